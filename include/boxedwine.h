@@ -12,6 +12,8 @@
 #include <functional>
 #include <set>
 #include <list>
+#include <map>
+#include <atomic>
 #include <filesystem>
 
 #include <errno.h>
@@ -60,6 +62,7 @@
 #include "ktimer.h"
 #include "../source/util/synchronization.h"
 #include "../source/util/karray.h"
+#include "../source/util/slabpool.h"
 #include "../source/util/stringutil.h"
 #include "../source/util/vectorutils.h"
 #include "../source/util/fileutils.h"
@@ -67,6 +70,7 @@
 #include "../source/emulation/cpu/common/cpu.h"
 #include "kpoll.h"
 #include "memory.h"
+#include "kfutex.h"
 #include "kthread.h"
 #include "kfilelock.h"
 #include "kobject.h"
@@ -48,13 +48,29 @@ public:
     U32 ctl(U32 op, FD fd, U32 address);
     U32 wait(U32 events, U32 maxevents, U32 timeout);
 private:
+    // A registered fd.  The conditions of the kobject stay children of cond between calls to wait, so when the
+    // kobject signals them this Data is put on readyList and only the Data on readyList are checked by wait.
     class Data {
     public:
-        U32 fd;
+        Data(FD fd, const std::shared_ptr<KObject>& kobject) : fd(fd), kobject(kobject), data(0), events(0), queued(false), disabled(false), removed(false), cond("KEPoll::Data::cond") {}
+        FD fd;
+        std::weak_ptr<KObject> kobject; // the epoll should not keep a closed file open
         U64 data;
         U32 events;
+        bool queued; // in readyList
+        bool disabled; // K_EPOLLONESHOT event was reported, waiting for K_EPOLL_CTL_MOD
+        bool removed;
+        BOXEDWINE_CONDITION cond;
     };
-    std::unordered_map<U32, Data*> data;
+    void arm(const std::shared_ptr<Data>& d, const std::shared_ptr<KObject>& kobject);
+    void disarm(const std::shared_ptr<Data>& d);
+    void queue(const std::shared_ptr<Data>& d);
+    void remove(const std::shared_ptr<Data>& d);
+
+    std::unordered_map<U32, std::shared_ptr<Data>> data;
+    BOXEDWINE_MUTEX dataMutex;
+    std::deque<std::shared_ptr<Data>> readyList;
+    BOXEDWINE_CONDITION readyCond; // guards readyList and the Data flags, wait blocks on it
 };
 
 #endif
\ No newline at end of file
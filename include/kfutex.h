@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 2016  The BoxedWine Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __KFUTEX_H__
+#define __KFUTEX_H__
+
+// Each thread can only wait on one futex at a time, so KThread owns its waiter
+class KFutexWaiter {
+public:
+    KFutexWaiter() : thread(NULL), address(NULL), expireTimeInMillies(0), mask(0), wake(false), queued(false), cond("KFutexWaiter::cond") {}
+
+    KThread* thread; // NULL when the thread isn't waiting
+    std::atomic<U8*> address; // changed by a requeue, which holds the lock of both buckets
+    U32 expireTimeInMillies;
+    U32 mask;
+    bool wake;
+    bool queued; // in the bucket for address
+    BOXEDWINE_CONDITION cond;
+};
+
+#define K_FUTEX_BUCKETS 256
+
+class KFutexBucket {
+public:
+    BOXEDWINE_MUTEX mutex;
+    std::list<KFutexWaiter*> waiters;
+};
+
+// The waiters are kept in buckets hashed by the host address of the futex word, that way processes that share memory
+// will find each other's waiters and unrelated futexes don't contend on the same lock.
+class KFutex {
+public:
+    static U32 futex(KThread* thread, U32 addr, U32 op, U32 value, U32 pTime, U32 addr2, U32 val3);
+
+    // stops the thread from waiting, if it was
+    static void removeWaiter(KThread* thread);
+private:
+    static U32 wait(KThread* thread, U32 addr, U8* ramAddress, U32 value, U32 pTime, U32 mask);
+    static U32 wakeLocked(KFutexBucket& bucket, U8* ramAddress, U32 count, U32 mask);
+    static U32 requeue(KThread* thread, U32 addr, U8* ramAddress, U32 addr2, U32 wakeCount, U32 requeueCount, bool compare, U32 value);
+    static U32 wakeOp(KThread* thread, U32 addr, U8* ramAddress, U32 addr2, U32 wakeCount, U32 wakeCount2, U32 encodedOp);
+    static KFutexBucket& getBucket(U8* ramAddress);
+    static void lockBuckets(KFutexBucket& bucket1, KFutexBucket& bucket2);
+    static void unlockBuckets(KFutexBucket& bucket1, KFutexBucket& bucket2);
+
+    static KFutexBucket buckets[K_FUTEX_BUCKETS];
+};
+
+#endif
@@ -51,6 +51,7 @@ public:
     virtual U32  writeNative(U8* buffer, U32 len)=0;
     virtual U32  writev(U32 iov, S32 iovcnt);
     virtual U32  read(U32 buffer, U32 len);
+    virtual U32  readv(U32 iov, S32 iovcnt);
     virtual U32  readNative(U8* buffer, U32 len)=0;
     virtual U32  stat(U32 address, bool is64)=0;
     virtual U32  map(U32 address, U32 len, S32 prot, S32 flags, U64 off)=0;
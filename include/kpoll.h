@@ -19,6 +19,8 @@
 #ifndef __KPOLL_H__
 #define __KPOLL_H__
 
+class KObject;
+
 class KPollData {
 public:
     U32 address;
@@ -28,6 +30,8 @@ public:
     U64 data;
 };
 
+// the K_POLL* event that is ready on kobject out of the ones in events, or 0
+U32 getPollEvents(KObject* kobject, U32 events);
 S32 internal_poll(KPollData* data, U32 count, U32 timeout);
 
 U32 kpoll(U32 pfds, U32 nfds, U32 timeout);
@@ -26,6 +26,8 @@ void terminateCurrentThread(KThread* thread);
 
 void addTimer(KTimer* timer);
 void removeTimer(KTimer* timer);
+void runTimers();
+U32 getNextTimer(); // millies until the next timer is due, 0xFFFFFFFF if there are no timers
 
 bool runSlice();
 void runThreadSlice(KThread* thread);
@@ -35,6 +35,7 @@
 
 #define K_MSG_OOB 1
 #define	K_MSG_PEEK     0x2
+#define K_MSG_TRUNC    0x20
 #define K_MSG_NOSIGNAL 0x4000
 
 #define K_SHUT_RD      0
@@ -10,10 +10,16 @@ public:
 };
 
 
-class KSocketMsg : public BoxedPtrBase {
+// A sendmsg waiting to be read by recvmsg.  They are reused by the socket that receives them, so data keeps its
+// capacity from one message to the next.
+class KSocketMsg {
 public:
+    KSocketMsg() : readPos(0), next(NULL) {}
+
     std::vector<KSocketMsgObject> objects;
     std::vector<U8> data;
+    U32 readPos; // what recvmsg has already read from data
+    KSocketMsg* next; // in the socket's queue or free list
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -71,13 +71,20 @@ class KSystem {
 public:    
     static bool videoEnabled;
     static U32 openglType;
+    static bool openglThreaded; // OSMesa contexts run their OpenGL calls on a host thread, most calls are queued for it
+    static std::string openglProfilePath; // if set, OpenGL calls are profiled and the result is written here as JSON on exit
     static bool soundEnabled;
     static U32 pentiumLevel;
 	static bool shutingDown;
     static U32 killTime;
     static std::string title;
+#ifdef BOXEDWINE_64BIT_MMU
+    static bool copyOnWriteFork; // if the platform supports it, fork shares the memory pages copy-on-write instead of copying them
+#endif
 #ifdef BOXEDWINE_BINARY_TRANSLATOR
     static bool useLargeAddressSpace;
+    static std::string translationCachePath; // if set, translated code will be saved here and reused on the next run
+    static U32 translationThreads; // number of threads that will translate code before it is run, 0 to only translate on demand
 #endif
 #ifdef BOXEDWINE_MULTI_THREADED
     static U32 cpuAffinityCountForApp;
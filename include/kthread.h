@@ -26,18 +26,26 @@
 
 class OpenGLVetexPointer {
 public:
-    OpenGLVetexPointer() : size(0), type(0), stride(0), count(0), ptr(0), marshal(NULL), marshal_size(0), refreshEachCall(0) {}
+    OpenGLVetexPointer() : size(0), type(0), stride(0), count(0), ptr(0), marshal(NULL), marshal_size(0), refreshEachCall(0), buffer(NULL), checkedPtr(0), checkedStart(0), checkedEnd(0), checkedGeneration(0) {}
     U32 size;
     U32 type;
     U32 stride;
     U32 count; // used by marshalEdgeFlagPointerEXT
     U32 ptr;
     U8* marshal;
-    U32 marshal_size;
+    U32 marshal_size; // size of buffer
     U32 refreshEachCall;
+    U8* buffer; // copy of the array when it can't be used where it is, marshal points to where ptr would be in it
+    // with the 64-bit MMU, the range of ptr that was last found to be readable, good until Memory::protectionGeneration changes
+    U32 checkedPtr;
+    U32 checkedStart;
+    U32 checkedEnd;
+    U32 checkedGeneration;
 };
 
 class KProcess;
+class GLThread;
+class VkArena;
 class Memory;
 
 class KThreadGlContext {
@@ -105,6 +113,7 @@ public:
     BOXEDWINE_CONDITION waitingForSignalToEndCond;
     U64 waitingForSignalToEndMaskToRestore;    
     U64 pendingSignals;
+    KFutexWaiter futexWaiter;
     BOXEDWINE_MUTEX pendingSignalsMutex;
     KThreadGlContext* getGlContextById(U32 id);
     void removeGlContextById(U32 id);
@@ -115,6 +124,8 @@ public:
     std::unordered_map<U32, KThreadGlContext> glContext;
 public:
     void* currentContext;
+    GLThread* glThread; // set while the current context runs its OpenGL calls on a render thread
+    VkArena* vkArena; // host copies of the structures passed to the current Vulkan call
     bool log; // syscalls
     OpenGLVetexPointer glVertextPointer;
     OpenGLVetexPointer glNormalPointer;
@@ -128,6 +139,9 @@ public:
     OpenGLVetexPointer glEdgeFlagPointer;
     OpenGLVetexPointer glEdgeFlagPointerEXT;
     OpenGLVetexPointer glInterleavedArray;
+    // set once the app uses client arrays that the draw calls don't refresh (glInterleavedArrays or another client
+    // texture unit), a GLThread can't queue a draw that might read them
+    bool glUntrackedClientArrays;
 
     inline static KThread* currentThread() {return runningThread;}
 	inline static void setCurrentThread(KThread* thread) { runningThread = thread; if (thread) { thread->memory->onThreadChanged(); } }
@@ -157,7 +171,6 @@ private:
     struct user_desc tls[TLS_ENTRIES];
     BOXEDWINE_MUTEX tlsMutex;
 
-    static BOXEDWINE_MUTEX futexesMutex;
 };
 
 class ChangeThread {
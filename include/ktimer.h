@@ -19,17 +19,39 @@
 #ifndef __KTIMER_H__
 #define __KTIMER_H__
 
+#define K_TIMER_NOT_QUEUED 0xFFFFFFFF
+
 class KTimer {
 public:
-    KTimer() : node(this), millies(0), resetMillies(0), active(false) {}
+    KTimer() : queueIndex(K_TIMER_NOT_QUEUED), millies(0), resetMillies(0), active(false), lastRunPass(0) {}
     ~KTimer();
 
-    virtual bool run()=0; // return true of the timer should be removed, don't remove a timer manually in run because it will invalidate the iterator
+    virtual bool run()=0; // return true if the timer should be removed, to keep it running again change millies and return false
 
-    KListNode<KTimer*> node;
+    U32 queueIndex; // position in KTimerQueue::heap
 	U32 millies;
 	U32 resetMillies;
 	bool active;
+    U32 lastRunPass; // the runTimers call that last ran it
+};
+
+// Binary min-heap of timers ordered by KTimer::millies.  Each timer knows where it is in the heap so that removing
+// it or changing its time is O(log n) and the next deadline is always at the front.
+class KTimerQueue {
+public:
+    void add(KTimer* timer); // if the timer is already queued, it is moved to its new millies
+    void remove(KTimer* timer);
+
+    KTimer* front() {return this->heap.size() ? this->heap[0] : NULL;}
+    bool isEmpty() {return this->heap.size() == 0;}
+    U32 size() {return (U32)this->heap.size();}
+
+private:
+    void siftUp(U32 index);
+    void siftDown(U32 index);
+    void set(U32 index, KTimer* timer) {this->heap[index] = timer; timer->queueIndex = index;}
+
+    std::vector<KTimer*> heap;
 };
 
-#endif
\ No newline at end of file
+#endif
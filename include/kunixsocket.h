@@ -3,6 +3,7 @@
 
 #include "ksocketmsg.h"
 #include "ksocketobject.h"
+#include "../source/util/ringbuffer.h"
 
 class KUnixSocketObject : public KSocketObject {
 public:
@@ -27,6 +28,7 @@ public:
     virtual U32  writeNative(U8* buffer, U32 len);
     virtual U32  writev(U32 iov, S32 iovcnt);
     virtual U32  read(U32 buffer, U32 len);
+    virtual U32  readv(U32 iov, S32 iovcnt);
     virtual U32  readNative(U8* buffer, U32 len);
     virtual U32  stat(U32 address, bool is64);
     virtual U32  map(U32 address, U32 len, S32 prot, S32 flags, U64 off);
@@ -57,10 +59,20 @@ private:
 
     BOXEDWINE_CONDITION lockCond;
 
-    std::deque<S8> recvBuffer;
-    std::queue<std::shared_ptr<KSocketMsg> > msgs;
+    // stream data written by the connection, guarded by lockCond
+    RingBuffer recvBuffer;
+
+    // sendmsg's from the connection, oldest first, guarded by lockCond
+    KSocketMsg* msgHead;
+    KSocketMsg* msgTail;
+    // messages that were read, the connection reuses them for its next sendmsg
+    KSocketMsg* freeMsgs;
+    U32 freeMsgCount;
 
     U32 internal_write(const std::shared_ptr<KUnixSocketObject>& con, BOXEDWINE_CONDITION& cond, U32 buffer, U32 len);
+    U32 internal_read(U32 buffer, U32 len);
+    KSocketMsg* allocMsg();
+    void freeMsg(KSocketMsg* msg);
 };
 
 #endif
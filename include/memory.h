@@ -78,6 +78,13 @@ class CPU;
 class DecodedOp;
 class DecodedBlock;
 class BtCodeChunk;
+class NativeMemoryLayers;
+class LazyFilePages;
+
+#if defined(BOXEDWINE_64BIT_MMU) && defined(BOXEDWINE_BINARY_TRANSLATOR) && K_NATIVE_PAGES_PER_PAGE == 1 && !defined(BOXEDWINE_MSVC)
+// private file mappings that can't be mapped from a host file are left without access and read when they fault
+#define BOXEDWINE_LAZY_FILE_PAGES
+#endif
 
 typedef void (OPCALL *OpCallback)(CPU* cpu, DecodedOp* op);
 
@@ -117,6 +124,8 @@ public:
 	void decRefCount() { this->refCount--; if (this->refCount == 0) { delete this; } }
     U32 getRefCount() { return this->refCount;}
 
+    // changes whenever one of this memory's code blocks is freed, so a cpu knows its cached blocks are stale
+    std::atomic<U32> blockGeneration;
 private:
     U32 refCount;
 public: 
@@ -147,11 +156,29 @@ public:
     U8 flags[K_NUMBER_OF_PAGES];
     U8 nativeFlags[K_NATIVE_NUMBER_OF_PAGES]; // this is based on the granularity for permissions, Platform::getPagePermissionGranularity. 
     U32 allocated;
+    std::atomic<U32> protectionGeneration; // changes whenever pages are unmapped or their permissions change, any thread can read it
     U64 id; 
 
     // this will contain id in each page unless that page was mapped to native host memory
     U64 memOffsets[K_NUMBER_OF_PAGES];    
+
+    // owned by the platform, it is used by cloneNativeMemory to share pages copy-on-write, NULL if the platform can't
+    NativeMemoryLayers* nativeLayers;
+
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+    // called by signalHandler() for a fault in translated code, never from the signal handler itself since it takes
+    // locks and reads the file.  Returns true if hostAddress is in a page that was waiting to be read from its file
+    // and the access can be retried
+    bool loadLazyFilePage(void* hostAddress, bool write);
+    void loadLazyFilePages(U32 address, U32 len);
+    bool isLazyFilePage(void* hostAddress); // only looks at the flags, so the signal handler can call it
+#endif
 private:
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+    std::map<U32, std::shared_ptr<LazyFilePages>> lazyFilePages; // key is LazyFilePages::page
+    void loadLazyFilePage(U32 page, LazyFilePages* pages);
+    void cloneLazyFilePages(Memory* from);
+#endif
     std::unordered_map<U32, std::unordered_map<U32, U32> > needsMemoryOffset; // first index is page, second index is offset
 public:
     bool doesInstructionNeedMemoryOffset(U32 eip) {
@@ -193,7 +220,28 @@ private:
     std::unordered_map<U32, std::shared_ptr< std::list< std::shared_ptr<BtCodeChunk> > >> codeChunksByEmulationPage;
 
     std::list<void*> freeExecutableMemory[EXECUTABLE_SIZES];
+
+    // bit n is set if bytes [n*64, n*64+64) of the page hold translated code, indexed by page
+    std::unordered_map<U32, U64> codeLines;
 public:
+#define K_CODE_LINE_SHIFT 6
+    void markCodeLines(U32 address, U32 len);
+    U64 getCodeLines(U32 page);
+    void clearCodeLines(U32 page);
+    // returns false if the write only touches lines of read only code pages that don't hold translated code
+    bool isCodeLineWrite(U32 address, U32 len);
+
+    // BtCodeMemoryWrite makes code pages writable while keeping their code, these count how many are writing to each
+    // native page.  Everything but isCodePageBeingWritten needs executableMemoryMutex.
+    void beginCodePageWrite(U32 nativePage);
+    bool endCodePageWrite(U32 nativePage); // returns true if it was the last one
+    bool isCodePageBeingWritten(U32 nativePage) { return this->codePageWriterCount.load(std::memory_order_acquire) && this->hasCodePageWriters(nativePage); }
+private:
+    bool hasCodePageWriters(U32 nativePage);
+    std::unordered_map<U32, U32> codePageWriters;
+    std::atomic<U32> codePageWriterCount; // pages in codePageWriters, so that most writes don't need the lock
+public:
+
     std::shared_ptr<BtCodeChunk> getCodeChunkContainingHostAddress(void* hostAddress);
     void clearHostCodeForWriting(U32 nativePage, U32 count);
     std::shared_ptr<BtCodeChunk> getCodeChunkContainingEip(U32 eip);
@@ -201,13 +249,17 @@ public:
     void removeCodeChunk(const std::shared_ptr<BtCodeChunk>& chunk);
     void makeNativePageDynamic(U32 nativePage);
     void* getExistingHostAddress(U32 eip);
+    std::deque<S32> hotChunkCounters; // the translated code holds pointers to these, so they live as long as the memory
+    std::vector<S32*> freeHotChunkCounters; // from chunks whose host code was freed, reused before hotChunkCounters grows
     void* allocateExcutableMemory(U32 size, U32* allocatedSize);
     void freeExcutableMemory(void* hostMemory, U32 size);
     void executableMemoryReleased();
     bool isAddressExecutable(void* address);
 
-    void allocNativeMemory(U32 page, U32 pageCount, U32 flags);
+    void allocNativeMemory(U32 page, U32 pageCount, U32 flags, bool zero = true);
     void freeNativeMemory(U32 page, U32 pageCount);    
+    bool mapFilePages(U32 page, U32 pageCount, U32 permissions, U64 offset, const BoxedPtr<MappedFile>& mappedFile);
+    void releaseFilePages(U32 page, U32 pageCount);
     void updatePagePermission(U32 page, U32 pageCount); // called after page permission has changed, code will give the native page the highest permission possible
     void updateNativePermission(U32 page, U32 pageCount, U32 permission); // for a native page change so that it can be read or written too now, updatePagePermission should be called when done to restore correct permissions
 
@@ -127,6 +127,7 @@ public:
     static void setCurrentThreadPriorityHigh();
     static void writeCodeToMemory(void* address, U32 len, std::function<void()> callback);
     static U32 nanoSleep(U64 nano);
+    static S64 pread(int handle, void* buffer, U32 len, U64 offset); // reads at offset without seeking first, so threads can share the handle
     static U32 getPageAllocationGranularity();
     static U32 getPagePermissionGranularity(); // assumed to be smaller or equal to getPageAllocationGranularity and that getPageAllocationGranularity / getPagePermissionGranularity is a whole number
     static U32 allocateNativeMemory(U64 address); // page must be aligned to Platform::getAllocationGranularity
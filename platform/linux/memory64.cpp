@@ -18,6 +18,8 @@
 
 #include "boxedwine.h"
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include <string.h>
 #include <errno.h>
 
@@ -150,7 +152,518 @@ static bool isAddressRangeInUse(void* p, U64 len) {
 }
 #endif
 
-static void* reserveNext4GBMemory() {
+class NativeMemoryFile {
+public:
+    NativeMemoryFile(int fd) : fd(fd) {}
+    ~NativeMemoryFile() {close(this->fd);}
+
+    const int fd;
+};
+
+#if defined(__linux__) && defined(MFD_CLOEXEC) && K_NATIVE_PAGES_PER_PAGE == 1
+#define BOXEDWINE_MEMORY_LAYERS
+#include <fcntl.h>
+
+// The memory of a process is backed by a memfd so that fork can map the pages copy-on-write instead of copying them.
+//
+// Until a memory is cloned, its whole reservation is a MAP_SHARED mapping of its own memfd.  The first clone turns
+// that memfd into a read only layer, the parent and the child both map their committed pages from it with
+// MAP_PRIVATE and the host copies a page the first time one of them writes to it.  A page that was written to after
+// that is anonymous memory, the next clone finds those pages with /proc/self/pagemap and only copies them into a new
+// layer.
+//
+// Pages that mapNativeFile mapped from a host file use that file as their layer, so a clone maps them from the file
+// too unless they were written to.
+class NativeMemoryLayer {
+public:
+    NativeMemoryLayer(const std::shared_ptr<NativeMemoryFile>& file, S64 offset) : file(file), offset(offset) {}
+
+    const std::shared_ptr<NativeMemoryFile> file;
+    const S64 offset; // page n is at (n << K_PAGE_SHIFT) + offset in the file
+};
+
+#define NO_MEMORY_LAYER 0xFFFF
+
+class NativeMemoryLayers {
+public:
+    NativeMemoryLayers() : fd(-1) {}
+    ~NativeMemoryLayers() {if (this->fd >= 0) close(this->fd);}
+
+    int fd; // mapped MAP_SHARED over the whole reservation until the memory is cloned, then -1
+    std::vector<std::shared_ptr<NativeMemoryLayer>> layers;
+    std::vector<U16> pageLayers; // index into layers of the layer each committed page was mapped from
+};
+
+static int createMemoryFile() {
+    int fd = memfd_create("boxedwine", MFD_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    if (ftruncate(fd, 0x100000000l) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+#define PAGEMAP_PRESENT (1ull << 63)
+#define PAGEMAP_SWAPPED (1ull << 62)
+#define PAGEMAP_FILE (1ull << 61)
+
+static int getPagemap() {
+    static int pagemap = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    return pagemap;
+}
+
+class PageRun {
+public:
+    PageRun(U32 page, U32 pageCount) : page(page), pageCount(pageCount) {}
+
+    U32 page;
+    U32 pageCount;
+};
+
+static bool isCommitted(Memory* memory, U32 page) {
+    return (memory->nativeFlags[page] & NATIVE_FLAG_COMMITTED) != 0;
+}
+
+static void getCommittedPages(Memory* memory, std::vector<PageRun>& runs) {
+    const U64 committedMask = NATIVE_FLAG_COMMITTED * 0x0101010101010101ull;
+    U32 page = 0;
+
+    while (page < K_NUMBER_OF_PAGES) {
+        // most of the address space isn't committed, so skip it 8 pages at a time
+        if (!(page & 7)) {
+            U64 flags;
+            memcpy(&flags, &memory->nativeFlags[page], sizeof(flags));
+            if (!(flags & committedMask)) {
+                page += 8;
+                continue;
+            }
+        }
+        if (!isCommitted(memory, page)) {
+            page++;
+            continue;
+        }
+        U32 start = page;
+        while (page < K_NUMBER_OF_PAGES && isCommitted(memory, page)) {
+            page++;
+        }
+        runs.push_back(PageRun(start, page - start));
+    }
+}
+
+// calls onRun for each range of the runs that getKey returns the same value for, pages where getKey returns -1 are skipped
+template <typename K, typename R>
+static void forEachPageRun(const std::vector<PageRun>& runs, K getKey, R onRun) {
+    for (const PageRun& run : runs) {
+        U32 start = run.page;
+        S32 key = -1;
+
+        for (U32 page = run.page; page <= run.page + run.pageCount; page++) {
+            S32 next = (page < run.page + run.pageCount) ? getKey(page) : -1;
+            if (next != key) {
+                if (key != -1) {
+                    onRun(start, page - start, key);
+                }
+                start = page;
+                key = next;
+            }
+        }
+    }
+}
+
+// the same protection Memory::updatePagePermission gives the page, nativeFlags can't be used because it drops
+// PAGE_EXEC and execute only pages are readable
+static int getNativeProtection(Memory* memory, U32 page, bool includeCodePages) {
+    int result = PROT_NONE;
+
+    // shared and lazy pages have no access so that their first use faults
+    if (memory->isShared(page) || (memory->nativeFlags[page] & NATIVE_FLAG_LAZY)) {
+        return result;
+    }
+    if (memory->flags[page] & (PAGE_READ | PAGE_EXEC)) {
+        result |= PROT_READ;
+    }
+    if (memory->flags[page] & PAGE_WRITE) {
+        result |= PROT_WRITE;
+    }
+    if (includeCodePages && (memory->nativeFlags[page] & NATIVE_FLAG_CODEPAGE_READONLY)) {
+        result &= ~PROT_WRITE;
+    }
+    return result;
+}
+
+static U8* getPagesAddress(Memory* memory, U32 page) {
+    return (U8*)memory->id + ((U64)page << K_PAGE_SHIFT);
+}
+
+// a NULL layer will map anonymous memory
+static void mapPages(Memory* memory, U32 page, U32 pageCount, int prot, NativeMemoryLayer* layer) {
+    U8* p = getPagesAddress(memory, page);
+    int flags = MAP_PRIVATE | MAP_FIXED;
+    int fd = -1;
+    off_t offset = 0;
+
+    if (layer) {
+        fd = layer->file->fd;
+        offset = ((S64)page << K_PAGE_SHIFT) + layer->offset;
+    } else {
+        flags |= MAP_ANONYMOUS;
+    }
+    if (mmap(p, (U64)pageCount << K_PAGE_SHIFT, prot, flags, fd, offset) != p) {
+        kpanic("cloneNativeMemory: mmap failed: %s", strerror(errno));
+    }
+}
+
+static bool isLayerPage(NativeMemoryLayers* native, U32 page) {
+    return native->pageLayers.size() && native->pageLayers[page] != NO_MEMORY_LAYER;
+}
+
+// A committed page was written to since it was mapped from a layer if it is anonymous memory now
+static bool findWrittenPages(Memory* memory, const std::vector<PageRun>& committed, std::vector<bool>& written) {
+    NativeMemoryLayers* native = memory->nativeLayers;
+    int pagemap = getPagemap();
+    U64 entries[512];
+
+    if (pagemap < 0) {
+        return false;
+    }
+    written.assign(K_NUMBER_OF_PAGES, false);
+    for (const PageRun& run : committed) {
+        U32 page = run.page;
+        U32 pageCount = run.pageCount;
+
+        while (pageCount) {
+            U32 todo = (pageCount < 512) ? pageCount : 512;
+            U64 offset = (((U64)getPagesAddress(memory, page)) >> K_PAGE_SHIFT) * sizeof(U64);
+
+            if (pread(pagemap, entries, todo * sizeof(U64), offset) != (ssize_t)(todo * sizeof(U64))) {
+                return false;
+            }
+            for (U32 i = 0; i < todo; i++) {
+                U64 entry = entries[i];
+                if (!isLayerPage(native, page + i) || (entry & PAGEMAP_SWAPPED) || ((entry & PAGEMAP_PRESENT) && !(entry & PAGEMAP_FILE))) {
+                    written[page + i] = true;
+                }
+            }
+            page += todo;
+            pageCount -= todo;
+        }
+    }
+    return true;
+}
+
+static bool writeLayer(Memory* memory, int fd, U32 page, U32 pageCount) {
+    U8* p = getPagesAddress(memory, page);
+    U64 len = (U64)pageCount << K_PAGE_SHIFT;
+    U64 offset = (U64)page << K_PAGE_SHIFT;
+
+    while (len) {
+        ssize_t done = pwrite(fd, p, len, offset);
+        if (done < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            return false;
+        }
+        p += done;
+        len -= done;
+        offset += done;
+    }
+    return true;
+}
+
+// prot is the current protection of the pages, they might need to be made readable to copy them
+static bool copyPagesToLayer(Memory* memory, int fd, U32 page, U32 pageCount, int prot) {
+    U8* p = getPagesAddress(memory, page);
+    U64 len = (U64)pageCount << K_PAGE_SHIFT;
+
+    if (!(prot & PROT_READ)) {
+        mprotect(p, len, prot | PROT_READ);
+    }
+    bool result = writeLayer(memory, fd, page, pageCount);
+    if (!(prot & PROT_READ)) {
+        mprotect(p, len, prot);
+    }
+    return result;
+}
+
+bool cloneNativeMemory(Memory* memory, Memory* from) {
+    NativeMemoryLayers* parent = from->nativeLayers;
+    NativeMemoryLayers* child = memory->nativeLayers;
+    std::vector<PageRun> committed;
+    std::vector<bool> written;
+    std::shared_ptr<NativeMemoryLayer> newLayer;
+
+    if (!parent || !child || parent->layers.size() >= NO_MEMORY_LAYER - 1) {
+        return false;
+    }
+    getCommittedPages(from, committed);
+    if (parent->fd >= 0) {
+        // pages of host files that were written to need to go into the memfd with the rest
+        if (parent->pageLayers.size()) {
+            if (!findWrittenPages(from, committed, written)) {
+                return false;
+            }
+            bool copied = true;
+            forEachPageRun(committed, [from, parent, &written](U32 page) {return (isLayerPage(parent, page) && written[page]) ? getNativeProtection(from, page, true) : -1;}, [from, parent, &copied](U32 page, U32 pageCount, S32 prot) {
+                if (copied) {
+                    copied = copyPagesToLayer(from, parent->fd, page, pageCount, prot);
+                }
+                });
+            if (!copied) {
+                return false;
+            }
+        }
+        // The parent's memfd already holds all of its other pages, it just can't be written to anymore.  Replacing a
+        // mapping is atomic for the parent's other threads, their writes either land in the memfd before this or in
+        // the parent's private copy after it.
+        newLayer = std::make_shared<NativeMemoryLayer>(std::make_shared<NativeMemoryFile>(parent->fd), 0);
+        parent->fd = -1;
+        U16 layerIndex = (U16)parent->layers.size();
+        parent->layers.push_back(newLayer);
+        if (parent->pageLayers.empty()) {
+            parent->pageLayers.assign(K_NUMBER_OF_PAGES, NO_MEMORY_LAYER);
+        }
+        forEachPageRun(committed, [from, parent](U32 page) {return isLayerPage(parent, page) ? -1 : getNativeProtection(from, page, true);}, [from, parent, &newLayer, layerIndex](U32 page, U32 pageCount, S32 prot) {
+            mapPages(from, page, pageCount, prot, newLayer.get());
+            for (U32 i = 0; i < pageCount; i++) {
+                parent->pageLayers[page + i] = layerIndex;
+            }
+            });
+        // the parent keeps its own copy of the file pages it wrote to, the child maps them from the memfd
+        for (U32 page = 0; page < written.size(); page++) {
+            if (written[page]) {
+                parent->pageLayers[page] = layerIndex;
+            }
+        }
+        written.clear();
+        // pages that are committed later must not end up in the layer
+        U32 page = 0;
+        for (const PageRun& run : committed) {
+            if (run.page > page) {
+                mapPages(from, page, run.page - page, PROT_NONE, NULL);
+            }
+            page = run.page + run.pageCount;
+        }
+        if (page < K_NUMBER_OF_PAGES) {
+            mapPages(from, page, K_NUMBER_OF_PAGES - page, PROT_NONE, NULL);
+        }
+    } else {
+        // Copy the pages the parent wrote to since it was mapped from its layers into a new layer.  The parent keeps
+        // its own copy of those pages, replacing it could lose a write from one of its other threads.
+        if (!findWrittenPages(from, committed, written)) {
+            return false;
+        }
+        int fd = createMemoryFile();
+        if (fd < 0) {
+            return false;
+        }
+        newLayer = std::make_shared<NativeMemoryLayer>(std::make_shared<NativeMemoryFile>(fd), 0);
+
+        bool copied = true;
+        forEachPageRun(committed, [from, &written](U32 page) {return written[page] ? getNativeProtection(from, page, true) : -1;}, [from, fd, &copied](U32 page, U32 pageCount, S32 prot) {
+            if (copied) {
+                copied = copyPagesToLayer(from, fd, page, pageCount, prot);
+            }
+            });
+        if (!copied) {
+            return false;
+        }
+    }
+
+    // the child only keeps the layers that it maps pages from
+    U16 newLayerIndex = (U16)parent->layers.size();
+    std::vector<U16> childLayerIndex(parent->layers.size() + 1, NO_MEMORY_LAYER);
+
+    child->layers.clear();
+    child->pageLayers.assign(K_NUMBER_OF_PAGES, NO_MEMORY_LAYER);
+    for (const PageRun& run : committed) {
+        for (U32 page = run.page; page < run.page + run.pageCount; page++) {
+            U16 layer = (written.size() && written[page]) ? newLayerIndex : parent->pageLayers[page];
+            if (childLayerIndex[layer] == NO_MEMORY_LAYER) {
+                childLayerIndex[layer] = (U16)child->layers.size();
+                child->layers.push_back((layer == newLayerIndex) ? newLayer : parent->layers[layer]);
+            }
+            child->pageLayers[page] = childLayerIndex[layer];
+        }
+    }
+
+    // the child hasn't run yet, so its memfd and the pages it committed in the constructor can just be dropped
+    if (child->fd >= 0) {
+        close(child->fd);
+        child->fd = -1;
+    }
+    mapPages(memory, 0, K_NUMBER_OF_PAGES, PROT_NONE, NULL);
+    forEachPageRun(committed, [from, child](U32 page) {return (child->pageLayers[page] << 8) | getNativeProtection(from, page, false);}, [memory, child](U32 page, U32 pageCount, S32 key) {
+        mapPages(memory, page, pageCount, key & 0xFF, child->layers[key >> 8].get());
+        });
+    memcpy(memory->nativeFlags, from->nativeFlags, sizeof(memory->nativeFlags));
+    for (const PageRun& run : committed) {
+        for (U32 page = run.page; page < run.page + run.pageCount; page++) {
+            memory->nativeFlags[page] &= ~NATIVE_FLAG_CODEPAGE_READONLY;
+        }
+    }
+    return true;
+}
+#else
+bool cloneNativeMemory(Memory* memory, Memory* from) {
+    return false;
+}
+#endif
+
+// a host file is only opened once no matter how many times it is mapped
+static std::map<std::pair<U64, U64>, std::weak_ptr<NativeMemoryFile>> nativeMemoryFiles; // key is st_dev, st_ino
+static BOXEDWINE_MUTEX nativeMemoryFilesMutex;
+
+static std::shared_ptr<NativeMemoryFile> openNativeMemoryFile(const std::string& nativePath) {
+    int fd = open(nativePath.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return nullptr;
+    }
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(nativeMemoryFilesMutex);
+    std::weak_ptr<NativeMemoryFile>& existing = nativeMemoryFiles[std::make_pair((U64)st.st_dev, (U64)st.st_ino)];
+    std::shared_ptr<NativeMemoryFile> result = existing.lock();
+    if (result) {
+        close(fd);
+        return result;
+    }
+    result = std::make_shared<NativeMemoryFile>(fd);
+    existing = result;
+    return result;
+}
+
+#ifdef BOXEDWINE_MEMORY_LAYERS
+static U16 getFileLayer(NativeMemoryLayers* native, const std::shared_ptr<NativeMemoryFile>& file, S64 offset) {
+    for (U32 i = 0; i < native->layers.size(); i++) {
+        if (native->layers[i]->file == file && native->layers[i]->offset == offset) {
+            return (U16)i;
+        }
+    }
+    if (native->layers.size() >= NO_MEMORY_LAYER - 1) {
+        return NO_MEMORY_LAYER;
+    }
+    native->layers.push_back(std::make_shared<NativeMemoryLayer>(file, offset));
+    return (U16)(native->layers.size() - 1);
+}
+#endif
+
+std::shared_ptr<NativeMemoryFile> createNativeMemoryFile(U64 length) {
+#ifdef BOXEDWINE_MEMORY_LAYERS
+    int fd = memfd_create("boxedwine-file", MFD_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (ftruncate(fd, length) < 0) {
+        close(fd);
+        return nullptr;
+    }
+    return std::make_shared<NativeMemoryFile>(fd);
+#else
+    return nullptr;
+#endif
+}
+
+bool writeNativeMemoryFile(NativeMemoryFile* file, U64 offset, U8* data, U32 len) {
+    while (len) {
+        ssize_t done = pwrite(file->fd, data, len, offset);
+        if (done < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            return false;
+        }
+        data += done;
+        len -= (U32)done;
+        offset += done;
+    }
+    return true;
+}
+
+bool mapNativeMemoryFile(Memory* memory, U32 page, U32 pageCount, const std::shared_ptr<NativeMemoryFile>& file, U64 offset) {
+#if K_NATIVE_PAGES_PER_PAGE == 1
+    U8* p = (U8*)memory->id + ((U64)page << K_PAGE_SHIFT);
+    U64 len = (U64)pageCount << K_PAGE_SHIFT;
+
+    if (offset & K_PAGE_MASK) {
+        return false;
+    }
+#ifdef BOXEDWINE_MEMORY_LAYERS
+    NativeMemoryLayers* native = memory->nativeLayers;
+    U16 layer = NO_MEMORY_LAYER;
+    if (native) {
+        layer = getFileLayer(native, file, (S64)offset - ((S64)page << K_PAGE_SHIFT));
+        if (layer == NO_MEMORY_LAYER) {
+            return false;
+        }
+    }
+#endif
+    if (mmap(p, len, PROT_NONE, MAP_PRIVATE | MAP_FIXED, file->fd, offset) != p) {
+        kpanic("mapNativeMemoryFile: mmap failed: %s", strerror(errno));
+    }
+#ifdef BOXEDWINE_MEMORY_LAYERS
+    if (native) {
+        if (native->fd >= 0) {
+            // the pages in the memfd under the mapping won't be used until the file is unmapped
+            fallocate(native->fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, (U64)page << K_PAGE_SHIFT, len);
+        }
+        if (native->pageLayers.empty()) {
+            native->pageLayers.assign(K_NUMBER_OF_PAGES, NO_MEMORY_LAYER);
+        }
+        for (U32 i = 0; i < pageCount; i++) {
+            native->pageLayers[page + i] = layer;
+        }
+    }
+#endif
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool mapNativeFile(Memory* memory, U32 page, U32 pageCount, const std::string& nativePath, U64 offset) {
+    if (K_NATIVE_PAGES_PER_PAGE != 1 || (offset & K_PAGE_MASK)) {
+        return false;
+    }
+    std::shared_ptr<NativeMemoryFile> file = openNativeMemoryFile(nativePath);
+    if (!file) {
+        return false;
+    }
+    return mapNativeMemoryFile(memory, page, pageCount, file, offset);
+}
+
+void unmapNativeFile(Memory* memory, U32 page, U32 pageCount) {
+    U8* p = (U8*)memory->id + ((U64)page << K_PAGE_SHIFT);
+    U64 len = (U64)pageCount << K_PAGE_SHIFT;
+
+#ifdef BOXEDWINE_MEMORY_LAYERS
+    NativeMemoryLayers* native = memory->nativeLayers;
+    if (native) {
+        for (U32 i = 0; i < pageCount && native->pageLayers.size(); i++) {
+            native->pageLayers[page + i] = NO_MEMORY_LAYER;
+        }
+        if (native->fd >= 0) {
+            if (mmap(p, len, PROT_NONE, MAP_SHARED | MAP_FIXED, native->fd, (U64)page << K_PAGE_SHIFT) != p) {
+                kpanic("unmapNativeFile: mmap failed: %s", strerror(errno));
+            }
+            return;
+        }
+    }
+#endif
+    if (mmap(p, len, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) != p) {
+        kpanic("unmapNativeFile: mmap failed: %s", strerror(errno));
+    }
+}
+
+// fd >= 0 will map the memory from that file instead of anonymous memory
+static void* reserveNext4GBMemory(int fd) {
     void* p;
 
     while (true) {
@@ -160,7 +673,11 @@ static void* reserveNext4GBMemory() {
         if (isAddressRangeInUse(p, 0x100000000l)) {
             continue;
         }
-        if (mmap(p, 0x100000000l, PROT_NONE, MAP_ANONYMOUS|MAP_FIXED|MAP_PRIVATE, -1, 0)==p) {
+        if (fd >= 0) {
+            if (mmap(p, 0x100000000l, PROT_NONE, MAP_FIXED|MAP_SHARED, fd, 0)==p) {
+                break;
+            }
+        } else if (mmap(p, 0x100000000l, PROT_NONE, MAP_ANONYMOUS|MAP_FIXED|MAP_PRIVATE, -1, 0)==p) {
             break;
         }
     }
@@ -185,7 +702,16 @@ static void* reserveNext32GBMemory() {
 }
 
 void reserveNativeMemory(Memory* memory) {
-    memory->id = (U64)reserveNext4GBMemory();
+#ifdef BOXEDWINE_MEMORY_LAYERS
+    int fd = createMemoryFile();
+    if (fd >= 0) {
+        memory->nativeLayers = new NativeMemoryLayers();
+        memory->nativeLayers->fd = fd;
+    }
+    memory->id = (U64)reserveNext4GBMemory(fd);
+#else
+    memory->id = (U64)reserveNext4GBMemory(-1);
+#endif
     for (int i = 0; i < K_NUMBER_OF_PAGES; i++) {
         memory->memOffsets[i] = memory->id;
     }
@@ -204,6 +730,10 @@ void releaseNativeMemory(Memory* memory) {
     memset(memory->nativeFlags, 0, sizeof(memory->nativeFlags));
     memory->allocated = 0;
     munmap((char*)memory->id, 0x100000000l);
+#ifdef BOXEDWINE_MEMORY_LAYERS
+    delete memory->nativeLayers;
+    memory->nativeLayers = NULL;
+#endif
 #ifdef BOXEDWINE_BINARY_TRANSLATOR
     memory->executableMemoryReleased();
     for (auto& p : memory->allocatedExecutableMemory) {
@@ -306,6 +836,11 @@ static void handler(int sig, siginfo_t* info, void* context)
 #else
         bool readAccess = (((ucontext_t*)context)->uc_mcontext.gregs[REG_ERR] & 1) == 0;
 #endif
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+        if (thread->memory->loadLazyFilePage(info->si_addr, !readAccess)) {
+            return;
+        }
+#endif
         
         if (!readAccess && (thread->process->memory->flags[page] & PROT_WRITE)) {
             void* p = (void*)(thread->memory->id + (thread->memory->getNativePage(page) << K_NATIVE_PAGE_SHIFT));
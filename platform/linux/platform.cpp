@@ -24,6 +24,7 @@
 #include <sys/socket.h>
 #include <SDL.h>
 #include <sys/mman.h>
+#include <unistd.h>
 #ifdef BOXEDWINE_BINARY_TRANSLATOR
 #include "../../source/emulation/cpu/binaryTranslation/btCpu.h"
 #endif
@@ -145,6 +146,10 @@ U32 Platform::getCpuCount() {
 #endif
 }
 
+S64 Platform::pread(int handle, void* buffer, U32 len, U64 offset) {
+    return ::pread(handle, buffer, len, (off_t)offset);
+}
+
 U32 Platform::nanoSleep(U64 nano) {
     struct timespec req, rem;
 
@@ -20,39 +20,42 @@
 #include <ucontext.h>
 #include <signal.h>
 #include <pthread.h>
-struct fpsimd_context* getSimdContext(mcontext_t* mc) {
-    struct _aarch64_ctx* head = (struct _aarch64_ctx*) &mc->__reserved;
+static struct _aarch64_ctx* getContextRecord(mcontext_t* mc, U32 magic) {
     size_t offset = 0;
-    
-    while (1) {
-        int err = 0;
-
-        head = (struct _aarch64_ctx*) &mc->__reserved[offset];
-
-        U32 magic =  head->magic;
-        U32 size = head->size;
-        
-        switch (magic) {
-            case 0:
-                return NULL;
-            case FPSIMD_MAGIC:
-                return (struct fpsimd_context*)head;
-            case ESR_MAGIC:
-                break; // ignore
-            default:
-                return NULL;
-        }
-        if (size < sizeof(*head)) {
-            return NULL;
+
+    while (offset + sizeof(struct _aarch64_ctx) <= sizeof(mc->__reserved)) {
+        struct _aarch64_ctx* head = (struct _aarch64_ctx*)&mc->__reserved[offset];
+
+        if (head->magic == magic) {
+            return head;
         }
-        if (size > sizeof(mc->__reserved) - (sizeof(*head) + offset)) {
+        if (!head->magic || head->size < sizeof(*head)) {
             return NULL;
         }
-        offset += size;
+        offset += head->size;
     }
+    return NULL;
+}
+
+struct fpsimd_context* getSimdContext(mcontext_t* mc) {
+    return (struct fpsimd_context*)getContextRecord(mc, FPSIMD_MAGIC);
 }
 #endif
 
+// ESR_ELx of a data abort, EC is in bits 26-31 and WnR, bit 6, is set for a write
+static bool isWriteFault(ucontext_t* context) {
+#ifdef __MACH__
+    U64 esr = context->uc_mcontext->__es.__esr;
+#else
+    struct esr_context* record = (struct esr_context*)getContextRecord(&context->uc_mcontext, ESR_MAGIC);
+    if (!record) {
+        return false;
+    }
+    U64 esr = record->esr;
+#endif
+    U32 ec = (U32)(esr >> 26) & 0x3F;
+    return (ec == 0x24 || ec == 0x25) && (esr & (1 << 6)) != 0;
+}
 
 void syncFromException(Armv8btCPU* cpu, ucontext_t* context) {
     EAX = (U32)context->CONTEXT_REG(xEAX);
@@ -107,17 +110,22 @@ void platformHandler(int sig, siginfo_t* info, void* vcontext) {
         return;
     }
     ucontext_t* context = (ucontext_t*)vcontext;
-
     BtCPU* cpu = (BtCPU*)currentThread->cpu;
     if (cpu != (BtCPU*)context->CONTEXT_REG(xCPU)) {
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+        // reading the page takes locks and reads a file, neither is safe here, so host code must read the page
+        // before it touches it, see loadLazyFilePagesForHost
+        if ((sig == SIGSEGV || sig == SIGBUS) && currentThread->memory->isLazyFilePage(info->si_addr)) {
+            kpanic("host code touched a page that wasn't read from its file yet: %p", info->si_addr);
+        }
+#endif
         return;
     }
     Armv8btCPU* armCpu = (Armv8btCPU*)cpu;
 
     syncFromException(armCpu, context);
 
-    // :TODO:
-    //cpu->exceptionReadAddress = mc->error_code == 0;
+    cpu->exceptionReadAddress = !isWriteFault(context);
     cpu->exceptionAddress = (U64)info->si_addr;
     cpu->exceptionSigNo = info->si_signo;
     cpu->exceptionSigCode = info->si_code;
@@ -154,6 +162,12 @@ void signalHandler() {
     KThread* currentThread = KThread::currentThread();
     Armv8btCPU* cpu = (Armv8btCPU*)currentThread->cpu;
 
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+    if ((cpu->exceptionSigNo == SIGSEGV || cpu->exceptionSigNo == SIGBUS) && cpu->thread->memory->loadLazyFilePage((void*)cpu->exceptionAddress, !cpu->exceptionReadAddress)) {
+        cpu->returnHostAddress = cpu->exceptionIp;
+        return;
+    }
+#endif
     U64 result = cpu->startException(cpu->exceptionAddress, cpu->exceptionReadAddress, NULL, NULL);
     if (result) {
         cpu->returnHostAddress = result;
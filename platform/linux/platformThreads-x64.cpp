@@ -290,6 +290,13 @@ void platformHandler(int sig, siginfo_t* info, void* vcontext) {
     ucontext_t* context = (ucontext_t*)vcontext;
     BtCPU* cpu = (BtCPU*)currentThread->cpu;
     if (cpu != (BtCPU*)context->CONTEXT_R13) {
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+        // reading the page takes locks and reads a file, neither is safe here, so host code must read the page
+        // before it touches it, see loadLazyFilePagesForHost
+        if ((sig == SIGSEGV || sig == SIGBUS) && currentThread->memory->isLazyFilePage(info->si_addr)) {
+            kpanic("host code touched a page that wasn't read from its file yet: %p", info->si_addr);
+        }
+#endif
         return;
     }
     x64CPU* x64Cpu = (x64CPU*)cpu;
@@ -335,6 +342,12 @@ void signalHandler() {
     KThread* currentThread = KThread::currentThread();
     x64CPU* cpu = (x64CPU*)currentThread->cpu;
 
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+    if ((cpu->exceptionSigNo == SIGSEGV || cpu->exceptionSigNo == SIGBUS) && cpu->thread->memory->loadLazyFilePage((void*)cpu->exceptionAddress, !cpu->exceptionReadAddress)) {
+        cpu->returnHostAddress = cpu->exceptionIp;
+        return;
+    }
+#endif
     U64 result = cpu->startException(cpu->exceptionAddress, cpu->exceptionReadAddress, NULL, NULL);
     if (result) {
         cpu->returnHostAddress = result;
@@ -2,9 +2,13 @@
 #include "kdspaudio.h"
 #include <SDL.h>
 #include "../../source/kernel/devs/oss.h"
+#include "../../source/util/spscring.h"
+#include "../../source/util/audioconvert.h"
 
 // Perhaps in the future, this class and devdsp.cpp will go away and instead I will replace the oss interface Wine uses in wineoss.drv with a custom one, like what I did with winex11.drv
 #define DSP_BUFFER_SIZE (1024*256)
+// how many frames writeAudio converts at a time
+#define DSP_CONVERT_FRAMES 4096
 
 static bool sdlAudioOpen;
 static U8 sdlSilence;
@@ -19,12 +23,10 @@ void closeSdlAudio() {
 
 class KDspAudioSdl : public KDspAudio, public std::enable_shared_from_this<KDspAudioSdl> {
 public:
-	KDspAudioSdl() : bufferCond("KDspAudioSdl::bufferCond") {
+	KDspAudioSdl() {
 		memset(&this->want, 0, sizeof(this->want));
 		memset(&this->got, 0, sizeof(this->got));
-		this->cvtBufLen = 0;
-		this->cvtBuf = NULL;
-		this->cvtBufPos = 0;
+		this->partialFrameLen = 0;
 		this->want.format = AUDIO_U8;
 		this->want.channels = 1;
 		this->want.freq = 11025;
@@ -43,12 +45,12 @@ public:
 		this->sameFormat = false;
 		this->open = false;
 		this->closeWhenDone = false;
+		this->starved = false;
+		this->underruns = 0;
+		this->droppedBytes = 0;
 	}
 
 	virtual ~KDspAudioSdl() {
-		if (this->cvtBuf) {
-			SDL_free(this->cvtBuf);
-		}
 	}
 
 	virtual void openAudio(U32 format, U32 freq, U32 channels);
@@ -56,11 +58,16 @@ public:
 	virtual void closeAudio();
 	virtual void writeAudio(U8* data, U32 len);
 	virtual U32 getFragmentSize() {return this->got.samples;}
-	virtual U32 getBufferSize() {return (U32)this->audioBuffer.size();}
+	virtual U32 getBufferSize();
 	virtual U32 getBufferCapacity() { return DSP_BUFFER_SIZE;}
 
 	void onClose();
 	void closeAudioFromAudioThread();
+	void writeFrames(U8* data, U32 frames);
+
+	U32 bytesPerFrameWant() {
+		return this->bytesPerSampleWant() * this->want.channels;
+	}
 
 	U32 bytesPerSampleWant() {
 		if (this->want.format == AUDIO_S16LSB || this->want.format == AUDIO_S16MSB || this->want.format == AUDIO_U16LSB || this->want.format == AUDIO_U16MSB)
@@ -71,6 +78,17 @@ public:
 			return 1;
 	}
 
+	static AudioSampleFormat getSampleFormat(U32 sdlFormat) {
+		switch (sdlFormat) {
+		case AUDIO_U8: return AUDIO_SAMPLE_U8;
+		case AUDIO_S8: return AUDIO_SAMPLE_S8;
+		case AUDIO_S16SYS: return AUDIO_SAMPLE_S16;
+		case AUDIO_S32SYS: return AUDIO_SAMPLE_S32;
+		case AUDIO_F32SYS: return AUDIO_SAMPLE_F32;
+		default: return AUDIO_SAMPLE_NONE;
+		}
+	}
+
 	U32 getSdlFormat(U32 format) {
 		switch (format) {
 		case AFMT_MU_LAW:
@@ -97,87 +115,54 @@ public:
 	}
 	SDL_AudioSpec want;
 	SDL_AudioSpec got;
-	SDL_AudioCVT cvt;
-	int cvtBufLen;
-	int cvtBufPos;
-	unsigned char* cvtBuf;
+	// When the device format is different, writeAudio converts before writing to the ring, so the ring holds what
+	// the device plays and the callback only copies
+	AudioConverter converter;
+	std::vector<U8> convertBuf;
+	U8 partialFrame[32]; // the start of a frame that the last write split
+	U32 partialFrameLen;
 	bool sameFormat;
 	U32 dspFragSize;
 	bool open;
-	std::deque<U8> audioBuffer;
-	BOXEDWINE_CONDITION bufferCond;
+	// written by the emulator in writeAudio and read by audioCallback, neither side waits on the other
+	SpscRing ring;
 	bool closeWhenDone;
+
+	// only touched by audioCallback until the voice is closed
+	bool starved;
+	U32 underruns; // how many times the device ran out of data, a run of silent callbacks counts once
+
+	U32 droppedBytes; // written while the ring was full
 };
 
 // not really a voice, currently they are not mixed
 std::list<std::shared_ptr<KDspAudioSdl>> voices;
 
+// This runs on the audio thread, it must not take any emulator locks or allocate memory
 void audioCallback(void* userdata, U8* stream, S32 len) {	
 	if (!voices.size()) {
 		memset(stream, sdlSilence, len);
 		return;
 	}
 	std::shared_ptr<KDspAudioSdl> data = voices.front();
-	if (data->closeWhenDone && data->audioBuffer.size()==0 && (data->cvtBufPos == 0 || data->cvtBufPos >= data->cvt.len_cvt)) {
+	if (data->closeWhenDone && data->ring.size()==0) {
 		data->closeAudioFromAudioThread();
 		memset(stream, sdlSilence, len);
 		return;
 	}
 
-	S32 available = (S32)data->audioBuffer.size();
-
-	if (!data->sameFormat) {
-		if (data->cvtBufPos < data->cvt.len_cvt) {
-			S32 todo = data->cvt.len_cvt - data->cvtBufPos;
-			if (todo > len)
-				todo = len;
-			memcpy(stream, data->cvt.buf + data->cvtBufPos, todo);
-			data->cvtBufPos += todo;
-			stream += todo;
-			len -= todo;
-		}
-		if (len) {
-			data->cvt.len = available;
-			if (data->cvtBufLen && data->cvtBufLen < data->cvt.len * data->cvt.len_mult) {
-				data->cvtBufLen = 0;
-				SDL_free(data->cvtBuf);
-				data->cvtBuf = NULL;
-			}
-			if (!data->cvtBufLen) {
-				data->cvtBufLen = data->cvt.len * data->cvt.len_mult;
-				data->cvtBuf = (Uint8*)SDL_malloc(data->cvt.len * data->cvt.len_mult);
-			}
-			data->cvt.buf = data->cvtBuf;
-
-			std::copy(data->audioBuffer.begin(), data->audioBuffer.begin() + available, data->cvt.buf);
-			data->audioBuffer.erase(data->audioBuffer.begin(), data->audioBuffer.begin() + available);
-
-			SDL_ConvertAudio(&data->cvt);
-			S32 todo = data->cvt.len_cvt;
-			if (todo > len)
-				todo = len;
-			memcpy(stream, data->cvt.buf, todo);
-			stream += todo;
-			len -= todo;
-			data->cvtBufPos = todo;
-		}
-	} else {
-		if (available > len)
-			available = len;
-		if (available) {
-			std::copy(data->audioBuffer.begin(), data->audioBuffer.begin() + available, stream);
-			data->audioBuffer.erase(data->audioBuffer.begin(), data->audioBuffer.begin() + available);
-			len -= available;
-			stream += available;
-		}
-	}
+	U32 copied = data->ring.read(stream, len);
+	len -= copied;
+	stream += copied;
 	if (len) {
+		if (!data->starved && !data->closeWhenDone) {
+			data->starved = true;
+			data->underruns++;
+		}
 		memset(stream, data->got.silence, len);
+	} else {
+		data->starved = false;
 	}
-
-	BOXEDWINE_CONDITION_LOCK(data->bufferCond);
-	BOXEDWINE_CONDITION_SIGNAL_ALL(data->bufferCond);
-	BOXEDWINE_CONDITION_UNLOCK(data->bufferCond);
 }
 
 void KDspAudioSdl::openAudio(U32 format, U32 freq, U32 channels) {
@@ -199,11 +184,35 @@ void KDspAudioSdl::openAudio(U32 format, U32 freq, U32 channels) {
 		sdlAudioOpen = true;
 		if (this->want.freq != this->got.freq || this->want.channels != this->got.channels || this->want.format != this->got.format) {
 			this->sameFormat = false;
-			SDL_BuildAudioCVT(&this->cvt, this->want.format, this->want.channels, this->want.freq, this->got.format, this->got.channels, this->got.freq);
+			if (!this->converter.init(getSampleFormat(this->want.format), this->want.channels, this->want.freq, getSampleFormat(this->got.format), this->got.channels, this->got.freq, DSP_CONVERT_FRAMES)) {
+				// let SDL convert on its own, it will do it on the audio thread
+				klog("openAudio: can't convert format %x to %x, SDL will convert it", this->want.format, this->got.format);
+				SDL_CloseAudio();
+				if (SDL_OpenAudio(&this->want, NULL) < 0) {
+					klog("Failed to open audio: %s", SDL_GetError());
+				}
+				this->got = this->want;
+				this->sameFormat = true;
+			}
 		} else {
 			this->sameFormat = true;
 		}
 	}
+	if (this->sameFormat) {
+		this->ring.alloc(DSP_BUFFER_SIZE);
+	} else {
+		// big enough for DSP_BUFFER_SIZE of the guest's audio once it is converted
+		U32 ringSize = 1;
+		while (ringSize < this->converter.getMaxOutputBytes(DSP_BUFFER_SIZE / this->bytesPerFrameWant())) {
+			ringSize <<= 1;
+		}
+		this->ring.alloc(ringSize);
+		this->convertBuf.resize(this->converter.getMaxOutputBytes(DSP_CONVERT_FRAMES));
+	}
+	this->partialFrameLen = 0;
+	this->starved = false;
+	this->underruns = 0;
+	this->droppedBytes = 0;
 	this->open = true;
 	voices.push_back(shared_from_this());
 	if (KSystem::soundEnabled) {
@@ -227,7 +236,7 @@ void KDspAudioSdl::closeAudio() {
 		if (KSystem::soundEnabled) {
 			SDL_LockAudio();
 		}
-		if (audioBuffer.size() || (this->cvtBufPos != 0 && this->cvtBufPos < this->cvt.len_cvt)) {
+		if (this->ring.size()) {
 			closeWhenDone = true;
 			needClose = false;
 		}
@@ -255,14 +264,69 @@ void KDspAudioSdl::onClose() {
 		}
 	}
 	this->open = false;
+	if (this->underruns || this->droppedBytes) {
+		klog("dsp audio: %d underruns, %d bytes dropped", this->underruns, this->droppedBytes);
+	}
+}
+
+U32 KDspAudioSdl::getBufferSize() {
+	if (this->sameFormat) {
+		return this->ring.size();
+	}
+	// the ring holds converted audio, the guest wants to know how much of what it wrote is still queued
+	U64 srcBytesPerSecond = (U64)this->converter.getSrcFrameSize() * this->want.freq;
+	U64 dstBytesPerSecond = (U64)this->converter.getDstFrameSize() * this->got.freq;
+	U32 result = (U32)(this->ring.size() * srcBytesPerSecond / dstBytesPerSecond);
+	return result > DSP_BUFFER_SIZE ? DSP_BUFFER_SIZE : result;
+}
+
+void KDspAudioSdl::writeFrames(U8* data, U32 frames) {
+	U32 frameSize = this->converter.getSrcFrameSize();
+
+	while (frames) {
+		U32 todo = frames > DSP_CONVERT_FRAMES ? DSP_CONVERT_FRAMES : frames;
+		U32 fits = this->converter.getMaxInputFrames(this->ring.space());
+		if (todo > fits) {
+			todo = fits;
+		}
+		if (!todo) {
+			this->droppedBytes += frames * frameSize;
+			return;
+		}
+		U32 len = this->converter.convert(data, todo, this->convertBuf.data());
+		this->ring.write(this->convertBuf.data(), len);
+		data += todo * frameSize;
+		frames -= todo;
+	}
 }
 
 void KDspAudioSdl::writeAudio(U8* data, U32 len) {
-	SDL_LockAudio();
-	BOXEDWINE_CONDITION_LOCK(this->bufferCond);
-	audioBuffer.insert(this->audioBuffer.end(), data, data + len);
-	BOXEDWINE_CONDITION_UNLOCK(this->bufferCond);
-	SDL_UnlockAudio();
+	// SNDCTL_DSP_GETOSPACE tells the app how much room there is, if it writes more than that the rest is dropped
+	// instead of making the emulator wait on the audio thread
+	if (this->sameFormat) {
+		this->droppedBytes += len - this->ring.write(data, len);
+		return;
+	}
+	U32 frameSize = this->converter.getSrcFrameSize();
+	if (this->partialFrameLen) {
+		U32 todo = frameSize - this->partialFrameLen;
+		if (todo > len) {
+			todo = len;
+		}
+		memcpy(this->partialFrame + this->partialFrameLen, data, todo);
+		this->partialFrameLen += todo;
+		data += todo;
+		len -= todo;
+		if (this->partialFrameLen < frameSize) {
+			return;
+		}
+		this->writeFrames(this->partialFrame, 1);
+		this->partialFrameLen = 0;
+	}
+	U32 frames = len / frameSize;
+	this->writeFrames(data, frames);
+	this->partialFrameLen = len - frames * frameSize;
+	memcpy(this->partialFrame, data + frames * frameSize, this->partialFrameLen);
 }
 
 std::shared_ptr<KDspAudio> KDspAudio::createDspAudio() {
@@ -3,6 +3,7 @@
 
 #include <SDL.h>
 #include "knativeaudiosdl.h"
+#include "kscheduler.h"
 
 #define S_OK 0
 #define E_FAIL 0x80004005
@@ -25,6 +26,7 @@ static void closeSdlAudio() {
 	}
 }
 
+// This runs on the audio thread, it must not take any emulator locks or allocate memory
 static void audioCallback(void* userdata, U8* stream, S32 len) {
 	KNativeSDLAudioData* data = (KNativeSDLAudioData*)userdata;
 
@@ -32,80 +34,92 @@ static void audioCallback(void* userdata, U8* stream, S32 len) {
 		memset(stream, data->got.silence, len);
 		return;
 	}
-	U32 blockAlign;
-	if (data->sameFormat) {
-		blockAlign = data->fmt.nBlockAlign;
+	U32 copied = data->ring.read(stream, len / data->ringFrameSize * data->ringFrameSize);
+	stream += copied;
+	len -= copied;
+	if (len) {
+		if (!data->starved.load(std::memory_order_relaxed)) {
+			data->starved.store(true, std::memory_order_relaxed);
+			data->underruns.fetch_add(1, std::memory_order_relaxed);
+		}
+		memset(stream, data->got.silence, len);
 	} else {
-		blockAlign = data->fmt.nBlockAlign * data->cvt.len_mult;
+		data->starved.store(false, std::memory_order_relaxed);
 	}
-	BOXEDWINE_CONDITION_LOCK(KSystem::processesCond);
-	if (data->process->terminated) {
-		memset(stream, data->got.silence, len);
-		BOXEDWINE_CONDITION_UNLOCK(KSystem::processesCond);
+}
+
+bool KNativeSDLAudioTimer::run() {
+	this->data->fillRing();
+	this->millies = KSystem::getMilliesSinceStart() + this->data->timerMillies;
+	return false;
+}
+
+void KNativeSDLAudioData::fillRing() {
+	BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(KSystem::processesCond);
+	if (!this->isPlaying || !this->process || this->process->terminated) {
 		return;
 	}
-	U32 nframes = len / blockAlign;
-	U32 to_copy_bytes, to_copy_frames, chunk_bytes, lcl_offs_bytes;
-	if (!data->process->memory->isValidReadAddress(data->address_lcl_offs_frames, 4)) {
-		memset(stream, data->got.silence, len);
-		BOXEDWINE_CONDITION_UNLOCK(KSystem::processesCond);
+	if (!this->process->memory->isValidReadAddress(this->address_lcl_offs_frames, 4)) {
 		return;
 	}
-	U32 lcl_offs_frames = data->process->readd(data->address_lcl_offs_frames);
-	U32 held_frames = data->process->readd(data->address_held_frames);
-
-	lcl_offs_bytes = lcl_offs_frames * data->fmt.nBlockAlign;
-	to_copy_frames = nframes < held_frames ? nframes : held_frames;
-	to_copy_bytes = to_copy_frames * data->fmt.nBlockAlign;
-
-	chunk_bytes = (data->bufsize_frames - lcl_offs_frames) * data->fmt.nBlockAlign;
+	// the guest holds this while it runs its own code, so don't wait on it, there will be another chance next period
+	if (!BOXEDWINE_MUTEX_TRY_LOCK(this->bufferMutex)) {
+		return;
+	}
+	U32 lcl_offs_frames = this->process->readd(this->address_lcl_offs_frames);
+	U32 held_frames = this->process->readd(this->address_held_frames);
+	U32 blockAlign = this->fmt.nBlockAlign;
+	U32 bufferedFrames = this->getBufferedFrames();
+	U32 to_copy_frames = this->targetFrames > bufferedFrames ? this->targetFrames - bufferedFrames : 0;
+	U32 space_frames = this->sameFormat ? this->ring.space() / blockAlign : this->converter.getMaxInputFrames(this->ring.space());
+
+	if (to_copy_frames > held_frames) {
+		to_copy_frames = held_frames;
+	}
+	if (to_copy_frames > space_frames) {
+		to_copy_frames = space_frames;
+	}
+	if (to_copy_frames) {
+		U32 to_copy_bytes = to_copy_frames * blockAlign;
+		U32 lcl_offs_bytes = lcl_offs_frames * blockAlign;
+		U32 chunk_bytes = (this->bufsize_frames - lcl_offs_frames) * blockAlign;
+		U8* input = this->ringInput.data();
 
-	if (data->sameFormat) {
 		if (to_copy_bytes > chunk_bytes) {
-			data->process->memcopyToNative(data->address_local_buffer + lcl_offs_bytes, stream, chunk_bytes);
-			data->process->memcopyToNative(data->address_local_buffer, stream + chunk_bytes, to_copy_bytes - chunk_bytes);
+			this->process->memcopyToNative(this->address_local_buffer + lcl_offs_bytes, input, chunk_bytes);
+			this->process->memcopyToNative(this->address_local_buffer, input + chunk_bytes, to_copy_bytes - chunk_bytes);
 		} else {
-			data->process->memcopyToNative(data->address_local_buffer + lcl_offs_bytes, stream, to_copy_bytes);
-		}
-		stream += to_copy_bytes;
-	} else {		
-		data->cvt.len = to_copy_bytes;
-		U32 bufSize = data->cvt.len * data->cvt.len_mult;
-		if (bufSize > data->cvtBufSize) {
-			if (data->cvtBuf) {
-				delete[] data->cvtBuf;
-			}
-			data->cvtBuf = new U8[bufSize];
-			data->cvtBufSize = bufSize;
+			this->process->memcopyToNative(this->address_local_buffer + lcl_offs_bytes, input, to_copy_bytes);
 		}
-		if (to_copy_bytes > chunk_bytes) {
-			data->process->memcopyToNative(data->address_local_buffer + lcl_offs_bytes, data->cvtBuf, chunk_bytes);
-			data->process->memcopyToNative(data->address_local_buffer, data->cvtBuf + chunk_bytes, to_copy_bytes - chunk_bytes);
-		}
-		else {
-			data->process->memcopyToNative(data->address_local_buffer + lcl_offs_bytes, data->cvtBuf, to_copy_bytes);
+		if (this->sameFormat) {
+			this->ring.write(input, to_copy_bytes);
+		} else {
+			this->ring.write(this->convertBuf.data(), this->converter.convert(input, to_copy_frames, this->convertBuf.data()));
 		}
-		data->cvt.buf = data->cvtBuf;
-		SDL_ConvertAudio(&data->cvt);
-		memcpy(stream, data->cvt.buf, data->cvt.len_cvt);
-		stream += data->cvt.len_cvt;
-	}
-	lcl_offs_frames += to_copy_frames;
-	lcl_offs_frames %= data->bufsize_frames;
-	data->process->writed(data->address_lcl_offs_frames, lcl_offs_frames);
-	held_frames -= to_copy_frames;
-	data->process->writed(data->address_held_frames, held_frames);
-	if (nframes > to_copy_frames) {
-		memset(stream, data->got.silence, (nframes - to_copy_frames) * blockAlign);
-	}
-	if (data->eventFd) {
-		KFileDescriptor* fd = data->process->getFileDescriptor(data->eventFd);
+
+		lcl_offs_frames += to_copy_frames;
+		lcl_offs_frames %= this->bufsize_frames;
+		this->process->writed(this->address_lcl_offs_frames, lcl_offs_frames);
+		held_frames -= to_copy_frames;
+		this->process->writed(this->address_held_frames, held_frames);
+	}
+	BOXEDWINE_MUTEX_UNLOCK(this->bufferMutex);
+	if (this->eventFd) {
+		KFileDescriptor* fd = this->process->getFileDescriptor(this->eventFd);
 		if (fd) {
 			U8 c = EVENT_MSG_DATA_READ;
 			fd->kobject->writeNative(&c, 1);
 		}
 	}
-	BOXEDWINE_CONDITION_UNLOCK(KSystem::processesCond);
+}
+
+// in the guest's frames
+U32 KNativeSDLAudioData::getBufferedFrames() {
+	U32 frames = this->ring.size() / this->ringFrameSize;
+	if (this->sameFormat || this->want.freq == this->got.freq) {
+		return frames;
+	}
+	return (U32)((U64)frames * this->want.freq / this->got.freq);
 }
 
 bool KNativeAudioSDL::load() {
@@ -134,6 +148,12 @@ void KNativeAudioSDL::start(U32 boxedAudioId, U32 eventFd) {
 	}
 	data->eventFd = eventFd;
 	data->isPlaying = true;
+	if (!data->timer.active) {
+		// what the resampler kept from before the stop doesn't belong to this stream
+		data->converter.reset();
+		data->timer.millies = KSystem::getMilliesSinceStart();
+		addTimer(&data->timer);
+	}
 }
 
 void KNativeAudioSDL::stop(U32 boxedAudioId) {
@@ -142,6 +162,9 @@ void KNativeAudioSDL::stop(U32 boxedAudioId) {
 		return;
 	}
 	data->isPlaying = false;
+	if (data->timer.active) {
+		removeTimer(&data->timer);
+	}
 }
 
 bool KNativeAudioSDL::configure() {
@@ -161,11 +184,34 @@ U32 KNativeAudioSDL::getEndPoint(bool isRender, U32 adevid) {
 }
 
 void KNativeAudioSDL::release(U32 boxedAudioId) {
+	KNativeSDLAudioData* data = getDataFromId(boxedAudioId);
+	if (!data) {
+		return;
+	}
+	data->isPlaying = false;
+	if (data->timer.active) {
+		removeTimer(&data->timer);
+	}
+	U32 underruns = data->underruns.load(std::memory_order_relaxed);
+	if (underruns) {
+		klog("audio: %d underruns", underruns);
+	}
 }
 
 void KNativeAudioSDL::captureResample(U32 boxedAudioId) {	
 }
 
+AudioSampleFormat KNativeAudioSDL::getSampleFormat(U32 sdlFormat) {
+	switch (sdlFormat) {
+	case AUDIO_U8: return AUDIO_SAMPLE_U8;
+	case AUDIO_S8: return AUDIO_SAMPLE_S8;
+	case AUDIO_S16SYS: return AUDIO_SAMPLE_S16;
+	case AUDIO_S32SYS: return AUDIO_SAMPLE_S32;
+	case AUDIO_F32SYS: return AUDIO_SAMPLE_F32;
+	default: return AUDIO_SAMPLE_NONE;
+	}
+}
+
 U32 KNativeAudioSDL::getSdlFormat(BoxedWaveFormatExtensible* pFmt) {
 	if ((pFmt->wFormatTag == WAVE_FORMAT_EXTENSIBLE && pFmt->SubFormat == SDL_KSDATAFORMAT_SUBTYPE_PCM) || pFmt->wFormatTag == WAVE_FORMAT_PCM) {
 		if (pFmt->wBitsPerSample == 8) {
@@ -219,12 +265,49 @@ U32 KNativeAudioSDL::init(bool isRender, U32 boxedAudioId, U32 addressFmt, U32 a
 		sdlAudioOpen = true;
 		if (data->want.freq != data->got.freq || data->want.channels != data->got.channels || data->want.format != data->got.format) {
 			data->sameFormat = false;
-			SDL_BuildAudioCVT(&data->cvt, data->want.format, data->want.channels, data->want.freq, data->got.format, data->got.channels, data->got.freq);
 		}
 		else {
 			data->sameFormat = true;
 		}
 	}
+	// the ring holds what 1 callback reads plus 2 periods, so that the callback still has data if the timer is late
+	U32 callbackFrames = data->got.samples;
+	if (data->got.freq) {
+		callbackFrames = (U32)((U64)data->got.samples * data->fmt.nSamplesPerSec / data->got.freq) + 1;
+	}
+	data->targetFrames = callbackFrames + data->period_frames * 2;
+	U32 ringBytes = data->targetFrames * data->fmt.nBlockAlign;
+	data->ringFrameSize = data->fmt.nBlockAlign;
+	if (!data->sameFormat) {
+		if (data->converter.init(getSampleFormat(data->want.format), data->want.channels, data->want.freq, getSampleFormat(data->got.format), data->got.channels, data->got.freq, data->targetFrames) && data->converter.getSrcFrameSize() == data->fmt.nBlockAlign) {
+			data->convertBuf.resize(data->converter.getMaxOutputBytes(data->targetFrames));
+			data->ringFrameSize = data->converter.getDstFrameSize();
+			ringBytes = data->converter.getMaxOutputBytes(data->targetFrames);
+		} else {
+			// let SDL convert on its own, it will do it on the audio thread
+			klog("openAudio: can't convert format %x to %x, SDL will convert it", data->want.format, data->got.format);
+			SDL_CloseAudio();
+			if (SDL_OpenAudio(&data->want, NULL) < 0) {
+				klog("Failed to open audio: %s", SDL_GetError());
+			}
+			data->got = data->want;
+			data->sameFormat = true;
+		}
+	}
+	U32 ringSize = 1;
+	while (ringSize < ringBytes * 2) {
+		ringSize <<= 1;
+	}
+	data->ring.alloc(ringSize);
+	data->ringInput.resize(data->targetFrames * data->fmt.nBlockAlign);
+	data->timerMillies = data->fmt.nSamplesPerSec ? data->period_frames * 1000 / data->fmt.nSamplesPerSec : 10;
+	if (!data->timerMillies) {
+		data->timerMillies = 1;
+	}
+	data->starved = false;
+	data->underruns = 0;
+	data->reportedUnderruns = 0;
+
 	data->open = true;
 	if (KSystem::soundEnabled) {
 		SDL_PauseAudio(0);
@@ -238,16 +321,27 @@ U32 KNativeAudioSDL::getLatency(U32 boxedAudioId, U32* pLatency) {
 	if (!data) {
 		return E_FAIL;
 	}
-	*pLatency = data->got.samples*2; // sdl audio is double buffered
+	*pLatency = data->got.samples*2 + data->targetFrames; // sdl audio is double buffered, plus what is kept in the ring
+	U32 underruns = data->underruns.load(std::memory_order_relaxed);
+	if (underruns != data->reportedUnderruns) {
+		klog("audio: %d underruns, latency %d frames", underruns, *pLatency);
+		data->reportedUnderruns = underruns;
+	}
 	return S_OK;
 }
 
 void KNativeAudioSDL::lock(U32 boxedAudioId) {
-	SDL_LockAudio();
+	KNativeSDLAudioData* data = getDataFromId(boxedAudioId);
+	if (data) {
+		BOXEDWINE_MUTEX_LOCK(data->bufferMutex);
+	}
 }
 
 void KNativeAudioSDL::unlock(U32 boxedAudioId) {
-	SDL_UnlockAudio();
+	KNativeSDLAudioData* data = getDataFromId(boxedAudioId);
+	if (data) {
+		BOXEDWINE_MUTEX_UNLOCK(data->bufferMutex);
+	}
 }
 
 U32 KNativeAudioSDL::isFormatSupported(U32 boxedAudioId, U32 addressWaveFormat) {
@@ -1,33 +1,62 @@
 #ifndef __KNATIVE_AUDIO_SDL_H__
 #define __KNATIVE_AUDIO_SDL_H__
 
+#include "../../source/util/spscring.h"
+#include "../../source/util/audioconvert.h"
+
+class KNativeSDLAudioData;
+
+// Moves what the guest wrote to its buffer into the ring every period, on the emulator side
+class KNativeSDLAudioTimer : public KTimer {
+public:
+	KNativeSDLAudioTimer(KNativeSDLAudioData* data) : data(data) {}
+	virtual bool run();
+
+	KNativeSDLAudioData* data;
+};
+
 class KNativeSDLAudioData {
 public:
-	KNativeSDLAudioData() : cvtBuf(0), cvtBufSize(0), sameFormat(false), open(false), isRender(false), isPlaying(false), eventFd(0), adevid(0), cap_held_frames(0), resamp_bufsize_frames(0), resamp_buffer(0), cap_offs_frames(0), bufsize_frames(0), address_local_buffer(0), address_wri_offs_frames(0), address_held_frames(0), address_lcl_offs_frames(0), period_frames(0) {}
+	KNativeSDLAudioData() : sameFormat(false), open(false), isRender(false), isPlaying(false), eventFd(0), adevid(0), ringFrameSize(0), timer(this), targetFrames(0), timerMillies(0), starved(false), underruns(0), reportedUnderruns(0), cap_held_frames(0), resamp_bufsize_frames(0), resamp_buffer(0), cap_offs_frames(0), bufsize_frames(0), address_local_buffer(0), address_wri_offs_frames(0), address_held_frames(0), address_lcl_offs_frames(0), period_frames(0) {}
 	~KNativeSDLAudioData() {
 		if (resamp_buffer) {
 			delete[] resamp_buffer;
 		}
-		if (cvtBuf) {
-			delete[] cvtBuf;
-		}
 	}
 
 	SDL_AudioSpec want;
 	SDL_AudioSpec got;
-	SDL_AudioCVT cvt;
-	U8* cvtBuf;
-	U32 cvtBufSize;
-
+	// when the device format is different, fillRing converts before writing to the ring
+	AudioConverter converter;
+	std::vector<U8> convertBuf;
 	bool sameFormat;
 	bool open;
 	std::shared_ptr<KProcess> process;
 
 	bool isRender;
-	bool isPlaying;
+	std::atomic<bool> isPlaying; // the audio callback plays silence while it is false
 	U32 eventFd;
 	U32 adevid;
 
+	void fillRing();
+	U32 getBufferedFrames();
+
+	// The guest's frames are copied into the ring by timer and the audio callback reads them from the ring.  The
+	// callback never touches emulator memory or takes an emulator lock.
+	SpscRing ring;
+	U32 ringFrameSize; // the device's frame size, the ring only holds whole frames
+	std::vector<U8> ringInput;
+	KNativeSDLAudioTimer timer;
+	U32 targetFrames; // how many frames timer keeps in the ring
+	U32 timerMillies;
+	// held while the guest or timer updates the buffer offsets, the audio callback doesn't use it
+	BOXEDWINE_MUTEX bufferMutex;
+
+	// only written by the audio callback while it runs, read on the emulator thread
+	std::atomic<bool> starved;
+	std::atomic<U32> underruns; // how many times the device ran out of data, a run of short callbacks counts once
+	U32 reportedUnderruns;
+
 	U32 cap_held_frames;
 	U32 resamp_bufsize_frames;
 	U8* resamp_buffer;
@@ -92,6 +121,7 @@ public:
 	virtual U32 midiInReset(U32 wDevID);
 
 	U32 getSdlFormat(BoxedWaveFormatExtensible* pFmt);
+	static AudioSampleFormat getSampleFormat(U32 sdlFormat);
 
 	KNativeSDLAudioData data[2];
 
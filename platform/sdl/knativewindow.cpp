@@ -35,6 +35,7 @@
 #include "../../source/util/threadutils.h"
 #include "../../source/sdl/startupArgs.h"
 #include "../../source/opengl/boxedwineGL.h"
+#include "../../source/opengl/glprofiler.h"
 
 #if !defined(BOXEDWINE_DISABLE_UI) && !defined(__TEST)
 #include "../../source/ui/mainui.h"
@@ -62,7 +63,7 @@ public:
 #ifdef BOXEDWINE_RECORDER
         , bits(0), bitsSize(0)
 #endif
-        , sdlTexture(NULL), sdlTextureHeight(0), sdlTextureWidth(0)
+        , sdlTexture(NULL), sdlTextureHeight(0), sdlTextureWidth(0), sdlTextureBits(0)
     {}
 
     virtual void setText(char* text) {
@@ -99,6 +100,7 @@ public:
     SDL_Texture* sdlTexture;
     int sdlTextureHeight;
     int sdlTextureWidth;
+    U32 sdlTextureBits; // the surface that was last uploaded, when Wine gives the window a new one it is uploaded whole
 };
 
 U32 KNativeWindow::defaultScreenWidth = 800;
@@ -109,7 +111,7 @@ U32 sdlCustomEvent;
 
 class KNativeWindowSdl : public KNativeWindow, public std::enable_shared_from_this<KNativeWindowSdl> {
 public:
-    KNativeWindowSdl() : scaleX(100), scaleXOffset(0), scaleY(100), scaleYOffset(0), sdlDesktopWidth(0), sdlDesktopHeight(0), fullScreen(FULLSCREEN_NOTSET), vsync(VSYNC_DEFAULT), window(NULL), renderer(NULL), shutdownWindow(NULL), shutdownRenderer(NULL), desktopTexture(NULL), currentContext(NULL), contextCount(0), windowIsGL(false), glWindowVersionMajor(0), windowIsHidden(false), timeToHideUI(0), timeWindowWasCreated(0), lastChildWndCreated(0), primarySurface(NULL)
+    KNativeWindowSdl() : scaleX(100), scaleXOffset(0), scaleY(100), scaleYOffset(0), sdlDesktopWidth(0), sdlDesktopHeight(0), fullScreen(FULLSCREEN_NOTSET), vsync(VSYNC_DEFAULT), window(NULL), renderer(NULL), shutdownWindow(NULL), shutdownRenderer(NULL), desktopTexture(NULL), currentContext(NULL), contextCount(0), windowIsGL(false), glWindowVersionMajor(0), windowIsHidden(false), timeToHideUI(0), timeWindowWasCreated(0), lastChildWndCreated(0), primarySurface(NULL), presentPending(false), lastPresentTime(0)
 #ifdef BOXEDWINE_RECORDER
         , screenCopyTexture(NULL)
 #endif
@@ -159,6 +161,12 @@ public:
     U32 lastChildWndCreated;
     Boxed_Surface* primarySurface;
 
+    // drawAllWindows presents at most once per SDL_PRESENT_INTERVAL, a flush that comes in sooner only records the
+    // z-order it was given and the present happens from processEvents on the main thread
+    std::vector<U32> presentOrder;
+    bool presentPending;
+    U32 lastPresentTime;
+
     std::string delayedCreateWindowMsg; // the ui will watch for this message
     std::unordered_map<std::string, SDL_Cursor*> cursors;
     std::unordered_map<U32, std::shared_ptr<WndSdl>> hwndToWnd;
@@ -230,6 +238,8 @@ public:
     bool handlSdlEvent(SDL_Event* e);
     void destroyScreen(KThread* thread);
     void preDrawWindow();
+    bool updateWndTexture(const std::shared_ptr<WndSdl>& wnd, U32 bpp, U32 width, U32 height);
+    void presentWindows();
     void displayChanged(KThread* thread);
     KThreadGlContext* getGlContextByIdInUnknownThread(const std::shared_ptr<KProcess>& process, U32 id);
     std::shared_ptr<WndSdl> getWndSdl(U32 hwnd);        
@@ -260,6 +270,8 @@ private:
 static std::shared_ptr<KNativeWindowSdl> screen;
 
 #define HIDE_UI_WINDOW_DELAY 1000
+// about 60 frames a second, desktop apps can flush their window surfaces far more often than that
+#define SDL_PRESENT_INTERVAL 16
 
 static int rel_mouse_sensitivity = 100;
 static bool relativeMouse = false;
@@ -271,6 +283,14 @@ bool KNativeWindowSdl::waitForEvent(U32 ms) {
         ms = 100;
         updateShutdownWindow();
     }
+    if (presentPending) {
+        // wake up in time to present the windows that drawAllWindows held back
+        U32 elapsed = KSystem::getMilliesSinceStart() - lastPresentTime;
+        U32 wait = elapsed < SDL_PRESENT_INTERVAL ? SDL_PRESENT_INTERVAL - elapsed : 0;
+        if (wait < ms) {
+            ms = wait;
+        }
+    }
     return SDL_WaitEventTimeout(NULL, ms) == 1;
 }
 
@@ -295,6 +315,15 @@ bool KNativeWindowSdl::processEvents() {
             return false;
         }
     }
+    if (presentPending && KSystem::getMilliesSinceStart() - lastPresentTime >= SDL_PRESENT_INTERVAL) {
+        // if the lock is held, then whoever has it is about to draw anyway
+        if (BOXEDWINE_MUTEX_TRY_LOCK(sdlMutex)) {
+            if (presentPending) {
+                presentWindows();
+            }
+            BOXEDWINE_MUTEX_UNLOCK(sdlMutex);
+        }
+    }
     return true;
 }
 
@@ -886,6 +915,9 @@ void KNativeWindowSdl::displayChanged(KThread* thread) {
 void KNativeWindowSdl::glSwapBuffers(KThread* thread) {
     preOpenGLCall(XSwapBuffer);
     BoxedwineGL::current->swapBuffer(window);
+#ifdef BOXEDWINE_OPENGL
+    glProfileFrame();
+#endif
 }
 
 #if !defined(BOXEDWINE_64BIT_MMU) || defined(BOXEDWINE_LINUX)
@@ -896,6 +928,31 @@ void KNativeWindowSdl::glSwapBuffers(KThread* thread) {
 static S8 sdlBuffer[1024*1024*4];
 #endif
 
+bool KNativeWindowSdl::updateWndTexture(const std::shared_ptr<WndSdl>& wnd, U32 bpp, U32 width, U32 height) {
+    SDL_Texture* sdlTexture = wnd->sdlTexture;
+
+    if (sdlTexture && (((U32)wnd->sdlTextureHeight) != height || ((U32)wnd->sdlTextureWidth) != width)) {
+        SDL_DestroyTexture(sdlTexture);
+        wnd->sdlTexture = NULL;
+        sdlTexture = NULL;
+    }
+    if (sdlTexture) {
+        return false;
+    }
+    U32 format = SDL_PIXELFORMAT_ARGB8888;
+    if (bpp == 16) {
+        format = SDL_PIXELFORMAT_RGB565;
+    } else if (bpp == 15) {
+        format = SDL_PIXELFORMAT_RGB555;
+    }
+    if (KSystem::videoEnabled && renderer) {
+        wnd->sdlTexture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, width, height);
+    }
+    wnd->sdlTextureHeight = height;
+    wnd->sdlTextureWidth = width;
+    return true;
+}
+
 void KNativeWindowSdl::bltWnd(KThread* thread, U32 hwnd, U32 bits, S32 xOrg, S32 yOrg, U32 width, U32 height, U32 rect) {
     if (!firstWindowCreated) {
         BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(sdlMutex);
@@ -906,9 +963,9 @@ void KNativeWindowSdl::bltWnd(KThread* thread, U32 hwnd, U32 bits, S32 xOrg, S32
     
     BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(sdlMutex);
     std::shared_ptr<WndSdl> wnd = getWndSdl(hwnd);
-    wRECT r;
     int bpp = screenBpp()==8?32:screenBpp();
-    int pitch = (width*((bpp+7)/8)+3) & ~3;
+    int bytesPerPixel = (bpp+7)/8;
+    int pitch = (width*bytesPerPixel+3) & ~3;
 
     if (!renderer) {
         // final reality will draw its main start window while an OpenGL context is still going
@@ -923,39 +980,43 @@ void KNativeWindowSdl::bltWnd(KThread* thread, U32 hwnd, U32 bits, S32 xOrg, S32
         }
     }
     preDrawWindow();
-    r.readRect(rect);    
     if (wnd)
     {
-        SDL_Texture *sdlTexture = NULL;
-        
-        if (wnd->sdlTexture) {
-            sdlTexture = (SDL_Texture*)wnd->sdlTexture;
-            if (sdlTexture && (((U32)wnd->sdlTextureHeight) != height || ((U32)wnd->sdlTextureWidth) != width)) {
-                SDL_DestroyTexture(sdlTexture);
-                wnd->sdlTexture = NULL;
-                sdlTexture = NULL;
-            }
+        // the dirty rect is top down in surface coordinates, the surface bits are bottom up
+        wRECT r;
+        r.right = width;
+        r.bottom = height;
+        bool wholeSurface = updateWndTexture(wnd, bpp, width, height) || !rect || wnd->sdlTextureBits != bits;
+#ifdef BOXEDWINE_RECORDER
+        if (Recorder::instance || Player::instance) {
+            wholeSurface = true;
         }
-        if (!sdlTexture) {
-            U32 format = SDL_PIXELFORMAT_ARGB8888;
-            if (bpp == 16) {
-                format = SDL_PIXELFORMAT_RGB565;
-            } else if (bpp == 15) {
-                format = SDL_PIXELFORMAT_RGB555;
-            }
-            if (KSystem::videoEnabled && renderer) {
-                sdlTexture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, width, height);
-                wnd->sdlTexture = sdlTexture;
+#endif
+        if (!wholeSurface) {
+            r.readRect(rect);
+            if (r.left < 0) r.left = 0;
+            if (r.top < 0) r.top = 0;
+            if (r.right > (S32)width) r.right = width;
+            if (r.bottom > (S32)height) r.bottom = height;
+            if (r.left >= r.right || r.top >= r.bottom) {
+                return;
             }
-            wnd->sdlTextureHeight = height;
-            wnd->sdlTextureWidth = width;
         }
+        SDL_Texture* sdlTexture = wnd->sdlTexture;
         if (!thread->memory->isValidReadAddress(bits, height*pitch)) {
             return;
         }
+        wnd->sdlTextureBits = bits;
+        SDL_Rect dirty;
+        dirty.x = r.left;
+        dirty.y = r.top;
+        dirty.w = r.right - r.left;
+        dirty.h = r.bottom - r.top;
+        U32 rowOffset = dirty.x * bytesPerPixel;
+        U32 rowBytes = wholeSurface ? pitch : dirty.w * bytesPerPixel;
 #ifdef BOXEDWINE_FLIP_MANUALLY        
-        for (U32 y = 0; y < height; y++) {
-            memcopyToNative(bits+(height-y-1)*pitch, sdlBuffer+y*pitch, pitch);
+        for (S32 y = r.top; y < r.bottom; y++) {
+            memcopyToNative(bits+(height-y-1)*pitch+rowOffset, sdlBuffer+(y-r.top)*rowBytes, rowBytes);
         } 
 #endif
         if (screenBpp()!=32) {
@@ -979,11 +1040,13 @@ void KNativeWindowSdl::bltWnd(KThread* thread, U32 hwnd, U32 bits, S32 xOrg, S32
             memcpy(wnd->bits, sdlBuffer, toCopy);
         }
 #endif        
-        if (KSystem::videoEnabled && renderer) {
+        if (KSystem::videoEnabled && renderer && sdlTexture) {
 #ifdef BOXEDWINE_FLIP_MANUALLY
-            SDL_UpdateTexture(sdlTexture, NULL, sdlBuffer, pitch);
+            SDL_UpdateTexture(sdlTexture, &dirty, sdlBuffer, rowBytes);
 #else
-            SDL_UpdateTexture(sdlTexture, NULL, getNativeAddress(KThread::currentThread()->process->memory, bits), pitch);            
+            // the texture is bottom up too, it is flipped when it is drawn
+            dirty.y = height - r.bottom;
+            SDL_UpdateTexture(sdlTexture, &dirty, getPhysicalReadAddress(bits+dirty.y*pitch+rowOffset, dirty.h*pitch), pitch);
 #endif
         }
     }
@@ -1139,31 +1202,9 @@ void KNativeWindowSdl::drawWnd(KThread* thread, std::shared_ptr<Wnd> w, U8* byte
     std::shared_ptr<WndSdl> wnd = std::dynamic_pointer_cast<WndSdl>(w);
 
     preDrawWindow();
-    SDL_Texture* sdlTexture = NULL;
-
-    if (wnd->sdlTexture) {
-        sdlTexture = (SDL_Texture*)wnd->sdlTexture;
-        if (sdlTexture && (((U32)wnd->sdlTextureHeight) != height || ((U32)wnd->sdlTextureWidth) != width)) {
-            SDL_DestroyTexture(sdlTexture);
-            wnd->sdlTexture = NULL;
-            sdlTexture = NULL;
-        }
-    }
-    if (!sdlTexture) {
-        U32 format = SDL_PIXELFORMAT_ARGB8888;
-        if (bpp == 16) {
-            format = SDL_PIXELFORMAT_RGB565;
-        }
-        else if (bpp == 15) {
-            format = SDL_PIXELFORMAT_RGB555;
-        }
-        if (KSystem::videoEnabled && renderer) {
-            sdlTexture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, width, height);
-            wnd->sdlTexture = sdlTexture;
-        }
-        wnd->sdlTextureHeight = height;
-        wnd->sdlTextureWidth = width;
-    }
+    // the whole frame is rendered again by OSMesa on each swap, so there is nothing to gain from tracking what changed
+    updateWndTexture(wnd, bpp, width, height);
+    SDL_Texture* sdlTexture = wnd->sdlTexture;
 #ifdef BOXEDWINE_RECORDER
     if (Recorder::instance || Player::instance) {
         U32 toCopy = pitch * height;
@@ -1293,52 +1334,68 @@ void KNativeWindowSdl::drawAllWindows(KThread* thread, U32 hWnd, int count) {
     }
 #endif
     if (KSystem::videoEnabled && renderer) {
-        U32 threadId = KThread::currentThread()->id;
+        // the z-order lives in the caller's memory, so it is read now in case the present is held back
+        presentOrder.resize(count);
+        for (int i=0;i<count;i++) {
+            presentOrder[i] = readd(hWnd+i*4);
+        }
+        presentPending = true;
+        if (KSystem::getMilliesSinceStart() - lastPresentTime < SDL_PRESENT_INTERVAL) {
+            // processEvents will present this along with whatever else is flushed before then
+            KNativeWindow::windowUpdated = true;
+            return;
+        }
         DISPATCH_MAIN_THREAD_BLOCK_BEGIN
-        KThread* thread = KSystem::getThreadById(threadId);
-        if (thread) {
-            ChangeThread t(thread);
-            SDL_SetRenderDrawColor(renderer, 58, 110, 165, 255 );
-            SDL_RenderClear(renderer);
-            for (int i=count-1;i>=0;i--) {
-                std::shared_ptr<WndSdl> wnd = getWndSdl(readd(hWnd+i*4));
-                if (wnd && wnd->sdlTextureWidth && wnd->sdlTexture) {
-                    SDL_Rect dstrect;
-                    dstrect.x = wnd->windowRect.left*(int)scaleX/100 + scaleXOffset;
-                    dstrect.y = wnd->windowRect.top*(int)scaleY/100 + scaleYOffset;
-                    dstrect.w = wnd->sdlTextureWidth*(int)scaleX/100;
-                    dstrect.h = wnd->sdlTextureHeight*(int)scaleY/100;
+        presentWindows();
+        DISPATCH_MAIN_THREAD_BLOCK_END
+    }
+    KNativeWindow::windowUpdated = true;
+}
+
+// must be called on the main thread with sdlMutex held
+void KNativeWindowSdl::presentWindows() {
+    presentPending = false;
+    lastPresentTime = KSystem::getMilliesSinceStart();
+    if (!KSystem::videoEnabled || !renderer) {
+        return;
+    }
+    SDL_SetRenderDrawColor(renderer, 58, 110, 165, 255 );
+    SDL_RenderClear(renderer);
+    for (int i=(int)presentOrder.size()-1;i>=0;i--) {
+        std::shared_ptr<WndSdl> wnd = getWndSdl(presentOrder[i]);
+        if (wnd && wnd->sdlTextureWidth && wnd->sdlTexture) {
+            SDL_Rect dstrect;
+            dstrect.x = wnd->windowRect.left*(int)scaleX/100 + scaleXOffset;
+            dstrect.y = wnd->windowRect.top*(int)scaleY/100 + scaleYOffset;
+            dstrect.w = wnd->sdlTextureWidth*(int)scaleX/100;
+            dstrect.h = wnd->sdlTextureHeight*(int)scaleY/100;
 #ifndef BOXEDWINE_FLIP_MANUALLY
-                    SDL_RenderCopyEx(renderer, wnd->sdlTexture, NULL, &dstrect, 0, NULL, SDL_FLIP_VERTICAL);
+            SDL_RenderCopyEx(renderer, wnd->sdlTexture, NULL, &dstrect, 0, NULL, SDL_FLIP_VERTICAL);
 #else
-                    SDL_RenderCopy(renderer, wnd->sdlTexture, NULL, &dstrect);
+            SDL_RenderCopy(renderer, wnd->sdlTexture, NULL, &dstrect);
 #endif
-                }
-            }
-            if (desktopTexture) {
-                SDL_Rect dstrect;
-                dstrect.x = scaleXOffset;
-                dstrect.y = scaleYOffset;
-                dstrect.w = this->screenWidth() * (int)scaleX / 100;
-                dstrect.h = this->screenHeight() * (int)scaleY / 100;
-                SDL_RenderCopyEx(renderer, desktopTexture, NULL, &dstrect, 0, NULL, SDL_FLIP_NONE);
-            }
-            if (scaleXOffset) {                
-                SDL_Rect rect;
-                rect.x = 0;
-                rect.w = scaleXOffset;
-                rect.y = 0;
-                rect.h = sdlDesktopHeight;
-                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-                SDL_RenderFillRect(renderer, &rect);
-                rect.x = sdlDesktopWidth - scaleXOffset;
-                SDL_RenderFillRect(renderer, &rect);
-            }
         }
-        SDL_RenderPresent(renderer);
-        DISPATCH_MAIN_THREAD_BLOCK_END
     }
-    KNativeWindow::windowUpdated = true;
+    if (desktopTexture) {
+        SDL_Rect dstrect;
+        dstrect.x = scaleXOffset;
+        dstrect.y = scaleYOffset;
+        dstrect.w = this->screenWidth() * (int)scaleX / 100;
+        dstrect.h = this->screenHeight() * (int)scaleY / 100;
+        SDL_RenderCopyEx(renderer, desktopTexture, NULL, &dstrect, 0, NULL, SDL_FLIP_NONE);
+    }
+    if (scaleXOffset) {                
+        SDL_Rect rect;
+        rect.x = 0;
+        rect.w = scaleXOffset;
+        rect.y = 0;
+        rect.h = sdlDesktopHeight;
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderFillRect(renderer, &rect);
+        rect.x = sdlDesktopWidth - scaleXOffset;
+        SDL_RenderFillRect(renderer, &rect);
+    }
+    SDL_RenderPresent(renderer);
 }
 
 std::shared_ptr<Wnd> KNativeWindowSdl::createWnd(KThread* thread, U32 processId, U32 hwnd, U32 windowRect, U32 clientRect) {
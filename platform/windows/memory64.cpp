@@ -156,6 +156,31 @@ void releaseNativeMemory(Memory* memory) {
 #endif
 }
 
+bool cloneNativeMemory(Memory* memory, Memory* from) {
+    // :TODO: a section created with CreateFileMapping could be mapped copy-on-write with FILE_MAP_COPY
+    return false;
+}
+
+bool mapNativeFile(Memory* memory, U32 page, U32 pageCount, const std::string& nativePath, U64 offset) {
+    // :TODO: MapViewOfFile3 can place a FILE_MAP_COPY view into a placeholder, but it needs 64k alignment
+    return false;
+}
+
+void unmapNativeFile(Memory* memory, U32 page, U32 pageCount) {
+}
+
+std::shared_ptr<NativeMemoryFile> createNativeMemoryFile(U64 length) {
+    return nullptr;
+}
+
+bool writeNativeMemoryFile(NativeMemoryFile* file, U64 offset, U8* data, U32 len) {
+    return false;
+}
+
+bool mapNativeMemoryFile(Memory* memory, U32 page, U32 pageCount, const std::shared_ptr<NativeMemoryFile>& file, U64 offset) {
+    return false;
+}
+
 void makeCodePageReadOnly(Memory* memory, U32 page) {
     DWORD oldProtect;
 
@@ -21,6 +21,7 @@
 #include "pixelformat.h"
 #include "../source/emulation/cpu/binaryTranslation/btCpu.h"
 #include <VersionHelpers.h>
+#include <io.h>
 
 LONGLONG PCFreq;
 LONGLONG CounterStart;
@@ -429,6 +430,18 @@ U32 Platform::updateNativePermission(U64 address, U32 permission, U32 len) {
     return 0;
 }
 
+S64 Platform::pread(int handle, void* buffer, U32 len, U64 offset) {
+    OVERLAPPED overlapped = {0};
+    DWORD read = 0;
+
+    overlapped.Offset = (DWORD)offset;
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+    if (!ReadFile((HANDLE)_get_osfhandle(handle), buffer, len, &read, &overlapped)) {
+        return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+    }
+    return read;
+}
+
 U32 Platform::nanoSleep(U64 nano) {
     U32 millies = (U32)(nano / 1000000);
     LARGE_INTEGER startTime;
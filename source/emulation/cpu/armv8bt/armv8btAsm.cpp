@@ -16,7 +16,7 @@ static bool isWidthVector(VectorWidth width) {
 }
 
 U32 Armv8btAsm::flagsNeeded() {
-    return DecodedOp::getNeededFlags(this->currentBlock, this->decodedOp, instructionInfo[this->decodedOp->inst].flagsSets & ~MAYBE);
+    return this->flagsLiveOut[this->decodedOpIndex] & instructionInfo[this->decodedOp->inst].flagsSets & ~MAYBE;
 }
 
 void Armv8btAsm::pushPair(U8 r1, U8 r2) {
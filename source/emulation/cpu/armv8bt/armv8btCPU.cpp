@@ -391,8 +391,9 @@ void Armv8btCPU::markCodePageReadOnly(Armv8btAsm* data) {
 
 void Armv8btCPU::makePendingCodePagesReadOnly() {
     for (int i=0;i<(int)this->pendingCodePages.size();i++) {
-        // the chunk could cross a page and be a mix of dynamic and non dynamic code
-        if (this->thread->memory->dynamicCodePageUpdateCount[this->pendingCodePages[i]]!=MAX_DYNAMIC_CODE_PAGE_COUNT) {
+        // the chunk could cross a page and be a mix of dynamic and non dynamic code, a page that a BtCodeMemoryWrite
+        // has writable will have this code cleared when it is done
+        if (this->thread->memory->dynamicCodePageUpdateCount[this->pendingCodePages[i]]!=MAX_DYNAMIC_CODE_PAGE_COUNT && !this->thread->memory->isCodePageBeingWritten(this->pendingCodePages[i])) {
             ::makeCodePageReadOnly(this->thread->memory, this->pendingCodePages[i]);
         }
     }
@@ -445,6 +446,8 @@ void Armv8btCPU::translateData(Armv8btAsm* data, Armv8btAsm* firstPass) {
     DecodedBlock block;
     data->currentBlock = &block;
     decodeBlock(fetchByte, data->startOfDataIp + this->seg[CS].address, this->isBig(), 0, 0, 0, &block);
+    DecodedOp::getFlagLiveness(&block, data->startOfDataIp + this->seg[CS].address, this->isBig(), data->flagsLiveOut);
+    data->decodedOpIndex = 0;
     DecodedOp* op = block.op;
     while (op) {  
         U32 address = data->cpu->seg[CS].address+data->ip;
@@ -483,6 +486,7 @@ void Armv8btCPU::translateData(Armv8btAsm* data, Armv8btAsm* firstPass) {
         data->decodedOp = op;
         translateInstruction(data, firstPass);
         op = op->next;
+        data->decodedOpIndex++;
         if (data->done) {
             break;
         }
@@ -498,6 +502,8 @@ void Armv8btCPU::translateData(Armv8btAsm* data, Armv8btAsm* firstPass) {
         if (!op) {
             block.op->dealloc(true);
             decodeBlock(fetchByte, data->startOfOpIp + this->seg[CS].address, this->isBig(), 0, 0, 0, &block);
+            DecodedOp::getFlagLiveness(&block, data->startOfOpIp + this->seg[CS].address, this->isBig(), data->flagsLiveOut);
+            data->decodedOpIndex = 0;
             op = block.op;
         }
     }     
@@ -791,6 +797,8 @@ void Armv8btCPU::startThread() {
     }
     std::shared_ptr<KProcess> process = thread->process;
 	process->deleteThread(thread);
+    DecodedOp::releaseThreadCache();
+    NormalCPU::releaseThreadCache();
 
     platformThreadCount--;
     if (platformThreadCount==0) {
@@ -26,6 +26,7 @@ Armv8btData::Armv8btData(Armv8btCPU* cpu) : cpu(cpu) {
     this->stopAfterInstruction = -1;
     this->dynamic = false;
     this->currentBlock = NULL;
+    this->decodedOpIndex = 0;
     this->fpuTopRegSet = false;
     this->fpuOffsetRegSet = false;
     this->clearCachedFpuRegs();
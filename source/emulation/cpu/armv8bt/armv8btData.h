@@ -34,6 +34,9 @@ public:
 
     DecodedOp* decodedOp;
     DecodedBlock* currentBlock;
+    // flagsLiveOut[decodedOpIndex] is the flags that decodedOp must leave correct, see DecodedOp::getFlagLiveness
+    std::vector<U32> flagsLiveOut;
+    U32 decodedOpIndex;
 
     U32 ip;
     U32 startOfDataIp;
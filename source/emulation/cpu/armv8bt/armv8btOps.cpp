@@ -4556,7 +4556,7 @@ void opCmpXchg8b(Armv8btAsm* data) {
     //     EDX = (U32)(value2 >> 32);
     //     EAX = (U32)value2;
     // }
-    U32 flags = DecodedOp::getNeededFlags(data->currentBlock, data->decodedOp, CF | SF | PF | AF | OF | ZF);
+    U32 flags = data->flagsLiveOut[data->decodedOpIndex] & (CF | SF | PF | AF | OF | ZF);
     
     U8 addressReg = data->getAddressReg();    
     U8 tmpReg = data->getTmpReg();
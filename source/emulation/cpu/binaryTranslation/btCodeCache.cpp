@@ -0,0 +1,214 @@
+#include "boxedwine.h"
+
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+#include "btCodeCache.h"
+#include "crc.h"
+#ifdef BOXEDWINE_X64
+#include "../x64/x64CPU.h"
+#endif
+
+#define BT_CODE_CACHE_MAGIC 0x43545742 // BWTC
+#define BT_CODE_CACHE_VERSION 2
+
+U32 BtCodeCache::hits;
+U32 BtCodeCache::misses;
+bool BtCodeCache::loaded;
+bool BtCodeCache::dirty;
+std::unordered_map<U32, std::vector<std::shared_ptr<BtCodeCacheEntry>>> BtCodeCache::entries;
+BOXEDWINE_MUTEX BtCodeCache::mutex;
+
+bool BtCodeCache::isEnabled() {
+    return KSystem::translationCachePath.length() != 0;
+}
+
+U64 BtCodeCache::getImageAnchor() {
+    return (U64)&BtCodeCache::getImageAnchor;
+}
+
+// If anything that the translator depends on changes, then the cache on disk is no longer valid.  The
+// distance between a few symbols will catch most rebuilds of the executable.
+U64 BtCodeCache::getFingerprint() {
+    std::string version = BOXEDWINE_VERSION_STR;
+    U64 result = crc32b((unsigned char*)version.c_str(), (int)version.length());
+    result = result * 31 + ((U64)&KSystem::destroy - getImageAnchor());
+    result = result * 31 + (KSystem::useLargeAddressSpace ? 1 : 0);
+#ifdef BOXEDWINE_X64
+    result = result * 31 + ((U64)&x64CPU::hasBMI2 - getImageAnchor());
+    result = result * 31 + (x64CPU::hasBMI2 ? 1 : 0);
+    result = result * 31 + sizeof(x64CPU);
+#endif
+    return result;
+}
+
+bool BtCodeCache::makeHostPointerRelative(U8* hostPointer) {
+    U64 value;
+    memcpy(&value, hostPointer, 8);
+    S64 diff = (S64)(value - getImageAnchor());
+    if (diff < -(S64)0x80000000l || diff >(S64)0x7FFFFFFFl) {
+        return false; // not part of the Boxedwine image, so it can't be relocated
+    }
+    memcpy(hostPointer, &diff, 8);
+    return true;
+}
+
+void BtCodeCache::makeHostPointerAbsolute(U8* hostPointer) {
+    U64 value;
+    memcpy(&value, hostPointer, 8);
+    value += getImageAnchor();
+    memcpy(hostPointer, &value, 8);
+}
+
+U32 BtCodeCache::crcEmulatedCode(U32 address, U32 len) {
+    U8 buffer[K_PAGE_SIZE];
+    U32 result = 0;
+
+    // the crc is chained 1 page at a time
+    while (len) {
+        U32 todo = len > K_PAGE_SIZE ? K_PAGE_SIZE : len;
+        readMemory(buffer, address, todo);
+        result = result * 31 + crc32b(buffer, todo);
+        address += todo;
+        len -= todo;
+    }
+    return result;
+}
+
+std::shared_ptr<BtCodeCacheEntry> BtCodeCache::find(U32 eip) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(mutex);
+    if (!loaded) {
+        load();
+    }
+    auto it = entries.find(eip);
+    if (it != entries.end()) {
+        Memory* memory = KThread::currentThread()->memory;
+
+        for (auto& entry : it->second) {
+            if (memory->isValidReadAddress(entry->eip, entry->eipLen) && crcEmulatedCode(entry->eip, entry->eipLen) == entry->crc) {
+                hits++;
+                return entry;
+            }
+        }
+    }
+    misses++;
+    return nullptr;
+}
+
+void BtCodeCache::add(const std::shared_ptr<BtCodeCacheEntry>& entry) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(mutex);
+    if (!loaded) {
+        load();
+    }
+    std::vector<std::shared_ptr<BtCodeCacheEntry>>& list = entries[entry->eip];
+    for (auto& existing : list) {
+        if (existing->crc == entry->crc && existing->eipLen == entry->eipLen) {
+            return;
+        }
+    }
+    list.push_back(entry);
+    dirty = true;
+}
+
+static void writeU32(FILE* f, U32 value) {
+    fwrite(&value, 4, 1, f);
+}
+
+static bool readU32(FILE* f, U32* value) {
+    return fread(value, 4, 1, f) == 1;
+}
+
+template <typename T>
+static void writeVector(FILE* f, const std::vector<T>& v) {
+    writeU32(f, (U32)v.size());
+    if (v.size()) {
+        fwrite(v.data(), sizeof(T), v.size(), f);
+    }
+}
+
+template <typename T>
+static bool readVector(FILE* f, std::vector<T>& v) {
+    U32 size;
+    if (!readU32(f, &size) || size > 0x1000000) {
+        return false;
+    }
+    v.resize(size);
+    return size == 0 || fread(v.data(), sizeof(T), size, f) == size;
+}
+
+void BtCodeCache::load() {
+    loaded = true;
+    FILE* f = fopen(KSystem::translationCachePath.c_str(), "rb");
+    if (!f) {
+        return;
+    }
+    U32 magic = 0;
+    U32 version = 0;
+    U64 fingerprint = 0;
+    U32 count = 0;
+
+    if (!readU32(f, &magic) || !readU32(f, &version) || fread(&fingerprint, 8, 1, f) != 1 || !readU32(f, &count) || magic != BT_CODE_CACHE_MAGIC || version != BT_CODE_CACHE_VERSION) {
+        klog("translation cache %s is not valid, it will be replaced", KSystem::translationCachePath.c_str());
+        fclose(f);
+        return;
+    }
+    if (fingerprint != getFingerprint()) {
+        klog("translation cache %s was created by a different build of Boxedwine, it will be replaced", KSystem::translationCachePath.c_str());
+        fclose(f);
+        return;
+    }
+    for (U32 i = 0; i < count; i++) {
+        std::shared_ptr<BtCodeCacheEntry> entry = std::make_shared<BtCodeCacheEntry>();
+        if (!readU32(f, &entry->eip) || !readU32(f, &entry->eipLen) || !readU32(f, &entry->crc) ||
+            !readVector(f, entry->instructionEip) || !readVector(f, entry->instructionHostPos) || !readVector(f, entry->host) || !readVector(f, entry->links) || !readVector(f, entry->hostPointers) || !readU32(f, &entry->hotChunkCounterPos)) {
+            klog("translation cache %s is truncated, only %d of %d chunks were loaded", KSystem::translationCachePath.c_str(), i, count);
+            break;
+        }
+        entries[entry->eip].push_back(entry);
+    }
+    fclose(f);
+}
+
+void BtCodeCache::save() {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(mutex);
+    if (!isEnabled() || !dirty) {
+        return;
+    }
+    std::string tmpPath = KSystem::translationCachePath + ".tmp";
+    FILE* f = fopen(tmpPath.c_str(), "wb");
+    if (!f) {
+        klog("could not write translation cache %s", tmpPath.c_str());
+        return;
+    }
+    U32 count = 0;
+    for (auto& it : entries) {
+        count += (U32)it.second.size();
+    }
+    U64 fingerprint = getFingerprint();
+    writeU32(f, BT_CODE_CACHE_MAGIC);
+    writeU32(f, BT_CODE_CACHE_VERSION);
+    fwrite(&fingerprint, 8, 1, f);
+    writeU32(f, count);
+    for (auto& it : entries) {
+        for (auto& entry : it.second) {
+            writeU32(f, entry->eip);
+            writeU32(f, entry->eipLen);
+            writeU32(f, entry->crc);
+            writeVector(f, entry->instructionEip);
+            writeVector(f, entry->instructionHostPos);
+            writeVector(f, entry->host);
+            writeVector(f, entry->links);
+            writeVector(f, entry->hostPointers);
+            writeU32(f, entry->hotChunkCounterPos);
+        }
+    }
+    fclose(f);
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, KSystem::translationCachePath, ec);
+    if (ec) {
+        klog("could not replace translation cache %s: %s", KSystem::translationCachePath.c_str(), ec.message().c_str());
+        return;
+    }
+    dirty = false;
+    klog("translation cache: saved %d chunks (%d hits, %d misses this run)", count, hits, misses);
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef __BT_CODE_CACHE_H__
+#define __BT_CODE_CACHE_H__
+
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+
+class BtCodeCacheLink {
+public:
+    BtCodeCacheLink() : eip(0), bufferPos(0), offsetSize(0), sameChunk(true) {}
+    BtCodeCacheLink(U32 eip, U32 bufferPos, U8 offsetSize, bool sameChunk) : eip(eip), bufferPos(bufferPos), offsetSize(offsetSize), sameChunk(sameChunk) {}
+    U32 eip;
+    U32 bufferPos;
+    U8 offsetSize;
+    bool sameChunk;
+};
+
+// A translated chunk in a form that can be written to disk and loaded on a later run.
+//
+// The host code is stored before it was linked, the links are replayed when the chunk is loaded.  Any 8 byte
+// pointers to Boxedwine functions or data that were embedded in the host code are stored relative to
+// BtCodeCache::getImageAnchor so that they survive the executable being loaded at a different address.
+class BtCodeCacheEntry {
+public:
+    BtCodeCacheEntry() : eip(0), eipLen(0), crc(0), hotChunkCounterPos(0) {}
+
+    U32 eip; // linear address, the cache is only used when CS has a base of 0
+    U32 eipLen;
+    U32 crc; // crc of the emulated code bytes [eip, eip+eipLen) that were translated
+    std::vector<U32> instructionEip;
+    std::vector<U32> instructionHostPos;
+    std::vector<U8> host;
+    std::vector<BtCodeCacheLink> links;
+    std::vector<U32> hostPointers; // offsets into host
+    U32 hotChunkCounterPos; // offset into host of the pointer to the chunk's entry counter, 0 if there isn't one
+};
+
+class BtCodeCache {
+public:
+    static bool isEnabled();
+
+    // returns an entry that starts at eip and whose emulated code bytes still match the current memory
+    static std::shared_ptr<BtCodeCacheEntry> find(U32 eip);
+    static void add(const std::shared_ptr<BtCodeCacheEntry>& entry);
+    static void save();
+
+    static U32 crcEmulatedCode(U32 address, U32 len);
+    static bool makeHostPointerRelative(U8* hostPointer);
+    static void makeHostPointerAbsolute(U8* hostPointer);
+
+    static U32 hits;
+    static U32 misses;
+private:
+    static U64 getImageAnchor();
+    static U64 getFingerprint();
+    static void load();
+
+    static bool loaded;
+    static bool dirty;
+    static std::unordered_map<U32, std::vector<std::shared_ptr<BtCodeCacheEntry>>> entries;
+    static BOXEDWINE_MUTEX mutex;
+};
+
+#endif
+
+#endif
@@ -14,6 +14,8 @@ BtCodeChunk::BtCodeChunk(U32 instructionCount, U32* eipInstructionAddress, U32*
     this->emulatedInstructionLen = new U8[instructionCount];
     this->hostInstructionLen = new U32[instructionCount];
     this->dynamic = dynamic;
+    this->linkPlaceholder = false;
+    this->hotCounter = NULL;
 
     Platform::writeCodeToMemory(this->hostAddress, this->hostAddressSize, [this]() {
         memset(this->hostAddress, 0xce, this->hostAddressSize);
@@ -94,7 +96,15 @@ void BtCodeChunk::release(Memory* memory) {
 }
 
 void BtCodeChunk::internalDealloc() {
-    KThread::currentThread()->memory->freeExcutableMemory(this->hostAddress, this->hostAddressSize);
+    if (this->hostAddress) {
+        Memory* memory = KThread::currentThread()->memory;
+        memory->freeExcutableMemory(this->hostAddress, this->hostAddressSize);
+        // if the host code is left in place because it might still be running, it can still count down the counter
+        if (this->hotCounter) {
+            memory->freeHotChunkCounters.push_back(this->hotCounter);
+        }
+    }
+    this->hotCounter = NULL;
     this->hostAddress = NULL;
     delete[] this->emulatedInstructionLen;
     this->emulatedInstructionLen = NULL;
@@ -158,13 +168,35 @@ std::shared_ptr<BtCodeChunkLink> BtCodeChunk::addLinkFrom(std::shared_ptr<BtCode
     return link;
 }
 
-void BtCodeChunk::releaseAndRetranslate() {
+void BtCodeChunk::releaseAndRetranslate(bool mightStillBeRunning) {
     // remove this chunk and its mappings from being used (since it is about to be replaced)
     BtCPU* cpu = (BtCPU*)KThread::currentThread()->cpu;
     detachFromHost(cpu->thread->memory);
 
     std::shared_ptr<BtCodeChunk> chunk = cpu->translateChunk(this->emulatedAddress - cpu->seg[CS].address);
     cpu->makePendingCodePagesReadOnly();
+    relinkTo(chunk);
+    chunk->makeLive();
+
+    if (mightStillBeRunning) {
+        // Another thread could have just read a link to this chunk and be about to run it, so the host code is
+        // left in place until the memory is released.
+        this->hostAddress = NULL;
+    }
+    this->internalDealloc(); // don't call dealloc() because the new chunk occupies the memory cache and we don't want to mess with it
+}
+
+void BtCodeChunk::replaceWith(std::shared_ptr<BtCodeChunk>& chunk) {
+    detachFromHost(KThread::currentThread()->memory);
+    relinkTo(chunk);
+    // another thread might be running this chunk
+    this->hostAddress = NULL;
+    this->internalDealloc();
+}
+
+void BtCodeChunk::relinkTo(std::shared_ptr<BtCodeChunk>& chunk) {
+    BtCPU* cpu = (BtCPU*)KThread::currentThread()->cpu;
+
     for (auto& link : this->linksFrom) {
         U64 destHost = (U64)chunk->getHostFromEip(link->toEip);
 
@@ -183,9 +215,6 @@ void BtCodeChunk::releaseAndRetranslate() {
             }
         }
     };
-    chunk->makeLive();
-
-    this->internalDealloc(); // don't call dealloc() because the new chunk occupies the memory cache and we don't want to mess with it
 }
 
 void BtCodeChunk::clearInstructionCache(U8* hostAddress, U32 len) {
@@ -24,7 +24,9 @@ public:
     virtual bool retranslateSingleInstruction(BtCPU* cpu, void* address) = 0;
 
     void release(Memory* memory);
-    void releaseAndRetranslate();
+    void releaseAndRetranslate(bool mightStillBeRunning = false);
+    // chunk was translated over the same code as this chunk (and more), anything that linked to this chunk will now link to chunk
+    void replaceWith(std::shared_ptr<BtCodeChunk>& chunk);
     void invalidateStartingAt(U32 eipAddress);
     void makeLive();
 
@@ -43,11 +45,16 @@ public:
     U32 getEip() { return emulatedAddress; }
     U32 getEipLen() { return emulatedLen; }
     bool isDynamicAware() { return this->dynamic; }
+    bool isLinkPlaceholder() { return this->linkPlaceholder; }
+    void setLinkPlaceholder() { this->linkPlaceholder = true; }
+    void setHotCounter(S32* counter) { this->hotCounter = counter; }
+    bool isHot() { return this->hotCounter && *this->hotCounter <= 0; }
     U32 getStartOfInstructionByEip(U32 eip, U8** hostAddress, U32* index);
     
 protected:
     void detachFromHost(Memory* memory);
     void internalDealloc();
+    void relinkTo(std::shared_ptr<BtCodeChunk>& chunk);
     virtual void clearInstructionCache(U8* hostAddress, U32 len);
 
     U32 emulatedAddress;
@@ -65,6 +72,8 @@ protected:
     std::list<std::shared_ptr<BtCodeChunkLink>> linksFrom;
 
     bool dynamic; // will include a check of the original vs current code bytes to make sure it is still valid at a per instruction level
+    bool linkPlaceholder; // created by a link to code that hasn't been translated yet, it only contains a stub that will translate it
+    S32* hotCounter; // counts down each time the chunk is entered, owned by Memory
 };
 
 #endif
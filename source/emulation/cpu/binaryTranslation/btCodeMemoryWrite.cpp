@@ -4,11 +4,59 @@
 #include "btCpu.h"
 #include "../../hardmmu/hard_memory.h"
 
-BtCodeMemoryWrite::BtCodeMemoryWrite(BtCPU* cpu, U32 address, U32 len) : cpu(cpu) {
+std::atomic<U32> BtCodeMemoryWrite::dataLineWrites;
+std::atomic<U32> BtCodeMemoryWrite::codeLineWrites;
+
+BtCodeMemoryWrite::BtCodeMemoryWrite(BtCPU* cpu, U32 address, U32 len, bool keepCode) : cpu(cpu), keepCode(keepCode) {
     this->invalidateCode(address, len);
 }
 
-BtCodeMemoryWrite::BtCodeMemoryWrite(BtCPU* cpu) : cpu(cpu) {
+BtCodeMemoryWrite::BtCodeMemoryWrite(BtCPU* cpu, bool keepCode) : cpu(cpu), keepCode(keepCode) {
+}
+
+BtCodeMemoryWrite::~BtCodeMemoryWrite() {
+    if (this->pages.empty()) {
+        return;
+    }
+    Memory* memory = this->cpu->thread->memory;
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(memory->executableMemoryMutex);
+
+    for (auto& p : this->pages) {
+        U32 emulatedPage = memory->getEmulatedPage(p.nativePage);
+        U32 pos = 0;
+        bool changed = false;
+        bool hasCode = false;
+        bool lastWriter = memory->endCodePageWrite(p.nativePage);
+
+        for (U32 i = 0; i < K_NATIVE_PAGES_PER_PAGE; i++) {
+            U8* address = (U8*)getNativeAddress(memory, (emulatedPage + i) << K_PAGE_SHIFT);
+            // lines that lost their code in the mean time were already dealt with
+            U64 codeLines = memory->getCodeLines(emulatedPage + i);
+
+            for (U32 line = 0; line < 64; line++) {
+                if (p.codeLines[i] & ((U64)1 << line)) {
+                    if ((codeLines & ((U64)1 << line)) && memcmp(address + (line << K_CODE_LINE_SHIFT), p.code.data() + pos, 1 << K_CODE_LINE_SHIFT)) {
+                        changed = true;
+                    }
+                    pos += 1 << K_CODE_LINE_SHIFT;
+                }
+            }
+            if (codeLines & ~p.codeLines[i]) {
+                // translated while the page was writable, so a write in the mean time might not be in it
+                changed = true;
+            }
+            if (codeLines) {
+                hasCode = true;
+            }
+        }
+        if (changed) {
+            // another thread wrote to the code while the page was writable
+            codeLineWrites.fetch_add(1, std::memory_order_relaxed);
+            memory->clearHostCodeForWriting(p.nativePage, 1);
+        } else if (lastWriter && hasCode && memory->dynamicCodePageUpdateCount[p.nativePage] != MAX_DYNAMIC_CODE_PAGE_COUNT) {
+            ::makeCodePageReadOnly(memory, p.nativePage);
+        }
+    }
 }
 
 void BtCodeMemoryWrite::invalidateStringWriteToDi(bool repeat, U32 size) {
@@ -29,17 +77,112 @@ void BtCodeMemoryWrite::invalidateStringWriteToDi(bool repeat, U32 size) {
     invalidateCode(addressStart, addressLen);
 }
 
+void BtCodeMemoryWrite::unprotect(U32 nativePage) {
+    Memory* memory = this->cpu->thread->memory;
+    U32 emulatedPage = memory->getEmulatedPage(nativePage);
+
+    for (auto& p : this->pages) {
+        if (p.nativePage == nativePage) {
+            return;
+        }
+    }
+    memory->beginCodePageWrite(nativePage);
+    this->pages.push_back(BtCodeMemoryWritePage(nativePage));
+    BtCodeMemoryWritePage& p = this->pages.back();
+    for (U32 i = 0; i < K_NATIVE_PAGES_PER_PAGE; i++) {
+        U8* address = (U8*)getNativeAddress(memory, (emulatedPage + i) << K_PAGE_SHIFT);
+        p.codeLines[i] = memory->getCodeLines(emulatedPage + i);
+        for (U32 line = 0; line < 64; line++) {
+            if (p.codeLines[i] & ((U64)1 << line)) {
+                p.code.insert(p.code.end(), address + (line << K_CODE_LINE_SHIFT), address + ((line + 1) << K_CODE_LINE_SHIFT));
+            }
+        }
+    }
+    ::clearCodePageReadOnly(memory, nativePage);
+}
+
+// A write that keeps the code still costs a fault or a lock and two mprotects, so it counts toward making the page
+// dynamic just like a write that clears the code.  Returns false once the page has had too many writes, then the
+// code is cleared, which will make the page dynamic.
+static bool countDataLineWrite(Memory* memory, U32 nativePage) {
+    if (memory->dynamicCodePageUpdateCount[nativePage] >= MAX_DYNAMIC_CODE_PAGE_COUNT - 1) {
+        return false;
+    }
+    memory->dynamicCodePageUpdateCount[nativePage]++;
+    return true;
+}
+
 void BtCodeMemoryWrite::invalidateCode(U32 addressStart, U32 addressLen) {
-    U32 pageStart = this->cpu->thread->memory->getNativePage(addressStart >> K_PAGE_SHIFT);
-    U32 pageStop = this->cpu->thread->memory->getNativePage((addressStart + addressLen - 1) >> K_PAGE_SHIFT);
+    Memory* memory = this->cpu->thread->memory;
+    U32 pageStart = memory->getNativePage(addressStart >> K_PAGE_SHIFT);
+    U32 pageStop = memory->getNativePage((addressStart + addressLen - 1) >> K_PAGE_SHIFT);
+    bool hasCode = false;
 
     for (U32 page = pageStart; page <= pageStop; page++) {
-        if (cpu->thread->memory->nativeFlags[page] & NATIVE_FLAG_CODEPAGE_READONLY) {
-            BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(cpu->thread->memory->executableMemoryMutex);
-            this->cpu->thread->memory->clearHostCodeForWriting(pageStart, pageStop - pageStart + 1);
+        if ((memory->nativeFlags[page] & NATIVE_FLAG_CODEPAGE_READONLY) || memory->isCodePageBeingWritten(page)) {
+            hasCode = true;
+        }
+    }
+    if (!hasCode) {
+        return;
+    }
+    // the lock is only held while the pages change between read only and writable, a page that another
+    // BtCodeMemoryWrite made writable stays writable until both are done with it
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(memory->executableMemoryMutex);
+    if (this->keepCode && !memory->isCodeLineWrite(addressStart, addressLen)) {
+        bool keep = true;
+
+        for (U32 page = pageStart; page <= pageStop; page++) {
+            if (((memory->nativeFlags[page] & NATIVE_FLAG_CODEPAGE_READONLY) || memory->isCodePageBeingWritten(page)) && !countDataLineWrite(memory, page)) {
+                keep = false;
+            }
+        }
+        if (keep) {
+            dataLineWrites.fetch_add(1, std::memory_order_relaxed);
+            for (U32 page = pageStart; page <= pageStop; page++) {
+                if ((memory->nativeFlags[page] & NATIVE_FLAG_CODEPAGE_READONLY) || memory->isCodePageBeingWritten(page)) {
+                    this->unprotect(page);
+                }
+            }
             return;
         }
-    }    
+    }
+    codeLineWrites.fetch_add(1, std::memory_order_relaxed);
+    memory->clearHostCodeForWriting(pageStart, pageStop - pageStart + 1);
+}
+
+bool BtCodeMemoryWrite::emulateDataLineStore(BtCPU* cpu, DecodedOp* op) {
+    U32 address;
+    U32 value;
+
+    switch (op->inst) {
+    case MovE8R8: address = eaa(cpu, op); value = *cpu->reg8[op->reg]; break;
+    case MovE8I8: address = eaa(cpu, op); value = op->imm; break;
+    case MovE16R16: address = eaa(cpu, op); value = cpu->reg[op->reg].u16; break;
+    case MovE16I16: address = eaa(cpu, op); value = op->imm; break;
+    case MovE32R32: address = eaa(cpu, op); value = cpu->reg[op->reg].u32; break;
+    case MovE32I32: address = eaa(cpu, op); value = op->imm; break;
+    case MovObAl: address = cpu->seg[op->base].address + op->disp; value = AL; break;
+    case MovOwAx: address = cpu->seg[op->base].address + op->disp; value = AX; break;
+    case MovOdEax: address = cpu->seg[op->base].address + op->disp; value = EAX; break;
+    default: return false;
+    }
+    Memory* memory = cpu->thread->memory;
+    U32 len = instructionInfo[op->inst].writeMemWidth / 8;
+
+    // the translated code will fault again if the page isn't writable for some other reason
+    if (!(memory->flags[address >> K_PAGE_SHIFT] & PAGE_WRITE) || !(memory->flags[(address + len - 1) >> K_PAGE_SHIFT] & PAGE_WRITE)) {
+        return false;
+    }
+    if (memory->isCodeLineWrite(address, len)) {
+        return false;
+    }
+    switch (len) {
+    case 1: writeb(address, (U8)value); break;
+    case 2: writew(address, (U16)value); break;
+    case 4: writed(address, value); break;
+    }
+    return true;
 }
 
 #endif
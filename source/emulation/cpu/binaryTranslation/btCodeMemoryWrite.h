@@ -5,15 +5,42 @@
 
 class BtCPU;
 
+class BtCodeMemoryWritePage {
+public:
+    BtCodeMemoryWritePage(U32 nativePage) : nativePage(nativePage) {}
+    U32 nativePage;
+    U64 codeLines[K_NATIVE_PAGES_PER_PAGE];
+    std::vector<U8> code; // copy of the code lines, so that a write by another thread can be detected
+};
+
+// Makes sure the memory about to be written isn't protected because it holds translated code.
+//
+// If the write only touches 64 byte lines that don't hold translated code, the code is kept and the pages are only
+// writable until this object goes out of scope.  Code that another thread translates on those pages in the mean time
+// is cleared then, since the write might have changed it after it was translated.  keepCode should be false if the
+// write can block, so that the pages don't stay writable.
 class BtCodeMemoryWrite {
 public:
-    BtCodeMemoryWrite(BtCPU* cpu);
-    BtCodeMemoryWrite(BtCPU* cpu, U32 address, U32 len);
+    BtCodeMemoryWrite(BtCPU* cpu, bool keepCode=true);
+    BtCodeMemoryWrite(BtCPU* cpu, U32 address, U32 len, bool keepCode=true);
+    ~BtCodeMemoryWrite();
 
     void invalidateCode(U32 address, U32 len);
     void invalidateStringWriteToDi(bool repeat, U32 size);
+
+    // does a plain mov to memory that faulted because the page holds code, returns false if the op is something
+    // else or the write touches a line with code
+    static bool emulateDataLineStore(BtCPU* cpu, DecodedOp* op);
+
+    // counted on every emulated thread, only the totals at shutdown matter so they are relaxed
+    static std::atomic<U32> dataLineWrites; // writes to read only code pages that kept the code
+    static std::atomic<U32> codeLineWrites; // writes to read only code pages that threw away the code
 private:
+    void unprotect(U32 nativePage);
+
     BtCPU* cpu;
+    bool keepCode;
+    std::vector<BtCodeMemoryWritePage> pages;
 };
 #endif
-#endif
\ No newline at end of file
+#endif
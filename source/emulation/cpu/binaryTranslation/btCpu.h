@@ -22,6 +22,8 @@ public:
     virtual void makePendingCodePagesReadOnly() = 0;
     virtual std::shared_ptr<BtCodeChunk> translateChunk(U32 ip) = 0;
     virtual void* translateEip(U32 ip) = 0;
+    // called from a BtTranslationPool worker, returns false if nothing was translated
+    virtual bool translateSpeculatively(U32 ip) {return false;}
 #ifdef __TEST
     virtual void postTestRun() = 0;
 #endif
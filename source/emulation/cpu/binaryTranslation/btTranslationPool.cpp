@@ -0,0 +1,172 @@
+#include "boxedwine.h"
+
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+#include "btTranslationPool.h"
+#include "btCpu.h"
+#include "knativethread.h"
+
+// A speculative translation can create more link placeholders, which will be scheduled too.  This keeps a
+// worker from walking the entire call graph of an app.
+#define BT_TRANSLATION_POOL_MAX_DEPTH 2
+#define BT_TRANSLATION_POOL_MAX_JOBS 1024
+
+U32 BtTranslationPool::scheduled;
+U32 BtTranslationPool::translated;
+U32 BtTranslationPool::dropped;
+std::vector<KNativeThread*> BtTranslationPool::workers;
+std::deque<BtTranslationJob> BtTranslationPool::jobs;
+std::vector<BtTranslationJob> BtTranslationPool::inFlight;
+bool BtTranslationPool::done;
+BOXEDWINE_CONDITION BtTranslationPool::cond("BtTranslationPool::cond");
+
+static THREAD_LOCAL U32 currentDepth;
+static THREAD_LOCAL KThread* currentGuestThread; // the thread the worker's current job was scheduled for
+
+void BtTranslationPool::stop() {
+    {
+        BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(cond);
+        if (!workers.size()) {
+            return;
+        }
+        done = true;
+        dropped += (U32)jobs.size();
+        jobs.clear();
+        BOXEDWINE_CONDITION_SIGNAL_ALL(cond);
+    }
+    for (auto& worker : workers) {
+        worker->wait();
+        delete worker;
+    }
+    workers.clear();
+    done = false;
+    klog("translation pool: %d scheduled, %d translated, %d dropped", scheduled, translated, dropped);
+}
+
+void BtTranslationPool::schedule(CPU* cpu, U32 eip) {
+    if (!KSystem::translationThreads || currentDepth >= BT_TRANSLATION_POOL_MAX_DEPTH) {
+        return;
+    }
+    // on a worker, cpu belongs to a thread that only exists for the current job
+    KThread* thread = currentGuestThread ? currentGuestThread : cpu->thread;
+    BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(cond);
+    if (done) {
+        return;
+    }
+    // the workers are started the first time there is something for them to do
+    while (workers.size() < KSystem::translationThreads) {
+        workers.push_back(KNativeThread::createAndStartThread(workerThread, "BtTranslationPool", NULL));
+    }
+    if (jobs.size() >= BT_TRANSLATION_POOL_MAX_JOBS) {
+        // the oldest job is the least likely to still be useful
+        jobs.pop_front();
+        dropped++;
+    }
+    jobs.push_back(BtTranslationJob(thread, cpu->thread->memory, eip, cpu->isBig(), cpu->seg[CS].address, currentDepth + 1));
+    scheduled++;
+    BOXEDWINE_CONDITION_SIGNAL(cond);
+}
+
+bool BtTranslationPool::isInFlight(KThread* thread, Memory* memory) {
+    for (auto& job : inFlight) {
+        if (job.thread == thread || job.memory == memory) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BtTranslationPool::cancel(KThread* thread) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(cond);
+    for (auto it = jobs.begin(); it != jobs.end();) {
+        if (it->thread == thread) {
+            it = jobs.erase(it);
+            dropped++;
+        } else {
+            ++it;
+        }
+    }
+    while (isInFlight(thread, NULL)) {
+        BOXEDWINE_CONDITION_WAIT(cond);
+    }
+}
+
+void BtTranslationPool::cancel(Memory* memory) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(cond);
+    for (auto it = jobs.begin(); it != jobs.end();) {
+        if (it->memory == memory) {
+            it = jobs.erase(it);
+            dropped++;
+        } else {
+            ++it;
+        }
+    }
+    while (isInFlight(NULL, memory)) {
+        BOXEDWINE_CONDITION_WAIT(cond);
+    }
+}
+
+bool BtTranslationPool::translate(const BtTranslationJob& job) {
+    // The job is in flight, so the guest thread, and the process it holds, won't be deleted until this returns.  The
+    // translator is not added to the process, its id of 0 is never given to a real thread.
+    KThread* translator = new KThread(0, job.thread->process);
+    CPU* cpu = translator->cpu;
+    bool result;
+
+    translator->memory = job.memory;
+    cpu->setIsBig(job.big);
+    cpu->seg[CS].address = job.csAddress; // not setSeg, that would mark CS as set for the whole process
+    {
+        ChangeThread changeThread(translator);
+        currentDepth = job.depth;
+        currentGuestThread = job.thread;
+        result = ((BtCPU*)cpu)->translateSpeculatively(job.eip);
+        currentGuestThread = NULL;
+        currentDepth = 0;
+    }
+    delete translator;
+    return result;
+}
+
+int BtTranslationPool::workerThread(void* data) {
+    while (true) {
+        BtTranslationJob job;
+        {
+            BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(cond);
+            while (!done && !jobs.size()) {
+                BOXEDWINE_CONDITION_WAIT(cond);
+            }
+            if (done) {
+                break;
+            }
+            job = jobs.front();
+            jobs.pop_front();
+            if (job.thread->memory != job.memory) {
+                // the thread called exec since this was scheduled
+                dropped++;
+                continue;
+            }
+            inFlight.push_back(job);
+        }
+        bool result = translate(job);
+        {
+            BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(cond);
+            if (result) {
+                translated++;
+            } else {
+                dropped++;
+            }
+            for (auto it = inFlight.begin(); it != inFlight.end(); ++it) {
+                if (it->thread == job.thread && it->eip == job.eip) {
+                    inFlight.erase(it);
+                    break;
+                }
+            }
+            // cancel might be waiting on this job
+            BOXEDWINE_CONDITION_SIGNAL_ALL(cond);
+        }
+    }
+    DecodedOp::releaseThreadCache();
+    return 0;
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef __BT_TRANSLATION_POOL_H__
+#define __BT_TRANSLATION_POOL_H__
+
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+
+class KNativeThread;
+
+class BtTranslationJob {
+public:
+    BtTranslationJob() : thread(NULL), memory(NULL), eip(0), big(true), csAddress(0), depth(0) {}
+    BtTranslationJob(KThread* thread, Memory* memory, U32 eip, bool big, U32 csAddress, U32 depth) : thread(thread), memory(memory), eip(eip), big(big), csAddress(csAddress), depth(depth) {}
+
+    KThread* thread;
+    Memory* memory;
+    U32 eip;
+    // the code mode and CS base of the cpu that linked to eip, the worker translates with its own cpu
+    bool big;
+    U32 csAddress;
+    U32 depth; // how many speculative translations led to this one
+};
+
+// KSystem::translationThreads worker threads that translate the targets of links that were not translated yet,
+// before the guest jumps to them.  A worker never waits for the memory locks, if it can't get them right away the job
+// is dropped and the code will be translated normally the first time it runs.  Once a worker has the locks it holds
+// them for the whole translation, so a guest thread that needs to translate or change the code pages in the mean
+// time waits for that one chunk.  The guest thread keeps running while its code is translated, so a worker never uses
+// the guest's cpu, each job is translated on a cpu of its own that only shares the guest's process and memory.
+class BtTranslationPool {
+public:
+    // waits for the worker threads to exit, they will be started again by the next call to schedule
+    static void stop();
+
+    // called by the cpu that is linking to eip, on its own thread or on a worker
+    static void schedule(CPU* cpu, U32 eip);
+
+    // removes any pending work for the thread/memory and waits for work already in progress to finish
+    static void cancel(KThread* thread);
+    static void cancel(Memory* memory);
+
+    static U32 scheduled;
+    static U32 translated;
+    static U32 dropped;
+private:
+    static int workerThread(void* data);
+    static bool translate(const BtTranslationJob& job);
+    static bool isInFlight(KThread* thread, Memory* memory);
+
+    static std::vector<KNativeThread*> workers;
+    static std::deque<BtTranslationJob> jobs;
+    static std::vector<BtTranslationJob> inFlight;
+    static bool done;
+    static BOXEDWINE_CONDITION cond;
+};
+
+#endif
+
+#endif
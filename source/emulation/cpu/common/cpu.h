@@ -20,6 +20,7 @@
 typedef void (*Int99Callback)(CPU* cpu);
 extern Int99Callback* int99Callback;
 void callOpenGL(CPU* cpu, U32 index);
+void callOpenGLBatch(CPU* cpu, U32 address, U32 count);
 void callVulkan(CPU* cpu, U32 index);
 extern U32 lastGlCallTime;
 extern U32 int99CallbackSize;
@@ -331,6 +332,9 @@ public:
 
     virtual void run()=0;
     virtual DecodedBlock* getNextBlock() = 0;
+    // call instructions report the return address they pushed so that a core can predict the block a ret goes to
+    virtual void pushReturn(U32 returnEip) {}
+    virtual DecodedBlock* getReturnBlock() {return this->getNextBlock();}
     virtual void restart() {}
     virtual void setSeg(U32 index, U32 address, U32 value);
 
@@ -5947,19 +5947,23 @@ U32 DecodeData::fetch32() {
     return ((U32)this->fetch16()) | (((U32)this->fetch16()) << 16);
 }
 
-static DecodedOp* freeOps;
-BOXEDWINE_MUTEX freeOpsMutex;
+// The decoder allocates a block's ops one after another from the same thread, so they end up next to each other
+// in a slab in the order they will run
+typedef SlabPool<DecodedOp, 512> DecodedOpPool;
+typedef SlabPool<DecodedBlockFromNode, 1024> DecodedBlockFromNodePool;
 
 DecodedOp::DecodedOp() {
     this->init();
 }
 
 void DecodedOp::clearCache() {
-    while (freeOps) {
-        DecodedOp* next = freeOps->next;
-        delete freeOps;
-        freeOps = next;
-    }
+    DecodedOpPool::clear();
+    DecodedBlockFromNodePool::clear();
+}
+
+void DecodedOp::releaseThreadCache() {
+    DecodedOpPool::releaseThreadCache();
+    DecodedBlockFromNodePool::releaseThreadCache();
 }
 
 void DecodedOp::init() {
@@ -5978,33 +5982,29 @@ void DecodedOp::init() {
     this->pfn = NULL;
 }
 DecodedOp* DecodedOp::alloc() {
-    DecodedOp* result;
-    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(freeOpsMutex);
-
-    if (freeOps) {
-        result = freeOps;
-        freeOps = freeOps->next;
-        result->init();
-        return result;
-    } else {
-        return new DecodedOp();
-    }    
+    DecodedOp* result = DecodedOpPool::alloc();
+    result->init();
+    return result;
 }
 
 void DecodedOp::dealloc(bool deallocNext) {
-    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(freeOpsMutex);
+    DecodedOp* tail = this;
+    U32 count = 1;
 
+    while (true) {
 #ifdef _DEBUG
-    if (this->inst == InstructionCount) {
-        kpanic("tried to dealloc a DecodedOp that was already deallocated");
-    }
+        if (tail->inst == InstructionCount) {
+            kpanic("tried to dealloc a DecodedOp that was already deallocated");
+        }
 #endif
-    if (deallocNext && this->next) {
-        this->next->dealloc(deallocNext);
+        tail->inst = InstructionCount;
+        if (!deallocNext || !tail->next) {
+            break;
+        }
+        tail = tail->next;
+        count++;
     }
-    this->next = freeOps;
-    this->inst = InstructionCount;
-    freeOps = this;
+    DecodedOpPool::free(this, tail, count);
 }
 
 bool DecodedOp::isFpuOp() {
@@ -6057,32 +6057,113 @@ U32 DecodedOp::getNeededFlags(DecodedBlock* block, DecodedOp* op, U32 flags, U32
     return flags;
 }
 
-static DecodedBlockFromNode* freeFromNodes;
-DecodedBlockFromNode* DecodedBlockFromNode::alloc() {
-    DecodedBlockFromNode* result;
+// How much code is decoded when following a jump to find out which flags it uses
+#define FLAG_LIVENESS_MAX_BYTES 64
+// How many jumps are followed
+#define FLAG_LIVENESS_DEPTH 2
 
-    if (freeFromNodes) {
-        result = freeFromNodes;
-        freeFromNodes = freeFromNodes->next;
-    } else {
-        DecodedBlockFromNode* nodes = new DecodedBlockFromNode[1024];
+static U8 flagLivenessFetchByte(U32* eip) {
+    return readb((*eip)++);
+}
+
+static U32 getFlagsUsedAt(U32 address, U32 page, bool isBig, U32 flags, U32 depth);
+
+// Walks the ops of the block backwards, returns the flags that are used before they are set by the block.  At the
+// end of the block the flags used by the code that direct jumps and calls go to are found by decoding that code, as
+// long as it is on the same page as the block.
+static U32 getBlockFlagLiveness(DecodedBlock* block, U32 address, bool isBig, U32 flags, U32 depth, std::vector<U32>* flagsLiveOut) {
+    std::vector<DecodedOp*> ops;
+    for (DecodedOp* op = block->op; op; op = op->next) {
+        ops.push_back(op);
+    }
+    if (!ops.size()) {
+        return flags;
+    }
+    DecodedOp* lastOp = ops.back();
+    U32 branch = instructionInfo[lastOp->inst].branch;
+    U32 live = flags;
+
+    if (isBig && (branch & DECODE_BRANCH_1) && !(branch & DECODE_BRANCH_NO_CACHE)) {
+        U32 next = address + block->bytes;
+        U32 offset = lastOp->imm;
+
+        if (lastOp->inst == JmpJb) {
+            offset = (S8)lastOp->imm;
+        } else if (lastOp->inst == JmpJw || lastOp->inst == CallJw) {
+            offset = (S16)lastOp->imm;
+        }
+        live = getFlagsUsedAt(next + offset, address >> K_PAGE_SHIFT, isBig, flags, depth);
+        if (branch & DECODE_BRANCH_2) {
+            live |= getFlagsUsedAt(next, address >> K_PAGE_SHIFT, isBig, flags, depth);
+        }
+    }
+    if (flagsLiveOut) {
+        flagsLiveOut->resize(ops.size());
+    }
+    for (S32 i = (S32)ops.size() - 1; i >= 0; i--) {
+        const InstructionInfo& info = instructionInfo[ops[i]->inst];
 
-        freeFromNodes = &nodes[1];
-        freeFromNodes->next = 0;
-        for (int i=2;i<1024;i++) {
-            nodes[i].next = freeFromNodes;
-            freeFromNodes = &nodes[i];            
+        if (flagsLiveOut) {
+            (*flagsLiveOut)[i] = live;
+        }
+        if (!(info.flagsSets & MAYBE)) {
+            live &= ~(info.flagsSets | info.flagsUndefined);
         }
-        result = &nodes[0];
+        live |= info.flagsUsed & flags;
+    }
+    return live;
+}
+
+// The translated code that relies on the answer is only thrown away when its own page changes, so code on other pages
+// isn't looked at.  Code on a page that checks itself for changes isn't looked at either, that page is never read only.
+static U32 getFlagsUsedAt(U32 address, U32 page, bool isBig, U32 flags, U32 depth) {
+    if (!depth || (address >> K_PAGE_SHIFT) != page) {
+        return flags;
+    }
+    Memory* memory = KThread::currentThread()->memory;
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+    if (memory->dynamicCodePageUpdateCount[memory->getNativePage(page)] == MAX_DYNAMIC_CODE_PAGE_COUNT) {
+        return flags;
+    }
+#endif
+    U32 len = K_PAGE_SIZE - (address & K_PAGE_MASK);
+
+    // the decoder can read up to 1 instruction past len
+    if (len <= K_MAX_X86_OP_LEN || !memory->isValidReadAddress(address, len)) {
+        return flags;
+    }
+    len -= K_MAX_X86_OP_LEN;
+    if (len > FLAG_LIVENESS_MAX_BYTES) {
+        len = FLAG_LIVENESS_MAX_BYTES;
     }
+    DecodedBlock block;
+    decodeBlock(flagLivenessFetchByte, address, isBig, 0, len, 0, &block);
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+    // the bytes that were looked at might not be in a chunk, this makes a write to them clear the code on the page
+    memory->markCodeLines(address, block.bytes);
+#endif
+    U32 result = getBlockFlagLiveness(&block, address, isBig, flags, depth - 1, NULL);
+    block.op->dealloc(true);
+    return result;
+}
+
+U32 DecodedOp::getFlagsUsedAt(U32 address, bool isBig, U32 flags) {
+    return ::getFlagsUsedAt(address, address >> K_PAGE_SHIFT, isBig, flags, FLAG_LIVENESS_DEPTH + 1);
+}
+
+void DecodedOp::getFlagLiveness(DecodedBlock* block, U32 address, bool isBig, std::vector<U32>& flagsLiveOut) {
+    getBlockFlagLiveness(block, address, isBig, CF|AF|ZF|SF|OF|PF, FLAG_LIVENESS_DEPTH, &flagsLiveOut);
+}
+
+DecodedBlockFromNode* DecodedBlockFromNode::alloc() {
+    DecodedBlockFromNode* result = DecodedBlockFromNodePool::alloc();
     result->next = NULL;
     result->block = NULL;
     return result;
 }
 void DecodedBlockFromNode::dealloc() {
-    this->next = freeFromNodes;
     this->block = NULL;
-    freeFromNodes = this;
+    DecodedBlockFromNodePool::free(this);
 }
 
 void DecodedBlock::addReferenceFrom(DecodedBlock* block) {
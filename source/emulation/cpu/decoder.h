@@ -1443,9 +1443,12 @@ class DecodedOp {
 public:    
     static DecodedOp* alloc();
     static void clearCache();
+    // hands the ops and block references cached by the calling thread to the other threads before it exits
+    static void releaseThreadCache();
 
     DecodedOp();
 
+    // if deallocNext is true, the ops linked from this one are freed too in one shot
     void dealloc(bool deallocNext);    
     void log(CPU* cpu);
     bool needsToSetFlags();
@@ -1453,6 +1456,14 @@ public:
     const char* name();
 
     static U32 getNeededFlags(DecodedBlock* block, DecodedOp* op, U32 flags, U32 depth=2);
+    // Unlike getNeededFlags, these look at every op in the block and follow direct jumps at the end of the block
+    // by decoding the code they go to, if it is on the same page.  They are meant for the binary translators, the
+    // code must be readable.  The lines of the code that was looked at are marked as code, see Memory::markCodeLines.
+    //
+    // returns the flags that the code at address might read before setting them
+    static U32 getFlagsUsedAt(U32 address, bool isBig, U32 flags);
+    // flagsLiveOut[i] will be the flags that the i'th op in the block must leave correct, block must start at address
+    static void getFlagLiveness(DecodedBlock* block, U32 address, bool isBig, std::vector<U32>& flagsLiveOut);
 
     DecodedOp* next;
     OpCallback pfn;
@@ -14,6 +14,8 @@
 #endif
 #define NEXT() cpu->eip.u32+=op->len; op->next->pfn(cpu, op->next)
 #define NEXT_DONE() cpu->nextBlock = cpu->getNextBlock();
+#define NEXT_CALL(returnEip) cpu->pushReturn(returnEip)
+#define NEXT_RETURN() cpu->nextBlock = cpu->getReturnBlock();
 #define NEXT_BRANCH1() cpu->eip.u32+=op->len; if (!DecodedBlock::currentBlock->next1) {DecodedBlock::currentBlock->next1 = cpu->getNextBlock(); DecodedBlock::currentBlock->next1->addReferenceFrom(DecodedBlock::currentBlock);} cpu->nextBlock = DecodedBlock::currentBlock->next1
 #define NEXT_BRANCH2() cpu->eip.u32+=op->len; if (!DecodedBlock::currentBlock->next2) {DecodedBlock::currentBlock->next2 = cpu->getNextBlock(); DecodedBlock::currentBlock->next2->addReferenceFrom(DecodedBlock::currentBlock);} cpu->nextBlock = DecodedBlock::currentBlock->next2
 
@@ -93,7 +95,13 @@ OpCallback NormalCPU::getFunctionForOp(DecodedOp* op) {
     return normalOps[op->inst];
 }
 
-NormalCPU::NormalCPU() {   
+U64 NormalCPU::totalBlockCacheHits;
+U64 NormalCPU::totalBlockCacheMisses;
+U64 NormalCPU::totalReturnStackHits;
+U64 NormalCPU::totalReturnStackMisses;
+BOXEDWINE_MUTEX NormalCPU::totalsMutex;
+
+NormalCPU::NormalCPU() : blockCacheMemory(NULL), blockCacheHits(0), blockCacheMisses(0), returnStackHits(0), returnStackMisses(0), returnStackPos(0) {
     initNormalOps();
 #ifdef BOXEDWINE_DYNAMIC
     this->firstOp = firstDynamicOp;
@@ -102,6 +110,14 @@ NormalCPU::NormalCPU() {
 #endif
 }
 
+NormalCPU::~NormalCPU() {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(totalsMutex);
+    totalBlockCacheHits += this->blockCacheHits;
+    totalBlockCacheMisses += this->blockCacheMisses;
+    totalReturnStackHits += this->returnStackHits;
+    totalReturnStackMisses += this->returnStackMisses;
+}
+
 U8 fetchByte(U32 *eip) {
     if (*eip - KThread::currentThread()->cpu->seg[CS].address == 0xFFFF && !KThread::currentThread()->cpu->isBig()) {
         kpanic("eip wrapped around.");
@@ -109,7 +125,11 @@ U8 fetchByte(U32 *eip) {
     return readb((*eip)++);
 }
 
+class NormalBlock;
+typedef SlabPool<NormalBlock, 256> NormalBlockPool;
+
 class NormalBlock : public DecodedBlock {
+    friend NormalBlockPool;
 public:
     static NormalBlock* alloc();
     static void clearCache();
@@ -140,8 +160,6 @@ void NormalBlock::run(CPU* cpu) {
     cpu->blockInstructionCount+=this->opCount;
 }
 
-static NormalBlock* freeBlocks;
-
 void NormalBlock::init() {
     this->next = 0;
     this->op = NULL;
@@ -154,24 +172,13 @@ void NormalBlock::init() {
 }
 
 void NormalBlock::clearCache() {
-    while (freeBlocks) {
-        NormalBlock* next = freeBlocks->next;
-        delete freeBlocks;
-        freeBlocks = next;
-    }
+    NormalBlockPool::clear();
 }
 
 NormalBlock* NormalBlock::alloc() {
-    NormalBlock* result;
-
-    if (freeBlocks) {
-        result = freeBlocks;
-        freeBlocks = freeBlocks->next;
-        result->init();
-        return result;
-    } else {
-        return new NormalBlock();
-    }    
+    NormalBlock* result = NormalBlockPool::alloc();
+    result->init();
+    return result;
 }
 
 void NormalBlock::dealloc(bool delayed) {
@@ -187,15 +194,13 @@ void NormalBlock::dealloc(bool delayed) {
             cpu->delayedFreeBlock = this;
         } else {
             this->op->dealloc(true);
-            this->next = freeBlocks;
             this->op = NULL;
-            freeBlocks = this;
+            NormalBlockPool::free(this);
         }
     } else {
         this->op->dealloc(true);
-        this->next = freeBlocks;
         this->op = NULL;
-        freeBlocks = this;
+        NormalBlockPool::free(this);
     }
     if (this->next1) {
         this->next1->removeReferenceFrom(this);
@@ -231,7 +236,18 @@ DecodedBlock* NormalCPU::getNextBlock() {
     if (!this->thread->process) // exit was called, don't need to pre-cache the next block
         return NULL;
 
-    U32 startIp = (this->big?this->eip.u32:this->eip.u16) + this->seg[CS].address;
+    U32 startIp = this->getStartIp(this->eip.u32);
+    if (this->blockCacheMemory != this->thread->memory) {
+        this->setBlockCacheMemory(this->thread->memory);
+    }
+    U32 generation = this->blockCacheMemory->blockGeneration;
+    NormalBlockCacheEntry& entry = this->blockCache[startIp & (K_BLOCK_CACHE_SIZE - 1)];
+    if (entry.eip == startIp && entry.generation == generation) {
+        this->blockCacheHits++;
+        return entry.block;
+    }
+    this->blockCacheMisses++;
+
     DecodedBlock* block = this->thread->memory->getCodeBlock(startIp);
 
     if (!block) {
@@ -254,9 +270,63 @@ DecodedBlock* NormalCPU::getNextBlock() {
             block->op = op;
         }
     }
+    entry.eip = startIp;
+    entry.generation = generation;
+    entry.block = block;
     return block;
 }
 
+// after exec the thread has a new memory, none of the entries can be used with it
+void NormalCPU::setBlockCacheMemory(Memory* memory) {
+    U32 stale = memory->blockGeneration - 1;
+
+    this->blockCacheMemory = memory;
+    for (U32 i = 0; i < K_BLOCK_CACHE_SIZE; i++) {
+        this->blockCache[i].generation = stale;
+    }
+    for (U32 i = 0; i < K_RETURN_STACK_SIZE; i++) {
+        this->returnStack[i].generation = stale;
+    }
+}
+
+U32 NormalCPU::getStartIp(U32 ip) {
+    return (this->big ? ip : (ip & 0xFFFF)) + this->seg[CS].address;
+}
+
+void NormalCPU::pushReturn(U32 returnEip) {
+    NormalReturnEntry& entry = this->returnStack[this->returnStackPos];
+    entry.eip = this->getStartIp(returnEip);
+    entry.generation = this->thread->memory->blockGeneration;
+    entry.callBlock = DecodedBlock::currentBlock;
+    this->returnStackPos = (this->returnStackPos + 1) & (K_RETURN_STACK_SIZE - 1);
+}
+
+// The return stack is a ring, if the guest unwinds more than K_RETURN_STACK_SIZE calls, or returns somewhere
+// other than where it was called from, the entry won't match and the normal lookup is used.
+DecodedBlock* NormalCPU::getReturnBlock() {
+    this->returnStackPos = (this->returnStackPos - 1) & (K_RETURN_STACK_SIZE - 1);
+    NormalReturnEntry& entry = this->returnStack[this->returnStackPos];
+    Memory* memory = this->thread->memory;
+
+    if (entry.generation == memory->blockGeneration && entry.eip == this->getStartIp(this->eip.u32)) {
+        DecodedBlock* callBlock = entry.callBlock;
+        if (callBlock->next2) {
+            this->returnStackHits++;
+            return callBlock->next2;
+        }
+        DecodedBlock* block = this->getNextBlock();
+        // decoding the block could have freed the call block
+        if (block && entry.generation == memory->blockGeneration) {
+            callBlock->next2 = block;
+            block->addReferenceFrom(callBlock);
+        }
+        this->returnStackMisses++;
+        return block;
+    }
+    this->returnStackMisses++;
+    return this->getNextBlock();
+}
+
 void NormalCPU::run() {    
     DecodedBlock::currentBlock = this->nextBlock;
     DecodedBlock::currentBlock->run(this);    
@@ -268,6 +338,21 @@ void NormalCPU::run() {
 #endif
 }
 
+static double hitRate(U64 hits, U64 misses) {
+    return (hits + misses) ? hits * 100.0 / (hits + misses) : 0.0;
+}
+
+void NormalCPU::logCacheStats() {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(totalsMutex);
+    if (totalBlockCacheHits || totalBlockCacheMisses) {
+        klog("block cache: %.1f%% of %.0f lookups hit, return stack: %.1f%% of %.0f rets hit", hitRate(totalBlockCacheHits, totalBlockCacheMisses), (double)(totalBlockCacheHits + totalBlockCacheMisses), hitRate(totalReturnStackHits, totalReturnStackMisses), (double)(totalReturnStackHits + totalReturnStackMisses));
+    }
+}
+
 void NormalCPU::clearCache() {
     NormalBlock::clearCache();
 }
+
+void NormalCPU::releaseThreadCache() {
+    NormalBlockPool::releaseThreadCache();
+}
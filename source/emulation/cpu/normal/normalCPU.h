@@ -3,20 +3,72 @@
 
 #include "../common/cpu.h"
 
+// must be powers of 2
+#define K_BLOCK_CACHE_SIZE 1024
+#define K_RETURN_STACK_SIZE 16
+
+class NormalBlockCacheEntry {
+public:
+    NormalBlockCacheEntry() : eip(0), generation(0), block(NULL) {}
+
+    U32 eip;
+    U32 generation;
+    DecodedBlock* block;
+};
+
+class NormalReturnEntry {
+public:
+    NormalReturnEntry() : eip(0), generation(0), callBlock(NULL) {}
+
+    U32 eip;
+    U32 generation;
+    DecodedBlock* callBlock; // the block that ends with the call, its next2 is linked to the block at eip
+};
+
 class NormalCPU : public CPU {
 public:
     NormalCPU();
+    virtual ~NormalCPU();
 
     static void clearCache();
+    // hands the blocks cached by the calling thread to the other threads before it exits
+    static void releaseThreadCache();
 
     virtual void run();
     virtual DecodedBlock* getNextBlock();
 
+    virtual void pushReturn(U32 returnEip);
+    virtual DecodedBlock* getReturnBlock();
+
     static OpCallback getFunctionForOp(DecodedOp* op);
 
     static DecodedBlock* getBlockForInspectionButNotUsed(U32 address, bool big);
 
     OpCallback firstOp;
+
+    // logs the hit rates of every cpu that has exited
+    static void logCacheStats();
+private:
+    U32 getStartIp(U32 ip);
+    void setBlockCacheMemory(Memory* memory);
+
+    // direct mapped cache of eip -> block so that indirect jumps, calls and rets don't need to look in the code page.
+    // An entry is only used while blockCacheMemory->blockGeneration is the same as when it was added.
+    NormalBlockCacheEntry blockCache[K_BLOCK_CACHE_SIZE];
+    Memory* blockCacheMemory;
+
+    // only this cpu updates them, they are added to the totals when it exits
+    U64 blockCacheHits;
+    U64 blockCacheMisses;
+    U64 returnStackHits;
+    U64 returnStackMisses;
+    static U64 totalBlockCacheHits;
+    static U64 totalBlockCacheMisses;
+    static U64 totalReturnStackHits;
+    static U64 totalReturnStackMisses;
+    static BOXEDWINE_MUTEX totalsMutex;
+    NormalReturnEntry returnStack[K_RETURN_STACK_SIZE];
+    U32 returnStackPos;
 };
 
 #endif
\ No newline at end of file
@@ -259,6 +259,12 @@ void X64Asm::writeToRegFromValue(U8 reg, bool isRexReg, U64 value, U8 bytes) {
     }
 }
 
+// the position of the pointer is remembered so that the host code can be relocated if it is saved to the translation cache
+void X64Asm::writeToRegFromHostPointer(U8 reg, bool isRexReg, void* pointer) {
+    writeToRegFromValue(reg, isRexReg, (U64)pointer, 8);
+    this->hostPointers.push_back(this->bufferPos - 8);
+}
+
 void X64Asm::writeHostPlusTmp(U8 rm, bool checkG, bool isG8bit, bool isE8bit, U8 tmpReg) {
     this->rex |= REX_BASE | REX_SIB_INDEX|REX_MOD_RM;    
     setRM(rm, checkG, false, isG8bit, isE8bit);
@@ -1618,7 +1624,7 @@ void X64Asm::callHost(void* pfn) {
     write8(0x74);
     U32 pos = this->bufferPos;
     write8(0);
-    writeToRegFromValue(tmp, true, (U64)badStack, 8);
+    writeToRegFromHostPointer(tmp, true, (void*)badStack);
     write8(REX_BASE | REX_64);
     write8(0x83);
     write8(0xEC);
@@ -1633,7 +1639,7 @@ void X64Asm::callHost(void* pfn) {
 
     write8(0xfc); // cld
 
-    writeToRegFromValue(tmp, true, (U64)pfn, 8);
+    writeToRegFromHostPointer(tmp, true, pfn);
 
 #ifdef BOXEDWINE_MSVC
     // part of the x64 windows ABI, shadow store
@@ -1858,6 +1864,7 @@ void X64Asm::setPF_onAL(U8 flagReg) {
     // mov HOST_TMP2, parity_lookup
     write8(REX_BASE | REX_64 | REX_MOD_RM);
     write8(0xb8+tmpReg);
+    this->hostPointers.push_back(this->bufferPos);
     write64((U64)parity_lookup);
     
     // or HOST_TMPb, byte ptr [HOST_TMP2]
@@ -2524,6 +2531,7 @@ void X64Asm::internal_addDynamicCheck(U32 address, U32 len, U32 needsFlags, bool
 void X64Asm::addDynamicCheck(bool panic) {
     DecodedBlock* block = NormalCPU::getBlockForInspectionButNotUsed(this->ip+this->cpu->seg[CS].address, this->cpu->isBig());
     U32 len = block->op->len;
+    // this code is on a page that can change at any time, so it doesn't look past the block
     U32 needsFlags = instructionInfo[block->op->inst].flagsUsed | DecodedOp::getNeededFlags(block, block->op, OF|SF|ZF|PF|AF|CF);
     U32 address = this->startOfOpIp + this->cpu->seg[CS].address;
     U8 tmpReg3 = getTmpReg();
@@ -2551,6 +2559,59 @@ void X64Asm::addDynamicCheck(bool panic) {
     block->dealloc(false); 
 }
 
+// Counts down each time the chunk is entered.  When it runs out the chunk is handed to x64CPU::reTranslateChunk,
+// which will translate it again as a superblock.
+void X64Asm::addHotChunkCounter() {
+    U32 needsFlags = DecodedOp::getFlagsUsedAt(this->ip+this->cpu->seg[CS].address, this->cpu->isBig(), OF|SF|ZF|PF|AF|CF);
+    bool saveAllFlags = (needsFlags & OF) != 0;
+    bool saveLowBitFlags = needsFlags!=0 && !saveAllFlags;
+    U8 flagsReg = getTmpReg();
+    U8 counterReg = getTmpReg();
+
+    if (saveAllFlags) {
+        pushFlagsToReg(flagsReg, true, true);
+    } else if (saveLowBitFlags) {
+        pushFlagsToReg(flagsReg, true, false);
+    }
+    writeToRegFromValue(counterReg, true, (U64)this->hotChunkCounter, 8);
+    this->hotChunkCounterPos = this->bufferPos - 8;
+
+    // sub dword ptr [counterReg], 1
+    write8(REX_BASE | REX_MOD_RM);
+    write8(0x83);
+    write8(0x28 | counterReg);
+    write8(1);
+
+    // jg
+    write8(0x0f);
+    write8(0x8f);
+    U32 pos = this->bufferPos;
+    write32(0);
+    if (saveAllFlags) {
+        popFlagsFromReg(flagsReg, true, true);
+    } else if (saveLowBitFlags) {
+        popFlagsFromReg(flagsReg, true, false);
+    }
+    callRetranslateChunk();
+    write32Buffer(this->buffer + pos, this->bufferPos - pos - 4);
+    if (saveAllFlags) {
+        popFlagsFromReg(flagsReg, true, true);
+    } else if (saveLowBitFlags) {
+        popFlagsFromReg(flagsReg, true, false);
+    }
+    releaseTmpReg(counterReg);
+    releaseTmpReg(flagsReg);
+}
+
+// In a superblock a short jmp forward doesn't end the chunk, the code up to the target is translated too so that
+// the jmp stays inside the chunk instead of going through a link.
+bool X64Asm::continuesSuperblock(U32 eip) {
+    U32 address = eip + this->cpu->seg[CS].address;
+    U32 startAddress = this->startOfDataIp + this->cpu->seg[CS].address;
+
+    return this->cpu->translatingSuperblock && eip > this->ip && eip - this->ip <= X64_SUPERBLOCK_MAX_JMP && (address >> K_PAGE_SHIFT) == (startAddress >> K_PAGE_SHIFT);
+}
+
 void X64Asm::doLoop(U32 eip) {
     // :TODO: maybe find one byte offset
     U32 pos = this->bufferPos;
@@ -3525,7 +3586,7 @@ static void x64_errorMsg(const char* msg) {
 void X64Asm::errorMsg(const char* msg) {
     //syncRegsFromHost(); 
     lockParamReg(PARAM_1_REG, PARAM_1_REX);
-    writeToRegFromValue(PARAM_1_REG, PARAM_1_REX, (U64)msg, 8);
+    writeToRegFromHostPointer(PARAM_1_REG, PARAM_1_REX, (void*)msg);
     callHost((void*)x64_errorMsg);
     //syncRegsToHost();
     //doJmp();
@@ -3712,7 +3773,7 @@ void X64Asm::stos(void* pfn, U32 size, bool repeat) {
     writeToRegFromReg(PARAM_1_REG, PARAM_1_REX, HOST_CPU, true, 8); // CPU* param
 
     lockParamReg(PARAM_2_REG, PARAM_2_REX);
-    writeToRegFromValue(PARAM_2_REG, PARAM_2_REX, (U64)pfn, 8);
+    writeToRegFromHostPointer(PARAM_2_REG, PARAM_2_REX, (void*)pfn);
 
     lockParamReg(PARAM_3_REG, PARAM_3_REX);
     writeToRegFromValue(PARAM_3_REG, PARAM_3_REX, size, 4);
@@ -3730,7 +3791,7 @@ void X64Asm::scas(void* pfn, U32 size, bool repeat, bool repeatZero) {
     writeToRegFromReg(PARAM_1_REG, PARAM_1_REX, HOST_CPU, true, 8); // CPU* param
 
     lockParamReg(PARAM_2_REG, PARAM_2_REX);
-    writeToRegFromValue(PARAM_2_REG, PARAM_2_REX, (U64)pfn, 8);
+    writeToRegFromHostPointer(PARAM_2_REG, PARAM_2_REX, (void*)pfn);
 
     lockParamReg(PARAM_3_REG, PARAM_3_REX);
     writeToRegFromValue(PARAM_3_REG, PARAM_3_REX, (U32)repeatZero?1:0, 4);
@@ -3751,7 +3812,7 @@ void X64Asm::movs(void* pfn, U32 size, bool repeat, U32 base) {
     writeToRegFromReg(PARAM_1_REG, PARAM_1_REX, HOST_CPU, true, 8); // CPU* param
 
     lockParamReg(PARAM_2_REG, PARAM_2_REX);
-    writeToRegFromValue(PARAM_2_REG, PARAM_2_REX, (U64)pfn, 8);
+    writeToRegFromHostPointer(PARAM_2_REG, PARAM_2_REX, (void*)pfn);
 
     lockParamReg(PARAM_3_REG, PARAM_3_REX);
     writeToRegFromValue(PARAM_3_REG, PARAM_3_REX, base, 4);
@@ -3772,7 +3833,7 @@ void X64Asm::lods(void* pfn, U32 size, bool repeat, U32 base) {
     writeToRegFromReg(PARAM_1_REG, PARAM_1_REX, HOST_CPU, true, 8); // CPU* param
 
     lockParamReg(PARAM_2_REG, PARAM_2_REX);
-    writeToRegFromValue(PARAM_2_REG, PARAM_2_REX, (U64)pfn, 8);
+    writeToRegFromHostPointer(PARAM_2_REG, PARAM_2_REX, (void*)pfn);
 
     lockParamReg(PARAM_3_REG, PARAM_3_REX);
     writeToRegFromValue(PARAM_3_REG, PARAM_3_REX, base, 4);
@@ -3793,7 +3854,7 @@ void X64Asm::cmps(void* pfn, U32 size, bool repeat, bool repeatZero, U32 base) {
     writeToRegFromReg(PARAM_1_REG, PARAM_1_REX, HOST_CPU, true, 8); // CPU* param
 
     lockParamReg(PARAM_2_REG, PARAM_2_REX);
-    writeToRegFromValue(PARAM_2_REG, PARAM_2_REX, (U64)pfn, 8);
+    writeToRegFromHostPointer(PARAM_2_REG, PARAM_2_REX, (void*)pfn);
 
     lockParamReg(PARAM_3_REG, PARAM_3_REX);
     writeToRegFromValue(PARAM_3_REG, PARAM_3_REX, (U32)repeatZero?1:0, 4);
@@ -3931,7 +3992,7 @@ void X64Asm::callFpuWithAddressWrite(PFN_FPU_ADDRESS pfn, U8 rm, U32 len) {
     writeToRegFromReg(PARAM_1_REG, PARAM_1_REX, HOST_CPU, true, 8); // CPU* param
 
     lockParamReg(PARAM_2_REG, PARAM_2_REX);
-    writeToRegFromValue(PARAM_2_REG, PARAM_2_REX, (U64)pfn, 8);
+    writeToRegFromHostPointer(PARAM_2_REG, PARAM_2_REX, (void*)pfn);
 
     lockParamReg(PARAM_3_REG, PARAM_3_REX);
     writeToRegFromValue(PARAM_3_REG, PARAM_3_REX, len, 4);
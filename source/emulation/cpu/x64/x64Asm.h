@@ -49,6 +49,8 @@ public:
     void translateRM(U8 rm, bool checkG, bool checkE, bool isG8bit, bool isE8bit, U8 immWidth);
     void writeOp(bool isG8bit=false);
     void addDynamicCheck(bool panic);
+    void addHotChunkCounter();
+    bool continuesSuperblock(U32 eip);
 	void saveNativeState();
 	void restoreNativeState();
     void createCodeForRetranslateChunk(bool includeSetupFromR9=false);
@@ -122,6 +124,7 @@ public:
     void bswapSp();
     void string32(bool hasSi, bool hasDi);
     void writeToRegFromValue(U8 reg, bool isRexReg, U64 value, U8 bytes);
+    void writeToRegFromHostPointer(U8 reg, bool isRexReg, void* pointer);
     void enter(bool big, U32 bytes, U32 level);
     void leave(bool big);
     void callE(bool big, U8 rm);
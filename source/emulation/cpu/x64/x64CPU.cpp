@@ -11,6 +11,8 @@
 #include "knativethread.h"
 #include "knativesystem.h"
 #include "../binaryTranslation/btCodeMemoryWrite.h"
+#include "../binaryTranslation/btCodeCache.h"
+#include "../binaryTranslation/btTranslationPool.h"
 
 CPU* CPU::allocCPU() {
     return new x64CPU();
@@ -20,7 +22,13 @@ CPU* CPU::allocCPU() {
 bool x64CPU::hasBMI2 = true;
 bool x64Intialized = false;
 
-x64CPU::x64CPU() : exitToStartThreadLoop(0) {
+#ifdef __TEST
+bool x64CPU::useHotChunkCounters = false; // most tests only run their code once, testSuperblock turns this on
+#else
+bool x64CPU::useHotChunkCounters = true;
+#endif
+
+x64CPU::x64CPU() : exitToStartThreadLoop(0), translatingSuperblock(false), translatingSpeculatively(false), noHotChunkCounter(false) {
     if (!x64Intialized) {
         x64Intialized = true;
         x64CPU::hasBMI2 = platformHasBMI2();
@@ -188,14 +196,34 @@ std::shared_ptr<BtCodeChunk> x64CPU::translateChunk(X64Asm* parent, U32 ip) {
     data.startOfDataIp = ip;  
     data.calculatedEipLen = data1.ip - data1.startOfDataIp;
     data.parent = parent;
+    this->superblockChunks.clear();
     translateData(&data, &data1);        
     S32 failedJumpOpIndex = this->preLinkCheck(&data);
 
     if (failedJumpOpIndex==-1) {
+        addChunkToCodeCache(&data);
         std::shared_ptr<BtCodeChunk> chunk = data.commit(false);
+        chunk->setHotCounter(data.hotChunkCounter);
+        for (auto& replaced : this->superblockChunks) {
+            if (!chunk->containsEip(replaced->getEip()) || !chunk->containsEip(replaced->getEip() + replaced->getEipLen() - 1)) {
+                kpanic("x64CPU::translateChunk superblock only partially replaced a chunk");
+            }
+            replaced->replaceWith(chunk);
+        }
+        this->superblockChunks.clear();
         link(&data, chunk);
         return chunk;
+    } else if (this->translatingSuperblock) {
+        // translate it again the normal way
+        this->translatingSuperblock = false;
+        this->noHotChunkCounter = true;
+        this->superblockChunks.clear();
+        return this->translateChunk(parent, ip);
     } else {
+        // data2 will get its own counter
+        if (data1.hotChunkCounter) {
+            this->thread->memory->freeHotChunkCounters.push_back(data1.hotChunkCounter);
+        }
         X64Asm data2(this);
         data2.ip = ip;
         data2.startOfDataIp = ip;       
@@ -211,7 +239,9 @@ std::shared_ptr<BtCodeChunk> x64CPU::translateChunk(X64Asm* parent, U32 ip) {
         data3.stopAfterInstruction = failedJumpOpIndex;
         translateData(&data3, &data2);
 
+        addChunkToCodeCache(&data3);
         std::shared_ptr<BtCodeChunk> chunk = data3.commit(false);
+        chunk->setHotCounter(data3.hotChunkCounter);
         link(&data3, chunk);
         return chunk;
     }    
@@ -225,13 +255,135 @@ void* x64CPU::translateEipInternal(X64Asm* parent, U32 ip) {
     void* result = this->thread->memory->getExistingHostAddress(address);
 
     if (!result) {
-        std::shared_ptr<BtCodeChunk> chunk = this->translateChunk(parent, ip);
+        std::shared_ptr<BtCodeChunk> chunk = this->loadChunkFromCodeCache(parent, ip);
+        if (!chunk) {
+            chunk = this->translateChunk(parent, ip);
+        }
         result = chunk->getHostAddress();
         chunk->makeLive();
     }
     return result;
 }
 
+S32* x64CPU::allocHotChunkCounter() {
+    Memory* memory = this->thread->memory;
+    if (memory->freeHotChunkCounters.size()) {
+        S32* result = memory->freeHotChunkCounters.back();
+        memory->freeHotChunkCounters.pop_back();
+        *result = X64_HOT_CHUNK_COUNT;
+        return result;
+    }
+    memory->hotChunkCounters.push_back(X64_HOT_CHUNK_COUNT);
+    return &memory->hotChunkCounters.back();
+}
+
+// A superblock can only replace a chunk it will completely cover
+bool x64CPU::canAddToSuperblock(U32 address, U32 page) {
+    std::shared_ptr<BtCodeChunk> chunk = this->thread->memory->getCodeChunkContainingEip(address);
+    return chunk && chunk->getEip() == address && !chunk->isDynamicAware() && ((address + chunk->getEipLen() - 1) >> K_PAGE_SHIFT) == page;
+}
+
+// The chunk's entry counter ran out.  Translate it again as a superblock: translation continues through short jmps
+// forward and through the chunks that follow it on the same page, which are replaced, so the hot code ends up in
+// one chunk with direct jumps instead of going through links.  Conditional jumps out of it are the side exits.
+void x64CPU::translateSuperblock(std::shared_ptr<BtCodeChunk>& chunk) {
+    U32 nativePage = this->thread->memory->getNativePage(chunk->getEip() >> K_PAGE_SHIFT);
+
+    if (this->isBig() && this->thread->memory->dynamicCodePageUpdateCount[nativePage] != MAX_DYNAMIC_CODE_PAGE_COUNT) {
+        this->translatingSuperblock = true;
+    } else {
+        this->noHotChunkCounter = true;
+    }
+    // another thread might be running the chunk
+    chunk->releaseAndRetranslate(true);
+    this->translatingSuperblock = false;
+    this->noHotChunkCounter = false;
+}
+
+// Only code that doesn't depend on the state of this process, other than the emulated code bytes, is cached
+void x64CPU::addChunkToCodeCache(X64Asm* data) {
+    if (!BtCodeCache::isEnabled() || data->dynamic || !this->isBig() || this->seg[CS].address || !data->ipAddressCount) {
+        return;
+    }
+    Memory* memory = this->thread->memory;
+    for (U32 i = 0; i < data->ipAddressCount; i++) {
+        if (memory->doesInstructionNeedMemoryOffset(data->ipAddress[i])) {
+            return;
+        }
+    }
+    std::shared_ptr<BtCodeCacheEntry> entry = std::make_shared<BtCodeCacheEntry>();
+    entry->eip = data->startOfDataIp;
+    entry->eipLen = data->ip - data->startOfDataIp;
+    entry->crc = BtCodeCache::crcEmulatedCode(entry->eip, entry->eipLen);
+    entry->instructionEip.assign(data->ipAddress, data->ipAddress + data->ipAddressCount);
+    entry->instructionHostPos.assign(data->ipAddressBufferPos, data->ipAddressBufferPos + data->ipAddressCount);
+    entry->host.assign(data->buffer, data->buffer + data->bufferPos);
+    for (auto& todo : data->todoJump) {
+        entry->links.push_back(BtCodeCacheLink(todo.eip, todo.bufferPos, todo.offsetSize, todo.sameChunk));
+    }
+    for (U32 pos : data->hostPointers) {
+        if (!BtCodeCache::makeHostPointerRelative(entry->host.data() + pos)) {
+            return;
+        }
+        entry->hostPointers.push_back(pos);
+    }
+    if (data->hotChunkCounterPos) {
+        // the counter belongs to this process, a new one is allocated when the chunk is loaded
+        entry->hotChunkCounterPos = data->hotChunkCounterPos;
+        memset(entry->host.data() + data->hotChunkCounterPos, 0, 8);
+    }
+    BtCodeCache::add(entry);
+}
+
+std::shared_ptr<BtCodeChunk> x64CPU::loadChunkFromCodeCache(X64Asm* parent, U32 ip) {
+    if (!BtCodeCache::isEnabled() || !this->isBig() || this->seg[CS].address) {
+        return nullptr;
+    }
+    std::shared_ptr<BtCodeCacheEntry> entry = BtCodeCache::find(ip);
+    if (!entry) {
+        return nullptr;
+    }
+    Memory* memory = this->thread->memory;
+    U32 pageStart = memory->getNativePage(entry->eip >> K_PAGE_SHIFT);
+    U32 pageEnd = memory->getNativePage((entry->eip + entry->eipLen - 1) >> K_PAGE_SHIFT);
+    for (U32 page = pageStart; page <= pageEnd; page++) {
+        if (memory->dynamicCodePageUpdateCount[page] == MAX_DYNAMIC_CODE_PAGE_COUNT) {
+            return nullptr;
+        }
+    }
+    // the cached chunk may overlap code that was translated since it was saved
+    for (U32 eip : entry->instructionEip) {
+        if (memory->getExistingHostAddress(eip) || memory->doesInstructionNeedMemoryOffset(eip)) {
+            return nullptr;
+        }
+    }
+    X64Asm data(this);
+    data.parent = parent;
+    data.startOfDataIp = entry->eip;
+    data.ip = entry->eip + entry->eipLen;
+    for (U32 i = 0; i < (U32)entry->instructionEip.size(); i++) {
+        data.mapAddress(entry->instructionEip[i], entry->instructionHostPos[i]);
+    }
+    for (U8 b : entry->host) {
+        data.write8(b);
+    }
+    for (U32 pos : entry->hostPointers) {
+        BtCodeCache::makeHostPointerAbsolute(data.buffer + pos);
+    }
+    for (auto& link : entry->links) {
+        data.todoJump.push_back(TodoJump(link.eip, link.bufferPos, link.offsetSize, link.sameChunk, 0));
+    }
+    if (entry->hotChunkCounterPos) {
+        data.hotChunkCounter = allocHotChunkCounter();
+        data.hotChunkCounterPos = entry->hotChunkCounterPos;
+        memcpy(data.buffer + data.hotChunkCounterPos, &data.hotChunkCounter, 8);
+    }
+    std::shared_ptr<BtCodeChunk> chunk = data.commit(false);
+    chunk->setHotCounter(data.hotChunkCounter);
+    link(&data, chunk);
+    return chunk;
+}
+
 #ifdef __TEST
 void x64CPU::postTestRun() {
     for (int i = 0; i < 8; i++) {
@@ -313,8 +465,10 @@ void x64CPU::link(X64Asm* data, std::shared_ptr<BtCodeChunk>& fromChunk, U32 off
                 returnData.callRetranslateChunk();
                 U32 hostIndex = 0;
                 std::shared_ptr<X64CodeChunk> chunk = std::make_shared<X64CodeChunk>(1, &eip, &hostIndex, returnData.buffer, returnData.bufferPos, eip - this->seg[CS].address, 1, false);
+                chunk->setLinkPlaceholder();
                 chunk->makeLive();
                 toHostAddress = (U8*)chunk->getHostAddress();
+                BtTranslationPool::schedule(this, eip);
             }
             std::shared_ptr<BtCodeChunk> toChunk = this->thread->memory->getCodeChunkContainingHostAddress(toHostAddress);
             if (!toChunk) {
@@ -346,8 +500,9 @@ void x64CPU::markCodePageReadOnly(X64Asm* data) {
 
 void x64CPU::makePendingCodePagesReadOnly() {
     for (int i=0;i<(int)this->pendingCodePages.size();i++) {
-        // the chunk could cross a page and be a mix of dynamic and non dynamic code
-        if (this->thread->memory->dynamicCodePageUpdateCount[this->pendingCodePages[i]]!=MAX_DYNAMIC_CODE_PAGE_COUNT) {
+        // the chunk could cross a page and be a mix of dynamic and non dynamic code, a page that a BtCodeMemoryWrite
+        // has writable will have this code cleared when it is done
+        if (this->thread->memory->dynamicCodePageUpdateCount[this->pendingCodePages[i]]!=MAX_DYNAMIC_CODE_PAGE_COUNT && !this->thread->memory->isCodePageBeingWritten(this->pendingCodePages[i])) {
             ::makeCodePageReadOnly(this->thread->memory, this->pendingCodePages[i]);
         }
     }
@@ -362,8 +517,42 @@ void* x64CPU::translateEip(U32 ip) {
     return result;
 }
 
+bool x64CPU::translateSpeculatively(U32 address) {
+    Memory* memory = this->thread->memory;
+    bool result = false;
+
+    // This runs on a BtTranslationPool worker with a cpu that only belongs to this job, it doesn't wait for a guest
+    // thread that holds these locks, but a guest thread that wants them while the chunk is being translated will wait
+    // for it.  pageMutex keeps the code from being unmapped while it is read.
+    if (!BOXEDWINE_MUTEX_TRY_LOCK(memory->pageMutex)) {
+        return false;
+    }
+    if (!BOXEDWINE_MUTEX_TRY_LOCK(memory->executableMemoryMutex)) {
+        BOXEDWINE_MUTEX_UNLOCK(memory->pageMutex);
+        return false;
+    }
+    if (this->isBig() && memory->isValidReadAddress(address, K_MAX_X86_OP_LEN)) {
+        std::shared_ptr<BtCodeChunk> chunk = memory->getCodeChunkContainingEip(address);
+
+        // the guest might have already run it
+        if (chunk && chunk->isLinkPlaceholder() && chunk->getEip() == address) {
+            this->translatingSpeculatively = true;
+            // a placeholder is only a stub that calls reTranslateChunk, which will find the new chunk
+            chunk->releaseAndRetranslate(true);
+            this->translatingSpeculatively = false;
+            result = true;
+        }
+    }
+    BOXEDWINE_MUTEX_UNLOCK(memory->executableMemoryMutex);
+    BOXEDWINE_MUTEX_UNLOCK(memory->pageMutex);
+    return result;
+}
+
 void x64CPU::translateInstruction(X64Asm* data, X64Asm* firstPass) {
     data->startOfOpIp = data->ip;  
+    if (data->hotChunkCounter && data->ip == data->startOfDataIp) {
+        data->addHotChunkCounter();
+    }
     if (data->ip == 0x40CB1B) {
         data->logOp(data->ip);
     }
@@ -400,13 +589,33 @@ void x64CPU::translateData(X64Asm* data, X64Asm* firstPass) {
     if (this->thread->memory->dynamicCodePageUpdateCount[nativePage]==MAX_DYNAMIC_CODE_PAGE_COUNT) {
         data->dynamic = true;
     }
+    if (!data->dynamic && !this->translatingSuperblock && !this->noHotChunkCounter && useHotChunkCounters) {
+        // the first pass is only used to find the length, the pass that is committed can use the same counter
+        data->hotChunkCounter = firstPass ? firstPass->hotChunkCounter : this->allocHotChunkCounter();
+    }
+    U32 superblockPage = codePage;
     while (1) {  
         U32 address = data->cpu->seg[CS].address+data->ip;
         void* hostAddress = this->thread->memory->getExistingHostAddress(address);
+        if (hostAddress && this->translatingSuperblock && this->canAddToSuperblock(address, superblockPage)) {
+            if (firstPass) {
+                this->superblockChunks.push_back(this->thread->memory->getCodeChunkContainingEip(address));
+            }
+            hostAddress = NULL;
+        }
         if (hostAddress) {
             data->jumpTo(data->ip);
             break;
         }
+        if (this->translatingSuperblock && (address >> K_PAGE_SHIFT) != superblockPage) {
+            data->jumpTo(data->ip);
+            break;
+        }
+        if (this->translatingSpeculatively && !this->thread->memory->isValidReadAddress(address, K_MAX_X86_OP_LEN)) {
+            // decoding this would fault on the worker thread, the guest will translate it if it ever gets here
+            data->jumpTo(data->ip);
+            break;
+        }
         if (firstPass) {
             U32 nextEipLen = firstPass->calculateEipLen(data->ip+data->cpu->seg[CS].address);
             U32 page = (data->ip+data->cpu->seg[CS].address+nextEipLen) >> K_PAGE_SHIFT;
@@ -543,6 +752,12 @@ U64 x64CPU::handleCodePatch(U64 rip, U32 address, U64 rsi, U64 rdi, std::functio
         } else {
             this->df = 1;
         }
+        // a plain mov to a line of the page that doesn't hold code can be done here, then the code on the page can stay
+        if (BtCodeMemoryWrite::emulateDataLineStore(this, op)) {
+            this->eip.u32 += op->len;
+            op->dealloc(true);
+            return getRipFromEip();
+        }
         U32 addressStart = address;
         U32 len = instructionInfo[op->inst].writeMemWidth / 8;
 
@@ -565,6 +780,7 @@ U64 x64CPU::handleCodePatch(U64 rip, U32 address, U64 rsi, U64 rdi, std::functio
         }
         U32 startPage = addressStart >> K_PAGE_SHIFT;
         U32 endPage = (addressStart + len - 1) >> K_PAGE_SHIFT;
+        BtCodeMemoryWrite::codeLineWrites.fetch_add(1, std::memory_order_relaxed);
         memory->clearHostCodeForWriting(memory->getNativePage(startPage), memory->getNativePage(endPage - startPage + 1));            
         op->dealloc(true);
         return getRipFromEip();
@@ -605,7 +821,10 @@ U64 x64CPU::reTranslateChunk() {
     BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->thread->memory->executableMemoryMutex);
 #endif
     std::shared_ptr<BtCodeChunk> chunk = this->thread->memory->getCodeChunkContainingEip(this->eip.u32 + this->seg[CS].address);
-    if (chunk) {
+    if (chunk && chunk->isHot() && chunk->getEip() == this->eip.u32 + this->seg[CS].address) {
+        this->translateSuperblock(chunk);
+    } else if (chunk && (chunk->isLinkPlaceholder() || !chunk->getHostFromEip(this->eip.u32 + this->seg[CS].address))) {
+        // a BtTranslationPool worker might have already replaced the placeholder this was called from
         chunk->releaseAndRetranslate();
     }    
 
@@ -794,6 +1013,8 @@ void x64CPU::startThread() {
     }
     std::shared_ptr<KProcess> process = thread->process;
 	process->deleteThread(thread);
+    DecodedOp::releaseThreadCache();
+    NormalCPU::releaseThreadCache();
 
     platformThreadCount--;
     if (platformThreadCount==0) {
@@ -8,6 +8,11 @@
 
 class X64Asm;
 
+// how many times a chunk is entered before it is translated again as a superblock
+#define X64_HOT_CHUNK_COUNT 5000
+// the longest jmp forward that a superblock will translate through instead of ending
+#define X64_SUPERBLOCK_MAX_JMP 256
+
 class x64CPU : public BtCPU {
 public:
     x64CPU();
@@ -17,6 +22,7 @@ public:
     virtual void restart();
     void* init();
     virtual void* translateEip(U32 ip);
+    virtual bool translateSpeculatively(U32 ip);
 
 	jmp_buf* jmpBuf;
 
@@ -46,6 +52,8 @@ public:
     void* jmpAndTranslateIfNecessary;
 #endif
     static bool hasBMI2;
+    static bool useHotChunkCounters;
+    bool translatingSuperblock;
 
 #ifdef _DEBUG
     U32 fromEip;
@@ -81,10 +89,19 @@ public:
 #endif
 private:      
     std::shared_ptr<BtCodeChunk> translateChunk(X64Asm* parent, U32 ip);
+    std::shared_ptr<BtCodeChunk> loadChunkFromCodeCache(X64Asm* parent, U32 ip);
+    void addChunkToCodeCache(X64Asm* data);
     void* translateEipInternal(X64Asm* parent, U32 ip);            
     void markCodePageReadOnly(X64Asm* data);
 
     std::vector<U32> pendingCodePages;
+    bool translatingSpeculatively; // set while a BtTranslationPool worker is translating with this cpu
+
+    S32* allocHotChunkCounter();
+    bool canAddToSuperblock(U32 address, U32 page);
+    void translateSuperblock(std::shared_ptr<BtCodeChunk>& chunk);
+    bool noHotChunkCounter; // set if a superblock could not be made, so that the chunk won't get hot again
+    std::vector<std::shared_ptr<BtCodeChunk>> superblockChunks; // existing chunks that the superblock being translated will replace
 };
 #endif
 #endif
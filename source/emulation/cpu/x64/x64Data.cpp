@@ -24,6 +24,8 @@ X64Data::X64Data(x64CPU* cpu) : cpu(cpu) {
     this->stopAfterInstruction = -1;
     this->dynamic = false;
     this->useSingleMemOffset = true;
+    this->hotChunkCounter = NULL;
+    this->hotChunkCounterPos = 0;
 }
 
 X64Data::~X64Data() {
@@ -109,6 +109,9 @@ public:
     x64CPU* cpu;
 
     std::vector<TodoJump> todoJump;
+    std::vector<U32> hostPointers; // buffer positions of 8 byte pointers to host functions/data
+    S32* hotChunkCounter; // counts down each time the chunk is entered, see X64Asm::addHotChunkCounter
+    U32 hotChunkCounterPos; // buffer position of the 8 byte pointer to hotChunkCounter, 0 if there isn't one
     S32 stopAfterInstruction;
 
     U8 calculateEipLen(U32 eip);
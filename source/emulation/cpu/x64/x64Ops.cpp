@@ -1018,7 +1018,7 @@ static U32 callJd(X64Asm* data) {
 static U32 jmpJw(X64Asm* data) {
     S16 offset = (S16)data->fetch16();
     data->jumpTo(data->ip+offset);
-    data->done = true;
+    data->done = !data->continuesSuperblock(data->ip+offset);
     return 0;
 }
 
@@ -1026,7 +1026,7 @@ static U32 jmpJw(X64Asm* data) {
 static U32 jmpJb(X64Asm* data) {
     S8 offset = (S8)data->fetch8();
     data->jumpTo(data->ip+offset);
-    data->done = true;
+    data->done = !data->continuesSuperblock(data->ip+offset);
     return 0;
 }
 
@@ -1034,7 +1034,7 @@ static U32 jmpJb(X64Asm* data) {
 static U32 jmpJd(X64Asm* data) {
     S32 offset = (S32)data->fetch32();
     data->jumpTo(data->ip+offset);
-    data->done = true;
+    data->done = !data->continuesSuperblock(data->ip+offset);
     return 0;
 }
 
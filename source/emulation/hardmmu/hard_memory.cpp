@@ -24,8 +24,9 @@
 #include "hard_memory.h"
 #include "../cpu/binaryTranslation/btCodeMemoryWrite.h"
 #include "../cpu/binaryTranslation/btCodeChunk.h"
+#include "../cpu/binaryTranslation/btTranslationPool.h"
 
-Memory::Memory() : allocated(0), callbackPos(0) {
+Memory::Memory() : blockGeneration(0), allocated(0), protectionGeneration(0), nativeLayers(NULL), callbackPos(0) {
     memset(flags, 0, sizeof(flags));
     memset(nativeFlags, 0, sizeof(nativeFlags));
     memset(memOffsets, 0, sizeof(memOffsets));
@@ -41,6 +42,7 @@ Memory::Memory() : allocated(0), callbackPos(0) {
     this->eipToHostInstructionAddressSpaceMapping = NULL;
     memset(this->dynamicCodePageUpdateCount, 0, sizeof(this->dynamicCodePageUpdateCount));
     memset(this->committedEipPages, 0, sizeof(this->committedEipPages));
+    this->codePageWriterCount = 0;
 #endif    
     reserveNativeMemory(this);
 
@@ -55,6 +57,9 @@ Memory::Memory() : allocated(0), callbackPos(0) {
 }
 
 Memory::~Memory() {    
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+    BtTranslationPool::cancel(this);
+#endif
     releaseNativeMemory(this);
 #ifdef BOXEDWINE_BINARY_TRANSLATOR
     if (this->eipToHostInstructionPages) {
@@ -92,8 +97,12 @@ void Memory::log_pf(KThread* thread, U32 address) {
 }
 
 void Memory::reset() {
+    this->protectionGeneration++;
     releaseNativeMemory(this);
     reserveNativeMemory(this);
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+    this->lazyFilePages.clear();
+#endif
 
     this->callbackPos = 0;
     allocNativeMemory(CALL_BACK_ADDRESS >> K_PAGE_SHIFT, K_NATIVE_PAGES_PER_PAGE, PAGE_READ | PAGE_EXEC | PAGE_WRITE);
@@ -102,6 +111,7 @@ void Memory::reset() {
 
 void Memory::reset(U32 page, U32 pageCount) {
     BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(pageMutex);
+    this->protectionGeneration++;
     this->clearNeedsMemoryOffset(page, pageCount);
     freeNativeMemory(page, pageCount);        
 }
@@ -109,6 +119,21 @@ void Memory::reset(U32 page, U32 pageCount) {
 void Memory::clone(Memory* from) {
     int i=0;    
 
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(from->pageMutex);
+    if (KSystem::copyOnWriteFork && cloneNativeMemory(this, from)) {
+        // the native pages are now shared copy-on-write, only the emulated page flags need to be copied
+        for (i=0;i<0x100000;i++) {
+            this->flags[i] = from->flags[i];
+            if (from->flags[i] & PAGE_MAPPED_HOST) {
+                this->memOffsets[i] = from->memOffsets[i];
+            }
+        }
+        this->allocated = from->allocated;
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+        cloneLazyFilePages(from);
+#endif
+        return;
+    }
     for (i=0;i<0x100000;i++) {
         if (from->isPageAllocated(i)) {
             if (from->flags[i] & PAGE_MAPPED_HOST) {
@@ -116,6 +141,15 @@ void Memory::clone(Memory* from) {
                 this->memOffsets[i] = from->memOffsets[i];
                 continue;
             }
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+            // no need to read the page just to copy it, the child will read it from its own copy of the file
+            if (from->nativeFlags[getNativePage(i)] & NATIVE_FLAG_LAZY) {
+                allocNativeMemory(i, 1, from->flags[i], false);
+                this->nativeFlags[getNativePage(i)] |= NATIVE_FLAG_LAZY;
+                updatePagePermission(i, 1);
+                continue;
+            }
+#endif
             bool changedWritePermission = false;
             if (!(from->flags[i] & PAGE_WRITE)) {
                 changedWritePermission = true;
@@ -137,17 +171,239 @@ void Memory::clone(Memory* from) {
             this->flags[i] = from->flags[i];
         }     
     }
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+    cloneLazyFilePages(from);
+#endif
+}
+
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+std::unordered_map<std::string, std::weak_ptr<SharedFilePages>> SharedFilePages::cache;
+BOXEDWINE_MUTEX SharedFilePages::cacheMutex;
+
+std::shared_ptr<SharedFilePages> SharedFilePages::get(const BoxedPtr<FsNode>& node) {
+    std::string key = node->getContentKey();
+    if (!key.length()) {
+        return nullptr;
+    }
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(cacheMutex);
+    std::weak_ptr<SharedFilePages>& existing = cache[key];
+    std::shared_ptr<SharedFilePages> result = existing.lock();
+    if (result) {
+        return result;
+    }
+    U32 pageCount = (U32)((node->length() + K_PAGE_MASK) >> K_PAGE_SHIFT);
+    std::shared_ptr<NativeMemoryFile> file = createNativeMemoryFile((U64)pageCount << K_PAGE_SHIFT);
+    if (!file) {
+        cache.erase(key);
+        return nullptr;
+    }
+    FsOpenNode* openNode = node->open(K_O_RDONLY);
+    if (!openNode) {
+        cache.erase(key);
+        return nullptr;
+    }
+    result = std::make_shared<SharedFilePages>(openNode, file, pageCount);
+    existing = result;
+    return result;
+}
+
+SharedFilePages::~SharedFilePages() {
+    delete this->openNode;
+}
+
+bool SharedFilePages::load(U32 filePage) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->mutex);
+    if (filePage >= this->loaded.size() || this->loaded[filePage]) {
+        return true;
+    }
+    U8 buffer[K_PAGE_SIZE];
+    U32 read = 0;
+
+    this->openNode->seek((U64)filePage << K_PAGE_SHIFT);
+    while (read < K_PAGE_SIZE) {
+        U32 result = this->openNode->readNative(buffer + read, K_PAGE_SIZE - read);
+        if (!result || result > K_PAGE_SIZE - read) {
+            break;
+        }
+        read += result;
+    }
+    // the rest of the page is already 0
+    if (read && !writeNativeMemoryFile(this->file.get(), (U64)filePage << K_PAGE_SHIFT, buffer, read)) {
+        return false;
+    }
+    this->loaded[filePage] = true;
+    return true;
+}
+
+LazyFile::~LazyFile() {
+    if (this->openNode) {
+        delete this->openNode;
+    }
+}
+
+// gives this memory its own open file for each of the ranges in from that still have pages to read, the pages that
+// have NATIVE_FLAG_LAZY were already copied from from
+void Memory::cloneLazyFilePages(Memory* from) {
+    std::unordered_map<LazyFile*, std::shared_ptr<LazyFile>> files;
+
+    for (auto& it : from->lazyFilePages) {
+        LazyFilePages* pages = it.second.get();
+        if (!pages->file->waitingPages) {
+            continue;
+        }
+        std::shared_ptr<LazyFile>& file = files[pages->file.get()];
+        if (!file && pages->file->shared) {
+            file = std::make_shared<LazyFile>((FsOpenNode*)NULL);
+            file->shared = pages->file->shared;
+        } else if (!file) {
+            FsOpenNode* openNode = pages->file->openNode->node->open(K_O_RDONLY);
+            if (!openNode) {
+                klog("could not reopen %s for a forked file mapping", pages->file->openNode->node->path.c_str());
+                continue;
+            }
+            file = std::make_shared<LazyFile>(openNode);
+        }
+        for (U32 i = 0; i < pages->pageCount; i++) {
+            if (this->nativeFlags[getNativePage(pages->page + i)] & NATIVE_FLAG_LAZY) {
+                file->waitingPages++;
+            }
+        }
+        this->lazyFilePages[pages->page] = std::make_shared<LazyFilePages>(file, pages->page, pages->pageCount, pages->offset);
+    }
+}
+
+// pageMutex must be held
+void Memory::loadLazyFilePage(U32 page, LazyFilePages* pages) {
+    LazyFile* file = pages->file.get();
+    U64 pos = pages->offset + ((U64)(page - pages->page) << K_PAGE_SHIFT);
+
+    if (file->shared) {
+        // the page is mapped from the shared file and this process hasn't written to it, so it will see the data
+        if (!file->shared->load((U32)(pos >> K_PAGE_SHIFT))) {
+            klog("could not read page %X of %s", (U32)(pos >> K_PAGE_SHIFT), file->shared->openNode->node->path.c_str());
+        }
+    } else {
+        U8* address = (U8*)getNativeAddress(this, page << K_PAGE_SHIFT);
+        U32 read = 0;
+
+        Platform::updateNativePermission((U64)address, PAGE_READ | PAGE_WRITE);
+        file->openNode->seek(pos);
+        while (read < K_PAGE_SIZE) {
+            U32 result = file->openNode->readNative(address + read, K_PAGE_SIZE - read);
+            if (!result || result > K_PAGE_SIZE - read) {
+                break;
+            }
+            read += result;
+        }
+        memset(address + read, 0, K_PAGE_SIZE - read);
+    }
+    U32 nativePage = getNativePage(page);
+    this->nativeFlags[nativePage] = (this->nativeFlags[nativePage] & ~NATIVE_FLAG_LAZY) | NATIVE_FLAG_LAZY_LOADED;
+    if (!--file->waitingPages) {
+        delete file->openNode;
+        file->openNode = NULL;
+    }
+    updatePagePermission(page, 1);
+}
+
+static LazyFilePages* findLazyFilePages(std::map<U32, std::shared_ptr<LazyFilePages>>& lazyFilePages, U32 page) {
+    auto it = lazyFilePages.upper_bound(page);
+    if (it == lazyFilePages.begin()) {
+        return NULL;
+    }
+    --it;
+    if (page >= it->second->page + it->second->pageCount) {
+        return NULL;
+    }
+    return it->second.get();
+}
+
+bool Memory::loadLazyFilePage(void* hostAddress, bool write) {
+    U64 address = (U64)hostAddress;
+
+    if ((address & 0xFFFFFFFF00000000l) != this->id) {
+        return false;
+    }
+    U32 page = (U32)address >> K_PAGE_SHIFT;
+    U32 nativePage = getNativePage(page);
+    if (!(this->nativeFlags[nativePage] & (NATIVE_FLAG_LAZY | NATIVE_FLAG_LAZY_LOADED))) {
+        return false;
+    }
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->pageMutex);
+    if (this->nativeFlags[nativePage] & NATIVE_FLAG_LAZY) {
+        LazyFilePages* pages = findLazyFilePages(this->lazyFilePages, page);
+        if (!pages || !pages->file->canLoad()) {
+            return false;
+        }
+        loadLazyFilePage(page, pages);
+        return true;
+    }
+    if (!(this->nativeFlags[nativePage] & NATIVE_FLAG_LAZY_LOADED)) {
+        return false;
+    }
+    // Another thread read the page after this one faulted on it.  If the page allows the access then that was the
+    // reason for the fault, otherwise it is a real one.
+    U32 flags = this->flags[page];
+    if (write ? !(flags & PAGE_WRITE) || (this->nativeFlags[nativePage] & NATIVE_FLAG_CODEPAGE_READONLY) : !(flags & (PAGE_READ | PAGE_EXEC))) {
+        return false;
+    }
+    updatePagePermission(page, 1);
+    return true;
+}
+
+bool Memory::isLazyFilePage(void* hostAddress) {
+    U64 address = (U64)hostAddress;
+
+    if ((address & 0xFFFFFFFF00000000l) != this->id) {
+        return false;
+    }
+    return (this->nativeFlags[getNativePage((U32)address >> K_PAGE_SHIFT)] & NATIVE_FLAG_LAZY) != 0;
+}
+
+void Memory::loadLazyFilePages(U32 address, U32 len) {
+    U32 startPage = address >> K_PAGE_SHIFT;
+    U32 endPage = (address + (len ? len : 1) - 1) >> K_PAGE_SHIFT;
+
+    for (U32 page = startPage; page <= endPage; page++) {
+        if (this->nativeFlags[getNativePage(page)] & NATIVE_FLAG_LAZY) {
+            BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->pageMutex);
+            if (this->nativeFlags[getNativePage(page)] & NATIVE_FLAG_LAZY) {
+                LazyFilePages* pages = findLazyFilePages(this->lazyFilePages, page);
+                if (pages && pages->file->canLoad()) {
+                    loadLazyFilePage(page, pages);
+                }
+            }
+        }
+    }
+}
+#endif
+
+// the string can end on any page, so its pages are read one at a time until the terminator is found
+static void loadLazyFilePagesForString(Memory* memory, U32 address) {
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+    while (true) {
+        U32 len = K_PAGE_SIZE - (address & K_PAGE_MASK);
+        loadLazyFilePagesForHost(memory, address, len);
+        if (memchr(getNativeAddress(memory, address), 0, len)) {
+            return;
+        }
+        address += len;
+    }
+#endif
 }
 
 void zeroMemory(U32 address, int len) {
+    loadLazyFilePagesForHost(KThread::currentThread()->process->memory, address, len);
     memset(getNativeAddress(KThread::currentThread()->process->memory, address), 0, len);
 }
 
 void readMemory(U8* data, U32 address, int len) {
+    loadLazyFilePagesForHost(KThread::currentThread()->process->memory, address, len);
     memcpy(data, getNativeAddress(KThread::currentThread()->process->memory, address), len);
 }
 
 void writeMemory(U32 address, U8* data, int len) {
+    loadLazyFilePagesForHost(KThread::currentThread()->process->memory, address, len);
     memcpy(getNativeAddress(KThread::currentThread()->process->memory, address), data, len);
 }
 
@@ -188,12 +444,16 @@ U32 Memory::mapNativeMemory(void* hostAddress, U32 size) {
 
 void Memory::allocPages(U32 page, U32 pageCount, U8 permissions, FD fd, U64 offset, const BoxedPtr<MappedFile>& mappedFile) {
     BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(pageMutex);
+    this->protectionGeneration++;
     for (U32 i = 0; i < pageCount; i++) {
         this->clearCodePageFromCache(page + i);
     }
     this->clearNeedsMemoryOffset(page, pageCount);
     if ((permissions & PAGE_PERMISSION_MASK) || mappedFile) {
         if ((permissions & PAGE_SHARED) == 0) {
+            if (mappedFile && mapFilePages(page, pageCount, permissions, offset, mappedFile)) {
+                return;
+            }
             allocNativeMemory(page, pageCount, permissions);
         } else {
             bool needToLoad = false;       
@@ -255,6 +515,7 @@ void Memory::allocPages(U32 page, U32 pageCount, U8 permissions, FD fd, U64 offs
 }
 
 void Memory::protectPage(U32 i, U32 permissions) {    
+    this->protectionGeneration++;
     if (!this->isPageAllocated(i) && (permissions & PAGE_PERMISSION_MASK)) {
         this->allocPages(i, 1, permissions, 0, 0, 0);
     } else {
@@ -333,15 +594,15 @@ bool Memory::isPageMapped(U32 page) {
 }
 
 void memcopyFromNative(U32 address, const void* p, U32 len) {
-    memcpy(getNativeAddress(KThread::currentThread()->process->memory, address), p, len);
+    memcpy(getPhysicalWriteAddress(address, len), p, len);
 }
 
 void memcopyToNative(U32 address, void* p, U32 len) {
-    memcpy(p, getNativeAddress(KThread::currentThread()->process->memory, address), len);
+    memcpy(p, getPhysicalReadAddress(address, len), len);
 }
 
 void writeNativeString(U32 address, const char* str) {	
-    strcpy((char*)getNativeAddress(KThread::currentThread()->process->memory, address), str);
+    strcpy((char*)getPhysicalWriteAddress(address, (U32)strlen(str) + 1), str);
 }
 
 U32 writeNativeString2(U32 address, const char* str, U32 len) {	
@@ -371,6 +632,7 @@ char* getNativeString(U32 address, char* buffer, U32 cbResult) {
         buffer[0]=0;
         return buffer;
     }
+    loadLazyFilePagesForString(KThread::currentThread()->memory, address);
     return (char*)getNativeAddress(KThread::currentThread()->memory, address);
 }
 
@@ -392,6 +654,7 @@ char* getNativeStringW(U32 address, char* buffer, U32 cbResult) {
 }
 
 U32 getNativeStringLen(U32 address) {
+    loadLazyFilePagesForString(KThread::currentThread()->memory, address);
     return (U32)strlen((char*)getNativeAddress(KThread::currentThread()->memory, address));
 }
 
@@ -402,6 +665,7 @@ U8 readb(U32 address) {
         fprintf(logFile, "readb %X @%X\n", result, address);
     return result;
 #else
+    loadLazyFilePagesForHost(KThread::currentThread()->memory, address, sizeof(U8));
     return *(U8*)getNativeAddress(KThread::currentThread()->memory, address);
 #endif
 }
@@ -414,6 +678,7 @@ void writeb(U32 address, U8 value) {
 #ifdef BOXEDWINE_BINARY_TRANSLATOR
     Memory* m = KThread::currentThread()->memory;
     U32 page = address >> K_PAGE_SHIFT;
+    loadLazyFilePagesForHost(m, address, 1);
     U32 nativePage = m->getNativePage(page);
     U8 flags = m->nativeFlags[nativePage];
 
@@ -437,6 +702,7 @@ U16 readw(U32 address) {
         fprintf(logFile, "readw %X @%X\n", result, address);
     return result;
 #else
+    loadLazyFilePagesForHost(KThread::currentThread()->memory, address, sizeof(U16));
     return *(U16*)getNativeAddress(KThread::currentThread()->memory, address);
 #endif
 }
@@ -451,6 +717,7 @@ void writew( U32 address, U16 value) {
 #ifdef BOXEDWINE_BINARY_TRANSLATOR
     Memory* m = KThread::currentThread()->memory;
     U32 page = address >> K_PAGE_SHIFT;
+    loadLazyFilePagesForHost(m, address, 2);
     U32 nativePage = m->getNativePage(page);
     U8 flags = m->nativeFlags[nativePage];
 
@@ -474,6 +741,7 @@ U32 readd(U32 address) {
         fprintf(logFile, "readd %X @%X\n", result, address);
     return result;
 #else
+    loadLazyFilePagesForHost(KThread::currentThread()->memory, address, sizeof(U32));
     return *(U32*)getNativeAddress(KThread::currentThread()->memory, address);
 #endif
 }
@@ -486,6 +754,7 @@ void writed(U32 address, U32 value) {
 #ifdef BOXEDWINE_BINARY_TRANSLATOR
     Memory* m = KThread::currentThread()->memory;
     U32 page = address >> K_PAGE_SHIFT;
+    loadLazyFilePagesForHost(m, address, 4);
     U32 nativePage = m->getNativePage(page);
     U8 flags = m->nativeFlags[nativePage];
 
@@ -503,6 +772,7 @@ void writed(U32 address, U32 value) {
 }
 
 U64 readq(U32 address) {
+    loadLazyFilePagesForHost(KThread::currentThread()->memory, address, 8);
     return *(U64*)getNativeAddress(KThread::currentThread()->memory, address);
 }
 
@@ -510,6 +780,7 @@ void writeq(U32 address, U64 value) {
 #ifdef BOXEDWINE_BINARY_TRANSLATOR
     Memory* m = KThread::currentThread()->memory;
     U32 page = address >> K_PAGE_SHIFT;
+    loadLazyFilePagesForHost(m, address, 8);
     U32 nativePage = m->getNativePage(page);
     U8 flags = m->nativeFlags[nativePage];
 
@@ -688,6 +959,7 @@ static void OPCALL emptyOp(CPU* cpu, DecodedOp* op) {
 
 void Memory::clearCodePageFromCache(U32 page) {
 #ifdef BOXEDWINE_BINARY_TRANSLATOR
+    this->clearCodeLines(page);
     if (KSystem::useLargeAddressSpace) {
         KThread* thread = KThread::currentThread();
         std::shared_ptr<KProcess> process;
@@ -742,6 +1014,7 @@ void Memory::clearCodePageFromCache(U32 page) {
                 BlockCache* c = cacheBlock->next;
 
                 this->removeBlock(block, cacheBlock->ip);
+                this->blockGeneration++;
 
                 if (DecodedBlock::currentBlock == block) {
                     // we don't have a pointer to the current op, so just set them all
@@ -785,18 +1058,28 @@ void Memory::onThreadChanged() {
 U8* getPhysicalAddress(U32 address, U32 len) {
     if (!address)
         return NULL;
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+    // the pointer might be handed to the host kernel, it won't fault on these pages for us, the call would just fail
+    KThread::currentThread()->process->memory->loadLazyFilePages(address, len);
+#endif
     return (U8*)getNativeAddress(KThread::currentThread()->process->memory, address);
 }
 
 U8* getPhysicalReadAddress(U32 address, U32 len) {
     if (!address)
         return NULL;
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+    KThread::currentThread()->process->memory->loadLazyFilePages(address, len);
+#endif
     return (U8*)getNativeAddress(KThread::currentThread()->process->memory, address);
 }
 
 U8* getPhysicalWriteAddress(U32 address, U32 len) {
     if (!address)
         return NULL;
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+    KThread::currentThread()->process->memory->loadLazyFilePages(address, len);
+#endif
     return (U8*)getNativeAddress(KThread::currentThread()->process->memory, address);
 }
 
@@ -852,6 +1135,87 @@ void Memory::addCodeChunk(const std::shared_ptr<BtCodeChunk>& chunk) {
         this->codeChunksByEmulationPage[emulationPage] = chunks;
     }
     chunks->push_back(chunk);
+    this->markCodeLines(chunk->getEip(), chunk->getEipLen());
+}
+
+static U64 getCodeLineMask(U32 offset, U32 len) {
+    U32 first = offset >> K_CODE_LINE_SHIFT;
+    U32 count = ((offset + len - 1) >> K_CODE_LINE_SHIFT) - first + 1;
+    if (count == 64) {
+        return 0xFFFFFFFFFFFFFFFFl;
+    }
+    return (((U64)1 << count) - 1) << first;
+}
+
+void Memory::markCodeLines(U32 address, U32 len) {
+    while (len) {
+        U32 offset = address & K_PAGE_MASK;
+        U32 todo = K_PAGE_SIZE - offset;
+        if (todo > len) {
+            todo = len;
+        }
+        this->codeLines[address >> K_PAGE_SHIFT] |= getCodeLineMask(offset, todo);
+        address += todo;
+        len -= todo;
+    }
+}
+
+U64 Memory::getCodeLines(U32 page) {
+    auto it = this->codeLines.find(page);
+    if (it == this->codeLines.end()) {
+        return 0;
+    }
+    return it->second;
+}
+
+void Memory::clearCodeLines(U32 page) {
+    this->codeLines.erase(page);
+}
+
+bool Memory::isCodeLineWrite(U32 address, U32 len) {
+    while (len) {
+        U32 page = address >> K_PAGE_SHIFT;
+        U32 offset = address & K_PAGE_MASK;
+        U32 todo = K_PAGE_SIZE - offset;
+        if (todo > len) {
+            todo = len;
+        }
+        U32 nativePage = this->getNativePage(page);
+        if ((this->nativeFlags[nativePage] & NATIVE_FLAG_CODEPAGE_READONLY) || this->isCodePageBeingWritten(nativePage)) {
+            auto it = this->codeLines.find(page);
+            // a read only page without lines would have code that was added without addCodeChunk
+            if (it == this->codeLines.end() || (it->second & getCodeLineMask(offset, todo))) {
+                return true;
+            }
+        }
+        address += todo;
+        len -= todo;
+    }
+    return false;
+}
+
+void Memory::beginCodePageWrite(U32 nativePage) {
+    if (this->codePageWriters[nativePage]++ == 0) {
+        this->codePageWriterCount++;
+    }
+}
+
+bool Memory::endCodePageWrite(U32 nativePage) {
+    auto it = this->codePageWriters.find(nativePage);
+    if (it == this->codePageWriters.end()) {
+        return true;
+    }
+    if (--it->second) {
+        return false;
+    }
+    this->codePageWriters.erase(it);
+    this->codePageWriterCount--;
+    return true;
+}
+
+bool Memory::hasCodePageWriters(U32 nativePage) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->executableMemoryMutex);
+    return this->codePageWriters.count(nativePage) != 0;
 }
 
 void Memory::makeNativePageDynamic(U32 nativePage) {
@@ -946,6 +1310,9 @@ void Memory::clearHostCodeForWriting(U32 nativePage, U32 count) {
             i=chunk->getEip()+chunk->getEipLen()-1;
         }
     }
+    for (U32 page = addressStart >> K_PAGE_SHIFT; page < (addressStop >> K_PAGE_SHIFT); page++) {
+        this->clearCodeLines(page);
+    }
 
     for (U32 page = nativePage; page < nativePage + count; page++) {
         if (this->nativeFlags[page] & NATIVE_FLAG_CODEPAGE_READONLY) {
@@ -1067,6 +1434,9 @@ void Memory::executableMemoryReleased() {
     for (U32 i = 0; i < EXECUTABLE_SIZES; i++) {
         this->freeExecutableMemory[i].clear();
     }
+    this->hotChunkCounters.clear();
+    this->freeHotChunkCounters.clear();
+    this->codeLines.clear();
 #endif   
 }
 #endif
@@ -1075,7 +1445,9 @@ static U32 getNativePermissionIndex(U32 page) {
     return (page << K_PAGE_SHIFT) >> K_NATIVE_PAGE_SHIFT;
 }
 
-void Memory::allocNativeMemory(U32 page, U32 pageCount, U32 flags) {
+void Memory::allocNativeMemory(U32 page, U32 pageCount, U32 flags, bool zero) {
+    releaseFilePages(page, pageCount);
+
     U32 gran = Platform::getPageAllocationGranularity();
     U32 permissionGran = Platform::getPagePermissionGranularity();
     U32 granPage = page & ~(gran - 1);
@@ -1102,7 +1474,9 @@ void Memory::allocNativeMemory(U32 page, U32 pageCount, U32 flags) {
         this->memOffsets[page + i] = this->id;
     }
     
-    memset(getNativeAddress(this, page << K_PAGE_SHIFT), 0, pageCount << K_PAGE_SHIFT);
+    if (zero) {
+        memset(getNativeAddress(this, page << K_PAGE_SHIFT), 0, pageCount << K_PAGE_SHIFT);
+    }
 
     granPage = page & ~(gran - 1);
     U32 granPageCount = granCount * gran;
@@ -1111,6 +1485,7 @@ void Memory::allocNativeMemory(U32 page, U32 pageCount, U32 flags) {
 }
 
 void Memory::freeNativeMemory(U32 page, U32 pageCount) {    
+    releaseFilePages(page, pageCount);
     for (U32 i = 0; i < pageCount; i++) {
         U32 nativePermissionIndex = getNativePermissionIndex(page + i);
         this->nativeFlags[nativePermissionIndex] &= ~NATIVE_FLAG_CODEPAGE_READONLY;
@@ -1176,6 +1551,10 @@ void Memory::updatePagePermission(U32 page, U32 pageCount) {
         }
         U64 address = (this->id | (permissionGranPage << K_PAGE_SHIFT));
         U32 index = getNativePermissionIndex(permissionGranPage);
+        // like shared pages, the first access needs to generate an exception so that the page can be read
+        if (this->nativeFlags[index] & NATIVE_FLAG_LAZY) {
+            permissions = 0;
+        }
         if (this->nativeFlags[index] & NATIVE_FLAG_COMMITTED) {
             this->nativeFlags[index] &= ~PAGE_PERMISSION_MASK;
             this->nativeFlags[index] |= (permissions & (PAGE_READ | PAGE_WRITE));
@@ -1186,6 +1565,9 @@ void Memory::updatePagePermission(U32 page, U32 pageCount) {
 }
 
 void Memory::updateNativePermission(U32 page, U32 pageCount, U32 permission) {
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+    loadLazyFilePages(page << K_PAGE_SHIFT, pageCount << K_PAGE_SHIFT);
+#endif
     U32 permissionGran = Platform::getPagePermissionGranularity();
     U32 permissionGranPage = page & ~(permissionGran - 1);
     U32 permissionGranCount = ((permissionGran - 1) + pageCount + (page - permissionGranPage)) / permissionGran;
@@ -1201,4 +1583,123 @@ void Memory::updateNativePermission(U32 page, U32 pageCount, U32 permission) {
         permissionGranPage += permissionGran;
     }
 }
+
+// Private file mappings aren't read when they are mapped.  Pages of a host file are mapped straight from it and the
+// host reads them when they are first touched, the pages of other files, like the ones in a zip file, are read by
+// loadLazyFilePage the first time they fault.  If the other file's contents can be identified, its pages are mapped
+// from a SharedFilePages so that all processes share them.  Returns false if the pages need to be read now.
+bool Memory::mapFilePages(U32 page, U32 pageCount, U32 permissions, U64 offset, const BoxedPtr<MappedFile>& mappedFile) {
+    FsOpenNode* openNode = mappedFile->file->openFile;
+    S64 length = openNode->length();
+
+    if (length <= (S64)offset) {
+        return false;
+    }
+    U64 filePageCount = ((U64)length - offset + K_PAGE_MASK) >> K_PAGE_SHIFT;
+    if (filePageCount > pageCount) {
+        filePageCount = pageCount;
+    }
+    allocNativeMemory(page, (U32)filePageCount, permissions, false);
+    if (openNode->node->type == FsNode::File && openNode->node->nativePath.length() && mapNativeFile(this, page, (U32)filePageCount, openNode->node->nativePath, offset)) {
+        for (U32 i = 0; i < filePageCount; i++) {
+            this->nativeFlags[getNativePage(page + i)] |= NATIVE_FLAG_FILE;
+        }
+    } else {
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+        std::shared_ptr<LazyFile> file;
+        std::shared_ptr<SharedFilePages> shared = SharedFilePages::get(openNode->node);
+
+        if (shared && mapNativeMemoryFile(this, page, (U32)filePageCount, shared->file, offset)) {
+            file = std::make_shared<LazyFile>((FsOpenNode*)NULL);
+            file->shared = shared;
+            for (U32 i = 0; i < filePageCount; i++) {
+                this->nativeFlags[getNativePage(page + i)] |= NATIVE_FLAG_FILE;
+            }
+        } else {
+            FsOpenNode* lazyNode = openNode->node->open(K_O_RDONLY);
+            if (!lazyNode) {
+                return false;
+            }
+            file = std::make_shared<LazyFile>(lazyNode);
+        }
+        file->waitingPages = (U32)filePageCount;
+        this->lazyFilePages[page] = std::make_shared<LazyFilePages>(file, page, (U32)filePageCount, offset);
+        for (U32 i = 0; i < filePageCount; i++) {
+            this->nativeFlags[getNativePage(page + i)] |= NATIVE_FLAG_LAZY;
+        }
+#else
+        return false;
+#endif
+    }
+    updatePagePermission(page, (U32)filePageCount);
+    if (filePageCount < pageCount) {
+        allocNativeMemory(page + (U32)filePageCount, pageCount - (U32)filePageCount, permissions);
+    }
+    return true;
+}
+
+// called before the native memory of the pages is reused or freed
+void Memory::releaseFilePages(U32 page, U32 pageCount) {
+    U32 runStart = 0;
+    U32 runCount = 0;
+
+    for (U32 i = 0; i < pageCount; i++) {
+        U32 nativePage = getNativePage(page + i);
+        if (this->nativeFlags[nativePage] & NATIVE_FLAG_FILE) {
+            if (!runCount) {
+                runStart = page + i;
+            }
+            runCount++;
+            this->nativeFlags[nativePage] &= ~NATIVE_FLAG_FILE;
+        } else if (runCount) {
+            unmapNativeFile(this, runStart, runCount);
+            runCount = 0;
+        }
+    }
+    if (runCount) {
+        unmapNativeFile(this, runStart, runCount);
+    }
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+    if (this->lazyFilePages.size()) {
+        U32 endPage = page + pageCount;
+        auto it = this->lazyFilePages.upper_bound(page);
+
+        if (it != this->lazyFilePages.begin()) {
+            --it;
+        }
+        while (it != this->lazyFilePages.end() && it->first < endPage) {
+            std::shared_ptr<LazyFilePages> pages = it->second;
+            U32 pagesEnd = pages->page + pages->pageCount;
+
+            if (pagesEnd <= page) {
+                ++it;
+                continue;
+            }
+            U32 start = std::max(pages->page, page);
+            U32 end = std::min(pagesEnd, endPage);
+            LazyFile* file = pages->file.get();
+            for (U32 i = start; i < end; i++) {
+                if (this->nativeFlags[getNativePage(i)] & NATIVE_FLAG_LAZY) {
+                    file->waitingPages--;
+                }
+            }
+            if (!file->waitingPages && file->openNode) {
+                delete file->openNode;
+                file->openNode = NULL;
+            }
+            it = this->lazyFilePages.erase(it);
+            // keep the parts of the range that are still mapped
+            if (pages->page < start) {
+                this->lazyFilePages[pages->page] = std::make_shared<LazyFilePages>(pages->file, pages->page, start - pages->page, pages->offset);
+            }
+            if (end < pagesEnd) {
+                this->lazyFilePages[end] = std::make_shared<LazyFilePages>(pages->file, end, pagesEnd - end, pages->offset + ((U64)(end - pages->page) << K_PAGE_SHIFT));
+            }
+        }
+    }
+    for (U32 i = 0; i < pageCount; i++) {
+        this->nativeFlags[getNativePage(page + i)] &= ~(NATIVE_FLAG_LAZY | NATIVE_FLAG_LAZY_LOADED);
+    }
+#endif
+}
 #endif
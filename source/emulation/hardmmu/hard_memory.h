@@ -23,6 +23,60 @@
 
 #define NATIVE_FLAG_COMMITTED 0x08
 #define NATIVE_FLAG_CODEPAGE_READONLY 0x10
+#define NATIVE_FLAG_FILE 0x20 // mapped from a host file by mapNativeFile
+#define NATIVE_FLAG_LAZY 0x40 // has no access until it is read from its file, see LazyFilePages
+#define NATIVE_FLAG_LAZY_LOADED 0x80
+
+class NativeMemoryFile;
+
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+// The pages of a file that isn't on the host, like one in a zip file, are read once into a NativeMemoryFile that
+// every process that maps the file shares copy-on-write.  Files are found by FsNode::getContentKey.
+class SharedFilePages {
+public:
+    SharedFilePages(FsOpenNode* openNode, const std::shared_ptr<NativeMemoryFile>& file, U32 pageCount) : openNode(openNode), file(file), loaded(pageCount, false) {}
+    ~SharedFilePages();
+
+    // returns nullptr if the node's contents can't be identified or the platform can't share them
+    static std::shared_ptr<SharedFilePages> get(const BoxedPtr<FsNode>& node);
+
+    // reads the page into file if that wasn't done yet
+    bool load(U32 filePage);
+
+    FsOpenNode* const openNode;
+    const std::shared_ptr<NativeMemoryFile> file;
+private:
+    std::vector<bool> loaded;
+    BOXEDWINE_MUTEX mutex;
+
+    static std::unordered_map<std::string, std::weak_ptr<SharedFilePages>> cache;
+    static BOXEDWINE_MUTEX cacheMutex;
+};
+
+class LazyFile {
+public:
+    LazyFile(FsOpenNode* openNode) : openNode(openNode), waitingPages(0) {}
+    ~LazyFile();
+
+    bool canLoad() {return this->openNode || this->shared;}
+
+    FsOpenNode* openNode; // opened just for this, it is released once all the pages were read
+    std::shared_ptr<SharedFilePages> shared; // if set, the pages are mapped from shared->file and openNode is NULL
+    U32 waitingPages; // pages that still have NATIVE_FLAG_LAZY
+};
+
+// A range of pages of a private file mapping that are read from the file the first time they fault.  Ranges in
+// Memory::lazyFilePages never overlap, unmapping part of a range splits it.
+class LazyFilePages {
+public:
+    LazyFilePages(const std::shared_ptr<LazyFile>& file, U32 page, U32 pageCount, U64 offset) : file(file), page(page), pageCount(pageCount), offset(offset) {}
+
+    const std::shared_ptr<LazyFile> file;
+    const U32 page;
+    const U32 pageCount;
+    const U64 offset; // file offset of page
+};
+#endif
 
 INLINE void* getNativeAddress(Memory* memory, U32 address) {
     U32 page = address >> K_PAGE_SHIFT;
@@ -35,6 +89,24 @@ INLINE void* getNativeAddress(Memory* memory, U32 address) {
     return (void*)(address + memory->memOffsets[page]);
 }
 
+#ifdef BOXEDWINE_LAZY_FILE_PAGES
+// Only faults from translated code are retried after the page is read, see signalHandler(), so host code reads the
+// pages it is about to touch first.  getPhysical*Address does this for callers that are given a pointer.
+INLINE void loadLazyFilePagesForHost(Memory* memory, U32 address, U32 len) {
+    U32 endPage = (address + (len ? len : 1) - 1) >> K_PAGE_SHIFT;
+
+    for (U32 page = address >> K_PAGE_SHIFT; page <= endPage; page++) {
+        if (memory->nativeFlags[memory->getNativePage(page)] & NATIVE_FLAG_LAZY) {
+            memory->loadLazyFilePages(page << K_PAGE_SHIFT, (endPage - page + 1) << K_PAGE_SHIFT);
+            return;
+        }
+    }
+}
+#else
+INLINE void loadLazyFilePagesForHost(Memory* memory, U32 address, U32 len) {
+}
+#endif
+
 INLINE void* getNativeAddressNoCheck(Memory* memory, U32 address) {
     U32 page = address >> K_PAGE_SHIFT;
     return (void*)(address + memory->memOffsets[page]);
@@ -46,6 +118,19 @@ INLINE U32 getHostAddress(KThread* thread, void* address) {
 
 void reserveNativeMemory(Memory* memory);
 void releaseNativeMemory(Memory* memory);
+// maps the committed native pages of from into memory copy-on-write and copies their nativeFlags, returns false if
+// the platform can't do that and the pages need to be copied
+bool cloneNativeMemory(Memory* memory, Memory* from);
+// maps the pages copy-on-write from the host file at nativePath with no access, the host reads them when they are
+// touched.  Returns false if the platform can't
+bool mapNativeFile(Memory* memory, U32 page, U32 pageCount, const std::string& nativePath, U64 offset);
+// a host file in memory that can be mapped by more than one process, returns nullptr if the platform can't do that
+std::shared_ptr<NativeMemoryFile> createNativeMemoryFile(U64 length);
+bool writeNativeMemoryFile(NativeMemoryFile* file, U64 offset, U8* data, U32 len);
+// like mapNativeFile
+bool mapNativeMemoryFile(Memory* memory, U32 page, U32 pageCount, const std::shared_ptr<NativeMemoryFile>& file, U64 offset);
+// gives pages that were mapped by mapNativeFile normal native memory again, they are left with no access
+void unmapNativeFile(Memory* memory, U32 page, U32 pageCount);
 void makeCodePageReadOnly(Memory* memory, U32 page);
 bool clearCodePageReadOnly(Memory* memory, U32 page);
 U32 getHostPageSize();
@@ -3,17 +3,8 @@
 #ifdef BOXEDWINE_DEFAULT_MMU
 #include "soft_code_page.h"
 
-CodePage::CodePageEntry* CodePage::freeCodePageEntries;
-
 CodePage::CodePageEntry* CodePage::allocCodePageEntry() {
-    CodePageEntry* result;
-
-    if (freeCodePageEntries) {
-        result = freeCodePageEntries;
-        freeCodePageEntries = result->next;        
-    } else {
-       result = new CodePageEntry();
-    }	
+    CodePageEntry* result = CodePageEntryPool::alloc();
     memset(result, 0, sizeof(CodePageEntry));
     return result;
 }
@@ -21,6 +12,7 @@ CodePage::CodePageEntry* CodePage::allocCodePageEntry() {
 void CodePage::freeCodePageEntry(CodePageEntry* entry) {	
     U32 offset = entry->offset >> CODE_ENTRIES_SHIFT;
     CodePageEntry** entries = entry->page->entries;
+    entry->page->memory->blockGeneration++;
    
     if (entry->block)
         entry->block->dealloc(false);
@@ -46,16 +38,14 @@ void CodePage::freeCodePageEntry(CodePageEntry* entry) {
     if (entry->next) {
         entry->next->prev = entry->prev;
     }
-    // add the entry to the free list
-    entry->next = freeCodePageEntries;
-    freeCodePageEntries = entry; 
+    CodePageEntryPool::free(entry);
 }
 
-CodePage* CodePage::alloc(U8* page, U32 address, U32 flags) {
-    return new CodePage(page, address, flags);
+CodePage* CodePage::alloc(Memory* memory, U8* page, U32 address, U32 flags) {
+    return new CodePage(memory, page, address, flags);
 }
 
-CodePage::CodePage(U8* page, U32 address, U32 flags) : RWPage(page, address, flags, Code_Page) {
+CodePage::CodePage(Memory* memory, U8* page, U32 address, U32 flags) : RWPage(page, address, flags, Code_Page), memory(memory) {
     memset(this->entries, 0, sizeof(this->entries));
 }
 
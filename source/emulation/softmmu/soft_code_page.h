@@ -28,11 +28,11 @@
 
 class CodePage : public RWPage {
 protected:
-    CodePage(U8* page, U32 address, U32 flags);
+    CodePage(Memory* memory, U8* page, U32 address, U32 flags);
     ~CodePage();
 
 public:
-    static CodePage* alloc(U8* page, U32 address, U32 flags);
+    static CodePage* alloc(Memory* memory, U8* page, U32 address, U32 flags);
 
     void writeb(U32 address, U8 value);
     void writew(U32 address, U16 value);
@@ -61,8 +61,9 @@ private:
     CodePageEntry* findCode(U32 address, U32 len);
     void addCode(U32 eip, DecodedBlock* block, U32 len, CodePageEntry* link);
     CodePageEntry* entries[CODE_ENTRIES];
+    Memory* const memory; // the memory that has this page, its blockGeneration changes when a block is removed
 
-    static CodePageEntry* freeCodePageEntries;
+    typedef SlabPool<CodePageEntry, 1024> CodePageEntryPool;
     static CodePageEntry* allocCodePageEntry();
     static void freeCodePageEntry(CodePageEntry* entry);
 };
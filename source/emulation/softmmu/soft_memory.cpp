@@ -104,7 +104,7 @@ void Memory::addCallback(OpCallback func) {
     }
 }
 
-Memory::Memory() : nativeAddressStart(0) {
+Memory::Memory() : blockGeneration(0), nativeAddressStart(0) {
     for (int i=0;i<K_NUMBER_OF_PAGES;i++) {
         this->mmu[i] = invalidPage;
         this->mmuReadPtr[i] = NULL;
@@ -127,6 +127,7 @@ Memory::Memory() : nativeAddressStart(0) {
 }
 
 Memory::~Memory() {
+    RamPageBatch batch;
     for (int i=0;i<K_NUMBER_OF_PAGES;i++) {
         this->mmu[i]->close();
     }
@@ -138,6 +139,7 @@ Memory::~Memory() {
 }
 
 void Memory::reset() {
+    RamPageBatch batch;
     for (int i=0;i<K_NUMBER_OF_PAGES;i++) {
         this->setPage(i, invalidPage);
     }
@@ -145,12 +147,15 @@ void Memory::reset() {
 }
 
 void Memory::reset(U32 page, U32 pageCount) {
+    RamPageBatch batch;
     for (U32 i=page;i<page+pageCount;i++) {
         this->setPage(i, invalidPage);
     }
 }
 
 void Memory::clone(Memory* from) {
+    // the pages released while from's pages are changed to copy on write are freed at the end, all at once
+    RamPageBatch batch;
     for (int i=0;i<0x100000;i++) {
         Page* page = from->getPage(i);
 
@@ -200,7 +205,7 @@ void Memory::clone(Memory* from) {
                 } else if (page->type == Page::Type::NO_Page) {
                     this->setPage(i, NOPage::alloc(p->page, p->address, p->flags));
                 } else if (page->type == Page::Type::Code_Page) {
-                    this->setPage(i, CodePage::alloc(p->page, p->address, p->flags));
+                    this->setPage(i, CodePage::alloc(this, p->page, p->address, p->flags));
                 }
             }
         } else if (page->type == Page::Type::Copy_On_Write_Page) {
@@ -630,7 +635,7 @@ void Memory::addCodeBlock(U32 startIp, DecodedBlock* block) {
     } else {
         if (page->type == Page::Type::RO_Page || page->type == Page::Type::RW_Page || page->type == Page::Type::Copy_On_Write_Page || page->type == Page::Type::Native_Page) {
             RWPage* p = (RWPage*)page;
-            codePage = CodePage::alloc(p->page, p->address, p->flags);
+            codePage = CodePage::alloc(this, p->page, p->address, p->flags);
             this->setPage(startIp >> K_PAGE_SHIFT, codePage);
         } else {
             kpanic("Unhandled code caching page type: %d", page->type);
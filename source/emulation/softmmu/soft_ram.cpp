@@ -1,25 +1,237 @@
 #include "boxedwine.h"
 
+#include "soft_ram.h"
+
+#ifdef BOXEDWINE_MSVC
+#include <malloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+// Guest pages are handed out from regions of K_RAM_REGION_PAGES pages.  A region is aligned to its size and its
+// first page holds the RamRegion, so the region, and with it the ref count, of a page is found by masking the page's
+// address.  The ref counts are atomic so that sharing a page doesn't need ramMutex, it is only held to hand out and
+// return pages and regions.
+#define K_RAM_REGION_SHIFT 20
+#define K_RAM_REGION_SIZE (1 << K_RAM_REGION_SHIFT)
+#define K_RAM_REGION_PAGES (K_RAM_REGION_SIZE >> K_PAGE_SHIFT)
+#define K_RAM_REGION_FREE_PAGES (K_RAM_REGION_PAGES - 1) // free pages in an empty region, page 0 is the RamRegion
+#define K_RAM_REGION_NOT_PARTIAL 0xFFFFFFFF
+
+class RamRegion {
+public:
+    RamRegion() : freeCount(K_RAM_REGION_FREE_PAGES), partialIndex(K_RAM_REGION_NOT_PARTIAL) {
+        for (U32 i = 0; i < K_RAM_REGION_PAGES; i++) {
+            this->refCounts[i] = 0;
+        }
+        for (U32 i = 0; i < K_RAM_REGION_FREE_PAGES; i++) {
+            // the lowest pages will be used first
+            this->freePages[i] = (U16)(K_RAM_REGION_PAGES - 1 - i);
+        }
+    }
+
+    U8* getPage(U32 index) {return (U8*)this + (index << K_PAGE_SHIFT);}
+
+    std::atomic<U32> refCounts[K_RAM_REGION_PAGES];
+    U16 freePages[K_RAM_REGION_FREE_PAGES]; // stack of page indexes
+    U32 freeCount;
+    U32 partialIndex; // index into partialRegions
+};
+
+static_assert(sizeof(RamRegion) <= K_PAGE_SIZE, "RamRegion must fit in the first page of its region");
+
+static std::vector<RamRegion*> partialRegions; // regions with at least 1 free page
+static U32 regionCount;
+static U32 emptyRegionCount;
+static U32 residentPageCount;
+static std::atomic<U32> sharedPageCount;
+static BOXEDWINE_MUTEX ramMutex;
+
+static U8* allocRegionMemory() {
+#ifdef BOXEDWINE_MSVC
+    return (U8*)_aligned_malloc(K_RAM_REGION_SIZE, K_RAM_REGION_SIZE);
+#else
+    void* result = NULL;
+    if (posix_memalign(&result, K_RAM_REGION_SIZE, K_RAM_REGION_SIZE)) {
+        return NULL;
+    }
+    return (U8*)result;
+#endif
+}
+
+static void freeRegionMemory(U8* ram) {
+#ifdef BOXEDWINE_MSVC
+    _aligned_free(ram);
+#else
+    free(ram);
+#endif
+}
+
+static void addPartialRegion(RamRegion* region) {
+    region->partialIndex = (U32)partialRegions.size();
+    partialRegions.push_back(region);
+}
+
+static void removePartialRegion(RamRegion* region) {
+    RamRegion* last = partialRegions.back();
+    partialRegions[region->partialIndex] = last;
+    last->partialIndex = region->partialIndex;
+    partialRegions.pop_back();
+    region->partialIndex = K_RAM_REGION_NOT_PARTIAL;
+}
+
+static RamRegion* getRegion(U8* ram) {
+    return (RamRegion*)((size_t)ram & ~(size_t)(K_RAM_REGION_SIZE - 1));
+}
+
+static U32 getRegionIndex(RamRegion* region, U8* ram) {
+    return (U32)((ram - (U8*)region) >> K_PAGE_SHIFT);
+}
+
+// ramMutex must be held, the page is cleared by the caller after the lock is released
+static U8* allocPage() {
+    RamRegion* region;
+
+    if (partialRegions.size()) {
+        region = partialRegions.back();
+    } else {
+        U8* ram = allocRegionMemory();
+        if (!ram) {
+            kpanic("ramPageAlloc: could not allocate %d bytes", K_RAM_REGION_SIZE);
+        }
+        region = new (ram) RamRegion();
+        regionCount++;
+        addPartialRegion(region);
+        emptyRegionCount++;
+    }
+    if (region->freeCount == K_RAM_REGION_FREE_PAGES) {
+        emptyRegionCount--;
+    }
+    U32 index = region->freePages[--region->freeCount];
+    if (!region->freeCount) {
+        removePartialRegion(region);
+    }
+    region->refCounts[index] = 1;
+    residentPageCount++;
+    return region->getPage(index);
+}
+
+// ramMutex must be held, the page's ref count already dropped to 0
+static void freePage(U8* ram) {
+    RamRegion* region = getRegion(ram);
+    U32 index = getRegionIndex(region, ram);
+
+    residentPageCount--;
+    if (!region->freeCount) {
+        addPartialRegion(region);
+    }
+    region->freePages[region->freeCount++] = (U16)index;
+    if (region->freeCount == K_RAM_REGION_FREE_PAGES) {
+        // keep 1 empty region around so that allocating and freeing a page at the boundary doesn't allocate a
+        // region each time
+        if (emptyRegionCount) {
+            removePartialRegion(region);
+            regionCount--;
+            region->~RamRegion();
+            freeRegionMemory((U8*)region);
+        } else {
+            emptyRegionCount++;
+        }
+    }
+}
+
+// returns true if that was the last reference, then the page has to be freed with ramMutex held
+static bool decRef(U8* ram) {
+    RamRegion* region = getRegion(ram);
+    U32 refCount = --region->refCounts[getRegionIndex(region, ram)];
+
+    if (refCount == 1) {
+        sharedPageCount--;
+    }
+    return refCount == 0;
+}
+
+// While a RamPageBatch is alive on a thread, pages that are released are collected and then returned to their
+// regions all at once.
+static THREAD_LOCAL RamPageBatch* currentBatch;
+
+RamPageBatch::RamPageBatch() : previous(currentBatch) {
+    currentBatch = this;
+}
+
+RamPageBatch::~RamPageBatch() {
+    currentBatch = this->previous;
+    if (this->pages.size()) {
+        ramPageDecRef(this->pages.data(), (U32)this->pages.size());
+    }
+}
+
 U8* ramPageAlloc() {
-    U8* ram = new U8[K_PAGE_SIZE+1];
-    memset(ram, 0, K_PAGE_SIZE);
-    ram[K_PAGE_SIZE] = 1;
-    return ram;
+    U8* result;
+    {
+        BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(ramMutex);
+        result = allocPage();
+    }
+    memset(result, 0, K_PAGE_SIZE);
+    return result;
 }
 
+void ramPageAlloc(U8** pages, U32 count) {
+    {
+        BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(ramMutex);
+        for (U32 i = 0; i < count; i++) {
+            pages[i] = allocPage();
+        }
+    }
+    for (U32 i = 0; i < count; i++) {
+        memset(pages[i], 0, K_PAGE_SIZE);
+    }
+}
+
+// the caller holds a reference, so the page can't be freed while this runs
 void ramPageIncRef(U8* ram) {
-    if (ram[K_PAGE_SIZE]==255) {
-        kpanic("max ram page ref count reached");
+    RamRegion* region = getRegion(ram);
+    if (++region->refCounts[getRegionIndex(region, ram)] == 2) {
+        sharedPageCount++;
     }
-    ram[K_PAGE_SIZE]++;
 }
 
 void ramPageDecRef(U8* ram) {
-    ram[K_PAGE_SIZE]--;
-    if (ram[K_PAGE_SIZE]==0)
-        delete[] ram;
+    if (currentBatch) {
+        currentBatch->pages.push_back(ram);
+        return;
+    }
+    if (decRef(ram)) {
+        BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(ramMutex);
+        freePage(ram);
+    }
+}
+
+void ramPageDecRef(U8** pages, U32 count) {
+    U32 freeCount = 0;
+
+    // the pages that are still used are moved out of the way, the rest are freed under 1 lock
+    for (U32 i = 0; i < count; i++) {
+        if (decRef(pages[i])) {
+            pages[freeCount++] = pages[i];
+        }
+    }
+    if (freeCount) {
+        BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(ramMutex);
+        for (U32 i = 0; i < freeCount; i++) {
+            freePage(pages[i]);
+        }
+    }
 }
 
 U32 ramPageRefCount(U8* ram) {
-    return ram[K_PAGE_SIZE];
-}
\ No newline at end of file
+    RamRegion* region = getRegion(ram);
+    return region->refCounts[getRegionIndex(region, ram)];
+}
+
+void ramPageStats(U32& residentPages, U32& sharedPages, U32& regions) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(ramMutex);
+    residentPages = residentPageCount;
+    sharedPages = sharedPageCount;
+    regions = regionCount;
+}
@@ -4,8 +4,23 @@
 #include "platform.h"
 
 U8* ramPageAlloc();
+void ramPageAlloc(U8** pages, U32 count);
 void ramPageIncRef(U8* ram);
 void ramPageDecRef(U8* ram);
+void ramPageDecRef(U8** pages, U32 count); // reorders pages
 U32 ramPageRefCount(U8* ram);
+void ramPageStats(U32& residentPages, U32& sharedPages, U32& regions);
+
+// Defers the ramPageDecRef calls made on this thread while it is alive and releases the pages all at once, use
+// it around code that frees a lot of pages like Memory::reset
+class RamPageBatch {
+public:
+    RamPageBatch();
+    ~RamPageBatch();
+
+    std::vector<U8*> pages;
+private:
+    RamPageBatch* previous;
+};
 
 #endif
\ No newline at end of file
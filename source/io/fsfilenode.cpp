@@ -136,6 +136,17 @@ U64 FsFileNode::length() {
     return 0;
 }
 
+std::string FsFileNode::getContentKey() {
+#ifdef BOXEDWINE_ZLIB
+    // a file that is only in a zip file can't change, so the zip and where the entry is in it identify its contents.
+    // The crc and length are not enough on their own, different files can have the same ones.
+    if (this->zipNode && !Fs::doesNativePathExist(this->nativePath)) {
+        return "zip:" + this->zipNode->fsZip->zipPath + ":" + std::to_string(this->zipNode->getZipOffset()) + ":" + std::to_string(this->zipNode->getCrc()) + ":" + std::to_string(this->zipNode->length());
+    }
+#endif
+    return "";
+}
+
 void FsFileNode::ensurePathIsLocal() {
 #ifdef BOXEDWINE_ZLIB
     BOXEDWINE_CRITICAL_SECTION;
@@ -25,6 +25,10 @@ public:
     virtual U32 getMode();
     virtual U32 removeDir();
     virtual U32 setTimes(U64 lastAccessTime, U32 lastAccessTimeNano, U64 lastModifiedTime, U32 lastModifiedTimeNano);
+    virtual std::string getContentKey();
+#ifdef BOXEDWINE_ZLIB
+    std::shared_ptr<FsZipNode> getZipNode() {return this->zipNode;}
+#endif
     static std::set<std::string> nonExecFileFullPaths;
 private:
     friend class FsFileOpenNode;
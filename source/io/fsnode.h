@@ -36,6 +36,8 @@ public:
 
     virtual std::string getLink() {return this->link;}
     virtual bool isLink() { return this->link.size() > 0; }
+    // the same for every node that has the same contents, empty if that isn't known
+    virtual std::string getContentKey() {return "";}
 
     U32 getHardLinkCount() {return this->hardLinkCount;}    
     bool isDirectory() {return this->isDir;}
@@ -10,6 +10,47 @@ extern "C"
 #include "fszip.h"
 #include "fszipnode.h"
 #include <time.h> 
+#include <fcntl.h>
+#include UNISTD
+
+std::list<FsZipBlockCache::Block> FsZipBlockCache::blocks;
+std::unordered_map<U64, std::list<FsZipBlockCache::Block>::iterator> FsZipBlockCache::blocksByKey;
+BOXEDWINE_MUTEX FsZipBlockCache::mutex;
+
+bool FsZipBlockCache::read(U64 key, U32 offset, U8* buffer, U32 len) {
+    std::shared_ptr<const std::vector<U8>> data;
+    {
+        BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(mutex);
+        auto it = blocksByKey.find(key);
+        if (it == blocksByKey.end() || offset + len > it->second->data->size()) {
+            return false;
+        }
+        blocks.splice(blocks.begin(), blocks, it->second);
+        data = it->second->data;
+    }
+    // data keeps the block alive if another thread evicts it while this copies
+    memcpy(buffer, data->data() + offset, len);
+    return true;
+}
+
+void FsZipBlockCache::add(U64 key, const std::vector<U8>& data) {
+    std::shared_ptr<const std::vector<U8>> copy = std::make_shared<const std::vector<U8>>(data);
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(mutex);
+    if (blocksByKey.count(key)) {
+        return;
+    }
+    blocks.emplace_front(key, copy);
+    blocksByKey[key] = blocks.begin();
+    while (blocks.size() > K_ZIP_CACHE_BLOCKS) {
+        blocksByKey.erase(blocks.back().key);
+        blocks.pop_back();
+    }
+}
+
+bool FsZipBlockCache::contains(U64 key) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(mutex);
+    return blocksByKey.count(key) != 0;
+}
 
 void FsZip::setupZipRead(U64 zipOffset, U64 zipFileOffset) {
 #ifdef BOXEDWINE_ZLIB
@@ -31,6 +72,35 @@ void FsZip::setupZipRead(U64 zipOffset, U64 zipFileOffset) {
 #endif
 }
 
+U64 FsZip::getDataOffset(U64 zipOffset) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->zipMutex);
+    U64 result = 0;
+
+    unzCloseCurrentFile(this->zipfile);
+    this->lastZipOffset = 0xFFFFFFFFFFFFFFFFl;
+    if (unzSetOffset64(this->zipfile, zipOffset) == UNZ_OK && unzOpenCurrentFile(this->zipfile) == UNZ_OK) {
+        result = unzGetCurrentFileZStreamPos64(this->zipfile);
+        unzCloseCurrentFile(this->zipfile);
+    }
+    return result;
+}
+
+U32 FsZip::readRaw(U64 zipPos, U8* buffer, U32 len) {
+    U32 result = 0;
+
+    if (this->zipHandle < 0) {
+        return 0;
+    }
+    while (result < len) {
+        S64 read = Platform::pread(this->zipHandle, buffer + result, len - result, zipPos + result);
+        if (read <= 0) {
+            break;
+        }
+        result += (U32)read;
+    }
+    return result;
+}
+
 bool FsZip::init(const std::string& zipPath, const std::string& mount) {
 #ifdef BOXEDWINE_ZLIB
     std::string strippedMount;
@@ -42,6 +112,7 @@ bool FsZip::init(const std::string& zipPath, const std::string& mount) {
         strippedMount = mount.substr(0, mount.length() - 1);
     }
     this->lastZipOffset = 0xFFFFFFFFFFFFFFFFl;
+    this->zipPath = zipPath;
     if (zipPath.length()) {
         unz_global_info global_info;
         U32 i;
@@ -51,6 +122,7 @@ bool FsZip::init(const std::string& zipPath, const std::string& mount) {
         if (!this->zipfile) {
             klog("Could not load zip file: %s", zipPath.c_str());
         }
+        this->zipHandle = ::open(zipPath.c_str(), O_RDONLY | O_BINARY);
 
         if (unzGetGlobalInfo( this->zipfile, &global_info ) != UNZ_OK) {
             klog("Could not read file global info from zip file: %s", zipPath.c_str());
@@ -88,6 +160,10 @@ bool FsZip::init(const std::string& zipPath, const std::string& mount) {
                 zipInfo[i].isDirectory = true;
             } else {
                 zipInfo[i].length = file_info.uncompressed_size;
+                zipInfo[i].compressedLength = file_info.compressed_size;
+                zipInfo[i].method = file_info.compression_method;
+                zipInfo[i].isEncrypted = (file_info.flag & 1) != 0;
+                zipInfo[i].crc = (U32)file_info.crc;
             }               
             tm.tm_sec = file_info.tmu_date.tm_sec;
             tm.tm_min = file_info.tmu_date.tm_min;
@@ -130,6 +206,9 @@ bool FsZip::init(const std::string& zipPath, const std::string& mount) {
 FsZip::~FsZip() {
 #ifdef BOXEDWINE_ZLIB
     unzClose(this->zipfile);
+    if (this->zipHandle >= 0) {
+        ::close(this->zipHandle);
+    }
 #endif
 }
 
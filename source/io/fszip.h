@@ -15,14 +15,42 @@ extern "C"
 
 class fsZipInfo {
 public:
-    fsZipInfo() : isLink(false), isDirectory(false), length(0), lastModified(0), offset(0) {}
+    fsZipInfo() : isLink(false), isDirectory(false), isEncrypted(false), length(0), compressedLength(0), lastModified(0), offset(0), method(0), crc(0) {}
     std::string filename;
     std::string link;
     bool isLink;
     bool isDirectory;
+    bool isEncrypted;
     U64 length;
+    U64 compressedLength;
     U64 lastModified;
     U64 offset;
+    U32 method;
+    U32 crc;
+};
+
+#define K_ZIP_BLOCK_SIZE (64 * 1024)
+#define K_ZIP_CACHE_BLOCKS 256
+
+// Decompressed K_ZIP_BLOCK_SIZE blocks of zip entries, shared by every open zip file.  When it is full the least
+// recently used block is dropped.
+class FsZipBlockCache {
+public:
+    static bool read(U64 key, U32 offset, U8* buffer, U32 len);
+    static void add(U64 key, const std::vector<U8>& data);
+    static bool contains(U64 key); // doesn't count as a use
+    static U64 getKey(U32 entryId, U64 block) {return ((U64)entryId << 32) | block;}
+
+private:
+    class Block {
+    public:
+        Block(U64 key, const std::shared_ptr<const std::vector<U8>>& data) : key(key), data(data) {}
+        U64 key;
+        std::shared_ptr<const std::vector<U8>> data; // shared so a reader can copy from it after unlocking
+    };
+    static std::list<Block> blocks; // most recently used first
+    static std::unordered_map<U64, std::list<Block>::iterator> blocksByKey;
+    static BOXEDWINE_MUTEX mutex;
 };
 
 class FsZip : public std::enable_shared_from_this<FsZip> {
@@ -30,11 +58,19 @@ public:
     ~FsZip();
     bool init(const std::string& zipPath, const std::string& mount);
     unzFile zipfile;
+    std::string zipPath;
 
     U64 lastZipOffset = 0xFFFFFFFFFFFFFFFFl;
     U64 lastZipFileOffset;
 
     void setupZipRead(U64 zipOffset, U64 zipFileOffset);
+    BOXEDWINE_MUTEX zipMutex; // for zipfile, which only has one current file
+
+    // returns the offset in the zip file where the data of the entry at zipOffset starts, 0 if it can't be found
+    U64 getDataOffset(U64 zipOffset);
+    // reads the zip file directly with Platform::pread, it doesn't use zipfile or a file pointer so it needs no lock
+    U32 readRaw(U64 zipPos, U8* buffer, U32 len);
+
     void remove(const std::string& localPath);
 
     static bool readFileFromZip(const std::string& zipFile, const std::string& file, std::string& result);
@@ -44,6 +80,7 @@ public:
 
 private:
     std::string deleteFilePath;
+    int zipHandle = -1;
 };
 #endif
 #endif
@@ -6,10 +6,62 @@
 #include <fcntl.h>
 #include "fszipopennode.h"
 
-FsZipNode::FsZipNode(const fsZipInfo& zipInfo, std::shared_ptr<FsZip>& fsZip) : fsZip(fsZip) {
+static std::atomic<U32> nextZipNodeId;
+
+FsZipNode::FsZipNode(const fsZipInfo& zipInfo, std::shared_ptr<FsZip>& fsZip) : fsZip(fsZip), id(++nextZipNodeId), located(false), randomAccess(false), dataOffset(0) {
     this->zipInfo = zipInfo;
 }
 
+bool FsZipNode::locate() {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->mutex);
+    if (this->located) {
+        return this->randomAccess;
+    }
+    this->located = true;
+    if (this->zipInfo.isEncrypted || (this->zipInfo.method != 0 && this->zipInfo.method != Z_DEFLATED)) {
+        return false;
+    }
+    this->dataOffset = this->fsZip->getDataOffset(this->zipInfo.offset);
+    if (!this->dataOffset) {
+        return false;
+    }
+    std::shared_ptr<FsZipCheckpoint> start = std::make_shared<FsZipCheckpoint>();
+    start->zipPos = this->dataOffset;
+    this->checkpoints.resize((size_t)(this->zipInfo.length / K_ZIP_CHECKPOINT_SPAN + 1));
+    this->checkpoints[0] = start;
+    this->randomAccess = true;
+    return true;
+}
+
+std::shared_ptr<FsZipCheckpoint> FsZipNode::findCheckpoint(U64 pos) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->mutex);
+    size_t slot = (size_t)(pos / K_ZIP_CHECKPOINT_SPAN);
+    if (slot >= this->checkpoints.size()) {
+        slot = this->checkpoints.size() - 1;
+    }
+    while (true) {
+        std::shared_ptr<FsZipCheckpoint>& checkpoint = this->checkpoints[slot];
+        if (checkpoint && checkpoint->pos <= pos) {
+            return checkpoint;
+        }
+        slot--;
+    }
+}
+
+bool FsZipNode::needsCheckpoint(U64 pos) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->mutex);
+    size_t slot = (size_t)(pos / K_ZIP_CHECKPOINT_SPAN);
+    return slot < this->checkpoints.size() && !this->checkpoints[slot];
+}
+
+void FsZipNode::addCheckpoint(const std::shared_ptr<FsZipCheckpoint>& checkpoint) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->mutex);
+    size_t slot = (size_t)(checkpoint->pos / K_ZIP_CHECKPOINT_SPAN);
+    if (slot < this->checkpoints.size() && !this->checkpoints[slot]) {
+        this->checkpoints[slot] = checkpoint;
+    }
+}
+
 bool FsZipNode::moveToFileSystem(BoxedPtr<FsNode> node) {
     if (node->isDirectory())
         return false;
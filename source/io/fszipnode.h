@@ -8,6 +8,20 @@
 
 class FsFileNode;
 
+#define K_ZIP_CHECKPOINT_SPAN (512 * 1024)
+
+// The state needed to start inflating an entry in the middle, pos is the offset in the uncompressed data and
+// zipPos is the offset in the zip file of the first byte that still has bits left to decode.
+class FsZipCheckpoint {
+public:
+    FsZipCheckpoint() : pos(0), zipPos(0), bits(0), bitsValue(0) {}
+    U64 pos;
+    U64 zipPos;
+    U8 bits; // how many bits of the byte before zipPos still need to be decoded
+    U8 bitsValue;
+    std::vector<U8> window; // the last 32K of uncompressed data before pos
+};
+
 class FsZipNode : public std::enable_shared_from_this<FsZipNode> {
 public:
     FsZipNode(const fsZipInfo& zipInfo, std::shared_ptr<FsZip>& fsZip);
@@ -16,9 +30,29 @@ public:
     FsOpenNode* open(BoxedPtr<FsNode> node, U32 flags);
     bool moveToFileSystem(BoxedPtr<FsNode> node);
 
+    // finds where the entry's data starts, returns false if the entry can't be read with random access and must
+    // be read through fsZip->zipfile instead
+    bool locate();
+    U64 getDataOffset() {return this->dataOffset;}
+    U32 getMethod() {return this->zipInfo.method;}
+    U64 getCompressedLength() {return this->zipInfo.compressedLength;}
+    U32 getCrc() {return this->zipInfo.crc;}
+    U64 getZipOffset() {return this->zipInfo.offset;}
+
+    // returns the closest checkpoint at or before pos, there is always one at 0 after locate
+    std::shared_ptr<FsZipCheckpoint> findCheckpoint(U64 pos);
+    bool needsCheckpoint(U64 pos);
+    void addCheckpoint(const std::shared_ptr<FsZipCheckpoint>& checkpoint);
+
     std::shared_ptr<FsZip> fsZip;
+    const U32 id; // used to key this entry's blocks in FsZipBlockCache
 private:
     fsZipInfo zipInfo;
+    bool located;
+    bool randomAccess;
+    U64 dataOffset;
+    std::vector<std::shared_ptr<FsZipCheckpoint>> checkpoints; // at most one per K_ZIP_CHECKPOINT_SPAN
+    BOXEDWINE_MUTEX mutex;
 };
 #endif
 #endif
@@ -7,7 +7,21 @@
 #include "fszip.h"
 
 
-FsZipOpenNode::FsZipOpenNode(BoxedPtr<FsNode> node, std::shared_ptr<FsZipNode>& zipNode, U32 flags, U64 offset) : FsOpenNode(node, flags), zipNode(zipNode), pos(0), offset(offset) {
+#define K_ZIP_INPUT_SIZE (16 * 1024)
+#define K_ZIP_NO_BLOCK 0xFFFFFFFFFFFFFFFFl
+
+FsZipOpenNode::FsZipOpenNode(BoxedPtr<FsNode> node, std::shared_ptr<FsZipNode>& zipNode, U32 flags, U64 offset) : FsOpenNode(node, flags), zipNode(zipNode), pos(0), offset(offset), streamInitialized(false), streamPos(0), streamZipPos(0), blockIndex(K_ZIP_NO_BLOCK) {
+}
+
+FsZipOpenNode::~FsZipOpenNode() {
+    endStream();
+}
+
+void FsZipOpenNode::endStream() {
+    if (this->streamInitialized) {
+        inflateEnd(&this->stream);
+        this->streamInitialized = false;
+    }
 }
 
 S64 FsZipOpenNode::length() {
@@ -33,6 +47,13 @@ S64 FsZipOpenNode::seek(S64 pos) {
 }
 
 void FsZipOpenNode::close() {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->readMutex);
+    endStream();
+    this->input.clear();
+    this->input.shrink_to_fit();
+    this->block.clear();
+    this->block.shrink_to_fit();
+    this->blockIndex = K_ZIP_NO_BLOCK;
 }
 
 bool FsZipOpenNode::isOpen() {
@@ -72,9 +93,9 @@ bool FsZipOpenNode::canMap() {
     return true;
 }
 
-U32 FsZipOpenNode::readNative(U8* buffer, U32 len) {
+U32 FsZipOpenNode::readSequential(U8* buffer, U32 len) {
     U32 result;
-    BOXEDWINE_CRITICAL_SECTION;
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->zipNode->fsZip->zipMutex);
 
     this->zipNode->fsZip->setupZipRead(this->offset, this->pos);    
     result = unzReadCurrentFile(this->zipNode->fsZip->zipfile, buffer, len);
@@ -83,6 +104,169 @@ U32 FsZipOpenNode::readNative(U8* buffer, U32 len) {
     return result;
 }
 
+U32 FsZipOpenNode::readNative(U8* buffer, U32 len) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(this->readMutex);
+    U64 length = this->zipNode->length();
+
+    if ((U64)this->pos >= length) {
+        return 0;
+    }
+    if (!this->zipNode->locate()) {
+        return readSequential(buffer, len);
+    }
+    if (len > length - this->pos) {
+        len = (U32)(length - this->pos);
+    }
+    if (this->zipNode->getMethod() == 0) {
+        U32 result = this->zipNode->fsZip->readRaw(this->zipNode->getDataOffset() + this->pos, buffer, len);
+        this->pos += result;
+        return result;
+    }
+    U32 result = 0;
+    while (len) {
+        U64 index = this->pos / K_ZIP_BLOCK_SIZE;
+        U32 offset = (U32)(this->pos % K_ZIP_BLOCK_SIZE);
+        U32 todo = K_ZIP_BLOCK_SIZE - offset;
+        if (todo > len) {
+            todo = len;
+        }
+        if (index == this->blockIndex) {
+            memcpy(buffer, this->block.data() + offset, todo);
+        } else if (!FsZipBlockCache::read(FsZipBlockCache::getKey(this->zipNode->id, index), offset, buffer, todo)) {
+            if (!decodeBlock(index)) {
+                klog("could not read %s from zip file", this->node->path.c_str());
+                break;
+            }
+            memcpy(buffer, this->block.data() + offset, todo);
+        }
+        buffer += todo;
+        len -= todo;
+        result += todo;
+        this->pos += todo;
+    }
+    return result;
+}
+
+// decodes the block into this->block and adds it, along with any whole block that was decoded on the way, to
+// the cache
+bool FsZipOpenNode::decodeBlock(U64 index) {
+    U64 start = index * K_ZIP_BLOCK_SIZE;
+    U64 length = this->zipNode->length();
+    U32 size = (U32)(length - start > K_ZIP_BLOCK_SIZE ? K_ZIP_BLOCK_SIZE : length - start);
+
+    this->blockIndex = K_ZIP_NO_BLOCK;
+    if (!this->streamInitialized || this->streamPos > start) {
+        if (!restart(this->zipNode->findCheckpoint(start))) {
+            return false;
+        }
+    } else {
+        // a checkpoint closer than where the decoder is now will save decoding everything in between
+        std::shared_ptr<FsZipCheckpoint> checkpoint = this->zipNode->findCheckpoint(start);
+        if (checkpoint->pos > this->streamPos && !restart(checkpoint)) {
+            return false;
+        }
+    }
+    this->block.resize(K_ZIP_BLOCK_SIZE);
+    while (this->streamPos < start) {
+        U64 skipStart = this->streamPos;
+        U32 todo = K_ZIP_BLOCK_SIZE - (U32)(skipStart % K_ZIP_BLOCK_SIZE);
+        if (!inflateTo(this->block.data(), todo)) {
+            return false;
+        }
+        if (todo == K_ZIP_BLOCK_SIZE) {
+            FsZipBlockCache::add(FsZipBlockCache::getKey(this->zipNode->id, skipStart / K_ZIP_BLOCK_SIZE), this->block);
+        }
+    }
+    this->block.resize(size);
+    if (!inflateTo(this->block.data(), size)) {
+        return false;
+    }
+    FsZipBlockCache::add(FsZipBlockCache::getKey(this->zipNode->id, index), this->block);
+    this->blockIndex = index;
+    return true;
+}
+
+bool FsZipOpenNode::restart(const std::shared_ptr<FsZipCheckpoint>& checkpoint) {
+    if (this->streamInitialized) {
+        if (inflateReset(&this->stream) != Z_OK) {
+            endStream();
+            return false;
+        }
+    } else {
+        memset(&this->stream, 0, sizeof(this->stream));
+        if (inflateInit2(&this->stream, -MAX_WBITS) != Z_OK) {
+            return false;
+        }
+        this->streamInitialized = true;
+    }
+    this->stream.avail_in = 0;
+    this->streamPos = checkpoint->pos;
+    this->streamZipPos = checkpoint->zipPos;
+    if (checkpoint->bits) {
+        inflatePrime(&this->stream, checkpoint->bits, checkpoint->bitsValue);
+    }
+    if (checkpoint->window.size()) {
+        inflateSetDictionary(&this->stream, checkpoint->window.data(), (uInt)checkpoint->window.size());
+    }
+    return true;
+}
+
+bool FsZipOpenNode::inflateTo(U8* buffer, U32 len) {
+    U64 zipEnd = this->zipNode->getDataOffset() + this->zipNode->getCompressedLength();
+
+    if (this->input.size() != K_ZIP_INPUT_SIZE) {
+        this->input.resize(K_ZIP_INPUT_SIZE);
+    }
+    this->stream.next_out = buffer;
+    this->stream.avail_out = len;
+    while (this->stream.avail_out) {
+        if (!this->stream.avail_in) {
+            U32 todo = (U32)(zipEnd - this->streamZipPos > K_ZIP_INPUT_SIZE ? K_ZIP_INPUT_SIZE : zipEnd - this->streamZipPos);
+            U32 read = todo ? this->zipNode->fsZip->readRaw(this->streamZipPos, this->input.data(), todo) : 0;
+            if (!read) {
+                endStream();
+                return false;
+            }
+            this->streamZipPos += read;
+            this->stream.next_in = this->input.data();
+            this->stream.avail_in = read;
+        }
+        U32 before = this->stream.avail_out;
+        int ret = inflate(&this->stream, Z_BLOCK);
+        this->streamPos += before - this->stream.avail_out;
+        if (ret == Z_STREAM_END) {
+            break;
+        }
+        if (ret != Z_OK) {
+            endStream();
+            return false;
+        }
+        // bit 7 means the decoder stopped at the end of a deflate block and bit 6 means it was the last one
+        if ((this->stream.data_type & 128) && !(this->stream.data_type & 64) && this->zipNode->needsCheckpoint(this->streamPos)) {
+            std::shared_ptr<FsZipCheckpoint> checkpoint = std::make_shared<FsZipCheckpoint>();
+            checkpoint->pos = this->streamPos;
+            checkpoint->zipPos = this->streamZipPos - this->stream.avail_in;
+            checkpoint->bits = (U8)(this->stream.data_type & 7);
+            if (checkpoint->bits) {
+                U8 last = 0;
+                this->zipNode->fsZip->readRaw(checkpoint->zipPos - 1, &last, 1);
+                checkpoint->bitsValue = last >> (8 - checkpoint->bits);
+            }
+            uInt windowLen = 0;
+            checkpoint->window.resize(32 * 1024);
+            if (inflateGetDictionary(&this->stream, checkpoint->window.data(), &windowLen) == Z_OK) {
+                checkpoint->window.resize(windowLen);
+                this->zipNode->addCheckpoint(checkpoint);
+            }
+        }
+    }
+    if (this->stream.avail_out) {
+        endStream();
+        return false;
+    }
+    return true;
+}
+
 U32 FsZipOpenNode::writeNative(U8* buffer, U32 len) {
     kpanic("FsZipOpenNode::writeNative not implemented");
     return 0;
@@ -2,12 +2,15 @@
 #define __FSZIPOPENNODE_H__
 
 #include "fsopennode.h"
+#include "fszip.h"
 
 class FsZipNode;
+class FsZipCheckpoint;
 
 class FsZipOpenNode : public FsOpenNode {
 public:
     FsZipOpenNode(BoxedPtr<FsNode> node, std::shared_ptr<FsZipNode>& zipNode, U32 flags, U64 offset);
+    virtual ~FsZipOpenNode();
     virtual S64  length();
     virtual bool setLength(S64 length);
     virtual S64  getFilePointer();
@@ -27,9 +30,25 @@ public:
     virtual bool isOpen();
 
 private:
+    U32 readSequential(U8* buffer, U32 len);
+    bool decodeBlock(U64 block);
+    bool restart(const std::shared_ptr<FsZipCheckpoint>& checkpoint);
+    bool inflateTo(U8* buffer, U32 len);
+    void endStream();
+
     std::shared_ptr<FsZipNode> zipNode;
     S64 pos;
     U64 offset;
+
+    // each open file has its own decoder so that reading one file doesn't disturb another one
+    BOXEDWINE_MUTEX readMutex;
+    z_stream stream;
+    bool streamInitialized;
+    U64 streamPos; // uncompressed offset that the decoder will produce next
+    U64 streamZipPos; // offset in the zip file of the next compressed byte to read into input
+    std::vector<U8> input;
+    std::vector<U8> block;
+    U64 blockIndex; // which block is in block
 };
 
 #endif
\ No newline at end of file
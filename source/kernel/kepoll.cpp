@@ -22,12 +22,13 @@
 
 #include <string.h>
 
-KEPoll::KEPoll() : KObject(KTYPE_EPOLL) {
+KEPoll::KEPoll() : KObject(KTYPE_EPOLL), readyCond("KEPoll::readyCond") {
 }
 
 KEPoll::~KEPoll() {
-     for( const auto& n : this->data ) {
-         delete n.second;
+    // the kobjects can outlive this, so they must stop signaling our conditions
+    for (const auto& n : this->data) {
+        disarm(n.second);
     }
 }
 
@@ -129,39 +130,103 @@ void KEPoll::close() {
 #define K_EPOLL_CTL_DEL 2
 #define K_EPOLL_CTL_MOD 3
 
+#define K_EPOLLONESHOT 0x40000000
+#define K_EPOLLET 0x80000000
+
+void KEPoll::arm(const std::shared_ptr<Data>& d, const std::shared_ptr<KObject>& kobject) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(d->cond);
+    // in the single threaded build the children are removed each time they signal, so this is done every
+    // time the fd is checked
+    d->cond.removeChildren();
+    kobject->waitForEvents(d->cond, d->events & ~(K_EPOLLONESHOT | K_EPOLLET));
+    d->cond.unlockChildren();
+}
+
+void KEPoll::disarm(const std::shared_ptr<Data>& d) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(d->cond);
+    d->cond.removeChildren();
+}
+
+void KEPoll::queue(const std::shared_ptr<Data>& d) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(readyCond);
+    if (!d->queued && !d->disabled && !d->removed) {
+        d->queued = true;
+        this->readyList.push_back(d);
+        BOXEDWINE_CONDITION_SIGNAL_ALL(readyCond);
+    }
+}
+
+void KEPoll::remove(const std::shared_ptr<Data>& d) {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(dataMutex);
+    {
+        BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(readyCond);
+        d->removed = true;
+    }
+    auto it = this->data.find(d->fd);
+    if (it != this->data.end() && it->second == d) {
+        this->data.erase(it);
+    }
+    disarm(d);
+}
+
 U32 KEPoll::ctl(U32 op, FD fd, U32 address) {
     KFileDescriptor* targetFD = KThread::currentThread()->process->getFileDescriptor(fd);
-    Data* existing = NULL;
+    std::shared_ptr<Data> existing;
 
     if (!targetFD) {
         return -K_EBADF;
     }
-
-    if (this->data.count(fd))
-        existing = this->data[fd];
+    if (targetFD->kobject.get() == this) {
+        return -K_EINVAL;
+    }
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(dataMutex);
+    auto it = this->data.find(fd);
+    if (it != this->data.end()) {
+        existing = it->second;
+        if (existing->kobject.lock() != targetFD->kobject) {
+            // the fd was closed and reused since it was added
+            remove(existing);
+            existing = nullptr;
+        }
+    }
 
     switch (op) {
-        case K_EPOLL_CTL_ADD:
+        case K_EPOLL_CTL_ADD: {
             if (existing) {
                 return -K_EEXIST;
             }
-            existing = new Data();
-            existing->fd = fd;
+            existing = std::make_shared<Data>(fd, targetFD->kobject);
             existing->events = readd(address);
             existing->data = readq(address + 4);
+            std::weak_ptr<Data> weak = existing;
+            existing->cond.signaledCallback = [this, weak]() {
+                std::shared_ptr<Data> d = weak.lock();
+                if (d) {
+                    this->queue(d);
+                }
+            };
             this->data[fd] = existing;
+            arm(existing, targetFD->kobject);
+            // it might already be ready
+            queue(existing);
             break;
+        }
         case K_EPOLL_CTL_DEL:
             if (!existing)
                 return -K_ENOENT;
-            this->data.erase(fd);
-            delete existing;
+            remove(existing);
             break;
         case K_EPOLL_CTL_MOD:
             if (!existing)
                 return -K_ENOENT;
-            existing->events = readd(address);
-            existing->data = readq(address + 4);
+            {
+                BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(readyCond);
+                existing->events = readd(address);
+                existing->data = readq(address + 4);
+                existing->disabled = false;
+            }
+            arm(existing, targetFD->kobject);
+            queue(existing);
             break;
         default:
             return -K_EINVAL;
@@ -170,36 +235,109 @@ U32 KEPoll::ctl(U32 op, FD fd, U32 address) {
 }
 
 U32 KEPoll::wait(U32 events, U32 maxevents, U32 timeout) {    
-    S32 result = 0;
-    U32 i;
-    THREAD_LOCAL static KPollData pollData[256];	
-    U32 pollCount=0;
-
-    for( const auto& n : this->data ) {
-        if (pollCount>=256) {
-            kpanic("Wasn't expect a poll count of more than 256");
-            break;
-        }
-        Data* next = n.second;
-        pollData[pollCount].events = next->events;
-        pollData[pollCount].fd = next->fd;
-        pollData[pollCount].data = next->data;
-        pollCount++;	
+    KThread* thread = KThread::currentThread();
+
+    if ((S32)maxevents <= 0) {
+        return -K_EINVAL;
     }
-    result = internal_poll(pollData, pollCount, timeout);
-    if (result >= 0) {
-        result = 0;
-        for (i=0;i<pollCount;i++) {
-            if (pollData[i].revents!=0) {
-                writed(events + result * 12, pollData[i].revents);        
-                writeq(events + result * 12 + 4, pollData[i].data);
-                result++;
-                if (result>=(S32)maxevents) {
-                    kwarn("possible starvation in epoll, more events are ready than can be received.");
-                    break;
+    while (true) {
+        std::vector<std::shared_ptr<Data>> ready;
+        U32 result = 0;
+        U32 i;
+
+        {
+            BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(readyCond);
+            ready.reserve(this->readyList.size());
+            for (auto& d : this->readyList) {
+                d->queued = false;
+                ready.push_back(d);
+            }
+            this->readyList.clear();
+        }
+        for (i = 0; i < ready.size() && result < maxevents; i++) {
+            std::shared_ptr<Data>& d = ready[i];
+            std::shared_ptr<KObject> kobject = d->kobject.lock();
+
+            if (!kobject) {
+                // the file was closed
+                remove(d);
+                continue;
+            }
+            if (d->disabled || d->removed) {
+                continue;
+            }
+            // arm before checking so that a change after the check will queue it again
+            arm(d, kobject);
+            U32 revents = getPollEvents(kobject.get(), d->events);
+            if (!revents) {
+                continue;
+            }
+            writed(events + result * 12, revents);
+            writeq(events + result * 12 + 4, d->data);
+            result++;
+            if (d->events & K_EPOLLONESHOT) {
+                {
+                    BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(readyCond);
+                    d->disabled = true;
                 }
-            }        
+                disarm(d);
+            } else if (!(d->events & K_EPOLLET)) {
+                // level triggered, it will be checked again on the next wait and dropped from the list if it
+                // is no longer ready
+                queue(d);
+            }
+        }
+        if (i < ready.size()) {
+            // these didn't fit, they go ahead of the ones that were just reported so that nothing starves
+            BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(readyCond);
+            for (U32 j = (U32)ready.size(); j > i; j--) {
+                std::shared_ptr<Data>& d = ready[j - 1];
+                if (!d->queued && !d->disabled && !d->removed) {
+                    d->queued = true;
+                    this->readyList.push_front(d);
+                }
+            }
+        }
+        if (result) {
+            thread->condStartWaitTime = 0;
+            return result;
+        }
+        if (timeout == 0) {
+            return 0;
+        }
+
+        BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(readyCond);
+        if (this->readyList.size()) {
+            continue;
+        }
+        if (!thread->inSignal && thread->interrupted) {
+            thread->interrupted = false;
+            thread->condStartWaitTime = 0;
+            return -K_EINTR;
+        }
+        if (!thread->condStartWaitTime) {
+            thread->condStartWaitTime = KSystem::getMilliesSinceStart();
+        } else {
+            U32 diff = KSystem::getMilliesSinceStart() - thread->condStartWaitTime;
+            if (diff > timeout) {
+                thread->condStartWaitTime = 0;
+                return 0;
+            }
+            timeout -= diff;
+        }
+        if (timeout > 0xF0000000) {
+            BOXEDWINE_CONDITION_WAIT(readyCond);
+        } else {
+            BOXEDWINE_CONDITION_WAIT_TIMEOUT(readyCond, timeout);
+        }
+#ifdef BOXEDWINE_MULTI_THREADED
+        if (thread->terminating) {
+            return -K_EINTR;
+        }
+        if (thread->startSignal) {
+            thread->startSignal = false;
+            return -K_CONTINUE;
         }
+#endif
     }
-    return result;
 }
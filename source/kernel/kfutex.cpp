@@ -0,0 +1,325 @@
+/*
+ *  Copyright (C) 2016  The BoxedWine Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "boxedwine.h"
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+#include "../emulation/cpu/binaryTranslation/btCodeMemoryWrite.h"
+#endif
+
+#define FUTEX_WAIT 0
+#define FUTEX_WAKE 1
+#define FUTEX_REQUEUE 3
+#define FUTEX_CMP_REQUEUE 4
+#define FUTEX_WAKE_OP 5
+#define FUTEX_WAIT_BITSET 9
+#define FUTEX_WAKE_BITSET 10
+#define FUTEX_PRIVATE_FLAG 128
+#define FUTEX_CLOCK_REALTIME 256
+
+#define FUTEX_BITSET_MATCH_ANY 0xFFFFFFFF
+
+#define FUTEX_OP_SET 0
+#define FUTEX_OP_ADD 1
+#define FUTEX_OP_OR 2
+#define FUTEX_OP_ANDN 3
+#define FUTEX_OP_XOR 4
+#define FUTEX_OP_OPARG_SHIFT 8
+
+#define FUTEX_OP_CMP_EQ 0
+#define FUTEX_OP_CMP_NE 1
+#define FUTEX_OP_CMP_LT 2
+#define FUTEX_OP_CMP_LE 3
+#define FUTEX_OP_CMP_GT 4
+#define FUTEX_OP_CMP_GE 5
+
+KFutexBucket KFutex::buckets[K_FUTEX_BUCKETS];
+
+KFutexBucket& KFutex::getBucket(U8* ramAddress) {
+    U64 hash = ((U64)(size_t)ramAddress >> 2) * 0x9E3779B97F4A7C15l;
+    return buckets[hash >> 56];
+}
+
+// always lock in the same order so that two requeues going in opposite directions don't deadlock
+void KFutex::lockBuckets(KFutexBucket& bucket1, KFutexBucket& bucket2) {
+    if (&bucket1 == &bucket2) {
+        BOXEDWINE_MUTEX_LOCK(bucket1.mutex);
+    } else if (&bucket1 < &bucket2) {
+        BOXEDWINE_MUTEX_LOCK(bucket1.mutex);
+        BOXEDWINE_MUTEX_LOCK(bucket2.mutex);
+    } else {
+        BOXEDWINE_MUTEX_LOCK(bucket2.mutex);
+        BOXEDWINE_MUTEX_LOCK(bucket1.mutex);
+    }
+}
+
+void KFutex::unlockBuckets(KFutexBucket& bucket1, KFutexBucket& bucket2) {
+    BOXEDWINE_MUTEX_UNLOCK(bucket1.mutex);
+    if (&bucket1 != &bucket2) {
+        BOXEDWINE_MUTEX_UNLOCK(bucket2.mutex);
+    }
+}
+
+void KFutex::removeWaiter(KThread* thread) {
+    KFutexWaiter* waiter = &thread->futexWaiter;
+
+    if (!waiter->thread) {
+        return;
+    }
+    while (true) {
+        U8* address = waiter->address;
+        KFutexBucket& bucket = getBucket(address);
+        BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(bucket.mutex);
+        if (waiter->address != address) {
+            continue; // requeued before the lock was taken
+        }
+        if (waiter->queued) {
+            bucket.waiters.remove(waiter);
+            waiter->queued = false;
+        }
+        waiter->thread = NULL;
+        return;
+    }
+}
+
+U32 KFutex::futex(KThread* thread, U32 addr, U32 op, U32 value, U32 pTime, U32 addr2, U32 val3) {
+    U8* ramAddress = getPhysicalReadAddress(addr, 4);
+
+    if (ramAddress==0) {
+        kpanic("Could not find futex address: %0.8X", addr);
+    }
+    op = op & ~(FUTEX_CLOCK_REALTIME | FUTEX_PRIVATE_FLAG);
+    switch (op) {
+    case FUTEX_WAIT:
+        return wait(thread, addr, ramAddress, value, pTime, FUTEX_BITSET_MATCH_ANY);
+    case FUTEX_WAIT_BITSET:
+        return wait(thread, addr, ramAddress, value, pTime, val3);
+    case FUTEX_WAKE: 
+    case FUTEX_WAKE_BITSET: {
+        KFutexBucket& bucket = getBucket(ramAddress);
+        BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(bucket.mutex);
+        return wakeLocked(bucket, ramAddress, value, op == FUTEX_WAKE_BITSET ? val3 : FUTEX_BITSET_MATCH_ANY);
+    }
+    // for these pTime is val2, the number of waiters to requeue or wake on addr2
+    case FUTEX_REQUEUE:
+        return requeue(thread, addr, ramAddress, addr2, value, pTime, false, 0);
+    case FUTEX_CMP_REQUEUE:
+        return requeue(thread, addr, ramAddress, addr2, value, pTime, true, val3);
+    case FUTEX_WAKE_OP:
+        return wakeOp(thread, addr, ramAddress, addr2, value, pTime, val3);
+    default:
+        kwarn("syscall __NR_futex op %d not implemented", op);
+        return -K_ENOSYS;
+    }
+}
+
+U32 KFutex::wait(KThread* thread, U32 addr, U8* ramAddress, U32 value, U32 pTime, U32 mask) {
+    KFutexWaiter* waiter = &thread->futexWaiter;
+
+    if (!mask) {
+        return -K_EINVAL;
+    }
+    // without BOXEDWINE_MULTI_THREADED, BOXEDWINE_CONDITION_WAIT returns and the syscall is called again when the
+    // condition is signaled, so the waiter will still be in use
+    if (!waiter->thread) {
+        U32 expireTime;
+
+        if (pTime == 0) {
+            expireTime = 0xFFFFFFFF;
+        } else {
+            U32 seconds = readd(pTime);
+            U32 nano = readd(pTime + 4);
+            expireTime = seconds * 1000 + nano / 1000000 + KSystem::getMilliesSinceStart();
+        }
+        KFutexBucket& bucket = getBucket(ramAddress);
+        BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(bucket.mutex);
+        // a wake can't come between this check and the waiter being queued, it would need the bucket lock
+        if (readd(addr) != value) {
+            return -K_EWOULDBLOCK;
+        }
+        waiter->thread = thread;
+        waiter->address = ramAddress;
+        waiter->expireTimeInMillies = expireTime;
+        waiter->mask = mask;
+        waiter->wake = false;
+        waiter->queued = true;
+        bucket.waiters.push_back(waiter);
+    }
+    U32 result;
+    // removeWaiter needs the bucket lock, so it can't be called while holding waiter->cond
+    while (true) {
+        BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(waiter->cond);
+        if (thread->pendingSignals) {
+            // I know this is a nested if statement, but it makes setting a break point easier
+            if (thread->runSignals()) {
+                result = -K_CONTINUE;
+                break;
+            }
+        }
+        if (waiter->wake) {
+            result = 0;
+            break;
+        }
+        if (waiter->expireTimeInMillies<0x7FFFFFFF) {
+            S32 diff = waiter->expireTimeInMillies - KSystem::getMilliesSinceStart();
+            if (diff<=0) {
+                result = -K_ETIMEDOUT;
+                break;
+            }
+            BOXEDWINE_CONDITION_WAIT_TIMEOUT(waiter->cond, (U32)diff);
+        } else {
+            BOXEDWINE_CONDITION_WAIT(waiter->cond);
+        }
+#ifdef BOXEDWINE_MULTI_THREADED
+        if (thread->terminating) {
+            result = -K_EINTR;
+            break;
+        }
+        if (thread->startSignal) {
+            thread->startSignal = false;
+            result = -K_CONTINUE;
+            break;
+        }
+#endif
+    }
+    removeWaiter(thread);
+    // a wake that happened while leaving still counted this waiter, so it can't be lost.  When the syscall is
+    // restarted after a signal the value will be checked again.
+    if (waiter->wake) {
+        result = 0;
+    }
+    return result;
+}
+
+// The waiters are woken in the order they started waiting.  A woken waiter is removed from the bucket right away so
+// that it isn't counted by the next wake.
+U32 KFutex::wakeLocked(KFutexBucket& bucket, U8* ramAddress, U32 count, U32 mask) {
+    U32 result = 0;
+
+    for (auto it = bucket.waiters.begin(); it != bucket.waiters.end() && result < count;) {
+        KFutexWaiter* waiter = *it;
+        if (waiter->address == ramAddress && (waiter->mask & mask)) {
+            it = bucket.waiters.erase(it);
+            waiter->queued = false;
+            BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(waiter->cond);
+            waiter->wake = true;
+            BOXEDWINE_CONDITION_SIGNAL(waiter->cond);
+            result++;
+        } else {
+            ++it;
+        }
+    }
+    return result;
+}
+
+// Used by pthread_cond_broadcast, 1 waiter is woken and the rest are moved to the mutex so that they are woken one
+// at a time as the mutex is released instead of all of them fighting over it.
+U32 KFutex::requeue(KThread* thread, U32 addr, U8* ramAddress, U32 addr2, U32 wakeCount, U32 requeueCount, bool compare, U32 value) {
+    U8* ramAddress2 = getPhysicalReadAddress(addr2, 4);
+    if (!ramAddress2) {
+        return -K_EFAULT;
+    }
+    KFutexBucket& bucket = getBucket(ramAddress);
+    KFutexBucket& bucket2 = getBucket(ramAddress2);
+    U32 result;
+
+    lockBuckets(bucket, bucket2);
+    if (compare && readd(addr) != value) {
+        unlockBuckets(bucket, bucket2);
+        return -K_EAGAIN;
+    }
+    result = wakeLocked(bucket, ramAddress, wakeCount, FUTEX_BITSET_MATCH_ANY);
+    U32 requeued = 0;
+    for (auto it = bucket.waiters.begin(); it != bucket.waiters.end() && requeued < requeueCount;) {
+        KFutexWaiter* waiter = *it;
+        if (waiter->address == ramAddress) {
+            waiter->address = ramAddress2;
+            requeued++;
+            if (&bucket != &bucket2) {
+                it = bucket.waiters.erase(it);
+                bucket2.waiters.push_back(waiter);
+                continue;
+            }
+        }
+        ++it;
+    }
+    unlockBuckets(bucket, bucket2);
+    // FUTEX_REQUEUE only returns the number woken
+    if (compare) {
+        result += requeued;
+    }
+    return result;
+}
+
+// Used by pthread_cond_signal, it updates the condition's sequence and wakes waiters on both the condition and
+// its mutex in 1 call.
+U32 KFutex::wakeOp(KThread* thread, U32 addr, U8* ramAddress, U32 addr2, U32 wakeCount, U32 wakeCount2, U32 encodedOp) {
+    if (!thread->memory->isValidWriteAddress(addr2, 4)) {
+        return -K_EFAULT;
+    }
+    U32 op = (encodedOp >> 28) & 0xf;
+    U32 cmp = (encodedOp >> 24) & 0xf;
+    S32 opArg = ((S32)(encodedOp << 8)) >> 20;
+    S32 cmpArg = ((S32)(encodedOp << 20)) >> 20;
+
+    if (op & FUTEX_OP_OPARG_SHIFT) {
+        op &= ~FUTEX_OP_OPARG_SHIFT;
+        opArg = 1 << (opArg & 31);
+    }
+    if (op > FUTEX_OP_XOR || cmp > FUTEX_OP_CMP_GE) {
+        return -K_ENOSYS;
+    }
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+    BtCodeMemoryWrite w((BtCPU*)thread->cpu, addr2, 4);
+#endif
+    U8* ramAddress2 = getPhysicalWriteAddress(addr2, 4);
+    KFutexBucket& bucket = getBucket(ramAddress);
+    KFutexBucket& bucket2 = getBucket(ramAddress2);
+    U32 result;
+
+    lockBuckets(bucket, bucket2);
+    // other threads can change the value without entering the kernel, so this needs to be atomic
+    std::atomic<U32>* value2 = (std::atomic<U32>*)ramAddress2;
+    U32 oldValue = value2->load();
+    U32 newValue;
+    do {
+        switch (op) {
+        case FUTEX_OP_SET: newValue = opArg; break;
+        case FUTEX_OP_ADD: newValue = oldValue + opArg; break;
+        case FUTEX_OP_OR: newValue = oldValue | opArg; break;
+        case FUTEX_OP_ANDN: newValue = oldValue & ~opArg; break;
+        default: newValue = oldValue ^ opArg; break;
+        }
+    } while (!value2->compare_exchange_weak(oldValue, newValue));
+
+    result = wakeLocked(bucket, ramAddress, wakeCount, FUTEX_BITSET_MATCH_ANY);
+
+    bool wake2;
+    switch (cmp) {
+    case FUTEX_OP_CMP_EQ: wake2 = (S32)oldValue == cmpArg; break;
+    case FUTEX_OP_CMP_NE: wake2 = (S32)oldValue != cmpArg; break;
+    case FUTEX_OP_CMP_LT: wake2 = (S32)oldValue < cmpArg; break;
+    case FUTEX_OP_CMP_LE: wake2 = (S32)oldValue <= cmpArg; break;
+    case FUTEX_OP_CMP_GT: wake2 = (S32)oldValue > cmpArg; break;
+    default: wake2 = (S32)oldValue >= cmpArg; break;
+    }
+    if (wake2) {
+        result += wakeLocked(bucket2, ramAddress2, wakeCount2, FUTEX_BITSET_MATCH_ANY);
+    }
+    unlockBuckets(bucket, bucket2);
+    return result;
+}
@@ -30,6 +30,34 @@ U32 KObject::writev(U32 iov, S32 iovcnt) {
     return len;
 }
 
+U32 KObject::readv(U32 iov, S32 iovcnt) {
+    U32 len=0;
+    S32 i;
+
+    for (i=0;i<iovcnt;i++) {
+        U32 buf = readd(iov + i * 8);
+        U32 toRead = readd(iov + i * 8 + 4);
+        S32 result;
+
+        result = this->read(buf, toRead);
+        if (result<0) {
+            if (i>0) {
+                return len;
+            }
+            return result;
+        }
+        len+=result;
+        if ((U32)result<toRead) {
+            break;
+        }
+        // like Linux, return what was read instead of blocking on the next iov (pipes, ttys, sockets)
+        if (i+1<iovcnt && !this->isReadReady()) {
+            break;
+        }
+    }
+    return len;
+}
+
 U32 KObject::read(U32 address, U32 len) {
     U8* ram = getPhysicalWriteAddress(address, len);
 
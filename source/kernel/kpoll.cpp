@@ -21,6 +21,20 @@
 #include "kpoll.h"
 #include "kscheduler.h"
 
+U32 getPollEvents(KObject* kobject, U32 events) {
+    if (!kobject->isOpen()) {
+        return K_POLLHUP;
+    }
+    if ((events & K_POLLPRI) && kobject->isPriorityReadReady()) {
+        return K_POLLPRI;
+    } else if ((events & K_POLLIN) != 0 && kobject->isReadReady()) {
+        return K_POLLIN;
+    } else if ((events & K_POLLOUT) != 0 && kobject->isWriteReady()) {
+        return K_POLLOUT;
+    }
+    return 0;
+}
+
 S32 internal_poll(KPollData* data, U32 count, U32 timeout) {
     KPollData* firstData=data;
 
@@ -49,17 +63,7 @@ S32 internal_poll(KPollData* data, U32 count, U32 timeout) {
             KFileDescriptor* fd = thread->process->getFileDescriptor(data->fd);
             data->revents = 0;
             if (fd) {
-                if (!fd->kobject->isOpen()) {
-                    data->revents = K_POLLHUP;
-                } else {
-                    if ((data->events & K_POLLPRI) && fd->kobject->isPriorityReadReady()) {
-                        data->revents |= K_POLLPRI;
-                    } else if ((data->events & K_POLLIN) != 0 && fd->kobject->isReadReady()) {
-                        data->revents |= K_POLLIN;
-                    } else if ((data->events & K_POLLOUT) != 0 && fd->kobject->isWriteReady()) {
-                        data->revents |= K_POLLOUT;
-                    }
-                }
+                data->revents = getPollEvents(fd->kobject.get(), data->events);
                 if (data->revents!=0) {
                     result++;
                 }
@@ -733,11 +733,11 @@ U32 KProcess::alarm(U32 seconds) {
     } else {
         this->timer.resetMillies = 0;
         if (this->timer.millies!=0) {
-            this->timer.millies = seconds*1000 + KSystem::getMilliesSinceStart();
-        } else {
-            this->timer.millies = seconds*1000 + KSystem::getMilliesSinceStart();
-            addTimer(&this->timer);
+            // the queue is ordered by millies, so a queued timer has to come out before millies changes
+            removeTimer(&this->timer);
         }
+        this->timer.millies = seconds*1000 + KSystem::getMilliesSinceStart();
+        addTimer(&this->timer);
     }
     if (prev) {
         return (prev - KSystem::getMilliesSinceStart())/1000;
@@ -1140,7 +1140,8 @@ U32 KProcess::read(FD fildes, U32 bufferAddress, U32 bufferLen) {
         return -K_EINVAL;
     }
 #ifdef BOXEDWINE_BINARY_TRANSLATOR
-    BtCodeMemoryWrite w((BtCPU*)KThread::currentThread()->cpu, bufferAddress, bufferLen);
+    // the read can block, so the pages can't be left writable while keeping the code on them
+    BtCodeMemoryWrite w((BtCPU*)KThread::currentThread()->cpu, bufferAddress, bufferLen, false);
 #endif
     return fd->kobject->read(bufferAddress, bufferLen);
 }
@@ -1595,11 +1596,11 @@ U32 KProcess::setitimer(U32 which, U32 newValue, U32 oldValue) {
         } else {
             this->timer.resetMillies = resetMillies;			
             if (this->timer.millies!=0) {
-                this->timer.millies = millies + KSystem::getMilliesSinceStart();
-            } else {
-                this->timer.millies = millies + KSystem::getMilliesSinceStart();
-                addTimer(&this->timer);
+                // the queue is ordered by millies, so a queued timer has to come out before millies changes
+                removeTimer(&this->timer);
             }
+            this->timer.millies = millies + KSystem::getMilliesSinceStart();
+            addTimer(&this->timer);
         }
     }	
     return 0;
@@ -1975,6 +1976,28 @@ U32 KProcess::writev(FD handle, U32 iov, S32 iovcnt) {
     return fd->kobject->writev(iov, iovcnt);    
 }
 
+U32 KProcess::readv(FD handle, U32 iov, S32 iovcnt) {
+    KFileDescriptor* fd = this->getFileDescriptor(handle);
+
+    if (fd==0) {
+        return -K_EBADF;
+    }
+    if (!fd->canRead()) {
+        return -K_EINVAL;
+    }
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+    // the read can block, so the pages can't be left writable while keeping the code on them
+    BtCodeMemoryWrite w((BtCPU*)KThread::currentThread()->cpu, false);
+    for (S32 i=0;i<iovcnt;i++) {
+        U32 len = readd(iov + i * 8 + 4);
+        if (len) {
+            w.invalidateCode(readd(iov + i * 8), len);
+        }
+    }
+#endif
+    return fd->kobject->readv(iov, iovcnt);
+}
+
 U32 KProcess::memfd_create(const std::string& name, U32 flags) {
     FsMemNode* node = new FsMemNode(1, 1, name);
     FsMemOpenNode* openNode = new FsMemOpenNode(flags, node);
@@ -2712,34 +2735,42 @@ U32 KProcess::allocNative(U32 len) {
 }
 
 U32 KProcess::readd(U32 address) {
+    loadLazyFilePagesForHost(memory, address, 4);
     return *(U32*)getNativeAddress(memory, address);
 }
 
 U16 KProcess::readw(U32 address) {
+    loadLazyFilePagesForHost(memory, address, 2);
     return *(U16*)getNativeAddress(memory, address);
 }
 
 U8 KProcess::readb(U32 address) {
+    loadLazyFilePagesForHost(memory, address, 1);
     return *(U8*)getNativeAddress(memory, address);
 }
 
 void KProcess::writed(U32 address, U32 value) {
+    loadLazyFilePagesForHost(memory, address, 4);
     *(U32*)getNativeAddress(memory, address) = value;
 }
 
 void KProcess::writew(U32 address, U16 value) {
+    loadLazyFilePagesForHost(memory, address, 2);
     *(U16*)getNativeAddress(memory, address) = value;
 }
 
 void KProcess::writeb(U32 address, U8 value) {
+    loadLazyFilePagesForHost(memory, address, 1);
     *(U8*)getNativeAddress(memory, address) = value;
 }
 
 void KProcess::memcopyFromNative(U32 address, const void* p, U32 len) {
+    loadLazyFilePagesForHost(memory, address, len);
     memcpy(getNativeAddress(memory, address), p, len);
 }
 
 void KProcess::memcopyToNative( U32 address, void* p, U32 len) {
+    loadLazyFilePagesForHost(memory, address, len);
     memcpy(p, getNativeAddress(memory, address), len);
 }
 
@@ -17,56 +17,60 @@
  */
 #include "boxedwine.h"
 
-#ifdef BOXEDWINE_MULTI_THREADED
-static KList<KTimer*> timers;
+static KTimerQueue timers;
 static BOXEDWINE_MUTEX timerMutex;
+
 void runTimers() {
+    static U32 pass;
     BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(timerMutex);
     U32 millies = KSystem::getMilliesSinceStart();
-    timers.for_each([millies](KListNode<KTimer*>* node) {
-        KTimer* timer = node->data;
 
-        if (timer->millies <= millies) {
-            if (timer->run()) {
-                timer->node.remove();
-            }
+    pass++;
+    // Only the front is ever taken, so a timer that an earlier run removed or deleted is never seen.  If a timer that
+    // already ran in this call is added back while it is still due, the call ends there so it can't run forever.
+    while (true) {
+        KTimer* timer = timers.front();
+        if (!timer || timer->millies > millies || timer->lastRunPass == pass) {
+            break;
+        }
+        timers.remove(timer);
+        timer->lastRunPass = pass;
+        if (timer->run()) {
+            timers.remove(timer);
+            timer->active = false;
+        } else if (timer->active) {
+            timers.add(timer);
         }
-        });
+    }
 }
 
 U32 getNextTimer() {
     BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(timerMutex);
-    U32 millies = KSystem::getMilliesSinceStart();
-    U32 result = 0xFFFFFFFF;
+    KTimer* timer = timers.front();
 
-    timers.for_each([millies, &result](KListNode<KTimer*>* node) {
-        KTimer* timer = node->data;
-        U32 next;
-        if (timer->millies <= millies) {
-            next = 0;
-        }
-        else {
-            next = timer->millies - millies;
-        }
-        if (next < result) {
-            result = next;
-        }
-        });
-    return result;
+    if (!timer) {
+        return 0xFFFFFFFF;
+    }
+    U32 millies = KSystem::getMilliesSinceStart();
+    if (timer->millies <= millies) {
+        return 0;
+    }
+    return timer->millies - millies;
 }
 
 void addTimer(KTimer* timer) {
     BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(timerMutex);
-    timers.addToBack(&timer->node);
+    timers.add(timer);
     timer->active = true;
 }
 
 void removeTimer(KTimer* timer) {
     BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(timerMutex);
-    timer->node.remove();
+    timers.remove(timer);
     timer->active = false;
 }
-#else
+
+#ifndef BOXEDWINE_MULTI_THREADED
 #include "devfb.h"
 #include "kscheduler.h"
 #include "knativewindow.h"
@@ -77,17 +81,6 @@ void removeTimer(KTimer* timer) {
 
 KList<KThread*> scheduledThreads;
 KList<KThread*> waitThreads;
-KList<KTimer*> timers;
-
-void addTimer(KTimer* timer) {
-    timers.addToBack(&timer->node);
-    timer->active = true;
-}
-
-void removeTimer(KTimer* timer) {
-    timer->node.remove();
-    timer->active = false;
-}
 
 void scheduleThread(KThread* thread) {
 #ifdef _DEBUG
@@ -148,19 +141,6 @@ void runThreadSlice(KThread* thread) {
     cpu->instructionCount+=cpu->blockInstructionCount;
 }
 
-void runTimers() {
-    U32 millies = KSystem::getMilliesSinceStart();
-    timers.for_each([millies] (KListNode<KTimer*>* node) {
-        KTimer* timer = node->data;
-
-        if (timer->millies<=millies) {
-            if (timer->run()) {                
-                timer->node.remove();
-            }
-        }
-    });
-}
-
 extern U64 sysCallTime;
 U64 elapsedTimeMIPS;
 U64 elapsedInstructionsMIPS;
@@ -23,6 +23,9 @@
 #include "kscheduler.h"
 #include "../emulation/softmmu/soft_ram.h"
 #include "../emulation/cpu/normal/normalCPU.h"
+#include "../emulation/cpu/binaryTranslation/btCodeCache.h"
+#include "../emulation/cpu/binaryTranslation/btTranslationPool.h"
+#include "../emulation/cpu/binaryTranslation/btCodeMemoryWrite.h"
 #include "knativesystem.h"
 #include "pixelformat.h"
 
@@ -38,6 +41,8 @@ U32 KSystem::openglType = OPENGL_TYPE_OSMESA;
 #else
 U32 KSystem::openglType = OPENGL_TYPE_UNAVAILABLE;
 #endif
+bool KSystem::openglThreaded = false;
+std::string KSystem::openglProfilePath;
 bool KSystem::soundEnabled = true;
 unsigned int KSystem::nextThreadId=10;
 std::unordered_map<void*, SHM*> KSystem::shm;
@@ -56,12 +61,17 @@ std::string KSystem::title;
 // some simple opengl apps seem to have a hard time starting if this is false
 // Not sure if this is a Boxedwine issue or if its normal for Windows to behave different for OpenGL if the window is hidden
 bool KSystem::showWindowImmediately = false;
+#ifdef BOXEDWINE_64BIT_MMU
+bool KSystem::copyOnWriteFork = true;
+#endif
 #ifdef BOXEDWINE_BINARY_TRANSLATOR
 #ifdef BOXEDWINE_SMALL_VIRTUAL_MEMORY
 bool KSystem::useLargeAddressSpace = false;
 #else
 bool KSystem::useLargeAddressSpace = true;
 #endif
+std::string KSystem::translationCachePath;
+U32 KSystem::translationThreads = 0;
 #endif
 #ifdef BOXEDWINE_MULTI_THREADED
 U32 KSystem::cpuAffinityCountForApp = 0;
@@ -93,6 +103,19 @@ void KSystem::init() {
 void KSystem::destroy() {
 	KThread::setCurrentThread(NULL);
 	KSystem::shutingDown = true;
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+    BtTranslationPool::stop();
+    U32 dataLineWrites = BtCodeMemoryWrite::dataLineWrites.load(std::memory_order_relaxed);
+    U32 codeLineWrites = BtCodeMemoryWrite::codeLineWrites.load(std::memory_order_relaxed);
+    if (dataLineWrites || codeLineWrites) {
+        klog("writes to code pages: %d kept the code, %d cleared the code", dataLineWrites, codeLineWrites);
+    }
+#endif
+    U32 residentPages, sharedPages, ramRegions;
+    ramPageStats(residentPages, sharedPages, ramRegions);
+    if (residentPages) {
+        klog("ram pages: %d resident, %d shared, %d regions", residentPages, sharedPages, ramRegions);
+    }
     while (true) {
         std::shared_ptr<KProcess> p;
         {
@@ -119,7 +142,11 @@ void KSystem::destroy() {
 	KSystem::shutingDown = false;
 	Fs::shutDown();
     DecodedOp::clearCache();
+    NormalCPU::logCacheStats();
     NormalCPU::clearCache();
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+    BtCodeCache::save();
+#endif
     if (KSystem::logFile) {
         fclose(KSystem::logFile);
         KSystem::logFile = NULL;
@@ -520,8 +547,8 @@ static std::unordered_map<U32, BoxedPtr<SHM> > shmKey;
 #define PRIVATE_SHMID 0x40000000
 
 SHM::~SHM() {
-    for (U32 i=0;i<(U32)this->pages.size();i++) {
-        ramPageDecRef(this->pages[i]);
+    if (this->pages.size()) {
+        ramPageDecRef(this->pages.data(), (U32)this->pages.size());
     }
 }
 
@@ -557,9 +584,8 @@ U32 KSystem::shmget(U32 key, U32 size, U32 flags) {
     result->ctime = Platform::getSystemTimeAsMicroSeconds();
     result->len = size;
     U32 pageCount = (size+K_PAGE_SIZE-1) / K_PAGE_SIZE;
-    for (U32 i=0;i<pageCount;i++) {
-        result->pages.push_back(ramPageAlloc());
-    }
+    result->pages.resize(pageCount);
+    ramPageAlloc(result->pages.data(), pageCount);
     return result->id;
 }
 
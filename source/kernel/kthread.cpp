@@ -24,19 +24,23 @@
 #include "ksignal.h"
 #include <string.h>
 #include <setjmp.h>
+#include "../emulation/cpu/binaryTranslation/btTranslationPool.h"
+#include "../vulkan/vk_arena.h"
 
 #ifdef BOXEDWINE_BINARY_TRANSLATOR
 THREAD_LOCAL
 #endif
 KThread* KThread::runningThread;
 
-BOXEDWINE_MUTEX KThread::futexesMutex;
-
 KThread::~KThread() {    
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+    BtTranslationPool::cancel(this);
+#endif
     this->cleanup();
     CPU* cpu = this->cpu;
     this->cpu = NULL;
     delete cpu;
+    delete this->vkArena;
 }
 
 void KThread::cleanup() {
@@ -117,7 +121,10 @@ KThread::KThread(U32 id, const std::shared_ptr<KProcess>& process) :
     hasContextBeenMadeCurrentSinceCreation(false),
     glContext(0),
     currentContext(0),
+    glThread(NULL),
+    vkArena(NULL),
     log(false),
+    glUntrackedClientArrays(false),
     waitingCond(0),
     pollCond("KThread::pollCond"),
 #ifndef BOXEDWINE_MULTI_THREADED
@@ -228,156 +235,12 @@ U32 KThread::signal(U32 signal, bool wait) {
     return 0;
 }
 
-#define FUTEX_WAIT 0
-#define FUTEX_WAKE 1
-#define FUTEX_WAIT_PRIVATE 128
-#define FUTEX_WAKE_PRIVATE 129
-#define FUTEX_WAIT_BITSET_PRIVATE 137
-#define FUTEX_WAKE_BITSET_PRIVATE 138
-#define FUTEX_CLOCK_REALTIME 256
-
-struct futex {
-public:
-    futex() : cond("futex") {}
-    KThread* thread;
-    U8* address;  
-    U32 expireTimeInMillies;
-    U32 mask;
-    bool wake;
-    BOXEDWINE_CONDITION cond;
-};
-
-#define MAX_FUTEXES 128
-
-struct futex system_futex[MAX_FUTEXES];
-
-struct futex* getFutex(KThread* thread, U8* address) {
-    int i=0;
-
-    for (i=0;i<MAX_FUTEXES;i++) {
-        if (system_futex[i].address == address && system_futex[i].thread==thread) {
-            return &system_futex[i];
-        }
-    }
-    return 0;
-}
-
-struct futex* allocFutex(KThread* thread, U8* address, U32 millies) {
-    BOXEDWINE_CRITICAL_SECTION;
-    int i=0;
-
-    for (i=0;i<MAX_FUTEXES;i++) {
-        if (system_futex[i].thread==0) {
-            system_futex[i].thread = thread;
-            system_futex[i].address = address;
-            system_futex[i].expireTimeInMillies = millies;
-            system_futex[i].wake = false;
-            system_futex[i].mask = 0;
-            return &system_futex[i];
-        }
-    }
-    kpanic("ran out of futexes");
-    return 0;
-}
-
-void freeFutex(struct futex* f) {
-    f->thread = 0;
-    f->address = 0;
-}
-
 void KThread::clearFutexes() {
-    U32 i;
-
-    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(KThread::futexesMutex);
-    for (i=0;i<MAX_FUTEXES;i++) {
-        if (system_futex[i].thread == this) {
-            freeFutex(&system_futex[i]);
-        }
-    }
+    KFutex::removeWaiter(this);
 }
 
 U32 KThread::futex(U32 addr, U32 op, U32 value, U32 pTime, U32 val2, U32 val3) {
-    U8* ramAddress = getPhysicalReadAddress(addr, 4);
-
-    if (ramAddress==0) {
-        kpanic("Could not find futex address: %0.8X", addr);
-    }
-    op = op & ~FUTEX_CLOCK_REALTIME;
-    if (op==FUTEX_WAIT || op==FUTEX_WAIT_PRIVATE || op == FUTEX_WAIT_BITSET_PRIVATE) {
-        struct futex* f=getFutex(this, ramAddress);
-        U32 expireTime;
-
-        if (pTime == 0) {
-            expireTime = 0xFFFFFFFF;
-        } else {
-            U32 seconds = readd(pTime);
-            U32 nano = readd(pTime + 4);
-            expireTime = seconds * 1000 + nano / 1000000 + KSystem::getMilliesSinceStart();
-        }
-        bool checkValue = false;
-
-        if (!f) {
-            checkValue = true;
-            f = allocFutex(this, ramAddress, expireTime);
-            if (op == FUTEX_WAIT_BITSET_PRIVATE) {
-                f->mask = val3;
-            }
-        }
-        while (true) {
-            BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(f->cond);
-            if (checkValue) {
-                checkValue = false;
-                if (readd(addr) != value) { // needs to be protected
-                    freeFutex(f);
-                    return -K_EWOULDBLOCK;
-                } 
-            }
-            if (this->pendingSignals) {
-                // I know this is a nested if statement, but it makes setting a break point easier
-                if (runSignals()) {
-                    return -K_CONTINUE;
-                }
-            }
-            if (f->wake) {
-                freeFutex(f);
-                return 0;
-            }            
-            if (f->expireTimeInMillies<0x7FFFFFFF) {
-                S32 diff = f->expireTimeInMillies - KSystem::getMilliesSinceStart();
-                if (diff<=0) {
-                    freeFutex(f);
-                    return -K_ETIMEDOUT;
-                }
-                BOXEDWINE_CONDITION_WAIT_TIMEOUT(f->cond, (U32)diff);
-            } else {
-                BOXEDWINE_CONDITION_WAIT(f->cond);
-            }
-#ifdef BOXEDWINE_MULTI_THREADED
-			if (this->terminating) {
-				return -K_EINTR;
-			}
-            if (KThread::currentThread()->startSignal) {
-                KThread::currentThread()->startSignal = false;
-                return -K_CONTINUE;
-            }
-#endif
-        }
-    } else if (op==FUTEX_WAKE_PRIVATE || op==FUTEX_WAKE || op==FUTEX_WAKE_BITSET_PRIVATE) {
-        int i;
-        U32 count = 0;
-        for (i=0;i<MAX_FUTEXES && count<value;i++) {
-            if (system_futex[i].address==ramAddress && !system_futex[i].wake && (op!= FUTEX_WAKE_BITSET_PRIVATE || (system_futex[i].mask & val3))) {
-                BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(system_futex[i].cond);
-                system_futex[i].wake = true;
-                BOXEDWINE_CONDITION_SIGNAL(system_futex[i].cond);
-                count++;
-            }
-        }
-        return count;
-    } else {
-        kwarn("syscall __NR_futex op %d not implemented", op);
-        return -1;
-    }
+    return KFutex::futex(this, addr, op, value, pTime, val2, val3);
 }
 
 static U8 fetchByte(U32* eip) {
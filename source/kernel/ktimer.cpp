@@ -4,4 +4,63 @@ KTimer::~KTimer() {
     if (this->active) {
         removeTimer(this);
     }
-}
\ No newline at end of file
+}
+
+void KTimerQueue::add(KTimer* timer) {
+    if (timer->queueIndex != K_TIMER_NOT_QUEUED) {
+        siftUp(timer->queueIndex);
+        siftDown(timer->queueIndex);
+        return;
+    }
+    this->heap.push_back(timer);
+    timer->queueIndex = (U32)this->heap.size() - 1;
+    siftUp(timer->queueIndex);
+}
+
+void KTimerQueue::remove(KTimer* timer) {
+    U32 index = timer->queueIndex;
+    if (index == K_TIMER_NOT_QUEUED) {
+        return;
+    }
+    timer->queueIndex = K_TIMER_NOT_QUEUED;
+    KTimer* last = this->heap.back();
+    this->heap.pop_back();
+    if (last != timer) {
+        set(index, last);
+        siftUp(index);
+        siftDown(last->queueIndex);
+    }
+}
+
+void KTimerQueue::siftUp(U32 index) {
+    KTimer* timer = this->heap[index];
+    while (index) {
+        U32 parent = (index - 1) / 2;
+        if (this->heap[parent]->millies <= timer->millies) {
+            break;
+        }
+        set(index, this->heap[parent]);
+        index = parent;
+    }
+    set(index, timer);
+}
+
+void KTimerQueue::siftDown(U32 index) {
+    KTimer* timer = this->heap[index];
+    U32 count = (U32)this->heap.size();
+    while (true) {
+        U32 child = index * 2 + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && this->heap[child + 1]->millies < this->heap[child]->millies) {
+            child++;
+        }
+        if (timer->millies <= this->heap[child]->millies) {
+            break;
+        }
+        set(index, this->heap[child]);
+        index = child;
+    }
+    set(index, timer);
+}
@@ -4,8 +4,13 @@
 #include "ksocket.h"
 #include "kstat.h"
 
+// how many read messages a socket keeps for reuse
+#define MAX_FREE_SOCKET_MSGS 8
+// a reused message doesn't hang on to more data than this
+#define MAX_FREE_SOCKET_MSG_DATA (64 * 1024)
+
 KUnixSocketObject::KUnixSocketObject(U32 pid, U32 domain, U32 type, U32 protocol) : KSocketObject(KTYPE_UNIX_SOCKET, domain, type, protocol), 
-    lockCond("KUnixSocketObject::lockCond")
+    lockCond("KUnixSocketObject::lockCond"), msgHead(NULL), msgTail(NULL), freeMsgs(NULL), freeMsgCount(0)
 {
 }
 
@@ -49,6 +54,47 @@ KUnixSocketObject::~KUnixSocketObject() {
         }
     }    
     BOXEDWINE_CONDITION_SIGNAL_ALL(this->lockCond);
+    while (this->msgHead) {
+        KSocketMsg* next = this->msgHead->next;
+        delete this->msgHead;
+        this->msgHead = next;
+    }
+    while (this->freeMsgs) {
+        KSocketMsg* next = this->freeMsgs->next;
+        delete this->freeMsgs;
+        this->freeMsgs = next;
+    }
+}
+
+// lockCond must be held
+KSocketMsg* KUnixSocketObject::allocMsg() {
+    KSocketMsg* result = this->freeMsgs;
+    if (result) {
+        this->freeMsgs = result->next;
+        this->freeMsgCount--;
+        result->next = NULL;
+    } else {
+        result = new KSocketMsg();
+    }
+    return result;
+}
+
+// lockCond must be held
+void KUnixSocketObject::freeMsg(KSocketMsg* msg) {
+    if (this->freeMsgCount >= MAX_FREE_SOCKET_MSGS) {
+        delete msg;
+        return;
+    }
+    msg->objects.clear();
+    if (msg->data.capacity() > MAX_FREE_SOCKET_MSG_DATA) {
+        std::vector<U8>().swap(msg->data);
+    } else {
+        msg->data.clear();
+    }
+    msg->readPos = 0;
+    msg->next = this->freeMsgs;
+    this->freeMsgs = msg;
+    this->freeMsgCount++;
 }
 
 void KUnixSocketObject::setBlocking(bool blocking) {
@@ -85,7 +131,7 @@ bool KUnixSocketObject::isOpen() {
 
 bool KUnixSocketObject::isReadReady() {
     //BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(this->lockCond);
-    return this->inClosed || this->recvBuffer.size() || this->pendingConnections.size() || this->msgs.size();
+    return this->inClosed || this->recvBuffer.size() || this->pendingConnections.size() || this->msgHead;
 }
 
 bool KUnixSocketObject::isWriteReady() {
@@ -118,8 +164,6 @@ void KUnixSocketObject::waitForEvents(BOXEDWINE_CONDITION& parentCondition, U32
 }
 
 U32 KUnixSocketObject::internal_write(const std::shared_ptr<KUnixSocketObject>& con, BOXEDWINE_CONDITION& cond, U32 buffer, U32 len) {
-    U32 count=0;
-    
     if (this->type == K_SOCK_DGRAM) {
         if (!strcmp(this->destAddress.data, "/dev/log")) {
             char tmp[MAX_FILEPATH_LEN];
@@ -130,24 +174,29 @@ U32 KUnixSocketObject::internal_write(const std::shared_ptr<KUnixSocketObject>&
     if (this->outClosed || !con)
         return -K_EPIPE;  
     
-    //printf("internal_write: %0.8X size=%d capacity=%d writeLen=%d", (int)&this->connection->recvBuffer, (int)this->connection->recvBuffer.size(), (int)this->connection->recvBuffer.capacity(), len);
-
-    while (len) {
-        S8 tmp[4096];
-        U32 todo = len;
-
-        if (todo>4096)
-            todo = 4096;
-        if (!KThread::currentThread()->memory->isValidReadAddress(buffer, todo)) {
-            kwarn("KUnixSocketObject::internal_write about to crash reading buffer to buffer");
-        }
-        memcopyToNative(buffer, tmp, todo);
-        con->recvBuffer.insert(con->recvBuffer.end(), tmp, tmp + todo);
-        buffer+=todo;
-        len-=todo;
-        count+=todo;
-    }     
-    return count;
+    if (len && !KThread::currentThread()->memory->isValidReadAddress(buffer, len)) {
+        kwarn("KUnixSocketObject::internal_write about to crash reading buffer to buffer");
+    }
+    // straight from guest memory into the connection's ring
+    con->recvBuffer.write(len, [&buffer](U8* dst, U32 todo) {
+        memcopyToNative(buffer, dst, todo);
+        buffer += todo;
+    });
+    return len;
+}
+
+// lockCond must be held
+U32 KUnixSocketObject::internal_read(U32 buffer, U32 len) {
+    if (len > this->recvBuffer.size()) {
+        len = this->recvBuffer.size();
+    }
+    if (len && !KThread::currentThread()->memory->isValidWriteAddress(buffer, len)) {
+        kwarn("KUnixSocketObject::read about to crash writing to buffer");
+    }
+    return this->recvBuffer.read(len, [&buffer](const U8* src, U32 todo) {
+        memcopyFromNative(buffer, src, todo);
+        buffer += todo;
+    });
 }
 
 U32 KUnixSocketObject::writev(U32 iov, S32 iovcnt) {
@@ -201,7 +250,7 @@ U32 KUnixSocketObject::writeNative(U8* buffer, U32 len) {
         return -K_EPIPE;
 
     BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(con->lockCond); 
-    con->recvBuffer.insert(con->recvBuffer.end(), buffer, buffer + len);
+    con->recvBuffer.write(buffer, len);
     BOXEDWINE_CONDITION_SIGNAL_ALL(con->lockCond);
     return len;
 }
@@ -220,7 +269,7 @@ U32 KUnixSocketObject::unixsocket_write_native_nowait(const std::shared_ptr<KObj
 
     BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(con->lockCond);
     //printf("SOCKET write len=%d bufferSize=%d pos=%d\n", len, s->connection->recvBufferLen, s->connection->recvBufferWritePos);
-    con->recvBuffer.insert(con->recvBuffer.end(), value, value + len);
+    con->recvBuffer.write(value, len);
     BOXEDWINE_CONDITION_SIGNAL_ALL(con->lockCond);
 
     return len;
@@ -250,16 +299,10 @@ U32 KUnixSocketObject::readNative(U8* buffer, U32 len) {
         }
 #endif
     }
-    //printf("readNative: %0.8X size=%d capacity=%d writeLen=%d", (int)&this->recvBuffer, (int)this->recvBuffer.size(), (int)this->recvBuffer.capacity(), len);
-    if (len > this->recvBuffer.size()) {
-        len = (U32)this->recvBuffer.size();
-    }
-    std::copy(this->recvBuffer.begin(), this->recvBuffer.begin() + len, buffer);
-    this->recvBuffer.erase(this->recvBuffer.begin(), this->recvBuffer.begin() + len);
+    len = this->recvBuffer.read(buffer, len);
     if (con) {
         BOXEDWINE_CONDITION_SIGNAL_ALL(this->lockCond);
     }
-    //printf("    readNative: %0.8X size=%d capacity=%d writeLen=%d", (int)&this->recvBuffer, (int)this->recvBuffer.size(), (int)this->recvBuffer.capacity(), len);
     return len;
 }
 
@@ -288,32 +331,46 @@ U32 KUnixSocketObject::read(U32 buffer, U32 len) {
         }
 #endif
     }
-    // :TODO: remove extra copy
-    while (len && this->recvBuffer.size()!=0) {
-        S8 tmp[4096];
-        U32 todo = len;
-
-        if (todo > 4096)
-            todo = 4096;
-        if (todo > this->recvBuffer.size())
-            todo = (U32)this->recvBuffer.size();
+    count = this->internal_read(buffer, len);
+    if (con) {
+        BOXEDWINE_CONDITION_SIGNAL_ALL(this->lockCond);
+    }
 
-        std::copy(this->recvBuffer.begin(), this->recvBuffer.begin() + todo, tmp);
-        this->recvBuffer.erase(this->recvBuffer.begin(), this->recvBuffer.begin() + todo);
+    return count;
+}
 
-        if (!KThread::currentThread()->memory->isValidWriteAddress(buffer, todo)) {
-            kwarn("KUnixSocketObject::read about to crash writing to buffer");
+// same as read, but the buffers are filled in one go while holding the lock
+U32 KUnixSocketObject::readv(U32 iov, S32 iovcnt) {
+    U32 count = 0;
+    std::shared_ptr<KUnixSocketObject> con = this->connection.lock();
+    if (!this->inClosed && !con)
+        return -K_EPIPE;
+    con = nullptr; // don't hold a strong reference to this, if we are blocking then it would prevent the con object from being destroyed when its process is closed
+    BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(this->lockCond);
+    while (this->recvBuffer.size()==0) {
+        if (this->inClosed) {
+            return 0;
         }
-        memcopyFromNative(buffer, tmp, todo);
-
-        buffer += todo;
-        count += todo;
-        len -= todo;
-    }      
-    if (con) {
-        BOXEDWINE_CONDITION_SIGNAL_ALL(this->lockCond);
+        if (!this->blocking) {
+            return -K_EWOULDBLOCK;
+        }
+        BOXEDWINE_CONDITION_WAIT(this->lockCond);
+#ifdef BOXEDWINE_MULTI_THREADED
+		if (KThread::currentThread()->terminating) {
+			return -K_EINTR;
+		}
+        if (KThread::currentThread()->startSignal) {
+            KThread::currentThread()->startSignal = false;
+            return -K_CONTINUE;
+        }
+#endif
     }
+    for (S32 i = 0; i < iovcnt && this->recvBuffer.size(); i++) {
+        U32 buf = readd(iov + i * 8);
+        U32 toRead = readd(iov + i * 8 + 4);
 
+        count += this->internal_read(buf, toRead);
+    }
     return count;
 }
 
@@ -702,7 +759,7 @@ U32 KUnixSocketObject::sendmsg(KFileDescriptor* fd, U32 address, U32 flags) {
         return -K_EPIPE;
     readMsgHdr(address, &hdr);
 
-    std::shared_ptr<KSocketMsg> msg = std::make_shared<KSocketMsg>();
+    KSocketMsg* msg = con->allocMsg();
 
     if (hdr.msg_control) {
         CMsgHdr cmsg;			
@@ -728,21 +785,21 @@ U32 KUnixSocketObject::sendmsg(KFileDescriptor* fd, U32 address, U32 flags) {
             }
         }				
     }
+    // gather the iovs into the message, recvmsg will scatter them into its own iovs
     for (U32 i=0;i<hdr.msg_iovlen;i++) {
         U32 p = readd(hdr.msg_iov + 8 * i);
         U32 len = readd(hdr.msg_iov + 8 * i + 4);
 
-        msg->data.push_back((U8)len);
-        msg->data.push_back((U8)(len >> 8));
-        msg->data.push_back((U8)(len >> 16));
-        msg->data.push_back((U8)(len >> 24));
-        while (len) {
-            msg->data.push_back(readb(p++));
-            len--;
-            result++;
-        }
+        msg->data.resize(result + len);
+        memcopyToNative(p, msg->data.data() + result, len);
+        result += len;
     }
-    con->msgs.push(msg);
+    if (con->msgTail) {
+        con->msgTail->next = msg;
+    } else {
+        con->msgHead = msg;
+    }
+    con->msgTail = msg;
     BOXEDWINE_CONDITION_SIGNAL_ALL(con->lockCond);
 
     return result;
@@ -755,14 +812,14 @@ U32 KUnixSocketObject::recvmsg(KFileDescriptor* fd, U32 address, U32 flags) {
     if (this->domain==K_AF_NETLINK)
         return -K_EIO;
     BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(this->lockCond);
-    while (!this->msgs.size()) {
+    while (!this->msgHead) {
         if (this->recvBuffer.size()) {
             readMsgHdr(address, &hdr);        
-            for (U32 i = 0; i < hdr.msg_iovlen; i++) {
+            for (U32 i = 0; i < hdr.msg_iovlen && this->recvBuffer.size(); i++) {
                 U32 p = readd(hdr.msg_iov + 8 * i);
                 U32 len = readd(hdr.msg_iov + 8 * i + 4);
                 
-                result+=this->read(p, len);
+                result+=this->internal_read(p, len);
             }
             if (this->type==K_SOCK_STREAM)
                 writed(address + 4, 0); // msg_namelen, set to 0 for connected sockets
@@ -789,8 +846,7 @@ U32 KUnixSocketObject::recvmsg(KFileDescriptor* fd, U32 address, U32 flags) {
     }
 
     readMsgHdr(address, &hdr);
-    std::shared_ptr<KSocketMsg> msg = this->msgs.front();
-    this->msgs.pop();
+    KSocketMsg* msg = this->msgHead;
 
     if (hdr.msg_control) {
         KThread* thread = KThread::currentThread();
@@ -803,19 +859,32 @@ U32 KUnixSocketObject::recvmsg(KFileDescriptor* fd, U32 address, U32 flags) {
         }
         writed(address + 20, i * 20);
     }
-    U32 pos = 0;
-    for (U32 i=0;i<hdr.msg_iovlen;i++) {
+    // the objects are only passed once, like on Linux they come with the first read of the message
+    msg->objects.clear();
+    for (U32 i=0;i<hdr.msg_iovlen && msg->readPos<msg->data.size();i++) {
         U32 p = readd(hdr.msg_iov + 8 * i);
         U32 len = readd(hdr.msg_iov + 8 * i + 4);
-        U32 dataLen = msg->data[pos] | (((U32)msg->data[pos + 1]) << 8) | (((U32)msg->data[pos + 2]) << 16) | (((U32)msg->data[pos + 3]) << 24);
-        pos+=4;
-        if (len<dataLen) {
-            kpanic("unhandled socket msg logic");
-        }
-        memcopyFromNative(p, msg->data.data() + pos, dataLen);
-        pos+=dataLen;
-        result+=dataLen;
+        U32 todo = (U32)msg->data.size() - msg->readPos;
+
+        if (todo > len) {
+            todo = len;
+        }
+        memcopyFromNative(p, msg->data.data() + msg->readPos, todo);
+        msg->readPos += todo;
+        result += todo;
     }  
+    // on a stream socket what didn't fit stays for the next read, a datagram is read whole or the rest is dropped
+    if (this->type!=K_SOCK_STREAM) {
+        writed(address + 24, msg->readPos < msg->data.size() ? K_MSG_TRUNC : 0); // msg_flags
+        msg->readPos = (U32)msg->data.size();
+    }
+    if (msg->readPos == msg->data.size()) {
+        this->msgHead = msg->next;
+        if (!this->msgHead) {
+            this->msgTail = NULL;
+        }
+        this->freeMsg(msg);
+    }
     if (!this->connection.expired()) {
         BOXEDWINE_CONDITION_SIGNAL_ALL(this->lockCond);
     }
@@ -750,6 +750,13 @@ static U32 syscall_msync(CPU* cpu, U32 eipCount) {
     return result;
 }
 
+static U32 syscall_readv(CPU* cpu, U32 eipCount) {
+    SYS_LOG1(SYSCALL_READ, cpu, "readv: filds=%d iov=0x%X iovcn=%d", ARG1, ARG2, ARG3);
+    U32 result = cpu->thread->process->readv(ARG1, ARG2, ARG3);
+    SYS_LOG(SYSCALL_READ, cpu, " result=%d(0x%X)\n", result, result);
+    return result;
+}
+
 static U32 syscall_writev(CPU* cpu, U32 eipCount) {
     SYS_LOG1(SYSCALL_WRITE, cpu, "writev: filds=%d iov=0x%X iovcn=%d", ARG1, ARG2, ARG3);    
     U32 result = cpu->thread->process->writev(ARG1, ARG2, ARG3);
@@ -1163,6 +1170,9 @@ static const char* getFutexOp(U32 op) {
     if (op==129) return "WAKE PRIVATE";
     if (op == 137) return "WAIT BITSET PRIVATE";
     if (op == 138) return "WAKE BITSET PRIVATE";
+    if (op == 3 || op == 131) return "REQUEUE";
+    if (op == 4 || op == 132) return "CMP REQUEUE";
+    if (op == 5 || op == 133) return "WAKE OP";
     static std::string tmp;
     tmp = std::to_string(op);
     return tmp.c_str();
@@ -1752,7 +1762,7 @@ static const SyscallFunc syscallFunc[] = {
     syscall_newselect,  // 142 __NR_newselect
     syscall_flock,      // 143 __NR_flock
     syscall_msync,      // 144 __NR_msync
-    0,                  // 145
+    syscall_readv,      // 145 __NR_readv
     syscall_writev,     // 146  __NR_writev
     0,                  // 147
     syscall_fdatasync,  // 148 __NR_fdatasync
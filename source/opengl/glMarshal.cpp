@@ -5,7 +5,7 @@
 #include "glcommon.h"
 #include "glMarshal.h"
 
-#define MARSHAL_TYPE(type, p, m, s) type* buffer##p; U32 buffer##p##_len; type* marshal##p(CPU* cpu, U32 address, U32 count) {U32 i; if (!address) return NULL; if (buffer##p && buffer##p##_len<count) { delete[] buffer##p; buffer##p=NULL;} if (!buffer##p) {buffer##p = new type[count]; buffer##p##_len = count;}for (i=0;i<count;i++) {buffer##p[i] = read##m(address);address+=s;} return buffer##p;}
+#define MARSHAL_TYPE(type, p, m, s) type* buffer##p; U32 buffer##p##_len; type* marshal##p(CPU* cpu, U32 address, U32 count) {U32 i; if (!address) return NULL; if (buffer##p && buffer##p##_len<count) { delete[] buffer##p; buffer##p=NULL;} if (!buffer##p) {buffer##p = new type[count]; buffer##p##_len = count;}for (i=0;i<count;i++) {buffer##p[i] = read##m(address);address+=s;} glProfileMarshaled(count * sizeof(type)); return glThreadMarshaled(buffer##p, count);}
 
 #ifdef BOXEDWINE_64BIT_MMU
 
@@ -181,7 +181,7 @@ const GLcharARB** marshalszArrayARB(CPU* cpu, U32 count, U32 address, U32 addres
 }
 
 #else 
-#define MARSHAL_TYPE_CUSTOM(type, p, m, s, conv, get, set) type* buffer##p; U32 buffer##p##_len; type* marshal##p(CPU* cpu, U32 address, U32 count) {U32 i; if (!address) return NULL; if (buffer##p && buffer##p##_len<count) { delete[] buffer##p; buffer##p=NULL;} if (!buffer##p) {buffer##p = new type[count]; buffer##p##_len = count;}for (i=0;i<count;i++) {struct conv d; get = read##m(address);address+=s;buffer##p[i] = set;} return buffer##p;}
+#define MARSHAL_TYPE_CUSTOM(type, p, m, s, conv, get, set) type* buffer##p; U32 buffer##p##_len; type* marshal##p(CPU* cpu, U32 address, U32 count) {U32 i; if (!address) return NULL; if (buffer##p && buffer##p##_len<count) { delete[] buffer##p; buffer##p=NULL;} if (!buffer##p) {buffer##p = new type[count]; buffer##p##_len = count;}for (i=0;i<count;i++) {struct conv d; get = read##m(address);address+=s;buffer##p[i] = set;} glProfileMarshaled(count * sizeof(type)); return glThreadMarshaled(buffer##p, count);}
 
 MARSHAL_TYPE(GLbyte, b, b, 1)
 MARSHAL_TYPE(GLbyte, 2b, b, 1)
@@ -911,8 +911,8 @@ GLvoid* marshalGetConvolutionFilter(CPU* cpu, U32 target, U32 format, U32 type,
     if (PIXEL_PACK_BUFFER())
         return (GLubyte*)(uintptr_t)image;
     if (ext_glGetConvolutionParameteriv) {
-        ext_glGetConvolutionParameteriv(target, GL_CONVOLUTION_WIDTH, &width);
-        ext_glGetConvolutionParameteriv(target, GL_CONVOLUTION_WIDTH, &height);
+        GL_FUNC(ext_glGetConvolutionParameteriv)(target, GL_CONVOLUTION_WIDTH, &width);
+        GL_FUNC(ext_glGetConvolutionParameteriv)(target, GL_CONVOLUTION_WIDTH, &height);
     }
     return marshalType(cpu, type, components_in_format(format)*width*height, image);
 }
@@ -928,12 +928,24 @@ GLboolean PIXEL_PACK_BUFFER() {
     return marshalGet(GL_PIXEL_PACK_BUFFER_BINDING)!=0;
 }
 
+// with a GLThread the binding is remembered so that a draw doesn't wait for the render thread to look it up
+static GLint marshalGetBinding(GLenum param, U32 index) {
+    GLThread* glThread = GLThread::current();
+    if (!glThread) {
+        return marshalGet(param);
+    }
+    if (glThread->bindings[index] == GL_THREAD_BINDING_UNKNOWN) {
+        glThread->bindings[index] = marshalGet(param);
+    }
+    return glThread->bindings[index];
+}
+
 GLboolean ARRAY_BUFFER() {
-    return marshalGet(GL_ARRAY_BUFFER_BINDING)!=0;
+    return marshalGetBinding(GL_ARRAY_BUFFER_BINDING, GL_THREAD_ARRAY_BUFFER_BINDING)!=0;
 }
 
 GLboolean ELEMENT_ARRAY_BUFFER() {
-    return marshalGet(GL_ELEMENT_ARRAY_BUFFER_BINDING)!=0;
+    return marshalGetBinding(GL_ELEMENT_ARRAY_BUFFER_BINDING, GL_THREAD_ELEMENT_ARRAY_BUFFER_BINDING)!=0;
 }
 
 GLboolean PIXEL_UNPACK_BUFFER() {
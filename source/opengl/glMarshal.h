@@ -73,19 +73,6 @@ GLvoid* marshalPixels(CPU* cpu, U32 is3d, GLsizei width, GLsizei height, GLsizei
 
 #define marshalPixel(cpu, format, type, pixel) (GLvoid*)getPhysicalAddress(pixel, 0)
 
-#define updateVertexPointers(cpu, count)
-#define marshalVetextPointer(cpu, size, type, stride, ptr) marshalp_and_check_array_buffer(cpu, 0, ptr, 0)
-#define marshalNormalPointer(cpu, type, stride, ptr) marshalp_and_check_array_buffer(cpu, 0, ptr, 0)
-#define marshalColorPointer(cpu, size, type, stride, ptr) marshalp_and_check_array_buffer(cpu, 0, ptr, 0)
-#define marshalIndexPointer(cpu, type, stride, ptr) marshalp_and_check_array_buffer(cpu, 0, ptr, 0)
-#define marshalTexCoordPointer(cpu, size, type, stride, ptr) marshalp_and_check_array_buffer(cpu, 0, ptr, 0)
-#define marshalEdgeFlagPointer(cpu, stride, ptr) marshalp_and_check_array_buffer(cpu, 0, ptr, 0)
-#define marshalFogPointer(cpu, type, stride, ptr) marshalp_and_check_array_buffer(cpu, 0, ptr, 0)
-#define marshalSecondaryColorPointer(cpu, size, type, stride, ptr) marshalp_and_check_array_buffer(cpu, 0, ptr, 0)
-#define marshalSecondaryColorPointerEXT(cpu, size, type, stride, ptr) marshalp_and_check_array_buffer(cpu, 0, ptr, 0)
-#define marshalEdgeFlagPointerEXT(cpu, stride, count, ptr) (GLboolean*)marshalp_and_check_array_buffer(cpu, 0, ptr, 0)
-#define marshalFogPointerEXT(cpu, type, stride, ptr) marshalp_and_check_array_buffer(cpu, 0, ptr, 0)
-
 #define getDataSize(x) 1
 #define components_in_format(format) 0
 #define marshalGetColorTableWidth(target) 0
@@ -186,18 +173,6 @@ GLvoid* marshalPixel(CPU* cpu, GLenum format, GLenum type, U32 pixel);
 GLvoid* marshalPixels(CPU* cpu, U32 is3d, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type,  U32 pixels);
 void marshalBackPixels(CPU* cpu, U32 is3d, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, U32 address, GLvoid* pixels);
 
-void updateVertexPointers(CPU* cpu, U32 count);
-GLvoid* marshalVetextPointer(CPU* cpu, GLint size, GLenum type, GLsizei stride, U32 ptr);
-GLvoid* marshalNormalPointer(CPU* cpu, GLenum type, GLsizei stride, U32 ptr);
-GLvoid* marshalColorPointer(CPU* cpu, GLint size, GLenum type, GLsizei stride, U32 ptr);
-GLvoid* marshalIndexPointer(CPU* cpu,  GLenum type, GLsizei stride, U32 ptr);
-GLvoid* marshalTexCoordPointer(CPU* cpu, GLint size, GLenum type, GLsizei stride, U32 ptr);
-GLvoid* marshalEdgeFlagPointer(CPU* cpu, GLsizei stride, U32 ptr);
-const GLboolean* marshalEdgeFlagPointerEXT(CPU* cpu, GLsizei stride, GLsizei count, U32 ptr);
-GLvoid* marshalSecondaryColorPointer(CPU* cpu, GLint size, GLenum type, GLsizei stride, U32 ptr);
-GLvoid* marshalSecondaryColorPointerEXT(CPU* cpu, GLint size, GLenum type, GLsizei stride, U32 ptr);
-GLvoid* marshalFogPointer(CPU* cpu, GLenum type, GLsizei stride, U32 ptr);
-GLvoid* marshalFogPointerEXT(CPU* cpu, GLenum type, GLsizei stride, U32 ptr);
 const GLvoid* marshalInterleavedPointer(CPU* cpu, GLenum format, GLsizei stride, U32 ptr);
 
 U32 getDataSize(GLenum type);
@@ -215,6 +190,25 @@ GLint components_in_format(GLenum format );
 GLsizei marshalHistogramWidth(GLenum target);
 #endif
 
+// Client arrays are refreshed by the draw calls with the range of vertices they use, with the 64-bit MMU they are
+// used where they are once the range has been checked.  The draws a GLThread can queue use the ForDraw versions.
+void updateVertexPointers(CPU* cpu, U32 first, U32 count);
+void updateVertexPointersForDraw(CPU* cpu, U32 first, U32 count);
+void updateVertexPointersForElements(CPU* cpu, GLsizei count, GLenum type, U32 indices);
+const GLvoid* marshalIndices(CPU* cpu, GLsizei count, GLenum type, U32 indices);
+void glIndexRange(const void* indices, GLenum type, U32 count, U32* low, U32* high);
+GLvoid* marshalVetextPointer(CPU* cpu, GLint size, GLenum type, GLsizei stride, U32 ptr);
+GLvoid* marshalNormalPointer(CPU* cpu, GLenum type, GLsizei stride, U32 ptr);
+GLvoid* marshalColorPointer(CPU* cpu, GLint size, GLenum type, GLsizei stride, U32 ptr);
+GLvoid* marshalIndexPointer(CPU* cpu,  GLenum type, GLsizei stride, U32 ptr);
+GLvoid* marshalTexCoordPointer(CPU* cpu, GLint size, GLenum type, GLsizei stride, U32 ptr);
+GLvoid* marshalEdgeFlagPointer(CPU* cpu, GLsizei stride, U32 ptr);
+const GLboolean* marshalEdgeFlagPointerEXT(CPU* cpu, GLsizei stride, GLsizei count, U32 ptr);
+GLvoid* marshalSecondaryColorPointer(CPU* cpu, GLint size, GLenum type, GLsizei stride, U32 ptr);
+GLvoid* marshalSecondaryColorPointerEXT(CPU* cpu, GLint size, GLenum type, GLsizei stride, U32 ptr);
+GLvoid* marshalFogPointer(CPU* cpu, GLenum type, GLsizei stride, U32 ptr);
+GLvoid* marshalFogPointerEXT(CPU* cpu, GLenum type, GLsizei stride, U32 ptr);
+
 GLintptr* marshalip(CPU* cpu, U32 address, U32 count);
 GLintptr* marshal2ip(CPU* cpu, U32 address, U32 count);
 
@@ -817,7 +817,7 @@ U32 marshalGetActiveAtomicCountersCount(U32 program, U32 bufferIndex) {
     GLint i=0;
     
     if (ext_glGetActiveAtomicCounterBufferiv)
-        ext_glGetActiveAtomicCounterBufferiv(program, bufferIndex, GL_ATOMIC_COUNTER_BUFFER_ACTIVE_ATOMIC_COUNTERS, &i);
+        GL_FUNC(ext_glGetActiveAtomicCounterBufferiv)(program, bufferIndex, GL_ATOMIC_COUNTER_BUFFER_ACTIVE_ATOMIC_COUNTERS, &i);
     return i;
 }
 
@@ -828,7 +828,7 @@ U32 marshalGetActiveAtomicCountersCount(U32 program, U32 bufferIndex) {
 U32 marshalGetCompatibleSubroutinesCount(U32 program, U32 shadertype, U32 index) {
     GLint i=0;
     if (ext_glGetActiveSubroutineUniformiv)
-        ext_glGetActiveSubroutineUniformiv(program, shadertype, index, GL_NUM_COMPATIBLE_SUBROUTINES, &i);
+        GL_FUNC(ext_glGetActiveSubroutineUniformiv)(program, shadertype, index, GL_NUM_COMPATIBLE_SUBROUTINES, &i);
     return i;
 }
 
@@ -839,14 +839,14 @@ U32 marshalGetCompatibleSubroutinesCount(U32 program, U32 shadertype, U32 index)
 U32 marshalGetUniformBlockActiveUnformsCount(U32 program, U32 uniformBlockIndex) {
     GLint i=0;
     if (ext_glGetActiveUniformBlockiv)
-        ext_glGetActiveUniformBlockiv(program, uniformBlockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &i);
+        GL_FUNC(ext_glGetActiveUniformBlockiv)(program, uniformBlockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &i);
     return i;
 }
 
 U32 marshalGetColorTableWidth(U32 target) {
     GLint i=0;
     if (ext_glGetColorTableParameteriv)
-        ext_glGetColorTableParameteriv(target, GL_COLOR_TABLE_WIDTH, &i);
+        GL_FUNC(ext_glGetColorTableParameteriv)(target, GL_COLOR_TABLE_WIDTH, &i);
     return i;
 }
 
@@ -857,42 +857,42 @@ U32 marshalGetColorTableWidth(U32 target) {
 U32 marshalGetColorTableWidthEXT(U32 target) {
     GLint i=0;
     if (ext_glGetColorTableParameterivEXT)
-        ext_glGetColorTableParameterivEXT(target, GL_COLOR_TABLE_WIDTH_EXT, &i);
+        GL_FUNC(ext_glGetColorTableParameterivEXT)(target, GL_COLOR_TABLE_WIDTH_EXT, &i);
     return i;
 }
 
 U32 marshalGetColorTableWidthSGI(U32 target) {
     GLint i=0;
     if (ext_glGetColorTableParameterivSGI)
-        ext_glGetColorTableParameterivSGI(target, GL_COLOR_TABLE_WIDTH_SGI, &i);
+        GL_FUNC(ext_glGetColorTableParameterivSGI)(target, GL_COLOR_TABLE_WIDTH_SGI, &i);
     return i;
 }
 
 U32 marshalGetCompressedImageSize(GLenum target, GLint level) {
     GLint i=0;
     if (ext_glGetTextureLevelParameteriv)
-        ext_glGetTextureLevelParameteriv(target, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &i);
+        GL_FUNC(ext_glGetTextureLevelParameteriv)(target, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &i);
     return i;
 }
 
 U32 marshalGetCompressedImageSizeARB(GLenum target, GLint level) {
     GLint i=0;
     if (ext_glGetTextureLevelParameteriv)
-        ext_glGetTextureLevelParameteriv(target, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE_ARB, &i);
+        GL_FUNC(ext_glGetTextureLevelParameteriv)(target, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE_ARB, &i);
     return i;
 }
 
 U32 marshalGetCompressedMultiImageSizeEXT(GLenum texunit, GLenum target, GLint level) {
     GLint i=0;
     if (ext_glGetMultiTexLevelParameterivEXT)
-        ext_glGetMultiTexLevelParameterivEXT(texunit, target, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &i);
+        GL_FUNC(ext_glGetMultiTexLevelParameterivEXT)(texunit, target, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &i);
     return i;
 }
 
 U32 marshalGetCompressedTextureSizeEXT(GLuint texture, GLenum target, GLint lod) {
     GLint i=0;
     if (ext_glGetTextureLevelParameterivEXT)
-        ext_glGetTextureLevelParameterivEXT(texture, target, lod, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &i);
+        GL_FUNC(ext_glGetTextureLevelParameterivEXT)(texture, target, lod, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &i);
     return i;
 }
 
@@ -900,7 +900,7 @@ U32 marshalGetConvolutionWidth(U32 target) {
     GLint i = 0;
 
     if (ext_glGetConvolutionParameteriv) {
-        ext_glGetConvolutionParameteriv(target, GL_CONVOLUTION_WIDTH, &i);
+        GL_FUNC(ext_glGetConvolutionParameteriv)(target, GL_CONVOLUTION_WIDTH, &i);
     }
     return i;
 }
@@ -909,7 +909,7 @@ U32 marshalGetConvolutionHeight(U32 target) {
     GLint i = 0;
 
     if (ext_glGetConvolutionParameteriv) {
-        ext_glGetConvolutionParameteriv(target, GL_CONVOLUTION_HEIGHT, &i);
+        GL_FUNC(ext_glGetConvolutionParameteriv)(target, GL_CONVOLUTION_HEIGHT, &i);
     }
     return i;
 }
@@ -946,7 +946,7 @@ GLsizei floatPerTransformList(GLenum transformType)
 GLsizei marshalHistogramWidth(GLenum target) {
     GLint result = 0;
     if (ext_glGetHistogramParameteriv) {
-        ext_glGetHistogramParameteriv(target, GL_HISTOGRAM_WIDTH, &result);
+        GL_FUNC(ext_glGetHistogramParameteriv)(target, GL_HISTOGRAM_WIDTH, &result);
     }
     return result;
 }
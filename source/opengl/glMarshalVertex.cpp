@@ -5,121 +5,486 @@
 #include "glcommon.h"
 #include "glMarshal.h"
 
-#ifndef BOXEDWINE_64BIT_MMU
-U32 updateVertexPointer(CPU* cpu, OpenGLVetexPointer* p, U32 count) {
-    if (ARRAY_BUFFER()) {
-        klog("updateVertexPointer might have failed");
-        return 0;
-    }
-    if (p->ptr) {        
-        U32 datasize = count * p->size * (p->stride?p->stride:getDataSize(p->type));    
-        U32 available = K_PAGE_SIZE - (p->ptr & K_PAGE_MASK) + (1 << K_PAGE_SHIFT);
+#include "../../lib/simde/simde/x86/sse2.h"
 
-#ifndef UNALIGNED_MEMORY
-        if (count == 0 || available > datasize) {
-            if (p->marshal_size) {
-                free(p->marshal);
-            }            
-            p->marshal = getPhysicalAddress(p->ptr, (datasize?datasize:available));
-            p->marshal_size = 0;
-            
-            if (p->marshal) {
-                if (p->refreshEachCall)
-                    return 1; 
-                // the datasize is still < available so we don't need to marshal the pointer
-                return 0;
+// low and high must already be set, they are only lowered/raised by what is found
+void glIndexRange(const void* indices, GLenum type, U32 count, U32* low, U32* high) {
+    U32 i = 0;
+    U32 lo = *low;
+    U32 hi = *high;
+
+    if (type == GL_UNSIGNED_BYTE) {
+        const U8* p = (const U8*)indices;
+        if (count >= 16) {
+            simde__m128i vmin = simde_mm_set1_epi8((char)0xFF);
+            simde__m128i vmax = simde_mm_setzero_si128();
+            for (; i + 16 <= count; i += 16) {
+                simde__m128i v = simde_mm_loadu_si128((const simde__m128i*)(p + i));
+                vmin = simde_mm_min_epu8(vmin, v);
+                vmax = simde_mm_max_epu8(vmax, v);
+            }
+            U8 mins[16], maxs[16];
+            simde_mm_storeu_si128((simde__m128i*)mins, vmin);
+            simde_mm_storeu_si128((simde__m128i*)maxs, vmax);
+            for (U32 j = 0; j < 16; j++) {
+                lo = std::min(lo, (U32)mins[j]);
+                hi = std::max(hi, (U32)maxs[j]);
             }
         }
-#endif
-        if (count == 0) {
-            datasize = available; // :TODO: should this be capped at all?
+        for (; i < count; i++) {
+            lo = std::min(lo, (U32)p[i]);
+            hi = std::max(hi, (U32)p[i]);
         }
-        if (p->marshal_size < datasize) {
-            if (p->marshal_size) {
-                delete[] p->marshal;
+    } else if (type == GL_UNSIGNED_SHORT) {
+        const U16* p = (const U16*)indices;
+        if (count >= 8) {
+            // SSE2 only has signed 16-bit min/max, flipping the top bit keeps the order
+            simde__m128i bias = simde_mm_set1_epi16((short)0x8000);
+            simde__m128i vmin = simde_mm_set1_epi16(0x7FFF);
+            simde__m128i vmax = simde_mm_set1_epi16((short)0x8000);
+            for (; i + 8 <= count; i += 8) {
+                simde__m128i v = simde_mm_xor_si128(simde_mm_loadu_si128((const simde__m128i*)(p + i)), bias);
+                vmin = simde_mm_min_epi16(vmin, v);
+                vmax = simde_mm_max_epi16(vmax, v);
+            }
+            U16 mins[8], maxs[8];
+            simde_mm_storeu_si128((simde__m128i*)mins, simde_mm_xor_si128(vmin, bias));
+            simde_mm_storeu_si128((simde__m128i*)maxs, simde_mm_xor_si128(vmax, bias));
+            for (U32 j = 0; j < 8; j++) {
+                lo = std::min(lo, (U32)mins[j]);
+                hi = std::max(hi, (U32)maxs[j]);
             }
-            p->marshal = new unsigned char[datasize];
-            p->marshal_size = datasize;
         }
-        memcopyToNative(p->ptr, p->marshal, datasize);
-    } else {
-        if (p->marshal_size) {
-            free(p->marshal);
-            p->marshal_size = 0;
+        for (; i < count; i++) {
+            lo = std::min(lo, (U32)p[i]);
+            hi = std::max(hi, (U32)p[i]);
+        }
+    } else if (type == GL_UNSIGNED_INT) {
+        const U32* p = (const U32*)indices;
+        if (count >= 4) {
+            // no 32-bit min/max in SSE2, compare signed with the top bit flipped and blend
+            simde__m128i bias = simde_mm_set1_epi32((int)0x80000000);
+            simde__m128i vmin = simde_mm_set1_epi32(0x7FFFFFFF);
+            simde__m128i vmax = simde_mm_set1_epi32((int)0x80000000);
+            for (; i + 4 <= count; i += 4) {
+                simde__m128i v = simde_mm_xor_si128(simde_mm_loadu_si128((const simde__m128i*)(p + i)), bias);
+                simde__m128i less = simde_mm_cmpgt_epi32(vmin, v);
+                vmin = simde_mm_or_si128(simde_mm_and_si128(less, v), simde_mm_andnot_si128(less, vmin));
+                simde__m128i greater = simde_mm_cmpgt_epi32(v, vmax);
+                vmax = simde_mm_or_si128(simde_mm_and_si128(greater, v), simde_mm_andnot_si128(greater, vmax));
+            }
+            U32 mins[4], maxs[4];
+            simde_mm_storeu_si128((simde__m128i*)mins, simde_mm_xor_si128(vmin, bias));
+            simde_mm_storeu_si128((simde__m128i*)maxs, simde_mm_xor_si128(vmax, bias));
+            for (U32 j = 0; j < 4; j++) {
+                lo = std::min(lo, mins[j]);
+                hi = std::max(hi, maxs[j]);
+            }
+        }
+        for (; i < count; i++) {
+            lo = std::min(lo, p[i]);
+            hi = std::max(hi, p[i]);
+        }
+    }
+    *low = lo;
+    *high = hi;
+}
+
+static U32 getIndexSize(GLenum type) {
+    switch (type) {
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    case GL_UNSIGNED_SHORT:
+        return 2;
+    case GL_UNSIGNED_INT:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+static U32 getVertexDataSize(GLenum type) {
+    switch (type) {
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+    case GL_HALF_FLOAT:
+        return 2;
+    case GL_DOUBLE:
+        return 8;
+    default:
+        return 4;
+    }
+}
+
+// the bytes, from p->ptr, that count vertices starting at first read
+static bool getVertexRange(OpenGLVetexPointer* p, U32 first, U32 count, U32* start, U32* len) {
+    U64 elementSize = (U64)(p->size == GL_BGRA ? 4 : p->size) * getVertexDataSize(p->type);
+    U64 stride = p->stride ? (U64)p->stride : elementSize;
+    U64 begin = (U64)p->ptr + (U64)first * stride;
+    U64 end = begin + (U64)(count - 1) * stride + elementSize;
+
+    if (!count || !elementSize || begin >= 0x100000000l) {
+        return false;
+    }
+    if (end > 0x100000000l) {
+        end = 0x100000000l;
+    }
+    *start = (U32)(begin - p->ptr);
+    *len = (U32)(end - begin);
+    return true;
+}
+
+static U8* getVertexBuffer(OpenGLVetexPointer* p, U32 len) {
+    if (p->marshal_size < len) {
+        if (p->buffer) {
+            delete[] p->buffer;
         }
-        p->marshal = (U8*)(uintptr_t)p->ptr;
+        p->marshal_size = std::max(len, p->marshal_size * 2);
+        p->buffer = new U8[p->marshal_size];
+    }
+    return p->buffer;
+}
+
+static U32 setVertexMarshal(OpenGLVetexPointer* p, U8* marshal) {
+    if (p->marshal == marshal) {
+        return 0;
     }
+    p->marshal = marshal;
     return 1;
 }
 
-void updateVertexPointers(CPU* cpu, U32 count) {    
+// GL doesn't read the array until something is drawn, the draw calls refresh the pointer with the range they use
+static GLvoid* setVertexPointer(OpenGLVetexPointer* p) {
+#ifdef BOXEDWINE_64BIT_MMU
+    setVertexMarshal(p, getPhysicalAddress(p->ptr, 0));
+#else
+    setVertexMarshal(p, getPhysicalReadAddress(p->ptr, 1));
+#endif
+    return p->marshal;
+}
+
+#ifdef BOXEDWINE_64BIT_MMU
+// The array is used where it is, after checking that every page GL will read is readable so that the host doesn't
+// crash.  The check is remembered until the emulated memory is remapped or protected again.
+static U32 updateVertexPointer(CPU* cpu, OpenGLVetexPointer* p, U32 first, U32 count) {
+    U32 start = 0;
+    U32 len = 0;
+
+    if (!p->ptr) {
+        return setVertexMarshal(p, NULL);
+    }
+    if (!getVertexRange(p, first, count, &start, &len)) {
+        return setVertexMarshal(p, getPhysicalAddress(p->ptr, 0));
+    }
+    Memory* memory = cpu->thread->memory;
+    if (p->checkedPtr != p->ptr || p->checkedGeneration != memory->protectionGeneration || start < p->checkedStart || start + len > p->checkedEnd) {
+        U32 address = p->ptr + start;
+        if (!memory->isValidReadAddress(address, len)) {
+            // GL would fault on the host, give it a copy with zeros where the guest can't read
+            klog("client array at %X (%d bytes) is not readable", address, len);
+            U8* buffer = getVertexBuffer(p, len);
+            U32 done = 0;
+            while (done < len) {
+                U32 todo = std::min(len - done, K_PAGE_SIZE - ((address + done) & K_PAGE_MASK));
+                if (memory->isValidReadAddress(address + done, todo)) {
+                    memcpy(buffer + done, getPhysicalAddress(address + done, todo), todo);
+                } else {
+                    memset(buffer + done, 0, todo);
+                }
+                done += todo;
+            }
+            glProfileMarshaled(len);
+            return setVertexMarshal(p, (U8*)((uintptr_t)buffer - start));
+        }
+        getPhysicalAddress(address, len); // lazy file pages are loaded here, GL won't fault them in
+        p->checkedPtr = p->ptr;
+        p->checkedGeneration = memory->protectionGeneration;
+        p->checkedStart = start;
+        p->checkedEnd = start + len;
+    }
+    return setVertexMarshal(p, getPhysicalAddress(p->ptr, 0));
+}
+#else
+// The soft MMU can only hand GL a pointer to its memory if what is read doesn't cross a page, otherwise just the
+// vertices that are drawn are copied.
+static U32 updateVertexPointer(CPU* cpu, OpenGLVetexPointer* p, U32 first, U32 count) {
+    U32 start = 0;
+    U32 len = 0;
+
+    if (!p->ptr) {
+        return setVertexMarshal(p, NULL);
+    }
+    if (!getVertexRange(p, first, count, &start, &len)) {
+        return setVertexMarshal(p, NULL);
+    }
+#ifndef UNALIGNED_MEMORY
+    U8* ram = getPhysicalAddress(p->ptr + start, len);
+    if (ram) {
+        return setVertexMarshal(p, (U8*)((uintptr_t)ram - start));
+    }
+#endif
+    U8* buffer = getVertexBuffer(p, len);
+    memcopyToNative(p->ptr + start, buffer, len);
+    glProfileMarshaled(len);
+    return setVertexMarshal(p, (U8*)((uintptr_t)buffer - start));
+}
+#endif
+
+void updateVertexPointers(CPU* cpu, U32 first, U32 count) {    
+    if (!count) {
+        return;
+    }
     if (cpu->thread->glVertextPointer.refreshEachCall) {        
-        if (updateVertexPointer(cpu, &cpu->thread->glVertextPointer, count))
+        if (updateVertexPointer(cpu, &cpu->thread->glVertextPointer, first, count))
             GL_FUNC(pglVertexPointer)(cpu->thread->glVertextPointer.size, cpu->thread->glVertextPointer.type, cpu->thread->glVertextPointer.stride, cpu->thread->glVertextPointer.marshal);
     }
     
     if (cpu->thread->glNormalPointer.refreshEachCall) {
-        if (updateVertexPointer(cpu, &cpu->thread->glNormalPointer, count))
+        if (updateVertexPointer(cpu, &cpu->thread->glNormalPointer, first, count))
             GL_FUNC(pglNormalPointer)(cpu->thread->glNormalPointer.type, cpu->thread->glNormalPointer.stride, cpu->thread->glNormalPointer.marshal);
     }
 
 #ifndef DISABLE_GL_EXTENSIONS
     if (cpu->thread->glFogPointer.refreshEachCall) {
-        if (updateVertexPointer(cpu, &cpu->thread->glFogPointer, count)) {
+        if (updateVertexPointer(cpu, &cpu->thread->glFogPointer, first, count)) {
             if (ext_glFogCoordPointer)
-                ext_glFogCoordPointer(cpu->thread->glFogPointer.type, cpu->thread->glFogPointer.stride, cpu->thread->glFogPointer.marshal);
+                GL_FUNC(ext_glFogCoordPointer)(cpu->thread->glFogPointer.type, cpu->thread->glFogPointer.stride, cpu->thread->glFogPointer.marshal);
         }
     }
 
     if (cpu->thread->glFogPointerEXT.refreshEachCall) {
-        if (updateVertexPointer(cpu, &cpu->thread->glFogPointerEXT, count)) {
+        if (updateVertexPointer(cpu, &cpu->thread->glFogPointerEXT, first, count)) {
             if (ext_glFogCoordPointerEXT)
-                ext_glFogCoordPointerEXT(cpu->thread->glFogPointerEXT.type, cpu->thread->glFogPointerEXT.stride, cpu->thread->glFogPointerEXT.marshal);
+                GL_FUNC(ext_glFogCoordPointerEXT)(cpu->thread->glFogPointerEXT.type, cpu->thread->glFogPointerEXT.stride, cpu->thread->glFogPointerEXT.marshal);
         }
     }
 
     if (cpu->thread->glSecondaryColorPointer.refreshEachCall) {
-        if (updateVertexPointer(cpu, &cpu->thread->glSecondaryColorPointer, count)) {
+        if (updateVertexPointer(cpu, &cpu->thread->glSecondaryColorPointer, first, count)) {
             if (ext_glSecondaryColorPointer)
-                ext_glSecondaryColorPointer(cpu->thread->glSecondaryColorPointer.size, cpu->thread->glSecondaryColorPointer.type, cpu->thread->glSecondaryColorPointer.stride, cpu->thread->glSecondaryColorPointer.marshal);
+                GL_FUNC(ext_glSecondaryColorPointer)(cpu->thread->glSecondaryColorPointer.size, cpu->thread->glSecondaryColorPointer.type, cpu->thread->glSecondaryColorPointer.stride, cpu->thread->glSecondaryColorPointer.marshal);
         }
     }
 
     if (cpu->thread->glSecondaryColorPointerEXT.refreshEachCall) {
-        if (updateVertexPointer(cpu, &cpu->thread->glSecondaryColorPointerEXT, count)) {
+        if (updateVertexPointer(cpu, &cpu->thread->glSecondaryColorPointerEXT, first, count)) {
             if (ext_glSecondaryColorPointerEXT)
-                ext_glSecondaryColorPointerEXT(cpu->thread->glSecondaryColorPointerEXT.size, cpu->thread->glSecondaryColorPointerEXT.type, cpu->thread->glSecondaryColorPointerEXT.stride, cpu->thread->glSecondaryColorPointerEXT.marshal);
+                GL_FUNC(ext_glSecondaryColorPointerEXT)(cpu->thread->glSecondaryColorPointerEXT.size, cpu->thread->glSecondaryColorPointerEXT.type, cpu->thread->glSecondaryColorPointerEXT.stride, cpu->thread->glSecondaryColorPointerEXT.marshal);
         }
     }
 
     if (cpu->thread->glEdgeFlagPointerEXT.refreshEachCall) {
-        if (updateVertexPointer(cpu, &cpu->thread->glEdgeFlagPointerEXT, count)) {
+        if (updateVertexPointer(cpu, &cpu->thread->glEdgeFlagPointerEXT, first, count)) {
             if (ext_glEdgeFlagPointerEXT)
-                ext_glEdgeFlagPointerEXT(cpu->thread->glEdgeFlagPointerEXT.stride, cpu->thread->glEdgeFlagPointerEXT.count, cpu->thread->glEdgeFlagPointerEXT.marshal);
+                GL_FUNC(ext_glEdgeFlagPointerEXT)(cpu->thread->glEdgeFlagPointerEXT.stride, cpu->thread->glEdgeFlagPointerEXT.count, cpu->thread->glEdgeFlagPointerEXT.marshal);
         }
     }
 #endif
     if (cpu->thread->glColorPointer.refreshEachCall) {
-        if (updateVertexPointer(cpu, &cpu->thread->glColorPointer, count))
+        if (updateVertexPointer(cpu, &cpu->thread->glColorPointer, first, count))
             GL_FUNC(pglColorPointer)(cpu->thread->glColorPointer.size, cpu->thread->glColorPointer.type, cpu->thread->glColorPointer.stride, cpu->thread->glColorPointer.marshal);
     }    
     
     if (cpu->thread->glIndexPointer.refreshEachCall) {
-        if (updateVertexPointer(cpu, &cpu->thread->glIndexPointer, count))
+        if (updateVertexPointer(cpu, &cpu->thread->glIndexPointer, first, count))
             GL_FUNC(pglIndexPointer)(cpu->thread->glIndexPointer.type, cpu->thread->glIndexPointer.stride, cpu->thread->glIndexPointer.marshal);
     }
     
     if (cpu->thread->glTexCoordPointer.refreshEachCall) {
-        if (updateVertexPointer(cpu, &cpu->thread->glTexCoordPointer, count))
+        if (updateVertexPointer(cpu, &cpu->thread->glTexCoordPointer, first, count))
             GL_FUNC(pglTexCoordPointer)(cpu->thread->glTexCoordPointer.size, cpu->thread->glTexCoordPointer.type, cpu->thread->glTexCoordPointer.stride, cpu->thread->glTexCoordPointer.marshal);
     }
     
     if (cpu->thread->glEdgeFlagPointer.refreshEachCall) {
-        if (updateVertexPointer(cpu, &cpu->thread->glEdgeFlagPointer, count))
+        if (updateVertexPointer(cpu, &cpu->thread->glEdgeFlagPointer, first, count))
             GL_FUNC(pglEdgeFlagPointer)(cpu->thread->glEdgeFlagPointer.stride, cpu->thread->glEdgeFlagPointer.marshal);
     }
 }
 
+// the render thread sets the arrays of a queued draw with these
+static void setVertexArray(const GLThreadClientArray* array, const void* p) {
+    pglVertexPointer(array->size, array->type, array->stride, p);
+}
+
+static void setNormalArray(const GLThreadClientArray* array, const void* p) {
+    pglNormalPointer(array->type, array->stride, p);
+}
+
+#ifndef DISABLE_GL_EXTENSIONS
+static void setFogArray(const GLThreadClientArray* array, const void* p) {
+    if (ext_glFogCoordPointer)
+        ext_glFogCoordPointer(array->type, array->stride, p);
+}
+
+static void setFogArrayEXT(const GLThreadClientArray* array, const void* p) {
+    if (ext_glFogCoordPointerEXT)
+        ext_glFogCoordPointerEXT(array->type, array->stride, p);
+}
+
+static void setSecondaryColorArray(const GLThreadClientArray* array, const void* p) {
+    if (ext_glSecondaryColorPointer)
+        ext_glSecondaryColorPointer(array->size, array->type, array->stride, p);
+}
+
+static void setSecondaryColorArrayEXT(const GLThreadClientArray* array, const void* p) {
+    if (ext_glSecondaryColorPointerEXT)
+        ext_glSecondaryColorPointerEXT(array->size, array->type, array->stride, p);
+}
+
+static void setEdgeFlagArrayEXT(const GLThreadClientArray* array, const void* p) {
+    if (ext_glEdgeFlagPointerEXT)
+        ext_glEdgeFlagPointerEXT(array->stride, array->count, (const GLboolean*)p);
+}
+#endif
+
+static void setColorArray(const GLThreadClientArray* array, const void* p) {
+    pglColorPointer(array->size, array->type, array->stride, p);
+}
+
+static void setIndexArray(const GLThreadClientArray* array, const void* p) {
+    pglIndexPointer(array->type, array->stride, p);
+}
+
+static void setTexCoordArray(const GLThreadClientArray* array, const void* p) {
+    pglTexCoordPointer(array->size, array->type, array->stride, p);
+}
+
+static void setEdgeFlagArray(const GLThreadClientArray* array, const void* p) {
+    pglEdgeFlagPointer(array->stride, p);
+}
+
+// The range the draw reads is found and checked like it is for a draw that waits, then copied when the draw is queued.
+// Returns false if the range isn't known.
+static bool snapshotVertexPointer(CPU* cpu, GLThread* glThread, OpenGLVetexPointer* p, GLThreadClientArraySet set, U32 first, U32 count) {
+    GLThreadClientArray array;
+
+    if (!p->refreshEachCall) {
+        return true;
+    }
+    if (!p->ptr || !getVertexRange(p, first, count, &array.start, &array.len)) {
+        return false;
+    }
+    updateVertexPointer(cpu, p, first, count);
+    array.set = set;
+    array.size = p->size;
+    array.type = p->type;
+    array.stride = p->stride;
+    array.count = p->count;
+    array.data = p->marshal + array.start;
+    array.pointer = p->marshal;
+    array.offset = 0;
+    glThread->addClientArray(array);
+    glProfileMarshaled(array.len);
+    return true;
+}
+
+// With a GLThread the draw is queued with a copy of what it reads from each client array.  If that can't be done
+// the arrays are set where they are and the draw waits for the render thread.
+void updateVertexPointersForDraw(CPU* cpu, U32 first, U32 count) {
+    KThread* thread = cpu->thread;
+    GLThread* glThread = thread->glThread;
+
+    if (!glThread) {
+        updateVertexPointers(cpu, first, count);
+        return;
+    }
+    if (!thread->glUntrackedClientArrays) {
+        if (!count) {
+            return;
+        }
+        bool copied = snapshotVertexPointer(cpu, glThread, &thread->glVertextPointer, setVertexArray, first, count)
+            && snapshotVertexPointer(cpu, glThread, &thread->glNormalPointer, setNormalArray, first, count)
+#ifndef DISABLE_GL_EXTENSIONS
+            && snapshotVertexPointer(cpu, glThread, &thread->glFogPointer, setFogArray, first, count)
+            && snapshotVertexPointer(cpu, glThread, &thread->glFogPointerEXT, setFogArrayEXT, first, count)
+            && snapshotVertexPointer(cpu, glThread, &thread->glSecondaryColorPointer, setSecondaryColorArray, first, count)
+            && snapshotVertexPointer(cpu, glThread, &thread->glSecondaryColorPointerEXT, setSecondaryColorArrayEXT, first, count)
+            && snapshotVertexPointer(cpu, glThread, &thread->glEdgeFlagPointerEXT, setEdgeFlagArrayEXT, first, count)
+#endif
+            && snapshotVertexPointer(cpu, glThread, &thread->glColorPointer, setColorArray, first, count)
+            && snapshotVertexPointer(cpu, glThread, &thread->glIndexPointer, setIndexArray, first, count)
+            && snapshotVertexPointer(cpu, glThread, &thread->glTexCoordPointer, setTexCoordArray, first, count)
+            && snapshotVertexPointer(cpu, glThread, &thread->glEdgeFlagPointer, setEdgeFlagArray, first, count);
+        if (copied && glThread->getClientArrayBytes() <= GL_THREAD_MAX_CLIENT_ARRAY_BYTES) {
+            return;
+        }
+        glThread->setClientArraysInPlace();
+    }
+    updateVertexPointers(cpu, first, count);
+    // after updateVertexPointers, its gl*Pointer calls are synchronous and clear this
+    glThread->syncNextCall();
+}
+
+static bool hasClientArrays(KThread* thread) {
+    return thread->glVertextPointer.refreshEachCall || thread->glNormalPointer.refreshEachCall || thread->glFogPointer.refreshEachCall || thread->glFogPointerEXT.refreshEachCall || thread->glSecondaryColorPointer.refreshEachCall || thread->glSecondaryColorPointerEXT.refreshEachCall || thread->glEdgeFlagPointerEXT.refreshEachCall || thread->glColorPointer.refreshEachCall || thread->glIndexPointer.refreshEachCall || thread->glTexCoordPointer.refreshEachCall || thread->glEdgeFlagPointer.refreshEachCall;
+}
+
+// The vertices glDrawElements reads are found by scanning its indices.  If the indices are in a buffer object they
+// can't be read here, so like before the first count vertices are used.
+void updateVertexPointersForElements(CPU* cpu, GLsizei count, GLenum type, U32 indices) {
+    U32 indexSize = getIndexSize(type);
+    U32 low = 0xFFFFFFFF;
+    U32 high = 0;
+
+    if (count <= 0 || !hasClientArrays(cpu->thread)) {
+        updateVertexPointersForDraw(cpu, 0, 0);
+        return;
+    }
+    if (!indexSize || ELEMENT_ARRAY_BUFFER()) {
+        updateVertexPointersForDraw(cpu, 0, count);
+        return;
+    }
+    U32 len = (U32)count * indexSize;
+#ifdef BOXEDWINE_64BIT_MMU
+    if (!cpu->thread->memory->isValidReadAddress(indices, len)) {
+        updateVertexPointersForDraw(cpu, 0, count);
+        return;
+    }
+    glIndexRange(getPhysicalAddress(indices, len), type, count, &low, &high);
+#else
+    U32 done = 0;
+    while (done < len) {
+        U32 address = indices + done;
+        U32 todo = std::min(len - done, K_PAGE_SIZE - (address & K_PAGE_MASK));
+        U8* ram = ((address & (indexSize - 1)) == 0) ? getPhysicalReadAddress(address, todo) : NULL;
+        if (ram) {
+            glIndexRange(ram, type, todo / indexSize, &low, &high);
+            done += todo;
+        } else {
+            U32 index = (indexSize == 1) ? readb(address) : ((indexSize == 2) ? readw(address) : readd(address));
+            low = std::min(low, index);
+            high = std::max(high, index);
+            done += indexSize;
+        }
+    }
+#endif
+    updateVertexPointersForDraw(cpu, low, high - low + 1);
+}
+
+// With a GLThread the indices are copied into the draw's command, an offset into a buffer object is passed as it is
+const GLvoid* marshalIndices(CPU* cpu, GLsizei count, GLenum type, U32 indices) {
+    GLThread* glThread = cpu->thread->glThread;
+
+    if (ELEMENT_ARRAY_BUFFER()) {
+        if (glThread) {
+            glThread->recordMarshaled((const void*)(uintptr_t)indices, 0);
+        }
+        return (const GLvoid*)(uintptr_t)indices;
+    }
+    const GLvoid* result = marshalType(cpu, type, count, indices);
+#ifdef BOXEDWINE_64BIT_MMU
+    // used in place, so it wasn't recorded
+    U32 indexSize = getIndexSize(type);
+    if (glThread && result && count > 0 && indexSize && cpu->thread->memory->isValidReadAddress(indices, (U32)count * indexSize)) {
+        glThread->recordMarshaled(result, (U32)count * indexSize);
+    }
+#endif
+    return result;
+}
+
 GLvoid* marshalVetextPointer(CPU* cpu, GLint size, GLenum type, GLsizei stride, U32 ptr) {
     if (ARRAY_BUFFER()) {        
         cpu->thread->glVertextPointer.refreshEachCall = 0;
@@ -130,8 +495,7 @@ GLvoid* marshalVetextPointer(CPU* cpu, GLint size, GLenum type, GLsizei stride,
         cpu->thread->glVertextPointer.stride = stride;
         cpu->thread->glVertextPointer.ptr = ptr;
         cpu->thread->glVertextPointer.refreshEachCall = 1;
-        updateVertexPointer(cpu, &cpu->thread->glVertextPointer, 0);
-        return cpu->thread->glVertextPointer.marshal;
+        return setVertexPointer(&cpu->thread->glVertextPointer);
     }
 }
 
@@ -145,8 +509,7 @@ GLvoid* marshalNormalPointer(CPU* cpu, GLenum type, GLsizei stride, U32 ptr) {
         cpu->thread->glNormalPointer.stride = stride;
         cpu->thread->glNormalPointer.ptr = ptr;
         cpu->thread->glNormalPointer.refreshEachCall = 1;
-        updateVertexPointer(cpu, &cpu->thread->glNormalPointer, 0);
-        return cpu->thread->glNormalPointer.marshal;
+        return setVertexPointer(&cpu->thread->glNormalPointer);
     }
 }
 
@@ -160,8 +523,7 @@ GLvoid* marshalFogPointer(CPU* cpu, GLenum type, GLsizei stride, U32 ptr) {
         cpu->thread->glFogPointer.stride = stride;
         cpu->thread->glFogPointer.ptr = ptr;
         cpu->thread->glFogPointer.refreshEachCall = 1;
-        updateVertexPointer(cpu, &cpu->thread->glFogPointer, 0);
-        return cpu->thread->glFogPointer.marshal;
+        return setVertexPointer(&cpu->thread->glFogPointer);
     }
 }
 
@@ -174,9 +536,8 @@ GLvoid* marshalFogPointerEXT(CPU* cpu, GLenum type, GLsizei stride, U32 ptr) {
         cpu->thread->glFogPointerEXT.type = type;
         cpu->thread->glFogPointerEXT.stride = stride;
         cpu->thread->glFogPointerEXT.ptr = ptr;
-        cpu->thread->glFogPointerEXT.refreshEachCall = 0;
-        updateVertexPointer(cpu, &cpu->thread->glFogPointerEXT, 0);
-        return cpu->thread->glFogPointerEXT.marshal;
+        cpu->thread->glFogPointerEXT.refreshEachCall = 1;
+        return setVertexPointer(&cpu->thread->glFogPointerEXT);
     }
 }
 
@@ -190,8 +551,7 @@ GLvoid* marshalColorPointer(CPU* cpu, GLint size, GLenum type, GLsizei stride, U
         cpu->thread->glColorPointer.stride = stride;
         cpu->thread->glColorPointer.ptr = ptr;
         cpu->thread->glColorPointer.refreshEachCall = 1;
-        updateVertexPointer(cpu, &cpu->thread->glColorPointer, 0);
-        return cpu->thread->glColorPointer.marshal;
+        return setVertexPointer(&cpu->thread->glColorPointer);
     }
 }
 
@@ -205,8 +565,7 @@ GLvoid* marshalSecondaryColorPointer(CPU* cpu, GLint size, GLenum type, GLsizei
         cpu->thread->glSecondaryColorPointer.stride = stride;
         cpu->thread->glSecondaryColorPointer.ptr = ptr;
         cpu->thread->glSecondaryColorPointer.refreshEachCall = 1;
-        updateVertexPointer(cpu, &cpu->thread->glSecondaryColorPointer, 0);
-        return cpu->thread->glSecondaryColorPointer.marshal;
+        return setVertexPointer(&cpu->thread->glSecondaryColorPointer);
     }
 }
 
@@ -219,9 +578,8 @@ GLvoid* marshalSecondaryColorPointerEXT(CPU* cpu, GLint size, GLenum type, GLsiz
         cpu->thread->glSecondaryColorPointerEXT.type = type;
         cpu->thread->glSecondaryColorPointerEXT.stride = stride;
         cpu->thread->glSecondaryColorPointerEXT.ptr = ptr;
-        cpu->thread->glSecondaryColorPointerEXT.refreshEachCall = 0;
-        updateVertexPointer(cpu, &cpu->thread->glSecondaryColorPointerEXT, 0);
-        return cpu->thread->glSecondaryColorPointerEXT.marshal;
+        cpu->thread->glSecondaryColorPointerEXT.refreshEachCall = 1;
+        return setVertexPointer(&cpu->thread->glSecondaryColorPointerEXT);
     }
 }
 
@@ -235,8 +593,7 @@ GLvoid* marshalIndexPointer(CPU* cpu,  GLenum type, GLsizei stride, U32 ptr) {
         cpu->thread->glIndexPointer.stride = stride;
         cpu->thread->glIndexPointer.ptr = ptr;
         cpu->thread->glIndexPointer.refreshEachCall = 1;
-        updateVertexPointer(cpu, &cpu->thread->glIndexPointer, 0);
-        return cpu->thread->glIndexPointer.marshal;
+        return setVertexPointer(&cpu->thread->glIndexPointer);
     }
 }
 
@@ -250,8 +607,7 @@ GLvoid* marshalTexCoordPointer(CPU* cpu, GLint size, GLenum type, GLsizei stride
         cpu->thread->glTexCoordPointer.stride = stride;
         cpu->thread->glTexCoordPointer.ptr = ptr;
         cpu->thread->glTexCoordPointer.refreshEachCall = 1;
-        updateVertexPointer(cpu, &cpu->thread->glTexCoordPointer, 0);
-        return cpu->thread->glTexCoordPointer.marshal;
+        return setVertexPointer(&cpu->thread->glTexCoordPointer);
     }
 }
 
@@ -265,8 +621,7 @@ GLvoid* marshalEdgeFlagPointer(CPU* cpu, GLsizei stride, U32 ptr) {
         cpu->thread->glEdgeFlagPointer.stride = stride;
         cpu->thread->glEdgeFlagPointer.ptr = ptr;
         cpu->thread->glEdgeFlagPointer.refreshEachCall = 1;
-        updateVertexPointer(cpu, &cpu->thread->glEdgeFlagPointer, 0);
-        return cpu->thread->glEdgeFlagPointer.marshal;
+        return setVertexPointer(&cpu->thread->glEdgeFlagPointer);
     }
 }
 
@@ -279,13 +634,13 @@ const GLboolean* marshalEdgeFlagPointerEXT(CPU* cpu, GLsizei stride, GLsizei cou
         cpu->thread->glEdgeFlagPointerEXT.type = GL_BYTE;
         cpu->thread->glEdgeFlagPointerEXT.stride = stride;
         cpu->thread->glEdgeFlagPointerEXT.ptr = ptr;
-        cpu->thread->glEdgeFlagPointerEXT.refreshEachCall = 0;
+        cpu->thread->glEdgeFlagPointerEXT.refreshEachCall = 1;
         cpu->thread->glEdgeFlagPointerEXT.count = count;
-        updateVertexPointer(cpu, &cpu->thread->glEdgeFlagPointerEXT, 0);
-        return cpu->thread->glEdgeFlagPointerEXT.marshal;
+        return (const GLboolean*)setVertexPointer(&cpu->thread->glEdgeFlagPointerEXT);
     }
 }
 
+#ifndef BOXEDWINE_64BIT_MMU
 static bool interleavedHasColor(GLenum format) {
     switch (format) {
     case GL_C4UB_V2F:
@@ -351,7 +706,7 @@ const void* marshalInterleavedPointer(CPU* cpu, GLenum format, GLsizei stride, U
         cpu->thread->glInterleavedArray.stride = stride;
         cpu->thread->glInterleavedArray.ptr = ptr;
         cpu->thread->glInterleavedArray.refreshEachCall = 1;
-        updateVertexPointer(cpu, &cpu->thread->glInterleavedArray, 0);
+        updateVertexPointer(cpu, &cpu->thread->glInterleavedArray, 0, 0);
         return cpu->thread->glInterleavedArray.marshal;
     }
 }
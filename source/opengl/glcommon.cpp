@@ -143,7 +143,7 @@ void glcommon_glFeedbackBuffer(CPU* cpu) {
     GLenum type = ARG2;
 #ifdef BOXEDWINE_64BIT_MMU
     U32 buffer = ARG3; // GLfloat*
-    GL_FUNC(pglFeedbackBuffer)(size, type, (GLfloat*)getNativeAddress(cpu->thread->process->memory, buffer));
+    GL_FUNC(pglFeedbackBuffer)(size, type, (GLfloat*)getPhysicalWriteAddress(buffer, size * sizeof(GLfloat)));
 #else
     if (size > feedbackBufferSize) {
         if (feedbackBuffer) {
@@ -474,6 +474,9 @@ void glcommon_glInterleavedArrays(CPU* cpu) {
     GLenum format = ARG1;
     GLsizei stride = ARG2;
     U32 address = ARG3;
+    if (!ARRAY_BUFFER()) {
+        cpu->thread->glUntrackedClientArrays = true;
+    }
 #ifdef BOXEDWINE_64BIT_MMU
     GL_FUNC(pglInterleavedArrays)(format, stride, getNativeAddress(cpu->thread->process->memory, address));
 #else
@@ -540,6 +543,39 @@ void glcommon_glSamplePass(CPU* cpu) {
 
 static Int99Callback gl_callback[GL_FUNC_COUNT];
 
+// Each call in the batch is [word count][index][args...], anything an arg points to was copied into the batch
+// after the args by the guest.  ESP is pointed at the index while the call's callback runs, so the callback reads
+// its args with peek32 just like it does when the call was made with its own int 0x99.  Calls that return
+// something are never batched, so EAX doesn't matter.
+void callOpenGLBatch(CPU* cpu, U32 address, U32 count) {
+    U32 end = address + count * 4;
+    U32 esp = ESP;
+
+    while (address < end) {
+        U32 words = readd(address);
+        U32 index = readd(address + 4);
+        if (words < 2 || words > (end - address) / 4 || index >= int99CallbackSize || !int99Callback[index] || index == GLBatch) {
+            kpanic("callOpenGLBatch: bad call at %x, words=%d index=%d", address, words, index);
+        }
+        ESP = address + 4 - cpu->seg[SS].address;
+        if (glProfiling) {
+            GLProfileCall call;
+            glProfileBegin(call);
+            int99Callback[index](cpu);
+            glProfileEnd(index, call);
+        } else {
+            int99Callback[index](cpu);
+        }
+        address += words * 4;
+    }
+    ESP = esp;
+}
+
+// ARG1 is the address of the calls that the guest libGL has collected and ARG2 is how many words they use
+static void glcommon_glBatch(CPU* cpu) {
+    callOpenGLBatch(cpu, ARG1, ARG2);
+}
+
 Int99Callback* int99Callback;
 U32 int99CallbackSize;
 U32 lastGlCallTime;
@@ -559,6 +595,10 @@ void gl_init(const std::string& allowExtensions) {
 #define GL_EXT_FUNCTION(func, RET, PARAMS) gl_callback[func] = glcommon_gl##func;
 
 #include "glfunctions.h"      
+    gl_callback[GLBatch] = glcommon_glBatch;
+    if (KSystem::openglProfilePath.length()) {
+        glProfileStart(KSystem::openglProfilePath);
+    }
 }
 
 #else
@@ -572,13 +612,24 @@ void gl_init() {
 
 void callOpenGL(CPU* cpu, U32 index) {
 #ifdef BOXEDWINE_OPENGL
-    KNativeWindow::getNativeWindow()->preOpenGLCall(index);
+    std::shared_ptr<KNativeWindow> wnd = KNativeWindow::getNativeWindow();
+    if (wnd) {
+        wnd->preOpenGLCall(index);
+    }
     if (index < int99CallbackSize && int99Callback[index]) {
         lastGlCallTime = KSystem::getMilliesSinceStart();
-        int99Callback[index](cpu);
+        if (glProfiling) {
+            GLProfileCall call;
+            glProfileBegin(call);
+            int99Callback[index](cpu);
+            glProfileEnd(index, call);
+        } else {
+            int99Callback[index](cpu);
+        }
     } else 
 #endif
 {
         kpanic("Uknown int 99 call: %d", index);
     }
 }
+
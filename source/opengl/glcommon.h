@@ -22,6 +22,8 @@
 #ifdef BOXEDWINE_OPENGL
 #include "../../tools/opengl/gldef.h"
 #include <inttypes.h>
+#include "glthread.h"
+#include "glprofiler.h"
 
 //#define GL_LOG klog
 #define GL_LOG if (0) klog
@@ -30,7 +32,8 @@
 #define GL_FUNC(name) es_##name
 #include "es/esopengl.h"
 #else
-#define GL_FUNC(name) name
+// goes through the context's render thread when -glthread is used
+#define GL_FUNC(name) glThreadCall<glThreadIsSync(#name), glThreadChangesBindings(#name)>(name)
 #endif
 
 struct int2Float {
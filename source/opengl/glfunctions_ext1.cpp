@@ -1315,6 +1315,10 @@ void glcommon_glClearTexSubImage(CPU* cpu) {
 void glcommon_glClientActiveTexture(CPU* cpu) {
     if (!ext_glClientActiveTexture)
         kpanic("ext_glClientActiveTexture is NULL");
+    // the draw calls only refresh the arrays of the unit that was last used
+    if (ARG1 != GL_TEXTURE0) {
+        cpu->thread->glUntrackedClientArrays = true;
+    }
     {
     GL_FUNC(ext_glClientActiveTexture)(ARG1);
     GL_LOG ("glClientActiveTexture GLenum texture=%d",ARG1);
@@ -1323,6 +1327,10 @@ void glcommon_glClientActiveTexture(CPU* cpu) {
 void glcommon_glClientActiveTextureARB(CPU* cpu) {
     if (!ext_glClientActiveTextureARB)
         kpanic("ext_glClientActiveTextureARB is NULL");
+    // the draw calls only refresh the arrays of the unit that was last used
+    if (ARG1 != GL_TEXTURE0) {
+        cpu->thread->glUntrackedClientArrays = true;
+    }
     {
     GL_FUNC(ext_glClientActiveTextureARB)(ARG1);
     GL_LOG ("glClientActiveTextureARB GLenum texture=%d",ARG1);
@@ -3412,8 +3420,9 @@ void glcommon_glDrawRangeElementArrayATI(CPU* cpu) {
 void glcommon_glDrawRangeElements(CPU* cpu) {
     if (!ext_glDrawRangeElements)
         kpanic("ext_glDrawRangeElements is NULL");
+    updateVertexPointersForDraw(cpu, ARG2, ARG3 - ARG2 + 1);
     {
-    GL_FUNC(ext_glDrawRangeElements)(ARG1, ARG2, ARG3, ARG4, ARG5, ELEMENT_ARRAY_BUFFER()?(GLvoid*)pARG6:marshalType(cpu, ARG5, ARG4, ARG6));
+    GL_FUNC(ext_glDrawRangeElements)(ARG1, ARG2, ARG3, ARG4, ARG5, marshalIndices(cpu, ARG4, ARG5, ARG6));
     GL_LOG ("glDrawRangeElements GLenum mode=%d, GLuint start=%d, GLuint end=%d, GLsizei count=%d, GLenum type=%d, const void* indices=%.08x",ARG1,ARG2,ARG3,ARG4,ARG5,ARG6);
     }
 }
@@ -4911,7 +4920,7 @@ void glcommon_glGetBufferPointerv(CPU* cpu) {
         kpanic("ext_glGetBufferPointerv is NULL");
     {
     GLint size;void* p;GL_FUNC(ext_glGetBufferPointerv)(ARG1, ARG2, &p);
-    ext_glGetBufferParameteriv(ARG1, GL_BUFFER_SIZE, &size); writed(ARG3, marshalBackp(cpu, p, size));
+    GL_FUNC(ext_glGetBufferParameteriv)(ARG1, GL_BUFFER_SIZE, &size); writed(ARG3, marshalBackp(cpu, p, size));
     GL_LOG ("glGetBufferPointerv GLenum target=%d, GLenum pname=%d, void** params=%.08x",ARG1,ARG2,ARG3);
     }
 }
@@ -4920,7 +4929,7 @@ void glcommon_glGetBufferPointervARB(CPU* cpu) {
         kpanic("ext_glGetBufferPointervARB is NULL");
     {
     GLint size;void* p;GL_FUNC(ext_glGetBufferPointervARB)(ARG1, ARG2, &p);
-    ext_glGetBufferParameterivARB(ARG1, GL_BUFFER_SIZE, &size); writed(ARG3, marshalBackp(cpu, p, size));
+    GL_FUNC(ext_glGetBufferParameterivARB)(ARG1, GL_BUFFER_SIZE, &size); writed(ARG3, marshalBackp(cpu, p, size));
     GL_LOG ("glGetBufferPointervARB GLenum target=%d, GLenum pname=%d, void** params=%.08x",ARG1,ARG2,ARG3);
     }
 }
@@ -6006,7 +6015,7 @@ void glcommon_glGetNamedBufferPointerv(CPU* cpu) {
         kpanic("ext_glGetNamedBufferPointerv is NULL");
     {
     GLint size;void* p;GL_FUNC(ext_glGetNamedBufferPointerv)(ARG1, ARG2, &p);
-    ext_glGetNamedBufferParameteriv(ARG1, GL_BUFFER_SIZE, &size); writed(ARG3, marshalBackp(cpu, p, size));
+    GL_FUNC(ext_glGetNamedBufferParameteriv)(ARG1, GL_BUFFER_SIZE, &size); writed(ARG3, marshalBackp(cpu, p, size));
     GL_LOG ("glGetNamedBufferPointerv GLuint buffer=%d, GLenum pname=%d, void** params=%.08x",ARG1,ARG2,ARG3);
     }
 }
@@ -6015,7 +6024,7 @@ void glcommon_glGetNamedBufferPointervEXT(CPU* cpu) {
         kpanic("ext_glGetNamedBufferPointervEXT is NULL");
     {
     GLint size;void* p;GL_FUNC(ext_glGetNamedBufferPointervEXT)(ARG1, ARG2, &p);
-    ext_glGetNamedBufferParameterivEXT(ARG1, GL_BUFFER_SIZE, &size); writed(ARG3, marshalBackp(cpu, p, size));
+    GL_FUNC(ext_glGetNamedBufferParameterivEXT)(ARG1, GL_BUFFER_SIZE, &size); writed(ARG3, marshalBackp(cpu, p, size));
     GL_LOG ("glGetNamedBufferPointervEXT GLuint buffer=%d, GLenum pname=%d, void** params=%.08x",ARG1,ARG2,ARG3);
     }
 }
@@ -0,0 +1,210 @@
+#include "boxedwine.h"
+
+#ifdef BOXEDWINE_OPENGL
+#include GLH
+#include "glcommon.h"
+#include <chrono>
+#include <deque>
+#include <algorithm>
+
+// only the most recent frames are kept
+#define GL_PROFILE_MAX_FRAMES 1000
+
+bool glProfiling;
+
+struct GLProfileCounts {
+    U64 calls;
+    U64 time; // ns
+    U64 bytes;
+};
+
+struct GLProfileFrameCounts {
+    U32 number;
+    U64 time; // ns from the end of the last frame
+    std::vector<std::pair<U32, GLProfileCounts> > counts;
+};
+
+static const char* glProfileNames[GL_FUNC_COUNT];
+static GLProfileCounts glProfileTotals[GL_FUNC_COUNT];
+static GLProfileCounts glProfileFrameTotals[GL_FUNC_COUNT];
+static std::vector<U32> glProfileFrameIndexes;
+static std::deque<GLProfileFrameCounts> glProfileFrames;
+static U32 glProfileFrameCount;
+static U64 glProfileFrameStart;
+static std::string glProfilePath;
+static BOXEDWINE_MUTEX glProfileMutex;
+
+// time spent in calls made by the current call and bytes marshaled for it
+static THREAD_LOCAL U64 glProfileNested;
+static THREAD_LOCAL U32 glProfileBytes;
+
+static U64 glProfileNow() {
+    return (U64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void glProfileAtExit() {
+    if (glProfiling && glProfilePath.length()) {
+        FILE* f = fopen(glProfilePath.c_str(), "w");
+        if (!f) {
+            klog("could not write the OpenGL profile to %s", glProfilePath.c_str());
+            return;
+        }
+        std::string json = glProfileJson();
+        fwrite(json.c_str(), 1, json.length(), f);
+        fclose(f);
+    }
+}
+
+#undef GL_FUNCTION
+#define GL_FUNCTION(func, RET, PARAMS, ARGS, PRE, POST, LOG) glProfileNames[func] = #func;
+
+#undef GL_FUNCTION_CUSTOM
+#define GL_FUNCTION_CUSTOM(func, RET, PARAMS) glProfileNames[func] = #func;
+
+#undef GL_EXT_FUNCTION
+#define GL_EXT_FUNCTION(func, RET, PARAMS) glProfileNames[func] = #func;
+
+// an empty path profiles without writing a file when the process exits
+void glProfileStart(const std::string& path) {
+    static bool atExitRegistered;
+
+#include "glfunctions.h"
+    glProfileNames[XCreateContext] = "XCreateContext";
+    glProfileNames[XMakeCurrent] = "XMakeCurrent";
+    glProfileNames[XDestroyContext] = "XDestroyContext";
+    glProfileNames[XSwapBuffer] = "XSwapBuffer";
+    glProfileNames[GLBatch] = "Batch";
+
+    glProfileStop();
+    glProfilePath = path;
+    glProfileFrameStart = glProfileNow();
+    glProfiling = true;
+    if (path.length() && !atExitRegistered) {
+        atExitRegistered = true;
+        atexit(glProfileAtExit);
+    }
+}
+
+void glProfileStop() {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(glProfileMutex);
+    glProfiling = false;
+    memset(glProfileTotals, 0, sizeof(glProfileTotals));
+    memset(glProfileFrameTotals, 0, sizeof(glProfileFrameTotals));
+    glProfileFrameIndexes.clear();
+    glProfileFrames.clear();
+    glProfileFrameCount = 0;
+}
+
+void glProfileBegin(GLProfileCall& call) {
+    call.outerNested = glProfileNested;
+    call.outerBytes = glProfileBytes;
+    glProfileNested = 0;
+    glProfileBytes = 0;
+    call.start = glProfileNow();
+}
+
+void glProfileEnd(U32 index, GLProfileCall& call) {
+    U64 time = glProfileNow() - call.start;
+    U64 ownTime = time - std::min(time, glProfileNested);
+    U32 bytes = glProfileBytes;
+
+    glProfileNested = call.outerNested + time;
+    glProfileBytes = call.outerBytes;
+    if (index >= GL_FUNC_COUNT) {
+        return;
+    }
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(glProfileMutex);
+    GLProfileCounts& total = glProfileTotals[index];
+    total.calls++;
+    total.time += ownTime;
+    total.bytes += bytes;
+    GLProfileCounts& frame = glProfileFrameTotals[index];
+    if (!frame.calls) {
+        glProfileFrameIndexes.push_back(index);
+    }
+    frame.calls++;
+    frame.time += ownTime;
+    frame.bytes += bytes;
+}
+
+void glProfileAddMarshaled(U32 bytes) {
+    glProfileBytes += bytes;
+}
+
+static bool glProfileMoreTime(const std::pair<U32, GLProfileCounts>& a, const std::pair<U32, GLProfileCounts>& b) {
+    return a.second.time > b.second.time;
+}
+
+void glProfileFrame() {
+    if (!glProfiling) {
+        return;
+    }
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(glProfileMutex);
+    U64 now = glProfileNow();
+    GLProfileFrameCounts frame;
+    frame.number = ++glProfileFrameCount;
+    frame.time = now - glProfileFrameStart;
+    glProfileFrameStart = now;
+    for (U32 index : glProfileFrameIndexes) {
+        frame.counts.push_back(std::make_pair(index, glProfileFrameTotals[index]));
+        memset(&glProfileFrameTotals[index], 0, sizeof(GLProfileCounts));
+    }
+    glProfileFrameIndexes.clear();
+    std::sort(frame.counts.begin(), frame.counts.end(), glProfileMoreTime);
+    if (glProfileFrames.size() == GL_PROFILE_MAX_FRAMES) {
+        glProfileFrames.pop_front();
+    }
+    glProfileFrames.push_back(std::move(frame));
+}
+
+static void glProfileAppend(std::string& json, U32 index, const GLProfileCounts& counts) {
+    char buffer[256];
+    if (glProfileNames[index]) {
+        snprintf(buffer, sizeof(buffer), "{\"name\":\"%s\",", glProfileNames[index]);
+    } else {
+        snprintf(buffer, sizeof(buffer), "{\"name\":\"%u\",", index);
+    }
+    json += buffer;
+    snprintf(buffer, sizeof(buffer), "\"index\":%u,\"calls\":%llu,\"ns\":%llu,\"bytes\":%llu}", index, (unsigned long long)counts.calls, (unsigned long long)counts.time, (unsigned long long)counts.bytes);
+    json += buffer;
+}
+
+// {"frames":n, "functions":[totals for each function], "frameBreakdown":[{"frame":n, "ns":n, "functions":[...]}]}
+// with the functions sorted by time
+std::string glProfileJson() {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(glProfileMutex);
+    std::vector<std::pair<U32, GLProfileCounts> > totals;
+    std::string json;
+    char buffer[128];
+
+    for (U32 i = 0; i < GL_FUNC_COUNT; i++) {
+        if (glProfileTotals[i].calls) {
+            totals.push_back(std::make_pair(i, glProfileTotals[i]));
+        }
+    }
+    std::sort(totals.begin(), totals.end(), glProfileMoreTime);
+    snprintf(buffer, sizeof(buffer), "{\"frames\":%u,\"functions\":[", glProfileFrameCount);
+    json += buffer;
+    for (U32 i = 0; i < totals.size(); i++) {
+        json += i ? ",\n" : "\n";
+        glProfileAppend(json, totals[i].first, totals[i].second);
+    }
+    json += "],\"frameBreakdown\":[";
+    bool first = true;
+    for (const GLProfileFrameCounts& frame : glProfileFrames) {
+        snprintf(buffer, sizeof(buffer), "%s\n{\"frame\":%u,\"ns\":%llu,\"functions\":[", first ? "" : ",", frame.number, (unsigned long long)frame.time);
+        json += buffer;
+        first = false;
+        for (U32 i = 0; i < frame.counts.size(); i++) {
+            if (i) {
+                json += ",";
+            }
+            glProfileAppend(json, frame.counts[i].first, frame.counts[i].second);
+        }
+        json += "]}";
+    }
+    json += "]}\n";
+    return json;
+}
+
+#endif
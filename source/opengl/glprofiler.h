@@ -0,0 +1,37 @@
+#ifndef __GL_PROFILER_H__
+#define __GL_PROFILER_H__
+
+// With -glprofile <file> every OpenGL call that comes through int 0x99 is counted by function, along with the host
+// time it took and how many bytes were copied to marshal its arguments.  The counts are also split into frames,
+// a frame ends each time the window's buffers are swapped.  Everything is written to the file as JSON when the
+// process exits.
+//
+// The time of a call that runs other calls, like a batch from the guest libGL, doesn't include the calls it ran.
+//
+// The time is taken on the emulated thread.  With -glthread a call that is queued only counts the time it took to
+// copy it into the queue, the render thread's work on it is counted in the next call that waits for the render
+// thread, usually the swap.
+
+extern bool glProfiling;
+
+struct GLProfileCall {
+    U64 start;
+    U64 outerNested;
+    U32 outerBytes;
+};
+
+void glProfileStart(const std::string& path);
+void glProfileStop();
+void glProfileBegin(GLProfileCall& call);
+void glProfileEnd(U32 index, GLProfileCall& call);
+void glProfileAddMarshaled(U32 bytes);
+void glProfileFrame();
+std::string glProfileJson();
+
+inline void glProfileMarshaled(U32 bytes) {
+    if (glProfiling) {
+        glProfileAddMarshaled(bytes);
+    }
+}
+
+#endif
@@ -0,0 +1,203 @@
+#include "boxedwine.h"
+
+#ifdef BOXEDWINE_OPENGL
+#include GLH
+#include "glcommon.h"
+
+struct GLThreadCommandHeader {
+    GLThreadCommandRun run;
+    U32 size;
+};
+
+// the client arrays and their copies go before the draw's own command
+struct GLThreadDrawCommand {
+    GLThreadCommandRun run;
+    U32 offset;
+    U32 arrayCount;
+    GLThreadClientArray arrays[GL_THREAD_MAX_CLIENT_ARRAYS];
+};
+
+GLThread::GLThread(const std::string& name) : queuedCalls(0), syncCalls(0), hasBatch(false), exiting(false), syncFn(NULL), idle(false), marshaledCount(0), clientArrayCount(0), clientArrayBytes(0), syncNext(false) {
+    clearBindings();
+    this->filling.reserve(GL_THREAD_BATCH_SIZE * 2);
+    this->submitted.reserve(GL_THREAD_BATCH_SIZE * 2);
+    this->thread = KNativeThread::createAndStartThread(renderThread, name, this);
+}
+
+GLThread::~GLThread() {
+    finish();
+    this->mutex.lock();
+    this->exiting = true;
+    this->cond.signalAll();
+    this->mutex.unlock();
+    this->thread->wait();
+    delete this->thread;
+}
+
+int GLThread::renderThread(void* data) {
+    ((GLThread*)data)->run();
+    return 0;
+}
+
+void GLThread::run() {
+    this->mutex.lock();
+    while (true) {
+        if (this->hasBatch) {
+            this->mutex.unlock();
+            U8* p = this->submitted.data();
+            U8* end = p + this->submitted.size();
+            while (p < end) {
+                GLThreadCommandHeader* header = (GLThreadCommandHeader*)p;
+                p += GL_THREAD_ALIGN((U32)sizeof(GLThreadCommandHeader));
+                header->run(p);
+                p += header->size;
+            }
+            this->submitted.clear();
+            this->mutex.lock();
+            this->hasBatch = false;
+            this->cond.signalAll();
+        } else if (this->syncFn) {
+            this->mutex.unlock();
+            (*this->syncFn)();
+            this->mutex.lock();
+            this->syncFn = NULL;
+            this->cond.signalAll();
+        } else if (this->exiting) {
+            break;
+        } else {
+            this->idle = true;
+            this->cond.wait(this->mutex);
+            this->idle = false;
+        }
+    }
+    this->mutex.unlock();
+}
+
+// hands the commands that were queued to the render thread, if it is still running the last batch this waits for it
+void GLThread::submit() {
+    this->mutex.lock();
+    while (this->hasBatch) {
+        this->cond.wait(this->mutex);
+    }
+    this->filling.swap(this->submitted);
+    this->hasBatch = true;
+    this->idle = false;
+    this->cond.signalAll();
+    this->mutex.unlock();
+}
+
+void GLThread::runDraw(U8* data) {
+    GLThreadDrawCommand* command = (GLThreadDrawCommand*)data;
+    for (U32 i = 0; i < command->arrayCount; i++) {
+        GLThreadClientArray* array = &command->arrays[i];
+        array->set(array, (const void*)((uintptr_t)(data + array->offset) - array->start));
+    }
+    command->run(data + command->offset);
+    // the copies go away with the batch
+    for (U32 i = 0; i < command->arrayCount; i++) {
+        GLThreadClientArray* array = &command->arrays[i];
+        array->set(array, array->pointer);
+    }
+}
+
+U8* GLThread::enqueue(GLThreadCommandRun run, U32 size) {
+    if (!this->clientArrayCount) {
+        return add(run, size);
+    }
+    U32 offset = GL_THREAD_ALIGN((U32)sizeof(GLThreadDrawCommand));
+    U8* data = add(runDraw, offset + (U32)this->clientArrayBytes + size);
+    GLThreadDrawCommand* command = (GLThreadDrawCommand*)data;
+    command->run = run;
+    command->arrayCount = this->clientArrayCount;
+    for (U32 i = 0; i < this->clientArrayCount; i++) {
+        GLThreadClientArray* array = &command->arrays[i];
+        *array = this->clientArrays[i];
+        array->offset = offset;
+        memcpy(data + offset, array->data, array->len);
+        array->data = NULL;
+        offset += GL_THREAD_ALIGN(array->len);
+    }
+    command->offset = offset;
+    this->clientArrayCount = 0;
+    this->clientArrayBytes = 0;
+    return data + offset;
+}
+
+U8* GLThread::add(GLThreadCommandRun run, U32 size) {
+    size_t used = this->filling.size();
+    if (used >= GL_THREAD_BATCH_SIZE || (used >= GL_THREAD_IDLE_BATCH_SIZE && this->idle.load(std::memory_order_relaxed))) {
+        submit();
+        used = 0;
+    }
+    U32 headerSize = GL_THREAD_ALIGN((U32)sizeof(GLThreadCommandHeader));
+    this->filling.resize(used + headerSize + size);
+    U8* p = this->filling.data() + used;
+    GLThreadCommandHeader* header = (GLThreadCommandHeader*)p;
+    header->run = run;
+    header->size = size;
+    this->queuedCalls++;
+    return p + headerSize;
+}
+
+void GLThread::callSync(const std::function<void()>& fn) {
+    if (!this->filling.empty()) {
+        submit();
+    }
+    this->mutex.lock();
+    // the render thread runs the batch before fn
+    this->syncFn = &fn;
+    this->cond.signalAll();
+    while (this->syncFn) {
+        this->cond.wait(this->mutex);
+    }
+    this->mutex.unlock();
+    this->syncCalls++;
+}
+
+void GLThread::finish() {
+    callSync([]() {});
+}
+
+void GLThread::recordMarshaled(const void* p, U32 size) {
+    if (this->marshaledCount < GL_THREAD_MAX_MARSHALED) {
+        this->marshaled[this->marshaledCount] = p;
+        this->marshaledSize[this->marshaledCount] = size;
+        this->marshaledCount++;
+    }
+}
+
+void GLThread::addClientArray(const GLThreadClientArray& array) {
+    if (this->clientArrayCount >= GL_THREAD_MAX_CLIENT_ARRAYS) {
+        kpanic("GLThread::addClientArray too many client arrays");
+    }
+    this->clientArrays[this->clientArrayCount++] = array;
+    this->clientArrayBytes += GL_THREAD_ALIGN((U64)array.len);
+}
+
+void GLThread::setClientArraysInPlace() {
+    callSync([this]() {
+        for (U32 i = 0; i < this->clientArrayCount; i++) {
+            this->clientArrays[i].set(&this->clientArrays[i], this->clientArrays[i].pointer);
+        }
+        });
+    this->clientArrayCount = 0;
+    this->clientArrayBytes = 0;
+}
+
+void GLThread::clearBindings() {
+    for (U32 i = 0; i < GL_THREAD_BINDING_COUNT; i++) {
+        this->bindings[i] = GL_THREAD_BINDING_UNKNOWN;
+    }
+}
+
+// the newest record wins, the marshal buffers are reused
+U32 GLThread::getMarshaledSize(const void* p) {
+    for (U32 i = this->marshaledCount; i > 0; i--) {
+        if (this->marshaled[i - 1] == p) {
+            return this->marshaledSize[i - 1];
+        }
+    }
+    return GL_THREAD_UNKNOWN;
+}
+
+#endif
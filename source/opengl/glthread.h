@@ -0,0 +1,282 @@
+#ifndef __GL_THREAD_H__
+#define __GL_THREAD_H__
+
+#include "knativesynchronization.h"
+#include "knativethread.h"
+#include <atomic>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+// With -glthread each OSMesa context gets its own host render thread and the context is only ever current on that
+// thread.  GL calls that don't return anything and only read memory that was marshaled for them (so its size is
+// known) are copied into a queue and the emulated thread keeps going while the render thread runs them.  Everything
+// else waits for the queue to drain and then runs on the render thread while the emulated thread waits.
+//
+// GL reads client arrays when it draws, not when the pointer is passed in.  glDrawArrays, glDrawElements and
+// glDrawRangeElements are queued with a copy of the range of each array they read (and of their indices), the
+// copies are handed to GL just for that draw.  The other calls that set or use client array pointers (glVertexPointer,
+// glArrayElement, glMultiDraw*, ...) are synchronous, and so is a draw whose arrays can't be copied.
+
+#define GL_THREAD_BATCH_SIZE (64 * 1024)
+// a smaller batch is handed over if the render thread has nothing to do
+#define GL_THREAD_IDLE_BATCH_SIZE (4 * 1024)
+#define GL_THREAD_MAX_MARSHALED 16
+#define GL_THREAD_MAX_CLIENT_ARRAYS 16
+// a draw that reads more than this from its client arrays waits instead, copying it would cost more than the wait
+#define GL_THREAD_MAX_CLIENT_ARRAY_BYTES (1024 * 1024)
+#define GL_THREAD_UNKNOWN 0xFFFFFFFF
+#define GL_THREAD_ALIGN(x) (((x) + 15) & ~15)
+
+#define GL_THREAD_ARRAY_BUFFER_BINDING 0
+#define GL_THREAD_ELEMENT_ARRAY_BUFFER_BINDING 1
+#define GL_THREAD_BINDING_COUNT 2
+#define GL_THREAD_BINDING_UNKNOWN -1
+
+typedef void (*GLThreadCommandRun)(U8* data);
+
+struct GLThreadClientArray;
+// calls the gl*Pointer function of the array on the render thread
+typedef void (*GLThreadClientArraySet)(const GLThreadClientArray* array, const void* p);
+
+struct GLThreadClientArray {
+    GLThreadClientArraySet set;
+    U32 size;
+    U32 type;
+    U32 stride;
+    U32 count;
+    const U8* data; // the first byte the draw reads, only used while the draw is queued
+    U32 start; // where data is from the pointer
+    U32 len;
+    const void* pointer; // what the emulated thread last set, put back after the draw
+    U32 offset; // of the copy in the command
+};
+
+class GLThread {
+public:
+    GLThread(const std::string& name);
+    ~GLThread();
+
+    static GLThread* current() {
+        KThread* thread = KThread::currentThread();
+        return thread ? thread->glThread : NULL;
+    }
+
+    // returns size bytes of space in the queue, run will be called with it on the render thread
+    U8* enqueue(GLThreadCommandRun run, U32 size);
+    // runs everything that was queued, then fn on the render thread and waits for it
+    void callSync(const std::function<void()>& fn);
+    // waits for everything that was queued to run
+    void finish();
+
+    // The marshal functions record the buffers they return so that a call that reads them can be queued with a
+    // copy.  The records only last until the call they were made for is dispatched.
+    void recordMarshaled(const void* p, U32 size);
+    U32 getMarshaledSize(const void* p);
+    void clearMarshaled() { this->marshaledCount = 0; this->clientArrayCount = 0; this->clientArrayBytes = 0; this->syncNext = false; }
+
+    // The client arrays the next queued call reads, it is queued with a copy of them.  If they can't all be copied
+    // setClientArraysInPlace sets them where they are so that the call can run synchronously instead.
+    void addClientArray(const GLThreadClientArray& array);
+    U64 getClientArrayBytes() { return this->clientArrayBytes; }
+    void setClientArraysInPlace();
+    // the next call is synchronous even if it could be queued
+    void syncNextCall() { this->syncNext = true; }
+    bool mustSync() { return this->syncNext; }
+
+    // glGetIntegerv of the buffer bindings the marshal code checks before most draws, remembered until a call that
+    // might change them so that the draw doesn't have to wait for the render thread
+    S32 bindings[GL_THREAD_BINDING_COUNT];
+    void clearBindings();
+
+    U64 queuedCalls;
+    U64 syncCalls;
+
+private:
+    static int renderThread(void* data);
+    static void runDraw(U8* data);
+    void run();
+    void submit();
+    U8* add(GLThreadCommandRun run, U32 size);
+
+    KNativeThread* thread;
+    KNativeMutex mutex;
+    KNativeCondition cond;
+    // only touched by the emulated thread
+    std::vector<U8> filling;
+    // only touched by the render thread while hasBatch is set
+    std::vector<U8> submitted;
+    bool hasBatch;
+    bool exiting;
+    const std::function<void()>* syncFn;
+    std::atomic<bool> idle;
+
+    const void* marshaled[GL_THREAD_MAX_MARSHALED];
+    U32 marshaledSize[GL_THREAD_MAX_MARSHALED];
+    U32 marshaledCount;
+
+    GLThreadClientArray clientArrays[GL_THREAD_MAX_CLIENT_ARRAYS];
+    U32 clientArrayCount;
+    U64 clientArrayBytes;
+    bool syncNext;
+};
+
+template<typename T> T* glThreadMarshaled(T* p, U32 count) {
+    if (p && count) {
+        GLThread* thread = GLThread::current();
+        if (thread) {
+            thread->recordMarshaled(p, count * sizeof(T));
+        }
+    }
+    return p;
+}
+
+// GL copies everything it reads through a const pointer before the call returns, so if the size is known the data
+// can be copied into the command.  A non-const pointer might be written to, so the call has to be synchronous.
+template<typename T> struct GLThreadArg {
+    static U32 size(GLThread* thread, T arg) { return 0; }
+    static const void* pointer(T arg) { return NULL; }
+    static void fix(T& arg, U8* data, U32 offset) {}
+};
+
+template<typename T> struct GLThreadArg<T*> {
+    static U32 size(GLThread* thread, T* arg) { return arg ? GL_THREAD_UNKNOWN : 0; }
+    static const void* pointer(T* arg) { return NULL; }
+    static void fix(T*& arg, U8* data, U32 offset) {}
+};
+
+template<typename T> struct GLThreadArg<const T*> {
+    static U32 size(GLThread* thread, const T* arg) { return arg ? thread->getMarshaledSize(arg) : 0; }
+    static const void* pointer(const T* arg) { return arg; }
+    static void fix(const T*& arg, U8* data, U32 offset) {
+        if (offset) {
+            arg = (const T*)(data + offset);
+        }
+    }
+};
+
+// the copies of the data the pointers pointed to follow the command
+template<typename... P> struct GLThreadCommand {
+    void (OPENGL_CALL_TYPE *fn)(P...);
+    std::tuple<P...> args;
+    U32 offsets[sizeof...(P) + 1];
+
+    template<size_t... I> void fixPointers(U8* data, std::index_sequence<I...>) {
+        (GLThreadArg<P>::fix(std::get<I>(this->args), data, this->offsets[I]), ...);
+    }
+
+    static void run(U8* data) {
+        GLThreadCommand* command = (GLThreadCommand*)data;
+        command->fixPointers(data, std::index_sequence_for<P...>());
+        std::apply(command->fn, command->args);
+    }
+};
+
+template<bool sync, bool changesBindings, typename R, typename... P> class GLThreadCall {
+public:
+    typedef R (OPENGL_CALL_TYPE *Fn)(P...);
+
+    GLThreadCall(Fn fn) : fn(fn) {}
+
+    R operator()(P... args) const {
+        GLThread* thread = GLThread::current();
+        if (!thread) {
+            return this->fn(args...);
+        }
+        Fn fn = this->fn;
+        if constexpr (changesBindings) {
+            thread->clearBindings();
+        }
+        if constexpr (std::is_void<R>::value) {
+            if constexpr (!sync) {
+                if (!thread->mustSync() && queue(thread, args...)) {
+                    return;
+                }
+            }
+            thread->callSync([&]() {fn(args...);});
+            thread->clearMarshaled();
+        } else {
+            R result;
+            thread->callSync([&]() {result = fn(args...);});
+            thread->clearMarshaled();
+            return result;
+        }
+    }
+
+private:
+    bool queue(GLThread* thread, P... args) const {
+        typedef GLThreadCommand<P...> Command;
+        U32 sizes[sizeof...(P) + 1] = {GLThreadArg<P>::size(thread, args)..., 0};
+        const void* pointers[sizeof...(P) + 1] = {GLThreadArg<P>::pointer(args)..., NULL};
+        U32 size = GL_THREAD_ALIGN((U32)sizeof(Command));
+
+        for (U32 i = 0; i < sizeof...(P); i++) {
+            if (sizes[i] == GL_THREAD_UNKNOWN) {
+                return false;
+            }
+            size += GL_THREAD_ALIGN(sizes[i]);
+        }
+        U8* data = thread->enqueue(Command::run, size);
+        Command* command = new (data) Command();
+        command->fn = this->fn;
+        command->args = std::tuple<P...>(args...);
+        size = GL_THREAD_ALIGN((U32)sizeof(Command));
+        for (U32 i = 0; i < sizeof...(P); i++) {
+            if (sizes[i]) {
+                memcpy(data + size, pointers[i], sizes[i]);
+                command->offsets[i] = size;
+                size += GL_THREAD_ALIGN(sizes[i]);
+            } else {
+                command->offsets[i] = 0;
+            }
+        }
+        thread->clearMarshaled();
+        return true;
+    }
+
+    Fn fn;
+};
+
+// Calls that use client arrays or that have to reach the driver before the guest continues are synchronous, found
+// by name when compiling
+constexpr bool glThreadNameEquals(const char* name, const char* s) {
+    U32 i = 0;
+    while (name[i] && name[i] == s[i]) {
+        i++;
+    }
+    return name[i] == s[i];
+}
+
+constexpr bool glThreadNameContains(const char* name, const char* s) {
+    for (U32 i = 0; name[i]; i++) {
+        U32 j = 0;
+        while (s[j] && name[i + j] == s[j]) {
+            j++;
+        }
+        if (!s[j]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// the draws that copy the client arrays they read, see updateVertexPointersForDraw
+constexpr bool glThreadIsQueuedDraw(const char* name) {
+    return glThreadNameEquals(name, "pglDrawArrays") || glThreadNameEquals(name, "pglDrawElements") || glThreadNameEquals(name, "ext_glDrawRangeElements");
+}
+
+constexpr bool glThreadIsSync(const char* name) {
+    return !glThreadIsQueuedDraw(name) && (glThreadNameContains(name, "Pointer") || glThreadNameContains(name, "Draw") || glThreadNameContains(name, "ArrayElement") || glThreadNameContains(name, "Finish") || glThreadNameContains(name, "Flush"));
+}
+
+// buffer and vertex array object calls might change GL_THREAD_*_BINDING, and so does glPopClientAttrib
+constexpr bool glThreadChangesBindings(const char* name) {
+    return glThreadNameContains(name, "Buffer") || glThreadNameContains(name, "VertexArray") || glThreadNameContains(name, "ClientAttrib");
+}
+
+template<bool sync, bool changesBindings = false, typename R, typename... P> GLThreadCall<sync, changesBindings, R, P...> glThreadCall(R (OPENGL_CALL_TYPE *fn)(P...)) {
+    return GLThreadCall<sync, changesBindings, R, P...>(fn);
+}
+
+#endif
@@ -59,8 +59,20 @@ static fn_OSMesaGetProcAddress pOSMesaGetProcAddress;
 
 class MesaBoxedwineGlContext {
 public:
-    MesaBoxedwineGlContext() : buffer(NULL), width(0), height(0), pitch(0), bpp(0), profile(0), major(0), minor(0), pixelFormat(NULL), context(NULL) {}
+    MesaBoxedwineGlContext() : buffer(NULL), width(0), height(0), pitch(0), bpp(0), profile(0), major(0), minor(0), pixelFormat(NULL), context(NULL), glThread(NULL) {}
     ~MesaBoxedwineGlContext() {
+        if (glThread) {
+            KThread* thread = KThread::currentThread();
+            if (thread && thread->glThread == glThread) {
+                thread->glThread = NULL;
+            }
+            if (context) {
+                OSMesaContext c = context;
+                glThread->callSync([c]() {pOSMesaDestroyContext(c);});
+                context = NULL;
+            }
+            delete glThread;
+        }
         if (buffer) {
             delete[] buffer;
         }
@@ -79,6 +91,7 @@ public:
     PixelFormat* pixelFormat;
     OSMesaContext context;
     std::shared_ptr<Wnd> wnd;
+    GLThread* glThread; // with -glthread the context is only made current on this thread
 };
 
 class MesaBoxedwineGL : public BoxedwineGL {
@@ -101,6 +114,12 @@ void MesaBoxedwineGL::deleteContext(void* context) {
 }
 
 bool MesaBoxedwineGL::makeCurrent(void* context, void* window) {
+    KThread* thread = KThread::currentThread();
+    if (thread->glThread) {
+        // the old context stays current on its render thread, but nothing queued for it can be left behind
+        thread->glThread->finish();
+        thread->glThread = NULL;
+    }
     if (!context) {
         return true;
     }
@@ -109,6 +128,19 @@ bool MesaBoxedwineGL::makeCurrent(void* context, void* window) {
         return true;
     }
     c->buffer = new U8[c->width * c->height * 4];
+    if (c->glThread) {
+        bool result = false;
+        c->glThread->callSync([c, &result]() {
+            result = pOSMesaMakeCurrent(c->context, c->buffer, GL_UNSIGNED_BYTE, c->width, c->height) != 0;
+            if (result) {
+                pOSMesaPixelStore(OSMESA_Y_UP, 0);
+            }
+        });
+        if (result) {
+            thread->glThread = c->glThread;
+        }
+        return result;
+    }
     if (pOSMesaMakeCurrent(c->context, c->buffer, GL_UNSIGNED_BYTE, c->width, c->height)) {
         pOSMesaPixelStore(OSMESA_Y_UP, 0);
         return true;
@@ -162,12 +194,15 @@ void* MesaBoxedwineGL::internalCreateContext(void* window, std::shared_ptr<Wnd>
     c->profile = profile;
     c->major = major;
     c->minor = minor;
+    if (KSystem::openglThreaded) {
+        c->glThread = new GLThread("OSMesa Render");
+    }
     return c;
 }
 
 void MesaBoxedwineGL::swapBuffer(void* window) {
     MesaBoxedwineGlContext* c = (MesaBoxedwineGlContext*)KThread::currentThread()->currentContext;
-    pglFlush();
+    GL_FUNC(pglFlush)();
     KNativeWindow::getNativeWindow()->drawWnd(KThread::currentThread(), c->wnd, c->buffer, c->pitch, c->bpp, c->width, c->height);
 }
 
@@ -226,13 +261,13 @@ void loadMesaExtensions() {
 
 // GLAPI void APIENTRY glFinish( void ) {
 void osmesa_glFinish(CPU* cpu) {
-    pglFinish();
+    GL_FUNC(pglFinish)();
 }
 
 // GLAPI void APIENTRY glFlush( void ) {
 void osmesa_glFlush(CPU* cpu) {
     MesaBoxedwineGlContext* c = (MesaBoxedwineGlContext*)KThread::currentThread()->currentContext;
-    pglFlush();
+    GL_FUNC(pglFlush)();
     KNativeWindow::getNativeWindow()->drawWnd(KThread::currentThread(), c->wnd, c->buffer, c->pitch, c->bpp, c->width, c->height);
 }
 
@@ -8,8 +8,6 @@
 #include "knativewindow.h"
 
 bool isFbReady();
-U32 getNextTimer();
-void runTimers();
 
 extern U32 platformThreadCount;
 extern U32 exceptionCount;
@@ -51,8 +51,13 @@ bool doMainLoop() {
             if (KSystem::getRunningProcessCount()==0) {
                 break;
             }
-            if (!checkWaitingNativeSockets(20)) {
-                KNativeThread::sleep(20);
+            // nothing can be scheduled before the next timer, unless a native socket wakes a thread
+            U32 timeout = getNextTimer();
+            if (timeout > 20) {
+                timeout = 20;
+            }
+            if (timeout && !checkWaitingNativeSockets(timeout)) {
+                KNativeThread::sleep(timeout);
             }
         }
     }
@@ -198,6 +198,13 @@ std::vector<std::string> StartUpArgs::buildArgs() {
     if (openGlType == OPENGL_TYPE_OSMESA) {
         args.push_back("-mesa");
     }
+    if (openGlThreaded) {
+        args.push_back("-glthread");
+    }
+    if (openGlProfilePath.length()) {
+        args.push_back("-glprofile");
+        args.push_back(openGlProfilePath);
+    }
     if (ttyPrepend) {
         args.push_back("-ttyPrepend");
     }
@@ -220,6 +227,14 @@ std::vector<std::string> StartUpArgs::buildArgs() {
         args.push_back("-cpuAffinity");
         args.push_back(std::to_string(cpuAffinity));
     }
+    if (translationCachePath.length()) {
+        args.push_back("-translationCache");
+        args.push_back(translationCachePath);
+    }
+    if (translationThreads) {
+        args.push_back("-translationThreads");
+        args.push_back(std::to_string(translationThreads));
+    }
     if (pollRate > 0) {
         args.push_back("-pollRate");
         args.push_back(std::to_string(this->pollRate));
@@ -261,9 +276,15 @@ bool StartUpArgs::apply() {
         KSystem::pollRate = 0;
     }
     KSystem::openglType = this->openGlType;
+    KSystem::openglThreaded = this->openGlThreaded;
+    KSystem::openglProfilePath = this->openGlProfilePath;
     KSystem::ttyPrepend = this->ttyPrepend;
     KSystem::showWindowImmediately = this->showWindowImmediately;
     KSystem::skipFrameFPS = this->skipFrameFPS;
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+    KSystem::translationCachePath = this->translationCachePath;
+    KSystem::translationThreads = this->translationThreads;
+#endif
     if (!KSystem::logFile && this->logPath.length()) {
         KSystem::logFile = fopen(this->logPath.c_str(), "w");
     }
@@ -689,6 +710,11 @@ bool StartUpArgs::parseStartupArgs(int argc, const char **argv) {
             i++;
         } else if (!strcmp(argv[i], "-mesa")) {
             this->openGlType = OPENGL_TYPE_OSMESA;
+        } else if (!strcmp(argv[i], "-glthread")) {
+            this->openGlThreaded = true;
+        } else if (!strcmp(argv[i], "-glprofile") && i + 1 < argc) {
+            this->openGlProfilePath = argv[i + 1];
+            i++;
         }
         else if (!strcmp(argv[i], "-ttyPrepend")) { // used to send tty back to WaitDlg for winetricks when BOXEDWINE_UI_LAUNCH_IN_PROCESS is not defined
             this->ttyPrepend = true;
@@ -697,6 +723,20 @@ bool StartUpArgs::parseStartupArgs(int argc, const char **argv) {
             this->cpuAffinity = atoi(argv[i+1]);
 #else
             klog("ignoring -cpuAffinity");
+#endif
+            i++;
+        } else if (!strcmp(argv[i], "-translationCache") && i + 1 < argc) {
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+            this->translationCachePath = argv[i + 1];
+#else
+            klog("ignoring -translationCache");
+#endif
+            i++;
+        } else if (!strcmp(argv[i], "-translationThreads") && i + 1 < argc) {
+#ifdef BOXEDWINE_BINARY_TRANSLATOR
+            this->translationThreads = atoi(argv[i + 1]);
+#else
+            klog("ignoring -translationThreads");
 #endif
             i++;
         } else if (!strcmp(argv[i], "-skipFrameFPS") && i+1<argc) {
@@ -36,6 +36,7 @@ static void notImplemented(const char* s) {
 #define ARG7 cpu->peek32(7)
 #define ARG8 cpu->peek32(8)
 #define ARG9 cpu->peek32(9)
+#define ARG10 cpu->peek32(10)
 
 
 #define BOXED_BASE 0
@@ -157,6 +158,7 @@ static void notImplemented(const char* s) {
 #define BOXED_VK_GET_NATIVE_SURFACE                  (BOXED_BASE+107)
 
 #define BOXED_AUTO_FLUSH_PRIMARY                  (BOXED_BASE+108)
+#define BOXED_FLUSH_SURFACE_DIRTY                 (BOXED_BASE+109)
 
 # define __MSABI_LONG(x)         x
 
@@ -2121,10 +2123,18 @@ void boxeddrv_UnregisterHotKey(CPU* cpu) {
 
 // void boxeddrv_FlushSurface(HWND hwnd, void* bits, int xOrg, int yOrg, int width, int height, zOrder, RECT* rects, int rectCount)
 void boxeddrv_FlushSurface(CPU* cpu) {
-    U32 i;
+    // rects is everything that has ever been drawn to the surface, not what changed, so the whole surface is uploaded once
+    if (ARG9) {
+        KNativeWindow::getNativeWindow()->bltWnd(cpu->thread, ARG1, ARG2, ARG3, ARG4, ARG5, ARG6, 0);
+    }
+    KNativeWindow::getNativeWindow()->drawAllWindows(cpu->thread, ARG7+4, readd(ARG7));
+}
 
-    for (i=0;i<ARG9;i++) {
-        KNativeWindow::getNativeWindow()->bltWnd(cpu->thread, ARG1, ARG2, ARG3, ARG4, ARG5, ARG6, ARG8+16*i);
+// void boxeddrv_FlushSurfaceDirty(HWND hwnd, void* bits, int xOrg, int yOrg, int width, int height, zOrder, RECT* rects, int rectCount, RECT* dirty)
+void boxeddrv_FlushSurfaceDirty(CPU* cpu) {
+    // dirty is the bounds of what was drawn since the last flush, in surface coordinates
+    if (ARG9) {
+        KNativeWindow::getNativeWindow()->bltWnd(cpu->thread, ARG1, ARG2, ARG3, ARG4, ARG5, ARG6, ARG10);
     }
     KNativeWindow::getNativeWindow()->drawAllWindows(cpu->thread, ARG7+4, readd(ARG7));
 }
@@ -2186,7 +2196,7 @@ U32 wine_callbackSize;
 
 void initWine() {
 	if (!wine_callback) {
-		wine_callback = new Int99Callback[109];
+		wine_callback = new Int99Callback[110];
 		wine_callback[BOXED_ACQUIRE_CLIPBOARD] = boxeddrv_AcquireClipboard;
 		wine_callback[BOXED_ACTIVATE_KEYBOARD_LAYOUT] = boxeddrv_ActivateKeyboardLayout;
 		wine_callback[BOXED_BEEP] = boxeddrv_Beep;
@@ -2298,6 +2308,7 @@ void initWine() {
         wine_callback[BOXED_VK_GET_NATIVE_SURFACE] = boxeddrv_vkGetNativeSurface;
 
         wine_callback[BOXED_AUTO_FLUSH_PRIMARY] = boxeddrv_autoFlushPrimary;
-		wine_callbackSize = 109;
+        wine_callback[BOXED_FLUSH_SURFACE_DIRTY] = boxeddrv_FlushSurfaceDirty;
+		wine_callbackSize = 110;
 	}
 }
@@ -0,0 +1,160 @@
+#include "boxedwine.h"
+
+#ifdef __TEST
+
+#include <stdio.h>
+
+#include "testCPU.h"
+#include "testAudio.h"
+#include "../util/audioconvert.h"
+
+static void checkSamples(const char* name, const S16* result, const S16* expected, U32 count) {
+    for (U32 i = 0; i < count; i++) {
+        if (result[i] != expected[i]) {
+            failed("%s: sample %d is %d instead of %d", name, i, result[i], expected[i]);
+            return;
+        }
+    }
+}
+
+void testAudioConverter() {
+    AudioConverter converter;
+
+    // 20 frames so that both the vector loops and the leftovers run
+    {
+        U8 src[20];
+        S16 dst[40];
+        S16 expected[40];
+        for (U32 i = 0; i < 20; i++) {
+            src[i] = (U8)(i * 13);
+            expected[i * 2] = expected[i * 2 + 1] = (S16)(((S32)src[i] - 128) * 256);
+        }
+        converter.init(AUDIO_SAMPLE_U8, 1, 22050, AUDIO_SAMPLE_S16, 2, 22050, 1024);
+        if (converter.convert(src, 20, (U8*)dst) != sizeof(dst)) {
+            failed("U8 mono to S16 stereo: wrong length");
+        }
+        checkSamples("U8 mono to S16 stereo", dst, expected, 40);
+    }
+    {
+        S16 src[40];
+        S16 dst[20];
+        S16 expected[20];
+        for (U32 i = 0; i < 20; i++) {
+            src[i * 2] = (S16)(i * 1000 - 10000);
+            src[i * 2 + 1] = (S16)(i * 3000 - 30000);
+            expected[i] = (S16)(i * 2000 - 20000);
+        }
+        src[0] = src[1] = -32768;
+        expected[0] = -32768;
+        converter.init(AUDIO_SAMPLE_S16, 2, 44100, AUDIO_SAMPLE_S16, 1, 44100, 1024);
+        converter.convert((U8*)src, 20, (U8*)dst);
+        checkSamples("S16 stereo to S16 mono", dst, expected, 20);
+    }
+    {
+        float src[12] = {2.0f, -2.0f, 0.5f, 1.0f, -1.0f, 0.0f, -0.5f, 0.25f, 100.0f, -100.0f, 1.0f / 32768.0f, 0.99f};
+        S16 dst[12];
+        S16 expected[12] = {32767, -32768, 16384, 32767, -32768, 0, -16384, 8192, 32767, -32768, 1, 32440};
+        converter.init(AUDIO_SAMPLE_F32, 1, 48000, AUDIO_SAMPLE_S16, 1, 48000, 1024);
+        converter.convert((U8*)src, 12, (U8*)dst);
+        checkSamples("F32 to S16", dst, expected, 12);
+    }
+    {
+        // every 16-bit sample survives the trip through float
+        std::vector<S16> src(65536);
+        std::vector<float> f(65536);
+        std::vector<S16> dst(65536);
+        AudioConverter back;
+        for (U32 i = 0; i < 65536; i++) {
+            src[i] = (S16)i;
+        }
+        converter.init(AUDIO_SAMPLE_S16, 1, 44100, AUDIO_SAMPLE_F32, 1, 44100, 1000);
+        back.init(AUDIO_SAMPLE_F32, 1, 44100, AUDIO_SAMPLE_S16, 1, 44100, 1000);
+        converter.convert((U8*)src.data(), 65536, (U8*)f.data());
+        back.convert((U8*)f.data(), 65536, (U8*)dst.data());
+        checkSamples("S16 to F32 to S16", dst.data(), src.data(), 65536);
+    }
+    {
+        // a constant signal stays constant when resampled and chunks come out the same as one big call
+        const U32 frames = 1000;
+        std::vector<S16> src(frames * 2, 1000);
+        converter.init(AUDIO_SAMPLE_S16, 2, 44100, AUDIO_SAMPLE_S16, 2, 48000, 256);
+        std::vector<S16> dst(converter.getMaxOutputBytes(frames) / 2);
+        U32 len = converter.convert((U8*)src.data(), frames, (U8*)dst.data());
+        U32 dstFrames = len / converter.getDstFrameSize();
+        U32 expectedFrames = frames * 48000 / 44100;
+        if (dstFrames + 2 < expectedFrames || dstFrames > expectedFrames + 2) {
+            failed("44100 to 48000: %d frames instead of about %d", dstFrames, expectedFrames);
+        }
+        for (U32 i = 0; i < dstFrames * 2; i++) {
+            if (dst[i] != 1000) {
+                failed("44100 to 48000: sample %d is %d", i, dst[i]);
+                break;
+            }
+        }
+
+        for (U32 i = 0; i < frames; i++) {
+            src[i * 2] = (S16)(i * 30);
+            src[i * 2 + 1] = (S16)(-(S32)i * 30);
+        }
+        converter.init(AUDIO_SAMPLE_S16, 2, 22050, AUDIO_SAMPLE_S16, 2, 48000, 4096);
+        std::vector<S16> whole(converter.getMaxOutputBytes(frames) / 2);
+        len = converter.convert((U8*)src.data(), frames, (U8*)whole.data());
+        converter.reset();
+        std::vector<S16> chunked(whole.size());
+        U32 chunkedLen = 0;
+        for (U32 i = 0; i < frames; i += 7) {
+            U32 todo = frames - i < 7 ? frames - i : 7;
+            chunkedLen += converter.convert((U8*)(src.data() + i * 2), todo, (U8*)chunked.data() + chunkedLen);
+        }
+        if (len != chunkedLen) {
+            failed("22050 to 48000: %d bytes in chunks, %d bytes at once", chunkedLen, len);
+        } else {
+            checkSamples("22050 to 48000 in chunks", chunked.data(), whole.data(), len / 2);
+        }
+        // a ramp stays a ramp
+        for (U32 i = 1; i < len / 4; i++) {
+            if (whole[i * 2] < whole[i * 2 - 2] || whole[i * 2 + 1] > whole[i * 2 - 1]) {
+                failed("22050 to 48000: frame %d is not on the ramp", i);
+                break;
+            }
+        }
+    }
+}
+
+static void benchmarkConversion(const char* name, AudioSampleFormat srcFormat, U32 srcChannels, U32 srcFreq, AudioSampleFormat dstFormat, U32 dstChannels, U32 dstFreq) {
+    // 60 seconds of audio fed the way the producers do, a period at a time
+    const U32 chunkFrames = 1024;
+    const U32 seconds = 60;
+    AudioConverter converter;
+    converter.init(srcFormat, srcChannels, srcFreq, dstFormat, dstChannels, dstFreq, chunkFrames);
+    std::vector<U8> src(chunkFrames * converter.getSrcFrameSize());
+    std::vector<U8> dst(converter.getMaxOutputBytes(chunkFrames));
+    for (U32 i = 0; i < src.size(); i++) {
+        src[i] = (U8)(i * 7);
+    }
+    if (srcFormat == AUDIO_SAMPLE_F32) {
+        float* f = (float*)src.data();
+        for (U32 i = 0; i < src.size() / 4; i++) {
+            f[i] = (float)(i % 200) / 100.0f - 1.0f;
+        }
+    }
+    U32 iterations = srcFreq * seconds / chunkFrames;
+    U64 bytes = 0;
+    U64 start = KSystem::getMicroCounter();
+    for (U32 i = 0; i < iterations; i++) {
+        bytes += converter.convert(src.data(), chunkFrames, dst.data());
+    }
+    U64 time = KSystem::getMicroCounter() - start;
+    printf("Audio convert: %s, %d seconds of audio in %dus (%d bytes out)\n", name, seconds, (U32)time, (U32)bytes);
+}
+
+void benchmarkAudioConvert() {
+    benchmarkConversion("S16 stereo 44100 -> F32 stereo 48000", AUDIO_SAMPLE_S16, 2, 44100, AUDIO_SAMPLE_F32, 2, 48000);
+    benchmarkConversion("S16 stereo 22050 -> S16 stereo 48000", AUDIO_SAMPLE_S16, 2, 22050, AUDIO_SAMPLE_S16, 2, 48000);
+    benchmarkConversion("U8 mono 22050 -> S16 stereo 48000", AUDIO_SAMPLE_U8, 1, 22050, AUDIO_SAMPLE_S16, 2, 48000);
+    benchmarkConversion("S16 mono 44100 -> F32 stereo 44100", AUDIO_SAMPLE_S16, 1, 44100, AUDIO_SAMPLE_F32, 2, 44100);
+    benchmarkConversion("S16 stereo 48000 -> F32 stereo 48000", AUDIO_SAMPLE_S16, 2, 48000, AUDIO_SAMPLE_F32, 2, 48000);
+    benchmarkConversion("F32 stereo 48000 -> S16 mono 48000", AUDIO_SAMPLE_F32, 2, 48000, AUDIO_SAMPLE_S16, 1, 48000);
+}
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef __TEST_AUDIO_H__
+#define __TEST_AUDIO_H__
+
+void testAudioConverter();
+void benchmarkAudioConvert();
+
+#endif
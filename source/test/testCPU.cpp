@@ -24,6 +24,7 @@
 #include "../emulation/softmmu/soft_memory.h"
 #include "../emulation/hardmmu/hard_memory.h"
 #include "../emulation/cpu/binaryTranslation/btCpu.h"
+#include "../emulation/cpu/x64/x64CPU.h"
 #include "knativethread.h"
 
 #ifdef BOXEDWINE_MSVC
@@ -32,6 +33,16 @@
 
 #include "testCPU.h"
 #include "testMMX.h"
+#include "testTimers.h"
+#include "testFork.h"
+#include "testDecoder.h"
+#include "testRing.h"
+#include "testAudio.h"
+#include "testSocket.h"
+#include "testOpenGL.h"
+#include "testVulkan.h"
+#include "testZip.h"
+#include "testFileMapping.h"
 #include "testSSE.h"
 #include "testSSE2.h"
 
@@ -8463,6 +8474,85 @@ void testSetNLE0x39f() {
     doTestSet(0x39f, true, OF, 0x7fffffff, 0xffffffff);
 }
 
+// a ret is predicted from the call that came before it, that must not hide the code at the return address changing
+void testCallRet() {
+    cpu->big = 1;
+    for (int i = 0; i < 2; i++) {
+        newInstruction(0);
+        pushCode8(0xeb); // jmp over the function
+        pushCode8(0x01);
+        pushCode8(0xc3); // ret
+        pushCode8(0xe8); // call the function
+        pushCode32(-6);
+        pushCode8(i ? 0x48 : 0x40); // dec eax : inc eax
+        runTestCPU();
+        assertTrue(EAX == (i ? 0xFFFFFFFF : 1));
+        assertTrue(ESP == 4096);
+    }
+}
+
+#ifdef BOXEDWINE_X64
+// The loop's chunk is entered more than X64_HOT_CHUNK_COUNT times, so it is translated again as a superblock that
+// runs through the short jmp and replaces the chunk the jmp goes to.
+void testSuperblock() {
+    const U32 loops = X64_HOT_CHUNK_COUNT + 1000;
+
+    cpu->big = 1;
+    x64CPU::useHotChunkCounters = true;
+
+    // the counter of a released chunk is reused by the next chunk
+    newInstruction(0);
+    pushCode8(0x40); // inc eax
+    pushCode8(0xcd);
+    pushCode8(0x97);
+    ((BtCPU*)cpu)->translateEip(cpu->eip.u32);
+    size_t counters = memory->hotChunkCounters.size();
+    std::shared_ptr<BtCodeChunk> chunk = memory->getCodeChunkContainingEip(CODE_ADDRESS);
+    if (!chunk) {
+        failed("chunk missing");
+        return;
+    }
+    chunk->release(memory);
+    if (memory->freeHotChunkCounters.size() != 1) {
+        failed("the released chunk's counter wasn't freed");
+    }
+    ((BtCPU*)cpu)->translateEip(cpu->eip.u32);
+    if (memory->hotChunkCounters.size() != counters || memory->freeHotChunkCounters.size()) {
+        failed("the counter wasn't reused");
+    }
+    cpu->run();
+    assertTrue(EAX == 1);
+    memory->clearCodePageFromCache(CODE_ADDRESS >> K_PAGE_SHIFT);
+
+    newInstruction(0);
+    pushCode8(0xb9); // mov ecx, loops
+    pushCode32(loops);
+    pushCode8(0xeb); // jmp 7, so that the loop starts its own chunk
+    pushCode8(0x00);
+    pushCode8(0x83); // 7: add eax, 1
+    pushCode8(0xc0);
+    pushCode8(0x01);
+    pushCode8(0xeb); // jmp 12
+    pushCode8(0x00);
+    pushCode8(0x49); // 12: dec ecx
+    pushCode8(0x75); // jnz 7
+    pushCode8(0xf8);
+    pushCode8(0xcd);
+    pushCode8(0x97);
+    ((BtCPU*)cpu)->translateEip(cpu->eip.u32);
+    cpu->run();
+    assertTrue(EAX == loops);
+    assertTrue(ECX == 0);
+    chunk = memory->getCodeChunkContainingEip(CODE_ADDRESS + 7);
+    if (!chunk || chunk->getEip() != CODE_ADDRESS + 7 || !chunk->containsEip(CODE_ADDRESS + 12)) {
+        failed("the loop wasn't translated as a superblock");
+    }
+    memory->clearCodePageFromCache(CODE_ADDRESS >> K_PAGE_SHIFT);
+    ((BtCPU*)cpu)->postTestRun();
+    x64CPU::useHotChunkCounters = false;
+}
+#endif
+
 void run(void (*functionPtr)(), const char* name) {
     didFail = 0;
     setup();
@@ -9180,6 +9270,13 @@ void test16BitMemoryAccess() {
 
 
 int main(int argc, char **argv) {	
+    // the benchmarks only print timings, so they are left out unless asked for to keep this a pass/fail run
+    bool benchmark = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-benchmark")) {
+            benchmark = true;
+        }
+    }
     printf("Please wait, these first 2 tests can take a while\n");
     run(test32BitMemoryAccess, "32-bit Memory Access");
     run(test16BitMemoryAccess, "16-bit Memory Access");
@@ -9980,8 +10077,60 @@ int main(int argc, char **argv) {
     run(testMmxPaddw, "PADDW 3fd (mmx)");
     run(testSse2Paddd1fe, "PADDD 1FE (sse2)");
     run(testMmxPaddd, "PADDD 3fe (mmx)");                                  
+    run(testCallRet, "Call/Ret");
+#ifdef BOXEDWINE_X64
+    run(testSuperblock, "Superblock");
+#endif
             
 
+    run(testTimerQueue, "Timer Queue");
+    run(testRunTimers, "Run Timers");
+    if (benchmark) {
+        benchmarkTimerQueue();
+    }
+    run(testDecodedOpPool, "Decoded Op Pool");
+    if (benchmark) {
+        benchmarkDecoder();
+    }
+    run(testSpscRing, "SPSC Ring");
+    run(testAudioConverter, "Audio Converter");
+    if (benchmark) {
+        benchmarkAudioConvert();
+    }
+    run(testUnixSocket, "Unix Socket");
+    if (benchmark) {
+        benchmarkUnixSocket();
+    }
+    run(testZipReads, "Zip Reads");
+    run(testLazyFilePages, "Lazy File Pages");
+    run(testSharedFilePages, "Shared File Pages");
+#ifdef BOXEDWINE_OPENGL
+    run(testOpenGLBatch, "OpenGL Batch");
+    if (benchmark) {
+        benchmarkOpenGLCalls();
+    }
+    run(testOpenGLProfile, "OpenGL Profile");
+    run(testOpenGLIndexRange, "OpenGL Index Range");
+    run(testOpenGLVertexRange, "OpenGL Vertex Range");
+    run(testOpenGLThread, "OpenGL Thread");
+    run(testOpenGLThreadDraw, "OpenGL Thread Draw");
+    if (benchmark) {
+        benchmarkOpenGLThread();
+    }
+#endif
+    run(testVulkanArena, "Vulkan Arena");
+#ifdef BOXEDWINE_VULKAN
+    if (benchmark) {
+        benchmarkVulkanMarshal();
+    }
+#endif
+#ifdef BOXEDWINE_64BIT_MMU
+    run(testForkMemory, "Fork Memory");
+    if (benchmark) {
+        benchmarkFork();
+    }
+#endif
+
     printf("%d tests FAILED\n", totalFails);
     KNativeThread::sleep(5000);
     if (totalFails)
@@ -0,0 +1,190 @@
+#include "boxedwine.h"
+
+#ifdef __TEST
+
+#include <stdio.h>
+
+#include "testCPU.h"
+#include "testDecoder.h"
+#include "knativethread.h"
+
+static std::vector<U8> decoderTestCode;
+
+static void initDecoderTestCode() {
+    if (decoderTestCode.size()) {
+        return;
+    }
+    for (U32 i = 0; i < 30; i++) {
+        U8 add[] = {0x83, 0xc0, 0x02}; // add eax, 2
+        U8 mov[] = {0x8b, 0x45, 0x08}; // mov eax, [ebp+8]
+        decoderTestCode.insert(decoderTestCode.end(), add, add + 3);
+        decoderTestCode.insert(decoderTestCode.end(), mov, mov + 3);
+    }
+    decoderTestCode.push_back(0xc3); // ret
+}
+
+static U8 decoderTestFetchByte(U32* eip) {
+    return decoderTestCode[(*eip)++];
+}
+
+static void decodeTestBlock(DecodedBlock* block) {
+    decodeBlock(decoderTestFetchByte, 0, true, 0, 0, 0, block);
+}
+
+void testDecodedOpPool() {
+    initDecoderTestCode();
+
+    DecodedBlock block;
+    std::vector<DecodedOp*> ops;
+
+    decodeTestBlock(&block);
+    for (DecodedOp* op = block.op; op; op = op->next) {
+        ops.push_back(op);
+    }
+    if (ops.size() != 61) {
+        failed("decoded %d ops instead of 61", (U32)ops.size());
+        return;
+    }
+    block.op->dealloc(true);
+
+    // the block was freed in one shot, decoding it again should reuse the same ops in the same order
+    decodeTestBlock(&block);
+    U32 i = 0;
+    for (DecodedOp* op = block.op; op; op = op->next, i++) {
+        if (i >= ops.size() || op != ops[i]) {
+            failed("op %d was not reused in order", i);
+            break;
+        }
+    }
+    block.op->dealloc(true);
+}
+
+// The free list DecodedOp used before SlabPool, every alloc and free took the same mutex
+static DecodedOp* mutexFreeOps;
+static BOXEDWINE_MUTEX mutexFreeOpsMutex;
+
+static DecodedOp* mutexFreeListAlloc() {
+    BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(mutexFreeOpsMutex);
+    if (mutexFreeOps) {
+        DecodedOp* result = mutexFreeOps;
+        mutexFreeOps = mutexFreeOps->next;
+        return new (result) DecodedOp(); // the constructor calls init like the old alloc did
+    }
+    return new DecodedOp();
+}
+
+static void mutexFreeListFree(DecodedOp* op) {
+    while (op) {
+        BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(mutexFreeOpsMutex);
+        DecodedOp* next = op->next;
+        op->next = mutexFreeOps;
+        mutexFreeOps = op;
+        op = next;
+    }
+}
+
+enum DecoderBenchmarkAllocator {
+    DecoderBenchmarkSlabPool,
+    DecoderBenchmarkMutexFreeList,
+    DecoderBenchmarkNewDelete,
+    DecoderBenchmarkDecode // decodes the test block with the pool, so the times include the decoder
+};
+
+class DecoderBenchmarkParams {
+public:
+    DecoderBenchmarkAllocator allocator;
+    U32 iterations;
+};
+
+// allocates and frees the ops of a block like the decoder does, one at a time and then the whole chain
+static int benchmarkDecoderThread(void* data) {
+    DecoderBenchmarkParams* params = (DecoderBenchmarkParams*)data;
+    DecodedBlock block;
+
+    for (U32 i = 0; i < params->iterations; i++) {
+        if (params->allocator == DecoderBenchmarkDecode) {
+            decodeTestBlock(&block);
+            block.op->dealloc(true);
+            continue;
+        }
+        DecodedOp* head = NULL;
+        DecodedOp* tail = NULL;
+        for (U32 j = 0; j < 61; j++) {
+            DecodedOp* op;
+            if (params->allocator == DecoderBenchmarkSlabPool) {
+                op = DecodedOp::alloc();
+            } else if (params->allocator == DecoderBenchmarkMutexFreeList) {
+                op = mutexFreeListAlloc();
+            } else {
+                op = new DecodedOp();
+            }
+            op->inst = Nop;
+            if (tail) {
+                tail->next = op;
+            } else {
+                head = op;
+            }
+            tail = op;
+        }
+        if (params->allocator == DecoderBenchmarkSlabPool) {
+            head->dealloc(true);
+        } else if (params->allocator == DecoderBenchmarkMutexFreeList) {
+            mutexFreeListFree(head);
+        } else {
+            while (head) {
+                DecodedOp* next = head->next;
+                delete head;
+                head = next;
+            }
+        }
+    }
+    DecodedOp::releaseThreadCache();
+    return 0;
+}
+
+static U32 benchmarkDecoderThreads(DecoderBenchmarkAllocator allocator, U32 iterations, U32 threadCount) {
+    DecoderBenchmarkParams params;
+    params.allocator = allocator;
+    params.iterations = iterations;
+
+    U64 start = KSystem::getMicroCounter();
+    if (threadCount == 1) {
+        benchmarkDecoderThread(&params);
+    } else {
+        std::vector<KNativeThread*> threads;
+        for (U32 i = 0; i < threadCount; i++) {
+            threads.push_back(KNativeThread::createAndStartThread(benchmarkDecoderThread, "Decoder Benchmark", &params));
+        }
+        for (auto& thread : threads) {
+            thread->wait();
+            delete thread;
+        }
+    }
+    return (U32)(KSystem::getMicroCounter() - start);
+}
+
+static void benchmarkDecoderAllocators(U32 iterations, U32 threadCount) {
+    U32 slabTime = benchmarkDecoderThreads(DecoderBenchmarkSlabPool, iterations, threadCount);
+    U32 mutexTime = benchmarkDecoderThreads(DecoderBenchmarkMutexFreeList, iterations, threadCount);
+    U32 newTime = benchmarkDecoderThreads(DecoderBenchmarkNewDelete, iterations, threadCount);
+    U32 decodeTime = benchmarkDecoderThreads(DecoderBenchmarkDecode, iterations, threadCount);
+    printf("Decoder: %d blocks of 61 ops on %d thread(s): alloc/free with SlabPool %dus, mutex free list %dus, new/delete %dus, decode with SlabPool %dus\n", iterations, threadCount, slabTime, mutexTime, newTime, decodeTime);
+}
+
+// Times the ops of a block being allocated and freed with SlabPool, the mutex free list it replaced and plain
+// new/delete.  This is not a pass/fail test, the times are just printed.
+void benchmarkDecoder() {
+    initDecoderTestCode();
+    benchmarkDecoderAllocators(100000, 1);
+#ifdef BOXEDWINE_MULTI_THREADED
+    // the pools are only thread safe when the mutex is real
+    benchmarkDecoderAllocators(100000, 4);
+#endif
+    while (mutexFreeOps) {
+        DecodedOp* next = mutexFreeOps->next;
+        delete mutexFreeOps;
+        mutexFreeOps = next;
+    }
+}
+
+#endif
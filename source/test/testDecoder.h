@@ -0,0 +1,7 @@
+#ifndef __TEST_DECODER_H__
+#define __TEST_DECODER_H__
+
+void testDecodedOpPool();
+void benchmarkDecoder();
+
+#endif
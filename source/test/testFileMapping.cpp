@@ -0,0 +1,150 @@
+#include "boxedwine.h"
+
+#ifdef __TEST
+
+#include <stdio.h>
+
+#include "testCPU.h"
+#include "testZip.h"
+#include "testFileMapping.h"
+
+#if defined(BOXEDWINE_LAZY_FILE_PAGES) && defined(BOXEDWINE_ZLIB)
+#include "../emulation/hardmmu/hard_memory.h"
+
+#define FILE_MAPPING_TEST_ADDRESS 0xC0000000
+
+static bool isLazy(Memory* memory, U32 address) {
+    return (memory->nativeFlags[memory->getNativePage(address >> K_PAGE_SHIFT)] & NATIVE_FLAG_LAZY) != 0;
+}
+
+// a zip entry is never mapped from a host file, so all of its pages wait to be read until they are used
+void testLazyFilePages() {
+    std::vector<TestZipEntry> entries(1);
+    std::vector<U8>& data = entries[0].data;
+    const U32 len = 4 * K_PAGE_SIZE + 100;
+
+    entries[0].name = "lazy.bin";
+    fillTestZipData(data, len, 3);
+    if (!addTestZip("lazyPages", entries)) {
+        return;
+    }
+    KProcess* process = cpu->thread->process.get();
+    Memory* memory = cpu->thread->memory;
+    U32 fd = process->open("/lazyPages/lazy.bin", K_O_RDONLY);
+    if ((S32)fd < 0) {
+        failed("could not open lazy.bin");
+        return;
+    }
+    U32 address = process->mmap(FILE_MAPPING_TEST_ADDRESS, len, K_PROT_READ, K_MAP_PRIVATE | K_MAP_FIXED, fd, 0);
+    if (address != FILE_MAPPING_TEST_ADDRESS) {
+        failed("mmap failed: %X", address);
+        process->close(fd);
+        return;
+    }
+    for (U32 i = 0; i < 5; i++) {
+        if (!isLazy(memory, address + i * K_PAGE_SIZE)) {
+            failed("page %d was read when it was mapped", i);
+        }
+    }
+
+    // what signalHandler() does for a fault in translated code
+    if (!memory->loadLazyFilePage((void*)(memory->id + address + 5), false)) {
+        failed("a read fault on a lazy page should be retried");
+    }
+    if (isLazy(memory, address) || memcmp(getNativeAddress(memory, address), data.data(), K_PAGE_SIZE)) {
+        failed("the faulting page was not read");
+    }
+    if (!isLazy(memory, address + K_PAGE_SIZE)) {
+        failed("only the faulting page should be read");
+    }
+    if (!memory->loadLazyFilePage((void*)(memory->id + address + 5), false)) {
+        failed("a read fault on a page another thread just read should be retried");
+    }
+    if (memory->loadLazyFilePage((void*)(memory->id + address + 5), true)) {
+        failed("a write to a read only mapping is a real fault");
+    }
+    if (memory->loadLazyFilePage((void*)(memory->id + HEAP_ADDRESS), false)) {
+        failed("a page that isn't mapped from a file is a real fault");
+    }
+
+    // host code reads the pages before it touches them, here a read that crosses into page 1
+    U32 expected;
+    memcpy(&expected, data.data() + K_PAGE_SIZE - 2, 4);
+    if (readd(address + K_PAGE_SIZE - 2) != expected) {
+        failed("readd across pages returned the wrong value");
+    }
+    if (isLazy(memory, address + K_PAGE_SIZE)) {
+        failed("readd did not read the second page");
+    }
+    U8* p = getPhysicalReadAddress(address + 2 * K_PAGE_SIZE, 2 * K_PAGE_SIZE);
+    if (isLazy(memory, address + 2 * K_PAGE_SIZE) || isLazy(memory, address + 3 * K_PAGE_SIZE)) {
+        failed("getPhysicalReadAddress did not read all the pages");
+    } else if (memcmp(p, data.data() + 2 * K_PAGE_SIZE, 2 * K_PAGE_SIZE)) {
+        failed("getPhysicalReadAddress returned the wrong data");
+    }
+
+    // the last page is only partly in the file, the rest of it is 0
+    U8 buffer[200];
+    memcopyToNative(address + 4 * K_PAGE_SIZE, buffer, 200);
+    if (memcmp(buffer, data.data() + 4 * K_PAGE_SIZE, 100)) {
+        failed("memcopyToNative returned the wrong data");
+    }
+    for (U32 i = 100; i < 200; i++) {
+        if (buffer[i]) {
+            failed("the part of the last page after the file is not 0");
+            break;
+        }
+    }
+    for (U32 i = 0; i < 5; i++) {
+        if (memory->isLazyFilePage((void*)(memory->id + address + i * K_PAGE_SIZE))) {
+            failed("page %d still needs to be read", i);
+        }
+    }
+    process->unmap(address, len);
+    process->close(fd);
+}
+
+// every mapping of a file shares one copy of its pages, files that only look alike do not
+void testSharedFilePages() {
+    std::vector<TestZipEntry> entries(2);
+
+    entries[0].name = "a.bin";
+    fillTestZipData(entries[0].data, 2 * K_PAGE_SIZE, 4);
+    entries[1].name = "b.bin";
+    entries[1].data = entries[0].data; // same crc and length
+    if (!addTestZip("sharedPages1", entries) || !addTestZip("sharedPages2", entries)) {
+        return;
+    }
+    BoxedPtr<FsNode> a = Fs::getNodeFromLocalPath("", "/sharedPages1/a.bin", true);
+    BoxedPtr<FsNode> b = Fs::getNodeFromLocalPath("", "/sharedPages1/b.bin", true);
+    BoxedPtr<FsNode> otherA = Fs::getNodeFromLocalPath("", "/sharedPages2/a.bin", true);
+    if (!a || !b || !otherA) {
+        failed("the zip entries were not added");
+        return;
+    }
+    std::shared_ptr<SharedFilePages> pages = SharedFilePages::get(a);
+    if (!pages) {
+        failed("the pages of a zip entry should be shared");
+        return;
+    }
+    if (SharedFilePages::get(Fs::getNodeFromLocalPath("", "/sharedPages1/a.bin", true)) != pages) {
+        failed("two mappings of the same file should share its pages");
+    }
+    std::shared_ptr<SharedFilePages> bPages = SharedFilePages::get(b);
+    if (!bPages || bPages == pages) {
+        failed("another entry with the same crc and length should have its own pages");
+    }
+    std::shared_ptr<SharedFilePages> otherPages = SharedFilePages::get(otherA);
+    if (!otherPages || otherPages == pages) {
+        failed("the same entry in another zip file should have its own pages");
+    }
+}
+#else
+void testLazyFilePages() {
+}
+
+void testSharedFilePages() {
+}
+#endif
+
+#endif
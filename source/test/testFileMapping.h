@@ -0,0 +1,7 @@
+#ifndef __TEST_FILE_MAPPING_H__
+#define __TEST_FILE_MAPPING_H__
+
+void testLazyFilePages();
+void testSharedFilePages();
+
+#endif
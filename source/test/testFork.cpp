@@ -0,0 +1,133 @@
+#include "boxedwine.h"
+
+#if defined(__TEST) && defined(BOXEDWINE_64BIT_MMU)
+
+#include <stdio.h>
+
+#include "testCPU.h"
+#include "testFork.h"
+#include "../emulation/hardmmu/hard_memory.h"
+#ifdef BOXEDWINE_POSIX
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#define FORK_TEST_PAGE 0x10000
+
+static U32* getTestPage(Memory* memory, U32 page) {
+    return (U32*)getNativeAddress(memory, (FORK_TEST_PAGE + page) << K_PAGE_SHIFT);
+}
+
+static Memory* createTestMemory(U32 pageCount) {
+    Memory* memory = new Memory();
+    memory->allocPages(FORK_TEST_PAGE, pageCount, PAGE_READ | PAGE_WRITE, 0, 0, 0);
+    for (U32 i = 0; i < pageCount; i++) {
+        *getTestPage(memory, i) = i;
+    }
+    return memory;
+}
+
+static Memory* forkMemory(Memory* from) {
+    Memory* memory = new Memory();
+    memory->clone(from);
+    return memory;
+}
+
+#ifdef BOXEDWINE_POSIX
+// the kernel reports EFAULT instead of faulting if it can't read the page
+static bool isHostReadable(void* p) {
+    int fds[2];
+    if (pipe(fds)) {
+        return true;
+    }
+    bool result = write(fds[1], p, 4) == 4 || errno != EFAULT;
+    close(fds[0]);
+    close(fds[1]);
+    return result;
+}
+#endif
+
+void testForkMemory() {
+    const U32 pageCount = 64;
+    Memory* parent = createTestMemory(pageCount);
+    Memory* child = forkMemory(parent);
+
+    for (U32 i = 0; i < pageCount; i++) {
+        if (*getTestPage(child, i) != i) {
+            failed("child does not have the parent's pages");
+            break;
+        }
+    }
+    *getTestPage(parent, 0) = 1000;
+    *getTestPage(child, 1) = 1001;
+    if (*getTestPage(child, 0) != 0) {
+        failed("child saw a write from the parent");
+    }
+    if (*getTestPage(parent, 1) != 1) {
+        failed("parent saw a write from the child");
+    }
+
+    // a second fork has to see what the parent wrote and allocated after the first one
+    parent->allocPages(FORK_TEST_PAGE + pageCount, 1, PAGE_READ | PAGE_WRITE, 0, 0, 0);
+    *getTestPage(parent, pageCount) = 1002;
+    Memory* child2 = forkMemory(parent);
+    if (*getTestPage(child2, 0) != 1000 || *getTestPage(child2, 1) != 1 || *getTestPage(child2, 2) != 2 || *getTestPage(child2, pageCount) != 1002) {
+        failed("second fork does not match the parent");
+    }
+
+    // the pages have to outlive the parent
+    Memory* grandChild = forkMemory(child);
+    parent->decRefCount();
+    if (*getTestPage(grandChild, 0) != 0 || *getTestPage(grandChild, 1) != 1001 || *getTestPage(grandChild, 3) != 3) {
+        failed("fork of a fork does not match its parent");
+    }
+    *getTestPage(child, 3) = 1003;
+    if (*getTestPage(grandChild, 3) != 3 || *getTestPage(child2, 3) != 3) {
+        failed("fork saw a write from its parent");
+    }
+    child->decRefCount();
+    child2->decRefCount();
+    grandChild->decRefCount();
+
+#ifdef BOXEDWINE_POSIX
+    // execute only pages are readable on the host, in both the parent and the child
+    parent = createTestMemory(1);
+    parent->allocPages(FORK_TEST_PAGE + 1, 1, PAGE_EXEC, 0, 0, 0);
+    child = forkMemory(parent);
+    if (!isHostReadable(getTestPage(child, 1))) {
+        failed("an execute only page can't be read in the child");
+    }
+    if (!isHostReadable(getTestPage(parent, 1))) {
+        failed("an execute only page can't be read in the parent after the fork");
+    }
+    child->decRefCount();
+    parent->decRefCount();
+#endif
+}
+
+// Times a fork that is followed by an exec, like Wine starting a helper process, so the child's memory is thrown
+// away right after it was cloned.  This is not a pass/fail test, the times are just printed.
+void benchmarkFork() {
+    const U32 pageCount = 16384;
+    const U32 iterations = 20;
+    Memory* parent = createTestMemory(pageCount);
+    U64 times[2];
+
+    for (U32 copyOnWrite = 0; copyOnWrite < 2; copyOnWrite++) {
+        KSystem::copyOnWriteFork = copyOnWrite != 0;
+        U64 start = KSystem::getMicroCounter();
+        for (U32 i = 0; i < iterations; i++) {
+            Memory* child = forkMemory(parent);
+            child->reset();
+            child->decRefCount();
+            // the parent keeps running between forks
+            *getTestPage(parent, i) = i + 1;
+        }
+        times[copyOnWrite] = KSystem::getMicroCounter() - start;
+    }
+    KSystem::copyOnWriteFork = true;
+    parent->decRefCount();
+    printf("Fork+exec: %dMB, %d forks: copy %dus, copy-on-write %dus\n", (pageCount << K_PAGE_SHIFT) >> 20, iterations, (U32)times[0], (U32)times[1]);
+}
+
+#endif
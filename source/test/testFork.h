@@ -0,0 +1,7 @@
+#ifndef __TEST_FORK_H__
+#define __TEST_FORK_H__
+
+void testForkMemory();
+void benchmarkFork();
+
+#endif
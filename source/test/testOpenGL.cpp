@@ -0,0 +1,609 @@
+#include "boxedwine.h"
+
+#ifdef __TEST
+#ifdef BOXEDWINE_OPENGL
+
+#include <stdio.h>
+
+#include "testCPU.h"
+#include "testOpenGL.h"
+#include "../../tools/opengl/gldef.h"
+#include "../opengl/glthread.h"
+#include "../opengl/glprofiler.h"
+#include GLH
+#include "../opengl/glcommon.h"
+#include "../opengl/glMarshal.h"
+
+// offset in the heap segment, the guest code uses DS relative addresses and the batch is passed as a linear address
+#define GL_TEST_BATCH 0x1000
+#define GL_TEST_MAX_CALLS 16
+
+static Int99Callback glTestCallbacks[GL_FUNC_COUNT];
+static U32 glTestCalls;
+static U32 glTestArgs[GL_TEST_MAX_CALLS][4];
+static U32 glTestSum;
+static U32 glTestCodeSize;
+
+static void glTestRecord(CPU* cpu) {
+    if (glTestCalls < GL_TEST_MAX_CALLS) {
+        for (U32 i = 0; i < 4; i++) {
+            glTestArgs[glTestCalls][i] = cpu->peek32(i);
+        }
+    }
+    glTestCalls++;
+}
+
+// the arg points at 3 values, like glVertex3fv
+static void glTestRecordVector(CPU* cpu) {
+    U32 address = cpu->peek32(1);
+    if (glTestCalls < GL_TEST_MAX_CALLS) {
+        glTestArgs[glTestCalls][0] = cpu->peek32(0);
+        for (U32 i = 0; i < 3; i++) {
+            glTestArgs[glTestCalls][i + 1] = readd(address + i * 4);
+        }
+    }
+    glTestCalls++;
+}
+
+static void glTestCount(CPU* cpu) {
+    glTestSum += cpu->peek32(1) + cpu->peek32(2) + cpu->peek32(3);
+    glTestCalls++;
+}
+
+static void glTestBatch(CPU* cpu) {
+    callOpenGLBatch(cpu, cpu->peek32(1), cpu->peek32(2));
+}
+
+class GLTestCallbacks {
+public:
+    GLTestCallbacks() : callbacks(int99Callback), size(int99CallbackSize) {
+        memset(glTestCallbacks, 0, sizeof(glTestCallbacks));
+        glTestCallbacks[GLBatch] = glTestBatch;
+        int99Callback = glTestCallbacks;
+        int99CallbackSize = GL_FUNC_COUNT;
+        glTestCalls = 0;
+        glTestSum = 0;
+    }
+    ~GLTestCallbacks() {
+        int99Callback = this->callbacks;
+        int99CallbackSize = this->size;
+    }
+private:
+    Int99Callback* callbacks;
+    U32 size;
+};
+
+static void glCode8(U32 value) {
+    pushCode8(value);
+    glTestCodeSize++;
+}
+
+static void glCode32(U32 value) {
+    pushCode32(value);
+    glTestCodeSize += 4;
+}
+
+static void glNewCode() {
+    newInstruction(0);
+    glTestCodeSize = 0;
+}
+
+// jnz back to start
+static void glCodeLoop(U32 start) {
+    glCode8(0x75);
+    glCode8((U8)(start - (glTestCodeSize + 1)));
+}
+
+static void glCodePush(U32 value) {
+    glCode8(0x68);
+    glCode32(value);
+}
+
+// push the args and the index then int 0x99, the way the guest libGL makes a call
+static void glCodeCall(U32 index, U32 arg1, U32 arg2, U32 arg3) {
+    glCodePush(arg3);
+    glCodePush(arg2);
+    glCodePush(arg1);
+    glCodePush(index);
+    glCode8(0xcd); // int 0x99
+    glCode8(0x99);
+    glCode8(0x83); // add esp, 16
+    glCode8(0xc4);
+    glCode8(16);
+}
+
+static void glCodeBatch(U32 words) {
+    glCodePush(words);
+    glCodePush(HEAP_ADDRESS + GL_TEST_BATCH);
+    glCodePush(GLBatch);
+    glCode8(0xcd); // int 0x99
+    glCode8(0x99);
+    glCode8(0x83); // add esp, 12
+    glCode8(0xc4);
+    glCode8(12);
+}
+
+static void checkGLCall(U32 call, U32 index, U32 arg1, U32 arg2, U32 arg3) {
+    if (glTestArgs[call][0] != index || glTestArgs[call][1] != arg1 || glTestArgs[call][2] != arg2 || glTestArgs[call][3] != arg3) {
+        failed("call %d: index=%d args=%d,%d,%d", call, glTestArgs[call][0], glTestArgs[call][1], glTestArgs[call][2], glTestArgs[call][3]);
+    }
+}
+
+void testOpenGLBatch() {
+    GLTestCallbacks callbacks;
+    glTestCallbacks[Vertex3f] = glTestRecord;
+    glTestCallbacks[End] = glTestRecord;
+    glTestCallbacks[Vertex3fv] = glTestRecordVector;
+
+    U32 address = HEAP_ADDRESS + GL_TEST_BATCH;
+    U32 calls[] = {
+        5, Vertex3f, 1, 2, 3,
+        2, End,
+        // the values the pointer points to are copied in after it
+        6, Vertex3fv, address + 9 * 4, 10, 20, 30,
+        5, Vertex3f, 4, 5, 6
+    };
+    U32 count = sizeof(calls) / sizeof(calls[0]);
+    for (U32 i = 0; i < count; i++) {
+        writed(address + i * 4, calls[i]);
+    }
+
+    glNewCode();
+    glCodeBatch(count);
+    runTestCPU();
+    if (glTestCalls != 4) {
+        failed("%d calls instead of 4", glTestCalls);
+        return;
+    }
+    checkGLCall(0, Vertex3f, 1, 2, 3);
+    if (glTestArgs[1][0] != End) {
+        failed("call 1 wasn't End");
+    }
+    checkGLCall(2, Vertex3fv, 10, 20, 30);
+    checkGLCall(3, Vertex3f, 4, 5, 6);
+    if (cpu->reg[4].u32 != 4096) {
+        failed("ESP wasn't restored");
+    }
+}
+
+// glVertex3f sized calls made from emulated code, first each with its own int 0x99 like before the guest libGL
+// batched them, then written to memory and sent in batches of 256 like it does now.  This is not a pass/fail test,
+// the rates are just printed.
+void benchmarkOpenGLCalls() {
+    const U32 batchSize = 256;
+    const U32 batches = 4000;
+    const U32 iterations = batchSize * batches;
+    GLTestCallbacks callbacks;
+    glTestCallbacks[Vertex3f] = glTestCount;
+
+    glNewCode();
+    glCode8(0xb9); // mov ecx, iterations
+    glCode32(iterations);
+    U32 loop = glTestCodeSize;
+    glCodeCall(Vertex3f, 1, 2, 3);
+    glCode8(0x49); // dec ecx
+    glCodeLoop(loop);
+    U64 start = KSystem::getMicroCounter();
+    runTestCPU();
+    U64 trapTime = KSystem::getMicroCounter() - start;
+    U32 trapCalls = glTestCalls;
+
+    glTestCalls = 0;
+    glNewCode();
+    glCode8(0xbb); // mov ebx, batches
+    glCode32(batches);
+    U32 outer = glTestCodeSize;
+    glCode8(0xbf); // mov edi, GL_TEST_BATCH
+    glCode32(GL_TEST_BATCH);
+    glCode8(0xb9); // mov ecx, batchSize
+    glCode32(batchSize);
+    U32 inner = glTestCodeSize;
+    glCode8(0xc7); // mov dword [edi], 5
+    glCode8(0x07);
+    glCode32(5);
+    U32 values[] = {Vertex3f, 1, 2, 3};
+    for (U32 i = 0; i < 4; i++) {
+        glCode8(0xc7); // mov dword [edi + 4 + i * 4], value
+        glCode8(0x47);
+        glCode8(4 + i * 4);
+        glCode32(values[i]);
+    }
+    glCode8(0x83); // add edi, 20
+    glCode8(0xc7);
+    glCode8(20);
+    glCode8(0x49); // dec ecx
+    glCodeLoop(inner);
+    glCodeBatch(batchSize * 5);
+    glCode8(0x4b); // dec ebx
+    glCodeLoop(outer);
+    start = KSystem::getMicroCounter();
+    runTestCPU();
+    U64 batchTime = KSystem::getMicroCounter() - start;
+
+    if (trapCalls != iterations || glTestCalls != iterations) {
+        failed("%d and %d calls instead of %d", trapCalls, glTestCalls, iterations);
+    }
+    if (!trapTime) {
+        trapTime = 1;
+    }
+    if (!batchTime) {
+        batchTime = 1;
+    }
+    printf("OpenGL calls: %d calls, one int 0x99 each %dus (%d calls/sec), batched %dus (%d calls/sec)\n", iterations, (U32)trapTime, (U32)(iterations * 1000000ull / trapTime), (U32)batchTime, (U32)(iterations * 1000000ull / batchTime));
+}
+
+static bool glProfileHas(const std::string& json, const char* name, U32 index, U32 calls) {
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "{\"name\":\"%s\",\"index\":%u,\"calls\":%u,", name, index, calls);
+    return json.find(buffer) != std::string::npos;
+}
+
+void testOpenGLProfile() {
+    GLTestCallbacks callbacks;
+    glTestCallbacks[Vertex3f] = glTestRecord;
+    glTestCallbacks[End] = glTestRecord;
+
+    U32 address = HEAP_ADDRESS + GL_TEST_BATCH;
+    U32 calls[] = {
+        5, Vertex3f, 1, 2, 3,
+        5, Vertex3f, 4, 5, 6,
+        2, End
+    };
+    U32 count = sizeof(calls) / sizeof(calls[0]);
+    for (U32 i = 0; i < count; i++) {
+        writed(address + i * 4, calls[i]);
+    }
+
+    glProfileStart("");
+    glNewCode();
+    glCodeCall(Vertex3f, 7, 8, 9);
+    glCodeBatch(count);
+    runTestCPU();
+    glProfileFrame();
+    std::string json = glProfileJson();
+    glProfileStop();
+
+    // the calls in the batch are counted on their own
+    if (!glProfileHas(json, "Vertex3f", Vertex3f, 3) || !glProfileHas(json, "End", End, 1) || !glProfileHas(json, "Batch", GLBatch, 1)) {
+        failed("wrong call counts: %s", json.c_str());
+    }
+    if (json.find("{\"frames\":1,") != 0 || json.find("{\"frame\":1,") == std::string::npos) {
+        failed("frame missing: %s", json.c_str());
+    }
+}
+
+template<typename T> static void glTestIndexRange(GLenum type, U32 count, U32 offset, U32 seed) {
+    std::vector<T> indices(count + offset);
+    U32 low = 0xFFFFFFFF;
+    U32 high = 0;
+    U32 expectedLow = 0xFFFFFFFF;
+    U32 expectedHigh = 0;
+
+    for (U32 i = 0; i < count; i++) {
+        seed = seed * 1103515245 + 12345;
+        T index = (T)(seed ^ (seed >> 16));
+        if (i == count / 2) {
+            index = 0; // the extremes must survive the signed compares
+        } else if (i == count / 3) {
+            index = (T)0xFFFFFFFF;
+        }
+        indices[offset + i] = index;
+        expectedLow = std::min(expectedLow, (U32)index);
+        expectedHigh = std::max(expectedHigh, (U32)index);
+    }
+    glIndexRange(indices.data() + offset, type, count, &low, &high);
+    if (low != expectedLow || high != expectedHigh) {
+        failed("type %X count %d offset %d: got %X-%X, expected %X-%X", type, count, offset, low, high, expectedLow, expectedHigh);
+    }
+}
+
+void testOpenGLIndexRange() {
+    U32 counts[] = {1, 3, 4, 7, 8, 15, 16, 17, 33, 100, 1000};
+
+    for (U32 count : counts) {
+        for (U32 offset = 0; offset < 3; offset++) {
+            glTestIndexRange<U8>(GL_UNSIGNED_BYTE, count, offset, count);
+            glTestIndexRange<U16>(GL_UNSIGNED_SHORT, count, offset, count);
+            glTestIndexRange<U32>(GL_UNSIGNED_INT, count, offset, count);
+        }
+    }
+    // a range that doesn't start empty is only widened
+    U16 indices[] = {10, 11, 12, 13, 14, 15, 16, 17, 18};
+    U32 low = 5;
+    U32 high = 12;
+    glIndexRange(indices, GL_UNSIGNED_SHORT, 9, &low, &high);
+    if (low != 5 || high != 18) {
+        failed("range wasn't widened: %d-%d", low, high);
+    }
+}
+
+#ifdef BOXEDWINE_64BIT_MMU
+#define GL_TEST_VERTEX_ADDRESS 0xC0000000
+
+static const GLvoid* glTestVertexPointerPtr;
+
+static void OPENGL_CALL_TYPE glTestVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* ptr) {
+    glTestVertexPointerPtr = ptr;
+}
+
+// draws vertices 0 to count and returns what GL was given for vertex 0
+static const U8* glTestDrawVertices(U32 count) {
+    updateVertexPointers(cpu, 0, count);
+    return (const U8*)cpu->thread->glVertextPointer.marshal;
+}
+
+// A client array is checked once and used where it is until the guest's memory is protected or unmapped, an
+// array GL can't read is replaced by a copy with zeros where it can't be read.
+void testOpenGLVertexRange() {
+    KProcess* process = cpu->thread->process.get();
+    Memory* memory = cpu->thread->memory;
+    OpenGLVetexPointer& p = cpu->thread->glVertextPointer;
+    glVertexPointer_func oldVertexPointer = pglVertexPointer;
+    const U32 vertexSize = 16; // 4 floats
+    const U32 firstPageVertices = K_PAGE_SIZE / vertexSize;
+
+    if (process->mmap(GL_TEST_VERTEX_ADDRESS, 2 * K_PAGE_SIZE, K_PROT_READ | K_PROT_WRITE, K_MAP_PRIVATE | K_MAP_ANONYMOUS | K_MAP_FIXED, -1, 0) != GL_TEST_VERTEX_ADDRESS) {
+        failed("mmap failed");
+        return;
+    }
+    for (U32 i = 0; i < 2 * K_PAGE_SIZE; i += 4) {
+        writed(GL_TEST_VERTEX_ADDRESS + i, i + 1);
+    }
+    pglVertexPointer = glTestVertexPointer;
+    p.size = 4;
+    p.type = GL_FLOAT;
+    p.stride = 0;
+    p.ptr = GL_TEST_VERTEX_ADDRESS;
+    p.refreshEachCall = 1;
+    const U8* inPlace = getPhysicalAddress(GL_TEST_VERTEX_ADDRESS, 0);
+
+    if (glTestDrawVertices(2 * firstPageVertices) != inPlace || glTestVertexPointerPtr != inPlace) {
+        failed("a readable array should be used where it is");
+    }
+    if (p.checkedPtr != p.ptr || p.checkedGeneration != memory->protectionGeneration || p.checkedEnd != 2 * K_PAGE_SIZE) {
+        failed("the readable range was not remembered");
+    }
+
+    // protecting the second page makes the cached check stale, the part of the array on it becomes 0
+    process->mprotect(GL_TEST_VERTEX_ADDRESS + K_PAGE_SIZE, K_PAGE_SIZE, K_PROT_NONE);
+    const U8* copy = glTestDrawVertices(firstPageVertices + 2);
+    if (copy == inPlace || copy != p.buffer) {
+        failed("an array that isn't readable should be copied");
+    } else {
+        if (memcmp(copy, inPlace, K_PAGE_SIZE)) {
+            failed("the readable part of the array was not copied");
+        }
+        for (U32 i = 0; i < 2 * vertexSize; i++) {
+            if (copy[K_PAGE_SIZE + i]) {
+                failed("the unreadable part of the array is not 0");
+                break;
+            }
+        }
+    }
+    // the first page alone is still readable
+    if (glTestDrawVertices(firstPageVertices) != inPlace) {
+        failed("the readable part of the array should be used where it is");
+    }
+    process->mprotect(GL_TEST_VERTEX_ADDRESS + K_PAGE_SIZE, K_PAGE_SIZE, K_PROT_READ);
+    if (glTestDrawVertices(2 * firstPageVertices) != inPlace) {
+        failed("the array should be used where it is once it can be read again");
+    }
+
+    // so does unmapping it
+    process->unmap(GL_TEST_VERTEX_ADDRESS + K_PAGE_SIZE, K_PAGE_SIZE);
+    if (glTestDrawVertices(2 * firstPageVertices) != p.buffer) {
+        failed("an unmapped array should be copied");
+    }
+
+    pglVertexPointer = oldVertexPointer;
+    delete[] p.buffer;
+    p = OpenGLVetexPointer();
+    process->unmap(GL_TEST_VERTEX_ADDRESS, K_PAGE_SIZE);
+}
+#else
+void testOpenGLVertexRange() {
+}
+#endif
+
+// stand ins for the host GL functions, only the render thread touches glTestDriverSum while a GLThread is used
+static U32 glTestDriverSum;
+static volatile U32 glTestAppSum;
+
+static U32 glTestBurn(U32 seed, U32 count) {
+    for (U32 i = 0; i < count; i++) {
+        seed = seed * 1664525 + 1013904223;
+    }
+    return seed;
+}
+
+static void OPENGL_CALL_TYPE glTestAdd(U32 value) {
+    glTestDriverSum += value;
+}
+
+static void OPENGL_CALL_TYPE glTestAdd3v(const U32* values) {
+    glTestDriverSum += values[0] + values[1] + values[2];
+}
+
+static U32 OPENGL_CALL_TYPE glTestGetSum() {
+    return glTestDriverSum;
+}
+
+// about as much work as llvmpipe does for a small state change or an immediate mode vertex
+static void OPENGL_CALL_TYPE glTestWork(U32 value) {
+    glTestDriverSum += glTestBurn(value, 200);
+}
+
+static void OPENGL_CALL_TYPE glTestFlush() {
+}
+
+class GLTestThread {
+public:
+    GLTestThread(bool threaded) : thread(KThread::currentThread()), glThread(threaded ? new GLThread("GL Test Render") : NULL) {
+        this->thread->glThread = this->glThread;
+    }
+    ~GLTestThread() {
+        this->thread->glThread = NULL;
+        delete this->glThread;
+    }
+    KThread* thread;
+    GLThread* glThread;
+};
+
+void testOpenGLThread() {
+    if (glThreadIsSync("pglDrawArrays") || glThreadIsSync("pglDrawElements") || glThreadIsSync("ext_glDrawRangeElements") || !glThreadIsSync("ext_glDrawElementsBaseVertex") || !glThreadIsSync("ext_glMultiDrawArrays") || !glThreadIsSync("pglArrayElement") || !glThreadIsSync("pglVertexPointer") || !glThreadIsSync("ext_glVertexAttribPointer") || !glThreadIsSync("pglFlush") || glThreadIsSync("pglVertex3f") || glThreadIsSync("ext_glUniform4fv")) {
+        failed("wrong calls are synchronous");
+    }
+    if (!glThreadChangesBindings("ext_glBindBuffer") || !glThreadChangesBindings("ext_glBindVertexArray") || !glThreadChangesBindings("pglPopClientAttrib") || glThreadChangesBindings("pglVertex3f")) {
+        failed("wrong calls forget the buffer bindings");
+    }
+    GLTestThread test(true);
+    glTestDriverSum = 0;
+
+    // more than a batch, in order
+    U32 expected = 0;
+    for (U32 i = 0; i < 100000; i++) {
+        glThreadCall<false>(glTestAdd)(i);
+        expected += i;
+    }
+    if (glThreadCall<false>(glTestGetSum)() != expected) {
+        failed("queued calls were lost or ran out of order");
+    }
+    if (test.glThread->queuedCalls != 100000) {
+        failed("only %d calls were queued", (U32)test.glThread->queuedCalls);
+    }
+
+    // a marshaled buffer is copied when the call is queued, so it can be reused right away
+    U32 values[3] = {1, 2, 3};
+    glThreadMarshaled(values, 3);
+    glThreadCall<false>(glTestAdd3v)(values);
+    values[0] = 100;
+    values[1] = 200;
+    values[2] = 300;
+    // wasn't marshaled, so the size isn't known and it has to wait
+    glThreadCall<false>(glTestAdd3v)(values);
+    if (test.glThread->queuedCalls != 100001) {
+        failed("the marshaled call wasn't queued or the unknown pointer was");
+    }
+    if (glThreadCall<false>(glTestGetSum)() != expected + 606) {
+        failed("the queued call didn't see a copy of the buffer");
+    }
+}
+
+#define GL_TEST_DRAW_VERTICES 0x2000
+#define GL_TEST_DRAW_INDICES 0x2100
+
+// what GL was given for the vertex array, only the render thread touches it while a GLThread is used
+static const U32* glTestVertices;
+
+static void OPENGL_CALL_TYPE glTestThreadVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* ptr) {
+    glTestVertices = (const U32*)ptr;
+}
+
+static void OPENGL_CALL_TYPE glTestDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    for (GLint i = first; i < first + count; i++) {
+        glTestDriverSum += glTestVertices[i];
+    }
+}
+
+static void OPENGL_CALL_TYPE glTestDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices) {
+    for (GLsizei i = 0; i < count; i++) {
+        glTestDriverSum += glTestVertices[((const U16*)indices)[i]];
+    }
+}
+
+// A draw is queued with a copy of the vertices and indices it reads, so the guest can change them as soon as it
+// returns.  The array is set back to where the guest's pointer is once the draw has run.
+void testOpenGLThreadDraw() {
+    OpenGLVetexPointer& p = cpu->thread->glVertextPointer;
+    glVertexPointer_func oldVertexPointer = pglVertexPointer;
+    U32 vertices = HEAP_ADDRESS + GL_TEST_DRAW_VERTICES;
+    U32 indices = HEAP_ADDRESS + GL_TEST_DRAW_INDICES;
+    GLTestThread test(true);
+
+    for (U32 i = 0; i < 16; i++) {
+        writed(vertices + i * 4, i + 1);
+    }
+    writew(indices, 9);
+    writew(indices + 2, 2);
+    writew(indices + 4, 14);
+    pglVertexPointer = glTestThreadVertexPointer;
+    p.size = 1;
+    p.type = GL_INT;
+    p.stride = 0;
+    p.ptr = vertices;
+    p.refreshEachCall = 1;
+    // no buffer objects, without this ELEMENT_ARRAY_BUFFER() would ask the driver
+    test.glThread->bindings[GL_THREAD_ELEMENT_ARRAY_BUFFER_BINDING] = 0;
+    glTestDriverSum = 0;
+
+    // glDrawArrays(GL_POINTS, 4, 8) and glDrawElements(GL_POINTS, 3, GL_UNSIGNED_SHORT, indices)
+    updateVertexPointersForDraw(cpu, 4, 8);
+    glThreadCall<glThreadIsSync("pglDrawArrays")>(glTestDrawArrays)(GL_POINTS, 4, 8);
+    updateVertexPointersForElements(cpu, 3, GL_UNSIGNED_SHORT, indices);
+    glThreadCall<glThreadIsSync("pglDrawElements")>(glTestDrawElements)(GL_POINTS, 3, GL_UNSIGNED_SHORT, marshalIndices(cpu, 3, GL_UNSIGNED_SHORT, indices));
+    for (U32 i = 0; i < 16; i++) {
+        writed(vertices + i * 4, 1000);
+    }
+    writew(indices, 0);
+    writew(indices + 2, 0);
+    writew(indices + 4, 0);
+    if (test.glThread->queuedCalls != 2) {
+        failed("only %d draws were queued", (U32)test.glThread->queuedCalls);
+    }
+    if (glThreadCall<false>(glTestGetSum)() != 68 + 28) {
+        failed("the queued draws didn't see a copy of the vertices and indices");
+    }
+    if ((const U8*)glTestVertices != p.marshal) {
+        failed("the vertex array wasn't set back after the draw");
+    }
+
+    // an array the draw calls don't refresh might be read, so the draw waits and uses the arrays where they are
+    cpu->thread->glUntrackedClientArrays = true;
+    updateVertexPointersForDraw(cpu, 0, 4);
+    glThreadCall<glThreadIsSync("pglDrawArrays")>(glTestDrawArrays)(GL_POINTS, 0, 4);
+    if (test.glThread->queuedCalls != 2) {
+        failed("a draw with an untracked array was queued");
+    }
+    if (glThreadCall<false>(glTestGetSum)() != 68 + 28 + 4000) {
+        failed("the draw with an untracked array didn't use it where it is");
+    }
+    cpu->thread->glUntrackedClientArrays = false;
+
+    // binding a buffer might change what ELEMENT_ARRAY_BUFFER() returns
+    glThreadCall<false, glThreadChangesBindings("ext_glBindBuffer")>(glTestAdd)(0);
+    if (test.glThread->bindings[GL_THREAD_ELEMENT_ARRAY_BUFFER_BINDING] != GL_THREAD_BINDING_UNKNOWN) {
+        failed("the buffer bindings were kept after a call that might change them");
+    }
+
+    pglVertexPointer = oldVertexPointer;
+    delete[] p.buffer;
+    p = OpenGLVetexPointer();
+}
+
+// Frames made of app work on the emulated thread plus GL calls that keep the driver busy, ending with a flush like
+// glXSwapBuffers does.  Without a GLThread they add up, with one they overlap.  This is not a pass/fail test, the
+// frame times are just printed.
+static U64 glTestFrames(bool threaded, U32 frames, U32 callsPerFrame) {
+    GLTestThread test(threaded);
+    U64 start = KSystem::getMicroCounter();
+    for (U32 frame = 0; frame < frames; frame++) {
+        for (U32 i = 0; i < callsPerFrame; i++) {
+            glTestAppSum = glTestBurn(glTestAppSum + i, 150);
+            glThreadCall<false>(glTestWork)(i);
+        }
+        glThreadCall<true>(glTestFlush)();
+    }
+    return KSystem::getMicroCounter() - start;
+}
+
+void benchmarkOpenGLThread() {
+    const U32 frames = 200;
+    const U32 callsPerFrame = 2000;
+
+    U64 direct = glTestFrames(false, frames, callsPerFrame);
+    U64 threaded = glTestFrames(true, frames, callsPerFrame);
+    printf("OpenGL thread: %d frames of %d calls, direct %dus/frame, render thread %dus/frame\n", frames, callsPerFrame, (U32)(direct / frames), (U32)(threaded / frames));
+}
+
+#endif
+#endif
@@ -0,0 +1,13 @@
+#ifndef __TEST_OPENGL_H__
+#define __TEST_OPENGL_H__
+
+void testOpenGLBatch();
+void benchmarkOpenGLCalls();
+void testOpenGLProfile();
+void testOpenGLIndexRange();
+void testOpenGLVertexRange();
+void testOpenGLThread();
+void testOpenGLThreadDraw();
+void benchmarkOpenGLThread();
+
+#endif
@@ -0,0 +1,90 @@
+#include "boxedwine.h"
+
+#ifdef __TEST
+
+#include <stdio.h>
+
+#include "testCPU.h"
+#include "testRing.h"
+#include "knativethread.h"
+#include "../util/spscring.h"
+
+#define RING_TEST_BYTES (1024 * 1024)
+
+static int ringProducerThread(void* data) {
+    SpscRing* ring = (SpscRing*)data;
+    U8 buffer[100];
+    U32 written = 0;
+
+    while (written < RING_TEST_BYTES) {
+        U32 todo = RING_TEST_BYTES - written;
+        if (todo > sizeof(buffer)) {
+            todo = sizeof(buffer);
+        }
+        for (U32 i = 0; i < todo; i++) {
+            buffer[i] = (U8)(written + i);
+        }
+        U32 done = ring->write(buffer, todo);
+        written += done;
+        if (!done) {
+            KNativeThread::sleep(0);
+        }
+    }
+    return 0;
+}
+
+void testSpscRing() {
+    SpscRing ring;
+    U8 buffer[64];
+
+    ring.alloc(16);
+    // wrap around the end a few times
+    for (U32 i = 0; i < 10; i++) {
+        for (U32 j = 0; j < 12; j++) {
+            buffer[j] = (U8)(i + j);
+        }
+        if (ring.write(buffer, 12) != 12 || ring.size() != 12 || ring.space() != 4) {
+            failed("ring write %d", i);
+            return;
+        }
+        memset(buffer, 0, sizeof(buffer));
+        if (ring.read(buffer, 12) != 12 || ring.size() != 0) {
+            failed("ring read %d", i);
+            return;
+        }
+        for (U32 j = 0; j < 12; j++) {
+            if (buffer[j] != (U8)(i + j)) {
+                failed("ring data %d", i);
+                return;
+            }
+        }
+    }
+    // a full ring only takes what fits, an empty one returns nothing
+    if (ring.write(buffer, 20) != 16 || ring.write(buffer, 1) != 0 || ring.read(buffer, 20) != 16 || ring.read(buffer, 1) != 0) {
+        failed("ring full/empty");
+        return;
+    }
+
+    // one producer and one consumer thread
+    ring.alloc(256);
+    KNativeThread* producer = KNativeThread::createAndStartThread(ringProducerThread, "Ring Producer", &ring);
+    U32 read = 0;
+    while (read < RING_TEST_BYTES) {
+        U32 done = ring.read(buffer, sizeof(buffer));
+        for (U32 i = 0; i < done; i++) {
+            if (buffer[i] != (U8)(read + i)) {
+                failed("ring data out of order at %d", read + i);
+                read = RING_TEST_BYTES;
+                break;
+            }
+        }
+        read += done;
+        if (!done) {
+            KNativeThread::sleep(0);
+        }
+    }
+    producer->wait();
+    delete producer;
+}
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef __TEST_RING_H__
+#define __TEST_RING_H__
+
+void testSpscRing();
+
+#endif
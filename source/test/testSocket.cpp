@@ -0,0 +1,191 @@
+#include "boxedwine.h"
+
+#ifdef __TEST
+
+#include <stdio.h>
+
+#include "testCPU.h"
+#include "testSocket.h"
+#include "kunixsocket.h"
+#include "ksocket.h"
+
+#define SOCKET_TEST_IOV HEAP_ADDRESS
+#define SOCKET_TEST_MSG (HEAP_ADDRESS + 0x100)
+#define SOCKET_TEST_CMSG (HEAP_ADDRESS + 0x200)
+#define SOCKET_TEST_SEND (HEAP_ADDRESS + 0x1000)
+#define SOCKET_TEST_RECV (HEAP_ADDRESS + 0x10000)
+
+static void connectTestSockets(std::shared_ptr<KUnixSocketObject>& a, std::shared_ptr<KUnixSocketObject>& b, U32 type = K_SOCK_STREAM) {
+    a = std::make_shared<KUnixSocketObject>(0, K_AF_UNIX, type, 0);
+    b = std::make_shared<KUnixSocketObject>(0, K_AF_UNIX, type, 0);
+    a->connection = b;
+    b->connection = a;
+    a->connected = true;
+    b->connected = true;
+    a->blocking = false;
+    b->blocking = false;
+}
+
+static void writeTestIov(U32 index, U32 address, U32 len) {
+    writed(SOCKET_TEST_IOV + index * 8, address);
+    writed(SOCKET_TEST_IOV + index * 8 + 4, len);
+}
+
+static void fillTestData(U32 address, U32 len, U32 seed) {
+    for (U32 i = 0; i < len; i++) {
+        writeb(address + i, (U8)(seed + i));
+    }
+}
+
+static bool checkTestData(U32 address, U32 len, U32 seed) {
+    for (U32 i = 0; i < len; i++) {
+        if (readb(address + i) != (U8)(seed + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// msg_iov is at SOCKET_TEST_IOV
+static void writeTestMsgHdr(U32 iovCount, U32 control, U32 controlLen) {
+    writed(SOCKET_TEST_MSG, 0); // msg_name
+    writed(SOCKET_TEST_MSG + 4, 0); // msg_namelen
+    writed(SOCKET_TEST_MSG + 8, SOCKET_TEST_IOV);
+    writed(SOCKET_TEST_MSG + 12, iovCount);
+    writed(SOCKET_TEST_MSG + 16, control);
+    writed(SOCKET_TEST_MSG + 20, controlLen);
+    writed(SOCKET_TEST_MSG + 24, 0); // msg_flags
+}
+
+void testUnixSocket() {
+    std::shared_ptr<KUnixSocketObject> a;
+    std::shared_ptr<KUnixSocketObject> b;
+    connectTestSockets(a, b);
+
+    // gathered from 3 buffers and scattered into 2 of different sizes
+    fillTestData(SOCKET_TEST_SEND, 300, 7);
+    writeTestIov(0, SOCKET_TEST_SEND, 100);
+    writeTestIov(1, SOCKET_TEST_SEND + 100, 150);
+    writeTestIov(2, SOCKET_TEST_SEND + 250, 50);
+    if (a->writev(SOCKET_TEST_IOV, 3) != 300) {
+        failed("writev didn't write everything");
+    }
+    writeTestIov(0, SOCKET_TEST_RECV, 30);
+    writeTestIov(1, SOCKET_TEST_RECV + 30, 1000);
+    if (b->readv(SOCKET_TEST_IOV, 2) != 300 || !checkTestData(SOCKET_TEST_RECV, 300, 7)) {
+        failed("readv didn't get what writev wrote");
+    }
+    if (b->read(SOCKET_TEST_RECV, 10) != (U32)-K_EWOULDBLOCK) {
+        failed("read of an empty socket didn't return EWOULDBLOCK");
+    }
+
+    // wraps around the end of the ring and then grows it while it is wrapped
+    fillTestData(SOCKET_TEST_SEND, 0x8000, 11);
+    a->write(SOCKET_TEST_SEND, 3000);
+    b->read(SOCKET_TEST_RECV, 2000);
+    a->write(SOCKET_TEST_SEND + 3000, 2000);
+    a->write(SOCKET_TEST_SEND + 5000, 6000);
+    if (b->read(SOCKET_TEST_RECV + 2000, 0x8000) != 9000 || !checkTestData(SOCKET_TEST_RECV, 11000, 11)) {
+        failed("ring lost data when it wrapped and grew");
+    }
+
+    // a message with a file descriptor, read in 2 parts
+    KProcess* process = KThread::currentThread()->process.get();
+    KFileDescriptor* fd = process->allocFileDescriptor(a, K_O_RDWR, 0, -1, 0);
+    fillTestData(SOCKET_TEST_SEND, 64, 3);
+    writeTestIov(0, SOCKET_TEST_SEND, 16);
+    writeTestIov(1, SOCKET_TEST_SEND + 16, 48);
+    writed(SOCKET_TEST_CMSG, 16); // cmsg_len
+    writed(SOCKET_TEST_CMSG + 4, K_SOL_SOCKET);
+    writed(SOCKET_TEST_CMSG + 8, K_SCM_RIGHTS);
+    writed(SOCKET_TEST_CMSG + 12, fd->handle);
+    writeTestMsgHdr(2, SOCKET_TEST_CMSG, 16);
+    if (a->sendmsg(fd, SOCKET_TEST_MSG, 0) != 64) {
+        failed("sendmsg didn't send everything");
+    }
+    writed(SOCKET_TEST_CMSG + 12, 0);
+    writeTestIov(0, SOCKET_TEST_RECV, 40);
+    writeTestMsgHdr(1, SOCKET_TEST_CMSG, 16);
+    if (b->recvmsg(NULL, SOCKET_TEST_MSG, 0) != 40 || !checkTestData(SOCKET_TEST_RECV, 40, 3)) {
+        failed("recvmsg didn't get the start of the message");
+    }
+    KFileDescriptor* recvFd = process->getFileDescriptor(readd(SOCKET_TEST_CMSG + 12));
+    if (!recvFd || recvFd == fd || recvFd->kobject != a) {
+        failed("recvmsg didn't pass the file descriptor");
+    }
+    writeTestIov(0, SOCKET_TEST_RECV + 40, 100);
+    if (b->recvmsg(NULL, SOCKET_TEST_MSG, 0) != 24 || !checkTestData(SOCKET_TEST_RECV, 64, 3)) {
+        failed("recvmsg didn't get the rest of the message");
+    }
+    if (b->isReadReady()) {
+        failed("socket is still read ready after the message was read");
+    }
+
+    // the message that was read gets reused
+    writeTestIov(0, SOCKET_TEST_SEND, 64);
+    writeTestMsgHdr(1, 0, 0);
+    a->sendmsg(fd, SOCKET_TEST_MSG, 0);
+    writeTestIov(0, SOCKET_TEST_RECV, 64);
+    if (b->recvmsg(NULL, SOCKET_TEST_MSG, 0) != 64 || !checkTestData(SOCKET_TEST_RECV, 64, 3)) {
+        failed("second message didn't arrive");
+    }
+    if (recvFd) {
+        process->close(recvFd->handle);
+    }
+    process->close(fd->handle);
+
+    // a datagram that doesn't fit is truncated instead of being left for the next read
+    connectTestSockets(a, b, K_SOCK_DGRAM);
+    fd = process->allocFileDescriptor(a, K_O_RDWR, 0, -1, 0);
+    fillTestData(SOCKET_TEST_SEND, 64, 5);
+    writeTestIov(0, SOCKET_TEST_SEND, 64);
+    writeTestMsgHdr(1, 0, 0);
+    a->sendmsg(fd, SOCKET_TEST_MSG, 0);
+    fillTestData(SOCKET_TEST_SEND, 8, 9);
+    writeTestIov(0, SOCKET_TEST_SEND, 8);
+    a->sendmsg(fd, SOCKET_TEST_MSG, 0);
+    writeTestIov(0, SOCKET_TEST_RECV, 40);
+    if (b->recvmsg(NULL, SOCKET_TEST_MSG, 0) != 40 || !checkTestData(SOCKET_TEST_RECV, 40, 5)) {
+        failed("recvmsg didn't get the start of the datagram");
+    }
+    if (!(readd(SOCKET_TEST_MSG + 24) & K_MSG_TRUNC)) {
+        failed("recvmsg didn't set MSG_TRUNC on a truncated datagram");
+    }
+    if (b->recvmsg(NULL, SOCKET_TEST_MSG, 0) != 8 || !checkTestData(SOCKET_TEST_RECV, 8, 9)) {
+        failed("recvmsg didn't drop the rest of the truncated datagram");
+    }
+    if (readd(SOCKET_TEST_MSG + 24) & K_MSG_TRUNC) {
+        failed("recvmsg set MSG_TRUNC on a datagram that fit");
+    }
+    process->close(fd->handle);
+}
+
+// Like a Wine client talking to wineserver: a fixed size request written with writev, then a reply read back.
+// This is not a pass/fail test, the time per round trip is just printed.
+void benchmarkUnixSocket() {
+    const U32 iterations = 200000;
+    const U32 requestSize = 64;
+    const U32 replySize = 32;
+    std::shared_ptr<KUnixSocketObject> client;
+    std::shared_ptr<KUnixSocketObject> server;
+
+    connectTestSockets(client, server);
+    fillTestData(SOCKET_TEST_SEND, requestSize + 256, 1);
+    U64 start = KSystem::getMicroCounter();
+    for (U32 i = 0; i < iterations; i++) {
+        // the request header and its variable part
+        writeTestIov(0, SOCKET_TEST_SEND, requestSize);
+        writeTestIov(1, SOCKET_TEST_SEND + requestSize, i & 255);
+        client->writev(SOCKET_TEST_IOV, 2);
+        server->read(SOCKET_TEST_RECV, requestSize);
+        if (i & 255) {
+            server->read(SOCKET_TEST_RECV + requestSize, i & 255);
+        }
+        server->write(SOCKET_TEST_SEND, replySize);
+        client->read(SOCKET_TEST_RECV, replySize);
+    }
+    U64 time = KSystem::getMicroCounter() - start;
+    printf("Unix socket: %d request/reply round trips in %dus (%dns each)\n", iterations, (U32)time, (U32)(time * 1000 / iterations));
+}
+
+#endif
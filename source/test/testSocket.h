@@ -0,0 +1,7 @@
+#ifndef __TEST_SOCKET_H__
+#define __TEST_SOCKET_H__
+
+void testUnixSocket();
+void benchmarkUnixSocket();
+
+#endif
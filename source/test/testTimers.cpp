@@ -0,0 +1,207 @@
+#include "boxedwine.h"
+
+#ifdef __TEST
+
+#include <stdio.h>
+
+#include "testCPU.h"
+#include "testTimers.h"
+
+class TestTimer : public KTimer {
+public:
+    TestTimer() : listNode(this) {}
+    virtual bool run() {return true;}
+
+    KListNode<TestTimer*> listNode; // for the benchmark against a list
+};
+
+static U32 nextRandom(U32& seed) {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+void testTimerQueue() {
+    const U32 count = 1000;
+    std::vector<TestTimer> timers(count);
+    KTimerQueue queue;
+    U32 seed = 1;
+
+    for (U32 i = 0; i < count; i++) {
+        timers[i].millies = nextRandom(seed) % 5000;
+        queue.add(&timers[i]);
+    }
+    // cancel some and move some, like a thread that is woken up early or a periodic timer
+    for (U32 i = 0; i < count; i += 3) {
+        queue.remove(&timers[i]);
+        if (timers[i].queueIndex != K_TIMER_NOT_QUEUED) {
+            failed("removed timer is still queued");
+        }
+    }
+    for (U32 i = 1; i < count; i += 7) {
+        timers[i].millies = nextRandom(seed) % 5000;
+        queue.add(&timers[i]);
+    }
+    queue.remove(&timers[0]); // already removed
+    if (queue.size() != count - (count + 2) / 3) {
+        failed("wrong number of timers queued");
+    }
+    U32 last = 0;
+    U32 found = 0;
+    while (!queue.isEmpty()) {
+        KTimer* timer = queue.front();
+        if (timer->millies < last) {
+            failed("timers are out of order");
+        }
+        if (((TestTimer*)timer - &timers[0]) % 3 == 0) {
+            failed("removed timer was returned");
+        }
+        last = timer->millies;
+        queue.remove(timer);
+        found++;
+    }
+    if (found != count - (count + 2) / 3) {
+        failed("wrong number of timers returned");
+    }
+
+    // re-arm a queued timer the way alarm and setitimer do, earlier and then later than the others
+    for (U32 i = 0; i < 10; i++) {
+        timers[i].millies = 1000 + i * 100;
+        queue.add(&timers[i]);
+    }
+    timers[5].millies = 10;
+    queue.add(&timers[5]);
+    if (queue.front() != &timers[5]) {
+        failed("re-armed timer should be first");
+    }
+    timers[5].millies = 5000;
+    queue.add(&timers[5]);
+    if (queue.size() != 10) {
+        failed("re-arming a queued timer should not queue it twice");
+    }
+    last = 0;
+    KTimer* timer = NULL;
+    while (!queue.isEmpty()) {
+        timer = queue.front();
+        if (timer->millies < last) {
+            failed("re-armed timers are out of order");
+        }
+        last = timer->millies;
+        queue.remove(timer);
+    }
+    if (timer != &timers[5]) {
+        failed("re-armed timer should be last");
+    }
+}
+
+static U32 timerRuns[3];
+
+class CountingTimer final : public KTimer {
+public:
+    CountingTimer(U32 index, CountingTimer* victim) : index(index), victim(victim) {}
+    virtual bool run() {
+        timerRuns[this->index]++;
+        if (this->victim) {
+            delete this->victim;
+            this->victim = NULL;
+        }
+        return this->index != 1; // 1 keeps running without moving its time
+    }
+
+    U32 index;
+    CountingTimer* victim;
+};
+
+// a timer can delete another timer that is also due, and one that stays due only runs once per call (the deadlines
+// are all long past)
+void testRunTimers() {
+    CountingTimer* victim = new CountingTimer(2, NULL);
+    CountingTimer deleter(0, victim);
+    CountingTimer repeater(1, NULL);
+
+    memset(timerRuns, 0, sizeof(timerRuns));
+    deleter.millies = 0;
+    victim->millies = 1;
+    repeater.millies = 2;
+    addTimer(&deleter);
+    addTimer(&repeater);
+    addTimer(victim);
+    runTimers();
+    if (timerRuns[0] != 1) {
+        failed("the timer that deletes another ran %d times", timerRuns[0]);
+    }
+    if (timerRuns[2]) {
+        failed("a deleted timer was run");
+    }
+    if (timerRuns[1] != 1) {
+        failed("a timer that stays due ran %d times in one call", timerRuns[1]);
+    }
+    runTimers();
+    if (timerRuns[1] != 2 || timerRuns[0] != 1) {
+        failed("the next call should only run the timer that stayed due");
+    }
+    removeTimer(&repeater);
+}
+
+// Compares the KTimerQueue to the list the scheduler used before, where every slice scanned all the timers to
+// find the next deadline.  This is not a pass/fail test, the times are just printed.
+void benchmarkTimerQueue() {
+    const U32 count = 2000;
+    const U32 iterations = 2000;
+    std::vector<TestTimer> timers(count);
+    U32 seed = 1;
+
+    for (U32 i = 0; i < count; i++) {
+        timers[i].millies = nextRandom(seed) % 100000;
+    }
+
+    KList<TestTimer*> list;
+    for (U32 i = 0; i < count; i++) {
+        list.addToBack(&timers[i].listNode);
+    }
+    U64 start = KSystem::getMicroCounter();
+    U32 checksum = 0;
+    for (U32 i = 0; i < iterations; i++) {
+        // find the next deadline, then reschedule that timer like a sleeping thread that wakes and sleeps again
+        TestTimer* next = NULL;
+        list.for_each([&next](KListNode<TestTimer*>* node) {
+            if (!next || node->data->millies < next->millies) {
+                next = node->data;
+            }
+            });
+        checksum += next->millies;
+        next->listNode.remove();
+        next->millies += nextRandom(seed) % 100000;
+        list.addToBack(&next->listNode);
+    }
+    U64 listTime = KSystem::getMicroCounter() - start;
+    for (U32 i = 0; i < count; i++) {
+        timers[i].listNode.remove();
+    }
+
+    seed = 1;
+    for (U32 i = 0; i < count; i++) {
+        timers[i].millies = nextRandom(seed) % 100000;
+    }
+    KTimerQueue queue;
+    for (U32 i = 0; i < count; i++) {
+        queue.add(&timers[i]);
+    }
+    start = KSystem::getMicroCounter();
+    U32 queueChecksum = 0;
+    for (U32 i = 0; i < iterations; i++) {
+        KTimer* next = queue.front();
+        queueChecksum += next->millies;
+        next->millies += nextRandom(seed) % 100000;
+        queue.add(next);
+    }
+    U64 queueTime = KSystem::getMicroCounter() - start;
+    for (U32 i = 0; i < count; i++) {
+        queue.remove(&timers[i]);
+    }
+    if (checksum != queueChecksum) {
+        failed("timer list and queue disagree");
+    }
+    printf("Timers: %d timers, %d reschedules: list %dus, queue %dus\n", count, iterations, (U32)listTime, (U32)queueTime);
+}
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef __TEST_TIMERS_H__
+#define __TEST_TIMERS_H__
+
+void testTimerQueue();
+void testRunTimers();
+void benchmarkTimerQueue();
+
+#endif
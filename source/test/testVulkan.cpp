@@ -0,0 +1,218 @@
+#include "boxedwine.h"
+
+#ifdef __TEST
+
+#include <stdio.h>
+
+#include "testCPU.h"
+#include "testVulkan.h"
+#include "../vulkan/vk_arena.h"
+
+void testVulkanArena() {
+    void* first;
+
+    {
+        VulkanArenaScope arenaScope;
+        first = vulkanAlloc<U8>(3);
+        U8* second = vulkanAlloc<U8>(1);
+        if (((size_t)first & 7) || second != (U8*)first + 8) {
+            failed("allocations should be 8 byte aligned: %p %p", first, second);
+        }
+    }
+    {
+        VulkanArenaScope arenaScope;
+        if (vulkanAlloc<U8>(1) != first) {
+            failed("the arena wasn't reset when the call ended");
+        }
+    }
+
+    // more than the block holds comes from the heap until the next reset grows the block
+    VkArena* arena = vulkanArena();
+    U32 blockSize = arena->getBlockSize();
+    {
+        VulkanArenaScope arenaScope;
+        U32* p = vulkanAlloc<U32>(blockSize / 4);
+        U32* extra = vulkanAlloc<U32>(blockSize / 4);
+        p[blockSize / 4 - 1] = 1;
+        extra[blockSize / 4 - 1] = 2;
+        if (p[blockSize / 4 - 1] != 1 || extra[blockSize / 4 - 1] != 2) {
+            failed("the extra allocation overlaps the block");
+        }
+    }
+    if (arena->getBlockSize() != blockSize * 2) {
+        failed("the block should have grown from %d to %d bytes, it is %d", blockSize, blockSize * 2, arena->getBlockSize());
+    }
+
+    // it only shrinks after many calls in a row that use a small part of it
+    for (U32 i = 0; i < VK_ARENA_SHRINK_RESETS - 1; i++) {
+        VulkanArenaScope arenaScope;
+        vulkanAlloc<U8>(blockSize / 2);
+    }
+    if (arena->getBlockSize() != blockSize * 2) {
+        failed("the block shrank too soon, it is %d bytes", arena->getBlockSize());
+    }
+    {
+        VulkanArenaScope arenaScope;
+        vulkanAlloc<U8>(blockSize / 2);
+    }
+    if (arena->getBlockSize() != blockSize) {
+        failed("the block should have shrunk back to %d bytes, it is %d", blockSize, arena->getBlockSize());
+    }
+
+    // and it never grows past the limit, larger calls keep using the heap
+    {
+        VulkanArenaScope arenaScope;
+        vulkanAlloc<U8>(VK_ARENA_MAX_BLOCK_SIZE * 2);
+    }
+    if (arena->getBlockSize() != VK_ARENA_MAX_BLOCK_SIZE) {
+        failed("the block should have stopped growing at %d bytes, it is %d", VK_ARENA_MAX_BLOCK_SIZE, arena->getBlockSize());
+    }
+
+    // the guest's memory is used in place when it can be, otherwise it is copied to the arena
+    U32 address = HEAP_ADDRESS + 0x100;
+    for (U32 i = 0; i < 4; i++) {
+        writed(address + i * 4, i + 1);
+    }
+    U32 crossing = HEAP_ADDRESS + K_PAGE_SIZE - 8;
+    for (U32 i = 0; i < 4; i++) {
+        writed(crossing + i * 4, i + 10);
+    }
+    {
+        VulkanArenaScope arenaScope;
+        U32* p = vulkanGetArray<U32>(address, 4);
+        if (p != (U32*)getPhysicalReadAddress(address, 16)) {
+            failed("an array in one page should not be copied");
+        }
+        for (U32 i = 0; i < 4; i++) {
+            if (p[i] != i + 1) {
+                failed("array[%d] is %d instead of %d", i, p[i], i + 1);
+            }
+        }
+        p = vulkanGetArray<U32>(crossing, 4);
+        for (U32 i = 0; i < 4; i++) {
+            if (p[i] != i + 10) {
+                failed("array across pages [%d] is %d instead of %d", i, p[i], i + 10);
+            }
+        }
+        if (vulkanGetArray<U32>(0, 4)) {
+            failed("a NULL array should stay NULL");
+        }
+    }
+}
+
+#ifdef BOXEDWINE_VULKAN
+#include "../vulkan/vk_host.h"
+
+// guest layouts, offsets in the heap
+#define VK_TEST_HANDLE 0
+#define VK_TEST_WRITES 0x100
+#define VK_TEST_IMAGES 0x1000
+#define VK_TEST_POOL 0x2000
+#define VK_TEST_POOL_SIZES 0x2100
+#define VK_TEST_POOL_RESULT 0x2200
+
+#define VK_TEST_WRITE_COUNT 8
+#define VK_TEST_IMAGES_PER_WRITE 4
+#define VK_TEST_POOL_SIZE_COUNT 11
+
+static U32 vkTestSum;
+
+// stand ins for the driver, they only look at what was marshaled
+static VKAPI_ATTR void VKAPI_CALL vkTestUpdateDescriptorSets(VkDevice device, uint32_t descriptorWriteCount, const VkWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const VkCopyDescriptorSet* pDescriptorCopies) {
+    for (U32 i = 0; i < descriptorWriteCount; i++) {
+        for (U32 j = 0; j < pDescriptorWrites[i].descriptorCount; j++) {
+            vkTestSum += pDescriptorWrites[i].pImageInfo[j].imageLayout;
+        }
+    }
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL vkTestCreateDescriptorPool(VkDevice device, const VkDescriptorPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDescriptorPool* pDescriptorPool) {
+    for (U32 i = 0; i < pCreateInfo->poolSizeCount; i++) {
+        vkTestSum += pCreateInfo->pPoolSizes[i].descriptorCount;
+    }
+    return VK_SUCCESS;
+}
+
+static void vkTestCall(void (*fn)(CPU* cpu), U32 arg1, U32 arg2, U32 arg3, U32 arg4, U32 arg5) {
+    U32 esp = ESP;
+    cpu->push32(arg5);
+    cpu->push32(arg4);
+    cpu->push32(arg3);
+    cpu->push32(arg2);
+    cpu->push32(arg1);
+    cpu->push32(0); // return address
+    fn(cpu);
+    ESP = esp;
+}
+
+static U64 vkTestTime(void (*fn)(CPU* cpu), U32 iterations, U32 arg2, U32 arg3, U32 arg4, U32 arg5, U32 expectedSum, const char* name) {
+    vkTestSum = 0;
+    U64 start = KSystem::getMicroCounter();
+    for (U32 i = 0; i < iterations; i++) {
+        vkTestCall(fn, HEAP_ADDRESS + VK_TEST_HANDLE, arg2, arg3, arg4, arg5);
+    }
+    U64 time = KSystem::getMicroCounter() - start;
+    if (vkTestSum != expectedSum * iterations) {
+        failed("%s marshaled the wrong values: %d instead of %d", name, vkTestSum, expectedSum * iterations);
+    }
+    if (!time) {
+        time = 1;
+    }
+    return time;
+}
+
+// Marshals calls through the generated vk_* functions with a driver that does nothing, so it runs without a GPU.
+// vkUpdateDescriptorSets converts each structure, vkCreateDescriptorPool passes the guest's pool sizes in place.
+// This is not a pass/fail test, the rates are just printed.
+void benchmarkVulkanMarshal() {
+    const U32 iterations = 200000;
+    BoxedVulkanInfo info;
+    U32 expectedWrites = 0;
+    U32 expectedPool = 0;
+
+    info.pvkUpdateDescriptorSets = vkTestUpdateDescriptorSets;
+    info.pvkCreateDescriptorPool = vkTestCreateDescriptorPool;
+    writeq(HEAP_ADDRESS + VK_TEST_HANDLE, 0);
+    writeq(HEAP_ADDRESS + VK_TEST_HANDLE + 8, (U64)(size_t)&info);
+
+    for (U32 i = 0; i < VK_TEST_WRITE_COUNT; i++) {
+        U32 write = HEAP_ADDRESS + VK_TEST_WRITES + i * 44;
+        U32 images = HEAP_ADDRESS + VK_TEST_IMAGES + i * VK_TEST_IMAGES_PER_WRITE * 20;
+        writed(write, VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET);
+        writed(write + 4, 0); // pNext
+        writeq(write + 8, i + 1); // dstSet
+        writed(write + 16, 0); // dstBinding
+        writed(write + 20, 0); // dstArrayElement
+        writed(write + 24, VK_TEST_IMAGES_PER_WRITE);
+        writed(write + 28, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+        writed(write + 32, images);
+        writed(write + 36, 0); // pBufferInfo
+        writed(write + 40, 0); // pTexelBufferView
+        for (U32 j = 0; j < VK_TEST_IMAGES_PER_WRITE; j++) {
+            writeq(images + j * 20, 0); // sampler
+            writeq(images + j * 20 + 8, 0); // imageView
+            writed(images + j * 20 + 16, i + j);
+            expectedWrites += i + j;
+        }
+    }
+
+    U32 pool = HEAP_ADDRESS + VK_TEST_POOL;
+    writed(pool, VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO);
+    writed(pool + 4, 0); // pNext
+    writed(pool + 8, 0); // flags
+    writed(pool + 12, 100); // maxSets
+    writed(pool + 16, VK_TEST_POOL_SIZE_COUNT);
+    writed(pool + 20, HEAP_ADDRESS + VK_TEST_POOL_SIZES);
+    for (U32 i = 0; i < VK_TEST_POOL_SIZE_COUNT; i++) {
+        writed(HEAP_ADDRESS + VK_TEST_POOL_SIZES + i * 8, i);
+        writed(HEAP_ADDRESS + VK_TEST_POOL_SIZES + i * 8 + 4, i * 10);
+        expectedPool += i * 10;
+    }
+
+    U64 writesTime = vkTestTime(vk_UpdateDescriptorSets, iterations, VK_TEST_WRITE_COUNT, HEAP_ADDRESS + VK_TEST_WRITES, 0, 0, expectedWrites, "vkUpdateDescriptorSets");
+    U64 poolTime = vkTestTime(vk_CreateDescriptorPool, iterations, pool, 0, HEAP_ADDRESS + VK_TEST_POOL_RESULT, 0, expectedPool, "vkCreateDescriptorPool");
+    printf("Vulkan marshal: %d calls, vkUpdateDescriptorSets(%d writes) %dus (%d calls/sec), vkCreateDescriptorPool %dus (%d calls/sec)\n", iterations, VK_TEST_WRITE_COUNT, (U32)writesTime, (U32)(iterations * 1000000ull / writesTime), (U32)poolTime, (U32)(iterations * 1000000ull / poolTime));
+}
+#endif
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef __TEST_VULKAN_H__
+#define __TEST_VULKAN_H__
+
+void testVulkanArena();
+void benchmarkVulkanMarshal();
+
+#endif
@@ -0,0 +1,252 @@
+#include "boxedwine.h"
+
+#ifdef __TEST
+
+#include <stdio.h>
+
+#include "testCPU.h"
+#include "testZip.h"
+
+#ifdef BOXEDWINE_ZLIB
+#include "../io/fszip.h"
+#include "../io/fszipnode.h"
+#include "../io/fsfilenode.h"
+
+static void writeZip16(std::vector<U8>& zip, U32 value) {
+    zip.push_back((U8)value);
+    zip.push_back((U8)(value >> 8));
+}
+
+static void writeZip32(std::vector<U8>& zip, U32 value) {
+    writeZip16(zip, value & 0xFFFF);
+    writeZip16(zip, value >> 16);
+}
+
+// the local header and the central directory header share everything from the version to the extra length
+static void writeZipHeader(std::vector<U8>& zip, U32 method, U32 crc, U32 compressedLen, U32 len, const std::string& name) {
+    writeZip16(zip, 20); // version needed
+    writeZip16(zip, 0); // flags
+    writeZip16(zip, method);
+    writeZip16(zip, 0); // time
+    writeZip16(zip, 0x21); // date, 1980-01-01
+    writeZip32(zip, crc);
+    writeZip32(zip, compressedLen);
+    writeZip32(zip, len);
+    writeZip16(zip, (U32)name.length());
+    writeZip16(zip, 0); // extra length
+}
+
+static bool deflateTestData(const std::vector<U8>& data, std::vector<U8>& result) {
+    z_stream stream;
+
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    result.resize(deflateBound(&stream, (uLong)data.size()));
+    stream.next_in = (Bytef*)data.data();
+    stream.avail_in = (uInt)data.size();
+    stream.next_out = result.data();
+    stream.avail_out = (uInt)result.size();
+    int ret = deflate(&stream, Z_FINISH);
+    result.resize(stream.total_out);
+    deflateEnd(&stream);
+    return ret == Z_STREAM_END;
+}
+
+static std::string getTestRoot() {
+    return (std::filesystem::temp_directory_path() / "boxedwineTest").string();
+}
+
+void initTestFileSystem() {
+    static bool initialized;
+
+    if (!initialized) {
+        std::error_code e;
+        std::filesystem::remove_all(getTestRoot(), e);
+        std::filesystem::create_directories(getTestRoot(), e);
+        Fs::initFileSystem(getTestRoot());
+        initialized = true;
+    }
+}
+
+BoxedPtr<FsNode> addTestZip(const std::string& name, const std::vector<TestZipEntry>& entries) {
+    std::vector<U8> zip;
+    std::vector<U8> directory;
+
+    initTestFileSystem();
+    for (const TestZipEntry& entry : entries) {
+        U32 crc = (U32)crc32(0, entry.data.data(), (uInt)entry.data.size());
+        U32 offset = (U32)zip.size();
+        std::vector<U8> compressed;
+
+        if (entry.compress && !deflateTestData(entry.data, compressed)) {
+            failed("could not deflate %s", entry.name.c_str());
+            return NULL;
+        }
+        const std::vector<U8>& stored = entry.compress ? compressed : entry.data;
+        U32 method = entry.compress ? Z_DEFLATED : 0;
+
+        writeZip32(zip, 0x04034b50);
+        writeZipHeader(zip, method, crc, (U32)stored.size(), (U32)entry.data.size(), entry.name);
+        zip.insert(zip.end(), entry.name.begin(), entry.name.end());
+        zip.insert(zip.end(), stored.begin(), stored.end());
+
+        writeZip32(directory, 0x02014b50);
+        writeZip16(directory, 20); // version made by
+        writeZipHeader(directory, method, crc, (U32)stored.size(), (U32)entry.data.size(), entry.name);
+        writeZip16(directory, 0); // comment length
+        writeZip16(directory, 0); // disk
+        writeZip16(directory, 0); // internal attributes
+        writeZip32(directory, 0); // external attributes
+        writeZip32(directory, offset);
+        directory.insert(directory.end(), entry.name.begin(), entry.name.end());
+    }
+    U32 directoryOffset = (U32)zip.size();
+    zip.insert(zip.end(), directory.begin(), directory.end());
+    writeZip32(zip, 0x06054b50);
+    writeZip16(zip, 0); // disk
+    writeZip16(zip, 0); // disk with the directory
+    writeZip16(zip, (U32)entries.size());
+    writeZip16(zip, (U32)entries.size());
+    writeZip32(zip, (U32)directory.size());
+    writeZip32(zip, directoryOffset);
+    writeZip16(zip, 0); // comment length
+
+    std::string zipPath = getTestRoot() + Fs::nativePathSeperator + name + ".zip";
+    FILE* f = fopen(zipPath.c_str(), "wb");
+    bool written = f && fwrite(zip.data(), 1, zip.size(), f) == zip.size();
+    if (f) {
+        fclose(f);
+    }
+    if (!written) {
+        failed("could not write %s", zipPath.c_str());
+        return NULL;
+    }
+    std::shared_ptr<FsZip> fsZip = std::make_shared<FsZip>();
+    if (!fsZip->init(zipPath, "/" + name + "/")) {
+        failed("could not open %s", zipPath.c_str());
+        return NULL;
+    }
+    return Fs::getNodeFromLocalPath("", "/" + name, true);
+}
+
+// words from a small list so the data is compressible and most of it refers back into the window
+void fillTestZipData(std::vector<U8>& data, U32 len, U32 seed) {
+    static const char* words[] = {"boxed", "wine ", "zip ", "inflate ", "window\n", "checkpoint ", "block ", "cache "};
+
+    data.clear();
+    while (data.size() < len) {
+        seed = seed * 1103515245 + 12345;
+        const char* word = words[(seed >> 16) % 8];
+        data.insert(data.end(), word, word + strlen(word));
+        data.push_back((U8)(seed >> 24)); // keeps the deflate blocks from being too large
+    }
+    data.resize(len);
+}
+
+static bool readTestZipNode(FsOpenNode* openNode, U64 pos, U32 len, const std::vector<U8>& expected, const char* what) {
+    std::vector<U8> buffer(len);
+
+    openNode->seek(pos);
+    if (openNode->readNative(buffer.data(), len) != len) {
+        failed("%s: short read at %X", what, (U32)pos);
+        return false;
+    }
+    if (memcmp(buffer.data(), expected.data() + pos, len)) {
+        failed("%s: wrong data at %X", what, (U32)pos);
+        return false;
+    }
+    return true;
+}
+
+void testZipReads() {
+    const U32 blocks = K_ZIP_CACHE_BLOCKS + 3 * K_ZIP_CHECKPOINT_SPAN / K_ZIP_BLOCK_SIZE;
+    std::vector<TestZipEntry> entries(2);
+
+    entries[0].name = "big.txt";
+    fillTestZipData(entries[0].data, blocks * K_ZIP_BLOCK_SIZE + 1000, 1);
+    entries[1].name = "stored.txt";
+    entries[1].compress = false;
+    fillTestZipData(entries[1].data, 100000, 2);
+
+    if (!addTestZip("zipReads", entries)) {
+        return;
+    }
+    BoxedPtr<FsFileNode> node = (FsFileNode*)Fs::getNodeFromLocalPath("", "/zipReads/big.txt", true).get();
+    BoxedPtr<FsFileNode> storedNode = (FsFileNode*)Fs::getNodeFromLocalPath("", "/zipReads/stored.txt", true).get();
+    if (!node || !node->getZipNode() || !storedNode || !storedNode->getZipNode()) {
+        failed("the zip entries were not added");
+        return;
+    }
+    const std::vector<U8>& data = entries[0].data;
+    std::shared_ptr<FsZipNode> zipNode = node->getZipNode();
+
+    // stored entries are read in place
+    FsOpenNode* openNode = storedNode->getZipNode()->open(storedNode, K_O_RDONLY);
+    readTestZipNode(openNode, 50000, 20000, entries[1].data, "stored");
+    readTestZipNode(openNode, 10, 100, entries[1].data, "stored backwards");
+    delete openNode;
+
+    // more than the cache holds, so the first blocks are evicted
+    openNode = zipNode->open(node, K_O_RDONLY);
+    for (U32 i = 0; i < blocks; i++) {
+        readTestZipNode(openNode, (U64)i * K_ZIP_BLOCK_SIZE, K_ZIP_BLOCK_SIZE, data, "sequential");
+    }
+    readTestZipNode(openNode, (U64)blocks * K_ZIP_BLOCK_SIZE, 1000, data, "last block");
+    U32 evicted = blocks + 1 - K_ZIP_CACHE_BLOCKS;
+    for (U32 i = 0; i <= blocks; i++) {
+        if (FsZipBlockCache::contains(FsZipBlockCache::getKey(zipNode->id, i)) != (i >= evicted)) {
+            failed("block %d should %s cached", i, i >= evicted ? "be" : "not be");
+        }
+    }
+
+    // a cached block is moved to the front, so decoding another block evicts the next oldest one instead
+    readTestZipNode(openNode, (U64)evicted * K_ZIP_BLOCK_SIZE, 100, data, "oldest cached block");
+    readTestZipNode(openNode, 0, 100, data, "first block");
+    if (!FsZipBlockCache::contains(FsZipBlockCache::getKey(zipNode->id, evicted))) {
+        failed("the block that was just used was evicted");
+    }
+    if (FsZipBlockCache::contains(FsZipBlockCache::getKey(zipNode->id, evicted + 1))) {
+        failed("the least recently used block was not evicted");
+    }
+
+    // a checkpoint was recorded in each span, and a deflate block rarely ends on a byte so some kept bits
+    U32 checkpointsWithBits = 0;
+    for (U32 span = 0; span < 3; span++) {
+        std::shared_ptr<FsZipCheckpoint> checkpoint = zipNode->findCheckpoint((U64)(span + 1) * K_ZIP_CHECKPOINT_SPAN - 1);
+        if (checkpoint->pos < (U64)span * K_ZIP_CHECKPOINT_SPAN) {
+            failed("no checkpoint between %X and %X", span * K_ZIP_CHECKPOINT_SPAN, (span + 1) * K_ZIP_CHECKPOINT_SPAN);
+        } else if (span && checkpoint->window.size() != 32 * 1024) {
+            failed("the checkpoint at %X has a %d byte window", (U32)checkpoint->pos, (U32)checkpoint->window.size());
+        }
+        if (checkpoint->bits) {
+            checkpointsWithBits++;
+        }
+    }
+    for (U32 span = 3; span * K_ZIP_CHECKPOINT_SPAN < data.size(); span++) {
+        if (zipNode->findCheckpoint((U64)span * K_ZIP_CHECKPOINT_SPAN + K_ZIP_CHECKPOINT_SPAN - 1)->bits) {
+            checkpointsWithBits++;
+        }
+    }
+    if (!checkpointsWithBits) {
+        failed("no checkpoint started in the middle of a byte");
+    }
+
+    // backward seek to an evicted block that is after a checkpoint, it is decoded from there with the saved window
+    // and bits, which only gives the right data if both were restored
+    U64 pos = 2 * K_ZIP_CHECKPOINT_SPAN + K_ZIP_CHECKPOINT_SPAN / 2;
+    std::shared_ptr<FsZipCheckpoint> checkpoint = zipNode->findCheckpoint(pos);
+    if (checkpoint->pos < 2 * K_ZIP_CHECKPOINT_SPAN) {
+        failed("seek to %X should start from a checkpoint after %X", (U32)pos, 2 * K_ZIP_CHECKPOINT_SPAN);
+    }
+    readTestZipNode(openNode, pos, 100, data, "backward seek");
+    delete openNode;
+}
+
+#else
+void testZipReads() {
+}
+#endif
+
+#endif
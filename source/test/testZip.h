@@ -0,0 +1,19 @@
+#ifndef __TEST_ZIP_H__
+#define __TEST_ZIP_H__
+
+class TestZipEntry {
+public:
+    std::string name;
+    std::vector<U8> data;
+    bool compress = true;
+};
+
+// the file system is in a new directory under the temp directory, it is created the first time it is needed
+void initTestFileSystem();
+// writes a zip file with the entries and mounts it at /name, returns the mounted directory
+BoxedPtr<FsNode> addTestZip(const std::string& name, const std::vector<TestZipEntry>& entries);
+void fillTestZipData(std::vector<U8>& data, U32 len, U32 seed);
+
+void testZipReads();
+
+#endif
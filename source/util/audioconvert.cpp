@@ -0,0 +1,372 @@
+#include "boxedwine.h"
+#include "audioconvert.h"
+#include "../../lib/simde/simde/x86/sse2.h"
+
+// The kernels work on 4 floats at a time with whatever is left over done one sample at a time.  Narrowing to an
+// integer biases the sample so that it is never negative, that way truncating rounds to nearest without needing
+// a rounding mode, and the packs saturate what is out of range.
+
+static void decodeU8(const U8* src, float* dst, U32 count) {
+    simde__m128i zero = simde_mm_setzero_si128();
+    simde__m128i bias = simde_mm_set1_epi16(128);
+    simde__m128 scale = simde_mm_set1_ps(1.0f / 128.0f);
+    U32 i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        simde__m128i v = simde_mm_loadu_si128((const simde__m128i*)(src + i));
+        simde__m128i lo = simde_mm_sub_epi16(simde_mm_unpacklo_epi8(v, zero), bias);
+        simde__m128i hi = simde_mm_sub_epi16(simde_mm_unpackhi_epi8(v, zero), bias);
+        simde_mm_storeu_ps(dst + i, simde_mm_mul_ps(simde_mm_cvtepi32_ps(simde_mm_srai_epi32(simde_mm_unpacklo_epi16(lo, lo), 16)), scale));
+        simde_mm_storeu_ps(dst + i + 4, simde_mm_mul_ps(simde_mm_cvtepi32_ps(simde_mm_srai_epi32(simde_mm_unpackhi_epi16(lo, lo), 16)), scale));
+        simde_mm_storeu_ps(dst + i + 8, simde_mm_mul_ps(simde_mm_cvtepi32_ps(simde_mm_srai_epi32(simde_mm_unpacklo_epi16(hi, hi), 16)), scale));
+        simde_mm_storeu_ps(dst + i + 12, simde_mm_mul_ps(simde_mm_cvtepi32_ps(simde_mm_srai_epi32(simde_mm_unpackhi_epi16(hi, hi), 16)), scale));
+    }
+    for (; i < count; i++) {
+        dst[i] = ((S32)src[i] - 128) * (1.0f / 128.0f);
+    }
+}
+
+static void decodeS8(const U8* src, float* dst, U32 count) {
+    simde__m128 scale = simde_mm_set1_ps(1.0f / 128.0f);
+    U32 i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        simde__m128i v = simde_mm_loadu_si128((const simde__m128i*)(src + i));
+        simde__m128i lo = simde_mm_srai_epi16(simde_mm_unpacklo_epi8(v, v), 8);
+        simde__m128i hi = simde_mm_srai_epi16(simde_mm_unpackhi_epi8(v, v), 8);
+        simde_mm_storeu_ps(dst + i, simde_mm_mul_ps(simde_mm_cvtepi32_ps(simde_mm_srai_epi32(simde_mm_unpacklo_epi16(lo, lo), 16)), scale));
+        simde_mm_storeu_ps(dst + i + 4, simde_mm_mul_ps(simde_mm_cvtepi32_ps(simde_mm_srai_epi32(simde_mm_unpackhi_epi16(lo, lo), 16)), scale));
+        simde_mm_storeu_ps(dst + i + 8, simde_mm_mul_ps(simde_mm_cvtepi32_ps(simde_mm_srai_epi32(simde_mm_unpacklo_epi16(hi, hi), 16)), scale));
+        simde_mm_storeu_ps(dst + i + 12, simde_mm_mul_ps(simde_mm_cvtepi32_ps(simde_mm_srai_epi32(simde_mm_unpackhi_epi16(hi, hi), 16)), scale));
+    }
+    for (; i < count; i++) {
+        dst[i] = (S8)src[i] * (1.0f / 128.0f);
+    }
+}
+
+static void decodeS16(const U8* src, float* dst, U32 count) {
+    const S16* s = (const S16*)src;
+    simde__m128 scale = simde_mm_set1_ps(1.0f / 32768.0f);
+    U32 i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        simde__m128i v = simde_mm_loadu_si128((const simde__m128i*)(s + i));
+        simde_mm_storeu_ps(dst + i, simde_mm_mul_ps(simde_mm_cvtepi32_ps(simde_mm_srai_epi32(simde_mm_unpacklo_epi16(v, v), 16)), scale));
+        simde_mm_storeu_ps(dst + i + 4, simde_mm_mul_ps(simde_mm_cvtepi32_ps(simde_mm_srai_epi32(simde_mm_unpackhi_epi16(v, v), 16)), scale));
+    }
+    for (; i < count; i++) {
+        dst[i] = s[i] * (1.0f / 32768.0f);
+    }
+}
+
+static void decodeS32(const U8* src, float* dst, U32 count) {
+    const S32* s = (const S32*)src;
+    simde__m128 scale = simde_mm_set1_ps(1.0f / 2147483648.0f);
+    U32 i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        simde__m128i v = simde_mm_loadu_si128((const simde__m128i*)(s + i));
+        simde_mm_storeu_ps(dst + i, simde_mm_mul_ps(simde_mm_cvtepi32_ps(v), scale));
+    }
+    for (; i < count; i++) {
+        dst[i] = (float)s[i] * (1.0f / 2147483648.0f);
+    }
+}
+
+static void decode(AudioSampleFormat format, const U8* src, float* dst, U32 count) {
+    switch (format) {
+    case AUDIO_SAMPLE_U8: decodeU8(src, dst, count); break;
+    case AUDIO_SAMPLE_S8: decodeS8(src, dst, count); break;
+    case AUDIO_SAMPLE_S16: decodeS16(src, dst, count); break;
+    case AUDIO_SAMPLE_S32: decodeS32(src, dst, count); break;
+    case AUDIO_SAMPLE_F32: memcpy(dst, src, count * sizeof(float)); break;
+    default: kpanic("AudioConverter: unknown format %d", format);
+    }
+}
+
+static inline simde__m128 clampSample(simde__m128 v) {
+    return simde_mm_min_ps(simde_mm_max_ps(v, simde_mm_set1_ps(-1.0f)), simde_mm_set1_ps(1.0f));
+}
+
+static inline float clampSample(float f) {
+    if (f < -1.0f) {
+        return -1.0f;
+    }
+    if (f > 1.0f) {
+        return 1.0f;
+    }
+    return f;
+}
+
+// returns 0 to 256 for -1.0 to 1.0
+static inline simde__m128i biasedU8(const float* src, simde__m128 scale) {
+    return simde_mm_cvttps_epi32(simde_mm_add_ps(simde_mm_mul_ps(clampSample(simde_mm_loadu_ps(src)), scale), simde_mm_set1_ps(128.5f)));
+}
+
+static void encodeU8(const float* src, U8* dst, U32 count) {
+    simde__m128 scale = simde_mm_set1_ps(128.0f);
+    U32 i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        simde__m128i lo = simde_mm_packs_epi32(biasedU8(src + i, scale), biasedU8(src + i + 4, scale));
+        simde__m128i hi = simde_mm_packs_epi32(biasedU8(src + i + 8, scale), biasedU8(src + i + 12, scale));
+        simde_mm_storeu_si128((simde__m128i*)(dst + i), simde_mm_packus_epi16(lo, hi));
+    }
+    for (; i < count; i++) {
+        S32 v = (S32)(clampSample(src[i]) * 128.0f + 128.5f);
+        dst[i] = (U8)(v > 255 ? 255 : v);
+    }
+}
+
+static void encodeS8(const float* src, U8* dst, U32 count) {
+    simde__m128 scale = simde_mm_set1_ps(128.0f);
+    simde__m128i bias = simde_mm_set1_epi32(128);
+    U32 i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        simde__m128i lo = simde_mm_packs_epi32(simde_mm_sub_epi32(biasedU8(src + i, scale), bias), simde_mm_sub_epi32(biasedU8(src + i + 4, scale), bias));
+        simde__m128i hi = simde_mm_packs_epi32(simde_mm_sub_epi32(biasedU8(src + i + 8, scale), bias), simde_mm_sub_epi32(biasedU8(src + i + 12, scale), bias));
+        simde_mm_storeu_si128((simde__m128i*)(dst + i), simde_mm_packs_epi16(lo, hi));
+    }
+    for (; i < count; i++) {
+        S32 v = (S32)(clampSample(src[i]) * 128.0f + 128.5f) - 128;
+        dst[i] = (U8)(S8)(v > 127 ? 127 : v);
+    }
+}
+
+static void encodeS16(const float* src, U8* dst, U32 count) {
+    S16* d = (S16*)dst;
+    simde__m128 scale = simde_mm_set1_ps(32768.0f);
+    simde__m128 fbias = simde_mm_set1_ps(32768.5f);
+    simde__m128i bias = simde_mm_set1_epi32(32768);
+    U32 i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        simde__m128i lo = simde_mm_cvttps_epi32(simde_mm_add_ps(simde_mm_mul_ps(clampSample(simde_mm_loadu_ps(src + i)), scale), fbias));
+        simde__m128i hi = simde_mm_cvttps_epi32(simde_mm_add_ps(simde_mm_mul_ps(clampSample(simde_mm_loadu_ps(src + i + 4)), scale), fbias));
+        simde_mm_storeu_si128((simde__m128i*)(d + i), simde_mm_packs_epi32(simde_mm_sub_epi32(lo, bias), simde_mm_sub_epi32(hi, bias)));
+    }
+    for (; i < count; i++) {
+        S32 v = (S32)(clampSample(src[i]) * 32768.0f + 32768.5f) - 32768;
+        d[i] = (S16)(v > 32767 ? 32767 : v);
+    }
+}
+
+static void encodeS32(const float* src, U8* dst, U32 count) {
+    S32* d = (S32*)dst;
+    // 1.0 doesn't fit, this is the largest float below it
+    const float maxSample = 0.99999994f;
+    simde__m128 scale = simde_mm_set1_ps(2147483648.0f);
+    simde__m128 minValue = simde_mm_set1_ps(-1.0f);
+    simde__m128 maxValue = simde_mm_set1_ps(maxSample);
+    U32 i = 0;
+
+    // 32-bit samples have more precision than a float, so rounding doesn't matter here
+    for (; i + 4 <= count; i += 4) {
+        simde__m128 v = simde_mm_min_ps(simde_mm_max_ps(simde_mm_loadu_ps(src + i), minValue), maxValue);
+        simde_mm_storeu_si128((simde__m128i*)(d + i), simde_mm_cvttps_epi32(simde_mm_mul_ps(v, scale)));
+    }
+    for (; i < count; i++) {
+        float f = clampSample(src[i]);
+        d[i] = (S32)((f > maxSample ? maxSample : f) * 2147483648.0f);
+    }
+}
+
+static void encode(AudioSampleFormat format, const float* src, U8* dst, U32 count) {
+    switch (format) {
+    case AUDIO_SAMPLE_U8: encodeU8(src, dst, count); break;
+    case AUDIO_SAMPLE_S8: encodeS8(src, dst, count); break;
+    case AUDIO_SAMPLE_S16: encodeS16(src, dst, count); break;
+    case AUDIO_SAMPLE_S32: encodeS32(src, dst, count); break;
+    case AUDIO_SAMPLE_F32: memcpy(dst, src, count * sizeof(float)); break;
+    default: kpanic("AudioConverter: unknown format %d", format);
+    }
+}
+
+static void monoToStereo(const float* src, float* dst, U32 frames) {
+    U32 i = 0;
+
+    for (; i + 4 <= frames; i += 4) {
+        simde__m128 v = simde_mm_loadu_ps(src + i);
+        simde_mm_storeu_ps(dst + i * 2, simde_mm_unpacklo_ps(v, v));
+        simde_mm_storeu_ps(dst + i * 2 + 4, simde_mm_unpackhi_ps(v, v));
+    }
+    for (; i < frames; i++) {
+        dst[i * 2] = src[i];
+        dst[i * 2 + 1] = src[i];
+    }
+}
+
+static void stereoToMono(const float* src, float* dst, U32 frames) {
+    simde__m128 half = simde_mm_set1_ps(0.5f);
+    U32 i = 0;
+
+    for (; i + 4 <= frames; i += 4) {
+        simde__m128 a = simde_mm_loadu_ps(src + i * 2);
+        simde__m128 b = simde_mm_loadu_ps(src + i * 2 + 4);
+        simde__m128 left = simde_mm_shuffle_ps(a, b, SIMDE_MM_SHUFFLE(2, 0, 2, 0));
+        simde__m128 right = simde_mm_shuffle_ps(a, b, SIMDE_MM_SHUFFLE(3, 1, 3, 1));
+        simde_mm_storeu_ps(dst + i, simde_mm_mul_ps(simde_mm_add_ps(left, right), half));
+    }
+    for (; i < frames; i++) {
+        dst[i] = (src[i * 2] + src[i * 2 + 1]) * 0.5f;
+    }
+}
+
+AudioConverter::AudioConverter() : srcFormat(AUDIO_SAMPLE_NONE), dstFormat(AUDIO_SAMPLE_NONE), srcChannels(0), dstChannels(0), srcFreq(0), dstFreq(0), srcFrameSize(0), dstFrameSize(0), maxFrames(0), step(0), pos(0) {
+}
+
+U32 AudioConverter::getSampleSize(AudioSampleFormat format) {
+    switch (format) {
+    case AUDIO_SAMPLE_U8:
+    case AUDIO_SAMPLE_S8:
+        return 1;
+    case AUDIO_SAMPLE_S16:
+        return 2;
+    case AUDIO_SAMPLE_S32:
+    case AUDIO_SAMPLE_F32:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+bool AudioConverter::init(AudioSampleFormat srcFormat, U32 srcChannels, U32 srcFreq, AudioSampleFormat dstFormat, U32 dstChannels, U32 dstFreq, U32 maxFrames) {
+    if (!getSampleSize(srcFormat) || !getSampleSize(dstFormat) || !srcFreq || !dstFreq || !srcChannels || !dstChannels || !maxFrames) {
+        return false;
+    }
+    if (srcChannels != dstChannels && !(srcChannels == 1 && dstChannels == 2) && !(srcChannels == 2 && dstChannels == 1)) {
+        return false;
+    }
+    this->srcFormat = srcFormat;
+    this->dstFormat = dstFormat;
+    this->srcChannels = srcChannels;
+    this->dstChannels = dstChannels;
+    this->srcFreq = srcFreq;
+    this->dstFreq = dstFreq;
+    this->srcFrameSize = getSampleSize(srcFormat) * srcChannels;
+    this->dstFrameSize = getSampleSize(dstFormat) * dstChannels;
+    this->maxFrames = maxFrames;
+    this->step = ((U64)srcFreq << 32) / dstFreq;
+
+    this->decodeBuffer.resize(maxFrames * srcChannels);
+    this->frameBuffer.resize((maxFrames + 1) * dstChannels);
+    if (srcFreq != dstFreq) {
+        this->resampleBuffer.resize(this->getMaxOutputFrames(maxFrames) * dstChannels);
+    } else {
+        this->resampleBuffer.clear();
+    }
+    this->reset();
+    return true;
+}
+
+void AudioConverter::reset() {
+    // the first output frame lands on the first source frame, the zeroed frame before it is never used
+    this->pos = 1ull << 32;
+    for (U32 i = 0; i < this->dstChannels; i++) {
+        this->frameBuffer[i] = 0.0f;
+    }
+}
+
+U32 AudioConverter::getMaxOutputFrames(U32 srcFrames) {
+    if (this->srcFreq == this->dstFreq) {
+        return srcFrames;
+    }
+    // step is rounded down, so a resampled chunk can come out a frame longer than the ratio says
+    return (U32)((U64)srcFrames * this->dstFreq / this->srcFreq) + 2;
+}
+
+U32 AudioConverter::getMaxInputFrames(U32 dstBytes) {
+    U32 dstFrames = dstBytes / this->dstFrameSize;
+    if (this->srcFreq == this->dstFreq) {
+        return dstFrames;
+    }
+    if (dstFrames <= 2) {
+        return 0;
+    }
+    return (U32)((U64)(dstFrames - 2) * this->srcFreq / this->dstFreq);
+}
+
+U32 AudioConverter::convert(const U8* src, U32 srcFrames, U8* dst) {
+    U32 result = 0;
+
+    while (srcFrames) {
+        U32 todo = srcFrames > this->maxFrames ? this->maxFrames : srcFrames;
+        result += this->convertFrames(src, todo, dst + result);
+        src += todo * this->srcFrameSize;
+        srcFrames -= todo;
+    }
+    return result;
+}
+
+U32 AudioConverter::convertFrames(const U8* src, U32 srcFrames, U8* dst) {
+    float* frames = this->frameBuffer.data() + this->dstChannels;
+
+    if (this->srcChannels == this->dstChannels) {
+        decode(this->srcFormat, src, frames, srcFrames * this->srcChannels);
+    } else {
+        const float* samples;
+
+        if (this->srcFormat == AUDIO_SAMPLE_F32) {
+            samples = (const float*)src;
+        } else {
+            decode(this->srcFormat, src, this->decodeBuffer.data(), srcFrames * this->srcChannels);
+            samples = this->decodeBuffer.data();
+        }
+        if (this->srcChannels == 1) {
+            monoToStereo(samples, frames, srcFrames);
+        } else {
+            stereoToMono(samples, frames, srcFrames);
+        }
+    }
+    if (this->srcFreq == this->dstFreq) {
+        encode(this->dstFormat, frames, dst, srcFrames * this->dstChannels);
+        return srcFrames * this->dstFrameSize;
+    }
+    U32 dstFrames = this->resample(srcFrames);
+    encode(this->dstFormat, this->resampleBuffer.data(), dst, dstFrames * this->dstChannels);
+    return dstFrames * this->dstFrameSize;
+}
+
+// frameBuffer holds the last frame of the previous call followed by srcFrames new ones, an output frame at pos is
+// interpolated between the frame pos points at and the one after it
+U32 AudioConverter::resample(U32 srcFrames) {
+    const float* src = this->frameBuffer.data();
+    float* dst = this->resampleBuffer.data();
+    const float fraction = 1.0f / 4294967296.0f;
+    U64 end = (U64)srcFrames << 32;
+    U64 pos = this->pos;
+    U64 step = this->step;
+    U32 count = 0;
+
+    if (this->dstChannels == 2) {
+        // frames i and i+1 are 4 floats in a row, 2 output frames are made at once
+        while (pos + step < end) {
+            U64 pos2 = pos + step;
+            simde__m128 v1 = simde_mm_loadu_ps(src + (pos >> 32) * 2);
+            simde__m128 v2 = simde_mm_loadu_ps(src + (pos2 >> 32) * 2);
+            simde__m128 a = simde_mm_movelh_ps(v1, v2);
+            simde__m128 b = simde_mm_movehl_ps(v2, v1);
+            float t1 = (U32)pos * fraction;
+            float t2 = (U32)pos2 * fraction;
+            simde__m128 t = simde_mm_set_ps(t2, t2, t1, t1);
+            simde_mm_storeu_ps(dst + count * 2, simde_mm_add_ps(a, simde_mm_mul_ps(simde_mm_sub_ps(b, a), t)));
+            count += 2;
+            pos = pos2 + step;
+        }
+    }
+    while (pos < end) {
+        const float* a = src + (pos >> 32) * this->dstChannels;
+        const float* b = a + this->dstChannels;
+        float t = (U32)pos * fraction;
+        for (U32 c = 0; c < this->dstChannels; c++) {
+            dst[count * this->dstChannels + c] = a[c] + (b[c] - a[c]) * t;
+        }
+        count++;
+        pos += step;
+    }
+    this->pos = pos - end;
+    // the last frame is needed to interpolate up to the first frame of the next call
+    memcpy(this->frameBuffer.data(), src + srcFrames * this->dstChannels, this->dstChannels * sizeof(float));
+    return count;
+}
@@ -0,0 +1,69 @@
+#ifndef __AUDIO_CONVERT_H__
+#define __AUDIO_CONVERT_H__
+
+#include "platform.h"
+
+// sample formats in the host's byte order
+enum AudioSampleFormat {
+    AUDIO_SAMPLE_NONE,
+    AUDIO_SAMPLE_U8,
+    AUDIO_SAMPLE_S8,
+    AUDIO_SAMPLE_S16,
+    AUDIO_SAMPLE_S32,
+    AUDIO_SAMPLE_F32
+};
+
+// Converts interleaved pcm from one sample format, channel count and rate to another.  Samples are widened to
+// float, remixed, resampled with linear interpolation and then narrowed to the output format.  Everything is
+// allocated in init, convert doesn't allocate.
+//
+// The resampler keeps its position and the last frame it was given between calls, so the audio can be fed in
+// whatever chunks it arrives in without a click at each chunk boundary.
+class AudioConverter {
+public:
+    AudioConverter();
+
+    // Returns false if the conversion isn't supported, only mono <-> stereo is handled when the channel counts
+    // differ.  maxFrames is the most source frames that are converted in one pass, bigger calls are split up.
+    bool init(AudioSampleFormat srcFormat, U32 srcChannels, U32 srcFreq, AudioSampleFormat dstFormat, U32 dstChannels, U32 dstFreq, U32 maxFrames);
+    // forgets the resampler state
+    void reset();
+
+    // src holds srcFrames whole frames, dst must have room for getMaxOutputBytes(srcFrames), returns the bytes
+    // written to dst
+    U32 convert(const U8* src, U32 srcFrames, U8* dst);
+
+    U32 getMaxOutputFrames(U32 srcFrames);
+    U32 getMaxOutputBytes(U32 srcFrames) {return this->getMaxOutputFrames(srcFrames) * this->dstFrameSize;}
+    // the most source frames that are sure to fit in dstBytes once they are converted
+    U32 getMaxInputFrames(U32 dstBytes);
+
+    U32 getSrcFrameSize() {return this->srcFrameSize;}
+    U32 getDstFrameSize() {return this->dstFrameSize;}
+
+    static U32 getSampleSize(AudioSampleFormat format);
+
+private:
+    U32 convertFrames(const U8* src, U32 srcFrames, U8* dst);
+    U32 resample(U32 srcFrames);
+
+    AudioSampleFormat srcFormat;
+    AudioSampleFormat dstFormat;
+    U32 srcChannels;
+    U32 dstChannels;
+    U32 srcFreq;
+    U32 dstFreq;
+    U32 srcFrameSize;
+    U32 dstFrameSize;
+    U32 maxFrames;
+
+    U64 step; // source frames per output frame, 32.32 fixed point
+    U64 pos; // where the next output frame is in frameBuffer, 32.32 fixed point
+
+    std::vector<float> decodeBuffer; // source samples when the channels have to be remixed
+    // the last frame of the previous call followed by the remixed source frames
+    std::vector<float> frameBuffer;
+    std::vector<float> resampleBuffer;
+};
+
+#endif
@@ -0,0 +1,226 @@
+#include "boxedwine.h"
+
+#ifdef BOXEDWINE_LOCK_PROFILER
+
+#include <chrono>
+#include UNISTD
+#ifdef BOXEDWINE_POSIX
+#include <signal.h>
+#endif
+
+#define LOCK_PROFILE_MAX_REPORT_SITES 8192
+
+// sites are never removed, so the report can walk the list while other threads are still adding to it
+static std::atomic<LockProfileSite*> lockProfileSites;
+
+LockProfileSite::LockProfileSite(const char* file, U32 line) : file(file), line(line), acquisitions(0), contended(0), waitTime(0), holdTime(0) {
+    this->next = lockProfileSites.load();
+    while (!lockProfileSites.compare_exchange_weak(this->next, this)) {
+    }
+}
+
+LockProfileSite* LockProfileSite::noSite() {
+    static LockProfileSite site("(no call site)", 0);
+    return &site;
+}
+
+U64 lockProfileNow() {
+    return (U64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// waitStart is 0 if the lock was free
+void LockProfileState::acquired(LockProfileSite* site, U64 waitStart) {
+    if (!site) {
+        site = LockProfileSite::noSite();
+    }
+    U64 now = lockProfileNow();
+    site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (waitStart) {
+        site->contended.fetch_add(1, std::memory_order_relaxed);
+        site->waitTime.fetch_add(now - waitStart, std::memory_order_relaxed);
+    }
+    if (this->depth++ == 0) {
+        this->holder = site;
+        this->holdStart = now;
+    }
+}
+
+void LockProfileState::released() {
+    if (this->depth && --this->depth == 0) {
+        this->holder->holdTime.fetch_add(lockProfileNow() - this->holdStart, std::memory_order_relaxed);
+        this->holder = NULL;
+    }
+}
+
+void LockProfileState::suspend(LockProfileState& saved) {
+    if (this->depth) {
+        this->holder->holdTime.fetch_add(lockProfileNow() - this->holdStart, std::memory_order_relaxed);
+    }
+    saved = *this;
+    this->holder = NULL;
+    this->holdStart = 0;
+    this->depth = 0;
+}
+
+void LockProfileState::resume(const LockProfileState& saved) {
+    *this = saved;
+    if (this->depth) {
+        this->holdStart = lockProfileNow();
+    }
+}
+
+// snprintf isn't async signal safe, so the report is formatted by hand
+class LockProfileLine {
+public:
+    LockProfileLine() : len(0) {}
+
+    void add(const char* s) {
+        while (*s && this->len < sizeof(this->buffer)) {
+            this->buffer[this->len++] = *s++;
+        }
+    }
+
+    // right aligned in width characters
+    void add(const char* s, U32 width) {
+        U32 sLen = (U32)strlen(s);
+        for (U32 i = sLen; i < width; i++) {
+            this->add(" ");
+        }
+        this->add(s);
+    }
+
+    void add(U64 value, U32 width) {
+        char digits[21];
+        U32 pos = sizeof(digits) - 1;
+        digits[pos] = 0;
+        do {
+            digits[--pos] = (char)('0' + value % 10);
+            value /= 10;
+        } while (value);
+        this->add(digits + pos, width);
+    }
+
+    // value / divisor rounded to decimals places
+    void addFraction(U64 value, U64 divisor, U32 decimals, U32 width) {
+        U64 scale = 1;
+        for (U32 i = 0; i < decimals; i++) {
+            scale *= 10;
+        }
+        U64 scaled = divisor ? (value * scale + divisor / 2) / divisor : 0;
+        char digits[32];
+        U32 pos = sizeof(digits) - 1;
+        digits[pos] = 0;
+        for (U32 i = 0; i < decimals; i++) {
+            digits[--pos] = (char)('0' + scaled % 10);
+            scaled /= 10;
+        }
+        digits[--pos] = '.';
+        do {
+            digits[--pos] = (char)('0' + scaled % 10);
+            scaled /= 10;
+        } while (scaled);
+        this->add(digits + pos, width);
+    }
+
+    bool write(int fd) {
+        return (int)::write(fd, this->buffer, this->len) == (int)this->len;
+    }
+
+private:
+    char buffer[512];
+    U32 len;
+};
+
+// Only uses static buffers, a stack buffer and write, so that it can be called from a signal handler.  If the
+// signal arrives while a report is being written, the second report is skipped since they share the buffers.
+void lockProfileReport(int fd) {
+    static LockProfileSite* sites[LOCK_PROFILE_MAX_REPORT_SITES];
+    static U64 waitTimes[LOCK_PROFILE_MAX_REPORT_SITES];
+    static std::atomic<bool> reporting;
+    U32 count = 0;
+
+    if (reporting.exchange(true)) {
+        return;
+    }
+
+    // insertion sort by the time spent waiting, a snapshot is taken of each wait time so the order is stable
+    for (LockProfileSite* site = lockProfileSites.load(); site && count < LOCK_PROFILE_MAX_REPORT_SITES; site = site->next) {
+        if (!site->acquisitions.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        U64 waitTime = site->waitTime.load(std::memory_order_relaxed);
+        U32 i = count++;
+        while (i && waitTimes[i - 1] < waitTime) {
+            sites[i] = sites[i - 1];
+            waitTimes[i] = waitTimes[i - 1];
+            i--;
+        }
+        sites[i] = site;
+        waitTimes[i] = waitTime;
+    }
+    LockProfileLine header;
+    header.add("Lock profile, ");
+    header.add(count, 0);
+    header.add(" call sites sorted by wait time\n");
+    header.add("wait ms", 12);
+    header.add(" ");
+    header.add("hold ms", 12);
+    header.add(" ");
+    header.add("acquisitions", 14);
+    header.add(" ");
+    header.add("contended", 12);
+    header.add(" ");
+    header.add("% waited", 9);
+    header.add("  call site\n");
+    bool ok = header.write(fd);
+    for (U32 i = 0; ok && i < count; i++) {
+        LockProfileSite* site = sites[i];
+        U64 acquisitions = site->acquisitions.load(std::memory_order_relaxed);
+        U64 contended = site->contended.load(std::memory_order_relaxed);
+        U64 holdTime = site->holdTime.load(std::memory_order_relaxed);
+        LockProfileLine line;
+
+        line.addFraction(waitTimes[i], 1000000, 3, 12);
+        line.add(" ");
+        line.addFraction(holdTime, 1000000, 3, 12);
+        line.add(" ");
+        line.add(acquisitions, 14);
+        line.add(" ");
+        line.add(contended, 12);
+        line.add(" ");
+        line.addFraction(contended * 100, acquisitions, 2, 8);
+        line.add("%  ");
+        line.add(site->file);
+        line.add(":");
+        line.add(site->line, 0);
+        line.add("\n");
+        ok = line.write(fd);
+    }
+    reporting = false;
+}
+
+static void lockProfileAtExit() {
+    lockProfileReport(2);
+}
+
+#ifdef BOXEDWINE_POSIX
+static void lockProfileSignal(int sig) {
+    lockProfileReport(2);
+}
+#endif
+
+static struct LockProfileInit {
+    LockProfileInit() {
+        atexit(lockProfileAtExit);
+#ifdef BOXEDWINE_POSIX
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = lockProfileSignal;
+        sa.sa_flags = SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGUSR1, &sa, NULL);
+#endif
+    }
+} lockProfileInit;
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef __LOCK_PROFILER_H__
+#define __LOCK_PROFILER_H__
+
+#ifdef BOXEDWINE_LOCK_PROFILER
+
+// Build with BOXEDWINE_LOCK_PROFILER (and BOXEDWINE_MULTI_THREADED) to find out which locks limit how well the
+// emulator scales across threads.  Every place the BOXEDWINE_ locking macros are used becomes a site that counts
+// how often it locked, how often it had to wait for another thread, how long it waited and how long it held the
+// lock.  Hold time is only counted for the outermost lock of a recursive lock and not while waiting on a
+// condition.
+//
+// The report, sorted by the time spent waiting, is written to stderr when the process exits and, on posix,
+// whenever it gets SIGUSR1.  Calls that don't go through the macros are lumped together as "(no call site)".
+class LockProfileSite {
+public:
+    LockProfileSite(const char* file, U32 line);
+
+    const char* file;
+    U32 line;
+    std::atomic<U64> acquisitions;
+    std::atomic<U64> contended;
+    std::atomic<U64> waitTime; // ns
+    std::atomic<U64> holdTime; // ns
+    LockProfileSite* next;
+
+    static LockProfileSite* noSite();
+};
+
+// lives in each lock, only the thread that holds the lock touches it
+class LockProfileState {
+public:
+    LockProfileState() : holder(NULL), holdStart(0), depth(0) {}
+
+    void acquired(LockProfileSite* site, U64 waitStart);
+    void released();
+    // A condition wait gives up the lock without unlocking it and other threads lock it in the meantime, so the
+    // waiter's state is moved to saved, which is on its stack, and put back once it has the lock again.
+    void suspend(LockProfileState& saved);
+    void resume(const LockProfileState& saved);
+
+private:
+    LockProfileSite* holder;
+    U64 holdStart;
+    U32 depth;
+};
+
+U64 lockProfileNow();
+void lockProfileReport(int fd);
+
+// a lambda so that it works where an expression is expected, each use gets its own static site
+#define BOXEDWINE_LOCK_SITE ([]() -> LockProfileSite* {static LockProfileSite site(__FILE__, __LINE__); return &site;}())
+
+#endif
+
+#endif
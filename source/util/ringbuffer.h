@@ -0,0 +1,125 @@
+#ifndef __RING_BUFFER_H__
+#define __RING_BUFFER_H__
+
+#include "platform.h"
+
+#define RING_BUFFER_MIN_CAPACITY 4096
+// when a ring this big empties, its memory is given back
+#define RING_BUFFER_SHRINK_CAPACITY (1024 * 1024)
+
+// Contiguous byte ring that grows as needed, the owner does the locking.  Reads and writes give the caller the
+// data as at most 2 spans, so that it can be copied straight to or from where it is going, like guest memory,
+// instead of through a temporary buffer.
+class RingBuffer {
+public:
+    RingBuffer() : data(NULL), capacity(0), readPos(0), count(0) {}
+    ~RingBuffer() {
+        if (this->data) {
+            delete[] this->data;
+        }
+    }
+
+    U32 size() {return this->count;}
+
+    // copy(U8* dst, U32 len) is called for each span to fill, the spans add up to len and are in order
+    template <typename T>
+    void write(U32 len, T copy) {
+        if (!len) {
+            return;
+        }
+        this->reserve(len);
+        U32 writePos = (this->readPos + this->count) & (this->capacity - 1);
+        U32 todo = this->capacity - writePos;
+        if (todo > len) {
+            todo = len;
+        }
+        copy(this->data + writePos, todo);
+        if (len > todo) {
+            copy(this->data, len - todo);
+        }
+        this->count += len;
+    }
+
+    void write(const U8* src, U32 len) {
+        this->write(len, [&src](U8* dst, U32 todo) {
+            memcpy(dst, src, todo);
+            src += todo;
+        });
+    }
+
+    // copy(const U8* src, U32 len) is called for each span that is read, returns how much was read
+    template <typename T>
+    U32 read(U32 len, T copy) {
+        if (len > this->count) {
+            len = this->count;
+        }
+        if (!len) {
+            return 0;
+        }
+        U32 todo = this->capacity - this->readPos;
+        if (todo > len) {
+            todo = len;
+        }
+        copy(this->data + this->readPos, todo);
+        if (len > todo) {
+            copy(this->data, len - todo);
+        }
+        this->readPos = (this->readPos + len) & (this->capacity - 1);
+        this->count -= len;
+        if (!this->count) {
+            // the next write starts at the beginning, so a request that fits is never split in 2
+            this->readPos = 0;
+            if (this->capacity >= RING_BUFFER_SHRINK_CAPACITY) {
+                delete[] this->data;
+                this->data = NULL;
+                this->capacity = 0;
+            }
+        }
+        return len;
+    }
+
+    U32 read(U8* dst, U32 len) {
+        return this->read(len, [&dst](const U8* src, U32 todo) {
+            memcpy(dst, src, todo);
+            dst += todo;
+        });
+    }
+
+    void clear() {
+        this->readPos = 0;
+        this->count = 0;
+    }
+
+private:
+    void reserve(U32 len) {
+        if (this->count + len <= this->capacity) {
+            return;
+        }
+        U32 newCapacity = this->capacity ? this->capacity : RING_BUFFER_MIN_CAPACITY;
+        while (newCapacity < this->count + len) {
+            newCapacity <<= 1;
+        }
+        U8* newData = new U8[newCapacity];
+        if (this->count) {
+            U32 todo = this->capacity - this->readPos;
+            if (todo > this->count) {
+                todo = this->count;
+            }
+            memcpy(newData, this->data + this->readPos, todo);
+            memcpy(newData + todo, this->data, this->count - todo);
+        }
+        if (this->data) {
+            delete[] this->data;
+        }
+        this->data = newData;
+        this->capacity = newCapacity;
+        this->readPos = 0;
+    }
+
+    U8* data;
+    U32 capacity; // power of 2
+    U32 readPos;
+    U32 count;
+};
+
+#endif
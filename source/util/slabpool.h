@@ -0,0 +1,138 @@
+#ifndef __SLAB_POOL_H__
+#define __SLAB_POOL_H__
+
+#include "platform.h"
+
+// Objects are carved out of slabs of SLAB_COUNT and recycled through a free list per thread, so allocating and
+// freeing doesn't take a lock.  T must have a "T* next" member that is free to use while the object is not
+// allocated.
+//
+// When a thread's list grows past 2 slabs worth of objects, a slab worth is handed to a shared list that other
+// threads refill from, that way objects freed by one thread can be allocated by another.
+template <typename T, U32 SLAB_COUNT>
+class SlabPool {
+public:
+    static T* alloc() {
+        SlabPoolCache& cache = threadCache;
+        if (!cache.head) {
+            refill(cache);
+        }
+        T* result = cache.head;
+        cache.head = result->next;
+        cache.count--;
+        return result;
+    }
+
+    // Frees count objects that are linked from head to tail through next.  The chain keeps its order, so the next
+    // allocations on this thread get the objects back in the same order, a block that was decoded into a slab
+    // will decode into the same contiguous memory the next time.
+    static void free(T* head, T* tail, U32 count) {
+        SlabPoolCache& cache = threadCache;
+        tail->next = cache.head;
+        cache.head = head;
+        cache.count += count;
+        if (cache.count > SLAB_COUNT * 2) {
+            release(cache, SLAB_COUNT);
+        }
+    }
+
+    static void free(T* t) {
+        free(t, t, 1);
+    }
+
+    // gives the objects cached by the calling thread to the other threads, should be called before a thread exits
+    static void releaseThreadCache() {
+        SlabPoolCache& cache = threadCache;
+        if (cache.count) {
+            release(cache, cache.count);
+        }
+    }
+
+    // Deletes the slabs if nothing is allocated from them, other threads must have called releaseThreadCache
+    static void clear() {
+        releaseThreadCache();
+        BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(mutex);
+        U32 freeCount = 0;
+        for (auto& batch : shared) {
+            freeCount += batch.count;
+        }
+        if (freeCount != (U32)slabs.size() * SLAB_COUNT) {
+            return;
+        }
+        shared.clear();
+        for (auto& slab : slabs) {
+            delete[] slab;
+        }
+        slabs.clear();
+    }
+
+private:
+    // POD so that it can be THREAD_LOCAL on every compiler
+    struct SlabPoolCache {
+        T* head;
+        U32 count;
+    };
+    struct SlabPoolBatch {
+        T* head;
+        U32 count;
+    };
+
+    static void refill(SlabPoolCache& cache) {
+        BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(mutex);
+        if (shared.size()) {
+            SlabPoolBatch& batch = shared.back();
+            cache.head = batch.head;
+            cache.count = batch.count;
+            shared.pop_back();
+            return;
+        }
+        T* slab = new T[SLAB_COUNT];
+        slabs.push_back(slab);
+        for (U32 i = 0; i < SLAB_COUNT - 1; i++) {
+            slab[i].next = &slab[i + 1];
+        }
+        slab[SLAB_COUNT - 1].next = NULL;
+        cache.head = slab;
+        cache.count = SLAB_COUNT;
+    }
+
+    // moves the last count objects of the cache to the shared list, the ones at the front were freed most recently
+    static void release(SlabPoolCache& cache, U32 count) {
+        SlabPoolBatch batch;
+        batch.count = count;
+        if (count == cache.count) {
+            batch.head = cache.head;
+            cache.head = NULL;
+        } else {
+            T* last = cache.head;
+            for (U32 i = 1; i < cache.count - count; i++) {
+                last = last->next;
+            }
+            batch.head = last->next;
+            last->next = NULL;
+        }
+        cache.count -= count;
+
+        BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(mutex);
+        shared.push_back(batch);
+    }
+
+    static THREAD_LOCAL SlabPoolCache threadCache;
+    static std::vector<SlabPoolBatch> shared;
+    static std::vector<T*> slabs;
+    static BOXEDWINE_MUTEX mutex;
+};
+
+template <typename T, U32 SLAB_COUNT>
+THREAD_LOCAL typename SlabPool<T, SLAB_COUNT>::SlabPoolCache SlabPool<T, SLAB_COUNT>::threadCache;
+
+template <typename T, U32 SLAB_COUNT>
+std::vector<typename SlabPool<T, SLAB_COUNT>::SlabPoolBatch> SlabPool<T, SLAB_COUNT>::shared;
+
+template <typename T, U32 SLAB_COUNT>
+std::vector<T*> SlabPool<T, SLAB_COUNT>::slabs;
+
+template <typename T, U32 SLAB_COUNT>
+BOXEDWINE_MUTEX SlabPool<T, SLAB_COUNT>::mutex;
+
+#endif
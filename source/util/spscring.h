@@ -0,0 +1,92 @@
+#ifndef __SPSC_RING_H__
+#define __SPSC_RING_H__
+
+#include "platform.h"
+
+// Wait-free byte ring for exactly one producer thread and one consumer thread, like the emulator writing audio
+// and the audio device callback reading it.  The producer is the only one that moves writePos and the consumer is
+// the only one that moves readPos.  Both are free running counters, so a full ring can be told apart from an empty
+// one without wasting a byte.
+class SpscRing {
+public:
+    SpscRing() : data(NULL), capacity(0), readPos(0), writePos(0) {}
+    ~SpscRing() {
+        if (this->data) {
+            delete[] this->data;
+        }
+    }
+
+    // capacity must be a power of 2, neither the producer nor the consumer can be running
+    void alloc(U32 capacity) {
+        if (capacity != this->capacity) {
+            if (this->data) {
+                delete[] this->data;
+            }
+            this->data = new U8[capacity];
+            this->capacity = capacity;
+        }
+        this->reset();
+    }
+
+    // neither the producer nor the consumer can be running
+    void reset() {
+        this->readPos.store(0);
+        this->writePos.store(0);
+    }
+
+    U32 getCapacity() {return this->capacity;}
+
+    // bytes that can be read, exact for the consumer, a lower bound for the producer
+    U32 size() {
+        return this->writePos.load(std::memory_order_acquire) - this->readPos.load(std::memory_order_acquire);
+    }
+
+    // bytes that can be written, exact for the producer, a lower bound for the consumer
+    U32 space() {
+        return this->capacity - this->size();
+    }
+
+    // producer only, returns how much was written
+    U32 write(const U8* src, U32 len) {
+        U32 w = this->writePos.load(std::memory_order_relaxed);
+        U32 available = this->capacity - (w - this->readPos.load(std::memory_order_acquire));
+        if (len > available) {
+            len = available;
+        }
+        U32 offset = w & (this->capacity - 1);
+        U32 todo = this->capacity - offset;
+        if (todo > len) {
+            todo = len;
+        }
+        memcpy(this->data + offset, src, todo);
+        memcpy(this->data, src + todo, len - todo);
+        this->writePos.store(w + len, std::memory_order_release);
+        return len;
+    }
+
+    // consumer only, returns how much was read
+    U32 read(U8* dst, U32 len) {
+        U32 r = this->readPos.load(std::memory_order_relaxed);
+        U32 available = this->writePos.load(std::memory_order_acquire) - r;
+        if (len > available) {
+            len = available;
+        }
+        U32 offset = r & (this->capacity - 1);
+        U32 todo = this->capacity - offset;
+        if (todo > len) {
+            todo = len;
+        }
+        memcpy(dst, this->data + offset, todo);
+        memcpy(dst + todo, this->data, len - todo);
+        this->readPos.store(r + len, std::memory_order_release);
+        return len;
+    }
+
+private:
+    U8* data;
+    U32 capacity;
+    std::atomic<U32> readPos;
+    std::atomic<U32> writePos;
+};
+
+#endif
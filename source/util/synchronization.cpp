@@ -1,22 +1,60 @@
 #include "boxedwine.h"
 #ifdef BOXEDWINE_MULTI_THREADED
 
+#ifdef BOXEDWINE_LOCK_PROFILER
+BoxedWineCriticalSection::BoxedWineCriticalSection(BoxedWineMutex* mutex, LockProfileSite* site) {
+    this->mutex = mutex;
+    this->mutex->lock(site);
+}
+#else
 BoxedWineCriticalSection::BoxedWineCriticalSection(BoxedWineMutex* mutex) {
     this->mutex = mutex;
     this->mutex->lock();    
 }
+#endif
 BoxedWineCriticalSection::~BoxedWineCriticalSection() {
     this->mutex->unlock();
 }
 
+#ifdef BOXEDWINE_LOCK_PROFILER
+BoxedWineCriticalSectionCond::BoxedWineCriticalSectionCond(BoxedWineCondition* cond, LockProfileSite* site) {
+    this->cond = cond;
+    this->cond->lock(site);
+}
+#else
 BoxedWineCriticalSectionCond::BoxedWineCriticalSectionCond(BoxedWineCondition* cond) {
     this->cond = cond;
     this->cond->lock();
 }
+#endif
 BoxedWineCriticalSectionCond::~BoxedWineCriticalSectionCond() {
     this->cond->unlock();
 }
 
+#ifdef BOXEDWINE_LOCK_PROFILER
+void BoxedWineMutex::lock(LockProfileSite* site) {
+    if (this->m.tryLock()) {
+        this->profile.acquired(site, 0);
+        return;
+    }
+    U64 waitStart = lockProfileNow();
+    this->m.lock();
+    this->profile.acquired(site, waitStart);
+}
+
+bool BoxedWineMutex::tryLock(LockProfileSite* site) {
+    if (this->m.tryLock()) {
+        this->profile.acquired(site, 0);
+        return true;
+    }
+    return false;
+}
+
+void BoxedWineMutex::unlock() {
+    this->profile.released();
+    this->m.unlock();
+}
+#else
 void BoxedWineMutex::lock() {
     this->m.lock();
 }
@@ -28,6 +66,7 @@ bool BoxedWineMutex::tryLock() {
 void BoxedWineMutex::unlock() {
     this->m.unlock();
 }
+#endif
 
 BoxedWineCondition::BoxedWineCondition(std::string name) : name(name) {
     this->lockOwner = 0;
@@ -37,8 +76,53 @@ BoxedWineCondition::BoxedWineCondition() {
     this->lockOwner = 0;
 }
 
+BoxedWineCondition::~BoxedWineCondition() {
+    // an object can be destroyed while one of its conditions is still a child of a long lived parent, like an
+    // epoll, so the parent must not keep pointing at it
+    parentsMutex.lock();
+    while (this->parents.size()) {
+        BoxedWineCondition* p = this->parents.back();
+        if (!p->tryLock()) {
+            // the parent might be in removeChildren waiting on parentsMutex
+            parentsMutex.unlock();
+            parentsMutex.lock();
+            continue;
+        }
+        for (auto it = p->children.begin(); it != p->children.end();) {
+            if (it->cond == this) {
+                it = p->children.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        this->parents.pop_back();
+        p->unlock();
+    }
+    parentsMutex.unlock();
+    // and the children must not keep pointing at it either, a child that is signaling only tryLocks its parents
+    // while it holds its parentsMutex, so taking them in this order can't deadlock
+    this->m.lock();
+    for (auto &child : this->children) {
+        child.cond->parentsMutex.lock();
+        VECTOR_REMOVE(child.cond->parents, this);
+        child.cond->parentsMutex.unlock();
+    }
+    this->children.clear();
+    this->m.unlock();
+}
+
+#ifdef BOXEDWINE_LOCK_PROFILER
+void BoxedWineCondition::lock(LockProfileSite* site) {
+    U64 waitStart = 0;
+    if (!this->m.tryLock()) {
+        waitStart = lockProfileNow();
+        this->m.lock();
+    }
+    this->profile.acquired(site, waitStart);
+#else
 void BoxedWineCondition::lock() {
     this->m.lock();
+#endif
     if (KThread::currentThread()) {
         this->lockOwner = KThread::currentThread()->id;
     } else {
@@ -46,8 +130,14 @@ void BoxedWineCondition::lock() {
     }
 }
  
+#ifdef BOXEDWINE_LOCK_PROFILER
+bool BoxedWineCondition::tryLock(LockProfileSite* site) {
+    if (this->m.tryLock()) {
+        this->profile.acquired(site, 0);
+#else
 bool BoxedWineCondition::tryLock() {
     if (this->m.tryLock()) {
+#endif
         if (KThread::currentThread()) {
             this->lockOwner = KThread::currentThread()->id;
         } else {
@@ -59,6 +149,9 @@ bool BoxedWineCondition::tryLock() {
 }
 
 void BoxedWineCondition::signal() { 
+    if (this->signaledCallback) {
+        this->signaledCallback();
+    }
     parentsMutex.lock();
     if (this->parents.size()>0) {
         // signal will change this->parents so we can't iterate this->parents directly
@@ -67,24 +160,29 @@ void BoxedWineCondition::signal() {
         VECTOR_TO_ARRAY_ON_STACK(this->parents, BoxedWineCondition*, pp);
         for (int i=0;i<count;i++) {
             BoxedWineCondition* p  = pp[i];
-            while(!p->tryLock()) {
+            bool locked = false;
+            // p might have been removed and destroyed while parentsMutex was released
+            while(VECTOR_CONTAINS(this->parents, p) && !(locked = p->tryLock())) {
                 this->unlock();
                 parentsMutex.unlock();
                 this->lock();
                 parentsMutex.lock();
             }
-            if(VECTOR_CONTAINS(this->parents, p)) {
-                p->signal();            
+            if(locked) {
+                p->signal();
+                p->unlock();
             }
-            p->unlock();
         }
-    } else {
-        parentsMutex.unlock();
-        this->c.signal();
     }
+    parentsMutex.unlock();
+    // a parent can stay attached while another thread blocks on this condition directly
+    this->c.signal();
 }
 
 void BoxedWineCondition::signalAll() {
+    if (this->signaledCallback) {
+        this->signaledCallback();
+    }
     parentsMutex.lock();
     if (this->parents.size()>0) {
         BoxedWineCondition** pp = NULL;
@@ -92,24 +190,31 @@ void BoxedWineCondition::signalAll() {
         VECTOR_TO_ARRAY_ON_STACK(this->parents, BoxedWineCondition*, pp);
         for (int i=0;i<count;i++) {
             BoxedWineCondition* p  = pp[i];
-            while(!p->tryLock()) {
+            bool locked = false;
+            // p might have been removed and destroyed while parentsMutex was released
+            while(VECTOR_CONTAINS(this->parents, p) && !(locked = p->tryLock())) {
                 this->unlock();
                 parentsMutex.unlock();
                 this->lock();
                 parentsMutex.lock();
             }
-            if(VECTOR_CONTAINS(this->parents, p)) {
-                p->signalAll();            
+            if(locked) {
+                p->signalAll();
+                p->unlock();
             }
-            p->unlock();
         }
     }
     parentsMutex.unlock();
     this->c.signalAll();
 }
 
+#ifdef BOXEDWINE_LOCK_PROFILER
+void BoxedWineCondition::signalAllLock(LockProfileSite* site) {
+    this->lock(site);
+#else
 void BoxedWineCondition::signalAllLock() {
     this->lock();
+#endif
     this->signalAll();
     this->unlock();
 }
@@ -129,6 +234,29 @@ void BoxedWineCondition::unlockAndRemoveChildren() {
     this->children.clear();
 }
 
+void BoxedWineCondition::unlockChildren() {
+    for (auto &child : this->children) {
+        child.cond->unlock();
+    }
+}
+
+// this should be locked, the children should not be
+void BoxedWineCondition::removeChildren() {
+    for (auto &child : this->children) {
+        child.cond->lock();
+        child.cond->parentsMutex.lock();
+        VECTOR_REMOVE(child.cond->parents, this);
+        child.cond->parentsMutex.unlock();
+        child.cond->unlock();
+    }
+    for (auto &child : this->children) {
+        if (child.doneWaitingCallback) {
+            child.doneWaitingCallback();
+        }
+    }
+    this->children.clear();
+}
+
 void BoxedWineCondition::wait() {    
     for (auto &child : this->children) {
         child.cond->unlock();
@@ -137,7 +265,14 @@ void BoxedWineCondition::wait() {
     if (thread) {
         thread->waitingCond = this;
     }
+#ifdef BOXEDWINE_LOCK_PROFILER
+    LockProfileState saved;
+    this->profile.suspend(saved);
     this->c.wait(this->m);
+    this->profile.resume(saved);
+#else
+    this->c.wait(this->m);
+#endif
     if (thread) {
         BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(thread->waitingCondSync);
         thread->waitingCond = NULL;
@@ -165,7 +300,14 @@ void BoxedWineCondition::waitWithTimeout(U32 ms) {
     if (!KSystem::shutingDown && thread) {
         thread->waitingCond = this;
     }
+#ifdef BOXEDWINE_LOCK_PROFILER
+    LockProfileState saved;
+    this->profile.suspend(saved);
+    this->c.waitWithTimeout(this->m, KSystem::emulatedMilliesToHost(ms));
+    this->profile.resume(saved);
+#else
     this->c.waitWithTimeout(this->m, KSystem::emulatedMilliesToHost(ms));
+#endif
     if (!KSystem::shutingDown && thread) {
         BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(thread->waitingCondSync);
         thread->waitingCond = NULL;
@@ -183,6 +325,9 @@ void BoxedWineCondition::waitWithTimeout(U32 ms) {
 
 void BoxedWineCondition::unlock() {
     this->lockOwner = 0;
+#ifdef BOXEDWINE_LOCK_PROFILER
+    this->profile.released();
+#endif
     this->m.unlock();
 }
 
@@ -214,6 +359,18 @@ BoxedWineCondition::BoxedWineCondition(std::string name) : name(name) {
 }
 
 BoxedWineCondition::~BoxedWineCondition() {
+    for (auto &p : this->parents) {
+        for (auto it = p->children.begin(); it != p->children.end();) {
+            if (it->cond == this) {
+                it = p->children.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (auto &child : this->children) {
+        VECTOR_REMOVE(child.cond->parents, this);
+    }
 }
 
 void BoxedWineCondition::signalThread(bool all) {
@@ -242,6 +399,9 @@ void BoxedWineCondition::signalThread(bool all) {
 }
 
 void BoxedWineCondition::signal() {
+    if (this->signaledCallback) {
+        this->signaledCallback();
+    }
     if (this->parents.size()) {
         // signal will change this->parents so we can't iterate this->parents directly
         BoxedWineCondition** pp = NULL;
@@ -254,6 +414,9 @@ void BoxedWineCondition::signal() {
 }
 
 void BoxedWineCondition::signalAll() {
+    if (this->signaledCallback) {
+        this->signaledCallback();
+    }
     if (this->parents.size()) {
         // signalAll will change this->parents so we can't iterate this->parents directly
         BoxedWineCondition** pp = NULL;
@@ -277,6 +440,10 @@ void BoxedWineCondition::unlockAndRemoveChildren() {
     this->children.clear();
 }
 
+void BoxedWineCondition::removeChildren() {
+    unlockAndRemoveChildren();
+}
+
 U32 BoxedWineCondition::wait() {
     this->waitingThreads.addToBack(&KThread::currentThread()->waitThreadNode);
     KThread::currentThread()->waitingCond = this;
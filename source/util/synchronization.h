@@ -2,6 +2,7 @@
 #define __SYNCHRONIZATION_H__
 
 #include "knativesynchronization.h"
+#include "lockprofiler.h"
 
 class BoxedWineCondition;
 
@@ -15,17 +16,29 @@ public:
 #ifdef BOXEDWINE_MULTI_THREADED
 class BoxedWineMutex {
 public:
+#ifdef BOXEDWINE_LOCK_PROFILER
+    void lock(LockProfileSite* site = NULL);
+    bool tryLock(LockProfileSite* site = NULL);
+#else
     void lock();
     bool tryLock();
+#endif
     void unlock();
 
 private:
     KNativeMutex m;
+#ifdef BOXEDWINE_LOCK_PROFILER
+    LockProfileState profile;
+#endif
 };
 
 class BoxedWineCriticalSection {
 public:
+#ifdef BOXEDWINE_LOCK_PROFILER
+    BoxedWineCriticalSection(BoxedWineMutex* mutex, LockProfileSite* site = NULL);
+#else
     BoxedWineCriticalSection(BoxedWineMutex* mutex);
+#endif
     ~BoxedWineCriticalSection();
 
 private:
@@ -36,20 +49,35 @@ class BoxedWineCondition {
 public:
     BoxedWineCondition(std::string name);
     BoxedWineCondition();
+    ~BoxedWineCondition();
 
+#ifdef BOXEDWINE_LOCK_PROFILER
+    bool tryLock(LockProfileSite* site = NULL);
+    void lock(LockProfileSite* site = NULL);
+#else
     bool tryLock();
     void lock();
+#endif
     void signal();
     void signalAll();
+#ifdef BOXEDWINE_LOCK_PROFILER
+    void signalAllLock(LockProfileSite* site = NULL);
+#else
     void signalAllLock();
+#endif
     void wait();
     void waitWithTimeout(U32 ms);
     void unlock();
     void addChildCondition(BoxedWineCondition& cond, const std::function<void(void)>& doneWaitingCallback);
     void unlockAndRemoveChildren();
+    // for children that stay attached after the parent is unlocked, like the fds registered with an epoll
+    void unlockChildren();
+    void removeChildren();
     U32 waitCount();
 
     const std::string name;
+    // called with this condition locked every time it is signaled, before the parents are signaled
+    std::function<void(void)> signaledCallback;
 
 private:
     std::vector<BoxedWineCondition*> parents;
@@ -59,28 +87,46 @@ private:
     KNativeMutex m;
     KNativeCondition c;
     U32 lockOwner;
+#ifdef BOXEDWINE_LOCK_PROFILER
+    LockProfileState profile;
+#endif
 };
 
 class BoxedWineCriticalSectionCond {
 public:
+#ifdef BOXEDWINE_LOCK_PROFILER
+    BoxedWineCriticalSectionCond(BoxedWineCondition* cond, LockProfileSite* site = NULL);
+#else
     BoxedWineCriticalSectionCond(BoxedWineCondition* cond);
+#endif
     ~BoxedWineCriticalSectionCond();
 
 private:
     BoxedWineCondition* cond;
 };
 
+#ifdef BOXEDWINE_LOCK_PROFILER
+#define BOXEDWINE_CRITICAL_SECTION static BoxedWineMutex csMutex; BoxedWineCriticalSection boxedWineCriticalSection(&csMutex, BOXEDWINE_LOCK_SITE);
+#define BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(csMutex) BoxedWineCriticalSection boxedWineCriticalSection(&csMutex, BOXEDWINE_LOCK_SITE);
+#define BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(csCond) BoxedWineCriticalSectionCond boxedWineCriticalSection(&csCond, BOXEDWINE_LOCK_SITE);
+#define BOXEDWINE_MUTEX_LOCK(mutex) mutex.lock(BOXEDWINE_LOCK_SITE)
+#define BOXEDWINE_MUTEX_TRY_LOCK(mutex) mutex.tryLock(BOXEDWINE_LOCK_SITE)
+#define BOXEDWINE_CONDITION_LOCK(cond) cond.lock(BOXEDWINE_LOCK_SITE)
+#define BOXEDWINE_CONDITION_SIGNAL_ALL_NEED_LOCK(cond) (cond).signalAllLock(BOXEDWINE_LOCK_SITE)
+#else
 #define BOXEDWINE_CRITICAL_SECTION static BoxedWineMutex csMutex; BoxedWineCriticalSection boxedWineCriticalSection(&csMutex);
 #define BOXEDWINE_CRITICAL_SECTION_WITH_MUTEX(csMutex) BoxedWineCriticalSection boxedWineCriticalSection(&csMutex);
 #define BOXEDWINE_CRITICAL_SECTION_WITH_CONDITION(csCond) BoxedWineCriticalSectionCond boxedWineCriticalSection(&csCond);
-
-#define BOXEDWINE_MUTEX BoxedWineMutex
 #define BOXEDWINE_MUTEX_LOCK(mutex) mutex.lock()
 #define BOXEDWINE_MUTEX_TRY_LOCK(mutex) mutex.tryLock()
+#define BOXEDWINE_CONDITION_LOCK(cond) cond.lock()
+#define BOXEDWINE_CONDITION_SIGNAL_ALL_NEED_LOCK(cond) (cond).signalAllLock()
+#endif
+
+#define BOXEDWINE_MUTEX BoxedWineMutex
 #define BOXEDWINE_MUTEX_UNLOCK(mutex) mutex.unlock()
 
 #define BOXEDWINE_CONDITION BoxedWineCondition
-#define BOXEDWINE_CONDITION_LOCK(cond) cond.lock()
 #define BOXEDWINE_CONDITION_UNLOCK(cond) cond.unlock()
 #define BOXEDWINE_CONDITION_SIGNAL(cond) cond.signal()
 #define BOXEDWINE_CONDITION_SIGNAL_ALL(cond) cond.signalAll()
@@ -88,7 +134,6 @@ private:
 #define BOXEDWINE_CONDITION_WAIT_TIMEOUT(cond, t) cond.waitWithTimeout(t)
 #define BOXEDWINE_CONDITION_WAIT_TYPE(x, type) cond.wait()
 #define BOXEDWINE_CONDITION_ADD_CHILD_CONDITION(parent, cond, doneWaitingCallback) (parent).addChildCondition(cond, doneWaitingCallback)
-#define BOXEDWINE_CONDITION_SIGNAL_ALL_NEED_LOCK(cond) (cond).signalAllLock()
 
 #define BoxedWineConditionTimer BoxedWineCondition
 #else
@@ -125,8 +170,12 @@ public:
 
     void addChildCondition(BoxedWineCondition& cond, const std::function<void(void)>& doneWaitingCallback);
     void unlockAndRemoveChildren();
+    void unlockChildren() {}
+    void removeChildren();
 
     const std::string name;
+    // called every time this condition is signaled, before the parents are signaled
+    std::function<void(void)> signaledCallback;
 private:
     KList<KThread*> waitingThreads;
 
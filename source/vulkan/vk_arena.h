@@ -0,0 +1,120 @@
+#ifndef __VK_ARENA_H__
+#define __VK_ARENA_H__
+
+// The host copies of the structures passed to a vk_* call are only needed until the call returns, so instead of
+// new/delete for each one they are carved out of a block that belongs to the thread and is reset when the call ends.
+// If a call needs more than the block has, the extra comes from the heap and the block is grown to fit all of it the
+// next time it is reset, up to VK_ARENA_MAX_BLOCK_SIZE.  One large call shouldn't pin that memory to the thread
+// forever, so once VK_ARENA_SHRINK_RESETS calls in a row have used no more than a quarter of a grown block it is halved.
+
+#define VK_ARENA_BLOCK_SIZE (64 * 1024)
+#define VK_ARENA_MAX_BLOCK_SIZE (1024 * 1024)
+#define VK_ARENA_SHRINK_RESETS 256
+#define VK_ARENA_ALIGN(x) (((x) + 7) & ~7)
+
+class VkArena {
+public:
+    VkArena() : block(NULL), blockSize(0), used(0), extraSize(0), smallResets(0) {}
+    ~VkArena() {
+        reset();
+        delete[] this->block;
+    }
+
+    void* alloc(U32 size) {
+        size = VK_ARENA_ALIGN(size);
+        if (this->blockSize - this->used < size) {
+            return allocExtra(size);
+        }
+        U8* result = (U8*)this->block + this->used;
+        this->used += size;
+        return result;
+    }
+
+    void reset() {
+        U32 newSize = this->blockSize;
+
+        if (this->extra.size()) {
+            for (U64* p : this->extra) {
+                delete[] p;
+            }
+            this->extra.clear();
+            newSize = VK_ARENA_ALIGN(std::min(std::max(this->blockSize + this->extraSize, (U32)VK_ARENA_BLOCK_SIZE), (U32)VK_ARENA_MAX_BLOCK_SIZE));
+            this->extraSize = 0;
+            this->smallResets = 0;
+        } else if (this->blockSize > VK_ARENA_BLOCK_SIZE && this->used <= this->blockSize / 4) {
+            if (++this->smallResets >= VK_ARENA_SHRINK_RESETS) {
+                newSize = std::max(this->blockSize / 2, (U32)VK_ARENA_BLOCK_SIZE);
+                this->smallResets = 0;
+            }
+        } else {
+            this->smallResets = 0;
+        }
+        this->used = 0;
+        if (newSize != this->blockSize) {
+            delete[] this->block;
+            this->blockSize = newSize;
+            this->block = new U64[this->blockSize / 8];
+        }
+    }
+
+    U32 getBlockSize() { return this->blockSize; }
+
+private:
+    void* allocExtra(U32 size) {
+        if (!this->block) {
+            this->blockSize = VK_ARENA_ALIGN(std::max(size, (U32)VK_ARENA_BLOCK_SIZE));
+            this->block = new U64[this->blockSize / 8];
+            return alloc(size);
+        }
+        U64* result = new U64[size / 8];
+        this->extra.push_back(result);
+        this->extraSize += size;
+        return result;
+    }
+
+    U64* block;
+    U32 blockSize;
+    U32 used;
+    std::vector<U64*> extra;
+    U32 extraSize;
+    U32 smallResets;
+};
+
+inline VkArena* vulkanArena() {
+    KThread* thread = KThread::currentThread();
+    if (!thread->vkArena) {
+        thread->vkArena = new VkArena();
+    }
+    return thread->vkArena;
+}
+
+template<typename T> T* vulkanAlloc(U32 count) {
+    return (T*)vulkanArena()->alloc(count * sizeof(T));
+}
+
+// Only for types that have the same layout for the guest and the host.  The guest's memory is used where it is unless
+// the MMU can't hand out all of it as one block.
+template<typename T> T* vulkanGetArray(U32 address, U32 count) {
+    if (!address) {
+        return NULL;
+    }
+    U32 len = count * sizeof(T);
+    T* result = (T*)getPhysicalReadAddress(address, len);
+    if (!result) {
+        result = vulkanAlloc<T>(count);
+        memcopyToNative(address, result, len);
+    }
+    return result;
+}
+
+class VulkanArenaScope {
+public:
+    ~VulkanArenaScope() {
+        KThread* thread = KThread::currentThread();
+        if (thread->vkArena) {
+            thread->vkArena->reset();
+        }
+    }
+};
+
+#endif
@@ -7,6 +7,7 @@
 #include "vk/vulkan_core.h"
 #define BOXED_VK_EXTERN
 #include "vk_host.h"
+#include "vk_arena.h"
 
 void initVulkan();
 void* getVulkanPtr(U32 address);
@@ -39,6 +40,7 @@ class MarshalVkPhysicalDeviceFeatures {
 public:
     MarshalVkPhysicalDeviceFeatures() {}
     VkPhysicalDeviceFeatures s;
+    static_assert(sizeof(VkPhysicalDeviceFeatures) == 220, "VkPhysicalDeviceFeatures is used in place");
     MarshalVkPhysicalDeviceFeatures(U32 address) {read(address, &this->s);}
     static void read(U32 address, VkPhysicalDeviceFeatures* s) {
         s->robustBufferAccess = (VkBool32)readd(address);address+=4;
@@ -214,10 +216,39 @@ public:
     }
 };
 
+class MarshalVkViewport {
+public:
+    MarshalVkViewport() {}
+    VkViewport s;
+    static_assert(sizeof(VkViewport) == 24, "VkViewport is used in place");
+    MarshalVkViewport(U32 address) {read(address, &this->s);}
+    static void read(U32 address, VkViewport* s) {
+        s->x = (float)readd(address);address+=4;
+        s->y = (float)readd(address);address+=4;
+        s->width = (float)readd(address);address+=4;
+        s->height = (float)readd(address);address+=4;
+        s->minDepth = (float)readd(address);address+=4;
+        s->maxDepth = (float)readd(address);address+=4;
+    }
+};
+
+class MarshalVkRect2D {
+public:
+    MarshalVkRect2D() {}
+    VkRect2D s;
+    static_assert(sizeof(VkRect2D) == 16, "VkRect2D is used in place");
+    MarshalVkRect2D(U32 address) {read(address, &this->s);}
+    static void read(U32 address, VkRect2D* s) {
+        memcopyToNative(address, &s->offset, 8);address+=8;
+        memcopyToNative(address, &s->extent, 8);address+=8;
+    }
+};
+
 class MarshalVkComponentMapping {
 public:
     MarshalVkComponentMapping() {}
     VkComponentMapping s;
+    static_assert(sizeof(VkComponentMapping) == 16, "VkComponentMapping is used in place");
     MarshalVkComponentMapping(U32 address) {read(address, &this->s);}
     static void read(U32 address, VkComponentMapping* s) {
         s->r = (VkComponentSwizzle)readd(address);address+=4;
@@ -331,9 +362,9 @@ public:
         if (paramAddress == 0) {
             s->pQueueCreateInfos = NULL;
         } else {
-            VkDeviceQueueCreateInfo* pQueueCreateInfos = new VkDeviceQueueCreateInfo[s->queueCreateInfoCount];
+            VkDeviceQueueCreateInfo* pQueueCreateInfos = vulkanAlloc<VkDeviceQueueCreateInfo>(s->queueCreateInfoCount);
             for (U32 i = 0; i < s->queueCreateInfoCount; i++) {
-                MarshalVkDeviceQueueCreateInfo::read(paramAddress, &pQueueCreateInfos[i]);
+                MarshalVkDeviceQueueCreateInfo::read(paramAddress + i * 24, &pQueueCreateInfos[i]);
             }
             s->pQueueCreateInfos = pQueueCreateInfos;
         }
@@ -342,7 +373,7 @@ public:
         if (paramAddress == 0) {
             s->ppEnabledLayerNames = NULL;
         } else {
-            char** ppEnabledLayerNames = new char*[s->enabledLayerCount];
+            char** ppEnabledLayerNames = vulkanAlloc<char*>(s->enabledLayerCount);
             for (int i=0;i<(int)s->enabledLayerCount;i++) {
                 ppEnabledLayerNames[i] = (char*)getPhysicalAddress(readd(paramAddress + i*4), 0);
             }
@@ -353,7 +384,7 @@ public:
         if (paramAddress == 0) {
             s->ppEnabledExtensionNames = NULL;
         } else {
-            char** ppEnabledExtensionNames = new char*[s->enabledExtensionCount];
+            char** ppEnabledExtensionNames = vulkanAlloc<char*>(s->enabledExtensionCount);
             for (int i=0;i<(int)s->enabledExtensionCount;i++) {
                 ppEnabledExtensionNames[i] = (char*)getPhysicalAddress(readd(paramAddress + i*4), 0);
             }
@@ -363,9 +394,7 @@ public:
         if (paramAddress == 0) {
             s->pEnabledFeatures = NULL;
         } else {
-            VkPhysicalDeviceFeatures* pEnabledFeatures = new VkPhysicalDeviceFeatures();
-            MarshalVkPhysicalDeviceFeatures::read(paramAddress, pEnabledFeatures);
-            s->pEnabledFeatures = pEnabledFeatures;
+            s->pEnabledFeatures = vulkanGetArray<VkPhysicalDeviceFeatures>(paramAddress, 1);
         }
     }
 };
@@ -388,7 +417,7 @@ public:
         if (paramAddress == 0) {
             s->pApplicationInfo = NULL;
         } else {
-            VkApplicationInfo* pApplicationInfo = new VkApplicationInfo();
+            VkApplicationInfo* pApplicationInfo = vulkanAlloc<VkApplicationInfo>(1);
             MarshalVkApplicationInfo::read(paramAddress, pApplicationInfo);
             s->pApplicationInfo = pApplicationInfo;
         }
@@ -397,7 +426,7 @@ public:
         if (paramAddress == 0) {
             s->ppEnabledLayerNames = NULL;
         } else {
-            char** ppEnabledLayerNames = new char*[s->enabledLayerCount];
+            char** ppEnabledLayerNames = vulkanAlloc<char*>(s->enabledLayerCount);
             for (int i=0;i<(int)s->enabledLayerCount;i++) {
                 ppEnabledLayerNames[i] = (char*)getPhysicalAddress(readd(paramAddress + i*4), 0);
             }
@@ -408,7 +437,7 @@ public:
         if (paramAddress == 0) {
             s->ppEnabledExtensionNames = NULL;
         } else {
-            char** ppEnabledExtensionNames = new char*[s->enabledExtensionCount];
+            char** ppEnabledExtensionNames = vulkanAlloc<char*>(s->enabledExtensionCount);
             for (int i=0;i<(int)s->enabledExtensionCount;i++) {
                 ppEnabledExtensionNames[i] = (char*)getPhysicalAddress(readd(paramAddress + i*4), 0);
             }
@@ -454,6 +483,19 @@ public:
     }
 };
 
+class MarshalVkDescriptorBufferInfo {
+public:
+    MarshalVkDescriptorBufferInfo() {}
+    VkDescriptorBufferInfo s;
+    static_assert(sizeof(VkDescriptorBufferInfo) == 24, "VkDescriptorBufferInfo is used in place");
+    MarshalVkDescriptorBufferInfo(U32 address) {read(address, &this->s);}
+    static void read(U32 address, VkDescriptorBufferInfo* s) {
+        s->buffer = (VkBuffer)readq(address);address+=8;
+        s->offset = (VkDeviceSize)readq(address);address+=8;
+        s->range = (VkDeviceSize)readq(address);address+=8;
+    }
+};
+
 class MarshalVkDescriptorImageInfo {
 public:
     MarshalVkDescriptorImageInfo() {}
@@ -488,13 +530,18 @@ public:
         if (paramAddress == 0) {
             s->pImageInfo = NULL;
         } else {
-            VkDescriptorImageInfo* pImageInfo = new VkDescriptorImageInfo[s->descriptorCount];
+            VkDescriptorImageInfo* pImageInfo = vulkanAlloc<VkDescriptorImageInfo>(s->descriptorCount);
             for (U32 i = 0; i < s->descriptorCount; i++) {
-                MarshalVkDescriptorImageInfo::read(paramAddress, &pImageInfo[i]);
+                MarshalVkDescriptorImageInfo::read(paramAddress + i * 20, &pImageInfo[i]);
             }
             s->pImageInfo = pImageInfo;
         }
-        memcopyToNative(address, &s->pBufferInfo, 24);address+=24;
+        paramAddress = readd(address);address+=4;
+        if (paramAddress == 0) {
+            s->pBufferInfo = NULL;
+        } else {
+            s->pBufferInfo = vulkanGetArray<VkDescriptorBufferInfo>(paramAddress, s->descriptorCount);
+        }
         paramAddress = readd(address);address+=4;
         if (paramAddress == 0) {
             s->pTexelBufferView = NULL;
@@ -772,9 +819,9 @@ public:
         if (paramAddress == 0) {
             s->pBufferBinds = NULL;
         } else {
-            VkSparseBufferMemoryBindInfo* pBufferBinds = new VkSparseBufferMemoryBindInfo[s->bufferBindCount];
+            VkSparseBufferMemoryBindInfo* pBufferBinds = vulkanAlloc<VkSparseBufferMemoryBindInfo>(s->bufferBindCount);
             for (U32 i = 0; i < s->bufferBindCount; i++) {
-                MarshalVkSparseBufferMemoryBindInfo::read(paramAddress, &pBufferBinds[i]);
+                MarshalVkSparseBufferMemoryBindInfo::read(paramAddress + i * 16, &pBufferBinds[i]);
             }
             s->pBufferBinds = pBufferBinds;
         }
@@ -783,9 +830,9 @@ public:
         if (paramAddress == 0) {
             s->pImageOpaqueBinds = NULL;
         } else {
-            VkSparseImageOpaqueMemoryBindInfo* pImageOpaqueBinds = new VkSparseImageOpaqueMemoryBindInfo[s->imageOpaqueBindCount];
+            VkSparseImageOpaqueMemoryBindInfo* pImageOpaqueBinds = vulkanAlloc<VkSparseImageOpaqueMemoryBindInfo>(s->imageOpaqueBindCount);
             for (U32 i = 0; i < s->imageOpaqueBindCount; i++) {
-                MarshalVkSparseImageOpaqueMemoryBindInfo::read(paramAddress, &pImageOpaqueBinds[i]);
+                MarshalVkSparseImageOpaqueMemoryBindInfo::read(paramAddress + i * 16, &pImageOpaqueBinds[i]);
             }
             s->pImageOpaqueBinds = pImageOpaqueBinds;
         }
@@ -794,9 +841,9 @@ public:
         if (paramAddress == 0) {
             s->pImageBinds = NULL;
         } else {
-            VkSparseImageMemoryBindInfo* pImageBinds = new VkSparseImageMemoryBindInfo[s->imageBindCount];
+            VkSparseImageMemoryBindInfo* pImageBinds = vulkanAlloc<VkSparseImageMemoryBindInfo>(s->imageBindCount);
             for (U32 i = 0; i < s->imageBindCount; i++) {
-                MarshalVkSparseImageMemoryBindInfo::read(paramAddress, &pImageBinds[i]);
+                MarshalVkSparseImageMemoryBindInfo::read(paramAddress + i * 16, &pImageBinds[i]);
             }
             s->pImageBinds = pImageBinds;
         }
@@ -872,9 +919,9 @@ public:
         if (paramAddress == 0) {
             s->pBindings = NULL;
         } else {
-            VkDescriptorSetLayoutBinding* pBindings = new VkDescriptorSetLayoutBinding[s->bindingCount];
+            VkDescriptorSetLayoutBinding* pBindings = vulkanAlloc<VkDescriptorSetLayoutBinding>(s->bindingCount);
             for (U32 i = 0; i < s->bindingCount; i++) {
-                MarshalVkDescriptorSetLayoutBinding::read(paramAddress, &pBindings[i]);
+                MarshalVkDescriptorSetLayoutBinding::read(paramAddress + i * 20, &pBindings[i]);
             }
             s->pBindings = pBindings;
         }
@@ -885,6 +932,7 @@ class MarshalVkDescriptorPoolSize {
 public:
     MarshalVkDescriptorPoolSize() {}
     VkDescriptorPoolSize s;
+    static_assert(sizeof(VkDescriptorPoolSize) == 8, "VkDescriptorPoolSize is used in place");
     MarshalVkDescriptorPoolSize(U32 address) {read(address, &this->s);}
     static void read(U32 address, VkDescriptorPoolSize* s) {
         s->type = (VkDescriptorType)readd(address);address+=4;
@@ -912,11 +960,7 @@ public:
         if (paramAddress == 0) {
             s->pPoolSizes = NULL;
         } else {
-            VkDescriptorPoolSize* pPoolSizes = new VkDescriptorPoolSize[s->poolSizeCount];
-            for (U32 i = 0; i < s->poolSizeCount; i++) {
-                MarshalVkDescriptorPoolSize::read(paramAddress, &pPoolSizes[i]);
-            }
-            s->pPoolSizes = pPoolSizes;
+            s->pPoolSizes = vulkanGetArray<VkDescriptorPoolSize>(paramAddress, s->poolSizeCount);
         }
     }
 };
@@ -968,9 +1012,9 @@ public:
         if (paramAddress == 0) {
             s->pMapEntries = NULL;
         } else {
-            VkSpecializationMapEntry* pMapEntries = new VkSpecializationMapEntry[s->mapEntryCount];
+            VkSpecializationMapEntry* pMapEntries = vulkanAlloc<VkSpecializationMapEntry>(s->mapEntryCount);
             for (U32 i = 0; i < s->mapEntryCount; i++) {
-                MarshalVkSpecializationMapEntry::read(paramAddress, &pMapEntries[i]);
+                MarshalVkSpecializationMapEntry::read(paramAddress + i * 12, &pMapEntries[i]);
             }
             s->pMapEntries = pMapEntries;
         }
@@ -1010,7 +1054,7 @@ public:
         if (paramAddress == 0) {
             s->pSpecializationInfo = NULL;
         } else {
-            VkSpecializationInfo* pSpecializationInfo = new VkSpecializationInfo();
+            VkSpecializationInfo* pSpecializationInfo = vulkanAlloc<VkSpecializationInfo>(1);
             MarshalVkSpecializationInfo::read(paramAddress, pSpecializationInfo);
             s->pSpecializationInfo = pSpecializationInfo;
         }
@@ -1042,6 +1086,7 @@ class MarshalVkVertexInputBindingDescription {
 public:
     MarshalVkVertexInputBindingDescription() {}
     VkVertexInputBindingDescription s;
+    static_assert(sizeof(VkVertexInputBindingDescription) == 12, "VkVertexInputBindingDescription is used in place");
     MarshalVkVertexInputBindingDescription(U32 address) {read(address, &this->s);}
     static void read(U32 address, VkVertexInputBindingDescription* s) {
         s->binding = (uint32_t)readd(address);address+=4;
@@ -1054,6 +1099,7 @@ class MarshalVkVertexInputAttributeDescription {
 public:
     MarshalVkVertexInputAttributeDescription() {}
     VkVertexInputAttributeDescription s;
+    static_assert(sizeof(VkVertexInputAttributeDescription) == 16, "VkVertexInputAttributeDescription is used in place");
     MarshalVkVertexInputAttributeDescription(U32 address) {read(address, &this->s);}
     static void read(U32 address, VkVertexInputAttributeDescription* s) {
         s->location = (uint32_t)readd(address);address+=4;
@@ -1082,22 +1128,14 @@ public:
         if (paramAddress == 0) {
             s->pVertexBindingDescriptions = NULL;
         } else {
-            VkVertexInputBindingDescription* pVertexBindingDescriptions = new VkVertexInputBindingDescription[s->vertexBindingDescriptionCount];
-            for (U32 i = 0; i < s->vertexBindingDescriptionCount; i++) {
-                MarshalVkVertexInputBindingDescription::read(paramAddress, &pVertexBindingDescriptions[i]);
-            }
-            s->pVertexBindingDescriptions = pVertexBindingDescriptions;
+            s->pVertexBindingDescriptions = vulkanGetArray<VkVertexInputBindingDescription>(paramAddress, s->vertexBindingDescriptionCount);
         }
         s->vertexAttributeDescriptionCount = (uint32_t)readd(address);address+=4;
         paramAddress = readd(address);address+=4;
         if (paramAddress == 0) {
             s->pVertexAttributeDescriptions = NULL;
         } else {
-            VkVertexInputAttributeDescription* pVertexAttributeDescriptions = new VkVertexInputAttributeDescription[s->vertexAttributeDescriptionCount];
-            for (U32 i = 0; i < s->vertexAttributeDescriptionCount; i++) {
-                MarshalVkVertexInputAttributeDescription::read(paramAddress, &pVertexAttributeDescriptions[i]);
-            }
-            s->pVertexAttributeDescriptions = pVertexAttributeDescriptions;
+            s->pVertexAttributeDescriptions = vulkanGetArray<VkVertexInputAttributeDescription>(paramAddress, s->vertexAttributeDescriptionCount);
         }
     }
 };
@@ -1158,14 +1196,14 @@ public:
         if (paramAddress == 0) {
             s->pViewports = NULL;
         } else {
-            s->pViewports = (VkViewport*)getPhysicalAddress(paramAddress, s->viewportCount * sizeof(VkViewport));
+            s->pViewports = vulkanGetArray<VkViewport>(paramAddress, s->viewportCount);
         }
         s->scissorCount = (uint32_t)readd(address);address+=4;
         paramAddress = readd(address);address+=4;
         if (paramAddress == 0) {
             s->pScissors = NULL;
         } else {
-            s->pScissors = (VkRect2D*)getPhysicalAddress(paramAddress, s->scissorCount * sizeof(VkRect2D));
+            s->pScissors = vulkanGetArray<VkRect2D>(paramAddress, s->scissorCount);
         }
     }
 };
@@ -1229,6 +1267,7 @@ class MarshalVkPipelineColorBlendAttachmentState {
 public:
     MarshalVkPipelineColorBlendAttachmentState() {}
     VkPipelineColorBlendAttachmentState s;
+    static_assert(sizeof(VkPipelineColorBlendAttachmentState) == 32, "VkPipelineColorBlendAttachmentState is used in place");
     MarshalVkPipelineColorBlendAttachmentState(U32 address) {read(address, &this->s);}
     static void read(U32 address, VkPipelineColorBlendAttachmentState* s) {
         s->blendEnable = (VkBool32)readd(address);address+=4;
@@ -1263,11 +1302,7 @@ public:
         if (paramAddress == 0) {
             s->pAttachments = NULL;
         } else {
-            VkPipelineColorBlendAttachmentState* pAttachments = new VkPipelineColorBlendAttachmentState[s->attachmentCount];
-            for (U32 i = 0; i < s->attachmentCount; i++) {
-                MarshalVkPipelineColorBlendAttachmentState::read(paramAddress, &pAttachments[i]);
-            }
-            s->pAttachments = pAttachments;
+            s->pAttachments = vulkanGetArray<VkPipelineColorBlendAttachmentState>(paramAddress, s->attachmentCount);
         }
         memcopyToNative(address, &s->blendConstants, 4);address+=4;
     }
@@ -1301,6 +1336,7 @@ class MarshalVkStencilOpState {
 public:
     MarshalVkStencilOpState() {}
     VkStencilOpState s;
+    static_assert(sizeof(VkStencilOpState) == 28, "VkStencilOpState is used in place");
     MarshalVkStencilOpState(U32 address) {read(address, &this->s);}
     static void read(U32 address, VkStencilOpState* s) {
         s->failOp = (VkStencilOp)readd(address);address+=4;
@@ -1358,9 +1394,9 @@ public:
         if (paramAddress == 0) {
             s->pStages = NULL;
         } else {
-            VkPipelineShaderStageCreateInfo* pStages = new VkPipelineShaderStageCreateInfo[s->stageCount];
+            VkPipelineShaderStageCreateInfo* pStages = vulkanAlloc<VkPipelineShaderStageCreateInfo>(s->stageCount);
             for (U32 i = 0; i < s->stageCount; i++) {
-                MarshalVkPipelineShaderStageCreateInfo::read(paramAddress, &pStages[i]);
+                MarshalVkPipelineShaderStageCreateInfo::read(paramAddress + i * 32, &pStages[i]);
             }
             s->pStages = pStages;
         }
@@ -1368,7 +1404,7 @@ public:
         if (paramAddress == 0) {
             s->pVertexInputState = NULL;
         } else {
-            VkPipelineVertexInputStateCreateInfo* pVertexInputState = new VkPipelineVertexInputStateCreateInfo();
+            VkPipelineVertexInputStateCreateInfo* pVertexInputState = vulkanAlloc<VkPipelineVertexInputStateCreateInfo>(1);
             MarshalVkPipelineVertexInputStateCreateInfo::read(paramAddress, pVertexInputState);
             s->pVertexInputState = pVertexInputState;
         }
@@ -1376,7 +1412,7 @@ public:
         if (paramAddress == 0) {
             s->pInputAssemblyState = NULL;
         } else {
-            VkPipelineInputAssemblyStateCreateInfo* pInputAssemblyState = new VkPipelineInputAssemblyStateCreateInfo();
+            VkPipelineInputAssemblyStateCreateInfo* pInputAssemblyState = vulkanAlloc<VkPipelineInputAssemblyStateCreateInfo>(1);
             MarshalVkPipelineInputAssemblyStateCreateInfo::read(paramAddress, pInputAssemblyState);
             s->pInputAssemblyState = pInputAssemblyState;
         }
@@ -1384,7 +1420,7 @@ public:
         if (paramAddress == 0) {
             s->pTessellationState = NULL;
         } else {
-            VkPipelineTessellationStateCreateInfo* pTessellationState = new VkPipelineTessellationStateCreateInfo();
+            VkPipelineTessellationStateCreateInfo* pTessellationState = vulkanAlloc<VkPipelineTessellationStateCreateInfo>(1);
             MarshalVkPipelineTessellationStateCreateInfo::read(paramAddress, pTessellationState);
             s->pTessellationState = pTessellationState;
         }
@@ -1392,7 +1428,7 @@ public:
         if (paramAddress == 0) {
             s->pViewportState = NULL;
         } else {
-            VkPipelineViewportStateCreateInfo* pViewportState = new VkPipelineViewportStateCreateInfo();
+            VkPipelineViewportStateCreateInfo* pViewportState = vulkanAlloc<VkPipelineViewportStateCreateInfo>(1);
             MarshalVkPipelineViewportStateCreateInfo::read(paramAddress, pViewportState);
             s->pViewportState = pViewportState;
         }
@@ -1400,7 +1436,7 @@ public:
         if (paramAddress == 0) {
             s->pRasterizationState = NULL;
         } else {
-            VkPipelineRasterizationStateCreateInfo* pRasterizationState = new VkPipelineRasterizationStateCreateInfo();
+            VkPipelineRasterizationStateCreateInfo* pRasterizationState = vulkanAlloc<VkPipelineRasterizationStateCreateInfo>(1);
             MarshalVkPipelineRasterizationStateCreateInfo::read(paramAddress, pRasterizationState);
             s->pRasterizationState = pRasterizationState;
         }
@@ -1408,7 +1444,7 @@ public:
         if (paramAddress == 0) {
             s->pMultisampleState = NULL;
         } else {
-            VkPipelineMultisampleStateCreateInfo* pMultisampleState = new VkPipelineMultisampleStateCreateInfo();
+            VkPipelineMultisampleStateCreateInfo* pMultisampleState = vulkanAlloc<VkPipelineMultisampleStateCreateInfo>(1);
             MarshalVkPipelineMultisampleStateCreateInfo::read(paramAddress, pMultisampleState);
             s->pMultisampleState = pMultisampleState;
         }
@@ -1416,7 +1452,7 @@ public:
         if (paramAddress == 0) {
             s->pDepthStencilState = NULL;
         } else {
-            VkPipelineDepthStencilStateCreateInfo* pDepthStencilState = new VkPipelineDepthStencilStateCreateInfo();
+            VkPipelineDepthStencilStateCreateInfo* pDepthStencilState = vulkanAlloc<VkPipelineDepthStencilStateCreateInfo>(1);
             MarshalVkPipelineDepthStencilStateCreateInfo::read(paramAddress, pDepthStencilState);
             s->pDepthStencilState = pDepthStencilState;
         }
@@ -1424,7 +1460,7 @@ public:
         if (paramAddress == 0) {
             s->pColorBlendState = NULL;
         } else {
-            VkPipelineColorBlendStateCreateInfo* pColorBlendState = new VkPipelineColorBlendStateCreateInfo();
+            VkPipelineColorBlendStateCreateInfo* pColorBlendState = vulkanAlloc<VkPipelineColorBlendStateCreateInfo>(1);
             MarshalVkPipelineColorBlendStateCreateInfo::read(paramAddress, pColorBlendState);
             s->pColorBlendState = pColorBlendState;
         }
@@ -1432,7 +1468,7 @@ public:
         if (paramAddress == 0) {
             s->pDynamicState = NULL;
         } else {
-            VkPipelineDynamicStateCreateInfo* pDynamicState = new VkPipelineDynamicStateCreateInfo();
+            VkPipelineDynamicStateCreateInfo* pDynamicState = vulkanAlloc<VkPipelineDynamicStateCreateInfo>(1);
             MarshalVkPipelineDynamicStateCreateInfo::read(paramAddress, pDynamicState);
             s->pDynamicState = pDynamicState;
         }
@@ -1468,6 +1504,19 @@ public:
     }
 };
 
+class MarshalVkPushConstantRange {
+public:
+    MarshalVkPushConstantRange() {}
+    VkPushConstantRange s;
+    static_assert(sizeof(VkPushConstantRange) == 12, "VkPushConstantRange is used in place");
+    MarshalVkPushConstantRange(U32 address) {read(address, &this->s);}
+    static void read(U32 address, VkPushConstantRange* s) {
+        s->stageFlags = (VkShaderStageFlags)readd(address);address+=4;
+        s->offset = (uint32_t)readd(address);address+=4;
+        s->size = (uint32_t)readd(address);address+=4;
+    }
+};
+
 class MarshalVkPipelineLayoutCreateInfo {
 public:
     MarshalVkPipelineLayoutCreateInfo() {}
@@ -1494,7 +1543,7 @@ public:
         if (paramAddress == 0) {
             s->pPushConstantRanges = NULL;
         } else {
-            s->pPushConstantRanges = (VkPushConstantRange*)getPhysicalAddress(paramAddress, s->pushConstantRangeCount * sizeof(VkPushConstantRange));
+            s->pPushConstantRanges = vulkanGetArray<VkPushConstantRange>(paramAddress, s->pushConstantRangeCount);
         }
     }
 };
@@ -1608,7 +1657,7 @@ public:
         if (paramAddress == 0) {
             s->pInheritanceInfo = NULL;
         } else {
-            VkCommandBufferInheritanceInfo* pInheritanceInfo = new VkCommandBufferInheritanceInfo();
+            VkCommandBufferInheritanceInfo* pInheritanceInfo = vulkanAlloc<VkCommandBufferInheritanceInfo>(1);
             MarshalVkCommandBufferInheritanceInfo::read(paramAddress, pInheritanceInfo);
             s->pInheritanceInfo = pInheritanceInfo;
         }
@@ -1645,6 +1694,7 @@ class MarshalVkAttachmentDescription {
 public:
     MarshalVkAttachmentDescription() {}
     VkAttachmentDescription s;
+    static_assert(sizeof(VkAttachmentDescription) == 36, "VkAttachmentDescription is used in place");
     MarshalVkAttachmentDescription(U32 address) {read(address, &this->s);}
     static void read(U32 address, VkAttachmentDescription* s) {
         s->flags = (VkAttachmentDescriptionFlags)readd(address);address+=4;
@@ -1663,6 +1713,7 @@ class MarshalVkAttachmentReference {
 public:
     MarshalVkAttachmentReference() {}
     VkAttachmentReference s;
+    static_assert(sizeof(VkAttachmentReference) == 8, "VkAttachmentReference is used in place");
     MarshalVkAttachmentReference(U32 address) {read(address, &this->s);}
     static void read(U32 address, VkAttachmentReference* s) {
         s->attachment = (uint32_t)readd(address);address+=4;
@@ -1683,40 +1734,26 @@ public:
         if (paramAddress == 0) {
             s->pInputAttachments = NULL;
         } else {
-            VkAttachmentReference* pInputAttachments = new VkAttachmentReference[s->inputAttachmentCount];
-            for (U32 i = 0; i < s->inputAttachmentCount; i++) {
-                MarshalVkAttachmentReference::read(paramAddress, &pInputAttachments[i]);
-            }
-            s->pInputAttachments = pInputAttachments;
+            s->pInputAttachments = vulkanGetArray<VkAttachmentReference>(paramAddress, s->inputAttachmentCount);
         }
         s->colorAttachmentCount = (uint32_t)readd(address);address+=4;
         paramAddress = readd(address);address+=4;
         if (paramAddress == 0) {
             s->pColorAttachments = NULL;
         } else {
-            VkAttachmentReference* pColorAttachments = new VkAttachmentReference[s->colorAttachmentCount];
-            for (U32 i = 0; i < s->colorAttachmentCount; i++) {
-                MarshalVkAttachmentReference::read(paramAddress, &pColorAttachments[i]);
-            }
-            s->pColorAttachments = pColorAttachments;
+            s->pColorAttachments = vulkanGetArray<VkAttachmentReference>(paramAddress, s->colorAttachmentCount);
         }
         paramAddress = readd(address);address+=4;
         if (paramAddress == 0) {
             s->pResolveAttachments = NULL;
         } else {
-            VkAttachmentReference* pResolveAttachments = new VkAttachmentReference[s->colorAttachmentCount];
-            for (U32 i = 0; i < s->colorAttachmentCount; i++) {
-                MarshalVkAttachmentReference::read(paramAddress, &pResolveAttachments[i]);
-            }
-            s->pResolveAttachments = pResolveAttachments;
+            s->pResolveAttachments = vulkanGetArray<VkAttachmentReference>(paramAddress, s->colorAttachmentCount);
         }
         paramAddress = readd(address);address+=4;
         if (paramAddress == 0) {
             s->pDepthStencilAttachment = NULL;
         } else {
-            VkAttachmentReference* pDepthStencilAttachment = new VkAttachmentReference();
-            MarshalVkAttachmentReference::read(paramAddress, pDepthStencilAttachment);
-            s->pDepthStencilAttachment = pDepthStencilAttachment;
+            s->pDepthStencilAttachment = vulkanGetArray<VkAttachmentReference>(paramAddress, 1);
         }
         s->preserveAttachmentCount = (uint32_t)readd(address);address+=4;
         paramAddress = readd(address);address+=4;
@@ -1728,6 +1765,23 @@ public:
     }
 };
 
+class MarshalVkSubpassDependency {
+public:
+    MarshalVkSubpassDependency() {}
+    VkSubpassDependency s;
+    static_assert(sizeof(VkSubpassDependency) == 28, "VkSubpassDependency is used in place");
+    MarshalVkSubpassDependency(U32 address) {read(address, &this->s);}
+    static void read(U32 address, VkSubpassDependency* s) {
+        s->srcSubpass = (uint32_t)readd(address);address+=4;
+        s->dstSubpass = (uint32_t)readd(address);address+=4;
+        s->srcStageMask = (VkPipelineStageFlags)readd(address);address+=4;
+        s->dstStageMask = (VkPipelineStageFlags)readd(address);address+=4;
+        s->srcAccessMask = (VkAccessFlags)readd(address);address+=4;
+        s->dstAccessMask = (VkAccessFlags)readd(address);address+=4;
+        s->dependencyFlags = (VkDependencyFlags)readd(address);address+=4;
+    }
+};
+
 class MarshalVkRenderPassCreateInfo {
 public:
     MarshalVkRenderPassCreateInfo() {}
@@ -1747,20 +1801,16 @@ public:
         if (paramAddress == 0) {
             s->pAttachments = NULL;
         } else {
-            VkAttachmentDescription* pAttachments = new VkAttachmentDescription[s->attachmentCount];
-            for (U32 i = 0; i < s->attachmentCount; i++) {
-                MarshalVkAttachmentDescription::read(paramAddress, &pAttachments[i]);
-            }
-            s->pAttachments = pAttachments;
+            s->pAttachments = vulkanGetArray<VkAttachmentDescription>(paramAddress, s->attachmentCount);
         }
         s->subpassCount = (uint32_t)readd(address);address+=4;
         paramAddress = readd(address);address+=4;
         if (paramAddress == 0) {
             s->pSubpasses = NULL;
         } else {
-            VkSubpassDescription* pSubpasses = new VkSubpassDescription[s->subpassCount];
+            VkSubpassDescription* pSubpasses = vulkanAlloc<VkSubpassDescription>(s->subpassCount);
             for (U32 i = 0; i < s->subpassCount; i++) {
-                MarshalVkSubpassDescription::read(paramAddress, &pSubpasses[i]);
+                MarshalVkSubpassDescription::read(paramAddress + i * 40, &pSubpasses[i]);
             }
             s->pSubpasses = pSubpasses;
         }
@@ -1769,7 +1819,7 @@ public:
         if (paramAddress == 0) {
             s->pDependencies = NULL;
         } else {
-            s->pDependencies = (VkSubpassDependency*)getPhysicalAddress(paramAddress, s->dependencyCount * sizeof(VkSubpassDependency));
+            s->pDependencies = vulkanGetArray<VkSubpassDependency>(paramAddress, s->dependencyCount);
         }
     }
 };
@@ -1904,9 +1954,9 @@ public:
         if (paramAddress == 0) {
             s->pCommandBuffers = NULL;
         } else {
-            VkCommandBuffer* pCommandBuffers = new VkCommandBuffer[s->commandBufferCount];
+            VkCommandBuffer* pCommandBuffers = vulkanAlloc<VkCommandBuffer>(s->commandBufferCount);
             for (int i=0;i<(int)s->commandBufferCount;i++) {
-                pCommandBuffers[i] = (VkCommandBuffer)getVulkanPtr(paramAddress);
+                pCommandBuffers[i] = (VkCommandBuffer)getVulkanPtr(readd(paramAddress + i*4));
             }
             s->pCommandBuffers = pCommandBuffers;
         }
@@ -1924,6 +1974,7 @@ class MarshalVkSurfaceCapabilitiesKHR {
 public:
     MarshalVkSurfaceCapabilitiesKHR() {}
     VkSurfaceCapabilitiesKHR s;
+    static_assert(sizeof(VkSurfaceCapabilitiesKHR) == 52, "VkSurfaceCapabilitiesKHR is used in place");
     MarshalVkSurfaceCapabilitiesKHR(U32 address) {read(address, &this->s);}
     static void read(U32 address, VkSurfaceCapabilitiesKHR* s) {
         s->minImageCount = (uint32_t)readd(address);address+=4;
@@ -2057,6 +2108,18 @@ public:
     }
 };
 
+class MarshalVkIndirectCommandsStreamNV {
+public:
+    MarshalVkIndirectCommandsStreamNV() {}
+    VkIndirectCommandsStreamNV s;
+    static_assert(sizeof(VkIndirectCommandsStreamNV) == 16, "VkIndirectCommandsStreamNV is used in place");
+    MarshalVkIndirectCommandsStreamNV(U32 address) {read(address, &this->s);}
+    static void read(U32 address, VkIndirectCommandsStreamNV* s) {
+        s->buffer = (VkBuffer)readq(address);address+=8;
+        s->offset = (VkDeviceSize)readq(address);address+=8;
+    }
+};
+
 class MarshalVkIndirectCommandsLayoutTokenNV {
 public:
     MarshalVkIndirectCommandsLayoutTokenNV() {}
@@ -2116,9 +2179,9 @@ public:
         if (paramAddress == 0) {
             s->pTokens = NULL;
         } else {
-            VkIndirectCommandsLayoutTokenNV* pTokens = new VkIndirectCommandsLayoutTokenNV[s->tokenCount];
+            VkIndirectCommandsLayoutTokenNV* pTokens = vulkanAlloc<VkIndirectCommandsLayoutTokenNV>(s->tokenCount);
             for (U32 i = 0; i < s->tokenCount; i++) {
-                MarshalVkIndirectCommandsLayoutTokenNV::read(paramAddress, &pTokens[i]);
+                MarshalVkIndirectCommandsLayoutTokenNV::read(paramAddress + i * 64, &pTokens[i]);
             }
             s->pTokens = pTokens;
         }
@@ -2153,7 +2216,7 @@ public:
         if (paramAddress == 0) {
             s->pStreams = NULL;
         } else {
-            s->pStreams = (VkIndirectCommandsStreamNV*)getPhysicalAddress(paramAddress, s->streamCount * sizeof(VkIndirectCommandsStreamNV));
+            s->pStreams = vulkanGetArray<VkIndirectCommandsStreamNV>(paramAddress, s->streamCount);
         }
         s->sequencesCount = (uint32_t)readd(address);address+=4;
         s->preprocessBuffer = (VkBuffer)readq(address);address+=8;
@@ -2206,7 +2269,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->features, 220); address+=220;
     }
@@ -2232,7 +2294,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->properties, 800); address+=800;
     }
@@ -2258,7 +2319,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->formatProperties, 12); address+=12;
     }
@@ -2284,7 +2344,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->imageFormatProperties, 32); address+=32;
     }
@@ -2320,7 +2379,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->queueFamilyProperties, 24); address+=24;
     }
@@ -2346,7 +2404,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->memoryProperties, 456); address+=456;
     }
@@ -2361,7 +2418,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->properties, 20); address+=20;
     }
@@ -2427,7 +2483,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->externalMemoryProperties, 12); address+=12;
     }
@@ -2457,7 +2512,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, s->deviceUUID, 16); address+=16;
         memcopyFromNative(address, s->driverUUID, 16); address+=16;
@@ -2506,7 +2560,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->exportFromImportedHandleTypes);address+=4;
         writed(address, s->compatibleHandleTypes);address+=4;
@@ -2553,7 +2606,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->exportFromImportedHandleTypes);address+=4;
         writed(address, s->compatibleHandleTypes);address+=4;
@@ -2570,7 +2622,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->physicalDeviceCount);address+=4;
         memcopyFromNative(address, s->physicalDevices, 128); address+=128;
@@ -2637,7 +2688,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, s->presentMask, 128); address+=128;
         writed(address, s->modes);address+=4;
@@ -2699,9 +2749,9 @@ public:
         if (paramAddress == 0) {
             s->pDescriptorUpdateEntries = NULL;
         } else {
-            VkDescriptorUpdateTemplateEntry* pDescriptorUpdateEntries = new VkDescriptorUpdateTemplateEntry[s->descriptorUpdateEntryCount];
+            VkDescriptorUpdateTemplateEntry* pDescriptorUpdateEntries = vulkanAlloc<VkDescriptorUpdateTemplateEntry>(s->descriptorUpdateEntryCount);
             for (U32 i = 0; i < s->descriptorUpdateEntryCount; i++) {
-                MarshalVkDescriptorUpdateTemplateEntry::read(paramAddress, &pDescriptorUpdateEntries[i]);
+                MarshalVkDescriptorUpdateTemplateEntry::read(paramAddress + i * 24, &pDescriptorUpdateEntries[i]);
             }
             s->pDescriptorUpdateEntries = pDescriptorUpdateEntries;
         }
@@ -2750,7 +2800,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->surfaceCapabilities, 52); address+=52;
     }
@@ -2765,7 +2814,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->surfaceFormat, 8); address+=8;
     }
@@ -2842,7 +2890,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->memoryRequirements, 20); address+=20;
     }
@@ -2857,7 +2904,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->memoryRequirements, 48); address+=48;
     }
@@ -2925,6 +2971,18 @@ public:
     }
 };
 
+class MarshalVkSampleLocationEXT {
+public:
+    MarshalVkSampleLocationEXT() {}
+    VkSampleLocationEXT s;
+    static_assert(sizeof(VkSampleLocationEXT) == 8, "VkSampleLocationEXT is used in place");
+    MarshalVkSampleLocationEXT(U32 address) {read(address, &this->s);}
+    static void read(U32 address, VkSampleLocationEXT* s) {
+        s->x = (float)readd(address);address+=4;
+        s->y = (float)readd(address);address+=4;
+    }
+};
+
 class MarshalVkSampleLocationsInfoEXT {
 public:
     MarshalVkSampleLocationsInfoEXT() {}
@@ -2945,7 +3003,7 @@ public:
         if (paramAddress == 0) {
             s->pSampleLocations = NULL;
         } else {
-            s->pSampleLocations = (VkSampleLocationEXT*)getPhysicalAddress(paramAddress, s->sampleLocationsCount * sizeof(VkSampleLocationEXT));
+            s->pSampleLocations = vulkanGetArray<VkSampleLocationEXT>(paramAddress, s->sampleLocationsCount);
         }
     }
 };
@@ -2970,7 +3028,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, &s->maxSampleLocationGridSize, 8); address+=8;
     }
@@ -3020,7 +3077,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->supported);address+=4;
     }
@@ -3046,7 +3102,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->hostQueryReset);address+=4;
     }
@@ -3072,7 +3127,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->memoryTypeBits);address+=4;
     }
@@ -3160,9 +3214,9 @@ public:
         if (paramAddress == 0) {
             s->pInputAttachments = NULL;
         } else {
-            VkAttachmentReference2* pInputAttachments = new VkAttachmentReference2[s->inputAttachmentCount];
+            VkAttachmentReference2* pInputAttachments = vulkanAlloc<VkAttachmentReference2>(s->inputAttachmentCount);
             for (U32 i = 0; i < s->inputAttachmentCount; i++) {
-                MarshalVkAttachmentReference2::read(paramAddress, &pInputAttachments[i]);
+                MarshalVkAttachmentReference2::read(paramAddress + i * 20, &pInputAttachments[i]);
             }
             s->pInputAttachments = pInputAttachments;
         }
@@ -3171,9 +3225,9 @@ public:
         if (paramAddress == 0) {
             s->pColorAttachments = NULL;
         } else {
-            VkAttachmentReference2* pColorAttachments = new VkAttachmentReference2[s->colorAttachmentCount];
+            VkAttachmentReference2* pColorAttachments = vulkanAlloc<VkAttachmentReference2>(s->colorAttachmentCount);
             for (U32 i = 0; i < s->colorAttachmentCount; i++) {
-                MarshalVkAttachmentReference2::read(paramAddress, &pColorAttachments[i]);
+                MarshalVkAttachmentReference2::read(paramAddress + i * 20, &pColorAttachments[i]);
             }
             s->pColorAttachments = pColorAttachments;
         }
@@ -3181,9 +3235,9 @@ public:
         if (paramAddress == 0) {
             s->pResolveAttachments = NULL;
         } else {
-            VkAttachmentReference2* pResolveAttachments = new VkAttachmentReference2[s->colorAttachmentCount];
+            VkAttachmentReference2* pResolveAttachments = vulkanAlloc<VkAttachmentReference2>(s->colorAttachmentCount);
             for (U32 i = 0; i < s->colorAttachmentCount; i++) {
-                MarshalVkAttachmentReference2::read(paramAddress, &pResolveAttachments[i]);
+                MarshalVkAttachmentReference2::read(paramAddress + i * 20, &pResolveAttachments[i]);
             }
             s->pResolveAttachments = pResolveAttachments;
         }
@@ -3191,7 +3245,7 @@ public:
         if (paramAddress == 0) {
             s->pDepthStencilAttachment = NULL;
         } else {
-            VkAttachmentReference2* pDepthStencilAttachment = new VkAttachmentReference2();
+            VkAttachmentReference2* pDepthStencilAttachment = vulkanAlloc<VkAttachmentReference2>(1);
             MarshalVkAttachmentReference2::read(paramAddress, pDepthStencilAttachment);
             s->pDepthStencilAttachment = pDepthStencilAttachment;
         }
@@ -3248,9 +3302,9 @@ public:
         if (paramAddress == 0) {
             s->pAttachments = NULL;
         } else {
-            VkAttachmentDescription2* pAttachments = new VkAttachmentDescription2[s->attachmentCount];
+            VkAttachmentDescription2* pAttachments = vulkanAlloc<VkAttachmentDescription2>(s->attachmentCount);
             for (U32 i = 0; i < s->attachmentCount; i++) {
-                MarshalVkAttachmentDescription2::read(paramAddress, &pAttachments[i]);
+                MarshalVkAttachmentDescription2::read(paramAddress + i * 44, &pAttachments[i]);
             }
             s->pAttachments = pAttachments;
         }
@@ -3259,9 +3313,9 @@ public:
         if (paramAddress == 0) {
             s->pSubpasses = NULL;
         } else {
-            VkSubpassDescription2* pSubpasses = new VkSubpassDescription2[s->subpassCount];
+            VkSubpassDescription2* pSubpasses = vulkanAlloc<VkSubpassDescription2>(s->subpassCount);
             for (U32 i = 0; i < s->subpassCount; i++) {
-                MarshalVkSubpassDescription2::read(paramAddress, &pSubpasses[i]);
+                MarshalVkSubpassDescription2::read(paramAddress + i * 52, &pSubpasses[i]);
             }
             s->pSubpasses = pSubpasses;
         }
@@ -3270,9 +3324,9 @@ public:
         if (paramAddress == 0) {
             s->pDependencies = NULL;
         } else {
-            VkSubpassDependency2* pDependencies = new VkSubpassDependency2[s->dependencyCount];
+            VkSubpassDependency2* pDependencies = vulkanAlloc<VkSubpassDependency2>(s->dependencyCount);
             for (U32 i = 0; i < s->dependencyCount; i++) {
-                MarshalVkSubpassDependency2::read(paramAddress, &pDependencies[i]);
+                MarshalVkSubpassDependency2::read(paramAddress + i * 40, &pDependencies[i]);
             }
             s->pDependencies = pDependencies;
         }
@@ -3388,7 +3442,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->vertexAttributeInstanceRateDivisor);address+=4;
         writed(address, s->vertexAttributeInstanceRateZeroDivisor);address+=4;
@@ -3416,7 +3469,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->transformFeedback);address+=4;
         writed(address, s->geometryStreams);address+=4;
@@ -3439,6 +3491,19 @@ public:
     }
 };
 
+class MarshalVkCoarseSampleLocationNV {
+public:
+    MarshalVkCoarseSampleLocationNV() {}
+    VkCoarseSampleLocationNV s;
+    static_assert(sizeof(VkCoarseSampleLocationNV) == 12, "VkCoarseSampleLocationNV is used in place");
+    MarshalVkCoarseSampleLocationNV(U32 address) {read(address, &this->s);}
+    static void read(U32 address, VkCoarseSampleLocationNV* s) {
+        s->pixelX = (uint32_t)readd(address);address+=4;
+        s->pixelY = (uint32_t)readd(address);address+=4;
+        s->sample = (uint32_t)readd(address);address+=4;
+    }
+};
+
 class MarshalVkCoarseSampleOrderCustomNV {
 public:
     MarshalVkCoarseSampleOrderCustomNV() {}
@@ -3452,7 +3517,7 @@ public:
         if (paramAddress == 0) {
             s->pSampleLocations = NULL;
         } else {
-            s->pSampleLocations = (VkCoarseSampleLocationNV*)getPhysicalAddress(paramAddress, s->sampleLocationCount * sizeof(VkCoarseSampleLocationNV));
+            s->pSampleLocations = vulkanGetArray<VkCoarseSampleLocationNV>(paramAddress, s->sampleLocationCount);
         }
     }
 };
@@ -3497,9 +3562,9 @@ public:
         if (paramAddress == 0) {
             s->pStages = NULL;
         } else {
-            VkPipelineShaderStageCreateInfo* pStages = new VkPipelineShaderStageCreateInfo[s->stageCount];
+            VkPipelineShaderStageCreateInfo* pStages = vulkanAlloc<VkPipelineShaderStageCreateInfo>(s->stageCount);
             for (U32 i = 0; i < s->stageCount; i++) {
-                MarshalVkPipelineShaderStageCreateInfo::read(paramAddress, &pStages[i]);
+                MarshalVkPipelineShaderStageCreateInfo::read(paramAddress + i * 32, &pStages[i]);
             }
             s->pStages = pStages;
         }
@@ -3508,9 +3573,9 @@ public:
         if (paramAddress == 0) {
             s->pGroups = NULL;
         } else {
-            VkRayTracingShaderGroupCreateInfoNV* pGroups = new VkRayTracingShaderGroupCreateInfoNV[s->groupCount];
+            VkRayTracingShaderGroupCreateInfoNV* pGroups = vulkanAlloc<VkRayTracingShaderGroupCreateInfoNV>(s->groupCount);
             for (U32 i = 0; i < s->groupCount; i++) {
-                MarshalVkRayTracingShaderGroupCreateInfoNV::read(paramAddress, &pGroups[i]);
+                MarshalVkRayTracingShaderGroupCreateInfoNV::read(paramAddress + i * 28, &pGroups[i]);
             }
             s->pGroups = pGroups;
         }
@@ -3619,9 +3684,9 @@ public:
         if (paramAddress == 0) {
             s->pGeometries = NULL;
         } else {
-            VkGeometryNV* pGeometries = new VkGeometryNV[s->geometryCount];
+            VkGeometryNV* pGeometries = vulkanAlloc<VkGeometryNV>(s->geometryCount);
             for (U32 i = 0; i < s->geometryCount; i++) {
-                MarshalVkGeometryNV::read(paramAddress, &pGeometries[i]);
+                MarshalVkGeometryNV::read(paramAddress + i * 128, &pGeometries[i]);
             }
             s->pGeometries = pGeometries;
         }
@@ -3716,7 +3781,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->MSize);address+=4;
         writed(address, s->NSize);address+=4;
@@ -3738,7 +3802,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->unit);address+=4;
         writed(address, s->scope);address+=4;
@@ -3756,7 +3819,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->flags);address+=4;
         memcopyFromNative(address, s->name, 256); address+=256;
@@ -3833,7 +3895,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->coverageReductionMode);address+=4;
         writed(address, s->rasterizationSamples);address+=4;
@@ -3868,7 +3929,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         memcopyFromNative(address, s->name, 256); address+=256;
         memcopyFromNative(address, s->version, 256); address+=256;
@@ -4001,9 +4061,9 @@ public:
         if (paramAddress == 0) {
             s->pRegions = NULL;
         } else {
-            VkBufferCopy2KHR* pRegions = new VkBufferCopy2KHR[s->regionCount];
+            VkBufferCopy2KHR* pRegions = vulkanAlloc<VkBufferCopy2KHR>(s->regionCount);
             for (U32 i = 0; i < s->regionCount; i++) {
-                MarshalVkBufferCopy2KHR::read(paramAddress, &pRegions[i]);
+                MarshalVkBufferCopy2KHR::read(paramAddress + i * 32, &pRegions[i]);
             }
             s->pRegions = pRegions;
         }
@@ -4032,9 +4092,9 @@ public:
         if (paramAddress == 0) {
             s->pRegions = NULL;
         } else {
-            VkImageCopy2KHR* pRegions = new VkImageCopy2KHR[s->regionCount];
+            VkImageCopy2KHR* pRegions = vulkanAlloc<VkImageCopy2KHR>(s->regionCount);
             for (U32 i = 0; i < s->regionCount; i++) {
-                MarshalVkImageCopy2KHR::read(paramAddress, &pRegions[i]);
+                MarshalVkImageCopy2KHR::read(paramAddress + i * 76, &pRegions[i]);
             }
             s->pRegions = pRegions;
         }
@@ -4063,9 +4123,9 @@ public:
         if (paramAddress == 0) {
             s->pRegions = NULL;
         } else {
-            VkImageBlit2KHR* pRegions = new VkImageBlit2KHR[s->regionCount];
+            VkImageBlit2KHR* pRegions = vulkanAlloc<VkImageBlit2KHR>(s->regionCount);
             for (U32 i = 0; i < s->regionCount; i++) {
-                MarshalVkImageBlit2KHR::read(paramAddress, &pRegions[i]);
+                MarshalVkImageBlit2KHR::read(paramAddress + i * 88, &pRegions[i]);
             }
             s->pRegions = pRegions;
         }
@@ -4094,9 +4154,9 @@ public:
         if (paramAddress == 0) {
             s->pRegions = NULL;
         } else {
-            VkBufferImageCopy2KHR* pRegions = new VkBufferImageCopy2KHR[s->regionCount];
+            VkBufferImageCopy2KHR* pRegions = vulkanAlloc<VkBufferImageCopy2KHR>(s->regionCount);
             for (U32 i = 0; i < s->regionCount; i++) {
-                MarshalVkBufferImageCopy2KHR::read(paramAddress, &pRegions[i]);
+                MarshalVkBufferImageCopy2KHR::read(paramAddress + i * 64, &pRegions[i]);
             }
             s->pRegions = pRegions;
         }
@@ -4124,9 +4184,9 @@ public:
         if (paramAddress == 0) {
             s->pRegions = NULL;
         } else {
-            VkBufferImageCopy2KHR* pRegions = new VkBufferImageCopy2KHR[s->regionCount];
+            VkBufferImageCopy2KHR* pRegions = vulkanAlloc<VkBufferImageCopy2KHR>(s->regionCount);
             for (U32 i = 0; i < s->regionCount; i++) {
-                MarshalVkBufferImageCopy2KHR::read(paramAddress, &pRegions[i]);
+                MarshalVkBufferImageCopy2KHR::read(paramAddress + i * 64, &pRegions[i]);
             }
             s->pRegions = pRegions;
         }
@@ -4155,9 +4215,9 @@ public:
         if (paramAddress == 0) {
             s->pRegions = NULL;
         } else {
-            VkImageResolve2KHR* pRegions = new VkImageResolve2KHR[s->regionCount];
+            VkImageResolve2KHR* pRegions = vulkanAlloc<VkImageResolve2KHR>(s->regionCount);
             for (U32 i = 0; i < s->regionCount; i++) {
-                MarshalVkImageResolve2KHR::read(paramAddress, &pRegions[i]);
+                MarshalVkImageResolve2KHR::read(paramAddress + i * 76, &pRegions[i]);
             }
             s->pRegions = pRegions;
         }
@@ -4173,7 +4233,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writed(address, s->sampleCounts);address+=4;
         memcopyFromNative(address, &s->fragmentSize, 8); address+=8;
@@ -4310,9 +4369,9 @@ public:
         if (paramAddress == 0) {
             s->pMemoryBarriers = NULL;
         } else {
-            VkMemoryBarrier2KHR* pMemoryBarriers = new VkMemoryBarrier2KHR[s->memoryBarrierCount];
+            VkMemoryBarrier2KHR* pMemoryBarriers = vulkanAlloc<VkMemoryBarrier2KHR>(s->memoryBarrierCount);
             for (U32 i = 0; i < s->memoryBarrierCount; i++) {
-                MarshalVkMemoryBarrier2KHR::read(paramAddress, &pMemoryBarriers[i]);
+                MarshalVkMemoryBarrier2KHR::read(paramAddress + i * 40, &pMemoryBarriers[i]);
             }
             s->pMemoryBarriers = pMemoryBarriers;
         }
@@ -4321,9 +4380,9 @@ public:
         if (paramAddress == 0) {
             s->pBufferMemoryBarriers = NULL;
         } else {
-            VkBufferMemoryBarrier2KHR* pBufferMemoryBarriers = new VkBufferMemoryBarrier2KHR[s->bufferMemoryBarrierCount];
+            VkBufferMemoryBarrier2KHR* pBufferMemoryBarriers = vulkanAlloc<VkBufferMemoryBarrier2KHR>(s->bufferMemoryBarrierCount);
             for (U32 i = 0; i < s->bufferMemoryBarrierCount; i++) {
-                MarshalVkBufferMemoryBarrier2KHR::read(paramAddress, &pBufferMemoryBarriers[i]);
+                MarshalVkBufferMemoryBarrier2KHR::read(paramAddress + i * 72, &pBufferMemoryBarriers[i]);
             }
             s->pBufferMemoryBarriers = pBufferMemoryBarriers;
         }
@@ -4332,9 +4391,9 @@ public:
         if (paramAddress == 0) {
             s->pImageMemoryBarriers = NULL;
         } else {
-            VkImageMemoryBarrier2KHR* pImageMemoryBarriers = new VkImageMemoryBarrier2KHR[s->imageMemoryBarrierCount];
+            VkImageMemoryBarrier2KHR* pImageMemoryBarriers = vulkanAlloc<VkImageMemoryBarrier2KHR>(s->imageMemoryBarrierCount);
             for (U32 i = 0; i < s->imageMemoryBarrierCount; i++) {
-                MarshalVkImageMemoryBarrier2KHR::read(paramAddress, &pImageMemoryBarriers[i]);
+                MarshalVkImageMemoryBarrier2KHR::read(paramAddress + i * 84, &pImageMemoryBarriers[i]);
             }
             s->pImageMemoryBarriers = pImageMemoryBarriers;
         }
@@ -4398,9 +4457,9 @@ public:
         if (paramAddress == 0) {
             s->pWaitSemaphoreInfos = NULL;
         } else {
-            VkSemaphoreSubmitInfoKHR* pWaitSemaphoreInfos = new VkSemaphoreSubmitInfoKHR[s->waitSemaphoreInfoCount];
+            VkSemaphoreSubmitInfoKHR* pWaitSemaphoreInfos = vulkanAlloc<VkSemaphoreSubmitInfoKHR>(s->waitSemaphoreInfoCount);
             for (U32 i = 0; i < s->waitSemaphoreInfoCount; i++) {
-                MarshalVkSemaphoreSubmitInfoKHR::read(paramAddress, &pWaitSemaphoreInfos[i]);
+                MarshalVkSemaphoreSubmitInfoKHR::read(paramAddress + i * 36, &pWaitSemaphoreInfos[i]);
             }
             s->pWaitSemaphoreInfos = pWaitSemaphoreInfos;
         }
@@ -4409,9 +4468,9 @@ public:
         if (paramAddress == 0) {
             s->pCommandBufferInfos = NULL;
         } else {
-            VkCommandBufferSubmitInfoKHR* pCommandBufferInfos = new VkCommandBufferSubmitInfoKHR[s->commandBufferInfoCount];
+            VkCommandBufferSubmitInfoKHR* pCommandBufferInfos = vulkanAlloc<VkCommandBufferSubmitInfoKHR>(s->commandBufferInfoCount);
             for (U32 i = 0; i < s->commandBufferInfoCount; i++) {
-                MarshalVkCommandBufferSubmitInfoKHR::read(paramAddress, &pCommandBufferInfos[i]);
+                MarshalVkCommandBufferSubmitInfoKHR::read(paramAddress + i * 16, &pCommandBufferInfos[i]);
             }
             s->pCommandBufferInfos = pCommandBufferInfos;
         }
@@ -4420,9 +4479,9 @@ public:
         if (paramAddress == 0) {
             s->pSignalSemaphoreInfos = NULL;
         } else {
-            VkSemaphoreSubmitInfoKHR* pSignalSemaphoreInfos = new VkSemaphoreSubmitInfoKHR[s->signalSemaphoreInfoCount];
+            VkSemaphoreSubmitInfoKHR* pSignalSemaphoreInfos = vulkanAlloc<VkSemaphoreSubmitInfoKHR>(s->signalSemaphoreInfoCount);
             for (U32 i = 0; i < s->signalSemaphoreInfoCount; i++) {
-                MarshalVkSemaphoreSubmitInfoKHR::read(paramAddress, &pSignalSemaphoreInfos[i]);
+                MarshalVkSemaphoreSubmitInfoKHR::read(paramAddress + i * 36, &pSignalSemaphoreInfos[i]);
             }
             s->pSignalSemaphoreInfos = pSignalSemaphoreInfos;
         }
@@ -4438,7 +4497,6 @@ public:
         U32 paramAddress = readd(address);address+=4;
         if (paramAddress != 0) {
             vulkanWriteNextPtr(paramAddress, s->pNext);
-            delete s->pNext;
         }
         writeq(address, s->stage);address+=8;
         paramAddress = readd(address);address+=4;
@@ -4450,6 +4508,7 @@ kpanic("        Can't marshal void*");
 
 // return type: VkResult(4 bytes)
 void vk_CreateInstance(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     initVulkan();
     MarshalVkInstanceCreateInfo local_pCreateInfo(ARG1);
     VkInstanceCreateInfo* pCreateInfo = &local_pCreateInfo.s;
@@ -4460,6 +4519,7 @@ void vk_CreateInstance(CPU* cpu) {
     writed(ARG3, createVulkanPtr((U64)pInstance, NULL));
 }
 void vk_DestroyInstance(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkInstance instance = (VkInstance)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     static bool shown; if (!shown && ARG2) { klog("vkDestroyInstance:VkAllocationCallbacks not implemented"); shown = true;}
@@ -4469,22 +4529,23 @@ void vk_DestroyInstance(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_EnumeratePhysicalDevices(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkInstance instance = (VkInstance)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pPhysicalDeviceCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
     VkPhysicalDevice* pPhysicalDevices = NULL;
     if (ARG3) {
-        pPhysicalDevices = new VkPhysicalDevice[*pPhysicalDeviceCount];
+        pPhysicalDevices = vulkanAlloc<VkPhysicalDevice>(*pPhysicalDeviceCount);
     }
     EAX = pBoxedInfo->pvkEnumeratePhysicalDevices(instance, pPhysicalDeviceCount, pPhysicalDevices);
     if (ARG3) {
         for (U32 i=0;i<*pPhysicalDeviceCount;i++) {
             writed(ARG3 + i*4, createVulkanPtr((U64)pPhysicalDevices[i], pBoxedInfo));
         }
-        delete[] pPhysicalDevices;
     }
 }
 void vk_GetPhysicalDeviceProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceProperties pProperties(ARG2);
@@ -4492,6 +4553,7 @@ void vk_GetPhysicalDeviceProperties(CPU* cpu) {
     MarshalVkPhysicalDeviceProperties::write(ARG2, &pProperties.s);
 }
 void vk_GetPhysicalDeviceQueueFamilyProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pQueueFamilyPropertyCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
@@ -4499,18 +4561,21 @@ void vk_GetPhysicalDeviceQueueFamilyProperties(CPU* cpu) {
     pBoxedInfo->pvkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, pQueueFamilyPropertyCount, pQueueFamilyProperties);
 }
 void vk_GetPhysicalDeviceMemoryProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPhysicalDeviceMemoryProperties* pMemoryProperties = (VkPhysicalDeviceMemoryProperties*)getPhysicalAddress(ARG2, 4);
     pBoxedInfo->pvkGetPhysicalDeviceMemoryProperties(physicalDevice, pMemoryProperties);
 }
 void vk_GetPhysicalDeviceFeatures(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPhysicalDeviceFeatures* pFeatures = (VkPhysicalDeviceFeatures*)getPhysicalAddress(ARG2, 4);
     pBoxedInfo->pvkGetPhysicalDeviceFeatures(physicalDevice, pFeatures);
 }
 void vk_GetPhysicalDeviceFormatProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkFormat format = (VkFormat)ARG2;
@@ -4519,6 +4584,7 @@ void vk_GetPhysicalDeviceFormatProperties(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceImageFormatProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkFormat format = (VkFormat)ARG2;
@@ -4531,6 +4597,7 @@ void vk_GetPhysicalDeviceImageFormatProperties(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateDevice(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDeviceCreateInfo local_pCreateInfo(ARG2);
@@ -4542,6 +4609,7 @@ void vk_CreateDevice(CPU* cpu) {
     writed(ARG4, createVulkanPtr((U64)pDevice, pBoxedInfo));
 }
 void vk_DestroyDevice(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     static bool shown; if (!shown && ARG2) { klog("vkDestroyDevice:VkAllocationCallbacks not implemented"); shown = true;}
@@ -4551,12 +4619,14 @@ void vk_DestroyDevice(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_EnumerateInstanceVersion(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     initVulkan();
     uint32_t* pApiVersion = (uint32_t*)getPhysicalAddress(ARG1, 4);
     EAX = pvkEnumerateInstanceVersion(pApiVersion);
 }
 // return type: VkResult(4 bytes)
 void vk_EnumerateInstanceLayerProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     initVulkan();
     uint32_t* pPropertyCount = (uint32_t*)getPhysicalAddress(ARG1, 4);
     VkLayerProperties* pProperties = (VkLayerProperties*)getPhysicalAddress(ARG2, (U32)(pPropertyCount ? *pPropertyCount : 0));
@@ -4564,6 +4634,7 @@ void vk_EnumerateInstanceLayerProperties(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_EnumerateInstanceExtensionProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     initVulkan();
     char* pLayerName = (char*)getPhysicalAddress(ARG1, 4);
     uint32_t* pPropertyCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
@@ -4572,6 +4643,7 @@ void vk_EnumerateInstanceExtensionProperties(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_EnumerateDeviceLayerProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pPropertyCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
@@ -4580,6 +4652,7 @@ void vk_EnumerateDeviceLayerProperties(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_EnumerateDeviceExtensionProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     char* pLayerName = (char*)getPhysicalAddress(ARG2, 4);
@@ -4588,6 +4661,7 @@ void vk_EnumerateDeviceExtensionProperties(CPU* cpu) {
     EAX = pBoxedInfo->pvkEnumerateDeviceExtensionProperties(physicalDevice, pLayerName, pPropertyCount, pProperties);
 }
 void vk_GetDeviceQueue(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t queueFamilyIndex = (uint32_t)ARG2;
@@ -4598,36 +4672,37 @@ void vk_GetDeviceQueue(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_QueueSubmit(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkQueue queue = (VkQueue)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t submitCount = (uint32_t)ARG2;
     VkSubmitInfo* pSubmits = NULL;
     if (ARG3) {
-        pSubmits = new VkSubmitInfo[submitCount];
+        pSubmits = vulkanAlloc<VkSubmitInfo>(submitCount);
         for (U32 i=0;i<submitCount;i++) {
             MarshalVkSubmitInfo::read(ARG3 + i * 36, &pSubmits[i]);
         }
     }
     VkFence fence = *(VkFence*)getPhysicalAddress(ARG4, 8);
     EAX = pBoxedInfo->pvkQueueSubmit(queue, submitCount, pSubmits, fence);
-    if (pSubmits) {
-        delete[] pSubmits;
-    }
 }
 // return type: VkResult(4 bytes)
 void vk_QueueWaitIdle(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkQueue queue = (VkQueue)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     EAX = pBoxedInfo->pvkQueueWaitIdle(queue);
 }
 // return type: VkResult(4 bytes)
 void vk_DeviceWaitIdle(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     EAX = pBoxedInfo->pvkDeviceWaitIdle(device);
 }
 // return type: VkResult(4 bytes)
 void vk_AllocateMemory(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkMemoryAllocateInfo local_pAllocateInfo(ARG2);
@@ -4641,6 +4716,7 @@ void vk_AllocateMemory(CPU* cpu) {
     }
 }
 void vk_FreeMemory(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDeviceMemory memory = *(VkDeviceMemory*)getPhysicalAddress(ARG2, 8);
@@ -4651,6 +4727,7 @@ void vk_FreeMemory(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_MapMemory(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDeviceMemory memory = *(VkDeviceMemory*)getPhysicalAddress(ARG2, 8);
@@ -4664,6 +4741,7 @@ void vk_MapMemory(CPU* cpu) {
     }
 }
 void vk_UnmapMemory(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDeviceMemory memory = *(VkDeviceMemory*)getPhysicalAddress(ARG2, 8);
@@ -4672,39 +4750,36 @@ void vk_UnmapMemory(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_FlushMappedMemoryRanges(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t memoryRangeCount = (uint32_t)ARG2;
     VkMappedMemoryRange* pMemoryRanges = NULL;
     if (ARG3) {
-        pMemoryRanges = new VkMappedMemoryRange[memoryRangeCount];
+        pMemoryRanges = vulkanAlloc<VkMappedMemoryRange>(memoryRangeCount);
         for (U32 i=0;i<memoryRangeCount;i++) {
             MarshalVkMappedMemoryRange::read(ARG3 + i * 32, &pMemoryRanges[i]);
         }
     }
     EAX = pBoxedInfo->pvkFlushMappedMemoryRanges(device, memoryRangeCount, pMemoryRanges);
-    if (pMemoryRanges) {
-        delete[] pMemoryRanges;
-    }
 }
 // return type: VkResult(4 bytes)
 void vk_InvalidateMappedMemoryRanges(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t memoryRangeCount = (uint32_t)ARG2;
     VkMappedMemoryRange* pMemoryRanges = NULL;
     if (ARG3) {
-        pMemoryRanges = new VkMappedMemoryRange[memoryRangeCount];
+        pMemoryRanges = vulkanAlloc<VkMappedMemoryRange>(memoryRangeCount);
         for (U32 i=0;i<memoryRangeCount;i++) {
             MarshalVkMappedMemoryRange::read(ARG3 + i * 32, &pMemoryRanges[i]);
         }
     }
     EAX = pBoxedInfo->pvkInvalidateMappedMemoryRanges(device, memoryRangeCount, pMemoryRanges);
-    if (pMemoryRanges) {
-        delete[] pMemoryRanges;
-    }
 }
 void vk_GetDeviceMemoryCommitment(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDeviceMemory memory = *(VkDeviceMemory*)getPhysicalAddress(ARG2, 8);
@@ -4712,6 +4787,7 @@ void vk_GetDeviceMemoryCommitment(CPU* cpu) {
     pBoxedInfo->pvkGetDeviceMemoryCommitment(device, memory, pCommittedMemoryInBytes);
 }
 void vk_GetBufferMemoryRequirements(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -4720,6 +4796,7 @@ void vk_GetBufferMemoryRequirements(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_BindBufferMemory(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -4728,6 +4805,7 @@ void vk_BindBufferMemory(CPU* cpu) {
     EAX = pBoxedInfo->pvkBindBufferMemory(device, buffer, memory, memoryOffset);
 }
 void vk_GetImageMemoryRequirements(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImage image = *(VkImage*)getPhysicalAddress(ARG2, 8);
@@ -4736,6 +4814,7 @@ void vk_GetImageMemoryRequirements(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_BindImageMemory(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImage image = *(VkImage*)getPhysicalAddress(ARG2, 8);
@@ -4744,6 +4823,7 @@ void vk_BindImageMemory(CPU* cpu) {
     EAX = pBoxedInfo->pvkBindImageMemory(device, image, memory, memoryOffset);
 }
 void vk_GetImageSparseMemoryRequirements(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImage image = *(VkImage*)getPhysicalAddress(ARG2, 8);
@@ -4752,6 +4832,7 @@ void vk_GetImageSparseMemoryRequirements(CPU* cpu) {
     pBoxedInfo->pvkGetImageSparseMemoryRequirements(device, image, pSparseMemoryRequirementCount, pSparseMemoryRequirements);
 }
 void vk_GetPhysicalDeviceSparseImageFormatProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkFormat format = (VkFormat)ARG2;
@@ -4765,24 +4846,23 @@ void vk_GetPhysicalDeviceSparseImageFormatProperties(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_QueueBindSparse(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkQueue queue = (VkQueue)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t bindInfoCount = (uint32_t)ARG2;
     VkBindSparseInfo* pBindInfo = NULL;
     if (ARG3) {
-        pBindInfo = new VkBindSparseInfo[bindInfoCount];
+        pBindInfo = vulkanAlloc<VkBindSparseInfo>(bindInfoCount);
         for (U32 i=0;i<bindInfoCount;i++) {
             MarshalVkBindSparseInfo::read(ARG3 + i * 48, &pBindInfo[i]);
         }
     }
     VkFence fence = *(VkFence*)getPhysicalAddress(ARG4, 8);
     EAX = pBoxedInfo->pvkQueueBindSparse(queue, bindInfoCount, pBindInfo, fence);
-    if (pBindInfo) {
-        delete[] pBindInfo;
-    }
 }
 // return type: VkResult(4 bytes)
 void vk_CreateFence(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkFenceCreateInfo local_pCreateInfo(ARG2);
@@ -4793,6 +4873,7 @@ void vk_CreateFence(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateFence(device, pCreateInfo, pAllocator, pFence);
 }
 void vk_DestroyFence(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkFence fence = *(VkFence*)getPhysicalAddress(ARG2, 8);
@@ -4802,6 +4883,7 @@ void vk_DestroyFence(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_ResetFences(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t fenceCount = (uint32_t)ARG2;
@@ -4810,6 +4892,7 @@ void vk_ResetFences(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetFenceStatus(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkFence fence = *(VkFence*)getPhysicalAddress(ARG2, 8);
@@ -4817,6 +4900,7 @@ void vk_GetFenceStatus(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_WaitForFences(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t fenceCount = (uint32_t)ARG2;
@@ -4827,6 +4911,7 @@ void vk_WaitForFences(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateSemaphore(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSemaphoreCreateInfo local_pCreateInfo(ARG2);
@@ -4837,6 +4922,7 @@ void vk_CreateSemaphore(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateSemaphore(device, pCreateInfo, pAllocator, pSemaphore);
 }
 void vk_DestroySemaphore(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSemaphore semaphore = *(VkSemaphore*)getPhysicalAddress(ARG2, 8);
@@ -4846,6 +4932,7 @@ void vk_DestroySemaphore(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateEvent(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkEventCreateInfo local_pCreateInfo(ARG2);
@@ -4856,6 +4943,7 @@ void vk_CreateEvent(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateEvent(device, pCreateInfo, pAllocator, pEvent);
 }
 void vk_DestroyEvent(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkEvent event = *(VkEvent*)getPhysicalAddress(ARG2, 8);
@@ -4865,6 +4953,7 @@ void vk_DestroyEvent(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetEventStatus(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkEvent event = *(VkEvent*)getPhysicalAddress(ARG2, 8);
@@ -4872,6 +4961,7 @@ void vk_GetEventStatus(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_SetEvent(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkEvent event = *(VkEvent*)getPhysicalAddress(ARG2, 8);
@@ -4879,6 +4969,7 @@ void vk_SetEvent(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_ResetEvent(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkEvent event = *(VkEvent*)getPhysicalAddress(ARG2, 8);
@@ -4886,6 +4977,7 @@ void vk_ResetEvent(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateQueryPool(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkQueryPoolCreateInfo local_pCreateInfo(ARG2);
@@ -4896,6 +4988,7 @@ void vk_CreateQueryPool(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateQueryPool(device, pCreateInfo, pAllocator, pQueryPool);
 }
 void vk_DestroyQueryPool(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkQueryPool queryPool = *(VkQueryPool*)getPhysicalAddress(ARG2, 8);
@@ -4905,6 +4998,7 @@ void vk_DestroyQueryPool(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetQueryPoolResults(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkQueryPool queryPool = *(VkQueryPool*)getPhysicalAddress(ARG2, 8);
@@ -4917,6 +5011,7 @@ void vk_GetQueryPoolResults(CPU* cpu) {
     EAX = pBoxedInfo->pvkGetQueryPoolResults(device, queryPool, firstQuery, queryCount, dataSize, pData, stride, flags);
 }
 void vk_ResetQueryPool(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkQueryPool queryPool = *(VkQueryPool*)getPhysicalAddress(ARG2, 8);
@@ -4925,6 +5020,7 @@ void vk_ResetQueryPool(CPU* cpu) {
     pBoxedInfo->pvkResetQueryPool(device, queryPool, firstQuery, queryCount);
 }
 void vk_ResetQueryPoolEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkQueryPool queryPool = *(VkQueryPool*)getPhysicalAddress(ARG2, 8);
@@ -4934,6 +5030,7 @@ void vk_ResetQueryPoolEXT(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateBuffer(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkBufferCreateInfo local_pCreateInfo(ARG2);
@@ -4944,6 +5041,7 @@ void vk_CreateBuffer(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateBuffer(device, pCreateInfo, pAllocator, pBuffer);
 }
 void vk_DestroyBuffer(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -4953,6 +5051,7 @@ void vk_DestroyBuffer(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateBufferView(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkBufferViewCreateInfo local_pCreateInfo(ARG2);
@@ -4963,6 +5062,7 @@ void vk_CreateBufferView(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateBufferView(device, pCreateInfo, pAllocator, pView);
 }
 void vk_DestroyBufferView(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBufferView bufferView = *(VkBufferView*)getPhysicalAddress(ARG2, 8);
@@ -4972,6 +5072,7 @@ void vk_DestroyBufferView(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateImage(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkImageCreateInfo local_pCreateInfo(ARG2);
@@ -4980,11 +5081,9 @@ void vk_CreateImage(CPU* cpu) {
     VkAllocationCallbacks* pAllocator = NULL;
     VkImage* pImage = (VkImage*)getPhysicalAddress(ARG4, 4);
     EAX = pBoxedInfo->pvkCreateImage(device, pCreateInfo, pAllocator, pImage);
-    if (EAX) {
-        int ii = 0;
-    }
 }
 void vk_DestroyImage(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImage image = *(VkImage*)getPhysicalAddress(ARG2, 8);
@@ -4993,6 +5092,7 @@ void vk_DestroyImage(CPU* cpu) {
     pBoxedInfo->pvkDestroyImage(device, image, pAllocator);
 }
 void vk_GetImageSubresourceLayout(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImage image = *(VkImage*)getPhysicalAddress(ARG2, 8);
@@ -5002,6 +5102,7 @@ void vk_GetImageSubresourceLayout(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateImageView(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkImageViewCreateInfo local_pCreateInfo(ARG2);
@@ -5012,6 +5113,7 @@ void vk_CreateImageView(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateImageView(device, pCreateInfo, pAllocator, pView);
 }
 void vk_DestroyImageView(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImageView imageView = *(VkImageView*)getPhysicalAddress(ARG2, 8);
@@ -5021,6 +5123,7 @@ void vk_DestroyImageView(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateShaderModule(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkShaderModuleCreateInfo local_pCreateInfo(ARG2);
@@ -5031,6 +5134,7 @@ void vk_CreateShaderModule(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateShaderModule(device, pCreateInfo, pAllocator, pShaderModule);
 }
 void vk_DestroyShaderModule(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkShaderModule shaderModule = *(VkShaderModule*)getPhysicalAddress(ARG2, 8);
@@ -5040,6 +5144,7 @@ void vk_DestroyShaderModule(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreatePipelineCache(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPipelineCacheCreateInfo local_pCreateInfo(ARG2);
@@ -5050,6 +5155,7 @@ void vk_CreatePipelineCache(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreatePipelineCache(device, pCreateInfo, pAllocator, pPipelineCache);
 }
 void vk_DestroyPipelineCache(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineCache pipelineCache = *(VkPipelineCache*)getPhysicalAddress(ARG2, 8);
@@ -5059,6 +5165,7 @@ void vk_DestroyPipelineCache(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPipelineCacheData(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineCache pipelineCache = *(VkPipelineCache*)getPhysicalAddress(ARG2, 8);
@@ -5068,6 +5175,7 @@ void vk_GetPipelineCacheData(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_MergePipelineCaches(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineCache dstCache = *(VkPipelineCache*)getPhysicalAddress(ARG2, 8);
@@ -5077,13 +5185,14 @@ void vk_MergePipelineCaches(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateGraphicsPipelines(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineCache pipelineCache = *(VkPipelineCache*)getPhysicalAddress(ARG2, 8);
     uint32_t createInfoCount = (uint32_t)ARG3;
     VkGraphicsPipelineCreateInfo* pCreateInfos = NULL;
     if (ARG4) {
-        pCreateInfos = new VkGraphicsPipelineCreateInfo[createInfoCount];
+        pCreateInfos = vulkanAlloc<VkGraphicsPipelineCreateInfo>(createInfoCount);
         for (U32 i=0;i<createInfoCount;i++) {
             MarshalVkGraphicsPipelineCreateInfo::read(ARG4 + i * 88, &pCreateInfos[i]);
         }
@@ -5092,19 +5201,17 @@ void vk_CreateGraphicsPipelines(CPU* cpu) {
     VkAllocationCallbacks* pAllocator = NULL;
     VkPipeline* pPipelines = (VkPipeline*)getPhysicalAddress(ARG6, (U32)createInfoCount * 4);
     EAX = pBoxedInfo->pvkCreateGraphicsPipelines(device, pipelineCache, createInfoCount, pCreateInfos, pAllocator, pPipelines);
-    if (pCreateInfos) {
-        delete[] pCreateInfos;
-    }
 }
 // return type: VkResult(4 bytes)
 void vk_CreateComputePipelines(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineCache pipelineCache = *(VkPipelineCache*)getPhysicalAddress(ARG2, 8);
     uint32_t createInfoCount = (uint32_t)ARG3;
     VkComputePipelineCreateInfo* pCreateInfos = NULL;
     if (ARG4) {
-        pCreateInfos = new VkComputePipelineCreateInfo[createInfoCount];
+        pCreateInfos = vulkanAlloc<VkComputePipelineCreateInfo>(createInfoCount);
         for (U32 i=0;i<createInfoCount;i++) {
             MarshalVkComputePipelineCreateInfo::read(ARG4 + i * 64, &pCreateInfos[i]);
         }
@@ -5113,18 +5220,17 @@ void vk_CreateComputePipelines(CPU* cpu) {
     VkAllocationCallbacks* pAllocator = NULL;
     VkPipeline* pPipelines = (VkPipeline*)getPhysicalAddress(ARG6, (U32)createInfoCount * 4);
     EAX = pBoxedInfo->pvkCreateComputePipelines(device, pipelineCache, createInfoCount, pCreateInfos, pAllocator, pPipelines);
-    if (pCreateInfos) {
-        delete[] pCreateInfos;
-    }
 }
 // return type: VkResult(4 bytes)
 void vk_GetSubpassShadingMaxWorkgroupSizeHUAWEI(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     initVulkan();
     VkRenderPass renderpass = *(VkRenderPass*)getPhysicalAddress(ARG1, 8);
     VkExtent2D* pMaxWorkgroupSize = (VkExtent2D*)getPhysicalAddress(ARG2, 4);
     EAX = pvkGetSubpassShadingMaxWorkgroupSizeHUAWEI(renderpass, pMaxWorkgroupSize);
 }
 void vk_DestroyPipeline(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipeline pipeline = *(VkPipeline*)getPhysicalAddress(ARG2, 8);
@@ -5134,6 +5240,7 @@ void vk_DestroyPipeline(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreatePipelineLayout(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPipelineLayoutCreateInfo local_pCreateInfo(ARG2);
@@ -5144,6 +5251,7 @@ void vk_CreatePipelineLayout(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreatePipelineLayout(device, pCreateInfo, pAllocator, pPipelineLayout);
 }
 void vk_DestroyPipelineLayout(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineLayout pipelineLayout = *(VkPipelineLayout*)getPhysicalAddress(ARG2, 8);
@@ -5153,6 +5261,7 @@ void vk_DestroyPipelineLayout(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateSampler(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSamplerCreateInfo local_pCreateInfo(ARG2);
@@ -5163,6 +5272,7 @@ void vk_CreateSampler(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateSampler(device, pCreateInfo, pAllocator, pSampler);
 }
 void vk_DestroySampler(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSampler sampler = *(VkSampler*)getPhysicalAddress(ARG2, 8);
@@ -5172,6 +5282,7 @@ void vk_DestroySampler(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateDescriptorSetLayout(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDescriptorSetLayoutCreateInfo local_pCreateInfo(ARG2);
@@ -5182,6 +5293,7 @@ void vk_CreateDescriptorSetLayout(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateDescriptorSetLayout(device, pCreateInfo, pAllocator, pSetLayout);
 }
 void vk_DestroyDescriptorSetLayout(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDescriptorSetLayout descriptorSetLayout = *(VkDescriptorSetLayout*)getPhysicalAddress(ARG2, 8);
@@ -5191,6 +5303,7 @@ void vk_DestroyDescriptorSetLayout(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateDescriptorPool(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDescriptorPoolCreateInfo local_pCreateInfo(ARG2);
@@ -5201,6 +5314,7 @@ void vk_CreateDescriptorPool(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateDescriptorPool(device, pCreateInfo, pAllocator, pDescriptorPool);
 }
 void vk_DestroyDescriptorPool(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDescriptorPool descriptorPool = *(VkDescriptorPool*)getPhysicalAddress(ARG2, 8);
@@ -5210,6 +5324,7 @@ void vk_DestroyDescriptorPool(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_ResetDescriptorPool(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDescriptorPool descriptorPool = *(VkDescriptorPool*)getPhysicalAddress(ARG2, 8);
@@ -5218,6 +5333,7 @@ void vk_ResetDescriptorPool(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_AllocateDescriptorSets(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDescriptorSetAllocateInfo local_pAllocateInfo(ARG2);
@@ -5227,6 +5343,7 @@ void vk_AllocateDescriptorSets(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_FreeDescriptorSets(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDescriptorPool descriptorPool = *(VkDescriptorPool*)getPhysicalAddress(ARG2, 8);
@@ -5235,34 +5352,30 @@ void vk_FreeDescriptorSets(CPU* cpu) {
     EAX = pBoxedInfo->pvkFreeDescriptorSets(device, descriptorPool, descriptorSetCount, pDescriptorSets);
 }
 void vk_UpdateDescriptorSets(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t descriptorWriteCount = (uint32_t)ARG2;
     VkWriteDescriptorSet* pDescriptorWrites = NULL;
     if (ARG3) {
-        pDescriptorWrites = new VkWriteDescriptorSet[descriptorWriteCount];
+        pDescriptorWrites = vulkanAlloc<VkWriteDescriptorSet>(descriptorWriteCount);
         for (U32 i=0;i<descriptorWriteCount;i++) {
-            MarshalVkWriteDescriptorSet::read(ARG3 + i * 64, &pDescriptorWrites[i]);
+            MarshalVkWriteDescriptorSet::read(ARG3 + i * 44, &pDescriptorWrites[i]);
         }
     }
     uint32_t descriptorCopyCount = (uint32_t)ARG4;
     VkCopyDescriptorSet* pDescriptorCopies = NULL;
     if (ARG5) {
-        pDescriptorCopies = new VkCopyDescriptorSet[descriptorCopyCount];
+        pDescriptorCopies = vulkanAlloc<VkCopyDescriptorSet>(descriptorCopyCount);
         for (U32 i=0;i<descriptorCopyCount;i++) {
             MarshalVkCopyDescriptorSet::read(ARG5 + i * 44, &pDescriptorCopies[i]);
         }
     }
     pBoxedInfo->pvkUpdateDescriptorSets(device, descriptorWriteCount, pDescriptorWrites, descriptorCopyCount, pDescriptorCopies);
-    if (pDescriptorWrites) {
-        delete[] pDescriptorWrites;
-    }
-    if (pDescriptorCopies) {
-        delete[] pDescriptorCopies;
-    }
 }
 // return type: VkResult(4 bytes)
 void vk_CreateFramebuffer(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkFramebufferCreateInfo local_pCreateInfo(ARG2);
@@ -5273,6 +5386,7 @@ void vk_CreateFramebuffer(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateFramebuffer(device, pCreateInfo, pAllocator, pFramebuffer);
 }
 void vk_DestroyFramebuffer(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkFramebuffer framebuffer = *(VkFramebuffer*)getPhysicalAddress(ARG2, 8);
@@ -5282,6 +5396,7 @@ void vk_DestroyFramebuffer(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateRenderPass(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkRenderPassCreateInfo local_pCreateInfo(ARG2);
@@ -5292,6 +5407,7 @@ void vk_CreateRenderPass(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateRenderPass(device, pCreateInfo, pAllocator, pRenderPass);
 }
 void vk_DestroyRenderPass(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkRenderPass renderPass = *(VkRenderPass*)getPhysicalAddress(ARG2, 8);
@@ -5300,6 +5416,7 @@ void vk_DestroyRenderPass(CPU* cpu) {
     pBoxedInfo->pvkDestroyRenderPass(device, renderPass, pAllocator);
 }
 void vk_GetRenderAreaGranularity(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkRenderPass renderPass = *(VkRenderPass*)getPhysicalAddress(ARG2, 8);
@@ -5308,6 +5425,7 @@ void vk_GetRenderAreaGranularity(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateCommandPool(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkCommandPoolCreateInfo local_pCreateInfo(ARG2);
@@ -5318,6 +5436,7 @@ void vk_CreateCommandPool(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateCommandPool(device, pCreateInfo, pAllocator, pCommandPool);
 }
 void vk_DestroyCommandPool(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkCommandPool commandPool = *(VkCommandPool*)getPhysicalAddress(ARG2, 8);
@@ -5327,6 +5446,7 @@ void vk_DestroyCommandPool(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_ResetCommandPool(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkCommandPool commandPool = *(VkCommandPool*)getPhysicalAddress(ARG2, 8);
@@ -5335,36 +5455,37 @@ void vk_ResetCommandPool(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_AllocateCommandBuffers(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkCommandBufferAllocateInfo local_pAllocateInfo(ARG2);
     VkCommandBufferAllocateInfo* pAllocateInfo = &local_pAllocateInfo.s;
     VkCommandBuffer* pCommandBuffers = NULL;
     if (ARG3) {
-        pCommandBuffers = new VkCommandBuffer[pAllocateInfo->commandBufferCount];
+        pCommandBuffers = vulkanAlloc<VkCommandBuffer>(pAllocateInfo->commandBufferCount);
     }
     EAX = pBoxedInfo->pvkAllocateCommandBuffers(device, pAllocateInfo, pCommandBuffers);
     if (ARG3) {
         for (U32 i=0;i<pAllocateInfo->commandBufferCount;i++) {
             writed(ARG3 + i*4, createVulkanPtr((U64)pCommandBuffers[i], pBoxedInfo));
         }
-        delete[] pCommandBuffers;
     }
 }
 void vk_FreeCommandBuffers(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkCommandPool commandPool = *(VkCommandPool*)getPhysicalAddress(ARG2, 8);
     uint32_t commandBufferCount = (uint32_t)ARG3;
-    VkCommandBuffer* pCommandBuffers = new VkCommandBuffer[commandBufferCount];
+    VkCommandBuffer* pCommandBuffers = vulkanAlloc<VkCommandBuffer>(commandBufferCount);
     for (U32 i=0;i<commandBufferCount;i++) {
         pCommandBuffers[i] = (VkCommandBuffer)getVulkanPtr(readd(ARG4 + i*4));
     }
     pBoxedInfo->pvkFreeCommandBuffers(device, commandPool, commandBufferCount, pCommandBuffers);
-    delete[] pCommandBuffers;
 }
 // return type: VkResult(4 bytes)
 void vk_BeginCommandBuffer(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkCommandBufferBeginInfo local_pBeginInfo(ARG2);
@@ -5373,18 +5494,21 @@ void vk_BeginCommandBuffer(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_EndCommandBuffer(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     EAX = pBoxedInfo->pvkEndCommandBuffer(commandBuffer);
 }
 // return type: VkResult(4 bytes)
 void vk_ResetCommandBuffer(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkCommandBufferResetFlags flags = (VkCommandBufferResetFlags)ARG2;
     EAX = pBoxedInfo->pvkResetCommandBuffer(commandBuffer, flags);
 }
 void vk_CmdBindPipeline(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineBindPoint pipelineBindPoint = (VkPipelineBindPoint)ARG2;
@@ -5392,6 +5516,7 @@ void vk_CmdBindPipeline(CPU* cpu) {
     pBoxedInfo->pvkCmdBindPipeline(commandBuffer, pipelineBindPoint, pipeline);
 }
 void vk_CmdSetViewport(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t firstViewport = (uint32_t)ARG2;
@@ -5400,6 +5525,7 @@ void vk_CmdSetViewport(CPU* cpu) {
     pBoxedInfo->pvkCmdSetViewport(commandBuffer, firstViewport, viewportCount, pViewports);
 }
 void vk_CmdSetScissor(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t firstScissor = (uint32_t)ARG2;
@@ -5408,12 +5534,14 @@ void vk_CmdSetScissor(CPU* cpu) {
     pBoxedInfo->pvkCmdSetScissor(commandBuffer, firstScissor, scissorCount, pScissors);
 }
 void vk_CmdSetLineWidth(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     float lineWidth = (float)ARG2;
     pBoxedInfo->pvkCmdSetLineWidth(commandBuffer, lineWidth);
 }
 void vk_CmdSetDepthBias(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     float depthBiasConstantFactor = (float)ARG2;
@@ -5422,12 +5550,14 @@ void vk_CmdSetDepthBias(CPU* cpu) {
     pBoxedInfo->pvkCmdSetDepthBias(commandBuffer, depthBiasConstantFactor, depthBiasClamp, depthBiasSlopeFactor);
 }
 void vk_CmdSetBlendConstants(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     float* blendConstants = (float*)getPhysicalAddress(ARG2, 16);
     pBoxedInfo->pvkCmdSetBlendConstants(commandBuffer, blendConstants);
 }
 void vk_CmdSetDepthBounds(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     float minDepthBounds = (float)ARG2;
@@ -5435,6 +5565,7 @@ void vk_CmdSetDepthBounds(CPU* cpu) {
     pBoxedInfo->pvkCmdSetDepthBounds(commandBuffer, minDepthBounds, maxDepthBounds);
 }
 void vk_CmdSetStencilCompareMask(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkStencilFaceFlags faceMask = (VkStencilFaceFlags)ARG2;
@@ -5442,6 +5573,7 @@ void vk_CmdSetStencilCompareMask(CPU* cpu) {
     pBoxedInfo->pvkCmdSetStencilCompareMask(commandBuffer, faceMask, compareMask);
 }
 void vk_CmdSetStencilWriteMask(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkStencilFaceFlags faceMask = (VkStencilFaceFlags)ARG2;
@@ -5449,6 +5581,7 @@ void vk_CmdSetStencilWriteMask(CPU* cpu) {
     pBoxedInfo->pvkCmdSetStencilWriteMask(commandBuffer, faceMask, writeMask);
 }
 void vk_CmdSetStencilReference(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkStencilFaceFlags faceMask = (VkStencilFaceFlags)ARG2;
@@ -5456,6 +5589,7 @@ void vk_CmdSetStencilReference(CPU* cpu) {
     pBoxedInfo->pvkCmdSetStencilReference(commandBuffer, faceMask, reference);
 }
 void vk_CmdBindDescriptorSets(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineBindPoint pipelineBindPoint = (VkPipelineBindPoint)ARG2;
@@ -5468,6 +5602,7 @@ void vk_CmdBindDescriptorSets(CPU* cpu) {
     pBoxedInfo->pvkCmdBindDescriptorSets(commandBuffer, pipelineBindPoint, layout, firstSet, descriptorSetCount, pDescriptorSets, dynamicOffsetCount, pDynamicOffsets);
 }
 void vk_CmdBindIndexBuffer(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -5476,6 +5611,7 @@ void vk_CmdBindIndexBuffer(CPU* cpu) {
     pBoxedInfo->pvkCmdBindIndexBuffer(commandBuffer, buffer, offset, indexType);
 }
 void vk_CmdBindVertexBuffers(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t firstBinding = (uint32_t)ARG2;
@@ -5485,6 +5621,7 @@ void vk_CmdBindVertexBuffers(CPU* cpu) {
     pBoxedInfo->pvkCmdBindVertexBuffers(commandBuffer, firstBinding, bindingCount, pBuffers, pOffsets);
 }
 void vk_CmdDraw(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t vertexCount = (uint32_t)ARG2;
@@ -5494,6 +5631,7 @@ void vk_CmdDraw(CPU* cpu) {
     pBoxedInfo->pvkCmdDraw(commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
 }
 void vk_CmdDrawIndexed(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t indexCount = (uint32_t)ARG2;
@@ -5504,6 +5642,7 @@ void vk_CmdDrawIndexed(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
 }
 void vk_CmdDrawMultiEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t drawCount = (uint32_t)ARG2;
@@ -5514,6 +5653,7 @@ void vk_CmdDrawMultiEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawMultiEXT(commandBuffer, drawCount, pVertexInfo, instanceCount, firstInstance, stride);
 }
 void vk_CmdDrawMultiIndexedEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t drawCount = (uint32_t)ARG2;
@@ -5525,6 +5665,7 @@ void vk_CmdDrawMultiIndexedEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawMultiIndexedEXT(commandBuffer, drawCount, pIndexInfo, instanceCount, firstInstance, stride, pVertexOffset);
 }
 void vk_CmdDrawIndirect(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -5534,6 +5675,7 @@ void vk_CmdDrawIndirect(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawIndirect(commandBuffer, buffer, offset, drawCount, stride);
 }
 void vk_CmdDrawIndexedIndirect(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -5543,6 +5685,7 @@ void vk_CmdDrawIndexedIndirect(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawIndexedIndirect(commandBuffer, buffer, offset, drawCount, stride);
 }
 void vk_CmdDispatch(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t groupCountX = (uint32_t)ARG2;
@@ -5551,6 +5694,7 @@ void vk_CmdDispatch(CPU* cpu) {
     pBoxedInfo->pvkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
 }
 void vk_CmdDispatchIndirect(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -5558,11 +5702,13 @@ void vk_CmdDispatchIndirect(CPU* cpu) {
     pBoxedInfo->pvkCmdDispatchIndirect(commandBuffer, buffer, offset);
 }
 void vk_CmdSubpassShadingHUAWEI(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     pBoxedInfo->pvkCmdSubpassShadingHUAWEI(commandBuffer);
 }
 void vk_CmdCopyBuffer(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer srcBuffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -5572,6 +5718,7 @@ void vk_CmdCopyBuffer(CPU* cpu) {
     pBoxedInfo->pvkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, regionCount, pRegions);
 }
 void vk_CmdCopyImage(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImage srcImage = *(VkImage*)getPhysicalAddress(ARG2, 8);
@@ -5583,6 +5730,7 @@ void vk_CmdCopyImage(CPU* cpu) {
     pBoxedInfo->pvkCmdCopyImage(commandBuffer, srcImage, srcImageLayout, dstImage, dstImageLayout, regionCount, pRegions);
 }
 void vk_CmdBlitImage(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImage srcImage = *(VkImage*)getPhysicalAddress(ARG2, 8);
@@ -5595,6 +5743,7 @@ void vk_CmdBlitImage(CPU* cpu) {
     pBoxedInfo->pvkCmdBlitImage(commandBuffer, srcImage, srcImageLayout, dstImage, dstImageLayout, regionCount, pRegions, filter);
 }
 void vk_CmdCopyBufferToImage(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer srcBuffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -5605,6 +5754,7 @@ void vk_CmdCopyBufferToImage(CPU* cpu) {
     pBoxedInfo->pvkCmdCopyBufferToImage(commandBuffer, srcBuffer, dstImage, dstImageLayout, regionCount, pRegions);
 }
 void vk_CmdCopyImageToBuffer(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImage srcImage = *(VkImage*)getPhysicalAddress(ARG2, 8);
@@ -5615,6 +5765,7 @@ void vk_CmdCopyImageToBuffer(CPU* cpu) {
     pBoxedInfo->pvkCmdCopyImageToBuffer(commandBuffer, srcImage, srcImageLayout, dstBuffer, regionCount, pRegions);
 }
 void vk_CmdUpdateBuffer(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer dstBuffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -5624,6 +5775,7 @@ void vk_CmdUpdateBuffer(CPU* cpu) {
     pBoxedInfo->pvkCmdUpdateBuffer(commandBuffer, dstBuffer, dstOffset, dataSize, pData);
 }
 void vk_CmdFillBuffer(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer dstBuffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -5633,6 +5785,7 @@ void vk_CmdFillBuffer(CPU* cpu) {
     pBoxedInfo->pvkCmdFillBuffer(commandBuffer, dstBuffer, dstOffset, size, data);
 }
 void vk_CmdClearColorImage(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImage image = *(VkImage*)getPhysicalAddress(ARG2, 8);
@@ -5643,6 +5796,7 @@ void vk_CmdClearColorImage(CPU* cpu) {
     pBoxedInfo->pvkCmdClearColorImage(commandBuffer, image, imageLayout, pColor, rangeCount, pRanges);
 }
 void vk_CmdClearDepthStencilImage(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImage image = *(VkImage*)getPhysicalAddress(ARG2, 8);
@@ -5653,6 +5807,7 @@ void vk_CmdClearDepthStencilImage(CPU* cpu) {
     pBoxedInfo->pvkCmdClearDepthStencilImage(commandBuffer, image, imageLayout, pDepthStencil, rangeCount, pRanges);
 }
 void vk_CmdClearAttachments(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t attachmentCount = (uint32_t)ARG2;
@@ -5662,6 +5817,7 @@ void vk_CmdClearAttachments(CPU* cpu) {
     pBoxedInfo->pvkCmdClearAttachments(commandBuffer, attachmentCount, pAttachments, rectCount, pRects);
 }
 void vk_CmdResolveImage(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImage srcImage = *(VkImage*)getPhysicalAddress(ARG2, 8);
@@ -5673,6 +5829,7 @@ void vk_CmdResolveImage(CPU* cpu) {
     pBoxedInfo->pvkCmdResolveImage(commandBuffer, srcImage, srcImageLayout, dstImage, dstImageLayout, regionCount, pRegions);
 }
 void vk_CmdSetEvent(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkEvent event = *(VkEvent*)getPhysicalAddress(ARG2, 8);
@@ -5680,6 +5837,7 @@ void vk_CmdSetEvent(CPU* cpu) {
     pBoxedInfo->pvkCmdSetEvent(commandBuffer, event, stageMask);
 }
 void vk_CmdResetEvent(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkEvent event = *(VkEvent*)getPhysicalAddress(ARG2, 8);
@@ -5687,6 +5845,7 @@ void vk_CmdResetEvent(CPU* cpu) {
     pBoxedInfo->pvkCmdResetEvent(commandBuffer, event, stageMask);
 }
 void vk_CmdWaitEvents(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t eventCount = (uint32_t)ARG2;
@@ -5696,7 +5855,7 @@ void vk_CmdWaitEvents(CPU* cpu) {
     uint32_t memoryBarrierCount = (uint32_t)ARG6;
     VkMemoryBarrier* pMemoryBarriers = NULL;
     if (ARG7) {
-        pMemoryBarriers = new VkMemoryBarrier[memoryBarrierCount];
+        pMemoryBarriers = vulkanAlloc<VkMemoryBarrier>(memoryBarrierCount);
         for (U32 i=0;i<memoryBarrierCount;i++) {
             MarshalVkMemoryBarrier::read(ARG7 + i * 16, &pMemoryBarriers[i]);
         }
@@ -5704,7 +5863,7 @@ void vk_CmdWaitEvents(CPU* cpu) {
     uint32_t bufferMemoryBarrierCount = (uint32_t)ARG8;
     VkBufferMemoryBarrier* pBufferMemoryBarriers = NULL;
     if (ARG9) {
-        pBufferMemoryBarriers = new VkBufferMemoryBarrier[bufferMemoryBarrierCount];
+        pBufferMemoryBarriers = vulkanAlloc<VkBufferMemoryBarrier>(bufferMemoryBarrierCount);
         for (U32 i=0;i<bufferMemoryBarrierCount;i++) {
             MarshalVkBufferMemoryBarrier::read(ARG9 + i * 48, &pBufferMemoryBarriers[i]);
         }
@@ -5712,23 +5871,15 @@ void vk_CmdWaitEvents(CPU* cpu) {
     uint32_t imageMemoryBarrierCount = (uint32_t)ARG10;
     VkImageMemoryBarrier* pImageMemoryBarriers = NULL;
     if (ARG11) {
-        pImageMemoryBarriers = new VkImageMemoryBarrier[imageMemoryBarrierCount];
+        pImageMemoryBarriers = vulkanAlloc<VkImageMemoryBarrier>(imageMemoryBarrierCount);
         for (U32 i=0;i<imageMemoryBarrierCount;i++) {
             MarshalVkImageMemoryBarrier::read(ARG11 + i * 60, &pImageMemoryBarriers[i]);
         }
     }
     pBoxedInfo->pvkCmdWaitEvents(commandBuffer, eventCount, pEvents, srcStageMask, dstStageMask, memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount, pBufferMemoryBarriers, imageMemoryBarrierCount, pImageMemoryBarriers);
-    if (pMemoryBarriers) {
-        delete[] pMemoryBarriers;
-    }
-    if (pBufferMemoryBarriers) {
-        delete[] pBufferMemoryBarriers;
-    }
-    if (pImageMemoryBarriers) {
-        delete[] pImageMemoryBarriers;
-    }
 }
 void vk_CmdPipelineBarrier(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineStageFlags srcStageMask = (VkPipelineStageFlags)ARG2;
@@ -5737,7 +5888,7 @@ void vk_CmdPipelineBarrier(CPU* cpu) {
     uint32_t memoryBarrierCount = (uint32_t)ARG5;
     VkMemoryBarrier* pMemoryBarriers = NULL;
     if (ARG6) {
-        pMemoryBarriers = new VkMemoryBarrier[memoryBarrierCount];
+        pMemoryBarriers = vulkanAlloc<VkMemoryBarrier>(memoryBarrierCount);
         for (U32 i=0;i<memoryBarrierCount;i++) {
             MarshalVkMemoryBarrier::read(ARG6 + i * 16, &pMemoryBarriers[i]);
         }
@@ -5745,7 +5896,7 @@ void vk_CmdPipelineBarrier(CPU* cpu) {
     uint32_t bufferMemoryBarrierCount = (uint32_t)ARG7;
     VkBufferMemoryBarrier* pBufferMemoryBarriers = NULL;
     if (ARG8) {
-        pBufferMemoryBarriers = new VkBufferMemoryBarrier[bufferMemoryBarrierCount];
+        pBufferMemoryBarriers = vulkanAlloc<VkBufferMemoryBarrier>(bufferMemoryBarrierCount);
         for (U32 i=0;i<bufferMemoryBarrierCount;i++) {
             MarshalVkBufferMemoryBarrier::read(ARG8 + i * 48, &pBufferMemoryBarriers[i]);
         }
@@ -5753,23 +5904,15 @@ void vk_CmdPipelineBarrier(CPU* cpu) {
     uint32_t imageMemoryBarrierCount = (uint32_t)ARG9;
     VkImageMemoryBarrier* pImageMemoryBarriers = NULL;
     if (ARG10) {
-        pImageMemoryBarriers = new VkImageMemoryBarrier[imageMemoryBarrierCount];
+        pImageMemoryBarriers = vulkanAlloc<VkImageMemoryBarrier>(imageMemoryBarrierCount);
         for (U32 i=0;i<imageMemoryBarrierCount;i++) {
             MarshalVkImageMemoryBarrier::read(ARG10 + i * 60, &pImageMemoryBarriers[i]);
         }
     }
     pBoxedInfo->pvkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, dependencyFlags, memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount, pBufferMemoryBarriers, imageMemoryBarrierCount, pImageMemoryBarriers);
-    if (pMemoryBarriers) {
-        delete[] pMemoryBarriers;
-    }
-    if (pBufferMemoryBarriers) {
-        delete[] pBufferMemoryBarriers;
-    }
-    if (pImageMemoryBarriers) {
-        delete[] pImageMemoryBarriers;
-    }
 }
 void vk_CmdBeginQuery(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkQueryPool queryPool = *(VkQueryPool*)getPhysicalAddress(ARG2, 8);
@@ -5778,6 +5921,7 @@ void vk_CmdBeginQuery(CPU* cpu) {
     pBoxedInfo->pvkCmdBeginQuery(commandBuffer, queryPool, query, flags);
 }
 void vk_CmdEndQuery(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkQueryPool queryPool = *(VkQueryPool*)getPhysicalAddress(ARG2, 8);
@@ -5785,6 +5929,7 @@ void vk_CmdEndQuery(CPU* cpu) {
     pBoxedInfo->pvkCmdEndQuery(commandBuffer, queryPool, query);
 }
 void vk_CmdBeginConditionalRenderingEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkConditionalRenderingBeginInfoEXT local_pConditionalRenderingBegin(ARG2);
@@ -5792,11 +5937,13 @@ void vk_CmdBeginConditionalRenderingEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdBeginConditionalRenderingEXT(commandBuffer, pConditionalRenderingBegin);
 }
 void vk_CmdEndConditionalRenderingEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     pBoxedInfo->pvkCmdEndConditionalRenderingEXT(commandBuffer);
 }
 void vk_CmdResetQueryPool(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkQueryPool queryPool = *(VkQueryPool*)getPhysicalAddress(ARG2, 8);
@@ -5805,6 +5952,7 @@ void vk_CmdResetQueryPool(CPU* cpu) {
     pBoxedInfo->pvkCmdResetQueryPool(commandBuffer, queryPool, firstQuery, queryCount);
 }
 void vk_CmdWriteTimestamp(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineStageFlagBits pipelineStage = (VkPipelineStageFlagBits)ARG2;
@@ -5813,6 +5961,7 @@ void vk_CmdWriteTimestamp(CPU* cpu) {
     pBoxedInfo->pvkCmdWriteTimestamp(commandBuffer, pipelineStage, queryPool, query);
 }
 void vk_CmdCopyQueryPoolResults(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkQueryPool queryPool = *(VkQueryPool*)getPhysicalAddress(ARG2, 8);
@@ -5825,6 +5974,7 @@ void vk_CmdCopyQueryPoolResults(CPU* cpu) {
     pBoxedInfo->pvkCmdCopyQueryPoolResults(commandBuffer, queryPool, firstQuery, queryCount, dstBuffer, dstOffset, stride, flags);
 }
 void vk_CmdPushConstants(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineLayout layout = *(VkPipelineLayout*)getPhysicalAddress(ARG2, 8);
@@ -5835,6 +5985,7 @@ void vk_CmdPushConstants(CPU* cpu) {
     pBoxedInfo->pvkCmdPushConstants(commandBuffer, layout, stageFlags, offset, size, pValues);
 }
 void vk_CmdBeginRenderPass(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkRenderPassBeginInfo local_pRenderPassBegin(ARG2);
@@ -5843,28 +5994,31 @@ void vk_CmdBeginRenderPass(CPU* cpu) {
     pBoxedInfo->pvkCmdBeginRenderPass(commandBuffer, pRenderPassBegin, contents);
 }
 void vk_CmdNextSubpass(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSubpassContents contents = (VkSubpassContents)ARG2;
     pBoxedInfo->pvkCmdNextSubpass(commandBuffer, contents);
 }
 void vk_CmdEndRenderPass(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     pBoxedInfo->pvkCmdEndRenderPass(commandBuffer);
 }
 void vk_CmdExecuteCommands(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t commandBufferCount = (uint32_t)ARG2;
-    VkCommandBuffer* pCommandBuffers = new VkCommandBuffer[commandBufferCount];
+    VkCommandBuffer* pCommandBuffers = vulkanAlloc<VkCommandBuffer>(commandBufferCount);
     for (U32 i=0;i<commandBufferCount;i++) {
         pCommandBuffers[i] = (VkCommandBuffer)getVulkanPtr(readd(ARG3 + i*4));
     }
     pBoxedInfo->pvkCmdExecuteCommands(commandBuffer, commandBufferCount, pCommandBuffers);
-    delete[] pCommandBuffers;
 }
 void vk_DestroySurfaceKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkInstance instance = (VkInstance)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSurfaceKHR surface = *(VkSurfaceKHR*)getPhysicalAddress(ARG2, 8);
@@ -5874,6 +6028,7 @@ void vk_DestroySurfaceKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceSurfaceSupportKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t queueFamilyIndex = (uint32_t)ARG2;
@@ -5883,6 +6038,7 @@ void vk_GetPhysicalDeviceSurfaceSupportKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceSurfaceCapabilitiesKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSurfaceKHR surface = *(VkSurfaceKHR*)getPhysicalAddress(ARG2, 8);
@@ -5892,24 +6048,25 @@ void vk_GetPhysicalDeviceSurfaceCapabilitiesKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceSurfaceFormatsKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSurfaceKHR surface = *(VkSurfaceKHR*)getPhysicalAddress(ARG2, 8);
     uint32_t* pSurfaceFormatCount = (uint32_t*)getPhysicalAddress(ARG3, 4);
     VkSurfaceFormatKHR* pSurfaceFormats = NULL;
     if (ARG4) {
-        pSurfaceFormats = new VkSurfaceFormatKHR[*pSurfaceFormatCount];
+        pSurfaceFormats = vulkanAlloc<VkSurfaceFormatKHR>(*pSurfaceFormatCount);
     }
     EAX = pBoxedInfo->pvkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, pSurfaceFormatCount, pSurfaceFormats);
     if (ARG4) {
         for (U32 i=0;i<*pSurfaceFormatCount;i++) {
             MarshalVkSurfaceFormatKHR::write(ARG4 + i * 8, &pSurfaceFormats[i]);
         }
-        delete[] pSurfaceFormats;
     }
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceSurfacePresentModesKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSurfaceKHR surface = *(VkSurfaceKHR*)getPhysicalAddress(ARG2, 8);
@@ -5920,6 +6077,7 @@ void vk_GetPhysicalDeviceSurfacePresentModesKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateSwapchainKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSwapchainCreateInfoKHR local_pCreateInfo(ARG2);
@@ -5930,6 +6088,7 @@ void vk_CreateSwapchainKHR(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateSwapchainKHR(device, pCreateInfo, pAllocator, pSwapchain);
 }
 void vk_DestroySwapchainKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSwapchainKHR swapchain = *(VkSwapchainKHR*)getPhysicalAddress(ARG2, 8);
@@ -5939,6 +6098,7 @@ void vk_DestroySwapchainKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetSwapchainImagesKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSwapchainKHR swapchain = *(VkSwapchainKHR*)getPhysicalAddress(ARG2, 8);
@@ -5948,6 +6108,7 @@ void vk_GetSwapchainImagesKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_AcquireNextImageKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSwapchainKHR swapchain = *(VkSwapchainKHR*)getPhysicalAddress(ARG2, 8);
@@ -5959,6 +6120,7 @@ void vk_AcquireNextImageKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_QueuePresentKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkQueue queue = (VkQueue)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPresentInfoKHR local_pPresentInfo(ARG2);
@@ -5966,6 +6128,7 @@ void vk_QueuePresentKHR(CPU* cpu) {
     EAX = pBoxedInfo->pvkQueuePresentKHR(queue, pPresentInfo);
 }
 void vk_CmdExecuteGeneratedCommandsNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBool32 isPreprocessed = (VkBool32)ARG2;
@@ -5974,6 +6137,7 @@ void vk_CmdExecuteGeneratedCommandsNV(CPU* cpu) {
     pBoxedInfo->pvkCmdExecuteGeneratedCommandsNV(commandBuffer, isPreprocessed, pGeneratedCommandsInfo);
 }
 void vk_CmdPreprocessGeneratedCommandsNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkGeneratedCommandsInfoNV local_pGeneratedCommandsInfo(ARG2);
@@ -5981,6 +6145,7 @@ void vk_CmdPreprocessGeneratedCommandsNV(CPU* cpu) {
     pBoxedInfo->pvkCmdPreprocessGeneratedCommandsNV(commandBuffer, pGeneratedCommandsInfo);
 }
 void vk_CmdBindPipelineShaderGroupNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineBindPoint pipelineBindPoint = (VkPipelineBindPoint)ARG2;
@@ -5989,6 +6154,7 @@ void vk_CmdBindPipelineShaderGroupNV(CPU* cpu) {
     pBoxedInfo->pvkCmdBindPipelineShaderGroupNV(commandBuffer, pipelineBindPoint, pipeline, groupIndex);
 }
 void vk_GetGeneratedCommandsMemoryRequirementsNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkGeneratedCommandsMemoryRequirementsInfoNV local_pInfo(ARG2);
@@ -5999,6 +6165,7 @@ void vk_GetGeneratedCommandsMemoryRequirementsNV(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateIndirectCommandsLayoutNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkIndirectCommandsLayoutCreateInfoNV local_pCreateInfo(ARG2);
@@ -6009,6 +6176,7 @@ void vk_CreateIndirectCommandsLayoutNV(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateIndirectCommandsLayoutNV(device, pCreateInfo, pAllocator, pIndirectCommandsLayout);
 }
 void vk_DestroyIndirectCommandsLayoutNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkIndirectCommandsLayoutNV indirectCommandsLayout = *(VkIndirectCommandsLayoutNV*)getPhysicalAddress(ARG2, 8);
@@ -6017,6 +6185,7 @@ void vk_DestroyIndirectCommandsLayoutNV(CPU* cpu) {
     pBoxedInfo->pvkDestroyIndirectCommandsLayoutNV(device, indirectCommandsLayout, pAllocator);
 }
 void vk_GetPhysicalDeviceFeatures2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceFeatures2 pFeatures(ARG2);
@@ -6024,6 +6193,7 @@ void vk_GetPhysicalDeviceFeatures2(CPU* cpu) {
     MarshalVkPhysicalDeviceFeatures2::write(ARG2, &pFeatures.s);
 }
 void vk_GetPhysicalDeviceFeatures2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceFeatures2 pFeatures(ARG2);
@@ -6031,6 +6201,7 @@ void vk_GetPhysicalDeviceFeatures2KHR(CPU* cpu) {
     MarshalVkPhysicalDeviceFeatures2::write(ARG2, &pFeatures.s);
 }
 void vk_GetPhysicalDeviceProperties2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceProperties2 pProperties(ARG2);
@@ -6038,6 +6209,7 @@ void vk_GetPhysicalDeviceProperties2(CPU* cpu) {
     MarshalVkPhysicalDeviceProperties2::write(ARG2, &pProperties.s);
 }
 void vk_GetPhysicalDeviceProperties2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceProperties2 pProperties(ARG2);
@@ -6045,6 +6217,7 @@ void vk_GetPhysicalDeviceProperties2KHR(CPU* cpu) {
     MarshalVkPhysicalDeviceProperties2::write(ARG2, &pProperties.s);
 }
 void vk_GetPhysicalDeviceFormatProperties2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkFormat format = (VkFormat)ARG2;
@@ -6053,6 +6226,7 @@ void vk_GetPhysicalDeviceFormatProperties2(CPU* cpu) {
     MarshalVkFormatProperties2::write(ARG3, &pFormatProperties.s);
 }
 void vk_GetPhysicalDeviceFormatProperties2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkFormat format = (VkFormat)ARG2;
@@ -6062,6 +6236,7 @@ void vk_GetPhysicalDeviceFormatProperties2KHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceImageFormatProperties2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceImageFormatInfo2 local_pImageFormatInfo(ARG2);
@@ -6072,6 +6247,7 @@ void vk_GetPhysicalDeviceImageFormatProperties2(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceImageFormatProperties2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceImageFormatInfo2 local_pImageFormatInfo(ARG2);
@@ -6081,38 +6257,39 @@ void vk_GetPhysicalDeviceImageFormatProperties2KHR(CPU* cpu) {
     MarshalVkImageFormatProperties2::write(ARG3, &pImageFormatProperties.s);
 }
 void vk_GetPhysicalDeviceQueueFamilyProperties2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pQueueFamilyPropertyCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
     VkQueueFamilyProperties2* pQueueFamilyProperties = NULL;
     if (ARG3) {
-        pQueueFamilyProperties = new VkQueueFamilyProperties2[*pQueueFamilyPropertyCount];
+        pQueueFamilyProperties = vulkanAlloc<VkQueueFamilyProperties2>(*pQueueFamilyPropertyCount);
     }
     pBoxedInfo->pvkGetPhysicalDeviceQueueFamilyProperties2(physicalDevice, pQueueFamilyPropertyCount, pQueueFamilyProperties);
     if (ARG3) {
         for (U32 i=0;i<*pQueueFamilyPropertyCount;i++) {
             MarshalVkQueueFamilyProperties2::write(ARG3 + i * 32, &pQueueFamilyProperties[i]);
         }
-        delete[] pQueueFamilyProperties;
     }
 }
 void vk_GetPhysicalDeviceQueueFamilyProperties2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pQueueFamilyPropertyCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
     VkQueueFamilyProperties2* pQueueFamilyProperties = NULL;
     if (ARG3) {
-        pQueueFamilyProperties = new VkQueueFamilyProperties2[*pQueueFamilyPropertyCount];
+        pQueueFamilyProperties = vulkanAlloc<VkQueueFamilyProperties2>(*pQueueFamilyPropertyCount);
     }
     pBoxedInfo->pvkGetPhysicalDeviceQueueFamilyProperties2KHR(physicalDevice, pQueueFamilyPropertyCount, pQueueFamilyProperties);
     if (ARG3) {
         for (U32 i=0;i<*pQueueFamilyPropertyCount;i++) {
             MarshalVkQueueFamilyProperties2::write(ARG3 + i * 32, &pQueueFamilyProperties[i]);
         }
-        delete[] pQueueFamilyProperties;
     }
 }
 void vk_GetPhysicalDeviceMemoryProperties2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceMemoryProperties2 pMemoryProperties(ARG2);
@@ -6120,6 +6297,7 @@ void vk_GetPhysicalDeviceMemoryProperties2(CPU* cpu) {
     MarshalVkPhysicalDeviceMemoryProperties2::write(ARG2, &pMemoryProperties.s);
 }
 void vk_GetPhysicalDeviceMemoryProperties2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceMemoryProperties2 pMemoryProperties(ARG2);
@@ -6127,6 +6305,7 @@ void vk_GetPhysicalDeviceMemoryProperties2KHR(CPU* cpu) {
     MarshalVkPhysicalDeviceMemoryProperties2::write(ARG2, &pMemoryProperties.s);
 }
 void vk_GetPhysicalDeviceSparseImageFormatProperties2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceSparseImageFormatInfo2 local_pFormatInfo(ARG2);
@@ -6134,17 +6313,17 @@ void vk_GetPhysicalDeviceSparseImageFormatProperties2(CPU* cpu) {
     uint32_t* pPropertyCount = (uint32_t*)getPhysicalAddress(ARG3, 4);
     VkSparseImageFormatProperties2* pProperties = NULL;
     if (ARG4) {
-        pProperties = new VkSparseImageFormatProperties2[*pPropertyCount];
+        pProperties = vulkanAlloc<VkSparseImageFormatProperties2>(*pPropertyCount);
     }
     pBoxedInfo->pvkGetPhysicalDeviceSparseImageFormatProperties2(physicalDevice, pFormatInfo, pPropertyCount, pProperties);
     if (ARG4) {
         for (U32 i=0;i<*pPropertyCount;i++) {
             MarshalVkSparseImageFormatProperties2::write(ARG4 + i * 28, &pProperties[i]);
         }
-        delete[] pProperties;
     }
 }
 void vk_GetPhysicalDeviceSparseImageFormatProperties2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceSparseImageFormatInfo2 local_pFormatInfo(ARG2);
@@ -6152,17 +6331,17 @@ void vk_GetPhysicalDeviceSparseImageFormatProperties2KHR(CPU* cpu) {
     uint32_t* pPropertyCount = (uint32_t*)getPhysicalAddress(ARG3, 4);
     VkSparseImageFormatProperties2* pProperties = NULL;
     if (ARG4) {
-        pProperties = new VkSparseImageFormatProperties2[*pPropertyCount];
+        pProperties = vulkanAlloc<VkSparseImageFormatProperties2>(*pPropertyCount);
     }
     pBoxedInfo->pvkGetPhysicalDeviceSparseImageFormatProperties2KHR(physicalDevice, pFormatInfo, pPropertyCount, pProperties);
     if (ARG4) {
         for (U32 i=0;i<*pPropertyCount;i++) {
             MarshalVkSparseImageFormatProperties2::write(ARG4 + i * 28, &pProperties[i]);
         }
-        delete[] pProperties;
     }
 }
 void vk_CmdPushDescriptorSetKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineBindPoint pipelineBindPoint = (VkPipelineBindPoint)ARG2;
@@ -6171,17 +6350,15 @@ void vk_CmdPushDescriptorSetKHR(CPU* cpu) {
     uint32_t descriptorWriteCount = (uint32_t)ARG5;
     VkWriteDescriptorSet* pDescriptorWrites = NULL;
     if (ARG6) {
-        pDescriptorWrites = new VkWriteDescriptorSet[descriptorWriteCount];
+        pDescriptorWrites = vulkanAlloc<VkWriteDescriptorSet>(descriptorWriteCount);
         for (U32 i=0;i<descriptorWriteCount;i++) {
-            MarshalVkWriteDescriptorSet::read(ARG6 + i * 64, &pDescriptorWrites[i]);
+            MarshalVkWriteDescriptorSet::read(ARG6 + i * 44, &pDescriptorWrites[i]);
         }
     }
     pBoxedInfo->pvkCmdPushDescriptorSetKHR(commandBuffer, pipelineBindPoint, layout, set, descriptorWriteCount, pDescriptorWrites);
-    if (pDescriptorWrites) {
-        delete[] pDescriptorWrites;
-    }
 }
 void vk_TrimCommandPool(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkCommandPool commandPool = *(VkCommandPool*)getPhysicalAddress(ARG2, 8);
@@ -6189,6 +6366,7 @@ void vk_TrimCommandPool(CPU* cpu) {
     pBoxedInfo->pvkTrimCommandPool(device, commandPool, flags);
 }
 void vk_TrimCommandPoolKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkCommandPool commandPool = *(VkCommandPool*)getPhysicalAddress(ARG2, 8);
@@ -6196,6 +6374,7 @@ void vk_TrimCommandPoolKHR(CPU* cpu) {
     pBoxedInfo->pvkTrimCommandPoolKHR(device, commandPool, flags);
 }
 void vk_GetPhysicalDeviceExternalBufferProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceExternalBufferInfo local_pExternalBufferInfo(ARG2);
@@ -6205,6 +6384,7 @@ void vk_GetPhysicalDeviceExternalBufferProperties(CPU* cpu) {
     MarshalVkExternalBufferProperties::write(ARG3, &pExternalBufferProperties.s);
 }
 void vk_GetPhysicalDeviceExternalBufferPropertiesKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceExternalBufferInfo local_pExternalBufferInfo(ARG2);
@@ -6214,6 +6394,7 @@ void vk_GetPhysicalDeviceExternalBufferPropertiesKHR(CPU* cpu) {
     MarshalVkExternalBufferProperties::write(ARG3, &pExternalBufferProperties.s);
 }
 void vk_GetPhysicalDeviceExternalSemaphoreProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceExternalSemaphoreInfo local_pExternalSemaphoreInfo(ARG2);
@@ -6223,6 +6404,7 @@ void vk_GetPhysicalDeviceExternalSemaphoreProperties(CPU* cpu) {
     MarshalVkExternalSemaphoreProperties::write(ARG3, &pExternalSemaphoreProperties.s);
 }
 void vk_GetPhysicalDeviceExternalSemaphorePropertiesKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceExternalSemaphoreInfo local_pExternalSemaphoreInfo(ARG2);
@@ -6232,6 +6414,7 @@ void vk_GetPhysicalDeviceExternalSemaphorePropertiesKHR(CPU* cpu) {
     MarshalVkExternalSemaphoreProperties::write(ARG3, &pExternalSemaphoreProperties.s);
 }
 void vk_GetPhysicalDeviceExternalFenceProperties(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceExternalFenceInfo local_pExternalFenceInfo(ARG2);
@@ -6241,6 +6424,7 @@ void vk_GetPhysicalDeviceExternalFenceProperties(CPU* cpu) {
     MarshalVkExternalFenceProperties::write(ARG3, &pExternalFenceProperties.s);
 }
 void vk_GetPhysicalDeviceExternalFencePropertiesKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceExternalFenceInfo local_pExternalFenceInfo(ARG2);
@@ -6251,39 +6435,40 @@ void vk_GetPhysicalDeviceExternalFencePropertiesKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_EnumeratePhysicalDeviceGroups(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkInstance instance = (VkInstance)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pPhysicalDeviceGroupCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
     VkPhysicalDeviceGroupProperties* pPhysicalDeviceGroupProperties = NULL;
     if (ARG3) {
-        pPhysicalDeviceGroupProperties = new VkPhysicalDeviceGroupProperties[*pPhysicalDeviceGroupCount];
+        pPhysicalDeviceGroupProperties = vulkanAlloc<VkPhysicalDeviceGroupProperties>(*pPhysicalDeviceGroupCount);
     }
     EAX = pBoxedInfo->pvkEnumeratePhysicalDeviceGroups(instance, pPhysicalDeviceGroupCount, pPhysicalDeviceGroupProperties);
     if (ARG3) {
         for (U32 i=0;i<*pPhysicalDeviceGroupCount;i++) {
             MarshalVkPhysicalDeviceGroupProperties::write(ARG3 + i * 144, &pPhysicalDeviceGroupProperties[i]);
         }
-        delete[] pPhysicalDeviceGroupProperties;
     }
 }
 // return type: VkResult(4 bytes)
 void vk_EnumeratePhysicalDeviceGroupsKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkInstance instance = (VkInstance)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pPhysicalDeviceGroupCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
     VkPhysicalDeviceGroupProperties* pPhysicalDeviceGroupProperties = NULL;
     if (ARG3) {
-        pPhysicalDeviceGroupProperties = new VkPhysicalDeviceGroupProperties[*pPhysicalDeviceGroupCount];
+        pPhysicalDeviceGroupProperties = vulkanAlloc<VkPhysicalDeviceGroupProperties>(*pPhysicalDeviceGroupCount);
     }
     EAX = pBoxedInfo->pvkEnumeratePhysicalDeviceGroupsKHR(instance, pPhysicalDeviceGroupCount, pPhysicalDeviceGroupProperties);
     if (ARG3) {
         for (U32 i=0;i<*pPhysicalDeviceGroupCount;i++) {
             MarshalVkPhysicalDeviceGroupProperties::write(ARG3 + i * 144, &pPhysicalDeviceGroupProperties[i]);
         }
-        delete[] pPhysicalDeviceGroupProperties;
     }
 }
 void vk_GetDeviceGroupPeerMemoryFeatures(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t heapIndex = (uint32_t)ARG2;
@@ -6293,6 +6478,7 @@ void vk_GetDeviceGroupPeerMemoryFeatures(CPU* cpu) {
     pBoxedInfo->pvkGetDeviceGroupPeerMemoryFeatures(device, heapIndex, localDeviceIndex, remoteDeviceIndex, pPeerMemoryFeatures);
 }
 void vk_GetDeviceGroupPeerMemoryFeaturesKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t heapIndex = (uint32_t)ARG2;
@@ -6303,79 +6489,73 @@ void vk_GetDeviceGroupPeerMemoryFeaturesKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_BindBufferMemory2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t bindInfoCount = (uint32_t)ARG2;
     VkBindBufferMemoryInfo* pBindInfos = NULL;
     if (ARG3) {
-        pBindInfos = new VkBindBufferMemoryInfo[bindInfoCount];
+        pBindInfos = vulkanAlloc<VkBindBufferMemoryInfo>(bindInfoCount);
         for (U32 i=0;i<bindInfoCount;i++) {
             MarshalVkBindBufferMemoryInfo::read(ARG3 + i * 32, &pBindInfos[i]);
         }
     }
     EAX = pBoxedInfo->pvkBindBufferMemory2(device, bindInfoCount, pBindInfos);
-    if (pBindInfos) {
-        delete[] pBindInfos;
-    }
 }
 // return type: VkResult(4 bytes)
 void vk_BindBufferMemory2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t bindInfoCount = (uint32_t)ARG2;
     VkBindBufferMemoryInfo* pBindInfos = NULL;
     if (ARG3) {
-        pBindInfos = new VkBindBufferMemoryInfo[bindInfoCount];
+        pBindInfos = vulkanAlloc<VkBindBufferMemoryInfo>(bindInfoCount);
         for (U32 i=0;i<bindInfoCount;i++) {
             MarshalVkBindBufferMemoryInfo::read(ARG3 + i * 32, &pBindInfos[i]);
         }
     }
     EAX = pBoxedInfo->pvkBindBufferMemory2KHR(device, bindInfoCount, pBindInfos);
-    if (pBindInfos) {
-        delete[] pBindInfos;
-    }
 }
 // return type: VkResult(4 bytes)
 void vk_BindImageMemory2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t bindInfoCount = (uint32_t)ARG2;
     VkBindImageMemoryInfo* pBindInfos = NULL;
     if (ARG3) {
-        pBindInfos = new VkBindImageMemoryInfo[bindInfoCount];
+        pBindInfos = vulkanAlloc<VkBindImageMemoryInfo>(bindInfoCount);
         for (U32 i=0;i<bindInfoCount;i++) {
             MarshalVkBindImageMemoryInfo::read(ARG3 + i * 32, &pBindInfos[i]);
         }
     }
     EAX = pBoxedInfo->pvkBindImageMemory2(device, bindInfoCount, pBindInfos);
-    if (pBindInfos) {
-        delete[] pBindInfos;
-    }
 }
 // return type: VkResult(4 bytes)
 void vk_BindImageMemory2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t bindInfoCount = (uint32_t)ARG2;
     VkBindImageMemoryInfo* pBindInfos = NULL;
     if (ARG3) {
-        pBindInfos = new VkBindImageMemoryInfo[bindInfoCount];
+        pBindInfos = vulkanAlloc<VkBindImageMemoryInfo>(bindInfoCount);
         for (U32 i=0;i<bindInfoCount;i++) {
             MarshalVkBindImageMemoryInfo::read(ARG3 + i * 32, &pBindInfos[i]);
         }
     }
     EAX = pBoxedInfo->pvkBindImageMemory2KHR(device, bindInfoCount, pBindInfos);
-    if (pBindInfos) {
-        delete[] pBindInfos;
-    }
 }
 void vk_CmdSetDeviceMask(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t deviceMask = (uint32_t)ARG2;
     pBoxedInfo->pvkCmdSetDeviceMask(commandBuffer, deviceMask);
 }
 void vk_CmdSetDeviceMaskKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t deviceMask = (uint32_t)ARG2;
@@ -6383,6 +6563,7 @@ void vk_CmdSetDeviceMaskKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetDeviceGroupPresentCapabilitiesKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDeviceGroupPresentCapabilitiesKHR pDeviceGroupPresentCapabilities(ARG2);
@@ -6391,6 +6572,7 @@ void vk_GetDeviceGroupPresentCapabilitiesKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetDeviceGroupSurfacePresentModesKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSurfaceKHR surface = *(VkSurfaceKHR*)getPhysicalAddress(ARG2, 8);
@@ -6399,6 +6581,7 @@ void vk_GetDeviceGroupSurfacePresentModesKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_AcquireNextImage2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkAcquireNextImageInfoKHR local_pAcquireInfo(ARG2);
@@ -6407,6 +6590,7 @@ void vk_AcquireNextImage2KHR(CPU* cpu) {
     EAX = pBoxedInfo->pvkAcquireNextImage2KHR(device, pAcquireInfo, pImageIndex);
 }
 void vk_CmdDispatchBase(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t baseGroupX = (uint32_t)ARG2;
@@ -6418,6 +6602,7 @@ void vk_CmdDispatchBase(CPU* cpu) {
     pBoxedInfo->pvkCmdDispatchBase(commandBuffer, baseGroupX, baseGroupY, baseGroupZ, groupCountX, groupCountY, groupCountZ);
 }
 void vk_CmdDispatchBaseKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t baseGroupX = (uint32_t)ARG2;
@@ -6430,6 +6615,7 @@ void vk_CmdDispatchBaseKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDevicePresentRectanglesKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSurfaceKHR surface = *(VkSurfaceKHR*)getPhysicalAddress(ARG2, 8);
@@ -6439,6 +6625,7 @@ void vk_GetPhysicalDevicePresentRectanglesKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateDescriptorUpdateTemplate(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDescriptorUpdateTemplateCreateInfo local_pCreateInfo(ARG2);
@@ -6450,6 +6637,7 @@ void vk_CreateDescriptorUpdateTemplate(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateDescriptorUpdateTemplateKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDescriptorUpdateTemplateCreateInfo local_pCreateInfo(ARG2);
@@ -6460,6 +6648,7 @@ void vk_CreateDescriptorUpdateTemplateKHR(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateDescriptorUpdateTemplateKHR(device, pCreateInfo, pAllocator, pDescriptorUpdateTemplate);
 }
 void vk_DestroyDescriptorUpdateTemplate(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDescriptorUpdateTemplate descriptorUpdateTemplate = *(VkDescriptorUpdateTemplate*)getPhysicalAddress(ARG2, 8);
@@ -6468,6 +6657,7 @@ void vk_DestroyDescriptorUpdateTemplate(CPU* cpu) {
     pBoxedInfo->pvkDestroyDescriptorUpdateTemplate(device, descriptorUpdateTemplate, pAllocator);
 }
 void vk_DestroyDescriptorUpdateTemplateKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDescriptorUpdateTemplate descriptorUpdateTemplate = *(VkDescriptorUpdateTemplate*)getPhysicalAddress(ARG2, 8);
@@ -6476,6 +6666,7 @@ void vk_DestroyDescriptorUpdateTemplateKHR(CPU* cpu) {
     pBoxedInfo->pvkDestroyDescriptorUpdateTemplateKHR(device, descriptorUpdateTemplate, pAllocator);
 }
 void vk_UpdateDescriptorSetWithTemplate(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDescriptorSet descriptorSet = *(VkDescriptorSet*)getPhysicalAddress(ARG2, 8);
@@ -6484,6 +6675,7 @@ void vk_UpdateDescriptorSetWithTemplate(CPU* cpu) {
     pBoxedInfo->pvkUpdateDescriptorSetWithTemplate(device, descriptorSet, descriptorUpdateTemplate, pData);
 }
 void vk_UpdateDescriptorSetWithTemplateKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDescriptorSet descriptorSet = *(VkDescriptorSet*)getPhysicalAddress(ARG2, 8);
@@ -6492,6 +6684,7 @@ void vk_UpdateDescriptorSetWithTemplateKHR(CPU* cpu) {
     pBoxedInfo->pvkUpdateDescriptorSetWithTemplateKHR(device, descriptorSet, descriptorUpdateTemplate, pData);
 }
 void vk_CmdPushDescriptorSetWithTemplateKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDescriptorUpdateTemplate descriptorUpdateTemplate = *(VkDescriptorUpdateTemplate*)getPhysicalAddress(ARG2, 8);
@@ -6501,6 +6694,7 @@ void vk_CmdPushDescriptorSetWithTemplateKHR(CPU* cpu) {
     pBoxedInfo->pvkCmdPushDescriptorSetWithTemplateKHR(commandBuffer, descriptorUpdateTemplate, layout, set, pData);
 }
 void vk_CmdSetViewportWScalingNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t firstViewport = (uint32_t)ARG2;
@@ -6509,6 +6703,7 @@ void vk_CmdSetViewportWScalingNV(CPU* cpu) {
     pBoxedInfo->pvkCmdSetViewportWScalingNV(commandBuffer, firstViewport, viewportCount, pViewportWScalings);
 }
 void vk_CmdSetDiscardRectangleEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t firstDiscardRectangle = (uint32_t)ARG2;
@@ -6517,6 +6712,7 @@ void vk_CmdSetDiscardRectangleEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdSetDiscardRectangleEXT(commandBuffer, firstDiscardRectangle, discardRectangleCount, pDiscardRectangles);
 }
 void vk_CmdSetSampleLocationsEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSampleLocationsInfoEXT local_pSampleLocationsInfo(ARG2);
@@ -6524,6 +6720,7 @@ void vk_CmdSetSampleLocationsEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdSetSampleLocationsEXT(commandBuffer, pSampleLocationsInfo);
 }
 void vk_GetPhysicalDeviceMultisamplePropertiesEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSampleCountFlagBits samples = (VkSampleCountFlagBits)ARG2;
@@ -6533,6 +6730,7 @@ void vk_GetPhysicalDeviceMultisamplePropertiesEXT(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceSurfaceCapabilities2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceSurfaceInfo2KHR local_pSurfaceInfo(ARG2);
@@ -6543,6 +6741,7 @@ void vk_GetPhysicalDeviceSurfaceCapabilities2KHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceSurfaceFormats2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPhysicalDeviceSurfaceInfo2KHR local_pSurfaceInfo(ARG2);
@@ -6550,17 +6749,17 @@ void vk_GetPhysicalDeviceSurfaceFormats2KHR(CPU* cpu) {
     uint32_t* pSurfaceFormatCount = (uint32_t*)getPhysicalAddress(ARG3, 4);
     VkSurfaceFormat2KHR* pSurfaceFormats = NULL;
     if (ARG4) {
-        pSurfaceFormats = new VkSurfaceFormat2KHR[*pSurfaceFormatCount];
+        pSurfaceFormats = vulkanAlloc<VkSurfaceFormat2KHR>(*pSurfaceFormatCount);
     }
     EAX = pBoxedInfo->pvkGetPhysicalDeviceSurfaceFormats2KHR(physicalDevice, pSurfaceInfo, pSurfaceFormatCount, pSurfaceFormats);
     if (ARG4) {
         for (U32 i=0;i<*pSurfaceFormatCount;i++) {
             MarshalVkSurfaceFormat2KHR::write(ARG4 + i * 16, &pSurfaceFormats[i]);
         }
-        delete[] pSurfaceFormats;
     }
 }
 void vk_GetBufferMemoryRequirements2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkBufferMemoryRequirementsInfo2 local_pInfo(ARG2);
@@ -6570,6 +6769,7 @@ void vk_GetBufferMemoryRequirements2(CPU* cpu) {
     MarshalVkMemoryRequirements2::write(ARG3, &pMemoryRequirements.s);
 }
 void vk_GetBufferMemoryRequirements2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkBufferMemoryRequirementsInfo2 local_pInfo(ARG2);
@@ -6579,6 +6779,7 @@ void vk_GetBufferMemoryRequirements2KHR(CPU* cpu) {
     MarshalVkMemoryRequirements2::write(ARG3, &pMemoryRequirements.s);
 }
 void vk_GetImageMemoryRequirements2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkImageMemoryRequirementsInfo2 local_pInfo(ARG2);
@@ -6588,6 +6789,7 @@ void vk_GetImageMemoryRequirements2(CPU* cpu) {
     MarshalVkMemoryRequirements2::write(ARG3, &pMemoryRequirements.s);
 }
 void vk_GetImageMemoryRequirements2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkImageMemoryRequirementsInfo2 local_pInfo(ARG2);
@@ -6597,6 +6799,7 @@ void vk_GetImageMemoryRequirements2KHR(CPU* cpu) {
     MarshalVkMemoryRequirements2::write(ARG3, &pMemoryRequirements.s);
 }
 void vk_GetImageSparseMemoryRequirements2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkImageSparseMemoryRequirementsInfo2 local_pInfo(ARG2);
@@ -6604,17 +6807,17 @@ void vk_GetImageSparseMemoryRequirements2(CPU* cpu) {
     uint32_t* pSparseMemoryRequirementCount = (uint32_t*)getPhysicalAddress(ARG3, 4);
     VkSparseImageMemoryRequirements2* pSparseMemoryRequirements = NULL;
     if (ARG4) {
-        pSparseMemoryRequirements = new VkSparseImageMemoryRequirements2[*pSparseMemoryRequirementCount];
+        pSparseMemoryRequirements = vulkanAlloc<VkSparseImageMemoryRequirements2>(*pSparseMemoryRequirementCount);
     }
     pBoxedInfo->pvkGetImageSparseMemoryRequirements2(device, pInfo, pSparseMemoryRequirementCount, pSparseMemoryRequirements);
     if (ARG4) {
         for (U32 i=0;i<*pSparseMemoryRequirementCount;i++) {
             MarshalVkSparseImageMemoryRequirements2::write(ARG4 + i * 56, &pSparseMemoryRequirements[i]);
         }
-        delete[] pSparseMemoryRequirements;
     }
 }
 void vk_GetImageSparseMemoryRequirements2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkImageSparseMemoryRequirementsInfo2 local_pInfo(ARG2);
@@ -6622,18 +6825,18 @@ void vk_GetImageSparseMemoryRequirements2KHR(CPU* cpu) {
     uint32_t* pSparseMemoryRequirementCount = (uint32_t*)getPhysicalAddress(ARG3, 4);
     VkSparseImageMemoryRequirements2* pSparseMemoryRequirements = NULL;
     if (ARG4) {
-        pSparseMemoryRequirements = new VkSparseImageMemoryRequirements2[*pSparseMemoryRequirementCount];
+        pSparseMemoryRequirements = vulkanAlloc<VkSparseImageMemoryRequirements2>(*pSparseMemoryRequirementCount);
     }
     pBoxedInfo->pvkGetImageSparseMemoryRequirements2KHR(device, pInfo, pSparseMemoryRequirementCount, pSparseMemoryRequirements);
     if (ARG4) {
         for (U32 i=0;i<*pSparseMemoryRequirementCount;i++) {
             MarshalVkSparseImageMemoryRequirements2::write(ARG4 + i * 56, &pSparseMemoryRequirements[i]);
         }
-        delete[] pSparseMemoryRequirements;
     }
 }
 // return type: VkResult(4 bytes)
 void vk_CreateSamplerYcbcrConversion(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSamplerYcbcrConversionCreateInfo local_pCreateInfo(ARG2);
@@ -6645,6 +6848,7 @@ void vk_CreateSamplerYcbcrConversion(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateSamplerYcbcrConversionKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSamplerYcbcrConversionCreateInfo local_pCreateInfo(ARG2);
@@ -6655,6 +6859,7 @@ void vk_CreateSamplerYcbcrConversionKHR(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateSamplerYcbcrConversionKHR(device, pCreateInfo, pAllocator, pYcbcrConversion);
 }
 void vk_DestroySamplerYcbcrConversion(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSamplerYcbcrConversion ycbcrConversion = *(VkSamplerYcbcrConversion*)getPhysicalAddress(ARG2, 8);
@@ -6663,6 +6868,7 @@ void vk_DestroySamplerYcbcrConversion(CPU* cpu) {
     pBoxedInfo->pvkDestroySamplerYcbcrConversion(device, ycbcrConversion, pAllocator);
 }
 void vk_DestroySamplerYcbcrConversionKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSamplerYcbcrConversion ycbcrConversion = *(VkSamplerYcbcrConversion*)getPhysicalAddress(ARG2, 8);
@@ -6671,6 +6877,7 @@ void vk_DestroySamplerYcbcrConversionKHR(CPU* cpu) {
     pBoxedInfo->pvkDestroySamplerYcbcrConversionKHR(device, ycbcrConversion, pAllocator);
 }
 void vk_GetDeviceQueue2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDeviceQueueInfo2 local_pQueueInfo(ARG2);
@@ -6681,6 +6888,7 @@ void vk_GetDeviceQueue2(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateValidationCacheEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkValidationCacheCreateInfoEXT local_pCreateInfo(ARG2);
@@ -6691,6 +6899,7 @@ void vk_CreateValidationCacheEXT(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateValidationCacheEXT(device, pCreateInfo, pAllocator, pValidationCache);
 }
 void vk_DestroyValidationCacheEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkValidationCacheEXT validationCache = *(VkValidationCacheEXT*)getPhysicalAddress(ARG2, 8);
@@ -6700,6 +6909,7 @@ void vk_DestroyValidationCacheEXT(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetValidationCacheDataEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkValidationCacheEXT validationCache = *(VkValidationCacheEXT*)getPhysicalAddress(ARG2, 8);
@@ -6709,6 +6919,7 @@ void vk_GetValidationCacheDataEXT(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_MergeValidationCachesEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkValidationCacheEXT dstCache = *(VkValidationCacheEXT*)getPhysicalAddress(ARG2, 8);
@@ -6717,6 +6928,7 @@ void vk_MergeValidationCachesEXT(CPU* cpu) {
     EAX = pBoxedInfo->pvkMergeValidationCachesEXT(device, dstCache, srcCacheCount, pSrcCaches);
 }
 void vk_GetDescriptorSetLayoutSupport(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDescriptorSetLayoutCreateInfo local_pCreateInfo(ARG2);
@@ -6726,6 +6938,7 @@ void vk_GetDescriptorSetLayoutSupport(CPU* cpu) {
     MarshalVkDescriptorSetLayoutSupport::write(ARG3, &pSupport.s);
 }
 void vk_GetDescriptorSetLayoutSupportKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDescriptorSetLayoutCreateInfo local_pCreateInfo(ARG2);
@@ -6736,6 +6949,7 @@ void vk_GetDescriptorSetLayoutSupportKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetShaderInfoAMD(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipeline pipeline = *(VkPipeline*)getPhysicalAddress(ARG2, 8);
@@ -6747,6 +6961,7 @@ void vk_GetShaderInfoAMD(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceCalibrateableTimeDomainsEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pTimeDomainCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
@@ -6756,12 +6971,13 @@ void vk_GetPhysicalDeviceCalibrateableTimeDomainsEXT(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetCalibratedTimestampsEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t timestampCount = (uint32_t)ARG2;
     VkCalibratedTimestampInfoEXT* pTimestampInfos = NULL;
     if (ARG3) {
-        pTimestampInfos = new VkCalibratedTimestampInfoEXT[timestampCount];
+        pTimestampInfos = vulkanAlloc<VkCalibratedTimestampInfoEXT>(timestampCount);
         for (U32 i=0;i<timestampCount;i++) {
             MarshalVkCalibratedTimestampInfoEXT::read(ARG3 + i * 12, &pTimestampInfos[i]);
         }
@@ -6769,12 +6985,10 @@ void vk_GetCalibratedTimestampsEXT(CPU* cpu) {
     uint64_t* pTimestamps = (uint64_t*)getPhysicalAddress(ARG4, (U32)timestampCount * 4);
     uint64_t* pMaxDeviation = (uint64_t*)getPhysicalAddress(ARG5, 4);
     EAX = pBoxedInfo->pvkGetCalibratedTimestampsEXT(device, timestampCount, pTimestampInfos, pTimestamps, pMaxDeviation);
-    if (pTimestampInfos) {
-        delete[] pTimestampInfos;
-    }
 }
 // return type: VkResult(4 bytes)
 void vk_GetMemoryHostPointerPropertiesEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkExternalMemoryHandleTypeFlagBits handleType = (VkExternalMemoryHandleTypeFlagBits)ARG2;
@@ -6784,6 +6998,7 @@ void vk_GetMemoryHostPointerPropertiesEXT(CPU* cpu) {
     MarshalVkMemoryHostPointerPropertiesEXT::write(ARG4, &pMemoryHostPointerProperties.s);
 }
 void vk_CmdWriteBufferMarkerAMD(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineStageFlagBits pipelineStage = (VkPipelineStageFlagBits)ARG2;
@@ -6794,6 +7009,7 @@ void vk_CmdWriteBufferMarkerAMD(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateRenderPass2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkRenderPassCreateInfo2 local_pCreateInfo(ARG2);
@@ -6805,6 +7021,7 @@ void vk_CreateRenderPass2(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateRenderPass2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkRenderPassCreateInfo2 local_pCreateInfo(ARG2);
@@ -6815,6 +7032,7 @@ void vk_CreateRenderPass2KHR(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateRenderPass2KHR(device, pCreateInfo, pAllocator, pRenderPass);
 }
 void vk_CmdBeginRenderPass2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkRenderPassBeginInfo local_pRenderPassBegin(ARG2);
@@ -6824,6 +7042,7 @@ void vk_CmdBeginRenderPass2(CPU* cpu) {
     pBoxedInfo->pvkCmdBeginRenderPass2(commandBuffer, pRenderPassBegin, pSubpassBeginInfo);
 }
 void vk_CmdBeginRenderPass2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkRenderPassBeginInfo local_pRenderPassBegin(ARG2);
@@ -6833,6 +7052,7 @@ void vk_CmdBeginRenderPass2KHR(CPU* cpu) {
     pBoxedInfo->pvkCmdBeginRenderPass2KHR(commandBuffer, pRenderPassBegin, pSubpassBeginInfo);
 }
 void vk_CmdNextSubpass2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSubpassBeginInfo local_pSubpassBeginInfo(ARG2);
@@ -6842,6 +7062,7 @@ void vk_CmdNextSubpass2(CPU* cpu) {
     pBoxedInfo->pvkCmdNextSubpass2(commandBuffer, pSubpassBeginInfo, pSubpassEndInfo);
 }
 void vk_CmdNextSubpass2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSubpassBeginInfo local_pSubpassBeginInfo(ARG2);
@@ -6851,6 +7072,7 @@ void vk_CmdNextSubpass2KHR(CPU* cpu) {
     pBoxedInfo->pvkCmdNextSubpass2KHR(commandBuffer, pSubpassBeginInfo, pSubpassEndInfo);
 }
 void vk_CmdEndRenderPass2(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSubpassEndInfo local_pSubpassEndInfo(ARG2);
@@ -6858,6 +7080,7 @@ void vk_CmdEndRenderPass2(CPU* cpu) {
     pBoxedInfo->pvkCmdEndRenderPass2(commandBuffer, pSubpassEndInfo);
 }
 void vk_CmdEndRenderPass2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSubpassEndInfo local_pSubpassEndInfo(ARG2);
@@ -6866,6 +7089,7 @@ void vk_CmdEndRenderPass2KHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetSemaphoreCounterValue(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSemaphore semaphore = *(VkSemaphore*)getPhysicalAddress(ARG2, 8);
@@ -6874,6 +7098,7 @@ void vk_GetSemaphoreCounterValue(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetSemaphoreCounterValueKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkSemaphore semaphore = *(VkSemaphore*)getPhysicalAddress(ARG2, 8);
@@ -6882,6 +7107,7 @@ void vk_GetSemaphoreCounterValueKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_WaitSemaphores(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSemaphoreWaitInfo local_pWaitInfo(ARG2);
@@ -6891,6 +7117,7 @@ void vk_WaitSemaphores(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_WaitSemaphoresKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSemaphoreWaitInfo local_pWaitInfo(ARG2);
@@ -6900,6 +7127,7 @@ void vk_WaitSemaphoresKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_SignalSemaphore(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSemaphoreSignalInfo local_pSignalInfo(ARG2);
@@ -6908,6 +7136,7 @@ void vk_SignalSemaphore(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_SignalSemaphoreKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkSemaphoreSignalInfo local_pSignalInfo(ARG2);
@@ -6915,6 +7144,7 @@ void vk_SignalSemaphoreKHR(CPU* cpu) {
     EAX = pBoxedInfo->pvkSignalSemaphoreKHR(device, pSignalInfo);
 }
 void vk_CmdDrawIndirectCount(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -6926,6 +7156,7 @@ void vk_CmdDrawIndirectCount(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawIndirectCount(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
 }
 void vk_CmdDrawIndirectCountKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -6937,6 +7168,7 @@ void vk_CmdDrawIndirectCountKHR(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawIndirectCountKHR(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
 }
 void vk_CmdDrawIndirectCountAMD(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -6948,6 +7180,7 @@ void vk_CmdDrawIndirectCountAMD(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawIndirectCountAMD(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
 }
 void vk_CmdDrawIndexedIndirectCount(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -6959,6 +7192,7 @@ void vk_CmdDrawIndexedIndirectCount(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawIndexedIndirectCount(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
 }
 void vk_CmdDrawIndexedIndirectCountKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -6970,6 +7204,7 @@ void vk_CmdDrawIndexedIndirectCountKHR(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawIndexedIndirectCountKHR(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
 }
 void vk_CmdDrawIndexedIndirectCountAMD(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -6981,6 +7216,7 @@ void vk_CmdDrawIndexedIndirectCountAMD(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawIndexedIndirectCountAMD(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
 }
 void vk_CmdBindTransformFeedbackBuffersEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t firstBinding = (uint32_t)ARG2;
@@ -6991,6 +7227,7 @@ void vk_CmdBindTransformFeedbackBuffersEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdBindTransformFeedbackBuffersEXT(commandBuffer, firstBinding, bindingCount, pBuffers, pOffsets, pSizes);
 }
 void vk_CmdBeginTransformFeedbackEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t firstCounterBuffer = (uint32_t)ARG2;
@@ -7000,6 +7237,7 @@ void vk_CmdBeginTransformFeedbackEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdBeginTransformFeedbackEXT(commandBuffer, firstCounterBuffer, counterBufferCount, pCounterBuffers, pCounterBufferOffsets);
 }
 void vk_CmdEndTransformFeedbackEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t firstCounterBuffer = (uint32_t)ARG2;
@@ -7009,6 +7247,7 @@ void vk_CmdEndTransformFeedbackEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdEndTransformFeedbackEXT(commandBuffer, firstCounterBuffer, counterBufferCount, pCounterBuffers, pCounterBufferOffsets);
 }
 void vk_CmdBeginQueryIndexedEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkQueryPool queryPool = *(VkQueryPool*)getPhysicalAddress(ARG2, 8);
@@ -7018,6 +7257,7 @@ void vk_CmdBeginQueryIndexedEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdBeginQueryIndexedEXT(commandBuffer, queryPool, query, flags, index);
 }
 void vk_CmdEndQueryIndexedEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkQueryPool queryPool = *(VkQueryPool*)getPhysicalAddress(ARG2, 8);
@@ -7026,6 +7266,7 @@ void vk_CmdEndQueryIndexedEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdEndQueryIndexedEXT(commandBuffer, queryPool, query, index);
 }
 void vk_CmdDrawIndirectByteCountEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t instanceCount = (uint32_t)ARG2;
@@ -7037,6 +7278,7 @@ void vk_CmdDrawIndirectByteCountEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawIndirectByteCountEXT(commandBuffer, instanceCount, firstInstance, counterBuffer, counterBufferOffset, counterOffset, vertexStride);
 }
 void vk_CmdSetExclusiveScissorNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t firstExclusiveScissor = (uint32_t)ARG2;
@@ -7045,6 +7287,7 @@ void vk_CmdSetExclusiveScissorNV(CPU* cpu) {
     pBoxedInfo->pvkCmdSetExclusiveScissorNV(commandBuffer, firstExclusiveScissor, exclusiveScissorCount, pExclusiveScissors);
 }
 void vk_CmdBindShadingRateImageNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkImageView imageView = *(VkImageView*)getPhysicalAddress(ARG2, 8);
@@ -7052,40 +7295,37 @@ void vk_CmdBindShadingRateImageNV(CPU* cpu) {
     pBoxedInfo->pvkCmdBindShadingRateImageNV(commandBuffer, imageView, imageLayout);
 }
 void vk_CmdSetViewportShadingRatePaletteNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t firstViewport = (uint32_t)ARG2;
     uint32_t viewportCount = (uint32_t)ARG3;
     VkShadingRatePaletteNV* pShadingRatePalettes = NULL;
     if (ARG4) {
-        pShadingRatePalettes = new VkShadingRatePaletteNV[viewportCount];
+        pShadingRatePalettes = vulkanAlloc<VkShadingRatePaletteNV>(viewportCount);
         for (U32 i=0;i<viewportCount;i++) {
             MarshalVkShadingRatePaletteNV::read(ARG4 + i * 8, &pShadingRatePalettes[i]);
         }
     }
     pBoxedInfo->pvkCmdSetViewportShadingRatePaletteNV(commandBuffer, firstViewport, viewportCount, pShadingRatePalettes);
-    if (pShadingRatePalettes) {
-        delete[] pShadingRatePalettes;
-    }
 }
 void vk_CmdSetCoarseSampleOrderNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkCoarseSampleOrderTypeNV sampleOrderType = (VkCoarseSampleOrderTypeNV)ARG2;
     uint32_t customSampleOrderCount = (uint32_t)ARG3;
     VkCoarseSampleOrderCustomNV* pCustomSampleOrders = NULL;
     if (ARG4) {
-        pCustomSampleOrders = new VkCoarseSampleOrderCustomNV[customSampleOrderCount];
+        pCustomSampleOrders = vulkanAlloc<VkCoarseSampleOrderCustomNV>(customSampleOrderCount);
         for (U32 i=0;i<customSampleOrderCount;i++) {
             MarshalVkCoarseSampleOrderCustomNV::read(ARG4 + i * 16, &pCustomSampleOrders[i]);
         }
     }
     pBoxedInfo->pvkCmdSetCoarseSampleOrderNV(commandBuffer, sampleOrderType, customSampleOrderCount, pCustomSampleOrders);
-    if (pCustomSampleOrders) {
-        delete[] pCustomSampleOrders;
-    }
 }
 void vk_CmdDrawMeshTasksNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t taskCount = (uint32_t)ARG2;
@@ -7093,6 +7333,7 @@ void vk_CmdDrawMeshTasksNV(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawMeshTasksNV(commandBuffer, taskCount, firstTask);
 }
 void vk_CmdDrawMeshTasksIndirectNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -7102,6 +7343,7 @@ void vk_CmdDrawMeshTasksIndirectNV(CPU* cpu) {
     pBoxedInfo->pvkCmdDrawMeshTasksIndirectNV(commandBuffer, buffer, offset, drawCount, stride);
 }
 void vk_CmdDrawMeshTasksIndirectCountNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer buffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -7114,6 +7356,7 @@ void vk_CmdDrawMeshTasksIndirectCountNV(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CompileDeferredNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipeline pipeline = *(VkPipeline*)getPhysicalAddress(ARG2, 8);
@@ -7122,6 +7365,7 @@ void vk_CompileDeferredNV(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateAccelerationStructureNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkAccelerationStructureCreateInfoNV local_pCreateInfo(ARG2);
@@ -7132,6 +7376,7 @@ void vk_CreateAccelerationStructureNV(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateAccelerationStructureNV(device, pCreateInfo, pAllocator, pAccelerationStructure);
 }
 void vk_DestroyAccelerationStructureNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkAccelerationStructureNV accelerationStructure = *(VkAccelerationStructureNV*)getPhysicalAddress(ARG2, 8);
@@ -7140,6 +7385,7 @@ void vk_DestroyAccelerationStructureNV(CPU* cpu) {
     pBoxedInfo->pvkDestroyAccelerationStructureNV(device, accelerationStructure, pAllocator);
 }
 void vk_GetAccelerationStructureMemoryRequirementsNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkAccelerationStructureMemoryRequirementsInfoNV local_pInfo(ARG2);
@@ -7150,22 +7396,21 @@ void vk_GetAccelerationStructureMemoryRequirementsNV(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_BindAccelerationStructureMemoryNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t bindInfoCount = (uint32_t)ARG2;
     VkBindAccelerationStructureMemoryInfoNV* pBindInfos = NULL;
     if (ARG3) {
-        pBindInfos = new VkBindAccelerationStructureMemoryInfoNV[bindInfoCount];
+        pBindInfos = vulkanAlloc<VkBindAccelerationStructureMemoryInfoNV>(bindInfoCount);
         for (U32 i=0;i<bindInfoCount;i++) {
             MarshalVkBindAccelerationStructureMemoryInfoNV::read(ARG3 + i * 40, &pBindInfos[i]);
         }
     }
     EAX = pBoxedInfo->pvkBindAccelerationStructureMemoryNV(device, bindInfoCount, pBindInfos);
-    if (pBindInfos) {
-        delete[] pBindInfos;
-    }
 }
 void vk_CmdCopyAccelerationStructureNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkAccelerationStructureNV dst = *(VkAccelerationStructureNV*)getPhysicalAddress(ARG2, 8);
@@ -7174,6 +7419,7 @@ void vk_CmdCopyAccelerationStructureNV(CPU* cpu) {
     pBoxedInfo->pvkCmdCopyAccelerationStructureNV(commandBuffer, dst, src, mode);
 }
 void vk_CmdWriteAccelerationStructuresPropertiesNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t accelerationStructureCount = (uint32_t)ARG2;
@@ -7184,6 +7430,7 @@ void vk_CmdWriteAccelerationStructuresPropertiesNV(CPU* cpu) {
     pBoxedInfo->pvkCmdWriteAccelerationStructuresPropertiesNV(commandBuffer, accelerationStructureCount, pAccelerationStructures, queryType, queryPool, firstQuery);
 }
 void vk_CmdBuildAccelerationStructureNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkAccelerationStructureInfoNV local_pInfo(ARG2);
@@ -7198,6 +7445,7 @@ void vk_CmdBuildAccelerationStructureNV(CPU* cpu) {
     pBoxedInfo->pvkCmdBuildAccelerationStructureNV(commandBuffer, pInfo, instanceData, instanceOffset, update, dst, src, scratch, scratchOffset);
 }
 void vk_CmdTraceRaysNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBuffer raygenShaderBindingTableBuffer = *(VkBuffer*)getPhysicalAddress(ARG2, 8);
@@ -7218,6 +7466,7 @@ void vk_CmdTraceRaysNV(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetRayTracingShaderGroupHandlesNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipeline pipeline = *(VkPipeline*)getPhysicalAddress(ARG2, 8);
@@ -7229,6 +7478,7 @@ void vk_GetRayTracingShaderGroupHandlesNV(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetAccelerationStructureHandleNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkAccelerationStructureNV accelerationStructure = *(VkAccelerationStructureNV*)getPhysicalAddress(ARG2, 8);
@@ -7238,13 +7488,14 @@ void vk_GetAccelerationStructureHandleNV(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateRayTracingPipelinesNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineCache pipelineCache = *(VkPipelineCache*)getPhysicalAddress(ARG2, 8);
     uint32_t createInfoCount = (uint32_t)ARG3;
     VkRayTracingPipelineCreateInfoNV* pCreateInfos = NULL;
     if (ARG4) {
-        pCreateInfos = new VkRayTracingPipelineCreateInfoNV[createInfoCount];
+        pCreateInfos = vulkanAlloc<VkRayTracingPipelineCreateInfoNV>(createInfoCount);
         for (U32 i=0;i<createInfoCount;i++) {
             MarshalVkRayTracingPipelineCreateInfoNV::read(ARG4 + i * 52, &pCreateInfos[i]);
         }
@@ -7253,56 +7504,53 @@ void vk_CreateRayTracingPipelinesNV(CPU* cpu) {
     VkAllocationCallbacks* pAllocator = NULL;
     VkPipeline* pPipelines = (VkPipeline*)getPhysicalAddress(ARG6, (U32)createInfoCount * 4);
     EAX = pBoxedInfo->pvkCreateRayTracingPipelinesNV(device, pipelineCache, createInfoCount, pCreateInfos, pAllocator, pPipelines);
-    if (pCreateInfos) {
-        delete[] pCreateInfos;
-    }
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceCooperativeMatrixPropertiesNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pPropertyCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
     VkCooperativeMatrixPropertiesNV* pProperties = NULL;
     if (ARG3) {
-        pProperties = new VkCooperativeMatrixPropertiesNV[*pPropertyCount];
+        pProperties = vulkanAlloc<VkCooperativeMatrixPropertiesNV>(*pPropertyCount);
     }
     EAX = pBoxedInfo->pvkGetPhysicalDeviceCooperativeMatrixPropertiesNV(physicalDevice, pPropertyCount, pProperties);
     if (ARG3) {
         for (U32 i=0;i<*pPropertyCount;i++) {
             MarshalVkCooperativeMatrixPropertiesNV::write(ARG3 + i * 40, &pProperties[i]);
         }
-        delete[] pProperties;
     }
 }
 // return type: VkResult(4 bytes)
 void vk_EnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t queueFamilyIndex = (uint32_t)ARG2;
     uint32_t* pCounterCount = (uint32_t*)getPhysicalAddress(ARG3, 4);
     VkPerformanceCounterKHR* pCounters = NULL;
     if (ARG4) {
-        pCounters = new VkPerformanceCounterKHR[*pCounterCount];
+        pCounters = vulkanAlloc<VkPerformanceCounterKHR>(*pCounterCount);
     }
     VkPerformanceCounterDescriptionKHR* pCounterDescriptions = NULL;
     if (ARG5) {
-        pCounterDescriptions = new VkPerformanceCounterDescriptionKHR[*pCounterCount];
+        pCounterDescriptions = vulkanAlloc<VkPerformanceCounterDescriptionKHR>(*pCounterCount);
     }
     EAX = pBoxedInfo->pvkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR(physicalDevice, queueFamilyIndex, pCounterCount, pCounters, pCounterDescriptions);
     if (ARG4) {
         for (U32 i=0;i<*pCounterCount;i++) {
             MarshalVkPerformanceCounterKHR::write(ARG4 + i * 36, &pCounters[i]);
         }
-        delete[] pCounters;
     }
     if (ARG5) {
         for (U32 i=0;i<*pCounterCount;i++) {
             MarshalVkPerformanceCounterDescriptionKHR::write(ARG5 + i * 780, &pCounterDescriptions[i]);
         }
-        delete[] pCounterDescriptions;
     }
 }
 void vk_GetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkQueryPoolPerformanceCreateInfoKHR local_pPerformanceQueryCreateInfo(ARG2);
@@ -7312,6 +7560,7 @@ void vk_GetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_AcquireProfilingLockKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkAcquireProfilingLockInfoKHR local_pInfo(ARG2);
@@ -7319,12 +7568,14 @@ void vk_AcquireProfilingLockKHR(CPU* cpu) {
     EAX = pBoxedInfo->pvkAcquireProfilingLockKHR(device, pInfo);
 }
 void vk_ReleaseProfilingLockKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     pBoxedInfo->pvkReleaseProfilingLockKHR(device);
 }
 // return type: uint64_t(8 bytes)
 void vk_GetBufferOpaqueCaptureAddress(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkBufferDeviceAddressInfo local_pInfo(ARG2);
@@ -7335,6 +7586,7 @@ void vk_GetBufferOpaqueCaptureAddress(CPU* cpu) {
 }
 // return type: uint64_t(8 bytes)
 void vk_GetBufferOpaqueCaptureAddressKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkBufferDeviceAddressInfo local_pInfo(ARG2);
@@ -7345,6 +7597,7 @@ void vk_GetBufferOpaqueCaptureAddressKHR(CPU* cpu) {
 }
 // return type: VkDeviceAddress(8 bytes)
 void vk_GetBufferDeviceAddress(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkBufferDeviceAddressInfo local_pInfo(ARG2);
@@ -7355,6 +7608,7 @@ void vk_GetBufferDeviceAddress(CPU* cpu) {
 }
 // return type: VkDeviceAddress(8 bytes)
 void vk_GetBufferDeviceAddressKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkBufferDeviceAddressInfo local_pInfo(ARG2);
@@ -7365,6 +7619,7 @@ void vk_GetBufferDeviceAddressKHR(CPU* cpu) {
 }
 // return type: VkDeviceAddress(8 bytes)
 void vk_GetBufferDeviceAddressEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkBufferDeviceAddressInfo local_pInfo(ARG2);
@@ -7375,6 +7630,7 @@ void vk_GetBufferDeviceAddressEXT(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreateHeadlessSurfaceEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkInstance instance = (VkInstance)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkHeadlessSurfaceCreateInfoEXT local_pCreateInfo(ARG2);
@@ -7386,23 +7642,24 @@ void vk_CreateHeadlessSurfaceEXT(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pCombinationCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
     VkFramebufferMixedSamplesCombinationNV* pCombinations = NULL;
     if (ARG3) {
-        pCombinations = new VkFramebufferMixedSamplesCombinationNV[*pCombinationCount];
+        pCombinations = vulkanAlloc<VkFramebufferMixedSamplesCombinationNV>(*pCombinationCount);
     }
     EAX = pBoxedInfo->pvkGetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV(physicalDevice, pCombinationCount, pCombinations);
     if (ARG3) {
         for (U32 i=0;i<*pCombinationCount;i++) {
             MarshalVkFramebufferMixedSamplesCombinationNV::write(ARG3 + i * 24, &pCombinations[i]);
         }
-        delete[] pCombinations;
     }
 }
 // return type: uint64_t(8 bytes)
 void vk_GetDeviceMemoryOpaqueCaptureAddress(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDeviceMemoryOpaqueCaptureAddressInfo local_pInfo(ARG2);
@@ -7413,6 +7670,7 @@ void vk_GetDeviceMemoryOpaqueCaptureAddress(CPU* cpu) {
 }
 // return type: uint64_t(8 bytes)
 void vk_GetDeviceMemoryOpaqueCaptureAddressKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDeviceMemoryOpaqueCaptureAddressInfo local_pInfo(ARG2);
@@ -7422,6 +7680,7 @@ void vk_GetDeviceMemoryOpaqueCaptureAddressKHR(CPU* cpu) {
     EDX = (U32)(result >> 32);
 }
 void vk_CmdSetLineStippleEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t lineStippleFactor = (uint32_t)ARG2;
@@ -7430,23 +7689,24 @@ void vk_CmdSetLineStippleEXT(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceToolPropertiesEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pToolCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
     VkPhysicalDeviceToolPropertiesEXT* pToolProperties = NULL;
     if (ARG3) {
-        pToolProperties = new VkPhysicalDeviceToolPropertiesEXT[*pToolCount];
+        pToolProperties = vulkanAlloc<VkPhysicalDeviceToolPropertiesEXT>(*pToolCount);
     }
     EAX = pBoxedInfo->pvkGetPhysicalDeviceToolPropertiesEXT(physicalDevice, pToolCount, pToolProperties);
     if (ARG3) {
         for (U32 i=0;i<*pToolCount;i++) {
             MarshalVkPhysicalDeviceToolPropertiesEXT::write(ARG3 + i * 1036, &pToolProperties[i]);
         }
-        delete[] pToolProperties;
     }
 }
 // return type: VkResult(4 bytes)
 void vk_CreateDeferredOperationKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     static bool shown; if (!shown && ARG2) { klog("vkCreateDeferredOperationKHR:VkAllocationCallbacks not implemented"); shown = true;}
@@ -7455,6 +7715,7 @@ void vk_CreateDeferredOperationKHR(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreateDeferredOperationKHR(device, pAllocator, pDeferredOperation);
 }
 void vk_DestroyDeferredOperationKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDeferredOperationKHR operation = *(VkDeferredOperationKHR*)getPhysicalAddress(ARG2, 8);
@@ -7464,6 +7725,7 @@ void vk_DestroyDeferredOperationKHR(CPU* cpu) {
 }
 // return type: uint32_t(4 bytes)
 void vk_GetDeferredOperationMaxConcurrencyKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDeferredOperationKHR operation = *(VkDeferredOperationKHR*)getPhysicalAddress(ARG2, 8);
@@ -7471,6 +7733,7 @@ void vk_GetDeferredOperationMaxConcurrencyKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetDeferredOperationResultKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDeferredOperationKHR operation = *(VkDeferredOperationKHR*)getPhysicalAddress(ARG2, 8);
@@ -7478,30 +7741,35 @@ void vk_GetDeferredOperationResultKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_DeferredOperationJoinKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkDeferredOperationKHR operation = *(VkDeferredOperationKHR*)getPhysicalAddress(ARG2, 8);
     EAX = pBoxedInfo->pvkDeferredOperationJoinKHR(device, operation);
 }
 void vk_CmdSetCullModeEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkCullModeFlags cullMode = (VkCullModeFlags)ARG2;
     pBoxedInfo->pvkCmdSetCullModeEXT(commandBuffer, cullMode);
 }
 void vk_CmdSetFrontFaceEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkFrontFace frontFace = (VkFrontFace)ARG2;
     pBoxedInfo->pvkCmdSetFrontFaceEXT(commandBuffer, frontFace);
 }
 void vk_CmdSetPrimitiveTopologyEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPrimitiveTopology primitiveTopology = (VkPrimitiveTopology)ARG2;
     pBoxedInfo->pvkCmdSetPrimitiveTopologyEXT(commandBuffer, primitiveTopology);
 }
 void vk_CmdSetViewportWithCountEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t viewportCount = (uint32_t)ARG2;
@@ -7509,6 +7777,7 @@ void vk_CmdSetViewportWithCountEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdSetViewportWithCountEXT(commandBuffer, viewportCount, pViewports);
 }
 void vk_CmdSetScissorWithCountEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t scissorCount = (uint32_t)ARG2;
@@ -7516,6 +7785,7 @@ void vk_CmdSetScissorWithCountEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdSetScissorWithCountEXT(commandBuffer, scissorCount, pScissors);
 }
 void vk_CmdBindVertexBuffers2EXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t firstBinding = (uint32_t)ARG2;
@@ -7527,36 +7797,42 @@ void vk_CmdBindVertexBuffers2EXT(CPU* cpu) {
     pBoxedInfo->pvkCmdBindVertexBuffers2EXT(commandBuffer, firstBinding, bindingCount, pBuffers, pOffsets, pSizes, pStrides);
 }
 void vk_CmdSetDepthTestEnableEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBool32 depthTestEnable = (VkBool32)ARG2;
     pBoxedInfo->pvkCmdSetDepthTestEnableEXT(commandBuffer, depthTestEnable);
 }
 void vk_CmdSetDepthWriteEnableEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBool32 depthWriteEnable = (VkBool32)ARG2;
     pBoxedInfo->pvkCmdSetDepthWriteEnableEXT(commandBuffer, depthWriteEnable);
 }
 void vk_CmdSetDepthCompareOpEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkCompareOp depthCompareOp = (VkCompareOp)ARG2;
     pBoxedInfo->pvkCmdSetDepthCompareOpEXT(commandBuffer, depthCompareOp);
 }
 void vk_CmdSetDepthBoundsTestEnableEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBool32 depthBoundsTestEnable = (VkBool32)ARG2;
     pBoxedInfo->pvkCmdSetDepthBoundsTestEnableEXT(commandBuffer, depthBoundsTestEnable);
 }
 void vk_CmdSetStencilTestEnableEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBool32 stencilTestEnable = (VkBool32)ARG2;
     pBoxedInfo->pvkCmdSetStencilTestEnableEXT(commandBuffer, stencilTestEnable);
 }
 void vk_CmdSetStencilOpEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkStencilFaceFlags faceMask = (VkStencilFaceFlags)ARG2;
@@ -7567,30 +7843,35 @@ void vk_CmdSetStencilOpEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdSetStencilOpEXT(commandBuffer, faceMask, failOp, passOp, depthFailOp, compareOp);
 }
 void vk_CmdSetPatchControlPointsEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t patchControlPoints = (uint32_t)ARG2;
     pBoxedInfo->pvkCmdSetPatchControlPointsEXT(commandBuffer, patchControlPoints);
 }
 void vk_CmdSetRasterizerDiscardEnableEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBool32 rasterizerDiscardEnable = (VkBool32)ARG2;
     pBoxedInfo->pvkCmdSetRasterizerDiscardEnableEXT(commandBuffer, rasterizerDiscardEnable);
 }
 void vk_CmdSetDepthBiasEnableEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBool32 depthBiasEnable = (VkBool32)ARG2;
     pBoxedInfo->pvkCmdSetDepthBiasEnableEXT(commandBuffer, depthBiasEnable);
 }
 void vk_CmdSetLogicOpEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkLogicOp logicOp = (VkLogicOp)ARG2;
     pBoxedInfo->pvkCmdSetLogicOpEXT(commandBuffer, logicOp);
 }
 void vk_CmdSetPrimitiveRestartEnableEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkBool32 primitiveRestartEnable = (VkBool32)ARG2;
@@ -7598,6 +7879,7 @@ void vk_CmdSetPrimitiveRestartEnableEXT(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_CreatePrivateDataSlotEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkPrivateDataSlotCreateInfoEXT local_pCreateInfo(ARG2);
@@ -7608,6 +7890,7 @@ void vk_CreatePrivateDataSlotEXT(CPU* cpu) {
     EAX = pBoxedInfo->pvkCreatePrivateDataSlotEXT(device, pCreateInfo, pAllocator, pPrivateDataSlot);
 }
 void vk_DestroyPrivateDataSlotEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPrivateDataSlotEXT privateDataSlot = *(VkPrivateDataSlotEXT*)getPhysicalAddress(ARG2, 8);
@@ -7617,6 +7900,7 @@ void vk_DestroyPrivateDataSlotEXT(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_SetPrivateDataEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkObjectType objectType = (VkObjectType)ARG2;
@@ -7626,6 +7910,7 @@ void vk_SetPrivateDataEXT(CPU* cpu) {
     EAX = pBoxedInfo->pvkSetPrivateDataEXT(device, objectType, objectHandle, privateDataSlot, data);
 }
 void vk_GetPrivateDataEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkDevice device = (VkDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkObjectType objectType = (VkObjectType)ARG2;
@@ -7635,6 +7920,7 @@ void vk_GetPrivateDataEXT(CPU* cpu) {
     pBoxedInfo->pvkGetPrivateDataEXT(device, objectType, objectHandle, privateDataSlot, pData);
 }
 void vk_CmdCopyBuffer2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkCopyBufferInfo2KHR local_pCopyBufferInfo(ARG2);
@@ -7642,6 +7928,7 @@ void vk_CmdCopyBuffer2KHR(CPU* cpu) {
     pBoxedInfo->pvkCmdCopyBuffer2KHR(commandBuffer, pCopyBufferInfo);
 }
 void vk_CmdCopyImage2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkCopyImageInfo2KHR local_pCopyImageInfo(ARG2);
@@ -7649,6 +7936,7 @@ void vk_CmdCopyImage2KHR(CPU* cpu) {
     pBoxedInfo->pvkCmdCopyImage2KHR(commandBuffer, pCopyImageInfo);
 }
 void vk_CmdBlitImage2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkBlitImageInfo2KHR local_pBlitImageInfo(ARG2);
@@ -7656,6 +7944,7 @@ void vk_CmdBlitImage2KHR(CPU* cpu) {
     pBoxedInfo->pvkCmdBlitImage2KHR(commandBuffer, pBlitImageInfo);
 }
 void vk_CmdCopyBufferToImage2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkCopyBufferToImageInfo2KHR local_pCopyBufferToImageInfo(ARG2);
@@ -7663,6 +7952,7 @@ void vk_CmdCopyBufferToImage2KHR(CPU* cpu) {
     pBoxedInfo->pvkCmdCopyBufferToImage2KHR(commandBuffer, pCopyBufferToImageInfo);
 }
 void vk_CmdCopyImageToBuffer2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkCopyImageToBufferInfo2KHR local_pCopyImageToBufferInfo(ARG2);
@@ -7670,6 +7960,7 @@ void vk_CmdCopyImageToBuffer2KHR(CPU* cpu) {
     pBoxedInfo->pvkCmdCopyImageToBuffer2KHR(commandBuffer, pCopyImageToBufferInfo);
 }
 void vk_CmdResolveImage2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkResolveImageInfo2KHR local_pResolveImageInfo(ARG2);
@@ -7677,6 +7968,7 @@ void vk_CmdResolveImage2KHR(CPU* cpu) {
     pBoxedInfo->pvkCmdResolveImage2KHR(commandBuffer, pResolveImageInfo);
 }
 void vk_CmdSetFragmentShadingRateKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkExtent2D* pFragmentSize = (VkExtent2D*)getPhysicalAddress(ARG2, 4);
@@ -7686,22 +7978,23 @@ void vk_CmdSetFragmentShadingRateKHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_GetPhysicalDeviceFragmentShadingRatesKHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkPhysicalDevice physicalDevice = (VkPhysicalDevice)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pFragmentShadingRateCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
     VkPhysicalDeviceFragmentShadingRateKHR* pFragmentShadingRates = NULL;
     if (ARG3) {
-        pFragmentShadingRates = new VkPhysicalDeviceFragmentShadingRateKHR[*pFragmentShadingRateCount];
+        pFragmentShadingRates = vulkanAlloc<VkPhysicalDeviceFragmentShadingRateKHR>(*pFragmentShadingRateCount);
     }
     EAX = pBoxedInfo->pvkGetPhysicalDeviceFragmentShadingRatesKHR(physicalDevice, pFragmentShadingRateCount, pFragmentShadingRates);
     if (ARG3) {
         for (U32 i=0;i<*pFragmentShadingRateCount;i++) {
             MarshalVkPhysicalDeviceFragmentShadingRateKHR::write(ARG3 + i * 20, &pFragmentShadingRates[i]);
         }
-        delete[] pFragmentShadingRates;
     }
 }
 void vk_CmdSetFragmentShadingRateEnumNV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkFragmentShadingRateNV shadingRate = (VkFragmentShadingRateNV)ARG2;
@@ -7710,12 +8003,13 @@ void vk_CmdSetFragmentShadingRateEnumNV(CPU* cpu) {
     pBoxedInfo->pvkCmdSetFragmentShadingRateEnumNV(commandBuffer, shadingRate, combinerOps);
 }
 void vk_CmdSetVertexInputEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t vertexBindingDescriptionCount = (uint32_t)ARG2;
     VkVertexInputBindingDescription2EXT* pVertexBindingDescriptions = NULL;
     if (ARG3) {
-        pVertexBindingDescriptions = new VkVertexInputBindingDescription2EXT[vertexBindingDescriptionCount];
+        pVertexBindingDescriptions = vulkanAlloc<VkVertexInputBindingDescription2EXT>(vertexBindingDescriptionCount);
         for (U32 i=0;i<vertexBindingDescriptionCount;i++) {
             MarshalVkVertexInputBindingDescription2EXT::read(ARG3 + i * 24, &pVertexBindingDescriptions[i]);
         }
@@ -7723,20 +8017,15 @@ void vk_CmdSetVertexInputEXT(CPU* cpu) {
     uint32_t vertexAttributeDescriptionCount = (uint32_t)ARG4;
     VkVertexInputAttributeDescription2EXT* pVertexAttributeDescriptions = NULL;
     if (ARG5) {
-        pVertexAttributeDescriptions = new VkVertexInputAttributeDescription2EXT[vertexAttributeDescriptionCount];
+        pVertexAttributeDescriptions = vulkanAlloc<VkVertexInputAttributeDescription2EXT>(vertexAttributeDescriptionCount);
         for (U32 i=0;i<vertexAttributeDescriptionCount;i++) {
             MarshalVkVertexInputAttributeDescription2EXT::read(ARG5 + i * 24, &pVertexAttributeDescriptions[i]);
         }
     }
     pBoxedInfo->pvkCmdSetVertexInputEXT(commandBuffer, vertexBindingDescriptionCount, pVertexBindingDescriptions, vertexAttributeDescriptionCount, pVertexAttributeDescriptions);
-    if (pVertexBindingDescriptions) {
-        delete[] pVertexBindingDescriptions;
-    }
-    if (pVertexAttributeDescriptions) {
-        delete[] pVertexAttributeDescriptions;
-    }
 }
 void vk_CmdSetColorWriteEnableEXT(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t attachmentCount = (uint32_t)ARG2;
@@ -7744,6 +8033,7 @@ void vk_CmdSetColorWriteEnableEXT(CPU* cpu) {
     pBoxedInfo->pvkCmdSetColorWriteEnableEXT(commandBuffer, attachmentCount, pColorWriteEnables);
 }
 void vk_CmdSetEvent2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkEvent event = *(VkEvent*)getPhysicalAddress(ARG2, 8);
@@ -7752,6 +8042,7 @@ void vk_CmdSetEvent2KHR(CPU* cpu) {
     pBoxedInfo->pvkCmdSetEvent2KHR(commandBuffer, event, pDependencyInfo);
 }
 void vk_CmdResetEvent2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkEvent event = *(VkEvent*)getPhysicalAddress(ARG2, 8);
@@ -7759,23 +8050,22 @@ void vk_CmdResetEvent2KHR(CPU* cpu) {
     pBoxedInfo->pvkCmdResetEvent2KHR(commandBuffer, event, stageMask);
 }
 void vk_CmdWaitEvents2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t eventCount = (uint32_t)ARG2;
     VkEvent* pEvents = (VkEvent*)getPhysicalAddress(ARG3, (U32)eventCount * 4);
     VkDependencyInfoKHR* pDependencyInfos = NULL;
     if (ARG4) {
-        pDependencyInfos = new VkDependencyInfoKHR[eventCount];
+        pDependencyInfos = vulkanAlloc<VkDependencyInfoKHR>(eventCount);
         for (U32 i=0;i<eventCount;i++) {
             MarshalVkDependencyInfoKHR::read(ARG4 + i * 36, &pDependencyInfos[i]);
         }
     }
     pBoxedInfo->pvkCmdWaitEvents2KHR(commandBuffer, eventCount, pEvents, pDependencyInfos);
-    if (pDependencyInfos) {
-        delete[] pDependencyInfos;
-    }
 }
 void vk_CmdPipelineBarrier2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     MarshalVkDependencyInfoKHR local_pDependencyInfo(ARG2);
@@ -7784,23 +8074,22 @@ void vk_CmdPipelineBarrier2KHR(CPU* cpu) {
 }
 // return type: VkResult(4 bytes)
 void vk_QueueSubmit2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkQueue queue = (VkQueue)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t submitCount = (uint32_t)ARG2;
     VkSubmitInfo2KHR* pSubmits = NULL;
     if (ARG3) {
-        pSubmits = new VkSubmitInfo2KHR[submitCount];
+        pSubmits = vulkanAlloc<VkSubmitInfo2KHR>(submitCount);
         for (U32 i=0;i<submitCount;i++) {
             MarshalVkSubmitInfo2KHR::read(ARG3 + i * 36, &pSubmits[i]);
         }
     }
     VkFence fence = *(VkFence*)getPhysicalAddress(ARG4, 8);
     EAX = pBoxedInfo->pvkQueueSubmit2KHR(queue, submitCount, pSubmits, fence);
-    if (pSubmits) {
-        delete[] pSubmits;
-    }
 }
 void vk_CmdWriteTimestamp2KHR(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineStageFlags2KHR stage = *(VkPipelineStageFlags2KHR*)getPhysicalAddress(ARG2, 8);
@@ -7809,6 +8098,7 @@ void vk_CmdWriteTimestamp2KHR(CPU* cpu) {
     pBoxedInfo->pvkCmdWriteTimestamp2KHR(commandBuffer, stage, queryPool, query);
 }
 void vk_CmdWriteBufferMarker2AMD(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkCommandBuffer commandBuffer = (VkCommandBuffer)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     VkPipelineStageFlags2KHR stage = *(VkPipelineStageFlags2KHR*)getPhysicalAddress(ARG2, 8);
@@ -7818,19 +8108,19 @@ void vk_CmdWriteBufferMarker2AMD(CPU* cpu) {
     pBoxedInfo->pvkCmdWriteBufferMarker2AMD(commandBuffer, stage, dstBuffer, dstOffset, marker);
 }
 void vk_GetQueueCheckpointData2NV(CPU* cpu) {
+    VulkanArenaScope arenaScope;
     VkQueue queue = (VkQueue)getVulkanPtr(ARG1);
     BoxedVulkanInfo* pBoxedInfo = getInfoFromHandle(ARG1);
     uint32_t* pCheckpointDataCount = (uint32_t*)getPhysicalAddress(ARG2, 4);
     VkCheckpointData2NV* pCheckpointData = NULL;
     if (ARG3) {
-        pCheckpointData = new VkCheckpointData2NV[*pCheckpointDataCount];
+        pCheckpointData = vulkanAlloc<VkCheckpointData2NV>(*pCheckpointDataCount);
     }
     pBoxedInfo->pvkGetQueueCheckpointData2NV(queue, pCheckpointDataCount, pCheckpointData);
     if (ARG3) {
         for (U32 i=0;i<*pCheckpointDataCount;i++) {
             MarshalVkCheckpointData2NV::write(ARG3 + i * 20, &pCheckpointData[i]);
         }
-        delete[] pCheckpointData;
     }
 }
 void* vulkanGetNextPtr(U32 address) {
@@ -7840,22 +8130,22 @@ void* vulkanGetNextPtr(U32 address) {
     VkStructureType type = (VkStructureType)readd(address);
     switch (type) {
         case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TRANSFORM_FEEDBACK_FEATURES_EXT: {
-            VkPhysicalDeviceTransformFeedbackFeaturesEXT* p = new VkPhysicalDeviceTransformFeedbackFeaturesEXT();
+            VkPhysicalDeviceTransformFeedbackFeaturesEXT* p = vulkanAlloc<VkPhysicalDeviceTransformFeedbackFeaturesEXT>(1);
             MarshalVkPhysicalDeviceTransformFeedbackFeaturesEXT::read(address, p);
             return p;
         }
         case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VERTEX_ATTRIBUTE_DIVISOR_FEATURES_EXT: {
-            VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT* p = new VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT();
+            VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT* p = vulkanAlloc<VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT>(1);
             MarshalVkPhysicalDeviceVertexAttributeDivisorFeaturesEXT::read(address, p);
             return p;
         }
         case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES: {
-            VkPhysicalDeviceIDProperties* p = new VkPhysicalDeviceIDProperties();
+            VkPhysicalDeviceIDProperties* p = vulkanAlloc<VkPhysicalDeviceIDProperties>(1);
             MarshalVkPhysicalDeviceIDProperties::read(address, p);
             return p;
         }
         case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES: {
-            VkPhysicalDeviceHostQueryResetFeatures* p = new VkPhysicalDeviceHostQueryResetFeatures();
+            VkPhysicalDeviceHostQueryResetFeatures* p = vulkanAlloc<VkPhysicalDeviceHostQueryResetFeatures>(1);
             MarshalVkPhysicalDeviceHostQueryResetFeatures::read(address, p);
             return p;
         }
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 #ifdef USE_GLX
 #include <X11/X.h>
@@ -151,35 +152,89 @@ typedef XID GLXWindow;
 
 #define LL(l) &l
 
-#define CALL_0_R(index) __asm__("push %0\n\tint $0x99\n\taddl $4, %%esp"::"i"(index):"%eax"); 
-#define CALL_1_R(index, arg1) __asm__("push %1\n\tpush %0\n\tint $0x99\n\taddl $8, %%esp"::"i"(index), "g"(arg1):"%eax"); 
-#define CALL_2_R(index, arg1, arg2) __asm__("push %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $12, %%esp"::"i"(index), "g"(arg1), "g"(arg2):"%eax"); 
-#define CALL_3_R(index, arg1, arg2, arg3) __asm__("push %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $16, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3):"%eax"); 
-#define CALL_4_R(index, arg1, arg2, arg3, arg4) __asm__("push %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $20, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4):"%eax"); 
-#define CALL_5_R(index, arg1, arg2, arg3, arg4, arg5) __asm__("push %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $24, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5):"%eax");
-#define CALL_6_R(index, arg1, arg2, arg3, arg4, arg5, arg6) __asm__("push %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $28, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6):"%eax");
-#define CALL_7_R(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7) __asm__("push %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $32, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7):"%eax");
-#define CALL_8_R(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8) __asm__("push %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $36, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8):"%eax");
-#define CALL_9_R(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9) __asm__("push %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $40, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9):"%eax");
-#define CALL_10_R(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10) __asm__("push %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $44, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10):"%eax");
-#define CALL_11_R(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11) __asm__("push %11\n\tpush %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $48, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10), "g"(arg11):"%eax");
-
-#define CALL_0(index) __asm__("push %0\n\tint $0x99\n\taddl $4, %%esp"::"i"(index)); 
-#define CALL_1(index, arg1) __asm__("push %1\n\tpush %0\n\tint $0x99\n\taddl $8, %%esp"::"i"(index), "g"(arg1)); 
-#define CALL_2(index, arg1, arg2) __asm__("push %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $12, %%esp"::"i"(index), "g"(arg1), "g"(arg2)); 
-#define CALL_3(index, arg1, arg2, arg3) __asm__("push %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $16, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3)); 
-#define CALL_4(index, arg1, arg2, arg3, arg4) __asm__("push %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $20, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4)); 
-#define CALL_5(index, arg1, arg2, arg3, arg4, arg5) __asm__("push %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $24, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5));
-#define CALL_6(index, arg1, arg2, arg3, arg4, arg5, arg6) __asm__("push %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $28, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6));
-#define CALL_7(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7) __asm__("push %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $32, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7));
-#define CALL_8(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8) __asm__("push %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $36, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8));
-#define CALL_9(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9) __asm__("push %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $40, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9));
-#define CALL_10(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10) __asm__("push %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $44, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10));
-#define CALL_11(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11) __asm__("push %11\n\tpush %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $48, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10), "g"(arg11));
-#define CALL_12(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12) __asm__("push %12\n\tpush %11\n\tpush %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $52, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10), "g"(arg11), "g"(arg12));
-#define CALL_13(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13) __asm__("push %13\n\tpush %12\n\tpush %11\n\tpush %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $56, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10), "g"(arg11), "g"(arg12), "g"(arg13));
-#define CALL_14(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13, arg14) __asm__("push %14\n\tpush %13\n\tpush %12\n\tpush %11\n\tpush %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $60, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10), "g"(arg11), "g"(arg12), "g"(arg13), "g"(arg14));
-#define CALL_15(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13, arg14, arg15) __asm__("push %15\n\tpush %14\n\tpush %13\n\tpush %12\n\tpush %11\n\tpush %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $64, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10), "g"(arg11), "g"(arg12), "g"(arg13), "g"(arg14), "g"(arg15));
+#define CALL_0_R(index) FLUSH_BATCH(); __asm__("push %0\n\tint $0x99\n\taddl $4, %%esp"::"i"(index):"%eax"); 
+#define CALL_1_R(index, arg1) FLUSH_BATCH(); __asm__("push %1\n\tpush %0\n\tint $0x99\n\taddl $8, %%esp"::"i"(index), "g"(arg1):"%eax"); 
+#define CALL_2_R(index, arg1, arg2) FLUSH_BATCH(); __asm__("push %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $12, %%esp"::"i"(index), "g"(arg1), "g"(arg2):"%eax"); 
+#define CALL_3_R(index, arg1, arg2, arg3) FLUSH_BATCH(); __asm__("push %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $16, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3):"%eax"); 
+#define CALL_4_R(index, arg1, arg2, arg3, arg4) FLUSH_BATCH(); __asm__("push %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $20, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4):"%eax"); 
+#define CALL_5_R(index, arg1, arg2, arg3, arg4, arg5) FLUSH_BATCH(); __asm__("push %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $24, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5):"%eax");
+#define CALL_6_R(index, arg1, arg2, arg3, arg4, arg5, arg6) FLUSH_BATCH(); __asm__("push %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $28, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6):"%eax");
+#define CALL_7_R(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7) FLUSH_BATCH(); __asm__("push %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $32, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7):"%eax");
+#define CALL_8_R(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8) FLUSH_BATCH(); __asm__("push %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $36, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8):"%eax");
+#define CALL_9_R(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9) FLUSH_BATCH(); __asm__("push %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $40, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9):"%eax");
+#define CALL_10_R(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10) FLUSH_BATCH(); __asm__("push %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $44, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10):"%eax");
+#define CALL_11_R(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11) FLUSH_BATCH(); __asm__("push %11\n\tpush %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $48, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10), "g"(arg11):"%eax");
+
+#define CALL_0(index) FLUSH_BATCH(); __asm__("push %0\n\tint $0x99\n\taddl $4, %%esp"::"i"(index)); 
+#define CALL_1(index, arg1) FLUSH_BATCH(); __asm__("push %1\n\tpush %0\n\tint $0x99\n\taddl $8, %%esp"::"i"(index), "g"(arg1)); 
+#define CALL_2(index, arg1, arg2) FLUSH_BATCH(); __asm__("push %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $12, %%esp"::"i"(index), "g"(arg1), "g"(arg2)); 
+#define CALL_3(index, arg1, arg2, arg3) FLUSH_BATCH(); __asm__("push %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $16, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3)); 
+#define CALL_4(index, arg1, arg2, arg3, arg4) FLUSH_BATCH(); __asm__("push %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $20, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4)); 
+#define CALL_5(index, arg1, arg2, arg3, arg4, arg5) FLUSH_BATCH(); __asm__("push %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $24, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5));
+#define CALL_6(index, arg1, arg2, arg3, arg4, arg5, arg6) FLUSH_BATCH(); __asm__("push %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $28, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6));
+#define CALL_7(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7) FLUSH_BATCH(); __asm__("push %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $32, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7));
+#define CALL_8(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8) FLUSH_BATCH(); __asm__("push %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $36, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8));
+#define CALL_9(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9) FLUSH_BATCH(); __asm__("push %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $40, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9));
+#define CALL_10(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10) FLUSH_BATCH(); __asm__("push %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $44, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10));
+#define CALL_11(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11) FLUSH_BATCH(); __asm__("push %11\n\tpush %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $48, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10), "g"(arg11));
+#define CALL_12(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12) FLUSH_BATCH(); __asm__("push %12\n\tpush %11\n\tpush %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $52, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10), "g"(arg11), "g"(arg12));
+#define CALL_13(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13) FLUSH_BATCH(); __asm__("push %13\n\tpush %12\n\tpush %11\n\tpush %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $56, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10), "g"(arg11), "g"(arg12), "g"(arg13));
+#define CALL_14(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13, arg14) FLUSH_BATCH(); __asm__("push %14\n\tpush %13\n\tpush %12\n\tpush %11\n\tpush %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $60, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10), "g"(arg11), "g"(arg12), "g"(arg13), "g"(arg14));
+#define CALL_15(index, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13, arg14, arg15) FLUSH_BATCH(); __asm__("push %15\n\tpush %14\n\tpush %13\n\tpush %12\n\tpush %11\n\tpush %10\n\tpush %9\n\tpush %8\n\tpush %7\n\tpush %6\n\tpush %5\n\tpush %4\n\tpush %3\n\tpush %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $64, %%esp"::"i"(index), "g"(arg1), "g"(arg2), "g"(arg3), "g"(arg4), "g"(arg5), "g"(arg6), "g"(arg7), "g"(arg8), "g"(arg9), "g"(arg10), "g"(arg11), "g"(arg12), "g"(arg13), "g"(arg14), "g"(arg15));
+
+// Calls that don't return anything and don't write through a pointer are appended to a per thread buffer instead of
+// each trapping into the emulator.  Every call is [word count][index][args...], what a pointer arg points to is copied
+// in after the args and the arg points at the copy.  The whole buffer is sent with one GLBatch call before any call
+// that isn't batched, so the order is kept and anything that is read back sees every call made before it.  The
+// Wine driver calls boxedFlushGLBatch before its own swap and make current calls, which don't go through here.
+#define BATCH_SIZE 4096
+
+static __thread uint32_t batch[BATCH_SIZE];
+static __thread uint32_t batchUsed;
+
+void boxedFlushGLBatch(void) {
+	uint32_t* p = batch;
+	uint32_t used = batchUsed;
+	
+	batchUsed = 0;
+	__asm__("push %2\n\tpush %1\n\tpush %0\n\tint $0x99\n\taddl $12, %%esp"::"i"(GLBatch), "g"(p), "g"(used):"%eax", "memory");
+}
+
+#define FLUSH_BATCH() do {if (batchUsed) boxedFlushGLBatch();} while (0)
+
+static inline uint32_t* batchCall(uint32_t index, uint32_t words) {
+	uint32_t* p;
+	
+	if (batchUsed + words > BATCH_SIZE) {
+		boxedFlushGLBatch();
+	}
+	p = batch + batchUsed;
+	batchUsed += words;
+	p[0] = words;
+	p[1] = index;
+	return p + 2;
+}
+
+static inline uint32_t batchFloat(GLfloat f) {
+	union {
+		GLfloat f;
+		uint32_t i;
+	} u;
+	u.f = f;
+	return u.i;
+}
+
+// float parameter of a batched call
+#define BF(f) batchFloat(f)
+
+#define BATCH_0(index) batchCall(index, 2)
+#define BATCH_1(index, arg1) {uint32_t* b = batchCall(index, 3); b[0] = (uint32_t)(arg1);}
+#define BATCH_2(index, arg1, arg2) {uint32_t* b = batchCall(index, 4); b[0] = (uint32_t)(arg1); b[1] = (uint32_t)(arg2);}
+#define BATCH_3(index, arg1, arg2, arg3) {uint32_t* b = batchCall(index, 5); b[0] = (uint32_t)(arg1); b[1] = (uint32_t)(arg2); b[2] = (uint32_t)(arg3);}
+#define BATCH_4(index, arg1, arg2, arg3, arg4) {uint32_t* b = batchCall(index, 6); b[0] = (uint32_t)(arg1); b[1] = (uint32_t)(arg2); b[2] = (uint32_t)(arg3); b[3] = (uint32_t)(arg4);}
+#define BATCH_5(index, arg1, arg2, arg3, arg4, arg5) {uint32_t* b = batchCall(index, 7); b[0] = (uint32_t)(arg1); b[1] = (uint32_t)(arg2); b[2] = (uint32_t)(arg3); b[3] = (uint32_t)(arg4); b[4] = (uint32_t)(arg5);}
+// the only arg is a pointer to words 32-bit values
+#define BATCH_V(index, v, words) {uint32_t* b = batchCall(index, 3 + (words)); b[0] = (uint32_t)(b + 1); memcpy(b + 1, v, (words) * 4);}
 
 /* Miscellaneous */
 GLAPI void APIENTRY glClearIndex( GLfloat c ) {
@@ -203,11 +258,11 @@ GLAPI void APIENTRY glColorMask( GLboolean red, GLboolean green, GLboolean blue,
 }
 
 GLAPI void APIENTRY glAlphaFunc( GLenum func, GLclampf ref ) {
-	CALL_2(AlphaFunc, func, F(ref));
+	BATCH_2(AlphaFunc, func, BF(ref));
 }
 
 GLAPI void APIENTRY glBlendFunc( GLenum sfactor, GLenum dfactor ) {
-	CALL_2(BlendFunc, sfactor, dfactor);
+	BATCH_2(BlendFunc, sfactor, dfactor);
 }
 
 GLAPI void APIENTRY glLogicOp( GLenum opcode ) {
@@ -215,7 +270,7 @@ GLAPI void APIENTRY glLogicOp( GLenum opcode ) {
 }
 
 GLAPI void APIENTRY glCullFace( GLenum mode ) {
-	CALL_1(CullFace, mode);
+	BATCH_1(CullFace, mode);
 }
 
 GLAPI void APIENTRY glFrontFace( GLenum mode ) {
@@ -279,11 +334,11 @@ GLAPI void APIENTRY glReadBuffer( GLenum mode ) {
 }
 
 GLAPI void APIENTRY glEnable( GLenum cap ) {
-	CALL_1(Enable, cap);
+	BATCH_1(Enable, cap);
 }
 
 GLAPI void APIENTRY glDisable( GLenum cap ) {
-	CALL_1(Disable, cap);
+	BATCH_1(Disable, cap);
 }
 
 GLAPI GLboolean APIENTRY glIsEnabled( GLenum cap ) {
@@ -360,11 +415,11 @@ GLAPI void APIENTRY glClearDepth( GLclampd depth ) {
 }
 
 GLAPI void APIENTRY glDepthFunc( GLenum func ) {
-	CALL_1(DepthFunc, func);
+	BATCH_1(DepthFunc, func);
 }
 
 GLAPI void APIENTRY glDepthMask( GLboolean flag ) {
-	CALL_1(DepthMask, flag);
+	BATCH_1(DepthMask, flag);
 }
 
 GLAPI void APIENTRY glDepthRange( GLclampd near_val, GLclampd far_val ) {
@@ -383,7 +438,7 @@ GLAPI void APIENTRY glAccum( GLenum op, GLfloat value ) {
 
 /* Transformation */
 GLAPI void APIENTRY glMatrixMode( GLenum mode ) {
-	CALL_1(MatrixMode, mode);
+	BATCH_1(MatrixMode, mode);
 }
 
 GLAPI void APIENTRY glOrtho( GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble near_val, GLdouble far_val ) {
@@ -399,15 +454,15 @@ GLAPI void APIENTRY glViewport( GLint x, GLint y, GLsizei width, GLsizei height
 }
 
 GLAPI void APIENTRY glPushMatrix( void ) {
-	CALL_0(PushMatrix);
+	BATCH_0(PushMatrix);
 }
 
 GLAPI void APIENTRY glPopMatrix( void ) {
-	CALL_0(PopMatrix);
+	BATCH_0(PopMatrix);
 }
 
 GLAPI void APIENTRY glLoadIdentity( void ) {
-	CALL_0(LoadIdentity);
+	BATCH_0(LoadIdentity);
 }
 
 GLAPI void APIENTRY glLoadMatrixd( const GLdouble *m ) {
@@ -415,7 +470,7 @@ GLAPI void APIENTRY glLoadMatrixd( const GLdouble *m ) {
 }
 
 GLAPI void APIENTRY glLoadMatrixf( const GLfloat *m ) {
-	CALL_1(LoadMatrixf, P(m));
+	BATCH_V(LoadMatrixf, m, 16);
 }
 
 GLAPI void APIENTRY glMultMatrixd( const GLdouble *m ) {
@@ -423,7 +478,7 @@ GLAPI void APIENTRY glMultMatrixd( const GLdouble *m ) {
 }
 
 GLAPI void APIENTRY glMultMatrixf( const GLfloat *m ) {
-	CALL_1(MultMatrixf, P(m));
+	BATCH_V(MultMatrixf, m, 16);
 }
 
 GLAPI void APIENTRY glRotated( GLdouble angle, GLdouble x, GLdouble y, GLdouble z) {
@@ -431,7 +486,7 @@ GLAPI void APIENTRY glRotated( GLdouble angle, GLdouble x, GLdouble y, GLdouble
 }
 
 GLAPI void APIENTRY glRotatef( GLfloat angle, GLfloat x, GLfloat y, GLfloat z ) {
-	CALL_4(Rotatef, F(angle), F(x), F(y), F(z));
+	BATCH_4(Rotatef, BF(angle), BF(x), BF(y), BF(z));
 }
 
 GLAPI void APIENTRY glScaled( GLdouble x, GLdouble y, GLdouble z ) {
@@ -439,7 +494,7 @@ GLAPI void APIENTRY glScaled( GLdouble x, GLdouble y, GLdouble z ) {
 }
 
 GLAPI void APIENTRY glScalef( GLfloat x, GLfloat y, GLfloat z ) {
-	CALL_3(Scalef, F(x), F(y), F(z));
+	BATCH_3(Scalef, BF(x), BF(y), BF(z));
 }
 
 GLAPI void APIENTRY glTranslated( GLdouble x, GLdouble y, GLdouble z ) {
@@ -447,7 +502,7 @@ GLAPI void APIENTRY glTranslated( GLdouble x, GLdouble y, GLdouble z ) {
 }
 
 GLAPI void APIENTRY glTranslatef( GLfloat x, GLfloat y, GLfloat z ) {
-	CALL_3(Translatef, F(x), F(y), F(z));
+	BATCH_3(Translatef, BF(x), BF(y), BF(z));
 }
 
 /* Display Lists */
@@ -485,11 +540,11 @@ GLAPI void APIENTRY glListBase( GLuint base ) {
 
 /* Drawing Functions */
 GLAPI void APIENTRY glBegin( GLenum mode ) {
-	CALL_1(Begin, mode);
+	BATCH_1(Begin, mode);
 }
 
 GLAPI void APIENTRY glEnd( void ) {
-	CALL_0(End);
+	BATCH_0(End);
 }
 
 GLAPI void APIENTRY glVertex2d( GLdouble x, GLdouble y ) {
@@ -497,11 +552,11 @@ GLAPI void APIENTRY glVertex2d( GLdouble x, GLdouble y ) {
 }
 
 GLAPI void APIENTRY glVertex2f( GLfloat x, GLfloat y ) {
-	CALL_2(Vertex2f, F(x), F(y));
+	BATCH_2(Vertex2f, BF(x), BF(y));
 }
 
 GLAPI void APIENTRY glVertex2i( GLint x, GLint y ) {
-	CALL_2(Vertex2i, x, y);
+	BATCH_2(Vertex2i, x, y);
 }
 
 GLAPI void APIENTRY glVertex2s( GLshort x, GLshort y ) {
@@ -513,11 +568,11 @@ GLAPI void APIENTRY glVertex3d( GLdouble x, GLdouble y, GLdouble z ) {
 }
 
 GLAPI void APIENTRY glVertex3f( GLfloat x, GLfloat y, GLfloat z ) {
-	CALL_3(Vertex3f, F(x), F(y), F(z));
+	BATCH_3(Vertex3f, BF(x), BF(y), BF(z));
 }
 
 GLAPI void APIENTRY glVertex3i( GLint x, GLint y, GLint z ) {
-	CALL_3(Vertex3i, x, y, z);
+	BATCH_3(Vertex3i, x, y, z);
 }
 
 GLAPI void APIENTRY glVertex3s( GLshort x, GLshort y, GLshort z ) {
@@ -529,7 +584,7 @@ GLAPI void APIENTRY glVertex4d( GLdouble x, GLdouble y, GLdouble z, GLdouble w )
 }
 
 GLAPI void APIENTRY glVertex4f( GLfloat x, GLfloat y, GLfloat z, GLfloat w ) {
-	CALL_4(Vertex4f, F(x), F(y), F(z), F(w));
+	BATCH_4(Vertex4f, BF(x), BF(y), BF(z), BF(w));
 }
 
 GLAPI void APIENTRY glVertex4i( GLint x, GLint y, GLint z, GLint w ) {
@@ -545,7 +600,7 @@ GLAPI void APIENTRY glVertex2dv( const GLdouble *v ) {
 }
 
 GLAPI void APIENTRY glVertex2fv( const GLfloat *v ) {
-	CALL_1(Vertex2fv, P(v));
+	BATCH_V(Vertex2fv, v, 2);
 }
 
 GLAPI void APIENTRY glVertex2iv( const GLint *v ) {
@@ -561,7 +616,7 @@ GLAPI void APIENTRY glVertex3dv( const GLdouble *v ) {
 }
 
 GLAPI void APIENTRY glVertex3fv( const GLfloat *v ) {
-	CALL_1(Vertex3fv, P(v));
+	BATCH_V(Vertex3fv, v, 3);
 }
 
 GLAPI void APIENTRY glVertex3iv( const GLint *v ) {
@@ -577,7 +632,7 @@ GLAPI void APIENTRY glVertex4dv( const GLdouble *v ) {
 }
 
 GLAPI void APIENTRY glVertex4fv( const GLfloat *v ) {
-	CALL_1(Vertex4fv, P(v));
+	BATCH_V(Vertex4fv, v, 4);
 }
 
 GLAPI void APIENTRY glVertex4iv( const GLint *v ) {
@@ -597,7 +652,7 @@ GLAPI void APIENTRY glNormal3d( GLdouble nx, GLdouble ny, GLdouble nz ) {
 }
 
 GLAPI void APIENTRY glNormal3f( GLfloat nx, GLfloat ny, GLfloat nz ) {
-	CALL_3(Normal3f, F(nx), F(ny), F(nz));
+	BATCH_3(Normal3f, BF(nx), BF(ny), BF(nz));
 }
 
 GLAPI void APIENTRY glNormal3i( GLint nx, GLint ny, GLint nz ) {
@@ -617,7 +672,7 @@ GLAPI void APIENTRY glNormal3dv( const GLdouble *v ) {
 }
 
 GLAPI void APIENTRY glNormal3fv( const GLfloat *v ) {
-	CALL_1(Normal3fv, P(v));
+	BATCH_V(Normal3fv, v, 3);
 }
 
 GLAPI void APIENTRY glNormal3iv( const GLint *v ) {
@@ -677,7 +732,7 @@ GLAPI void APIENTRY glColor3d( GLdouble red, GLdouble green, GLdouble blue ) {
 }
 
 GLAPI void APIENTRY glColor3f( GLfloat red, GLfloat green, GLfloat blue ) {
-	CALL_3(Color3f, F(red), F(green), F(blue));
+	BATCH_3(Color3f, BF(red), BF(green), BF(blue));
 }
 
 GLAPI void APIENTRY glColor3i( GLint red, GLint green, GLint blue ) {
@@ -689,7 +744,7 @@ GLAPI void APIENTRY glColor3s( GLshort red, GLshort green, GLshort blue ) {
 }
 
 GLAPI void APIENTRY glColor3ub( GLubyte red, GLubyte green, GLubyte blue ) {
-	CALL_3(Color3ub, red, green, blue);
+	BATCH_3(Color3ub, red, green, blue);
 }
 
 GLAPI void APIENTRY glColor3ui( GLuint red, GLuint green, GLuint blue ) {
@@ -709,7 +764,7 @@ GLAPI void APIENTRY glColor4d( GLdouble red, GLdouble green, GLdouble blue, GLdo
 }
 
 GLAPI void APIENTRY glColor4f( GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha ) {
-	CALL_4(Color4f, F(red), F(green), F(blue), F(alpha));
+	BATCH_4(Color4f, BF(red), BF(green), BF(blue), BF(alpha));
 }
 
 GLAPI void APIENTRY glColor4i( GLint red, GLint green, GLint blue, GLint alpha ) {
@@ -721,7 +776,7 @@ GLAPI void APIENTRY glColor4s( GLshort red, GLshort green, GLshort blue, GLshort
 }
 
 GLAPI void APIENTRY glColor4ub( GLubyte red, GLubyte green, GLubyte blue, GLubyte alpha ) {
-	CALL_4(Color4ub, red, green, blue, alpha);
+	BATCH_4(Color4ub, red, green, blue, alpha);
 }
 
 GLAPI void APIENTRY glColor4ui( GLuint red, GLuint green, GLuint blue, GLuint alpha ) {
@@ -741,7 +796,7 @@ GLAPI void APIENTRY glColor3dv( const GLdouble *v ) {
 }
 
 GLAPI void APIENTRY glColor3fv( const GLfloat *v ) {
-	CALL_1(Color3fv, P(v));
+	BATCH_V(Color3fv, v, 3);
 }
 
 GLAPI void APIENTRY glColor3iv( const GLint *v ) {
@@ -773,7 +828,7 @@ GLAPI void APIENTRY glColor4dv( const GLdouble *v ) {
 }
 
 GLAPI void APIENTRY glColor4fv( const GLfloat *v ) {
-	CALL_1(Color4fv, P(v));
+	BATCH_V(Color4fv, v, 4);
 }
 
 GLAPI void APIENTRY glColor4iv( const GLint *v ) {
@@ -785,7 +840,7 @@ GLAPI void APIENTRY glColor4sv( const GLshort *v ) {
 }
 
 GLAPI void APIENTRY glColor4ubv( const GLubyte *v ) {
-	CALL_1(Color4ubv, P(v));
+	BATCH_V(Color4ubv, v, 1);
 }
 
 GLAPI void APIENTRY glColor4uiv( const GLuint *v ) {
@@ -801,7 +856,7 @@ GLAPI void APIENTRY glTexCoord1d( GLdouble s ) {
 }
 
 GLAPI void APIENTRY glTexCoord1f( GLfloat s ) {
-	CALL_1(TexCoord1f, F(s));
+	BATCH_1(TexCoord1f, BF(s));
 }
 
 GLAPI void APIENTRY glTexCoord1i( GLint s ) {
@@ -817,7 +872,7 @@ GLAPI void APIENTRY glTexCoord2d( GLdouble s, GLdouble t ) {
 }
 
 GLAPI void APIENTRY glTexCoord2f( GLfloat s, GLfloat t ) {
-	CALL_2(TexCoord2f, F(s), F(t));
+	BATCH_2(TexCoord2f, BF(s), BF(t));
 }
 
 GLAPI void APIENTRY glTexCoord2i( GLint s, GLint t ) {
@@ -833,7 +888,7 @@ GLAPI void APIENTRY glTexCoord3d( GLdouble s, GLdouble t, GLdouble r ) {
 }
 
 GLAPI void APIENTRY glTexCoord3f( GLfloat s, GLfloat t, GLfloat r ) {
-	CALL_3(TexCoord3f, F(s), F(t), F(r));
+	BATCH_3(TexCoord3f, BF(s), BF(t), BF(r));
 }
 
 GLAPI void APIENTRY glTexCoord3i( GLint s, GLint t, GLint r ) {
@@ -849,7 +904,7 @@ GLAPI void APIENTRY glTexCoord4d( GLdouble s, GLdouble t, GLdouble r, GLdouble q
 }
 
 GLAPI void APIENTRY glTexCoord4f( GLfloat s, GLfloat t, GLfloat r, GLfloat q ) {
-	CALL_4(TexCoord4f, F(s), F(t), F(r), F(q));
+	BATCH_4(TexCoord4f, BF(s), BF(t), BF(r), BF(q));
 }
 
 GLAPI void APIENTRY glTexCoord4i( GLint s, GLint t, GLint r, GLint q ) {
@@ -881,7 +936,7 @@ GLAPI void APIENTRY glTexCoord2dv( const GLdouble *v ) {
 }
 
 GLAPI void APIENTRY glTexCoord2fv( const GLfloat *v ) {
-	CALL_1(TexCoord2fv, P(v));
+	BATCH_V(TexCoord2fv, v, 2);
 }
 
 GLAPI void APIENTRY glTexCoord2iv( const GLint *v ) {
@@ -897,7 +952,7 @@ GLAPI void APIENTRY glTexCoord3dv( const GLdouble *v ) {
 }
 
 GLAPI void APIENTRY glTexCoord3fv( const GLfloat *v ) {
-	CALL_1(TexCoord3fv, P(v));
+	BATCH_V(TexCoord3fv, v, 3);
 }
 
 GLAPI void APIENTRY glTexCoord3iv( const GLint *v ) {
@@ -913,7 +968,7 @@ GLAPI void APIENTRY glTexCoord4dv( const GLdouble *v ) {
 }
 
 GLAPI void APIENTRY glTexCoord4fv( const GLfloat *v ) {
-	CALL_1(TexCoord4fv, P(v));
+	BATCH_V(TexCoord4fv, v, 4);
 }
 
 GLAPI void APIENTRY glTexCoord4iv( const GLint *v ) {
@@ -1054,7 +1109,7 @@ GLAPI void APIENTRY glRectsv( const GLshort *v1, const GLshort *v2 ) {
 
 /* Lighting */
 GLAPI void APIENTRY glShadeModel( GLenum mode ) {
-	CALL_1(ShadeModel, mode);
+	BATCH_1(ShadeModel, mode);
 }
 
 GLAPI void APIENTRY glLightf( GLenum light, GLenum pname, GLfloat param ) {
@@ -1241,11 +1296,11 @@ GLAPI void APIENTRY glGetTexGeniv( GLenum coord, GLenum pname, GLint *params ) {
 }
 
 GLAPI void APIENTRY glTexEnvf( GLenum target, GLenum pname, GLfloat param ) {
-	CALL_3(TexEnvf, target, pname, F(param));
+	BATCH_3(TexEnvf, target, pname, BF(param));
 }
 
 GLAPI void APIENTRY glTexEnvi( GLenum target, GLenum pname, GLint param ) {
-	CALL_3(TexEnvi, target, pname, param);
+	BATCH_3(TexEnvi, target, pname, param);
 }
 
 GLAPI void APIENTRY glTexEnvfv( GLenum target, GLenum pname, const GLfloat *params ) {
@@ -1265,11 +1320,11 @@ GLAPI void APIENTRY glGetTexEnviv( GLenum target, GLenum pname, GLint *params )
 }
 
 GLAPI void APIENTRY glTexParameterf( GLenum target, GLenum pname, GLfloat param ) {
-	CALL_3(TexParameterf, target, pname, F(param));
+	BATCH_3(TexParameterf, target, pname, BF(param));
 }
 
 GLAPI void APIENTRY glTexParameteri( GLenum target, GLenum pname, GLint param ) {
-	CALL_3(TexParameteri, target, pname, param);
+	BATCH_3(TexParameteri, target, pname, param);
 }
 
 GLAPI void APIENTRY glTexParameterfv( GLenum target, GLenum pname, const GLfloat *params ) {
@@ -1458,7 +1513,7 @@ GLAPI void APIENTRY glDeleteTextures( GLsizei n, const GLuint *textures) {
 }
 
 GLAPI void APIENTRY glBindTexture( GLenum target, GLuint texture ) {
-	CALL_2(BindTexture, target, texture);
+	BATCH_2(BindTexture, target, texture);
 }
 
 GLAPI void APIENTRY glPrioritizeTextures( GLsizei n, const GLuint *textures, const GLclampf *priorities ) {
@@ -2553,4 +2553,5 @@
 #define WindowPos4svMESA (GL_EXT_BASE+2552)
 #define WriteMaskEXT (GL_EXT_BASE+2553)
 #define GetStringi (GL_EXT_BASE+2554)
-#define GL_FUNC_COUNT (GL_EXT_BASE+2555)
\ No newline at end of file
+#define GLBatch (GL_EXT_BASE+2555)
+#define GL_FUNC_COUNT (GL_EXT_BASE+2556)
\ No newline at end of file
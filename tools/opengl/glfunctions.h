@@ -15,7 +15,7 @@ GLAPI void APIENTRY glActiveStencilFaceEXT( GLenum face) {
 }
 
 GLAPI void APIENTRY glActiveTexture( GLenum texture) {
-    CALL_1(ActiveTexture, texture);
+    BATCH_1(ActiveTexture, texture);
 }
 
 GLAPI void APIENTRY glActiveTextureARB( GLenum texture) {
@@ -8023,7 +8023,7 @@ GLAPI void APIENTRY glUniform1dv( GLint location, GLsizei count, const GLdouble*
 }
 
 GLAPI void APIENTRY glUniform1f( GLint location, GLfloat v0) {
-    CALL_2(Uniform1f, location, F(v0));
+    BATCH_2(Uniform1f, location, BF(v0));
 }
 
 GLAPI void APIENTRY glUniform1fARB( GLint location, GLfloat v0) {
@@ -8039,7 +8039,7 @@ GLAPI void APIENTRY glUniform1fvARB( GLint location, GLsizei count, const GLfloa
 }
 
 GLAPI void APIENTRY glUniform1i( GLint location, GLint v0) {
-    CALL_2(Uniform1i, location, v0);
+    BATCH_2(Uniform1i, location, v0);
 }
 
 GLAPI void APIENTRY glUniform1i64ARB( GLint location, GLint64 x) {
@@ -8111,7 +8111,7 @@ GLAPI void APIENTRY glUniform2dv( GLint location, GLsizei count, const GLdouble*
 }
 
 GLAPI void APIENTRY glUniform2f( GLint location, GLfloat v0, GLfloat v1) {
-    CALL_3(Uniform2f, location, F(v0), F(v1));
+    BATCH_3(Uniform2f, location, BF(v0), BF(v1));
 }
 
 GLAPI void APIENTRY glUniform2fARB( GLint location, GLfloat v0, GLfloat v1) {
@@ -8127,7 +8127,7 @@ GLAPI void APIENTRY glUniform2fvARB( GLint location, GLsizei count, const GLfloa
 }
 
 GLAPI void APIENTRY glUniform2i( GLint location, GLint v0, GLint v1) {
-    CALL_3(Uniform2i, location, v0, v1);
+    BATCH_3(Uniform2i, location, v0, v1);
 }
 
 GLAPI void APIENTRY glUniform2i64ARB( GLint location, GLint64 x, GLint64 y) {
@@ -8199,7 +8199,7 @@ GLAPI void APIENTRY glUniform3dv( GLint location, GLsizei count, const GLdouble*
 }
 
 GLAPI void APIENTRY glUniform3f( GLint location, GLfloat v0, GLfloat v1, GLfloat v2) {
-    CALL_4(Uniform3f, location, F(v0), F(v1), F(v2));
+    BATCH_4(Uniform3f, location, BF(v0), BF(v1), BF(v2));
 }
 
 GLAPI void APIENTRY glUniform3fARB( GLint location, GLfloat v0, GLfloat v1, GLfloat v2) {
@@ -8215,7 +8215,7 @@ GLAPI void APIENTRY glUniform3fvARB( GLint location, GLsizei count, const GLfloa
 }
 
 GLAPI void APIENTRY glUniform3i( GLint location, GLint v0, GLint v1, GLint v2) {
-    CALL_4(Uniform3i, location, v0, v1, v2);
+    BATCH_4(Uniform3i, location, v0, v1, v2);
 }
 
 GLAPI void APIENTRY glUniform3i64ARB( GLint location, GLint64 x, GLint64 y, GLint64 z) {
@@ -8287,7 +8287,7 @@ GLAPI void APIENTRY glUniform4dv( GLint location, GLsizei count, const GLdouble*
 }
 
 GLAPI void APIENTRY glUniform4f( GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {
-    CALL_5(Uniform4f, location, F(v0), F(v1), F(v2), F(v3));
+    BATCH_5(Uniform4f, location, BF(v0), BF(v1), BF(v2), BF(v3));
 }
 
 GLAPI void APIENTRY glUniform4fARB( GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {
@@ -8303,7 +8303,7 @@ GLAPI void APIENTRY glUniform4fvARB( GLint location, GLsizei count, const GLfloa
 }
 
 GLAPI void APIENTRY glUniform4i( GLint location, GLint v0, GLint v1, GLint v2, GLint v3) {
-    CALL_5(Uniform4i, location, v0, v1, v2, v3);
+    BATCH_5(Uniform4i, location, v0, v1, v2, v3);
 }
 
 GLAPI void APIENTRY glUniform4i64ARB( GLint location, GLint64 x, GLint64 y, GLint64 z, GLint64 w) {
@@ -8451,7 +8451,16 @@ GLAPI void APIENTRY glUniformMatrix4dv( GLint location, GLsizei count, GLboolean
 }
 
 GLAPI void APIENTRY glUniformMatrix4fv( GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
-    CALL_4(UniformMatrix4fv, location, count, transpose, value);
+    if (count == 1) {
+        uint32_t* b = batchCall(UniformMatrix4fv, 22);
+        b[0] = location;
+        b[1] = count;
+        b[2] = transpose;
+        b[3] = (uint32_t)(b + 4);
+        memcpy(b + 4, value, 64);
+    } else {
+        CALL_4(UniformMatrix4fv, location, count, transpose, value);
+    }
 }
 
 GLAPI void APIENTRY glUniformMatrix4fvARB( GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
@@ -8519,7 +8528,7 @@ GLAPI void APIENTRY glUpdateObjectBufferATI( GLuint buffer, GLuint offset, GLsiz
 }
 
 GLAPI void APIENTRY glUseProgram( GLuint program) {
-    CALL_1(UseProgram, program);
+    BATCH_1(UseProgram, program);
 }
 
 GLAPI void APIENTRY glUseProgramObjectARB( GLhandleARB programObj) {
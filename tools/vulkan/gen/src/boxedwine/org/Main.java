@@ -698,7 +698,13 @@ public class Main {
             } else if (eElement.hasAttribute("len")) {
                 param.len = eElement.getAttribute("len");
             }
-            param.full = eElement.getTextContent().replaceAll("\\s{2,}", " ").trim();
+            param.full = eElement.getTextContent();
+            // comments can have * or [] in them
+            NodeList comments = eElement.getElementsByTagName("comment");
+            for (int i = 0; i < comments.getLength(); i++) {
+                param.full = param.full.replace(comments.item(i).getTextContent(), "");
+            }
+            param.full = param.full.replaceAll("\\s{2,}", " ").trim();
             param.isConst = param.full.contains("const ");
             if (param.full.contains("[")) {
                 int pos = param.full.indexOf('[');
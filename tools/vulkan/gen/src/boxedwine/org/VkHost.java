@@ -14,6 +14,7 @@ public class VkHost {
             out.append("// return type: "+fn.returnType.name+"("+fn.returnType.getSize()+" bytes)\n");
         }
         out.append("void vk_" + fn.name.substring(2) + "(CPU* cpu) {\n");
+        out.append("    VulkanArenaScope arenaScope;\n");
         if (!fn.params.elementAt(0).paramType.type.equals("VK_DEFINE_HANDLE")) {
             out.append("    initVulkan();\n");
         }/*
@@ -142,7 +143,8 @@ public class VkHost {
         out.append("#include \"vk/vulkan.h\"\n");
         out.append("#include \"vk/vulkan_core.h\"\n");
         out.append("#define BOXED_VK_EXTERN\n");
-        out.append("#include \"vk_host.h\"\n\n");
+        out.append("#include \"vk_host.h\"\n");
+        out.append("#include \"vk_arena.h\"\n\n");
         out.append("void initVulkan();\n");
         out.append("void* getVulkanPtr(U32 address);\n");
         out.append("U32 createVulkanPtr(U64 value, BoxedVulkanInfo* info);\n");
@@ -212,9 +214,9 @@ public class VkHost {
             part2.append(": {\n");
             part2.append("            ");
             part2.append(Main.typeExtensions.get(key));
-            part2.append("* p = new ");
+            part2.append("* p = vulkanAlloc<");
             part2.append(Main.typeExtensions.get(key));
-            part2.append("();\n");
+            part2.append(">(1);\n");
             part2.append("            Marshal");
             part2.append(Main.typeExtensions.get(key));
             part2.append("::read(address, p);\n");
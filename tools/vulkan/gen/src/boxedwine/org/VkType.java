@@ -113,6 +113,56 @@ public class VkType {
         return result;
     }
 
+    // The generated code reads the guest's structures with the members packed one after the other, which is how they
+    // are laid out for the 32-bit guest.  If none of the members are pointers or 4 byte handles and the host wouldn't
+    // pad anything, the host layout is the same and an array of them can be used where it is.
+    public boolean hasHostLayout() {
+        if (!category.equals("struct") || members == null) {
+            return false;
+        }
+        int offset = 0;
+        for (VkParam member : members) {
+            if (member.isPointer || member.isDoublePointer) {
+                return false;
+            }
+            int alignment = member.paramType.getHostAlignment();
+            if (alignment == 0 || (offset % alignment) != 0) {
+                return false;
+            }
+            offset += member.getSize();
+        }
+        return (offset % getHostAlignment()) == 0;
+    }
+
+    // 0 if the type is different on the host
+    public int getHostAlignment() {
+        if (category.equals("struct")) {
+            if (members == null) {
+                return 0;
+            }
+            int result = 1;
+            for (VkParam member : members) {
+                if (member.isPointer || member.isDoublePointer) {
+                    return 0;
+                }
+                int alignment = member.paramType.getHostAlignment();
+                if (alignment == 0) {
+                    return 0;
+                }
+                result = Math.max(result, alignment);
+            }
+            return result;
+        }
+        if (category.equals("union") || category.equals("funcpointer") || type.equals("VK_DEFINE_HANDLE") || type.equals("size_t") || type.equals("void")) {
+            return 0;
+        }
+        int size = getSize();
+        if (size == 1 || size == 2 || size == 4 || size == 8) {
+            return size;
+        }
+        return 0;
+    }
+
     public String name;
     public String type;
     public String category;
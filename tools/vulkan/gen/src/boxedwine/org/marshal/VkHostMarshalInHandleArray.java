@@ -12,16 +12,16 @@ public class VkHostMarshalInHandleArray extends VkHostMarshal {
         out.append(param.paramType.name);
         out.append("* ");
         out.append(param.name);
-        out.append(" = new ");
+        out.append(" = vulkanAlloc<");
         out.append(param.paramType.name);
-        out.append("[");
+        out.append(">(");
         param.countString = "";
         if (!param.countInStructure && param.countParam.isPointer) {
             param.countString += "*";
         }
         param.countString += param.countParam.name;
         out.append(param.countString);
-        out.append("];\n");
+        out.append(");\n");
         out.append("    for (U32 i=0;i<");
         out.append(param.countString);
         out.append(";i++) {\n        ");
@@ -34,8 +34,5 @@ public class VkHostMarshalInHandleArray extends VkHostMarshal {
     }
 
     public void after(VkFunction fn, StringBuilder out, VkParam param) throws Exception {
-        out.append("    delete[] ");
-        out.append(param.name);
-        out.append(";\n");
     }
 }
@@ -15,6 +15,17 @@ public class VkHostMarshalInStructure extends VkHostMarshal {
             out.append("* ");
             out.append(param.name);
             out.append(" = NULL;\n");
+        } else if (param.paramType.hasHostLayout()) {
+            out.append("    ");
+            out.append(param.paramType.name);
+            out.append("* ");
+            out.append(param.name);
+            out.append(" = vulkanGetArray<");
+            out.append(param.paramType.name);
+            out.append(">(");
+            out.append(param.paramArg);
+            out.append(", 1);\n");
+            param.paramType.needMarshalIn = true;
         } else {
             out.append("    Marshal");
             out.append(param.paramType.name);
@@ -8,6 +8,26 @@ import boxedwine.org.VkParam;
  */
 public class VkHostMarshalInStructureArray  extends VkHostMarshal {
     public void before(VkFunction fn, StringBuilder out, VkParam param) throws Exception {
+        param.countString = "";
+        if (!param.countInStructure && param.countParam.isPointer) {
+            param.countString += "*";
+        }
+        param.countString += param.countParam.name;
+        param.paramType.needMarshalIn = true;
+        if (param.paramType.hasHostLayout()) {
+            out.append("    ");
+            out.append(param.paramType.name);
+            out.append("* ");
+            out.append(param.name);
+            out.append(" = vulkanGetArray<");
+            out.append(param.paramType.name);
+            out.append(">(");
+            out.append(param.paramArg);
+            out.append(", ");
+            out.append(param.countString);
+            out.append(");\n");
+            return;
+        }
         out.append("    ");
         out.append(param.paramType.name);
         out.append("* ");
@@ -17,16 +37,11 @@ public class VkHostMarshalInStructureArray  extends VkHostMarshal {
         out.append(param.paramArg);
         out.append(") {\n        ");
         out.append(param.name);
-        out.append(" = new ");
+        out.append(" = vulkanAlloc<");
         out.append(param.paramType.name);
-        out.append("[");
-        param.countString = "";
-        if (!param.countInStructure && param.countParam.isPointer) {
-            param.countString += "*";
-        }
-        param.countString += param.countParam.name;
+        out.append(">(");
         out.append(param.countString);
-        out.append("];\n");
+        out.append(");\n");
 
         out.append("        for (U32 i=0;i<");
         out.append(param.countString);
@@ -40,14 +55,8 @@ public class VkHostMarshalInStructureArray  extends VkHostMarshal {
         out.append(param.name);
         out.append("[i]);\n        }\n");
         out.append("    }\n");
-        param.paramType.needMarshalIn = true;
     }
 
     public void after(VkFunction fn, StringBuilder out, VkParam param) throws Exception {
-        out.append("    if (");
-        out.append(param.name);
-        out.append(") {\n        delete[] ");
-        out.append(param.name);
-        out.append(";\n    }\n");
     }
 }
\ No newline at end of file
@@ -17,16 +17,16 @@ public class VkHostMarshalOutHandleArray extends VkHostMarshal {
         out.append(param.paramArg);
         out.append(") {\n        ");
         out.append(param.name);
-        out.append(" = new ");
+        out.append(" = vulkanAlloc<");
         out.append(param.paramType.name);
-        out.append("[");
+        out.append(">(");
         param.countString = "";
         if (!param.countInStructure && param.countParam.isPointer) {
             param.countString += "*";
         }
         param.countString += param.len;
         out.append(param.countString);
-        out.append("];\n    }\n");
+        out.append(");\n    }\n");
     }
 
     public void after(VkFunction fn, StringBuilder out, VkParam param) throws Exception {
@@ -40,8 +40,6 @@ public class VkHostMarshalOutHandleArray extends VkHostMarshal {
         out.append(" + i*4, createVulkanPtr((U64)");
         out.append(param.name);
         out.append("[i], pBoxedInfo));\n        }\n");
-        out.append("        delete[] ");
-        out.append(param.name);
-        out.append(";\n    }\n");
+        out.append("    }\n");
     }
 }
\ No newline at end of file
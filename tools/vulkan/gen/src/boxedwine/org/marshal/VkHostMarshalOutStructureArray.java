@@ -17,16 +17,16 @@ public class VkHostMarshalOutStructureArray extends VkHostMarshal {
         out.append(param.paramArg);
         out.append(") {\n        ");
         out.append(param.name);
-        out.append(" = new ");
+        out.append(" = vulkanAlloc<");
         out.append(param.paramType.name);
-        out.append("[");
+        out.append(">(");
         param.countString = "";
         if (!param.countInStructure && param.countParam.isPointer) {
             param.countString += "*";
         }
         param.countString += param.countParam.name;
         out.append(param.countString);
-        out.append("];\n    }\n");
+        out.append(");\n    }\n");
     }
 
     public void after(VkFunction fn, StringBuilder out, VkParam param) throws Exception {
@@ -44,9 +44,7 @@ public class VkHostMarshalOutStructureArray extends VkHostMarshal {
         out.append(", &");
         out.append(param.name);
         out.append("[i]);\n        }\n");
-        out.append("        delete[] ");
-        out.append(param.name);
-        out.append(";\n    }\n");
+        out.append("    }\n");
         param.paramType.needMarshalOut = true;
     }
 }
\ No newline at end of file
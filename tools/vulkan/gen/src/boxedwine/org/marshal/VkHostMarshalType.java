@@ -15,6 +15,15 @@ public class VkHostMarshalType {
         out.append("    ");
         out.append(t.name);
         out.append(" s;\n");
+        if (t.needMarshalIn && t.hasHostLayout()) {
+            out.append("    static_assert(sizeof(");
+            out.append(t.name);
+            out.append(") == ");
+            out.append(t.getSize());
+            out.append(", \"");
+            out.append(t.name);
+            out.append(" is used in place\");\n");
+        }
         if (t.needMarshalIn) {
             out.append("    Marshal");
             out.append(t.name);
@@ -53,11 +62,11 @@ public class VkHostMarshalType {
                                     out.append(p.paramType.name);
                                     out.append("** ");
                                     out.append(p.name);
-                                    out.append(" = new ");
+                                    out.append(" = vulkanAlloc<");
                                     out.append(p.paramType.name);
-                                    out.append("*[s->");
+                                    out.append("*>(s->");
                                     out.append(parts[0]);
-                                    out.append("];\n");
+                                    out.append(");\n");
                                     out.append("            for (int i=0;i<(int)s->");
                                     out.append(parts[0]);
                                     out.append(";i++) {\n");
@@ -78,7 +87,7 @@ public class VkHostMarshalType {
                             } else {
                                 throw new  Exception("oops");
                             }
-                        } else if (!p.paramType.needsMarshaling() || (p.isPointer && !p.isDoublePointer && p.paramType.type.equals("void")) || p.paramType.category.equals("enum")) {
+                        } else if ((!p.paramType.needsMarshaling() && !p.paramType.hasHostLayout()) || (p.isPointer && !p.isDoublePointer && p.paramType.type.equals("void")) || p.paramType.category.equals("enum")) {
                             out.append("            s->");
                             out.append(p.name);
                             out.append(" = (");
@@ -106,11 +115,11 @@ public class VkHostMarshalType {
                             out.append(p.paramType.name);
                             out.append("* ");
                             out.append(p.name);
-                            out.append(" = new ");
+                            out.append(" = vulkanAlloc<");
                             out.append(p.paramType.name);
-                            out.append("[s->");
+                            out.append(">(s->");
                             out.append(p.len);
-                            out.append("];\n");
+                            out.append(");\n");
                             out.append("            for (int i=0;i<(int)s->");
                             out.append(p.len);
                             out.append(";i++) {\n");
@@ -118,30 +127,45 @@ public class VkHostMarshalType {
                             out.append(p.name);
                             out.append("[i] = (");
                             out.append(p.paramType.name);
-                            out.append(")getVulkanPtr(paramAddress);\n            }\n");
+                            out.append(")getVulkanPtr(readd(paramAddress + i*4));\n            }\n");
                             out.append("            s->");
                             out.append(p.name);
                             out.append(" = ");
                             out.append(p.name);
                             out.append(";\n");
                         } else if (p.paramType.category.equals("struct")) {
-                            if (p.len != null && p.len.length() > 0) {
+                            if (p.paramType.hasHostLayout()) {
+                                out.append("            s->");
+                                out.append(p.name);
+                                out.append(" = vulkanGetArray<");
+                                out.append(p.paramType.name);
+                                out.append(">(paramAddress, ");
+                                if (p.len != null && p.len.length() > 0) {
+                                    out.append("s->");
+                                    out.append(p.len);
+                                } else {
+                                    out.append("1");
+                                }
+                                out.append(");\n");
+                            } else if (p.len != null && p.len.length() > 0) {
                                 out.append("            ");
                                 out.append(p.paramType.name);
                                 out.append("* ");
                                 out.append(p.name);
-                                out.append(" = new ");
+                                out.append(" = vulkanAlloc<");
                                 out.append(p.paramType.name);
-                                out.append("[s->");
+                                out.append(">(s->");
                                 out.append(p.len);
-                                out.append("];\n");
+                                out.append(");\n");
                                 out.append("            for (U32 i = 0; i < s->");
                                 out.append(p.len);
                                 out.append("; i++) {\n");
 
                                 out.append("                Marshal");
                                 out.append(p.paramType.name);
-                                out.append("::read(paramAddress, &");
+                                out.append("::read(paramAddress + i * ");
+                                out.append(p.paramType.getSize());
+                                out.append(", &");
                                 out.append(p.name);
                                 out.append("[i]);\n");
 
@@ -156,9 +180,9 @@ public class VkHostMarshalType {
                                 out.append(p.paramType.name);
                                 out.append("* ");
                                 out.append(p.name);
-                                out.append(" = new ");
+                                out.append(" = vulkanAlloc<");
                                 out.append(p.paramType.name);
-                                out.append("();\n");
+                                out.append(">(1);\n");
                                 out.append("            Marshal");
                                 out.append(p.paramType.name);
                                 out.append("::read(paramAddress, ");
@@ -174,15 +198,22 @@ public class VkHostMarshalType {
                         } else {
                             throw new Exception("oops");
                         }
+                    } else if (p.paramType.category.equals("struct") && p.paramType.hasHostLayout()) {
+                        p.paramType.needMarshalIn = true;
+                        out.append("            s->");
+                        out.append(p.name);
+                        out.append(" = vulkanGetArray<");
+                        out.append(p.paramType.name);
+                        out.append(">(paramAddress, 1);\n");
                     } else if (p.paramType.category.equals("struct")) {
                         p.paramType.needMarshalIn = true;
                         out.append("            ");
                         out.append(p.paramType.name);
                         out.append("* ");
                         out.append(p.name);
-                        out.append(" = new ");
+                        out.append(" = vulkanAlloc<");
                         out.append(p.paramType.name);
-                        out.append("();\n");
+                        out.append(">(1);\n");
                         out.append("            Marshal");
                         out.append(p.paramType.name);
                         out.append("::read(paramAddress, ");
@@ -269,16 +300,15 @@ public class VkHostMarshalType {
                     out.append("        if (paramAddress != 0) {\n");
                     if (p.name.equals("pNext")) {
                         out.append("            vulkanWriteNextPtr(paramAddress, s->pNext);\n");
-                        out.append("            delete s->pNext;\n");
                     } else if (p.paramType.category.equals("struct")) {
                         p.paramType.needMarshalIn = true;
                         out.append("            ");
                         out.append(p.paramType.name);
                         out.append("* ");
                         out.append(p.name);
-                        out.append(" = new ");
+                        out.append(" = vulkanAlloc<");
                         out.append(p.paramType.name);
-                        out.append("();\n");
+                        out.append(">(1);\n");
                         out.append("            Marshal");
                         out.append(p.paramType.name);
                         out.append("::read(paramAddress, ");
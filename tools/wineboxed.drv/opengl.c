@@ -26,8 +26,15 @@ WINE_DEFAULT_DEBUG_CHANNEL(boxeddrv);
 #define BGLAPI
 #endif
 
+// libGL collects calls that don't return anything and only sends them to Boxedwine when it has to, the calls here
+// go straight to Boxedwine so they need to send what has been collected first.  Older libGL.so.1 don't have it.
+static void (*pglFlushBatch)(void);
+
+#define FLUSH_GL_BATCH() do {if (pglFlushBatch) pglFlushBatch();} while (0)
+
 static BOOL BGLAPI boxeddrv_wglCopyContext(struct wgl_context* src, struct wgl_context* dst, UINT mask) {
     int result;
+    FLUSH_GL_BATCH();
     CALL_3(BOXED_GL_COPY_CONTEXT, src, dst, mask);
     TRACE("boxeddrv_wglCopyContext src=%p dst=%p mask=%X result=%d\n", src, dst, mask, result);
     return (BOOL)result;
@@ -42,6 +49,7 @@ static struct wgl_context* BGLAPI boxeddrv_wglCreateContext(HDC hdc) {
 
 static BOOL BGLAPI boxeddrv_wglDeleteContext(struct wgl_context* context) {
     TRACE("boxeddrv_wglDeleteContext context=%p\n", context);
+    FLUSH_GL_BATCH();
     CALL_NORETURN_1(BOXED_GL_DELETE_CONTEXT, context);
     return TRUE;
 }
@@ -90,6 +98,7 @@ static PROC BGLAPI boxeddrv_wglGetProcAddress(const char* proc) {
 
 static BOOL BGLAPI boxeddrv_wglMakeCurrent(HDC hdc, struct wgl_context* context) {
     int result;
+    FLUSH_GL_BATCH();
     CALL_2(BOXED_GL_MAKE_CURRENT, WindowFromDC(hdc), context);
     TRACE("boxeddrv_wglMakeCurrent hdc=%X context=%p result=%d\n", (int)hdc, context, result);
     return (BOOL)result;
@@ -104,6 +113,7 @@ static BOOL BGLAPI boxeddrv_wglSetPixelFormat(HDC hdc, int fmt, const PIXELFORMA
 
 static BOOL BGLAPI boxeddrv_wglShareLists(struct wgl_context* org, struct wgl_context* dest) {
     int result;
+    FLUSH_GL_BATCH();
     CALL_2(BOXED_GL_SHARE_LISTS, org, dest);
     TRACE("boxeddrv_wglShareLists org=%p dest=%p result=%d\n", org, dest, result);
     return (BOOL)result;
@@ -111,6 +121,7 @@ static BOOL BGLAPI boxeddrv_wglShareLists(struct wgl_context* org, struct wgl_co
 
 static BOOL BGLAPI boxeddrv_wglSwapBuffers(HDC hdc) {
     int result;
+    FLUSH_GL_BATCH();
     CALL_1(BOXED_GL_SWAP_BUFFERS, hdc);
     return (BOOL)result;
 }
@@ -219,6 +230,7 @@ int initOpengl(void) {
             goto failed;
         }
     }
+    pglFlushBatch = dlsym(opengl_handle, "boxedFlushGLBatch");
     return TRUE;
 
 failed:
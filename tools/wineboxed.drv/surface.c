@@ -247,6 +247,7 @@ static void boxeddrv_surface_flush(struct window_surface *window_surface)
     struct boxeddrv_window_surface *surface = get_boxed_surface(window_surface);
     HRGN region;
     BOOL isBoundsEmpty;
+    RECT dirty;
     window_surface->funcs->lock(window_surface);
 
     TRACE("flushing %p %s bounds %s bits %p\n", surface, wine_dbgstr_rect(&surface->header.rect),
@@ -269,6 +270,8 @@ static void boxeddrv_surface_flush(struct window_surface *window_surface)
         }
     }
     update_blit_data(surface);
+    /* only what was drawn since the last flush needs to be uploaded again */
+    dirty = surface->bounds;
     reset_bounds(&surface->bounds);    
 
     if (!isBoundsEmpty)
@@ -277,7 +280,7 @@ static void boxeddrv_surface_flush(struct window_surface *window_surface)
 
         //GetWindowRect(surface->window, &r);
         if (surface->blit_data) { // this can be changed to null sometimes, example: homeworld demo installer with wine 5.0
-            boxeddrv_FlushSurface(surface->window, surface->bits, 0, 0, surface->info.bmiHeader.biWidth, surface->info.bmiHeader.biHeight, (RECT*)surface->blit_data->Buffer, surface->blit_data->rdh.nCount);
+            boxeddrv_FlushSurface(surface->window, surface->bits, 0, 0, surface->info.bmiHeader.biWidth, surface->info.bmiHeader.biHeight, (RECT*)surface->blit_data->Buffer, surface->blit_data->rdh.nCount, &dirty);
         }
     }
     window_surface->funcs->unlock(window_surface);
@@ -162,7 +162,7 @@ BOOL getZOrderCallback(HWND hWnd, LPARAM lParam) {
 }
     return TRUE;
 }
-void boxeddrv_FlushSurface(HWND hwnd, void* bits, int xOrg, int yOrg, int width, int height, RECT* rects, int rectCount) {
+void boxeddrv_FlushSurface(HWND hwnd, void* bits, int xOrg, int yOrg, int width, int height, RECT* rects, int rectCount, const RECT* dirty) {
     struct winZOrder zorder;
     HWND h = GetTopWindow(NULL);
 
@@ -173,8 +173,8 @@ void boxeddrv_FlushSurface(HWND hwnd, void* bits, int xOrg, int yOrg, int width,
     }
 
     // EnumWindows((WNDENUMPROC)getZOrderCallback, (LPARAM)&zorder);
-    TRACE("hwnd=%p bits=%p width=%d height=%d rects=%p rectCount=%d hWndCount=%d\n", hwnd, bits, width, height, rects, rectCount, zorder.count);
-    CALL_NORETURN_9(BOXED_FLUSH_SURFACE, hwnd, bits, xOrg, yOrg, width, height, &zorder, rects, rectCount);
+    TRACE("hwnd=%p bits=%p width=%d height=%d rects=%p rectCount=%d dirty=%s hWndCount=%d\n", hwnd, bits, width, height, rects, rectCount, wine_dbgstr_rect(dirty), zorder.count);
+    CALL_NORETURN_10(BOXED_FLUSH_SURFACE_DIRTY, hwnd, bits, xOrg, yOrg, width, height, &zorder, rects, rectCount, dirty);
 }
 
 #if BOXED_WINE_VERSION >= 6080